@@ -0,0 +1,971 @@
+/**
+ * @file        face_gallery.c
+ * @brief       face embedding gallery functions
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "face_gallery.h"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#define FACE_GALLERY_FILE_MAGIC 0x4746504b      // "KPFG"
+#define FACE_GALLERY_FILE_VERSION 1
+#define FACE_GALLERY_INT8_SCALE 127
+#define FACE_GALLERY_MIN_CAPACITY 64
+#define FACE_GALLERY_TRAIN_PER_LIST 64
+#define FACE_GALLERY_DEFAULT_PROBE_COUNT 8
+
+/* embeddings of one list, stored contiguously */
+typedef struct
+{
+    int count;
+    int capacity;
+    uint32_t *ids;
+    void *vectors;              // count x dim values in the storage format
+} face_gallery_list_t;
+
+struct face_gallery_s
+{
+    int dim;
+    uint32_t storage;
+    size_t vector_size;         // bytes of one stored embedding
+    int list_count;
+    face_gallery_list_t *lists;
+    float *centroids;           // list_count x dim normalized centroids, NULL without index
+    int probe_count;
+
+    // working buffers of one query
+    float *normalized;
+    void *prepared;             // query in the form of the scoring kernel
+    float *list_scores;
+    int *probe_lists;
+};
+
+/*
+ * Half precision conversion.
+ * float -> half rounds to nearest even, half -> float shifts the exponent/mantissa bits and rescales by 2^112,
+ * which handles normal and subnormal halves in the same way (embedding values never reach inf/NaN).
+ */
+static uint16_t float_to_half(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t abs_bits = bits & 0x7fffffffu;
+
+    if (abs_bits >= 0x477ff000u) // rounds to inf or is inf/NaN
+        return (uint16_t)(sign | ((abs_bits > 0x7f800000u) ? 0x7e00u : 0x7c00u));
+
+    if (abs_bits < 0x38800000u) // subnormal half
+    {
+        float abs_value;
+        memcpy(&abs_value, &abs_bits, sizeof(abs_value));
+        return (uint16_t)(sign | (uint32_t)lrintf(abs_value * 16777216.0f)); // 2^24, nearest even
+    }
+
+    uint32_t half = (abs_bits - 0x38000000u) >> 13;
+    uint32_t rest = abs_bits & 0x1fffu;
+    if ((rest > 0x1000u) || ((rest == 0x1000u) && (half & 1)))
+        half++;
+
+    return (uint16_t)(sign | half);
+}
+
+static inline float half_to_float(uint16_t half)
+{
+    uint32_t bits = ((uint32_t)half & 0x7fffu) << 13;
+    float value;
+
+    memcpy(&value, &bits, sizeof(value));
+    value *= 5.192296858534828e+33f; // 2^112
+
+    return (half & 0x8000u) ? -value : value;
+}
+
+/* dot product of two int8 embeddings */
+static int32_t dot_int8(const int8_t *a, const int8_t *b, int dim)
+{
+    int32_t sum = 0;
+    int i = 0;
+
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 16 <= dim; i += 16)
+    {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    __m128i acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc128 = _mm_add_epi32(acc128, _mm_shuffle_epi32(acc128, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(acc128);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= dim; i += 16)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        // sign extension to int16: the byte in the high half, then arithmetic shift
+        __m128i va_lo = _mm_srai_epi16(_mm_unpacklo_epi8(va, va), 8);
+        __m128i va_hi = _mm_srai_epi16(_mm_unpackhi_epi8(va, va), 8);
+        __m128i vb_lo = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+        __m128i vb_hi = _mm_srai_epi16(_mm_unpackhi_epi8(vb, vb), 8);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(va_lo, vb_lo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(va_hi, vb_hi));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(acc);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    int32x4_t acc = vdupq_n_s32(0);
+    for (; i + 16 <= dim; i += 16)
+    {
+        int8x16_t va = vld1q_s8(a + i);
+        int8x16_t vb = vld1q_s8(b + i);
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(va), vget_low_s8(vb)));
+        acc = vpadalq_s16(acc, vmull_high_s8(va, vb));
+    }
+    sum = vaddvq_s32(acc);
+#endif
+
+    for (; i < dim; i++)
+        sum += (int32_t)a[i] * b[i];
+
+    return sum;
+}
+
+/* dot product of a float query and a fp16 embedding */
+static float dot_fp16(const float *a, const uint16_t *b, int dim)
+{
+    float sum = 0;
+    int i = 0;
+
+#if defined(__AVX2__) && defined(__F16C__)
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= dim; i += 8)
+    {
+        __m256 vb = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(b + i)));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), vb));
+    }
+    __m128 acc128 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    acc128 = _mm_add_ps(acc128, _mm_movehl_ps(acc128, acc128));
+    acc128 = _mm_add_ss(acc128, _mm_shuffle_ps(acc128, acc128, 1));
+    sum = _mm_cvtss_f32(acc128);
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i magnitude_mask = _mm_set1_epi32(0x7fff);
+    const __m128i sign_mask = _mm_set1_epi32(0x8000);
+    const __m128 rescale = _mm_set1_ps(5.192296858534828e+33f); // 2^112, same as half_to_float()
+    const __m128i zero = _mm_setzero_si128();
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 8 <= dim; i += 8)
+    {
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        __m128i halves[2] = {_mm_unpacklo_epi16(vb, zero), _mm_unpackhi_epi16(vb, zero)};
+
+        for (int j = 0; j < 2; j++)
+        {
+            __m128 value = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(halves[j], magnitude_mask), 13)), rescale);
+            value = _mm_or_ps(value, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(halves[j], sign_mask), 16)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i + 4 * j), value));
+        }
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    sum = _mm_cvtss_f32(acc);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    float32x4_t acc = vdupq_n_f32(0);
+    for (; i + 4 <= dim; i += 4)
+    {
+        float32x4_t vb = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(b + i)));
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vb);
+    }
+    sum = vaddvq_f32(acc);
+#endif
+
+    for (; i < dim; i++)
+        sum += a[i] * half_to_float(b[i]);
+
+    return sum;
+}
+
+/* dot product of two float vectors */
+static float dot_float(const float *a, const float *b, int dim)
+{
+    float sum = 0;
+    int i = 0;
+
+#if defined(__AVX2__)
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= dim; i += 8)
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    __m128 acc128 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    acc128 = _mm_add_ps(acc128, _mm_movehl_ps(acc128, acc128));
+    acc128 = _mm_add_ss(acc128, _mm_shuffle_ps(acc128, acc128, 1));
+    sum = _mm_cvtss_f32(acc128);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= dim; i += 4)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    sum = _mm_cvtss_f32(acc);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    float32x4_t acc = vdupq_n_f32(0);
+    for (; i + 4 <= dim; i += 4)
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    sum = vaddvq_f32(acc);
+#endif
+
+    for (; i < dim; i++)
+        sum += a[i] * b[i];
+
+    return sum;
+}
+
+/* copy an embedding with unit length, a zero embedding can not be normalized */
+static int normalize_embedding(const float *embedding, int dim, float *normalized)
+{
+    double norm = 0;
+
+    for (int i = 0; i < dim; i++)
+        norm += (double)embedding[i] * embedding[i];
+
+    if (!(0 < norm) || isinf(norm))
+        return -1;
+
+    float inv_norm = (float)(1 / sqrt(norm));
+    for (int i = 0; i < dim; i++)
+        normalized[i] = embedding[i] * inv_norm;
+
+    return 0;
+}
+
+/* store a normalized embedding in the storage format */
+static void encode_embedding(face_gallery_t *gallery, const float *normalized, void *vector)
+{
+    for (int i = 0; i < gallery->dim; i++)
+    {
+        if (FACE_GALLERY_STORAGE_INT8 == gallery->storage)
+        {
+            long value = lrintf(normalized[i] * FACE_GALLERY_INT8_SCALE);
+            ((int8_t *)vector)[i] = (int8_t)((value > FACE_GALLERY_INT8_SCALE) ? FACE_GALLERY_INT8_SCALE : (value < -FACE_GALLERY_INT8_SCALE) ? -FACE_GALLERY_INT8_SCALE : value);
+        }
+        else
+        {
+            ((uint16_t *)vector)[i] = float_to_half(normalized[i]);
+        }
+    }
+}
+
+static void decode_embedding(face_gallery_t *gallery, const void *vector, float *normalized)
+{
+    for (int i = 0; i < gallery->dim; i++)
+    {
+        if (FACE_GALLERY_STORAGE_INT8 == gallery->storage)
+            normalized[i] = (float)((const int8_t *)vector)[i] / FACE_GALLERY_INT8_SCALE;
+        else
+            normalized[i] = half_to_float(((const uint16_t *)vector)[i]);
+    }
+}
+
+/* a normalized query in the form of the scoring kernel: int8 values, or float values for fp16 storage */
+static void prepare_query(face_gallery_t *gallery, const float *normalized, void *prepared)
+{
+    if (FACE_GALLERY_STORAGE_INT8 == gallery->storage)
+        encode_embedding(gallery, normalized, prepared);
+    else
+        memcpy(prepared, normalized, gallery->dim * sizeof(float));
+}
+
+/* cosine similarity of a prepared query and a stored embedding */
+static inline float score_embedding(face_gallery_t *gallery, const void *prepared, const void *vector)
+{
+    if (FACE_GALLERY_STORAGE_INT8 == gallery->storage)
+        return (float)dot_int8((const int8_t *)prepared, (const int8_t *)vector, gallery->dim) / (FACE_GALLERY_INT8_SCALE * FACE_GALLERY_INT8_SCALE);
+
+    return dot_fp16((const float *)prepared, (const uint16_t *)vector, gallery->dim);
+}
+
+static int reserve_list(face_gallery_t *gallery, face_gallery_list_t *list, int count)
+{
+    if (count <= list->capacity)
+        return 0;
+
+    // doubled in size_t, count and list->capacity are at most INT_MAX
+    size_t capacity = (0 < list->capacity) ? (size_t)list->capacity : FACE_GALLERY_MIN_CAPACITY;
+    while (capacity < (size_t)count)
+        capacity *= 2;
+
+    if (INT_MAX < capacity)
+        capacity = INT_MAX;
+
+    if ((SIZE_MAX / sizeof(uint32_t) < capacity) || (SIZE_MAX / gallery->vector_size < capacity))
+        return -1;
+
+    uint32_t *ids = (uint32_t *)realloc(list->ids, capacity * sizeof(uint32_t));
+    if (NULL == ids)
+        return -1;
+    list->ids = ids;
+
+    void *vectors = realloc(list->vectors, capacity * gallery->vector_size);
+    if (NULL == vectors)
+        return -1;
+    list->vectors = vectors;
+
+    list->capacity = (int)capacity;
+
+    return 0;
+}
+
+static int append_to_list(face_gallery_t *gallery, face_gallery_list_t *list, uint32_t id, const void *vector)
+{
+    if (0 != reserve_list(gallery, list, list->count + 1))
+        return -1;
+
+    list->ids[list->count] = id;
+    memcpy((uint8_t *)list->vectors + list->count * gallery->vector_size, vector, gallery->vector_size);
+    list->count++;
+
+    return 0;
+}
+
+static void release_lists(face_gallery_list_t *lists, int list_count)
+{
+    if (NULL == lists)
+        return;
+
+    for (int i = 0; i < list_count; i++)
+    {
+        free(lists[i].ids);
+        free(lists[i].vectors);
+    }
+    free(lists);
+}
+
+/* replace the lists and centroids, the working buffers of list scores follow the list count */
+static int set_lists(face_gallery_t *gallery, face_gallery_list_t *lists, int list_count, float *centroids)
+{
+    float *list_scores = (float *)realloc(gallery->list_scores, list_count * sizeof(float));
+    if (NULL == list_scores)
+        return -1;
+    gallery->list_scores = list_scores;
+
+    int *probe_lists = (int *)realloc(gallery->probe_lists, list_count * sizeof(int));
+    if (NULL == probe_lists)
+        return -1;
+    gallery->probe_lists = probe_lists;
+
+    release_lists(gallery->lists, gallery->list_count);
+    free(gallery->centroids);
+
+    gallery->lists = lists;
+    gallery->list_count = list_count;
+    gallery->centroids = centroids;
+
+    return 0;
+}
+
+/* index of the centroid closest to a normalized embedding */
+static int closest_centroid(const float *centroids, int list_count, int dim, const float *normalized)
+{
+    int best = 0;
+    float best_score = -INFINITY;
+
+    for (int i = 0; i < list_count; i++)
+    {
+        float score = dot_float(&centroids[i * dim], normalized, dim);
+        if (score > best_score)
+        {
+            best_score = score;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+face_gallery_t *face_gallery_create(int dim, face_gallery_storage_t storage)
+{
+    face_gallery_t *gallery = NULL;
+
+    if ((0 >= dim) || ((FACE_GALLERY_STORAGE_INT8 != storage) && (FACE_GALLERY_STORAGE_FP16 != storage)))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return NULL;
+    }
+
+    gallery = (face_gallery_t *)calloc(1, sizeof(face_gallery_t));
+    if (NULL == gallery)
+    {
+        printf("Error! %s(): malloc memory for gallery failed\n", __FUNCTION__);
+        return NULL;
+    }
+
+    gallery->dim = dim;
+    gallery->storage = storage;
+    gallery->vector_size = dim * ((FACE_GALLERY_STORAGE_INT8 == storage) ? sizeof(int8_t) : sizeof(uint16_t));
+    gallery->probe_count = FACE_GALLERY_DEFAULT_PROBE_COUNT;
+    gallery->normalized = (float *)malloc(dim * sizeof(float));
+    gallery->prepared = malloc(dim * sizeof(float));
+
+    face_gallery_list_t *lists = (face_gallery_list_t *)calloc(1, sizeof(face_gallery_list_t));
+
+    if ((NULL == gallery->normalized) || (NULL == gallery->prepared) || (NULL == lists) || (0 != set_lists(gallery, lists, 1, NULL)))
+    {
+        printf("Error! %s(): malloc memory for gallery failed\n", __FUNCTION__);
+        if (gallery->lists != lists)
+            free(lists);
+        face_gallery_release(gallery);
+        return NULL;
+    }
+
+    return gallery;
+}
+
+void face_gallery_release(face_gallery_t *gallery)
+{
+    if (NULL == gallery)
+        return;
+
+    release_lists(gallery->lists, gallery->list_count);
+    free(gallery->centroids);
+    free(gallery->normalized);
+    free(gallery->prepared);
+    free(gallery->list_scores);
+    free(gallery->probe_lists);
+    free(gallery);
+}
+
+int face_gallery_add(face_gallery_t *gallery, uint32_t id, const float *embedding)
+{
+    if ((NULL == gallery) || (NULL == embedding))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (0 != normalize_embedding(embedding, gallery->dim, gallery->normalized))
+    {
+        printf("Error! %s(): the embedding can not be normalized\n", __FUNCTION__);
+        return -1;
+    }
+
+    int list_idx = (NULL == gallery->centroids) ? 0 : closest_centroid(gallery->centroids, gallery->list_count, gallery->dim, gallery->normalized);
+
+    encode_embedding(gallery, gallery->normalized, gallery->prepared);
+
+    if (0 != append_to_list(gallery, &gallery->lists[list_idx], id, gallery->prepared))
+    {
+        printf("Error! %s(): malloc memory for embeddings failed\n", __FUNCTION__);
+        return -1;
+    }
+
+    return 0;
+}
+
+int face_gallery_remove(face_gallery_t *gallery, uint32_t id)
+{
+    int removed_count = 0;
+
+    if (NULL == gallery)
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    // the last embedding of the list fills the hole, lists stay contiguous
+    for (int i = 0; i < gallery->list_count; i++)
+    {
+        face_gallery_list_t *list = &gallery->lists[i];
+
+        for (int j = 0; j < list->count;)
+        {
+            if (list->ids[j] != id)
+            {
+                j++;
+                continue;
+            }
+
+            list->count--;
+            list->ids[j] = list->ids[list->count];
+            memmove((uint8_t *)list->vectors + j * gallery->vector_size, (uint8_t *)list->vectors + list->count * gallery->vector_size, gallery->vector_size);
+            removed_count++;
+        }
+    }
+
+    return (0 < removed_count) ? 0 : -1;
+}
+
+int face_gallery_count(face_gallery_t *gallery)
+{
+    int count = 0;
+
+    if (NULL == gallery)
+        return 0;
+
+    for (int i = 0; i < gallery->list_count; i++)
+        count += gallery->lists[i].count;
+
+    return count;
+}
+
+int face_gallery_build_index(face_gallery_t *gallery, int list_count, int iterations)
+{
+    int total_count = face_gallery_count(gallery);
+    int train_count = 0;
+    int dim = 0;
+    float *train = NULL;
+    int *assignment = NULL;
+    float *centroids = NULL;
+    face_gallery_list_t *lists = NULL;
+
+    if ((NULL == gallery) || (0 >= list_count) || (0 > iterations) || ((1 < list_count) && (total_count < list_count)))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    dim = gallery->dim;
+    train_count = (total_count < list_count * FACE_GALLERY_TRAIN_PER_LIST) ? total_count : list_count * FACE_GALLERY_TRAIN_PER_LIST;
+    lists = (face_gallery_list_t *)calloc(list_count, sizeof(face_gallery_list_t));
+
+    if (1 < list_count)
+    {
+        train = (float *)malloc((size_t)train_count * dim * sizeof(float));
+        assignment = (int *)malloc(train_count * sizeof(int));
+        centroids = (float *)malloc((size_t)list_count * dim * sizeof(float));
+    }
+
+    if ((NULL == lists) || ((1 < list_count) && ((NULL == train) || (NULL == assignment) || (NULL == centroids))))
+    {
+        printf("Error! %s(): malloc memory for index failed\n", __FUNCTION__);
+        goto FUNC_OUT_ERROR;
+    }
+
+    if (1 < list_count)
+    {
+        // training samples evenly spread over all embeddings
+        for (int s = 0, idx = 0, list_idx = 0, list_offset = 0; s < train_count; s++)
+        {
+            int target = (int)((long long)s * total_count / train_count);
+
+            for (; idx < target; idx++)
+            {
+                if (++list_offset >= gallery->lists[list_idx].count)
+                {
+                    list_offset = 0;
+                    do
+                        list_idx++;
+                    while (0 == gallery->lists[list_idx].count);
+                }
+            }
+
+            while (0 == gallery->lists[list_idx].count)
+                list_idx++;
+
+            decode_embedding(gallery, (uint8_t *)gallery->lists[list_idx].vectors + list_offset * gallery->vector_size, &train[(size_t)s * dim]);
+        }
+
+        // initial centroids are samples evenly spread over the training set
+        for (int c = 0; c < list_count; c++)
+            memcpy(&centroids[(size_t)c * dim], &train[(size_t)((long long)c * train_count / list_count) * dim], dim * sizeof(float));
+
+        // spherical k-means: assign to the closest centroid by cosine, then normalize the mean of each cluster
+        for (int iter = 0; iter < iterations; iter++)
+        {
+            for (int s = 0; s < train_count; s++)
+                assignment[s] = closest_centroid(centroids, list_count, dim, &train[(size_t)s * dim]);
+
+            for (int c = 0; c < list_count; c++)
+            {
+                float *centroid = &centroids[(size_t)c * dim];
+                bool empty = true;
+
+                for (int s = 0; s < train_count; s++)
+                {
+                    if (assignment[s] != c)
+                        continue;
+
+                    if (empty)
+                        memset(centroid, 0, dim * sizeof(float));
+                    empty = false;
+
+                    for (int d = 0; d < dim; d++)
+                        centroid[d] += train[(size_t)s * dim + d];
+                }
+
+                // an empty cluster keeps its centroid
+                if (!empty)
+                    normalize_embedding(centroid, dim, centroid);
+            }
+        }
+    }
+
+    // move every embedding to the list of its closest centroid
+    for (int i = 0; i < gallery->list_count; i++)
+    {
+        face_gallery_list_t *list = &gallery->lists[i];
+
+        for (int j = 0; j < list->count; j++)
+        {
+            const void *vector = (uint8_t *)list->vectors + j * gallery->vector_size;
+            int list_idx = 0;
+
+            if (1 < list_count)
+            {
+                decode_embedding(gallery, vector, gallery->normalized);
+                list_idx = closest_centroid(centroids, list_count, dim, gallery->normalized);
+            }
+
+            if (0 != append_to_list(gallery, &lists[list_idx], list->ids[j], vector))
+            {
+                printf("Error! %s(): malloc memory for embeddings failed\n", __FUNCTION__);
+                goto FUNC_OUT_ERROR;
+            }
+        }
+    }
+
+    if (0 != set_lists(gallery, lists, list_count, centroids))
+    {
+        printf("Error! %s(): malloc memory for index failed\n", __FUNCTION__);
+        goto FUNC_OUT_ERROR;
+    }
+
+    free(train);
+    free(assignment);
+
+    return 0;
+
+FUNC_OUT_ERROR:
+    release_lists(lists, list_count);
+    free(train);
+    free(assignment);
+    free(centroids);
+
+    return -1;
+}
+
+void face_gallery_set_probe_count(face_gallery_t *gallery, int probe_count)
+{
+    if ((NULL != gallery) && (0 < probe_count))
+        gallery->probe_count = probe_count;
+}
+
+/* whether match 'a' ranks after match 'b' by cosine similarity, equal similarities rank in ID order */
+static inline bool match_worse(const face_gallery_match_t *a, const face_gallery_match_t *b)
+{
+    return (a->score < b->score) || ((a->score == b->score) && (a->id > b->id));
+}
+
+static void match_sift_down(face_gallery_match_t *heap, int size, int idx)
+{
+    while (1)
+    {
+        int child = 2 * idx + 1;
+        if (child >= size)
+            break;
+
+        if ((child + 1 < size) && match_worse(&heap[child + 1], &heap[child]))
+            child++;
+
+        if (!match_worse(&heap[child], &heap[idx]))
+            break;
+
+        face_gallery_match_t temp = heap[idx];
+        heap[idx] = heap[child];
+        heap[child] = temp;
+        idx = child;
+    }
+}
+
+static int match_comparator(const void *match_1, const void *match_2)
+{
+    const face_gallery_match_t *a = (const face_gallery_match_t *)match_1;
+    const face_gallery_match_t *b = (const face_gallery_match_t *)match_2;
+
+    if (match_worse(a, b))
+        return 1;
+    if (match_worse(b, a))
+        return -1;
+
+    return 0;
+}
+
+int face_gallery_search(face_gallery_t *gallery, const float *embedding, face_gallery_metric_t metric, int top_k,
+                        face_gallery_match_t matches[], int *match_count)
+{
+    int probe_count = 0;
+    int heap_size = 0;
+
+    if ((NULL == gallery) || (NULL == embedding) || (0 >= top_k) || (NULL == matches) || (NULL == match_count) ||
+        ((FACE_GALLERY_METRIC_COSINE != metric) && (FACE_GALLERY_METRIC_L2 != metric)))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (0 != normalize_embedding(embedding, gallery->dim, gallery->normalized))
+    {
+        printf("Error! %s(): the embedding can not be normalized\n", __FUNCTION__);
+        return -1;
+    }
+
+    prepare_query(gallery, gallery->normalized, gallery->prepared);
+
+    // lists to visit: all lists without index, otherwise the lists of the closest centroids
+    if ((NULL == gallery->centroids) || (gallery->probe_count >= gallery->list_count))
+    {
+        probe_count = gallery->list_count;
+        for (int i = 0; i < probe_count; i++)
+            gallery->probe_lists[i] = i;
+    }
+    else
+    {
+        probe_count = gallery->probe_count;
+
+        for (int i = 0; i < gallery->list_count; i++)
+            gallery->list_scores[i] = dot_float(&gallery->centroids[i * gallery->dim], gallery->normalized, gallery->dim);
+
+        // selection of the best 'probe_count' lists, probe_count is small
+        for (int p = 0; p < probe_count; p++)
+        {
+            int best = -1;
+
+            for (int i = 0; i < gallery->list_count; i++)
+            {
+                if ((-INFINITY != gallery->list_scores[i]) && ((0 > best) || (gallery->list_scores[i] > gallery->list_scores[best])))
+                    best = i;
+            }
+
+            gallery->probe_lists[p] = best;
+            gallery->list_scores[best] = -INFINITY;
+        }
+    }
+
+    for (int p = 0; p < probe_count; p++)
+    {
+        face_gallery_list_t *list = &gallery->lists[gallery->probe_lists[p]];
+        const uint8_t *vector = (const uint8_t *)list->vectors;
+
+        for (int j = 0; j < list->count; j++, vector += gallery->vector_size)
+        {
+            face_gallery_match_t match = {list->ids[j], score_embedding(gallery, gallery->prepared, vector)};
+
+            // bounded heap, the root is the worst kept match
+            if (heap_size < top_k)
+            {
+                int idx = heap_size++;
+                matches[idx] = match;
+
+                while (0 < idx)
+                {
+                    int parent = (idx - 1) / 2;
+                    if (!match_worse(&matches[idx], &matches[parent]))
+                        break;
+
+                    face_gallery_match_t temp = matches[idx];
+                    matches[idx] = matches[parent];
+                    matches[parent] = temp;
+                    idx = parent;
+                }
+            }
+            else if (match_worse(&matches[0], &match))
+            {
+                matches[0] = match;
+                match_sift_down(matches, heap_size, 0);
+            }
+        }
+    }
+
+    qsort(matches, heap_size, sizeof(face_gallery_match_t), match_comparator);
+
+    // L2 distance of unit vectors is sqrt(2 - 2 x cosine)
+    if (FACE_GALLERY_METRIC_L2 == metric)
+    {
+        for (int i = 0; i < heap_size; i++)
+        {
+            float square = 2 - 2 * matches[i].score;
+            matches[i].score = (0 < square) ? sqrtf(square) : 0;
+        }
+    }
+
+    *match_count = heap_size;
+
+    return 0;
+}
+
+int face_gallery_save(face_gallery_t *gallery, const char *file_path)
+{
+    FILE *file = NULL;
+    int ret = -1;
+
+    if ((NULL == gallery) || (NULL == file_path))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    file = fopen(file_path, "wb");
+    if (NULL == file)
+    {
+        printf("Error! %s(): open file %s failed\n", __FUNCTION__, file_path);
+        return -1;
+    }
+
+    uint32_t header[6] = {FACE_GALLERY_FILE_MAGIC, FACE_GALLERY_FILE_VERSION, (uint32_t)gallery->dim, gallery->storage,
+                          (uint32_t)gallery->list_count, (NULL != gallery->centroids) ? 1u : 0u};
+
+    if (6 != fwrite(header, sizeof(uint32_t), 6, file))
+        goto FUNC_OUT;
+
+    if ((NULL != gallery->centroids) &&
+        ((size_t)gallery->list_count * gallery->dim != fwrite(gallery->centroids, sizeof(float), (size_t)gallery->list_count * gallery->dim, file)))
+        goto FUNC_OUT;
+
+    for (int i = 0; i < gallery->list_count; i++)
+    {
+        face_gallery_list_t *list = &gallery->lists[i];
+        uint32_t count = (uint32_t)list->count;
+
+        if ((1 != fwrite(&count, sizeof(uint32_t), 1, file)) ||
+            (count != fwrite(list->ids, sizeof(uint32_t), count, file)) ||
+            (count != fwrite(list->vectors, gallery->vector_size, count, file)))
+            goto FUNC_OUT;
+    }
+
+    ret = 0;
+
+FUNC_OUT:
+    if (0 != fclose(file))
+        ret = -1;
+
+    if (0 != ret)
+        printf("Error! %s(): write file %s failed\n", __FUNCTION__, file_path);
+
+    return ret;
+}
+
+face_gallery_t *face_gallery_load(const char *file_path)
+{
+    FILE *file = NULL;
+    face_gallery_t *gallery = NULL;
+    face_gallery_list_t *lists = NULL;
+    float *centroids = NULL;
+    uint32_t header[6] = {0};
+
+    if (NULL == file_path)
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return NULL;
+    }
+
+    file = fopen(file_path, "rb");
+    if (NULL == file)
+    {
+        printf("Error! %s(): open file %s failed\n", __FUNCTION__, file_path);
+        return NULL;
+    }
+
+    if ((6 != fread(header, sizeof(uint32_t), 6, file)) || (FACE_GALLERY_FILE_MAGIC != header[0]) || (FACE_GALLERY_FILE_VERSION != header[1]) ||
+        (0 == header[2]) || (0x10000 < header[2]) || (0 == header[4]) || (0x1000000 < header[4]))
+    {
+        printf("Error! %s(): %s is not a face gallery file\n", __FUNCTION__, file_path);
+        goto FUNC_OUT_ERROR;
+    }
+
+    gallery = face_gallery_create((int)header[2], (face_gallery_storage_t)header[3]);
+    if (NULL == gallery)
+        goto FUNC_OUT_ERROR;
+
+    int dim = gallery->dim;
+    int list_count = (int)header[4];
+
+    lists = (face_gallery_list_t *)calloc(list_count, sizeof(face_gallery_list_t));
+    if (0 != header[5])
+        centroids = (float *)malloc((size_t)list_count * dim * sizeof(float));
+
+    if ((NULL == lists) || ((0 != header[5]) && (NULL == centroids)))
+    {
+        printf("Error! %s(): malloc memory for gallery failed\n", __FUNCTION__);
+        goto FUNC_OUT_ERROR;
+    }
+
+    if ((NULL != centroids) && ((size_t)list_count * dim != fread(centroids, sizeof(float), (size_t)list_count * dim, file)))
+        goto FUNC_OUT_READ_ERROR;
+
+    /* bytes left for the lists, a count the rest of the file cannot hold is rejected before allocating its list */
+    long position = ftell(file);
+    if ((0 > position) || (0 != fseek(file, 0, SEEK_END)))
+        goto FUNC_OUT_READ_ERROR;
+
+    long file_size = ftell(file);
+    if ((position > file_size) || (0 != fseek(file, position, SEEK_SET)))
+        goto FUNC_OUT_READ_ERROR;
+
+    uint64_t remaining_size = (uint64_t)(file_size - position);
+    uint64_t record_size = sizeof(uint32_t) + gallery->vector_size;
+
+    for (int i = 0; i < list_count; i++)
+    {
+        uint32_t count = 0;
+
+        if ((sizeof(uint32_t) > remaining_size) || (1 != fread(&count, sizeof(uint32_t), 1, file)))
+            goto FUNC_OUT_READ_ERROR;
+
+        remaining_size -= sizeof(uint32_t);
+
+        if ((0x7fffffff < count) || (remaining_size / record_size < count))
+            goto FUNC_OUT_READ_ERROR;
+
+        remaining_size -= count * record_size;
+
+        if (0 != reserve_list(gallery, &lists[i], (int)count))
+        {
+            printf("Error! %s(): malloc memory for embeddings failed\n", __FUNCTION__);
+            goto FUNC_OUT_ERROR;
+        }
+
+        if ((count != fread(lists[i].ids, sizeof(uint32_t), count, file)) ||
+            (count != fread(lists[i].vectors, gallery->vector_size, count, file)))
+            goto FUNC_OUT_READ_ERROR;
+
+        lists[i].count = (int)count;
+    }
+
+    if (0 != set_lists(gallery, lists, list_count, centroids))
+    {
+        printf("Error! %s(): malloc memory for gallery failed\n", __FUNCTION__);
+        goto FUNC_OUT_ERROR;
+    }
+
+    fclose(file);
+
+    return gallery;
+
+FUNC_OUT_READ_ERROR:
+    printf("Error! %s(): read file %s failed\n", __FUNCTION__, file_path);
+
+FUNC_OUT_ERROR:
+    release_lists(lists, (int)header[4]);
+    free(centroids);
+    face_gallery_release(gallery);
+    fclose(file);
+
+    return NULL;
+}
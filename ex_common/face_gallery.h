@@ -0,0 +1,158 @@
+/**
+ * @file        face_gallery.h
+ * @brief       face embedding gallery APIs
+ *
+ * Embeddings (e.g. 'feature_map' of kp_fr_result_t) are normalized and stored contiguously in int8 or fp16,
+ * and searched by cosine similarity or L2 distance with SIMD kernels.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "kp_struct.h"
+
+/**
+ * @brief Storage formats of gallery embeddings.
+ */
+typedef enum
+{
+    FACE_GALLERY_STORAGE_INT8 = 0,          /**< each value is round(value x 127) of the normalized embedding, queries are quantized the same way */
+    FACE_GALLERY_STORAGE_FP16,              /**< each value is the IEEE half precision value of the normalized embedding, queries stay in float */
+} face_gallery_storage_t;
+
+/**
+ * @brief Metrics of gallery search.
+ */
+typedef enum
+{
+    FACE_GALLERY_METRIC_COSINE = 0,         /**< cosine similarity, larger is closer */
+    FACE_GALLERY_METRIC_L2,                 /**< L2 distance of the normalized embeddings, smaller is closer */
+} face_gallery_metric_t;
+
+/**
+ * @brief One search result.
+ */
+typedef struct
+{
+    uint32_t id;                            /**< identity ID given to face_gallery_add() */
+    float score;                            /**< cosine similarity or L2 distance to the query */
+} face_gallery_match_t;
+
+/**
+ * @brief Face embedding gallery.
+ *
+ * Embeddings are kept in lists. Without an index there is one list and search is exhaustive, face_gallery_build_index() clusters
+ * the embeddings into lists (IVF, inverted file) and search only visits the lists whose centroids are closest to the query.
+ * A gallery is not thread-safe, search uses working buffers of the gallery.
+ */
+typedef struct face_gallery_s face_gallery_t;
+
+/**
+ * @brief Create an empty gallery.
+ *
+ * @param[in] dim length of embeddings, e.g. FR_FEAT_LENGTH.
+ * @param[in] storage storage format of embeddings, refer to face_gallery_storage_t.
+ *
+ * @return the gallery, NULL if failed.
+ */
+face_gallery_t *face_gallery_create(int dim, face_gallery_storage_t storage);
+
+/**
+ * @brief Release a gallery.
+ *
+ * @param[in] gallery the gallery created by face_gallery_create() or face_gallery_load().
+ */
+void face_gallery_release(face_gallery_t *gallery);
+
+/**
+ * @brief Add an embedding of an identity, an identity can have several embeddings.
+ *
+ * With an index, the embedding is added to the list of its closest centroid.
+ *
+ * @param[in] gallery the gallery.
+ * @param[in] id identity ID.
+ * @param[in] embedding 'dim' floating-point values, it is normalized before being stored.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int face_gallery_add(face_gallery_t *gallery, uint32_t id, const float *embedding);
+
+/**
+ * @brief Remove all embeddings of an identity.
+ *
+ * @param[in] gallery the gallery.
+ * @param[in] id identity ID.
+ *
+ * @return return 0 means sucessful, otherwise failed (no embedding of the identity).
+ */
+int face_gallery_remove(face_gallery_t *gallery, uint32_t id);
+
+/**
+ * @brief Get the number of embeddings in a gallery.
+ *
+ * @param[in] gallery the gallery.
+ *
+ * @return number of embeddings.
+ */
+int face_gallery_count(face_gallery_t *gallery);
+
+/**
+ * @brief Cluster the embeddings into lists by spherical k-means for sub-linear search.
+ *
+ * Centroids are trained on at most 64 embeddings per list, then every embedding moves to the list of its closest centroid.
+ * Embeddings added later join the lists of their closest centroids, build the index again after many changes.
+ *
+ * @param[in] gallery the gallery.
+ * @param[in] list_count number of lists, 1 removes the index.
+ * @param[in] iterations k-means iterations.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int face_gallery_build_index(face_gallery_t *gallery, int list_count, int iterations);
+
+/**
+ * @brief Set the number of lists visited by search, more lists give higher recall and longer latency.
+ *
+ * @param[in] gallery the gallery.
+ * @param[in] probe_count number of lists to visit, all lists if it is larger than the number of lists.
+ */
+void face_gallery_set_probe_count(face_gallery_t *gallery, int probe_count);
+
+/**
+ * @brief Find the embeddings closest to a query.
+ *
+ * @param[in] gallery the gallery.
+ * @param[in] embedding 'dim' floating-point values of the query.
+ * @param[in] metric metric of the scores, refer to face_gallery_metric_t.
+ * @param[in] top_k max number of matches.
+ * @param[out] matches matches from the closest, users need to prepare a buffer of 'top_k' matches for this.
+ * @param[out] match_count number of matches.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int face_gallery_search(face_gallery_t *gallery, const float *embedding, face_gallery_metric_t metric, int top_k,
+                        face_gallery_match_t matches[], int *match_count);
+
+/**
+ * @brief Save a gallery with its index to a file.
+ *
+ * @param[in] gallery the gallery.
+ * @param[in] file_path path of the file.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int face_gallery_save(face_gallery_t *gallery, const char *file_path);
+
+/**
+ * @brief Load a gallery saved by face_gallery_save().
+ *
+ * @param[in] file_path path of the file.
+ *
+ * @return the gallery, NULL if failed.
+ */
+face_gallery_t *face_gallery_load(const char *file_path);
@@ -16,13 +16,17 @@
 #include <math.h>
 #include <float.h>
 #include <limits.h>
+#include <pthread.h>
 
 #include "kp_inference.h"
 #include "helper_functions.h"
+#include "image_convert.h"
 
 #define MIN(a,b) (((a)<(b))?(a):(b))
 #define MAX(a,b) (((a)>(b))?(a):(b))
 
+#define HELPER_IMAGE_CONVERT_THREAD_COUNT 4
+
 static struct timeval time_begin;
 static struct timeval time_end;
 
@@ -122,127 +126,6 @@ static size_t custom_fread(void *ptr, size_t size, size_t count, FILE *stream)
     return read_size;
 }
 
-static void generate_ycbcr_to_ycbcr_order_mapping(kp_image_format_t in_format, kp_image_format_t out_format, int order_mapping[])
-{
-    // initialize
-    int y0_index = 0;
-    int cb_index = 0;
-    int y1_index = 0;
-    int cr_index = 0;
-
-    switch (in_format)
-    {
-        case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
-            cr_index = 0;
-            y1_index = 1;
-            cb_index = 2;
-            y0_index = 3;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
-            cb_index = 0;
-            y1_index = 1;
-            cr_index = 2;
-            y0_index = 3;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
-            y1_index = 0;
-            cr_index = 1;
-            y0_index = 2;
-            cb_index = 3;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
-            y1_index = 0;
-            cb_index = 1;
-            y0_index = 2;
-            cr_index = 3;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
-            cr_index = 0;
-            y0_index = 1;
-            cb_index = 2;
-            y1_index = 3;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
-            cb_index = 0;
-            y0_index = 1;
-            cr_index = 2;
-            y1_index = 3;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
-            y0_index = 0;
-            cr_index = 1;
-            y1_index = 2;
-            cb_index = 3;
-            break;
-        case KP_IMAGE_FORMAT_YUYV:
-        case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
-            y0_index = 0;
-            cb_index = 1;
-            y1_index = 2;
-            cr_index = 3;
-            break;
-        default:
-            printf("input format is not supported\n");
-            break;
-    }
-
-    switch (out_format)
-    {
-        case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
-            order_mapping[0] = cr_index;
-            order_mapping[1] = y1_index;
-            order_mapping[2] = cb_index;
-            order_mapping[3] = y0_index;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
-            order_mapping[0] = cb_index;
-            order_mapping[1] = y1_index;
-            order_mapping[2] = cr_index;
-            order_mapping[3] = y0_index;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
-            order_mapping[0] = y1_index;
-            order_mapping[1] = cr_index;
-            order_mapping[2] = y0_index;
-            order_mapping[3] = cb_index;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
-            order_mapping[0] = y1_index;
-            order_mapping[1] = cb_index;
-            order_mapping[2] = y0_index;
-            order_mapping[3] = cr_index;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
-            order_mapping[0] = cr_index;
-            order_mapping[1] = y0_index;
-            order_mapping[2] = cb_index;
-            order_mapping[3] = y1_index;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
-            order_mapping[0] = cb_index;
-            order_mapping[1] = y0_index;
-            order_mapping[2] = cr_index;
-            order_mapping[3] = y1_index;
-            break;
-        case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
-            order_mapping[0] = y0_index;
-            order_mapping[1] = cr_index;
-            order_mapping[2] = y1_index;
-            order_mapping[3] = cb_index;
-            break;
-        case KP_IMAGE_FORMAT_YUYV:
-        case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
-            order_mapping[0] = y0_index;
-            order_mapping[1] = cb_index;
-            order_mapping[2] = y1_index;
-            order_mapping[3] = cr_index;
-            break;
-        default:
-            printf("output format is not supported\n");
-            break;
-    }
-}
-
 static void dump_bmp_file_from_bmp_pixel_data(const char *out_bmp_path, int bmp_width, int bmp_height, unsigned char *pixel_data)
 {
     // Open .bmp file to write
@@ -292,8 +175,6 @@ char *helper_bmp_file_to_raw_buffer(const char *file_path, int *width, int *heig
     FILEHEADER header1;
     INFOHEADER header2;
 
-    unsigned short *b16_buf = NULL;
-    unsigned char  *b8_buf  = NULL;
     unsigned char *bmp_buf = NULL;
 
     char *raw_buf = NULL;
@@ -368,222 +249,22 @@ char *helper_bmp_file_to_raw_buffer(const char *file_path, int *width, int *heig
 
     if (header2.bits == 24)
     {
-        switch (format)
-        {
-        case KP_IMAGE_FORMAT_RGB565:
-        {
-            b16_buf = (unsigned short *)malloc(header2.width * header2.height * 2);
-            if ( NULL == b16_buf ) {
-                printf("Error! malloc memory for converted data failed\n");
-                goto err;
-            }
-            int rgb565_pos = 0;
-
-            for (int row = header2.height - 1; row >= 0; row--)
-            {
-                int bmp_pos = (header2.width * 3 + padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-                for (int col = 0; col < header2.width; col++)
-                {
-                    unsigned char blue = bmp_buf[bmp_pos];
-                    unsigned char green = bmp_buf[bmp_pos + 1];
-                    unsigned char red = bmp_buf[bmp_pos + 2];
-
-                    b16_buf[rgb565_pos] = ((red & 0b11111000) << 8) | ((green & 0b11111100) << 3) | (blue >> 3);
-
-                    bmp_pos += 3;
-                    rgb565_pos++;
-                }
-            }
-
-            raw_buf = (char *)b16_buf;
-            break;
-        }
-        case KP_IMAGE_FORMAT_RGBA8888:
-        {
-            b8_buf = (unsigned char *)malloc(header2.width * header2.height * 4);
-            if ( NULL == b8_buf ) {
-                printf("Error! malloc memory for converted data failed\n");
-                goto err;
-            }
-            int rgba8888_pos = 0;
-
-            for (int row = header2.height - 1; row >= 0; row--)
-            {
-                int bmp_pos = (header2.width * 3 + padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-                for (int col = 0; col < header2.width; col++)
-                {
-                    unsigned char blue = bmp_buf[bmp_pos];
-                    unsigned char green = bmp_buf[bmp_pos + 1];
-                    unsigned char red = bmp_buf[bmp_pos + 2];
-
-                    b8_buf[rgba8888_pos++] = red;
-                    b8_buf[rgba8888_pos++] = green;
-                    b8_buf[rgba8888_pos++] = blue;
-                    b8_buf[rgba8888_pos++] = 0;
-
-                    bmp_pos += 3;
-                }
-            }
-
-            raw_buf = (char *)b8_buf;
-            break;
-        }
-        case KP_IMAGE_FORMAT_YUYV:
-        case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
-        case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
-        case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
-        case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
-        case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
-        case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
-        case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
-        case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
-        {
-            b8_buf = (unsigned char *)malloc(header2.width * header2.height * 2);
-            if ( NULL == b8_buf ) {
-                printf("Error! malloc memory for converted data failed\n");
-                goto err;
-            }
-            int write_pos = 0;
-
-            // generate the order mappings of (y0, cb, y1, cr) to (cr, y1, cb, y0), (cb, y1, cr, y0), ... described in the yuyv or ycbcr image format
-            int order_mapping[4] = {0};
-            generate_ycbcr_to_ycbcr_order_mapping(KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR, format, order_mapping);
-
-            for (int row = header2.height - 1; row >= 0; row--)
-            {
-                int bmp_pos = (header2.width * 3 + padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-
-                // FIXME? How if the width is an odd number?
-                for (int col = 0; col < header2.width / 2; col++)
-                {
-                    unsigned char blue0 = bmp_buf[bmp_pos];
-                    unsigned char green0 = bmp_buf[bmp_pos + 1];
-                    unsigned char red0 = bmp_buf[bmp_pos + 2];
-
-                    unsigned char blue1 = bmp_buf[bmp_pos + 3];
-                    unsigned char green1 = bmp_buf[bmp_pos + 4];
-                    unsigned char red1 = bmp_buf[bmp_pos + 5];
-
-                    // FIXME: use integer method to speed up
-                    float output[4];
-                    output[0] = 0.299 * red0 + 0.587 * green0 + 0.114 * blue0; // y0
-                    output[1] = -0.169 * (red0 + red1) / 2 - 0.331 * (green0 + green1) / 2 + 0.5 * (blue0 + blue1) / 2 + 128; // cb
-                    output[2] = 0.299 * red1 + 0.587 * green1 + 0.114 * blue1; // y1
-                    output[3] = 0.5 * (red0 + red1) / 2 - 0.419 * (green0 + green1) / 2 - 0.081 * (blue0 + blue1) / 2 + 128;  // cr
-
-                    b8_buf[write_pos++] = (unsigned char)output[order_mapping[0]];
-                    b8_buf[write_pos++] = (unsigned char)output[order_mapping[1]];
-                    b8_buf[write_pos++] = (unsigned char)output[order_mapping[2]];
-                    b8_buf[write_pos++] = (unsigned char)output[order_mapping[3]];
-
-                    bmp_pos += 6;
-                }
-            }
-
-            raw_buf = (char *)b8_buf;
-            break;
+        int raw_buf_size = image_convert_buffer_size(header2.width, header2.height, format);
+        if (0 > raw_buf_size) {
+            printf("image format is not supported\n");
+            goto err;
         }
-        case KP_IMAGE_FORMAT_YUV420:
-        {
-            if ((0 != header2.width % 2) || (0 != header2.height % 2)) {
-                printf("Error! width or height is not even number\n");
-                goto err;
-            }
-
-            b8_buf = (unsigned char *)malloc(header2.width * header2.height * 1.5);
-            if ( NULL == b8_buf ) {
-                printf("Error! malloc memory for converted data failed\n");
-                goto err;
-            }
-
-            int y_bias = header2.width * header2.height;
-            int u_bias = y_bias / 4;
-            int u_pos = y_bias;
-            int v_pos = y_bias + u_bias;
-
-            for (int row = header2.height - 1; row >= 0; row -= 2)
-            {
-                int bmp_pos_row_0 = (header2.width * 3 + padding_byte_num) * row;       // we only support bmp file with 3 bytes per pixel
-                int bmp_pos_row_1 = (header2.width * 3 + padding_byte_num) * (row - 1); // we only support bmp file with 3 bytes per pixel
-                int y_write_pos_row_0 = header2.width * (header2.height - row - 1);
-                int y_write_pos_row_1 = header2.width * (header2.height - row);
-
-                for (int col = 0; col < header2.width; col += 2)
-                {
-                    unsigned char blue0 = bmp_buf[bmp_pos_row_0];
-                    unsigned char green0 = bmp_buf[bmp_pos_row_0 + 1];
-                    unsigned char red0 = bmp_buf[bmp_pos_row_0 + 2];
-
-                    unsigned char blue1 = bmp_buf[bmp_pos_row_0 + 3];
-                    unsigned char green1 = bmp_buf[bmp_pos_row_0 + 4];
-                    unsigned char red1 = bmp_buf[bmp_pos_row_0 + 5];
-
-                    unsigned char blue2 = bmp_buf[bmp_pos_row_1];
-                    unsigned char green2 = bmp_buf[bmp_pos_row_1 + 1];
-                    unsigned char red2 = bmp_buf[bmp_pos_row_1 + 2];
-
-                    unsigned char blue3 = bmp_buf[bmp_pos_row_1 + 3];
-                    unsigned char green3 = bmp_buf[bmp_pos_row_1 + 4];
-                    unsigned char red3 = bmp_buf[bmp_pos_row_1 + 5];
-
-                    float y[2][2];
-                    float u, v;
-
-                    y[0][0] = 0.299 * red0 + 0.587 * green0 + 0.114 * blue0;
-                    y[0][1] = 0.299 * red1 + 0.587 * green1 + 0.114 * blue1;
-                    y[1][0] = 0.299 * red2 + 0.587 * green2 + 0.114 * blue2;
-                    y[1][1] = 0.299 * red3 + 0.587 * green3 + 0.114 * blue3;
-
-                    u = -0.169 * (red0 + red1 + red2 + red3) / 4 - 0.331 * (green0 + green1 + green2 + green3) / 4 + 0.5 * (blue0 + blue1 + blue2 + blue3) / 4 + 128;
-                    v = 0.5 * (red0 + red1 + red2 + red3) / 4 - 0.419 * (green0 + green1 + green2 + green3) / 4 - 0.081 * (blue0 + blue1 + blue2 + blue3) / 4 + 128;
-
-                    b8_buf[y_write_pos_row_0++] = (unsigned char)y[0][0];
-                    b8_buf[y_write_pos_row_0++] = (unsigned char)y[0][1];
-                    b8_buf[y_write_pos_row_1++] = (unsigned char)y[1][0];
-                    b8_buf[y_write_pos_row_1++] = (unsigned char)y[1][0];
-                    b8_buf[u_pos++] = (unsigned char)u;
-                    b8_buf[v_pos++] = (unsigned char)v;
-
-                    bmp_pos_row_0 += 6;
-                    bmp_pos_row_1 += 6;
-                }
-            }
 
-            raw_buf = (char *)b8_buf;
-            break;
+        raw_buf = (char *)malloc(raw_buf_size);
+        if ( NULL == raw_buf ) {
+            printf("Error! malloc memory for converted data failed\n");
+            goto err;
         }
-        case KP_IMAGE_FORMAT_RAW8:
-        {
-            b8_buf = (unsigned char *)malloc(header2.width * header2.height);
-            if ( NULL == b8_buf ) {
-                printf("Error! malloc memory for converted data failed\n");
-                goto err;
-            }
-            int gray_pos = 0;
 
-            for (int row = header2.height - 1; row >= 0; row--)
-            {
-                int bmp_pos = (header2.width * 3 + padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-                for (int col = 0; col < header2.width; col++)
-                {
-                    unsigned char blue = bmp_buf[bmp_pos];
-                    unsigned char green = bmp_buf[bmp_pos + 1];
-                    unsigned char red = bmp_buf[bmp_pos + 2];
-
-                    b8_buf[gray_pos++] = (0.3 * red) + (0.59 * green) + (0.11 * blue);
-
-                    bmp_pos += 3;
-                }
-            }
-
-            raw_buf = (char *)b8_buf;
-            break;
-        }
-        case KP_IMAGE_FORMAT_UNKNOWN:
-        default:
-            printf("image format is not supported\n");
-            break;
-        }
+        // bmp rows are stored from bottom to top
+        int bmp_stride = header2.width * 3 + padding_byte_num; // we only support bmp file with 3 bytes per pixel
+        image_convert_from_rgb888(bmp_buf + bmp_stride * (header2.height - 1), -bmp_stride, IMAGE_CONVERT_ORDER_BGR, header2.width, header2.height,
+                                  format, (uint8_t *)raw_buf, HELPER_IMAGE_CONVERT_THREAD_COUNT);
     }
     else
     {
@@ -596,8 +277,7 @@ char *helper_bmp_file_to_raw_buffer(const char *file_path, int *width, int *heig
 
 err:
     free(bmp_buf);
-    free(b16_buf);
-    free(b8_buf);
+    free(raw_buf);
 
     return NULL;
 }
@@ -899,196 +579,16 @@ err:
     return;
 }
 
-static unsigned char clamp_to_0_255(float num)
-{
-    if (num > 255)
-        return 255;
-    else if (num < 0)
-        return 0;
-    else
-        return (unsigned char)num;
-}
-
 // Passing bmp_padding_byte_num to avoid recalculation
 // bmp_buf is used to store pixel data of bmp image
 static void convert_bin_to_bmp_pixel_data(unsigned char *bin_buf, unsigned char *bmp_buf, int width, int height, kp_image_format_t bin_format, int bmp_padding_byte_num)
 {
-    switch (bin_format)
-    {
-    case KP_IMAGE_FORMAT_RGB565:
-    {
-        unsigned short *rgb565_buf = (unsigned short *)bin_buf;
-
-        int rgb565_pos = 0;
-
-        for (int row = height - 1; row >= 0; row--)
-        {
-            int bmp_pos = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-            for (int col = 0; col < width; col++)
-            {
-                bmp_buf[bmp_pos] = (rgb565_buf[rgb565_pos] << 3) & 0b11111000;     // blue
-                bmp_buf[bmp_pos + 1] = (rgb565_buf[rgb565_pos] >> 3) & 0b11111100; // green
-                bmp_buf[bmp_pos + 2] = (rgb565_buf[rgb565_pos] >> 8) & 0b11111000; // red
-
-                bmp_pos += 3;
-                rgb565_pos++;
-            }
-        }
-        break;
-    }
-    case KP_IMAGE_FORMAT_RGBA8888:
-    {
-        // Just an alias for buffer naming consistency
-        unsigned char *rgba8888_buf = bin_buf;
+    int bmp_stride = width * 3 + bmp_padding_byte_num; // we only support bmp file with 3 bytes per pixel
 
-        int rgba8888_pos = 0;
-
-        for (int row = height - 1; row >= 0; row--)
-        {
-            int bmp_pos = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-            for (int col = 0; col < width; col++)
-            {
-                bmp_buf[bmp_pos] = rgba8888_buf[rgba8888_pos + 2];     // blue
-                bmp_buf[bmp_pos + 1] = rgba8888_buf[rgba8888_pos + 1]; // green
-                bmp_buf[bmp_pos + 2] = rgba8888_buf[rgba8888_pos];     // red
-
-                bmp_pos += 3;
-                rgba8888_pos += 4;
-            }
-        }
-        break;
-    }
-    case KP_IMAGE_FORMAT_YUYV:
-    case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
-    case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
-    case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
-    case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
-    case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
-    case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
-    case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
-    case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
-    {
-        // Just an alias for buffer naming consistency
-        unsigned char *ycbcr_buf = bin_buf;
-
-        int ycbcr_pos = 0;
-
-        // generate the order mappings of (cr, y1, cb, y0), (cb, y1, cr, y0) to (y0, cb, y1, cr)... described in the yuyv or ycbcr image format
-        int order_mapping[4] = {0};
-        generate_ycbcr_to_ycbcr_order_mapping(bin_format, KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR, order_mapping);
-
-        for (int row = height - 1; row >= 0; row--)
-        {
-            int bmp_pos = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-
-            // FIXME: How if the width is an odd number?
-            for (int col = 0; col < width / 2; col++)
-            {
-                unsigned char output[4];
-                output[0] = ycbcr_buf[ycbcr_pos++]; // one of (y0, cb, y1, cr)
-                output[1] = ycbcr_buf[ycbcr_pos++]; // one of (y0, cb, y1, cr)
-                output[2] = ycbcr_buf[ycbcr_pos++]; // one of (y0, cb, y1, cr)
-                output[3] = ycbcr_buf[ycbcr_pos++]; // one of (y0, cb, y1, cr)
-
-                unsigned char y0 = output[order_mapping[0]];
-                unsigned char cb = output[order_mapping[1]];
-                unsigned char y1 = output[order_mapping[2]];
-                unsigned char cr = output[order_mapping[3]];
-
-                // FIXME: use integer method to speed up
-                float b_diff = 1.77 * (cb - 128);
-                float g_diff = -0.343 * (cb - 128) - 0.714 * (cr - 128);
-                float r_diff = 1.403 * (cr - 128);
-
-                bmp_buf[bmp_pos++] = clamp_to_0_255(y0 + b_diff);
-                bmp_buf[bmp_pos++] = clamp_to_0_255(y0 + g_diff);
-                bmp_buf[bmp_pos++] = clamp_to_0_255(y0 + r_diff);
-                bmp_buf[bmp_pos++] = clamp_to_0_255(y1 + b_diff);
-                bmp_buf[bmp_pos++] = clamp_to_0_255(y1 + g_diff);
-                bmp_buf[bmp_pos++] = clamp_to_0_255(y1 + r_diff);
-            }
-        }
-        break;
-    }
-    case KP_IMAGE_FORMAT_RAW8:
-    {
-        // Just an alias for buffer naming consistency
-        unsigned char *raw8_buf = bin_buf;
-
-        int raw8_pos = 0;
-
-        for (int row = height - 1; row >= 0; row--)
-        {
-            int bmp_pos = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-            for (int col = 0; col < width; col++)
-            {
-                memset(bmp_buf + bmp_pos, raw8_buf[raw8_pos++], 3);
-                bmp_pos += 3;
-            }
-        }
-        break;
-    }
-    case KP_IMAGE_FORMAT_YUV420:
-    {
-        if ((0 != width % 2) || (0 != height % 2)) {
-            printf("Error! width or height is not even number\n");
-            return;
-        }
-
-        // Just an alias for buffer naming consistency
-        unsigned char *yuv_buf = bin_buf;
-        int y_bias = width * height;
-        int u_bias = y_bias / 4;
-        int u_pos = y_bias;
-        int v_pos = y_bias + u_bias;
-
-        for (int row = height - 1; row >= 0; row -= 2)
-        {
-            int bmp_pos_row_0 = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
-            int bmp_pos_row_1 = (width * 3 + bmp_padding_byte_num) * (row - 1); // we only support bmp file with 3 bytes per pixel
-            int y_pos_row_0 = width * (height - row - 1);
-            int y_pos_row_1 = width * (height - row);
-
-            for (int col = 0; col < width; col += 2)
-            {
-                unsigned char y[2][2];
-                unsigned char u, v;
-
-                y[0][0] = yuv_buf[y_pos_row_0++];
-                y[0][1] = yuv_buf[y_pos_row_0++];
-                y[1][0] = yuv_buf[y_pos_row_1++];
-                y[1][1] = yuv_buf[y_pos_row_1++];
-
-                u = yuv_buf[u_pos++];
-                v = yuv_buf[v_pos++];
-
-                // FIXME: use integer method to speed up
-                float b_diff = 1.77 * (u - 128);
-                float g_diff = -0.343 * (u - 128) - 0.714 * (v - 128);
-                float r_diff = 1.403 * (v - 128);
-
-                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][0] + b_diff);
-                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][0] + g_diff);
-                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][0] + r_diff);
-                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][1] + b_diff);
-                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][1] + g_diff);
-                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][1] + r_diff);
-
-                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][0] + b_diff);
-                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][0] + g_diff);
-                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][0] + r_diff);
-                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][1] + b_diff);
-                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][1] + g_diff);
-                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][1] + r_diff);
-            }
-        }
-        break;
-    }
-    default:
-    case KP_IMAGE_FORMAT_UNKNOWN:
+    // bmp rows are stored from bottom to top
+    if (0 != image_convert_to_rgb888(bin_buf, width, height, bin_format, bmp_buf + bmp_stride * (height - 1), -bmp_stride, IMAGE_CONVERT_ORDER_BGR,
+                                     HELPER_IMAGE_CONVERT_THREAD_COUNT))
         printf("image format is not supported\n");
-        return;
-    }
 }
 
 void helper_draw_box_on_bmp_from_bin(const char *in_bin_path, int in_bin_width, int in_bin_height, kp_image_format_t in_bin_format,
@@ -2416,380 +1916,574 @@ int helper_get_quantization_parameters_v1_information(kp_quantization_parameters
     return KP_SUCCESS;
 }
 
-int helper_convert_onnx_data_to_npu_data(kp_tensor_descriptor_t *tensor_descriptor, float *onnx_data_buf, int32_t onnx_data_buf_size, int8_t **npu_data_buf, int32_t *npu_data_buf_size)
+/*
+ * ONNX to NPU data conversion.
+ *
+ * A plan precomputes everything of a tensor descriptor that does not depend on the data: the quantization factors, the
+ * npu buffer size, and the re-layout as rows along one "inner" axis (the contiguous onnx axis if there is one), each row
+ * with its onnx and npu base offsets and the npu offset of each element from the base. Rows are quantized with SIMD and
+ * scattered into the npu layout, and bands of rows are converted in parallel.
+ *
+ * The vector code clamps before rounding: for integer bounds, MAX(min, MIN(round(x), max)) == round(MAX(min, MIN(x, max))),
+ * and the clamped value rounds to nearest even in the int32 conversion exactly as kneron_round(). RAW_FLOAT and rows whose
+ * elements need different factors use the scalar formula of the original element-by-element code.
+ */
+#if defined(EX_COMMON_NO_SIMD)
+/* scalar code only, project/test_onnx_to_npu_data checks both builds against the former element-by-element code */
+#elif defined(__AVX2__)
+#define NPU_VEC_WIDTH 8
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define NPU_VEC_WIDTH 4
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define NPU_VEC_WIDTH 4
+#include <arm_neon.h>
+#endif
+
+#define HELPER_NPU_DATA_CONVERT_THREAD_COUNT 4
+#define HELPER_NPU_DATA_MAX_THREAD_COUNT 16
+#define HELPER_NPU_DATA_MIN_ELEMENTS_PER_THREAD (64 * 1024)
+
+struct helper_onnx_to_npu_plan_s
 {
-    int status                                                  = KP_SUCCESS;
-
-    kp_tensor_shape_info_v2_t *tensor_shape_info                = NULL;
+    uint32_t data_layout;
+    float quantization_max_value;
+    float quantization_min_value;
+    int descriptor_count;
+    float *quantization_factors;        // 2^radix x scale of each quantized fixed point descriptor
+    int32_t quantized_axis_stride;      // onnx elements of one descriptor
+    int32_t onnx_data_size;             // onnx elements read, the last onnx offset + 1
+    int32_t npu_data_buf_size;          // bytes of npu data
+
+    int inner_count;                    // elements of a row
+    int32_t inner_onnx_stride;
+    int32_t *inner_npu_offsets;         // npu offset of each element of a row from the row base (in scalars)
+    int row_count;
+    int32_t *row_onnx_offsets;
+    int32_t *row_npu_offsets;
+    int32_t *row_descriptors;           // descriptor of all elements of a row, -1 if they differ
+
+    int thread_count;
+    int32_t *row_values;                // thread_count x inner_count quantized values
+};
 
-    uint32_t npu_data_layout                                    = KP_MODEL_TENSOR_DATA_LAYOUT_UNKNOWN;
+typedef struct
+{
+    const helper_onnx_to_npu_plan_t *plan;
+    const float *onnx_data_buf;
+    uint8_t *npu_data_buf;
+    int row_begin;
+    int row_end;
+    int32_t *values;
+} onnx_to_npu_band_t;
+
+static inline float quantize_onnx_value(float value, float quantization_factor, float quantization_min_value, float quantization_max_value)
+{
+    value = (float)kneron_round(value * quantization_factor);
 
-    kp_quantization_parameters_v1_t *quantization_parameters_v1 = NULL;
-    float quantization_max_value                                = 0;
-    float quantization_min_value                                = 0;
-    int32_t radix                                               = 0;
-    float scale                                                 = 0;
-    float quantization_factor                                   = 0;
-    int quantized_axis_stride                                   = 0;
-
-    int channel_idx                                             = 0;
-    int npu_channel_group_stride_tmp                            = 0;
-    int npu_channel_group_stride                                = -1;
-
-    int32_t *onnx_data_shape_index                              = NULL;
-    int32_t onnx_data_buf_offset                                = 0;
-    int32_t npu_data_buf_offset                                 = 0;
-
-    int max_npu_stride_axis                                     = 0;
-    uint32_t max_npu_stride                                     = 0;
-    uint16_t npu_data_element_u16b                              = 0;
-    uint16_t npu_data_element_i16b                              = 0;
-    uint16_t npu_data_high_bit_offset                           = 16;
+    return MAX(quantization_min_value, MIN(value, quantization_max_value));
+}
 
-    if (NULL == tensor_descriptor ||
-        NULL == onnx_data_buf ||
-        0 == onnx_data_buf_size ||
-        NULL == npu_data_buf ||
-        NULL == npu_data_buf_size) {
-        printf("convert onnx data to npu data fail: NULL pointer input parameters ...\n");
-        status = KP_ERROR_INVALID_PARAM_12;
-        goto FUNC_OUT;
+static void quantize_onnx_row(const helper_onnx_to_npu_plan_t *plan, const float *onnx_data_buf, int row, int32_t *values)
+{
+    const float *src = onnx_data_buf + plan->row_onnx_offsets[row];
+    const int32_t stride = plan->inner_onnx_stride;
+    const int count = plan->inner_count;
+    const float min_value = plan->quantization_min_value;
+    const float max_value = plan->quantization_max_value;
+    int descriptor = plan->row_descriptors[row];
+    int i = 0;
+
+    if (0 > descriptor)
+    {
+        for (; i < count; i++)
+        {
+            int32_t onnx_offset = plan->row_onnx_offsets[row] + i * stride;
+            float factor = plan->quantization_factors[onnx_offset / plan->quantized_axis_stride];
+            values[i] = (int32_t)quantize_onnx_value(src[i * stride], factor, min_value, max_value);
+        }
+        return;
     }
 
-    if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2 != tensor_descriptor->tensor_shape_info.version) {
-        printf("convert onnx data to npu data fail: only support KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2 tensor shape ...\n");
-        status = KP_ERROR_INVALID_PARAM_12;
-        goto FUNC_OUT;
+    float factor = plan->quantization_factors[descriptor];
+
+#ifdef NPU_VEC_WIDTH
+    if (1 == stride)
+    {
+#if defined(__AVX2__)
+        __m256 factor_v = _mm256_set1_ps(factor);
+        __m256 min_v = _mm256_set1_ps(min_value);
+        __m256 max_v = _mm256_set1_ps(max_value);
+
+        for (; i + NPU_VEC_WIDTH <= count; i += NPU_VEC_WIDTH)
+        {
+            __m256 x = _mm256_mul_ps(_mm256_loadu_ps(src + i), factor_v);
+            _mm256_storeu_si256((__m256i *)(values + i), _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(x, min_v), max_v)));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        __m128 factor_v = _mm_set1_ps(factor);
+        __m128 min_v = _mm_set1_ps(min_value);
+        __m128 max_v = _mm_set1_ps(max_value);
+
+        for (; i + NPU_VEC_WIDTH <= count; i += NPU_VEC_WIDTH)
+        {
+            __m128 x = _mm_mul_ps(_mm_loadu_ps(src + i), factor_v);
+            _mm_storeu_si128((__m128i *)(values + i), _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x, min_v), max_v)));
+        }
+#else
+        float32x4_t factor_v = vdupq_n_f32(factor);
+        float32x4_t min_v = vdupq_n_f32(min_value);
+        float32x4_t max_v = vdupq_n_f32(max_value);
+
+        for (; i + NPU_VEC_WIDTH <= count; i += NPU_VEC_WIDTH)
+        {
+            float32x4_t x = vmulq_f32(vld1q_f32(src + i), factor_v);
+            vst1q_s32(values + i, vcvtnq_s32_f32(vminq_f32(vmaxq_f32(x, min_v), max_v)));
+        }
+#endif
     }
+#endif
 
-    quantization_parameters_v1  = &(tensor_descriptor->quantization_parameters.quantization_parameters_data.v1);
-    tensor_shape_info           = &(tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2);
-    npu_data_layout             = tensor_descriptor->data_layout;
+    for (; i < count; i++)
+        values[i] = (int32_t)quantize_onnx_value(src[i * stride], factor, min_value, max_value);
+}
+
+static void convert_onnx_rows(const helper_onnx_to_npu_plan_t *plan, const float *onnx_data_buf, uint8_t *npu_data_buf,
+                              int row_begin, int row_end, int32_t *values)
+{
+    const int32_t *inner_npu_offsets = plan->inner_npu_offsets;
+    const int count = plan->inner_count;
 
-    /* input data quantization */
+    for (int row = row_begin; row < row_end; row++)
     {
-        // get clip value by data layout
-        switch (npu_data_layout)
+        const int32_t npu_base = plan->row_npu_offsets[row];
+
+        if (KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT == plan->data_layout)
+        {
+            const float *src = onnx_data_buf + plan->row_onnx_offsets[row];
+            int descriptor = plan->row_descriptors[row];
+
+            for (int i = 0; i < count; i++)
+            {
+                int32_t onnx_offset = plan->row_onnx_offsets[row] + i * plan->inner_onnx_stride;
+                float factor = plan->quantization_factors[(0 > descriptor) ? onnx_offset / plan->quantized_axis_stride : descriptor];
+
+                ((float *)npu_data_buf)[npu_base + inner_npu_offsets[i]] =
+                    quantize_onnx_value(src[i * plan->inner_onnx_stride], factor, plan->quantization_min_value, plan->quantization_max_value);
+            }
+            continue;
+        }
+
+        quantize_onnx_row(plan, onnx_data_buf, row, values);
+
+        switch (plan->data_layout)
         {
-        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B:
-            quantization_max_value = 127.0f;
-            quantization_min_value = -128.0f;
-            break;
         case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
         case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
+            for (int i = 0; i < count; i++)
+                ((uint16_t *)npu_data_buf)[npu_base + inner_npu_offsets[i]] = (uint16_t)((uint16_t)(int16_t)values[i] & 0xfffeu);
+            break;
         case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
         case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
         case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
         case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
-            quantization_max_value = 32766.0f;
-            quantization_min_value = -32768.0f;
-            break;
-        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT:
-            quantization_max_value = FLT_MAX;
-            quantization_min_value = FLT_MIN;
+            for (int i = 0; i < count; i++)
+            {
+                // 16 low 7-bit entries are followed by the 16 high 8-bit entries of the same scalars
+                int32_t offset = npu_base + inner_npu_offsets[i];
+                uint16_t value = (uint16_t)((uint16_t)(int16_t)values[i] >> 1);
+
+                offset = ((offset >> 4) << 5) + (offset & 15);
+                npu_data_buf[offset] = (uint8_t)(value & 0x007fu);
+                npu_data_buf[offset + 16] = (uint8_t)((value >> 7) & 0x00ffu);
+            }
             break;
         default:
-            printf("error: get invalide data layout ...\n");
-            status = KP_ERROR_INVALID_MODEL_21;
-            goto FUNC_OUT;
+            for (int i = 0; i < count; i++)
+                ((int8_t *)npu_data_buf)[npu_base + inner_npu_offsets[i]] = (int8_t)values[i];
+            break;
         }
+    }
+}
 
-        // toolchain calculate the radix value from input data (after normalization), and set it into NEF model.
-        // NPU will divide input data "2^radix" automatically, so, we have to scaling the input data here due to this reason.
-        if (1 == quantization_parameters_v1->quantized_fixed_point_descriptor_num) {
-            // layer-wise quantize
-            radix = 0;
-            scale = 0;
-            if (KP_SUCCESS != helper_get_quantization_parameters_v1_information(quantization_parameters_v1, 0, &radix, &scale)) {
-                printf("error: get invalide KneronKNE_DataType_enum_t ...\n");
-                status = KP_ERROR_INVALID_MODEL_21;
-                goto FUNC_OUT;
-            }
+static void *convert_onnx_band_thread(void *data)
+{
+    onnx_to_npu_band_t *band = (onnx_to_npu_band_t *)data;
 
-            quantization_factor = powf(2, (float)radix) * scale;
+    convert_onnx_rows(band->plan, band->onnx_data_buf, band->npu_data_buf, band->row_begin, band->row_end, band->values);
 
-            for (onnx_data_buf_offset = 0; onnx_data_buf_offset < onnx_data_buf_size; onnx_data_buf_offset++) {
-                onnx_data_buf[onnx_data_buf_offset] = (float)kneron_round(onnx_data_buf[onnx_data_buf_offset] * quantization_factor);
-                onnx_data_buf[onnx_data_buf_offset] = MAX(quantization_min_value, MIN(onnx_data_buf[onnx_data_buf_offset], quantization_max_value));
-            }
-        } else if (1 < quantization_parameters_v1->quantized_fixed_point_descriptor_num) {
-            // channel-wise quantize
-            quantized_axis_stride = 1;
-            for (int axis = 0; axis < tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2.shape_len; axis++) {
-                if (axis != quantization_parameters_v1->quantized_axis) {
-                    quantized_axis_stride *= tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2.shape[axis];
-                }
-            }
+    return NULL;
+}
 
-            onnx_data_buf_offset = 0;
-            for (int quantized_fixed_point_descriptor_idx = 0; quantized_fixed_point_descriptor_idx < quantization_parameters_v1->quantized_fixed_point_descriptor_num; quantized_fixed_point_descriptor_idx++) {
-                radix = 0;
-                scale = 0;
+void helper_release_onnx_to_npu_plan(helper_onnx_to_npu_plan_t *plan)
+{
+    if (NULL == plan)
+        return;
 
-                if (KP_SUCCESS != helper_get_quantization_parameters_v1_information(quantization_parameters_v1, quantized_fixed_point_descriptor_idx, &radix, &scale)) {
-                    printf("error: get invalide KneronKNE_DataType_enum_t ...\n");
-                    status = KP_ERROR_INVALID_MODEL_21;
-                    goto FUNC_OUT;
-                }
+    free(plan->quantization_factors);
+    free(plan->inner_npu_offsets);
+    free(plan->row_onnx_offsets);
+    free(plan->row_npu_offsets);
+    free(plan->row_descriptors);
+    free(plan->row_values);
+    free(plan);
+}
 
-                quantization_factor = powf(2, (float)radix) * scale;
+helper_onnx_to_npu_plan_t *helper_create_onnx_to_npu_plan(kp_tensor_descriptor_t *tensor_descriptor, int thread_count)
+{
+    helper_onnx_to_npu_plan_t *plan                             = NULL;
+    kp_tensor_shape_info_v2_t *tensor_shape_info                = NULL;
+    kp_quantization_parameters_v1_t *quantization_parameters_v1 = NULL;
+    int32_t *shape_index                                        = NULL;
+    int shape_len                                               = 0;
+    int inner_axis                                              = 0;
+    int channel_idx                                             = -1;
+    int32_t npu_channel_group_stride                            = -1;
+    int32_t element_count                                       = 1;
+    int32_t npu_data_size                                       = 0;
+    int32_t max_npu_offset                                      = 0;
+    int element_size                                            = 1;
+
+    if ((NULL == tensor_descriptor) || (0 >= thread_count)) {
+        printf("error: invalid parameters ...\n");
+        return NULL;
+    }
 
-                for (int quantized_axis_offset = 0; quantized_axis_offset < quantized_axis_stride; quantized_axis_offset++) {
-                    onnx_data_buf[onnx_data_buf_offset] = (float)kneron_round(onnx_data_buf[onnx_data_buf_offset] * quantization_factor);
-                    onnx_data_buf[onnx_data_buf_offset] = MAX(quantization_min_value, MIN(onnx_data_buf[onnx_data_buf_offset], quantization_max_value));
-                    onnx_data_buf_offset += 1;
-                }
-            }
-        } else {
-            printf("error: get invalide number of quantized_fixed_point_descriptor ...\n");
-            status = KP_ERROR_INVALID_MODEL_21;
-            goto FUNC_OUT;
-        }
+    if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2 != tensor_descriptor->tensor_shape_info.version) {
+        printf("convert onnx data to npu data fail: only support KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2 tensor shape ...\n");
+        return NULL;
     }
 
-    /* re-layout the data to fit NPU data layout format */
+    quantization_parameters_v1  = &(tensor_descriptor->quantization_parameters.quantization_parameters_data.v1);
+    tensor_shape_info           = &(tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2);
+    shape_len                   = (int)tensor_shape_info->shape_len;
+
+    if ((0 >= shape_len) || (0 >= quantization_parameters_v1->quantized_fixed_point_descriptor_num)) {
+        printf("error: get invalide tensor shape or number of quantized_fixed_point_descriptor ...\n");
+        return NULL;
+    }
+
+    plan = (helper_onnx_to_npu_plan_t *)calloc(1, sizeof(helper_onnx_to_npu_plan_t));
+    if (NULL == plan) {
+        printf("error: malloc onnx to npu plan fail ...\n");
+        return NULL;
+    }
+
+    plan->data_layout = tensor_descriptor->data_layout;
+
+    /* clip values and element sizes by data layout */
+    switch (plan->data_layout)
     {
-        onnx_data_shape_index = calloc(tensor_shape_info->shape_len, sizeof(int32_t));
-        if (NULL == onnx_data_shape_index) {
-            printf("error: malloc working buffer onnx_data_shape_index fail ...\n");
-            status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
-            goto FUNC_OUT;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B:
+        plan->quantization_max_value = 127.0f;
+        plan->quantization_min_value = -128.0f;
+        element_size = sizeof(int8_t);
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+        plan->quantization_max_value = 32766.0f;
+        plan->quantization_min_value = -32768.0f;
+        element_size = sizeof(int16_t);
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT:
+        plan->quantization_max_value = FLT_MAX;
+        plan->quantization_min_value = FLT_MIN;
+        element_size = sizeof(float);
+        break;
+    default:
+        printf("error: get invalide data layout ...\n");
+        goto err;
+    }
+
+    /* quantization factors, NPU divides input data by 2^radix */
+    plan->descriptor_count = quantization_parameters_v1->quantized_fixed_point_descriptor_num;
+    plan->quantization_factors = (float *)malloc(sizeof(float) * plan->descriptor_count);
+    if (NULL == plan->quantization_factors) {
+        printf("error: malloc onnx to npu plan fail ...\n");
+        goto err;
+    }
+
+    for (int i = 0; i < plan->descriptor_count; i++) {
+        int32_t radix = 0;
+        float scale = 0;
+
+        if (KP_SUCCESS != helper_get_quantization_parameters_v1_information(quantization_parameters_v1, i, &radix, &scale)) {
+            printf("error: get invalide KneronKNE_DataType_enum_t ...\n");
+            goto err;
         }
 
-        switch (npu_data_layout)
-        {
-        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
-            for (int axis = 0; axis < (int)tensor_shape_info->shape_len; axis++) {
-                if (1 == tensor_shape_info->stride_npu[axis]) {
-                    channel_idx = axis;
-                    continue;
-                }
+        plan->quantization_factors[i] = powf(2, (float)radix) * scale;
+    }
 
-                npu_channel_group_stride_tmp = tensor_shape_info->stride_npu[axis] * tensor_shape_info->shape[axis];
-                if (npu_channel_group_stride_tmp > npu_channel_group_stride)
-                    npu_channel_group_stride = npu_channel_group_stride_tmp;
-            }
+    // layer-wise quantization uses one factor for all elements, channel-wise uses one per quantized_axis_stride onnx elements
+    plan->quantized_axis_stride = 1;
+    for (int axis = 0; axis < shape_len; axis++) {
+        element_count *= tensor_shape_info->shape[axis];
+        plan->onnx_data_size += (tensor_shape_info->shape[axis] - 1) * (int32_t)tensor_shape_info->stride_onnx[axis];
 
-            *npu_data_buf_size = (tensor_shape_info->shape[channel_idx] >> 4) * npu_channel_group_stride;
+        if (axis != quantization_parameters_v1->quantized_axis)
+            plan->quantized_axis_stride *= tensor_shape_info->shape[axis];
+    }
+    plan->onnx_data_size += 1;
 
-            if (0 != (tensor_shape_info->shape[channel_idx] % 16)) {
-                *npu_data_buf_size += npu_channel_group_stride;
+    if (1 == plan->descriptor_count)
+        plan->quantized_axis_stride = plan->onnx_data_size;
+
+    if ((0 >= element_count) || (plan->descriptor_count * plan->quantized_axis_stride < plan->onnx_data_size)) {
+        printf("error: quantized_fixed_point_descriptor does not cover the tensor ...\n");
+        goto err;
+    }
+
+    /* npu buffer size */
+    if ((KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B == plan->data_layout) || (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL == plan->data_layout)) {
+        // 16 channels are interleaved per group, groups are npu_channel_group_stride scalars apart
+        for (int axis = 0; axis < shape_len; axis++) {
+            if (1 == tensor_shape_info->stride_npu[axis]) {
+                channel_idx = axis;
+                continue;
             }
 
-            /* reuse for npu_data_buf_offset calculate (without reset the ) */
-            npu_channel_group_stride -= 16;
-            break;
-        default:
-        for (int axis = 0; axis < tensor_shape_info->shape_len; axis++) {
+            if ((int32_t)tensor_shape_info->stride_npu[axis] * tensor_shape_info->shape[axis] > npu_channel_group_stride)
+                npu_channel_group_stride = (int32_t)tensor_shape_info->stride_npu[axis] * tensor_shape_info->shape[axis];
+        }
+
+        if (0 > channel_idx) {
+            printf("error: get invalide channel stride of data layout ...\n");
+            goto err;
+        }
+
+        npu_data_size = (tensor_shape_info->shape[channel_idx] >> 4) * npu_channel_group_stride;
+
+        if (0 != (tensor_shape_info->shape[channel_idx] % 16))
+            npu_data_size += npu_channel_group_stride;
+
+        npu_channel_group_stride -= 16;
+    } else {
+        uint32_t max_npu_stride = 0;
+        int max_npu_stride_axis = 0;
+
+        for (int axis = 0; axis < shape_len; axis++) {
             if (tensor_shape_info->stride_npu[axis] > max_npu_stride) {
                 max_npu_stride      = tensor_shape_info->stride_npu[axis];
                 max_npu_stride_axis = axis;
             }
         }
 
-            *npu_data_buf_size = tensor_shape_info->shape[max_npu_stride_axis] * max_npu_stride;
+        npu_data_size = tensor_shape_info->shape[max_npu_stride_axis] * max_npu_stride;
+    }
+
+    plan->npu_data_buf_size = npu_data_size * element_size;
+
+    /* rows along the contiguous onnx axis, or the longest axis */
+    inner_axis = -1;
+    for (int axis = 0; axis < shape_len; axis++) {
+        if ((1 == tensor_shape_info->stride_onnx[axis]) && (1 < tensor_shape_info->shape[axis])) {
+            inner_axis = axis;
             break;
         }
+    }
 
-        switch (npu_data_layout)
-        {
-        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B:
-            *npu_data_buf_size  = *npu_data_buf_size * sizeof(int8_t);
-            *npu_data_buf       = realloc(*npu_data_buf, *npu_data_buf_size);
-
-            if (NULL == *npu_data_buf) {
-                printf("error: malloc working buffer npu_data_buf fail ...\n");
-                status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
-                goto FUNC_OUT;
-            }
+    if (0 > inner_axis) {
+        inner_axis = 0;
+        for (int axis = 1; axis < shape_len; axis++) {
+            if (tensor_shape_info->shape[axis] > tensor_shape_info->shape[inner_axis])
+                inner_axis = axis;
+        }
+    }
 
-            memset(*npu_data_buf, 0, *npu_data_buf_size);
+    plan->inner_count = tensor_shape_info->shape[inner_axis];
+    plan->inner_onnx_stride = (int32_t)tensor_shape_info->stride_onnx[inner_axis];
+    plan->row_count = element_count / plan->inner_count;
 
-            while (true) {
-                onnx_data_buf_offset    = 0;
-                npu_data_buf_offset     = 0;
+    plan->inner_npu_offsets = (int32_t *)malloc(sizeof(int32_t) * plan->inner_count);
+    plan->row_onnx_offsets = (int32_t *)malloc(sizeof(int32_t) * plan->row_count);
+    plan->row_npu_offsets = (int32_t *)malloc(sizeof(int32_t) * plan->row_count);
+    plan->row_descriptors = (int32_t *)malloc(sizeof(int32_t) * plan->row_count);
+    shape_index = (int32_t *)calloc(shape_len, sizeof(int32_t));
 
-                for (int32_t axis = 0; axis < tensor_shape_info->shape_len; axis++) {
-                    onnx_data_buf_offset    += onnx_data_shape_index[axis] * tensor_shape_info->stride_onnx[axis];
-                    npu_data_buf_offset     += onnx_data_shape_index[axis] * tensor_shape_info->stride_npu[axis];
-                }
+    if ((NULL == plan->inner_npu_offsets) || (NULL == plan->row_onnx_offsets) || (NULL == plan->row_npu_offsets) ||
+        (NULL == plan->row_descriptors) || (NULL == shape_index)) {
+        printf("error: malloc onnx to npu plan fail ...\n");
+        goto err;
+    }
 
-                if (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B == npu_data_layout) {
-                    /* npu_data_buf_offset += (onnx_data_shape_index[channel_idx] / 16) * npu_channel_group_stride; */
-                    npu_data_buf_offset += (onnx_data_shape_index[channel_idx] >> 4) * npu_channel_group_stride;
-                }
+    for (int i = 0; i < plan->inner_count; i++) {
+        plan->inner_npu_offsets[i] = i * (int32_t)tensor_shape_info->stride_npu[inner_axis];
 
-                ((int8_t *)*npu_data_buf)[npu_data_buf_offset] = (int8_t)onnx_data_buf[onnx_data_buf_offset];
+        if (inner_axis == channel_idx)
+            plan->inner_npu_offsets[i] += (i >> 4) * npu_channel_group_stride;
+    }
 
-                for (int32_t axis = tensor_shape_info->shape_len - 1; axis >= 0; axis--) {
-                    onnx_data_shape_index[axis]++;
-                    if (onnx_data_shape_index[axis] == tensor_shape_info->shape[axis]) {
-                        if (axis == 0)
-                            break;
+    for (int row = 0; row < plan->row_count; row++) {
+        int32_t onnx_offset = 0;
+        int32_t npu_offset = 0;
+        int32_t first_descriptor;
+        int32_t last_descriptor;
 
-                        onnx_data_shape_index[axis] = 0;
-                        continue;
-                    } else {
-                        break;
-                    }
-                }
+        for (int axis = 0; axis < shape_len; axis++) {
+            onnx_offset += shape_index[axis] * (int32_t)tensor_shape_info->stride_onnx[axis];
+            npu_offset  += shape_index[axis] * (int32_t)tensor_shape_info->stride_npu[axis];
+        }
 
-                if (onnx_data_shape_index[0] == tensor_shape_info->shape[0]) {
-                    break;
-                }
-            }
-            break;
-        case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
-            *npu_data_buf_size  = *npu_data_buf_size * sizeof(int16_t);
-            *npu_data_buf       = realloc(*npu_data_buf, *npu_data_buf_size);
+        if ((0 <= channel_idx) && (inner_axis != channel_idx))
+            npu_offset += (shape_index[channel_idx] >> 4) * npu_channel_group_stride;
 
-            if (NULL == *npu_data_buf) {
-                printf("error: malloc working buffer npu_data_buf fail ...\n");
-                status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
-                goto FUNC_OUT;
-            }
+        first_descriptor = onnx_offset / plan->quantized_axis_stride;
+        last_descriptor = (onnx_offset + (plan->inner_count - 1) * plan->inner_onnx_stride) / plan->quantized_axis_stride;
 
-            memset(*npu_data_buf, 0, *npu_data_buf_size);
+        plan->row_onnx_offsets[row] = onnx_offset;
+        plan->row_npu_offsets[row] = npu_offset;
+        plan->row_descriptors[row] = (first_descriptor == last_descriptor) ? first_descriptor : -1;
 
-            while (true) {
-                onnx_data_buf_offset    = 0;
-                npu_data_buf_offset     = 0;
+        if (max_npu_offset < npu_offset)
+            max_npu_offset = npu_offset;
 
-                for (int32_t axis = 0; axis < tensor_shape_info->shape_len; axis++) {
-                    onnx_data_buf_offset    += onnx_data_shape_index[axis] * tensor_shape_info->stride_onnx[axis];
-                    npu_data_buf_offset     += onnx_data_shape_index[axis] * tensor_shape_info->stride_npu[axis];
-                }
+        // next index of the axes other than the inner axis
+        for (int axis = shape_len - 1; axis >= 0; axis--) {
+            if (axis == inner_axis)
+                continue;
 
-                npu_data_element_i16b                               = (int16_t)onnx_data_buf[onnx_data_buf_offset];
-                npu_data_element_u16b                               = *((uint16_t *)(&npu_data_element_i16b));
-                ((uint16_t *)*npu_data_buf)[npu_data_buf_offset]    = (npu_data_element_u16b & 0xfffeu);
-
-                for (int32_t axis = tensor_shape_info->shape_len - 1; axis >= 0; axis--) {
-                    onnx_data_shape_index[axis]++;
-                    if (onnx_data_shape_index[axis] == tensor_shape_info->shape[axis]) {
-                        if (axis == 0)
-                            break;
-
-                        onnx_data_shape_index[axis] = 0;
-                        continue;
-                    } else {
-                        break;
-                    }
-                }
+            if (++shape_index[axis] < tensor_shape_info->shape[axis])
+                break;
 
-                if (onnx_data_shape_index[0] == tensor_shape_info->shape[0])
-                    break;
-            }
-            break;
-        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
-        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
-            *npu_data_buf_size  = *npu_data_buf_size * sizeof(uint16_t);
-            *npu_data_buf       = realloc(*npu_data_buf, *npu_data_buf_size);
+            shape_index[axis] = 0;
+        }
+    }
 
-            if (NULL == *npu_data_buf) {
-                printf("error: malloc working buffer npu_data_buf fail ...\n");
-                status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
-                goto FUNC_OUT;
-            }
+    max_npu_offset += plan->inner_npu_offsets[plan->inner_count - 1];
 
-            memset(*npu_data_buf, 0, *npu_data_buf_size);
+    switch (plan->data_layout)
+    {
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+        max_npu_offset = ((max_npu_offset >> 4) << 5) + (max_npu_offset & 15) + 16;
+        element_size = 1;
+        break;
+    default:
+        break;
+    }
 
-            while (true) {
-                onnx_data_buf_offset    = 0;
-                npu_data_buf_offset     = 0;
+    if ((max_npu_offset + 1) * element_size > plan->npu_data_buf_size) {
+        printf("error: npu stride of tensor exceeds npu data size ...\n");
+        goto err;
+    }
 
-                for (int32_t axis = 0; axis < tensor_shape_info->shape_len; axis++) {
-                    onnx_data_buf_offset    += onnx_data_shape_index[axis] * tensor_shape_info->stride_onnx[axis];
-                    npu_data_buf_offset     += onnx_data_shape_index[axis] * tensor_shape_info->stride_npu[axis];
-                }
+    /* threads convert bands of rows, each with its own row of quantized values */
+    if (thread_count > element_count / HELPER_NPU_DATA_MIN_ELEMENTS_PER_THREAD)
+        thread_count = element_count / HELPER_NPU_DATA_MIN_ELEMENTS_PER_THREAD;
+    if (thread_count > plan->row_count)
+        thread_count = plan->row_count;
+    if (thread_count > HELPER_NPU_DATA_MAX_THREAD_COUNT)
+        thread_count = HELPER_NPU_DATA_MAX_THREAD_COUNT;
 
-                if (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL == npu_data_layout) {
-                    /* npu_data_buf_offset += (onnx_data_shape_index[channel_idx] / 16) * npu_channel_group_stride; */
-                    npu_data_buf_offset += (onnx_data_shape_index[channel_idx] >> 4) * npu_channel_group_stride;
-                }
+    plan->thread_count = (1 > thread_count) ? 1 : thread_count;
+    plan->row_values = (int32_t *)malloc(sizeof(int32_t) * plan->inner_count * plan->thread_count);
 
-                /* npu_data_buf_offset = (npu_data_buf_offset / 16) * 32 + (npu_data_buf_offset % 16) */
-                npu_data_buf_offset = ((npu_data_buf_offset >> 4) << 5) + (npu_data_buf_offset & 15u);
-
-                npu_data_element_i16b                                                       = (int16_t)onnx_data_buf[onnx_data_buf_offset];
-                npu_data_element_u16b                                                       = ((*((uint16_t *)(&npu_data_element_i16b))) >> 1);
-                ((uint8_t *)*npu_data_buf)[npu_data_buf_offset]                             = (uint8_t)(npu_data_element_u16b & 0x007fu);
-                ((uint8_t *)*npu_data_buf)[npu_data_buf_offset + npu_data_high_bit_offset]  = (uint8_t)((npu_data_element_u16b >> 7) & 0x00ffu);
-
-                for (int32_t axis = tensor_shape_info->shape_len - 1; axis >= 0; axis--) {
-                    onnx_data_shape_index[axis]++;
-                    if (onnx_data_shape_index[axis] == tensor_shape_info->shape[axis]) {
-                        if (axis == 0)
-                            break;
-
-                        onnx_data_shape_index[axis] = 0;
-                        continue;
-                    } else {
-                        break;
-                    }
-                }
+    if (NULL == plan->row_values) {
+        printf("error: malloc onnx to npu plan fail ...\n");
+        goto err;
+    }
 
-                if (onnx_data_shape_index[0] == tensor_shape_info->shape[0])
-                    break;
-            }
-            break;
-        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT:
-            *npu_data_buf_size  = *npu_data_buf_size * sizeof(float);
-            *npu_data_buf        = realloc(*npu_data_buf, *npu_data_buf_size);
-
-            if (NULL == *npu_data_buf) {
-                printf("error: malloc working buffer npu_data_buf fail ...\n");
-                status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
-                goto FUNC_OUT;
-            }
+    free(shape_index);
 
-            while (true) {
-                onnx_data_buf_offset    = 0;
-                npu_data_buf_offset     = 0;
+    return plan;
 
-                for (int32_t axis = 0; axis < tensor_shape_info->shape_len; axis++) {
-                    onnx_data_buf_offset    += onnx_data_shape_index[axis] * tensor_shape_info->stride_onnx[axis];
-                    npu_data_buf_offset     += onnx_data_shape_index[axis] * tensor_shape_info->stride_npu[axis];
-                }
+err:
+    free(shape_index);
+    helper_release_onnx_to_npu_plan(plan);
 
-                ((float *)*npu_data_buf)[npu_data_buf_offset] = (float)onnx_data_buf[onnx_data_buf_offset];
+    return NULL;
+}
 
-                for (int32_t axis = tensor_shape_info->shape_len - 1; axis >= 0; axis--) {
-                    onnx_data_shape_index[axis]++;
-                    if (onnx_data_shape_index[axis] == tensor_shape_info->shape[axis]) {
-                        if (axis == 0)
-                            break;
+int32_t helper_get_onnx_to_npu_plan_npu_data_size(helper_onnx_to_npu_plan_t *plan)
+{
+    return (NULL == plan) ? 0 : plan->npu_data_buf_size;
+}
 
-                        onnx_data_shape_index[axis] = 0;
-                        continue;
-                    } else {
-                        break;
-                    }
-                }
+int helper_convert_onnx_data_to_npu_data_with_plan(helper_onnx_to_npu_plan_t *plan, const float *onnx_data_buf, int32_t onnx_data_buf_size,
+                                                   int8_t *npu_data_buf, int32_t npu_data_buf_size)
+{
+    pthread_t threads[HELPER_NPU_DATA_MAX_THREAD_COUNT];
+    onnx_to_npu_band_t bands[HELPER_NPU_DATA_MAX_THREAD_COUNT];
+    bool created[HELPER_NPU_DATA_MAX_THREAD_COUNT] = {false};
 
-                if (onnx_data_shape_index[0] == tensor_shape_info->shape[0]) {
-                    break;
-                }
-            }
-            break;
-        }
+    if ((NULL == plan) || (NULL == onnx_data_buf) || (NULL == npu_data_buf) ||
+        (onnx_data_buf_size < plan->onnx_data_size) || (npu_data_buf_size < plan->npu_data_buf_size)) {
+        printf("convert onnx data to npu data fail: invalid parameters ...\n");
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    // scalars not covered by the tensor are zero
+    memset(npu_data_buf, 0, plan->npu_data_buf_size);
+
+    for (int i = 0; i < plan->thread_count; i++) {
+        bands[i].plan           = plan;
+        bands[i].onnx_data_buf  = onnx_data_buf;
+        bands[i].npu_data_buf   = (uint8_t *)npu_data_buf;
+        bands[i].row_begin      = (int)((long long)plan->row_count * i / plan->thread_count);
+        bands[i].row_end        = (int)((long long)plan->row_count * (i + 1) / plan->thread_count);
+        bands[i].values         = plan->row_values + (size_t)plan->inner_count * i;
     }
 
-FUNC_OUT:
-    if (NULL != onnx_data_shape_index)
-        free(onnx_data_shape_index);
+    // the calling thread converts the first band, a band is converted in the calling thread as well if its thread can not be created
+    for (int i = 1; i < plan->thread_count; i++)
+        created[i] = (0 == pthread_create(&threads[i], NULL, convert_onnx_band_thread, &bands[i]));
+
+    convert_onnx_band_thread(&bands[0]);
+
+    for (int i = 1; i < plan->thread_count; i++) {
+        if (created[i])
+            pthread_join(threads[i], NULL);
+        else
+            convert_onnx_band_thread(&bands[i]);
+    }
+
+    return KP_SUCCESS;
+}
+
+int helper_convert_onnx_data_to_npu_data(kp_tensor_descriptor_t *tensor_descriptor, float *onnx_data_buf, int32_t onnx_data_buf_size, int8_t **npu_data_buf, int32_t *npu_data_buf_size)
+{
+    int status                          = KP_SUCCESS;
+    helper_onnx_to_npu_plan_t *plan     = NULL;
+    int8_t *buf                         = NULL;
+
+    if (NULL == tensor_descriptor ||
+        NULL == onnx_data_buf ||
+        0 == onnx_data_buf_size ||
+        NULL == npu_data_buf ||
+        NULL == npu_data_buf_size) {
+        printf("convert onnx data to npu data fail: NULL pointer input parameters ...\n");
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    plan = helper_create_onnx_to_npu_plan(tensor_descriptor, HELPER_NPU_DATA_CONVERT_THREAD_COUNT);
+    if (NULL == plan)
+        return KP_ERROR_INVALID_MODEL_21;
+
+    buf = realloc(*npu_data_buf, plan->npu_data_buf_size);
+    if (NULL == buf) {
+        printf("error: malloc working buffer npu_data_buf fail ...\n");
+        helper_release_onnx_to_npu_plan(plan);
+        return KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+    }
+
+    *npu_data_buf       = buf;
+    *npu_data_buf_size  = plan->npu_data_buf_size;
+
+    status = helper_convert_onnx_data_to_npu_data_with_plan(plan, onnx_data_buf, onnx_data_buf_size, *npu_data_buf, *npu_data_buf_size);
+
+    helper_release_onnx_to_npu_plan(plan);
 
     return status;
 }
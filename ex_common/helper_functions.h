@@ -48,6 +48,7 @@ void helper_print_model_info(kp_model_nef_descriptor_t *pModel_desc);
 
 void helper_get_device_usb_speed_by_port_id(kp_devices_list_t *devices_list, int port_id, int *link_speed);
 
+// deprecated, use post_process_tracker_t of postprocess.h to keep objects identified over frames
 // box_count_last and boxes_last: box count and all boxes info in the last image frame
 // box_count_lastest and boxes_lastest: box count and all boxes info in the current image frame
 // box_count_stabilized and boxes_stabilized: stabilized boxes result and the total count of them
@@ -59,5 +60,16 @@ void helper_bounding_box_stabilization(uint32_t box_count_last, kp_bounding_box_
 void helper_convert_rgb888_to_bmp(const char *out_bmp_path, uint32_t width, uint32_t height, uint8_t *rgb888_buf);
 
 int helper_get_quantization_parameters_v1_information(kp_quantization_parameters_v1_t* quantization_parameters_v1, int quantized_fixed_point_descriptor_idx, int *radix, float *scale);
+// onnx_data_buf is read only, it is no longer quantized in place; npu scalars not covered by the tensor are zero, also for RAW_FLOAT
+// where they were left uninitialized
 int helper_convert_onnx_data_to_npu_data(kp_tensor_descriptor_t *tensor_descriptor, float *onnx_data_buf, int32_t onnx_data_buf_size, int8_t **npu_data_buf, int32_t *npu_data_buf_size);
+
+// a plan keeps the re-layout of a tensor to convert many inputs of it, onnx_data_buf_size is in floats
+// the npu_data_buf of the plan version is allocated by the caller with the plan's npu data size (in bytes)
+typedef struct helper_onnx_to_npu_plan_s helper_onnx_to_npu_plan_t;
+helper_onnx_to_npu_plan_t *helper_create_onnx_to_npu_plan(kp_tensor_descriptor_t *tensor_descriptor, int thread_count);
+void helper_release_onnx_to_npu_plan(helper_onnx_to_npu_plan_t *plan);
+int32_t helper_get_onnx_to_npu_plan_npu_data_size(helper_onnx_to_npu_plan_t *plan);
+int helper_convert_onnx_data_to_npu_data_with_plan(helper_onnx_to_npu_plan_t *plan, const float *onnx_data_buf, int32_t onnx_data_buf_size,
+                                                   int8_t *npu_data_buf, int32_t npu_data_buf_size);
 #endif
@@ -0,0 +1,451 @@
+/**
+ * @file        image_cache.c
+ * @brief       image loader with a cache of converted images
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "image_cache.h"
+#include "image_convert.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define IMAGE_CACHE_BUCKET_COUNT 256
+#define IMAGE_CACHE_CONVERT_THREAD_COUNT 4
+#define IMAGE_CACHE_BMP_HEADER_SIZE 54      // file header and info header of BMP
+#define IMAGE_CACHE_BMP_MAX_SIDE 32768      // max width and height of BMP, rows of 3-byte pixels stay far from INT_MAX
+
+typedef struct image_cache_entry_s
+{
+    char *path;
+    bool is_bmp;
+    int width;                              // requested size of raw files, 0 for BMP files
+    int height;
+    kp_image_format_t format;
+    uint32_t hash;
+    image_cache_image_t image;
+    void *mapping;                          // mapped file of a raw image, NULL if the buffer is converted
+    size_t mapping_size;
+    struct image_cache_entry_s *bucket_next;
+    struct image_cache_entry_s *newer;      // LRU list from the most recently used
+    struct image_cache_entry_s *older;
+} image_cache_entry_t;
+
+struct image_cache_s
+{
+    size_t max_bytes;
+    size_t cached_bytes;
+    uint32_t hit_count;
+    uint32_t miss_count;
+    image_cache_entry_t *buckets[IMAGE_CACHE_BUCKET_COUNT];
+    image_cache_entry_t *newest;
+    image_cache_entry_t *oldest;
+};
+
+/* map a whole file read-only, the file is read into memory where mmap is not available */
+static void *map_file(const char *file_path, size_t *size)
+{
+#if defined(_WIN32)
+    void *data = NULL;
+    long file_size;
+    FILE *file = fopen(file_path, "rb");
+
+    if (NULL == file)
+        return NULL;
+
+    if ((0 == fseek(file, 0, SEEK_END)) && (0 < (file_size = ftell(file))) && (0 == fseek(file, 0, SEEK_SET)))
+    {
+        data = malloc(file_size);
+
+        if ((NULL != data) && ((size_t)file_size != fread(data, 1, file_size, file)))
+        {
+            free(data);
+            data = NULL;
+        }
+
+        *size = (size_t)file_size;
+    }
+
+    fclose(file);
+
+    return data;
+#else
+    void *data;
+    struct stat file_stat;
+    int fd = open(file_path, O_RDONLY);
+
+    if (0 > fd)
+        return NULL;
+
+    if ((0 != fstat(fd, &file_stat)) || (0 >= file_stat.st_size))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    *size = (size_t)file_stat.st_size;
+    data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping stays valid after the file is closed
+    close(fd);
+
+    return (MAP_FAILED == data) ? NULL : data;
+#endif
+}
+
+static void unmap_file(void *data, size_t size)
+{
+#if defined(_WIN32)
+    free(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+static uint32_t entry_hash(const char *path, bool is_bmp, int width, int height, kp_image_format_t format)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    uint32_t values[4] = {is_bmp, (uint32_t)width, (uint32_t)height, (uint32_t)format};
+
+    for (const char *c = path; *c; c++)
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+
+    for (int i = 0; i < 4; i++)
+        hash = (hash ^ values[i]) * 16777619u;
+
+    return hash;
+}
+
+static void unlink_lru(image_cache_t *cache, image_cache_entry_t *entry)
+{
+    if (entry->newer)
+        entry->newer->older = entry->older;
+    else
+        cache->newest = entry->older;
+
+    if (entry->older)
+        entry->older->newer = entry->newer;
+    else
+        cache->oldest = entry->newer;
+
+    entry->newer = NULL;
+    entry->older = NULL;
+}
+
+static void push_newest(image_cache_t *cache, image_cache_entry_t *entry)
+{
+    entry->older = cache->newest;
+    entry->newer = NULL;
+
+    if (cache->newest)
+        cache->newest->newer = entry;
+    else
+        cache->oldest = entry;
+
+    cache->newest = entry;
+}
+
+static void free_entry(image_cache_entry_t *entry)
+{
+    if (NULL != entry->mapping)
+        unmap_file(entry->mapping, entry->mapping_size);
+    else
+        free(entry->image.buffer);
+
+    free(entry->path);
+    free(entry);
+}
+
+static void evict_entry(image_cache_t *cache, image_cache_entry_t *entry)
+{
+    image_cache_entry_t **link = &cache->buckets[entry->hash % IMAGE_CACHE_BUCKET_COUNT];
+
+    while (*link != entry)
+        link = &(*link)->bucket_next;
+
+    *link = entry->bucket_next;
+
+    unlink_lru(cache, entry);
+    cache->cached_bytes -= entry->image.size;
+    free_entry(entry);
+}
+
+/* find a cached image and make it the most recently used one */
+static image_cache_entry_t *find_entry(image_cache_t *cache, const char *path, bool is_bmp, int width, int height, kp_image_format_t format)
+{
+    uint32_t hash = entry_hash(path, is_bmp, width, height, format);
+
+    for (image_cache_entry_t *entry = cache->buckets[hash % IMAGE_CACHE_BUCKET_COUNT]; entry; entry = entry->bucket_next)
+    {
+        if ((entry->hash == hash) && (entry->is_bmp == is_bmp) && (entry->width == width) && (entry->height == height) &&
+            (entry->format == format) && (0 == strcmp(entry->path, path)))
+        {
+            unlink_lru(cache, entry);
+            push_newest(cache, entry);
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static image_cache_entry_t *new_entry(const char *path, bool is_bmp, int width, int height, kp_image_format_t format)
+{
+    image_cache_entry_t *entry = (image_cache_entry_t *)calloc(1, sizeof(image_cache_entry_t));
+
+    if (NULL == entry)
+        return NULL;
+
+    entry->path = strdup(path);
+    if (NULL == entry->path)
+    {
+        free(entry);
+        return NULL;
+    }
+
+    entry->is_bmp = is_bmp;
+    entry->width = width;
+    entry->height = height;
+    entry->format = format;
+    entry->hash = entry_hash(path, is_bmp, width, height, format);
+
+    return entry;
+}
+
+/* add a loaded image as the most recently used one, and evict the least recently used images beyond the max bytes */
+static void insert_entry(image_cache_t *cache, image_cache_entry_t *entry)
+{
+    image_cache_entry_t **bucket = &cache->buckets[entry->hash % IMAGE_CACHE_BUCKET_COUNT];
+
+    entry->bucket_next = *bucket;
+    *bucket = entry;
+
+    push_newest(cache, entry);
+    cache->cached_bytes += entry->image.size;
+
+    while ((cache->cached_bytes > cache->max_bytes) && (cache->oldest != entry))
+        evict_entry(cache, cache->oldest);
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int load_bmp(image_cache_entry_t *entry, const char *file_path)
+{
+    size_t file_size = 0;
+    uint8_t *file = (uint8_t *)map_file(file_path, &file_size);
+    uint32_t offset;
+    int width;
+    int height;
+    bool top_down;
+    int stride;
+    int size;
+    const uint8_t *first_row;
+    int ret = -1;
+
+    if (NULL == file)
+    {
+        printf("Error! %s(): open %s failed (%s)\n", __FUNCTION__, file_path, strerror(errno));
+        return -1;
+    }
+
+    if ((IMAGE_CACHE_BMP_HEADER_SIZE > file_size) || ('B' != file[0]) || ('M' != file[1]) || (24 != (file[28] | (file[29] << 8))))
+    {
+        printf("Error! %s(): %s is not a 24-bit BMP file\n", __FUNCTION__, file_path);
+        goto out;
+    }
+
+    offset = read_le32(file + 10);
+    width = (int)read_le32(file + 18);
+    height = (int)read_le32(file + 22);
+
+    // the size comes from the file, it is checked before row and buffer sizes are computed from it
+    if ((0 >= width) || (IMAGE_CACHE_BMP_MAX_SIDE < width) || (0 == height) || (-IMAGE_CACHE_BMP_MAX_SIDE > height) || (IMAGE_CACHE_BMP_MAX_SIDE < height))
+    {
+        printf("Error! %s(): %s has an invalid size %d x %d\n", __FUNCTION__, file_path, width, height);
+        goto out;
+    }
+
+    // a negative height stores rows from top to bottom
+    top_down = (0 > height);
+    if (top_down)
+        height = -height;
+
+    // rows are padded to 4 bytes
+    stride = (width * 3 + 3) & ~3;
+    size = image_convert_buffer_size(width, height, entry->format);
+
+    if ((0 > size) || ((unsigned long long)offset + (unsigned long long)stride * height > file_size))
+    {
+        printf("Error! %s(): %s is not supported for image format 0x%x\n", __FUNCTION__, file_path, entry->format);
+        goto out;
+    }
+
+    entry->image.buffer = (uint8_t *)malloc(size);
+    if (NULL == entry->image.buffer)
+    {
+        printf("Error! %s(): memory allocation failed\n", __FUNCTION__);
+        goto out;
+    }
+
+    first_row = top_down ? file + offset : file + offset + (size_t)stride * (height - 1);
+
+    ret = image_convert_from_rgb888(first_row, top_down ? stride : -stride, IMAGE_CONVERT_ORDER_BGR, width, height,
+                                    entry->format, entry->image.buffer, IMAGE_CACHE_CONVERT_THREAD_COUNT);
+
+    entry->image.size = size;
+    entry->image.width = width;
+    entry->image.height = height;
+    entry->image.format = entry->format;
+
+out:
+    unmap_file(file, file_size);
+
+    return ret;
+}
+
+image_cache_t *image_cache_create(size_t max_bytes)
+{
+    image_cache_t *cache = (image_cache_t *)calloc(1, sizeof(image_cache_t));
+
+    if (NULL == cache)
+    {
+        printf("Error! %s(): memory allocation failed\n", __FUNCTION__);
+        return NULL;
+    }
+
+    cache->max_bytes = max_bytes;
+
+    return cache;
+}
+
+void image_cache_release(image_cache_t *cache)
+{
+    if (NULL == cache)
+        return;
+
+    while (cache->oldest)
+        evict_entry(cache, cache->oldest);
+
+    free(cache);
+}
+
+int image_cache_get_bmp(image_cache_t *cache, const char *file_path, kp_image_format_t format, image_cache_image_t *image)
+{
+    image_cache_entry_t *entry;
+
+    if ((NULL == cache) || (NULL == file_path) || (NULL == image))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    entry = find_entry(cache, file_path, true, 0, 0, format);
+
+    if (NULL != entry)
+    {
+        cache->hit_count++;
+        *image = entry->image;
+        return 0;
+    }
+
+    entry = new_entry(file_path, true, 0, 0, format);
+
+    if (NULL == entry)
+    {
+        printf("Error! %s(): memory allocation failed\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (0 != load_bmp(entry, file_path))
+    {
+        free_entry(entry);
+        return -1;
+    }
+
+    cache->miss_count++;
+    insert_entry(cache, entry);
+    *image = entry->image;
+
+    return 0;
+}
+
+int image_cache_get_raw(image_cache_t *cache, const char *file_path, int width, int height, kp_image_format_t format, image_cache_image_t *image)
+{
+    image_cache_entry_t *entry;
+    int size = image_convert_buffer_size(width, height, format);
+
+    if ((NULL == cache) || (NULL == file_path) || (NULL == image) || (0 > size))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    entry = find_entry(cache, file_path, false, width, height, format);
+
+    if (NULL != entry)
+    {
+        cache->hit_count++;
+        *image = entry->image;
+        return 0;
+    }
+
+    entry = new_entry(file_path, false, width, height, format);
+
+    if (NULL == entry)
+    {
+        printf("Error! %s(): memory allocation failed\n", __FUNCTION__);
+        return -1;
+    }
+
+    entry->mapping = map_file(file_path, &entry->mapping_size);
+
+    if ((NULL == entry->mapping) || (entry->mapping_size != (size_t)size))
+    {
+        if (NULL == entry->mapping)
+            printf("Error! %s(): open %s failed (%s)\n", __FUNCTION__, file_path, strerror(errno));
+        else
+            printf("Error! %s(): file size does not match input image width, height or format\n", __FUNCTION__);
+
+        free_entry(entry);
+        return -1;
+    }
+
+    entry->image.buffer = (uint8_t *)entry->mapping;
+    entry->image.size = size;
+    entry->image.width = width;
+    entry->image.height = height;
+    entry->image.format = format;
+
+    cache->miss_count++;
+    insert_entry(cache, entry);
+    *image = entry->image;
+
+    return 0;
+}
+
+void image_cache_get_statistics(image_cache_t *cache, uint32_t *hit_count, uint32_t *miss_count, size_t *cached_bytes)
+{
+    if (NULL != hit_count)
+        *hit_count = cache->hit_count;
+    if (NULL != miss_count)
+        *miss_count = cache->miss_count;
+    if (NULL != cached_bytes)
+        *cached_bytes = cache->cached_bytes;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file        image_cache.h
+ * @brief       image loader with a cache of converted images
+ *
+ * Image files are mapped into memory instead of being read with fread, converted once into the raw image format to be sent,
+ * and kept in a LRU (least recently used) cache keyed by path, size and format, so repeated inferences on an image set reuse
+ * ready-to-send buffers and file I/O and conversion stay out of benchmark timing.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kp_struct.h"
+
+/**
+ * @brief One cached image.
+ */
+typedef struct
+{
+    uint8_t *buffer;                        /**< image in 'format', ready to be set as 'image_buffer' of an input image (read only) */
+    int size;                               /**< bytes of the image */
+    int width;                              /**< image width */
+    int height;                             /**< image height */
+    kp_image_format_t format;               /**< image format, refer to kp_image_format_t */
+} image_cache_image_t;
+
+/**
+ * @brief Cache of converted images.
+ *
+ * The buffer of an image stays valid until the image is evicted to make room for other images or the cache is released.
+ * The image returned last is never evicted. A cache is not thread-safe.
+ */
+typedef struct image_cache_s image_cache_t;
+
+/**
+ * @brief Create an empty cache.
+ *
+ * @param[in] max_bytes max total bytes of the cached images, the least recently used images are evicted beyond it.
+ *
+ * @return the cache, NULL if failed.
+ */
+image_cache_t *image_cache_create(size_t max_bytes);
+
+/**
+ * @brief Release a cache and all of its images.
+ *
+ * @param[in] cache the cache.
+ */
+void image_cache_release(image_cache_t *cache);
+
+/**
+ * @brief Get a 24-bit BMP file converted to a raw image format, as helper_bmp_file_to_raw_buffer() converts it.
+ *
+ * @param[in] cache the cache.
+ * @param[in] file_path path of the BMP file.
+ * @param[in] format raw image format, refer to kp_image_format_t.
+ * @param[out] image the image.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int image_cache_get_bmp(image_cache_t *cache, const char *file_path, kp_image_format_t format, image_cache_image_t *image);
+
+/**
+ * @brief Get a file of raw image data (e.g. BIN or YUV files), its mapped content is the image buffer without conversion.
+ *
+ * @param[in] cache the cache.
+ * @param[in] file_path path of the raw image file.
+ * @param[in] width image width.
+ * @param[in] height image height.
+ * @param[in] format raw image format of the file, refer to kp_image_format_t.
+ * @param[out] image the image.
+ *
+ * @return return 0 means sucessful, otherwise failed (including a file size not matching the image).
+ */
+int image_cache_get_raw(image_cache_t *cache, const char *file_path, int width, int height, kp_image_format_t format, image_cache_image_t *image);
+
+/**
+ * @brief Get the statistics of a cache.
+ *
+ * @param[in] cache the cache.
+ * @param[out] hit_count number of gets served from the cache, NULL to ignore.
+ * @param[out] miss_count number of gets that loaded a file, NULL to ignore.
+ * @param[out] cached_bytes total bytes of the cached images, NULL to ignore.
+ */
+void image_cache_get_statistics(image_cache_t *cache, uint32_t *hit_count, uint32_t *miss_count, size_t *cached_bytes);
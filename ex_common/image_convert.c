@@ -0,0 +1,1429 @@
+/**
+ * @file        image_convert.c
+ * @brief       image format conversion functions
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "image_convert.h"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#define IMAGE_CONVERT_MAX_THREAD_COUNT 16
+#define IMAGE_CONVERT_MIN_PIXELS_PER_THREAD (64 * 1024)
+#define IMAGE_CONVERT_CROP_ALIGN 4
+
+/*
+ * The scalar conversions of helper_functions.c evaluate the YCbCr/YUV formulas with double coefficients and truncate the float result.
+ * Their coefficients have three decimals, so each result is the floor of an integer numerator over 1000 (or 100, 2000, 4000),
+ * e.g. y = (unsigned char)(0.299 * r + 0.587 * g + 0.114 * b) = (299 * r + 587 * g + 114 * b) / 1000 for all 2^24 pixels,
+ * which was verified exhaustively for every formula below. The integer forms are used by the scalar code here.
+ *
+ * The vector code computes the same numerators exactly in float lanes (integers below 2^24) and the quotient as (n + 0.5) x (1 / d):
+ * the rounding error of the product is below 4e-5 while (n + 0.5) / d is at least 0.5 / d away from an integer, so the truncation is
+ * the integer quotient. Only the RAW8 gray formula truncates a double result which can be an integer minus one ulp, it is evaluated
+ * in double from tables of the three products, so the sums are rounded in the same order and a compiler can not contract them into FMA.
+ */
+#if defined(EX_COMMON_NO_SIMD)
+/* scalar code only, project/test_image_convert checks the vector code against this build */
+#elif defined(__AVX2__)
+#define CVT_VEC_WIDTH 8
+typedef __m256 cvt_vec_t;
+typedef __m256i cvt_int_t;
+#define cvt_vec_set1(v) _mm256_set1_ps(v)
+#define cvt_vec_add(a, b) _mm256_add_ps(a, b)
+#define cvt_vec_mul(a, b) _mm256_mul_ps(a, b)
+#define cvt_int_or(a, b) _mm256_or_si256(a, b)
+#define cvt_int_shift(a, n) _mm256_sll_epi32(a, _mm_cvtsi32_si128(n))
+#define cvt_int_store(p, a) _mm256_storeu_si256((__m256i *)(p), a)
+#define cvt_vec_load(p) _mm256_loadu_ps(p)
+#define cvt_vec_store(p, a) _mm256_storeu_ps(p, a)
+
+static inline cvt_vec_t cvt_vec_load_u8(const uint8_t *p, int step)
+{
+    return _mm256_cvtepi32_ps(_mm256_setr_epi32(p[0], p[step], p[2 * step], p[3 * step], p[4 * step], p[5 * step], p[6 * step], p[7 * step]));
+}
+
+static inline cvt_vec_t cvt_vec_load_u8_packed(const uint8_t *p)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p)));
+}
+
+static inline cvt_int_t cvt_vec_to_u8(cvt_vec_t a)
+{
+    return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(a, _mm256_setzero_ps()), _mm256_set1_ps(255.f)));
+}
+
+static inline void cvt_int_store_u8(uint8_t *p, cvt_int_t a)
+{
+    __m128i w = _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+    _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(w, w));
+}
+
+static inline cvt_int_t cvt_vec_gray(const double table[3][256], const uint8_t *r, const uint8_t *g, const uint8_t *b, int step)
+{
+    __m128i half[2];
+
+    for (int i = 0, k = 0; i < 2; i++, k += 4 * step)
+    {
+        __m256d rd = _mm256_setr_pd(table[0][r[k]], table[0][r[k + step]], table[0][r[k + 2 * step]], table[0][r[k + 3 * step]]);
+        __m256d gd = _mm256_setr_pd(table[1][g[k]], table[1][g[k + step]], table[1][g[k + 2 * step]], table[1][g[k + 3 * step]]);
+        __m256d bd = _mm256_setr_pd(table[2][b[k]], table[2][b[k + step]], table[2][b[k + 2 * step]], table[2][b[k + 3 * step]]);
+        half[i] = _mm256_cvttpd_epi32(_mm256_add_pd(_mm256_add_pd(rd, gd), bd));
+    }
+
+    return _mm256_set_m128i(half[1], half[0]);
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+#define CVT_VEC_WIDTH 4
+typedef __m128 cvt_vec_t;
+typedef __m128i cvt_int_t;
+#define cvt_vec_set1(v) _mm_set1_ps(v)
+#define cvt_vec_add(a, b) _mm_add_ps(a, b)
+#define cvt_vec_mul(a, b) _mm_mul_ps(a, b)
+#define cvt_int_or(a, b) _mm_or_si128(a, b)
+#define cvt_int_shift(a, n) _mm_sll_epi32(a, _mm_cvtsi32_si128(n))
+#define cvt_int_store(p, a) _mm_storeu_si128((__m128i *)(p), a)
+#define cvt_vec_load(p) _mm_loadu_ps(p)
+#define cvt_vec_store(p, a) _mm_storeu_ps(p, a)
+
+static inline cvt_vec_t cvt_vec_load_u8(const uint8_t *p, int step)
+{
+    return _mm_cvtepi32_ps(_mm_setr_epi32(p[0], p[step], p[2 * step], p[3 * step]));
+}
+
+static inline cvt_vec_t cvt_vec_load_u8_packed(const uint8_t *p)
+{
+    int32_t bytes;
+    memcpy(&bytes, p, sizeof(bytes));
+    __m128i zero = _mm_setzero_si128();
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero));
+}
+
+static inline cvt_int_t cvt_vec_to_u8(cvt_vec_t a)
+{
+    return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(a, _mm_setzero_ps()), _mm_set1_ps(255.f)));
+}
+
+static inline void cvt_int_store_u8(uint8_t *p, cvt_int_t a)
+{
+    __m128i w = _mm_packs_epi32(a, a);
+    int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+    memcpy(p, &bytes, sizeof(bytes));
+}
+
+static inline cvt_int_t cvt_vec_gray(const double table[3][256], const uint8_t *r, const uint8_t *g, const uint8_t *b, int step)
+{
+    __m128i half[2];
+
+    for (int i = 0, k = 0; i < 2; i++, k += 2 * step)
+    {
+        __m128d rd = _mm_setr_pd(table[0][r[k]], table[0][r[k + step]]);
+        __m128d gd = _mm_setr_pd(table[1][g[k]], table[1][g[k + step]]);
+        __m128d bd = _mm_setr_pd(table[2][b[k]], table[2][b[k + step]]);
+        half[i] = _mm_cvttpd_epi32(_mm_add_pd(_mm_add_pd(rd, gd), bd));
+    }
+
+    return _mm_unpacklo_epi64(half[0], half[1]);
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define CVT_VEC_WIDTH 4
+typedef float32x4_t cvt_vec_t;
+typedef uint32x4_t cvt_int_t;
+#define cvt_vec_set1(v) vdupq_n_f32(v)
+#define cvt_vec_add(a, b) vaddq_f32(a, b)
+#define cvt_vec_mul(a, b) vmulq_f32(a, b)
+#define cvt_int_or(a, b) vorrq_u32(a, b)
+#define cvt_int_shift(a, n) vshlq_u32(a, vdupq_n_s32(n))
+#define cvt_int_store(p, a) vst1q_u8((uint8_t *)(p), vreinterpretq_u8_u32(a))
+#define cvt_vec_load(p) vld1q_f32(p)
+#define cvt_vec_store(p, a) vst1q_f32(p, a)
+
+static inline cvt_vec_t cvt_vec_load_u8(const uint8_t *p, int step)
+{
+    uint32_t values[4] = {p[0], p[step], p[2 * step], p[3 * step]};
+    return vcvtq_f32_u32(vld1q_u32(values));
+}
+
+static inline cvt_vec_t cvt_vec_load_u8_packed(const uint8_t *p)
+{
+    uint32_t bytes;
+    memcpy(&bytes, p, sizeof(bytes));
+    return vcvtq_f32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes))))));
+}
+
+static inline cvt_int_t cvt_vec_to_u8(cvt_vec_t a)
+{
+    return vcvtq_u32_f32(vminq_f32(vmaxq_f32(a, vdupq_n_f32(0.f)), vdupq_n_f32(255.f)));
+}
+
+static inline void cvt_int_store_u8(uint8_t *p, cvt_int_t a)
+{
+    uint16x4_t w = vmovn_u32(a);
+    uint32_t bytes = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(w, w))), 0);
+    memcpy(p, &bytes, sizeof(bytes));
+}
+
+static inline cvt_int_t cvt_vec_gray(const double table[3][256], const uint8_t *r, const uint8_t *g, const uint8_t *b, int step)
+{
+    uint64x2_t sum[2];
+
+    for (int i = 0, k = 0; i < 2; i++, k += 2 * step)
+    {
+        double rd[2] = {table[0][r[k]], table[0][r[k + step]]};
+        double gd[2] = {table[1][g[k]], table[1][g[k + step]]};
+        double bd[2] = {table[2][b[k]], table[2][b[k + step]]};
+        sum[i] = vcvtq_u64_f64(vaddq_f64(vaddq_f64(vld1q_f64(rd), vld1q_f64(gd)), vld1q_f64(bd)));
+    }
+
+    return vcombine_u32(vmovn_u64(sum[0]), vmovn_u64(sum[1]));
+}
+#endif
+
+#ifdef CVT_VEC_WIDTH
+/* ka x a + kb x b + kc x c + bias, exact for integer lanes */
+static inline cvt_vec_t cvt_vec_dot3(cvt_vec_t a, cvt_vec_t b, cvt_vec_t c, float ka, float kb, float kc, float bias)
+{
+    return cvt_vec_add(cvt_vec_add(cvt_vec_add(cvt_vec_mul(a, cvt_vec_set1(ka)), cvt_vec_mul(b, cvt_vec_set1(kb))), cvt_vec_mul(c, cvt_vec_set1(kc))),
+                       cvt_vec_set1(bias));
+}
+
+/* n / d clamped to [0, 255], refer to the comment above */
+static inline cvt_int_t cvt_vec_quotient(cvt_vec_t n, int d)
+{
+    return cvt_vec_to_u8(cvt_vec_mul(cvt_vec_add(n, cvt_vec_set1(0.5f)), cvt_vec_set1(1.f / d)));
+}
+#endif
+
+/* source pixels and weights of the output pixels along one axis of a resize */
+typedef struct
+{
+    int count;                      // taps per output pixel, unused taps have zero weights
+    int *first;                     // first source pixel of each output pixel
+    float *weights;                 // 'count' weights of each output pixel, they sum to 1
+} image_convert_taps_t;
+
+typedef struct
+{
+    const uint8_t *src;
+    int src_stride;
+    int src_width;                  // source size of a resize, 0 for format conversions
+    int src_height;
+    const image_convert_taps_t *x_taps;
+    const image_convert_taps_t *y_taps;
+    uint8_t *dst;
+    int dst_stride;
+    int width;
+    int height;
+    kp_image_format_t format;
+    int r_offset;                   // byte offsets of red, green and blue in a 3-byte pixel
+    int g_offset;
+    int b_offset;
+    int ycbcr_offset[4];            // byte offsets of y0, cb, y1 and cr in a YCbCr422 pixel pair
+    double gray_table[3][256];      // 0.3 x red, 0.59 x green and 0.11 x blue of RAW8
+} image_convert_job_t;
+
+typedef void (*image_convert_rows_t)(const image_convert_job_t *job, int row_begin, int row_end);
+
+typedef struct
+{
+    const image_convert_job_t *job;
+    image_convert_rows_t convert_rows;
+    int row_begin;
+    int row_end;
+} image_convert_band_t;
+
+static inline uint8_t rgb_to_y(int r, int g, int b)
+{
+    return (uint8_t)((299 * r + 587 * g + 114 * b) / 1000);
+}
+
+/* chroma of the sums of 'count' pixels */
+static inline uint8_t rgb_sum_to_cb(int r, int g, int b, int count)
+{
+    return (uint8_t)((-169 * r - 331 * g + 500 * b + 128000 * count) / (1000 * count));
+}
+
+static inline uint8_t rgb_sum_to_cr(int r, int g, int b, int count)
+{
+    return (uint8_t)((500 * r - 419 * g - 81 * b + 128000 * count) / (1000 * count));
+}
+
+static inline uint8_t rgb_to_gray(const double table[3][256], int r, int g, int b)
+{
+    return table[0][r] + table[1][g] + table[2][b];
+}
+
+static inline uint8_t clamp_quotient(int n, int d)
+{
+    if (n < 0)
+        return 0;
+
+    n /= d;
+
+    return (n > 255) ? 255 : (uint8_t)n;
+}
+
+/* 3-byte pixel of y, cb and cr */
+static inline void ycbcr_to_pixel(int y, int cb, int cr, int r_offset, int g_offset, int b_offset, uint8_t *pixel)
+{
+    pixel[b_offset] = clamp_quotient(100 * y + 177 * (cb - 128), 100);
+    pixel[g_offset] = clamp_quotient(1000 * y - 343 * (cb - 128) - 714 * (cr - 128), 1000);
+    pixel[r_offset] = clamp_quotient(1000 * y + 1403 * (cr - 128), 1000);
+}
+
+static bool ycbcr_byte_offsets(kp_image_format_t format, int offsets[4])
+{
+    // offsets of y0, cb, y1, cr
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
+        offsets[0] = 3; offsets[1] = 2; offsets[2] = 1; offsets[3] = 0;
+        return true;
+    case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
+        offsets[0] = 3; offsets[1] = 0; offsets[2] = 1; offsets[3] = 2;
+        return true;
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
+        offsets[0] = 2; offsets[1] = 3; offsets[2] = 0; offsets[3] = 1;
+        return true;
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
+        offsets[0] = 2; offsets[1] = 1; offsets[2] = 0; offsets[3] = 3;
+        return true;
+    case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
+        offsets[0] = 1; offsets[1] = 2; offsets[2] = 3; offsets[3] = 0;
+        return true;
+    case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
+        offsets[0] = 1; offsets[1] = 0; offsets[2] = 3; offsets[3] = 2;
+        return true;
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
+        offsets[0] = 0; offsets[1] = 3; offsets[2] = 2; offsets[3] = 1;
+        return true;
+    case KP_IMAGE_FORMAT_YUYV:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
+        offsets[0] = 0; offsets[1] = 1; offsets[2] = 2; offsets[3] = 3;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void rgb888_rows_to_rgb565(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    const int width = job->width;
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const uint8_t *src = job->src + (ptrdiff_t)row * job->src_stride;
+        uint8_t *dst = job->dst + (size_t)row * job->width * 2;
+
+        for (int col = 0; col < width; col++, src += 3, dst += 2)
+        {
+            uint16_t pixel = ((src[r_offset] & 0b11111000) << 8) | ((src[g_offset] & 0b11111100) << 3) | (src[b_offset] >> 3);
+
+            dst[0] = (uint8_t)pixel;
+            dst[1] = (uint8_t)(pixel >> 8);
+        }
+    }
+}
+
+static void rgb888_rows_to_rgba8888(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    const int width = job->width;
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const uint8_t *src = job->src + (ptrdiff_t)row * job->src_stride;
+        uint8_t *dst = job->dst + (size_t)row * job->width * 4;
+
+        for (int col = 0; col < width; col++, src += 3, dst += 4)
+        {
+            dst[0] = src[r_offset];
+            dst[1] = src[g_offset];
+            dst[2] = src[b_offset];
+            dst[3] = 0;
+        }
+    }
+}
+
+static void rgb888_rows_to_ycbcr422(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    const int y0_offset = job->ycbcr_offset[0];
+    const int cb_offset = job->ycbcr_offset[1];
+    const int y1_offset = job->ycbcr_offset[2];
+    const int cr_offset = job->ycbcr_offset[3];
+    int pair_count = job->width / 2;
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const uint8_t *src = job->src + (ptrdiff_t)row * job->src_stride;
+        uint8_t *dst = job->dst + (size_t)row * job->width * 2;
+        int i = 0;
+
+#ifdef CVT_VEC_WIDTH
+        for (; i + CVT_VEC_WIDTH <= pair_count; i += CVT_VEC_WIDTH)
+        {
+            const uint8_t *p = src + 6 * i;
+            cvt_vec_t r0 = cvt_vec_load_u8(p + r_offset, 6);
+            cvt_vec_t g0 = cvt_vec_load_u8(p + g_offset, 6);
+            cvt_vec_t b0 = cvt_vec_load_u8(p + b_offset, 6);
+            cvt_vec_t r1 = cvt_vec_load_u8(p + 3 + r_offset, 6);
+            cvt_vec_t g1 = cvt_vec_load_u8(p + 3 + g_offset, 6);
+            cvt_vec_t b1 = cvt_vec_load_u8(p + 3 + b_offset, 6);
+            cvt_vec_t r = cvt_vec_add(r0, r1);
+            cvt_vec_t g = cvt_vec_add(g0, g1);
+            cvt_vec_t b = cvt_vec_add(b0, b1);
+
+            cvt_int_t y0 = cvt_vec_quotient(cvt_vec_dot3(r0, g0, b0, 299, 587, 114, 0), 1000);
+            cvt_int_t y1 = cvt_vec_quotient(cvt_vec_dot3(r1, g1, b1, 299, 587, 114, 0), 1000);
+            cvt_int_t cb = cvt_vec_quotient(cvt_vec_dot3(r, g, b, -169, -331, 500, 256000), 2000);
+            cvt_int_t cr = cvt_vec_quotient(cvt_vec_dot3(r, g, b, 500, -419, -81, 256000), 2000);
+
+            cvt_int_t pair = cvt_int_or(cvt_int_or(cvt_int_shift(y0, 8 * y0_offset), cvt_int_shift(cb, 8 * cb_offset)),
+                                        cvt_int_or(cvt_int_shift(y1, 8 * y1_offset), cvt_int_shift(cr, 8 * cr_offset)));
+            cvt_int_store(dst + 4 * i, pair);
+        }
+#endif
+
+        for (; i < pair_count; i++)
+        {
+            const uint8_t *p = src + 6 * i;
+            int r = p[r_offset] + p[3 + r_offset];
+            int g = p[g_offset] + p[3 + g_offset];
+            int b = p[b_offset] + p[3 + b_offset];
+
+            dst[4 * i + y0_offset] = rgb_to_y(p[r_offset], p[g_offset], p[b_offset]);
+            dst[4 * i + cb_offset] = rgb_sum_to_cb(r, g, b, 2);
+            dst[4 * i + y1_offset] = rgb_to_y(p[3 + r_offset], p[3 + g_offset], p[3 + b_offset]);
+            dst[4 * i + cr_offset] = rgb_sum_to_cr(r, g, b, 2);
+        }
+    }
+}
+
+static void rgb888_row_to_y(const image_convert_job_t *job, const uint8_t *src, uint8_t *dst)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    const int width = job->width;
+    int col = 0;
+
+#ifdef CVT_VEC_WIDTH
+    for (; col + CVT_VEC_WIDTH <= width; col += CVT_VEC_WIDTH)
+    {
+        const uint8_t *p = src + 3 * col;
+        cvt_vec_t r = cvt_vec_load_u8(p + r_offset, 3);
+        cvt_vec_t g = cvt_vec_load_u8(p + g_offset, 3);
+        cvt_vec_t b = cvt_vec_load_u8(p + b_offset, 3);
+
+        cvt_int_store_u8(dst + col, cvt_vec_quotient(cvt_vec_dot3(r, g, b, 299, 587, 114, 0), 1000));
+    }
+#endif
+
+    for (; col < width; col++)
+    {
+        const uint8_t *p = src + 3 * col;
+        dst[col] = rgb_to_y(p[r_offset], p[g_offset], p[b_offset]);
+    }
+}
+
+/* rows are converted in pairs, 'row_begin' is even */
+static void rgb888_rows_to_yuv420(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    int chroma_width = job->width / 2;
+    uint8_t *dst_u = job->dst + (size_t)job->width * job->height;
+    uint8_t *dst_v = dst_u + (size_t)chroma_width * (job->height / 2);
+
+    for (int row = row_begin; row < row_end; row += 2)
+    {
+        const uint8_t *src_0 = job->src + (ptrdiff_t)row * job->src_stride;
+        const uint8_t *src_1 = src_0 + job->src_stride;
+        uint8_t *u = dst_u + (size_t)(row / 2) * chroma_width;
+        uint8_t *v = dst_v + (size_t)(row / 2) * chroma_width;
+        int i = 0;
+
+        rgb888_row_to_y(job, src_0, job->dst + (size_t)row * job->width);
+        rgb888_row_to_y(job, src_1, job->dst + (size_t)(row + 1) * job->width);
+
+#ifdef CVT_VEC_WIDTH
+        for (; i + CVT_VEC_WIDTH <= chroma_width; i += CVT_VEC_WIDTH)
+        {
+            const uint8_t *p_0 = src_0 + 6 * i;
+            const uint8_t *p_1 = src_1 + 6 * i;
+            cvt_vec_t r = cvt_vec_add(cvt_vec_add(cvt_vec_load_u8(p_0 + r_offset, 6), cvt_vec_load_u8(p_0 + 3 + r_offset, 6)),
+                                      cvt_vec_add(cvt_vec_load_u8(p_1 + r_offset, 6), cvt_vec_load_u8(p_1 + 3 + r_offset, 6)));
+            cvt_vec_t g = cvt_vec_add(cvt_vec_add(cvt_vec_load_u8(p_0 + g_offset, 6), cvt_vec_load_u8(p_0 + 3 + g_offset, 6)),
+                                      cvt_vec_add(cvt_vec_load_u8(p_1 + g_offset, 6), cvt_vec_load_u8(p_1 + 3 + g_offset, 6)));
+            cvt_vec_t b = cvt_vec_add(cvt_vec_add(cvt_vec_load_u8(p_0 + b_offset, 6), cvt_vec_load_u8(p_0 + 3 + b_offset, 6)),
+                                      cvt_vec_add(cvt_vec_load_u8(p_1 + b_offset, 6), cvt_vec_load_u8(p_1 + 3 + b_offset, 6)));
+
+            cvt_int_store_u8(u + i, cvt_vec_quotient(cvt_vec_dot3(r, g, b, -169, -331, 500, 512000), 4000));
+            cvt_int_store_u8(v + i, cvt_vec_quotient(cvt_vec_dot3(r, g, b, 500, -419, -81, 512000), 4000));
+        }
+#endif
+
+        for (; i < chroma_width; i++)
+        {
+            const uint8_t *p_0 = src_0 + 6 * i;
+            const uint8_t *p_1 = src_1 + 6 * i;
+            int r = p_0[r_offset] + p_0[3 + r_offset] + p_1[r_offset] + p_1[3 + r_offset];
+            int g = p_0[g_offset] + p_0[3 + g_offset] + p_1[g_offset] + p_1[3 + g_offset];
+            int b = p_0[b_offset] + p_0[3 + b_offset] + p_1[b_offset] + p_1[3 + b_offset];
+
+            u[i] = rgb_sum_to_cb(r, g, b, 4);
+            v[i] = rgb_sum_to_cr(r, g, b, 4);
+        }
+    }
+}
+
+static void rgb888_rows_to_raw8(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    const int width = job->width;
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const uint8_t *src = job->src + (ptrdiff_t)row * job->src_stride;
+        uint8_t *dst = job->dst + (size_t)row * job->width;
+        int col = 0;
+
+#ifdef CVT_VEC_WIDTH
+        for (; col + CVT_VEC_WIDTH <= width; col += CVT_VEC_WIDTH)
+        {
+            const uint8_t *p = src + 3 * col;
+            cvt_int_store_u8(dst + col, cvt_vec_gray(job->gray_table, p + r_offset, p + g_offset, p + b_offset, 3));
+        }
+#endif
+
+        for (; col < width; col++)
+        {
+            const uint8_t *p = src + 3 * col;
+            dst[col] = rgb_to_gray(job->gray_table, p[r_offset], p[g_offset], p[b_offset]);
+        }
+    }
+}
+
+static void rgb565_rows_to_rgb888(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    const int width = job->width;
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const uint8_t *src = job->src + (size_t)row * job->width * 2;
+        uint8_t *dst = job->dst + (ptrdiff_t)row * job->dst_stride;
+
+        for (int col = 0; col < width; col++, src += 2, dst += 3)
+        {
+            uint16_t pixel = src[0] | (src[1] << 8);
+
+            dst[b_offset] = (pixel << 3) & 0b11111000;
+            dst[g_offset] = (pixel >> 3) & 0b11111100;
+            dst[r_offset] = (pixel >> 8) & 0b11111000;
+        }
+    }
+}
+
+static void rgba8888_rows_to_rgb888(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    const int width = job->width;
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const uint8_t *src = job->src + (size_t)row * job->width * 4;
+        uint8_t *dst = job->dst + (ptrdiff_t)row * job->dst_stride;
+
+        for (int col = 0; col < width; col++, src += 4, dst += 3)
+        {
+            dst[r_offset] = src[0];
+            dst[g_offset] = src[1];
+            dst[b_offset] = src[2];
+        }
+    }
+}
+
+#ifdef CVT_VEC_WIDTH
+/* 3-byte pixels of y and the chroma terms in a 32-bit lane each */
+static inline cvt_int_t cvt_vec_ycbcr_to_pixel(cvt_vec_t y, cvt_vec_t cb_b, cvt_vec_t cbcr_g, cvt_vec_t cr_r, int r_offset, int g_offset, int b_offset)
+{
+    cvt_int_t b = cvt_vec_quotient(cvt_vec_add(cvt_vec_mul(y, cvt_vec_set1(100)), cb_b), 100);
+    cvt_int_t g = cvt_vec_quotient(cvt_vec_add(cvt_vec_mul(y, cvt_vec_set1(1000)), cbcr_g), 1000);
+    cvt_int_t r = cvt_vec_quotient(cvt_vec_add(cvt_vec_mul(y, cvt_vec_set1(1000)), cr_r), 1000);
+
+    return cvt_int_or(cvt_int_or(cvt_int_shift(b, 8 * b_offset), cvt_int_shift(g, 8 * g_offset)), cvt_int_shift(r, 8 * r_offset));
+}
+
+static inline void write_pixel(uint8_t *dst, uint32_t pixel)
+{
+    dst[0] = (uint8_t)pixel;
+    dst[1] = (uint8_t)(pixel >> 8);
+    dst[2] = (uint8_t)(pixel >> 16);
+}
+#endif
+
+static void ycbcr422_rows_to_rgb888(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    const int y0_offset = job->ycbcr_offset[0];
+    const int cb_offset = job->ycbcr_offset[1];
+    const int y1_offset = job->ycbcr_offset[2];
+    const int cr_offset = job->ycbcr_offset[3];
+    int pair_count = job->width / 2;
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const uint8_t *src = job->src + (size_t)row * job->width * 2;
+        uint8_t *dst = job->dst + (ptrdiff_t)row * job->dst_stride;
+        int i = 0;
+
+#ifdef CVT_VEC_WIDTH
+        for (; i + CVT_VEC_WIDTH <= pair_count; i += CVT_VEC_WIDTH)
+        {
+            const uint8_t *p = src + 4 * i;
+            uint32_t pixels[2][CVT_VEC_WIDTH];
+            cvt_vec_t y0 = cvt_vec_load_u8(p + y0_offset, 4);
+            cvt_vec_t cb = cvt_vec_add(cvt_vec_load_u8(p + cb_offset, 4), cvt_vec_set1(-128));
+            cvt_vec_t y1 = cvt_vec_load_u8(p + y1_offset, 4);
+            cvt_vec_t cr = cvt_vec_add(cvt_vec_load_u8(p + cr_offset, 4), cvt_vec_set1(-128));
+            cvt_vec_t cb_b = cvt_vec_mul(cb, cvt_vec_set1(177));
+            cvt_vec_t cbcr_g = cvt_vec_add(cvt_vec_mul(cb, cvt_vec_set1(-343)), cvt_vec_mul(cr, cvt_vec_set1(-714)));
+            cvt_vec_t cr_r = cvt_vec_mul(cr, cvt_vec_set1(1403));
+
+            cvt_int_store(pixels[0], cvt_vec_ycbcr_to_pixel(y0, cb_b, cbcr_g, cr_r, r_offset, g_offset, b_offset));
+            cvt_int_store(pixels[1], cvt_vec_ycbcr_to_pixel(y1, cb_b, cbcr_g, cr_r, r_offset, g_offset, b_offset));
+
+            for (int k = 0; k < CVT_VEC_WIDTH; k++)
+            {
+                write_pixel(dst + 6 * (i + k), pixels[0][k]);
+                write_pixel(dst + 6 * (i + k) + 3, pixels[1][k]);
+            }
+        }
+#endif
+
+        for (; i < pair_count; i++)
+        {
+            const uint8_t *p = src + 4 * i;
+
+            ycbcr_to_pixel(p[y0_offset], p[cb_offset], p[cr_offset], r_offset, g_offset, b_offset, dst + 6 * i);
+            ycbcr_to_pixel(p[y1_offset], p[cb_offset], p[cr_offset], r_offset, g_offset, b_offset, dst + 6 * i + 3);
+        }
+    }
+}
+
+/* rows are converted in pairs, 'row_begin' is even */
+static void yuv420_rows_to_rgb888(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int r_offset = job->r_offset;
+    const int g_offset = job->g_offset;
+    const int b_offset = job->b_offset;
+    int chroma_width = job->width / 2;
+    const uint8_t *src_u = job->src + (size_t)job->width * job->height;
+    const uint8_t *src_v = src_u + (size_t)chroma_width * (job->height / 2);
+
+    for (int row = row_begin; row < row_end; row += 2)
+    {
+        const uint8_t *y_0 = job->src + (size_t)row * job->width;
+        const uint8_t *y_1 = y_0 + job->width;
+        const uint8_t *u = src_u + (size_t)(row / 2) * chroma_width;
+        const uint8_t *v = src_v + (size_t)(row / 2) * chroma_width;
+        uint8_t *dst_0 = job->dst + (ptrdiff_t)row * job->dst_stride;
+        uint8_t *dst_1 = dst_0 + job->dst_stride;
+        int i = 0;
+
+#ifdef CVT_VEC_WIDTH
+        for (; i + CVT_VEC_WIDTH <= chroma_width; i += CVT_VEC_WIDTH)
+        {
+            uint32_t pixels[4][CVT_VEC_WIDTH];
+            cvt_vec_t cb = cvt_vec_add(cvt_vec_load_u8(u + i, 1), cvt_vec_set1(-128));
+            cvt_vec_t cr = cvt_vec_add(cvt_vec_load_u8(v + i, 1), cvt_vec_set1(-128));
+            cvt_vec_t cb_b = cvt_vec_mul(cb, cvt_vec_set1(177));
+            cvt_vec_t cbcr_g = cvt_vec_add(cvt_vec_mul(cb, cvt_vec_set1(-343)), cvt_vec_mul(cr, cvt_vec_set1(-714)));
+            cvt_vec_t cr_r = cvt_vec_mul(cr, cvt_vec_set1(1403));
+
+            cvt_int_store(pixels[0], cvt_vec_ycbcr_to_pixel(cvt_vec_load_u8(y_0 + 2 * i, 2), cb_b, cbcr_g, cr_r, r_offset, g_offset, b_offset));
+            cvt_int_store(pixels[1], cvt_vec_ycbcr_to_pixel(cvt_vec_load_u8(y_0 + 2 * i + 1, 2), cb_b, cbcr_g, cr_r, r_offset, g_offset, b_offset));
+            cvt_int_store(pixels[2], cvt_vec_ycbcr_to_pixel(cvt_vec_load_u8(y_1 + 2 * i, 2), cb_b, cbcr_g, cr_r, r_offset, g_offset, b_offset));
+            cvt_int_store(pixels[3], cvt_vec_ycbcr_to_pixel(cvt_vec_load_u8(y_1 + 2 * i + 1, 2), cb_b, cbcr_g, cr_r, r_offset, g_offset, b_offset));
+
+            for (int k = 0; k < CVT_VEC_WIDTH; k++)
+            {
+                write_pixel(dst_0 + 6 * (i + k), pixels[0][k]);
+                write_pixel(dst_0 + 6 * (i + k) + 3, pixels[1][k]);
+                write_pixel(dst_1 + 6 * (i + k), pixels[2][k]);
+                write_pixel(dst_1 + 6 * (i + k) + 3, pixels[3][k]);
+            }
+        }
+#endif
+
+        for (; i < chroma_width; i++)
+        {
+            ycbcr_to_pixel(y_0[2 * i], u[i], v[i], r_offset, g_offset, b_offset, dst_0 + 6 * i);
+            ycbcr_to_pixel(y_0[2 * i + 1], u[i], v[i], r_offset, g_offset, b_offset, dst_0 + 6 * i + 3);
+            ycbcr_to_pixel(y_1[2 * i], u[i], v[i], r_offset, g_offset, b_offset, dst_1 + 6 * i);
+            ycbcr_to_pixel(y_1[2 * i + 1], u[i], v[i], r_offset, g_offset, b_offset, dst_1 + 6 * i + 3);
+        }
+    }
+}
+
+static void raw8_rows_to_rgb888(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const int width = job->width;
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const uint8_t *src = job->src + (size_t)row * job->width;
+        uint8_t *dst = job->dst + (ptrdiff_t)row * job->dst_stride;
+
+        for (int col = 0; col < width; col++, dst += 3)
+            memset(dst, src[col], 3);
+    }
+}
+
+static inline uint8_t clamp_weighted_sum(float sum)
+{
+    return (sum <= 0.f) ? 0 : (sum >= 255.f) ? 255 : (uint8_t)(sum + 0.5f);
+}
+
+/*
+ * Each output row sums its source rows into a float line of the source width (contiguous, SIMD), then each output pixel sums
+ * its source pixels of the line. The vertical pass is the bulk of a downscale, the horizontal pass only touches the taps.
+ */
+static void rgb888_rows_resize(const image_convert_job_t *job, int row_begin, int row_end)
+{
+    const image_convert_taps_t *x_taps = job->x_taps;
+    const image_convert_taps_t *y_taps = job->y_taps;
+    const int width = job->width;
+    const int line_size = job->src_width * 3;
+    float *line = (float *)malloc(sizeof(float) * line_size);
+
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const float *wy = y_taps->weights + (size_t)row * y_taps->count;
+        const uint8_t *src = job->src + (ptrdiff_t)y_taps->first[row] * job->src_stride;
+        uint8_t *dst = job->dst + (ptrdiff_t)row * job->dst_stride;
+
+        if (NULL == line)
+        {
+            // no memory for the line, sum the source pixels of each output pixel directly
+            for (int col = 0; col < width; col++)
+            {
+                const float *wx = x_taps->weights + (size_t)col * x_taps->count;
+                float sum[3] = {0.f, 0.f, 0.f};
+
+                for (int ty = 0; ty < y_taps->count; ty++)
+                {
+                    const uint8_t *p = src + (ptrdiff_t)ty * job->src_stride + 3 * x_taps->first[col];
+
+                    for (int tx = 0; tx < x_taps->count; tx++, p += 3)
+                    {
+                        float w = wy[ty] * wx[tx];
+                        sum[0] += w * p[0];
+                        sum[1] += w * p[1];
+                        sum[2] += w * p[2];
+                    }
+                }
+
+                for (int c = 0; c < 3; c++)
+                    dst[3 * col + c] = clamp_weighted_sum(sum[c]);
+            }
+            continue;
+        }
+
+        for (int ty = 0, initialized = 0; ty < y_taps->count; ty++, src += job->src_stride)
+        {
+            const float w = wy[ty];
+            int i = 0;
+
+            if ((0.f == w) && initialized)
+                continue;
+
+#ifdef CVT_VEC_WIDTH
+            cvt_vec_t wv = cvt_vec_set1(w);
+
+            if (initialized)
+            {
+                for (; i + CVT_VEC_WIDTH <= line_size; i += CVT_VEC_WIDTH)
+                    cvt_vec_store(line + i, cvt_vec_add(cvt_vec_load(line + i), cvt_vec_mul(cvt_vec_load_u8_packed(src + i), wv)));
+            }
+            else
+            {
+                for (; i + CVT_VEC_WIDTH <= line_size; i += CVT_VEC_WIDTH)
+                    cvt_vec_store(line + i, cvt_vec_mul(cvt_vec_load_u8_packed(src + i), wv));
+            }
+#endif
+
+            if (initialized)
+            {
+                for (; i < line_size; i++)
+                    line[i] += w * src[i];
+            }
+            else
+            {
+                for (; i < line_size; i++)
+                    line[i] = w * src[i];
+            }
+
+            initialized = 1;
+        }
+
+        for (int col = 0; col < width; col++, dst += 3)
+        {
+            const float *wx = x_taps->weights + (size_t)col * x_taps->count;
+            const float *p = line + 3 * x_taps->first[col];
+            float sum[3] = {0.f, 0.f, 0.f};
+
+            for (int tx = 0; tx < x_taps->count; tx++, p += 3)
+            {
+                sum[0] += wx[tx] * p[0];
+                sum[1] += wx[tx] * p[1];
+                sum[2] += wx[tx] * p[2];
+            }
+
+            dst[0] = clamp_weighted_sum(sum[0]);
+            dst[1] = clamp_weighted_sum(sum[1]);
+            dst[2] = clamp_weighted_sum(sum[2]);
+        }
+    }
+
+    free(line);
+}
+
+static void *image_convert_band_thread(void *data)
+{
+    image_convert_band_t *band = (image_convert_band_t *)data;
+
+    band->convert_rows(band->job, band->row_begin, band->row_end);
+
+    return NULL;
+}
+
+/* convert bands of rows in parallel, a band starts at a multiple of 'row_step' */
+static void image_convert_run(const image_convert_job_t *job, image_convert_rows_t convert_rows, int row_step, int thread_count)
+{
+    pthread_t threads[IMAGE_CONVERT_MAX_THREAD_COUNT];
+    image_convert_band_t bands[IMAGE_CONVERT_MAX_THREAD_COUNT];
+    bool created[IMAGE_CONVERT_MAX_THREAD_COUNT] = {false};
+    int step_count = job->height / row_step;
+    long long pixel_count = (long long)job->width * job->height;
+    long long max_thread_count;
+
+    // a downscale reads more pixels than it writes
+    if (pixel_count < (long long)job->src_width * job->src_height)
+        pixel_count = (long long)job->src_width * job->src_height;
+    max_thread_count = pixel_count / IMAGE_CONVERT_MIN_PIXELS_PER_THREAD;
+
+    if (thread_count > max_thread_count)
+        thread_count = (int)max_thread_count;
+    if (thread_count > step_count)
+        thread_count = step_count;
+    if (thread_count > IMAGE_CONVERT_MAX_THREAD_COUNT)
+        thread_count = IMAGE_CONVERT_MAX_THREAD_COUNT;
+
+    if (1 >= thread_count)
+    {
+        convert_rows(job, 0, job->height);
+        return;
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        bands[i].job = job;
+        bands[i].convert_rows = convert_rows;
+        bands[i].row_begin = (int)((long long)step_count * i / thread_count) * row_step;
+        bands[i].row_end = (i + 1 == thread_count) ? job->height : (int)((long long)step_count * (i + 1) / thread_count) * row_step;
+    }
+
+    // the calling thread converts the first band, a band is converted in the calling thread as well if its thread can not be created
+    for (int i = 1; i < thread_count; i++)
+        created[i] = (0 == pthread_create(&threads[i], NULL, image_convert_band_thread, &bands[i]));
+
+    convert_rows(job, bands[0].row_begin, bands[0].row_end);
+
+    for (int i = 1; i < thread_count; i++)
+    {
+        if (created[i])
+            pthread_join(threads[i], NULL);
+        else
+            convert_rows(job, bands[i].row_begin, bands[i].row_end);
+    }
+}
+
+static void init_job(image_convert_job_t *job, int width, int height, kp_image_format_t format, image_convert_order_t order)
+{
+    memset(job, 0, sizeof(image_convert_job_t));
+
+    job->width = width;
+    job->height = height;
+    job->format = format;
+    job->r_offset = (IMAGE_CONVERT_ORDER_RGB == order) ? 0 : 2;
+    job->g_offset = 1;
+    job->b_offset = (IMAGE_CONVERT_ORDER_RGB == order) ? 2 : 0;
+
+    ycbcr_byte_offsets(format, job->ycbcr_offset);
+}
+
+static void release_taps(image_convert_taps_t *taps)
+{
+    free(taps->first);
+    free(taps->weights);
+}
+
+static int init_taps(image_convert_taps_t *taps, int src_size, int dst_size, image_convert_resize_mode_t mode)
+{
+    double scale = (double)src_size / dst_size;
+    bool area = (IMAGE_CONVERT_RESIZE_AREA == mode) && (src_size > dst_size);
+
+    // an area pixel covers 'scale' source pixels starting anywhere in a pixel, a bilinear pixel interpolates two neighbors
+    taps->count = area ? (int)ceil(scale) + 1 : 2;
+    if (taps->count > src_size)
+        taps->count = src_size;
+
+    taps->first = (int *)malloc(sizeof(int) * dst_size);
+    taps->weights = (float *)calloc((size_t)dst_size * taps->count, sizeof(float));
+
+    if ((NULL == taps->first) || (NULL == taps->weights))
+    {
+        release_taps(taps);
+        return -1;
+    }
+
+    for (int i = 0; i < dst_size; i++)
+    {
+        float *weights = taps->weights + (size_t)i * taps->count;
+
+        if (area)
+        {
+            double begin = i * scale;
+            double end = begin + scale;
+            int first = (int)floor(begin);
+
+            if (first > src_size - taps->count)
+                first = src_size - taps->count;
+
+            taps->first[i] = first;
+
+            for (int t = 0; t < taps->count; t++)
+            {
+                double overlap = fmin(end, first + t + 1) - fmax(begin, first + t);
+                weights[t] = (overlap > 0.0) ? (float)(overlap / scale) : 0.f;
+            }
+        }
+        else
+        {
+            // pixel centers are aligned, as cv::resize() with INTER_LINEAR
+            double position = fmax((i + 0.5) * scale - 0.5, 0.0);
+            int left = (int)floor(position);
+            double fraction = position - left;
+            int first;
+
+            if (left >= src_size - 1)
+            {
+                left = src_size - 1;
+                fraction = 0.0;
+            }
+
+            first = (left > src_size - taps->count) ? src_size - taps->count : left;
+            taps->first[i] = first;
+
+            weights[left - first] += (float)(1.0 - fraction);
+            if (0.0 < fraction)
+                weights[left + 1 - first] += (float)fraction;
+        }
+    }
+
+    return 0;
+}
+
+int image_convert_buffer_size(int width, int height, kp_image_format_t format)
+{
+    long long pixel_count = (long long)width * height;
+    long long size = -1;
+
+    if ((0 >= width) || (0 >= height))
+        return -1;
+
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_RGB565:
+        size = pixel_count * 2;
+        break;
+    case KP_IMAGE_FORMAT_RGBA8888:
+        size = pixel_count * 4;
+        break;
+    case KP_IMAGE_FORMAT_YUYV:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
+        if (0 == width % 2)
+            size = pixel_count * 2;
+        break;
+    case KP_IMAGE_FORMAT_RAW8:
+        size = pixel_count;
+        break;
+    case KP_IMAGE_FORMAT_YUV420:
+        if ((0 == width % 2) && (0 == height % 2))
+            size = pixel_count * 3 / 2;
+        break;
+    default:
+        break;
+    }
+
+    return (size > INT_MAX) ? -1 : (int)size;
+}
+
+int image_convert_from_rgb888(const uint8_t *src, int src_stride, image_convert_order_t src_order, int width, int height,
+                              kp_image_format_t format, uint8_t *dst, int thread_count)
+{
+    image_convert_job_t job;
+    image_convert_rows_t convert_rows = NULL;
+    int row_step = 1;
+
+    if ((NULL == src) || (NULL == dst) || (0 >= thread_count) || ((IMAGE_CONVERT_ORDER_BGR != src_order) && (IMAGE_CONVERT_ORDER_RGB != src_order)))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (0 > image_convert_buffer_size(width, height, format))
+    {
+        printf("Error! %s(): image format 0x%x is not supported for %d x %d\n", __FUNCTION__, format, width, height);
+        return -1;
+    }
+
+    init_job(&job, width, height, format, src_order);
+    job.src = src;
+    job.src_stride = src_stride;
+    job.dst = dst;
+
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_RGB565:
+        convert_rows = rgb888_rows_to_rgb565;
+        break;
+    case KP_IMAGE_FORMAT_RGBA8888:
+        convert_rows = rgb888_rows_to_rgba8888;
+        break;
+    case KP_IMAGE_FORMAT_RAW8:
+        for (int i = 0; i < 256; i++)
+        {
+            job.gray_table[0][i] = 0.3 * i;
+            job.gray_table[1][i] = 0.59 * i;
+            job.gray_table[2][i] = 0.11 * i;
+        }
+        convert_rows = rgb888_rows_to_raw8;
+        break;
+    case KP_IMAGE_FORMAT_YUV420:
+        convert_rows = rgb888_rows_to_yuv420;
+        row_step = 2;
+        break;
+    default:
+        convert_rows = rgb888_rows_to_ycbcr422;
+        break;
+    }
+
+    image_convert_run(&job, convert_rows, row_step, thread_count);
+
+    return 0;
+}
+
+int image_convert_to_rgb888(const uint8_t *src, int width, int height, kp_image_format_t format,
+                            uint8_t *dst, int dst_stride, image_convert_order_t dst_order, int thread_count)
+{
+    image_convert_job_t job;
+    image_convert_rows_t convert_rows = NULL;
+    int row_step = 1;
+
+    if ((NULL == src) || (NULL == dst) || (0 >= thread_count) || ((IMAGE_CONVERT_ORDER_BGR != dst_order) && (IMAGE_CONVERT_ORDER_RGB != dst_order)))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (0 > image_convert_buffer_size(width, height, format))
+    {
+        printf("Error! %s(): image format 0x%x is not supported for %d x %d\n", __FUNCTION__, format, width, height);
+        return -1;
+    }
+
+    init_job(&job, width, height, format, dst_order);
+    job.src = src;
+    job.dst = dst;
+    job.dst_stride = dst_stride;
+
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_RGB565:
+        convert_rows = rgb565_rows_to_rgb888;
+        break;
+    case KP_IMAGE_FORMAT_RGBA8888:
+        convert_rows = rgba8888_rows_to_rgb888;
+        break;
+    case KP_IMAGE_FORMAT_RAW8:
+        convert_rows = raw8_rows_to_rgb888;
+        break;
+    case KP_IMAGE_FORMAT_YUV420:
+        convert_rows = yuv420_rows_to_rgb888;
+        row_step = 2;
+        break;
+    default:
+        convert_rows = ycbcr422_rows_to_rgb888;
+        break;
+    }
+
+    image_convert_run(&job, convert_rows, row_step, thread_count);
+
+    return 0;
+}
+
+int image_convert_letterbox_size(int width, int height, int model_width, int model_height, kp_padding_mode_t padding_mode,
+                                 kp_image_format_t format, int *resized_width, int *resized_height)
+{
+    long long resized_w = model_width;
+    long long resized_h = model_height;
+
+    if ((0 >= width) || (0 >= height) || (0 >= model_width) || (0 >= model_height) || (NULL == resized_width) || (NULL == resized_height))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    // with padding the image keeps its aspect ratio and fills the model input along one side, the rest is padded by the device
+    if (KP_PADDING_DISABLE != padding_mode)
+    {
+        if ((long long)width * model_height >= (long long)height * model_width)
+            resized_h = ((long long)height * model_width + width / 2) / width;
+        else
+            resized_w = ((long long)width * model_height + height / 2) / height;
+    }
+
+    // never upscale on the host, the device resizes a smaller image itself
+    if ((resized_w > width) || (resized_h > height))
+    {
+        resized_w = width;
+        resized_h = height;
+    }
+
+    if (1 > resized_w)
+        resized_w = 1;
+    if (1 > resized_h)
+        resized_h = 1;
+
+    // YCbCr422 and YUV420 need even sizes
+    if ((0 > image_convert_buffer_size((int)resized_w, (int)resized_h, format)) && (1 < resized_w))
+        resized_w &= ~1LL;
+    if ((0 > image_convert_buffer_size((int)resized_w, (int)resized_h, format)) && (1 < resized_h))
+        resized_h &= ~1LL;
+
+    if (0 > image_convert_buffer_size((int)resized_w, (int)resized_h, format))
+    {
+        printf("Error! %s(): image format 0x%x is not supported for %lld x %lld\n", __FUNCTION__, format, resized_w, resized_h);
+        return -1;
+    }
+
+    *resized_width = (int)resized_w;
+    *resized_height = (int)resized_h;
+
+    return 0;
+}
+
+int image_convert_resize_rgb888(const uint8_t *src, int src_stride, int src_width, int src_height,
+                                uint8_t *dst, int dst_stride, int dst_width, int dst_height, image_convert_resize_mode_t mode, int thread_count)
+{
+    image_convert_job_t job;
+    image_convert_taps_t x_taps;
+    image_convert_taps_t y_taps;
+
+    if ((NULL == src) || (NULL == dst) || (0 >= src_width) || (0 >= src_height) || (0 >= dst_width) || (0 >= dst_height) || (0 >= thread_count) ||
+        ((IMAGE_CONVERT_RESIZE_AREA != mode) && (IMAGE_CONVERT_RESIZE_BILINEAR != mode)))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (0 != init_taps(&x_taps, src_width, dst_width, mode))
+    {
+        printf("Error! %s(): memory allocation failed\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (0 != init_taps(&y_taps, src_height, dst_height, mode))
+    {
+        printf("Error! %s(): memory allocation failed\n", __FUNCTION__);
+        release_taps(&x_taps);
+        return -1;
+    }
+
+    init_job(&job, dst_width, dst_height, KP_IMAGE_FORMAT_UNKNOWN, IMAGE_CONVERT_ORDER_BGR);
+    job.src = src;
+    job.src_stride = src_stride;
+    job.src_width = src_width;
+    job.src_height = src_height;
+    job.x_taps = &x_taps;
+    job.y_taps = &y_taps;
+    job.dst = dst;
+    job.dst_stride = dst_stride;
+
+    image_convert_run(&job, rgb888_rows_resize, 1, thread_count);
+
+    release_taps(&x_taps);
+    release_taps(&y_taps);
+
+    return 0;
+}
+
+int image_convert_restore_pre_proc_info(kp_hw_pre_proc_info_t *pre_proc_info, int img_width, int img_height)
+{
+    if ((NULL == pre_proc_info) || (0 >= img_width) || (0 >= img_height) || (0 == pre_proc_info->img_width) || (0 == pre_proc_info->img_height))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    // the crop area is in pixels of the sent image
+    pre_proc_info->crop_area.x1 = (uint32_t)((uint64_t)pre_proc_info->crop_area.x1 * img_width / pre_proc_info->img_width);
+    pre_proc_info->crop_area.y1 = (uint32_t)((uint64_t)pre_proc_info->crop_area.y1 * img_height / pre_proc_info->img_height);
+    pre_proc_info->crop_area.width = (uint32_t)((uint64_t)pre_proc_info->crop_area.width * img_width / pre_proc_info->img_width);
+    pre_proc_info->crop_area.height = (uint32_t)((uint64_t)pre_proc_info->crop_area.height * img_height / pre_proc_info->img_height);
+
+    pre_proc_info->img_width = img_width;
+    pre_proc_info->img_height = img_height;
+
+    return 0;
+}
+
+/* crop region (x, y, width, height) in the original image and its y in the packed image, returns the packed width and height */
+static int crop_pack_layout(const kp_generic_input_node_image_t *input_node, int regions[MAX_CROP_BOX][5], int *packed_width, int *packed_height)
+{
+    const int width = (int)input_node->width;
+    const int height = (int)input_node->height;
+    int packed_y = 0;
+
+    *packed_width = 0;
+    *packed_height = 0;
+
+    if ((0 == input_node->crop_count) || (MAX_CROP_BOX < input_node->crop_count) ||
+        (0 > image_convert_buffer_size(width, height, (kp_image_format_t)input_node->image_format)))
+        return -1;
+
+    for (uint32_t i = 0; i < input_node->crop_count; i++)
+    {
+        const kp_inf_crop_box_t *crop = &input_node->inf_crop[i];
+        int x_end;
+        int y_end;
+
+        if ((0 == crop->width) || (0 == crop->height) || (crop->x1 + crop->width > (uint32_t)width) || (crop->y1 + crop->height > (uint32_t)height))
+            return -1;
+
+        // regions start and end on multiples of the alignment, or at the image border (which has the pixel pair alignment)
+        x_end = (int)(crop->x1 + crop->width + IMAGE_CONVERT_CROP_ALIGN - 1) / IMAGE_CONVERT_CROP_ALIGN * IMAGE_CONVERT_CROP_ALIGN;
+        y_end = (int)(crop->y1 + crop->height + IMAGE_CONVERT_CROP_ALIGN - 1) / IMAGE_CONVERT_CROP_ALIGN * IMAGE_CONVERT_CROP_ALIGN;
+
+        regions[i][0] = (int)crop->x1 / IMAGE_CONVERT_CROP_ALIGN * IMAGE_CONVERT_CROP_ALIGN;
+        regions[i][1] = (int)crop->y1 / IMAGE_CONVERT_CROP_ALIGN * IMAGE_CONVERT_CROP_ALIGN;
+        regions[i][2] = ((x_end < width) ? x_end : width) - regions[i][0];
+        regions[i][3] = ((y_end < height) ? y_end : height) - regions[i][1];
+        regions[i][4] = packed_y;
+
+        if (*packed_width < regions[i][2])
+            *packed_width = regions[i][2];
+
+        *packed_height = packed_y + regions[i][3];
+        packed_y = (*packed_height + IMAGE_CONVERT_CROP_ALIGN - 1) / IMAGE_CONVERT_CROP_ALIGN * IMAGE_CONVERT_CROP_ALIGN;
+    }
+
+    return 0;
+}
+
+int image_convert_crop_pack_size(const kp_generic_input_node_image_t *input_node)
+{
+    int regions[MAX_CROP_BOX][5];
+    int packed_width;
+    int packed_height;
+    int packed_size;
+
+    if ((NULL == input_node) || (0 != crop_pack_layout(input_node, regions, &packed_width, &packed_height)))
+        return -1;
+
+    packed_size = image_convert_buffer_size(packed_width, packed_height, (kp_image_format_t)input_node->image_format);
+
+    if ((0 > packed_size) || (packed_size >= image_convert_buffer_size((int)input_node->width, (int)input_node->height, (kp_image_format_t)input_node->image_format)))
+        return 0;
+
+    return packed_size;
+}
+
+/* copy a region of a plane with 'bytes_per_pixel' bytes per pixel to (0, packed_y) of another plane */
+static void copy_plane_region(const uint8_t *src, int src_width, uint8_t *dst, int dst_width, int bytes_per_pixel,
+                              int x, int y, int width, int height, int packed_y)
+{
+    for (int row = 0; row < height; row++)
+        memcpy(dst + ((size_t)(packed_y + row) * dst_width) * bytes_per_pixel, src + ((size_t)(y + row) * src_width + x) * bytes_per_pixel,
+               (size_t)width * bytes_per_pixel);
+}
+
+int image_convert_pack_crops(kp_generic_input_node_image_t *input_node, uint8_t *packed_buffer, int packed_buffer_size,
+                             image_convert_crop_pack_t *pack)
+{
+    int regions[MAX_CROP_BOX][5];
+    int packed_width;
+    int packed_height;
+    int packed_size;
+    int width;
+    int height;
+
+    if ((NULL == input_node) || (NULL == input_node->image_buffer) || (NULL == pack))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    memset(pack, 0, sizeof(image_convert_crop_pack_t));
+
+    packed_size = image_convert_crop_pack_size(input_node);
+
+    if (0 > packed_size)
+    {
+        printf("Error! %s(): crop boxes or image format 0x%x of %u x %u are not valid\n", __FUNCTION__, input_node->image_format,
+               input_node->width, input_node->height);
+        return -1;
+    }
+
+    if (0 == packed_size)
+        return 0;
+
+    if ((NULL == packed_buffer) || (packed_buffer_size < packed_size))
+    {
+        printf("Error! %s(): packed buffer needs %d bytes\n", __FUNCTION__, packed_size);
+        return -1;
+    }
+
+    crop_pack_layout(input_node, regions, &packed_width, &packed_height);
+
+    width = (int)input_node->width;
+    height = (int)input_node->height;
+
+    // the gaps between regions are never cropped by the device, clear them to keep the payload deterministic
+    memset(packed_buffer, 0, packed_size);
+
+    for (uint32_t i = 0; i < input_node->crop_count; i++)
+    {
+        const int *region = regions[i];
+
+        if (KP_IMAGE_FORMAT_YUV420 == input_node->image_format)
+        {
+            const uint8_t *src_u = input_node->image_buffer + (size_t)width * height;
+            const uint8_t *src_v = src_u + (size_t)(width / 2) * (height / 2);
+            uint8_t *dst_u = packed_buffer + (size_t)packed_width * packed_height;
+            uint8_t *dst_v = dst_u + (size_t)(packed_width / 2) * (packed_height / 2);
+
+            copy_plane_region(input_node->image_buffer, width, packed_buffer, packed_width, 1, region[0], region[1], region[2], region[3], region[4]);
+            copy_plane_region(src_u, width / 2, dst_u, packed_width / 2, 1, region[0] / 2, region[1] / 2, region[2] / 2, region[3] / 2, region[4] / 2);
+            copy_plane_region(src_v, width / 2, dst_v, packed_width / 2, 1, region[0] / 2, region[1] / 2, region[2] / 2, region[3] / 2, region[4] / 2);
+        }
+        else
+        {
+            int bytes_per_pixel = image_convert_buffer_size(1, 1, (kp_image_format_t)input_node->image_format);
+
+            // YCbCr422 has no 1 x 1 size, its regions are pixel pairs of 2 bytes per pixel
+            if (0 > bytes_per_pixel)
+                bytes_per_pixel = 2;
+
+            copy_plane_region(input_node->image_buffer, width, packed_buffer, packed_width, bytes_per_pixel,
+                              region[0], region[1], region[2], region[3], region[4]);
+        }
+
+        pack->inf_crop[i] = input_node->inf_crop[i];
+        pack->offset_x[i] = region[0];
+        pack->offset_y[i] = region[1] - region[4];
+
+        input_node->inf_crop[i].x1 -= pack->offset_x[i];
+        input_node->inf_crop[i].y1 -= pack->offset_y[i];
+    }
+
+    pack->packed = true;
+    pack->img_width = input_node->width;
+    pack->img_height = input_node->height;
+    pack->crop_count = input_node->crop_count;
+
+    input_node->width = packed_width;
+    input_node->height = packed_height;
+    input_node->image_buffer = packed_buffer;
+
+    return 0;
+}
+
+int image_convert_restore_crop_pre_proc_info(const image_convert_crop_pack_t *pack, uint32_t crop_number, kp_hw_pre_proc_info_t *pre_proc_info)
+{
+    uint32_t index = crop_number;
+
+    if ((NULL == pack) || (NULL == pre_proc_info))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (!pack->packed)
+        return 0;
+
+    // results carry the crop_number of their crop box, which is usually its index
+    for (uint32_t i = 0; i < pack->crop_count; i++)
+    {
+        if (pack->inf_crop[i].crop_number == crop_number)
+        {
+            index = i;
+            break;
+        }
+    }
+
+    if (index >= pack->crop_count)
+    {
+        printf("Error! %s(): crop number %u is not packed\n", __FUNCTION__, crop_number);
+        return -1;
+    }
+
+    pre_proc_info->img_width = pack->img_width;
+    pre_proc_info->img_height = pack->img_height;
+    pre_proc_info->crop_area.x1 += pack->offset_x[index];
+    pre_proc_info->crop_area.y1 += pack->offset_y[index];
+
+    return 0;
+}
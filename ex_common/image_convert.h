@@ -0,0 +1,203 @@
+/**
+ * @file        image_convert.h
+ * @brief       image format conversion APIs
+ *
+ * Conversions between RGB888/BGR888 pixels and the raw image formats of kp_image_format_t, with SIMD kernels and
+ * row-parallel execution for large frames. The results are identical to the scalar conversions of helper_functions.c.
+ *
+ * The host can also letterbox-resize frames to the resized size of the model input before they are sent, so USB carries
+ * model-sized images instead of camera-sized ones and the device only pads them:
+ *
+ *     image_convert_letterbox_size(frame_w, frame_h, model_w, model_h, padding_mode, format, &w, &h);
+ *     image_convert_resize_rgb888(frame, frame_stride, frame_w, frame_h, resized, w * 3, w, h, IMAGE_CONVERT_RESIZE_AREA, threads);
+ *     image_convert_from_rgb888(resized, w * 3, order, w, h, format, image_buffer, threads);
+ *     ... send 'image_buffer' as a w x h image, receive the result ...
+ *     image_convert_restore_pre_proc_info(&result_header.pre_proc_info[0], frame_w, frame_h);
+ *
+ * Boxes scaled by the restored pre_proc_info are in pixels of the original frame.
+ *
+ * Likewise an input image with crop boxes can be replaced by just its crop regions packed into a smaller image, see
+ * image_convert_pack_crops() and image_convert_restore_crop_pre_proc_info().
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "kp_struct.h"
+
+/**
+ * @brief Byte order of 3-byte pixels.
+ */
+typedef enum
+{
+    IMAGE_CONVERT_ORDER_BGR = 0,            /**< blue, green, red, e.g. BMP pixel data and OpenCV Mat */
+    IMAGE_CONVERT_ORDER_RGB,                /**< red, green, blue */
+} image_convert_order_t;
+
+/**
+ * @brief Resize methods.
+ */
+typedef enum
+{
+    IMAGE_CONVERT_RESIZE_AREA = 0,          /**< average of the covered source pixels when downscaling, bilinear when upscaling */
+    IMAGE_CONVERT_RESIZE_BILINEAR,          /**< interpolation of the four nearest source pixels, faster but aliased when downscaling a lot */
+} image_convert_resize_mode_t;
+
+/**
+ * @brief Layout of crop regions packed into a smaller image by image_convert_pack_crops().
+ */
+typedef struct
+{
+    bool packed;                            /**< the crop regions were packed, false if the input image is sent as it is */
+    uint32_t img_width;                     /**< width of the original image */
+    uint32_t img_height;                    /**< height of the original image */
+    uint32_t crop_count;                    /**< number of crops */
+    kp_inf_crop_box_t inf_crop[MAX_CROP_BOX]; /**< crop boxes in the original image */
+    int32_t offset_x[MAX_CROP_BOX];         /**< x of each crop in the original image minus its x in the packed image */
+    int32_t offset_y[MAX_CROP_BOX];         /**< y of each crop in the original image minus its y in the packed image */
+} image_convert_crop_pack_t;
+
+/**
+ * @brief Get the buffer size of an image in a raw image format.
+ *
+ * @param[in] width image width.
+ * @param[in] height image height.
+ * @param[in] format raw image format, refer to kp_image_format_t.
+ *
+ * @return buffer size in bytes, -1 if the format is not supported or the size is not valid for the format.
+ */
+int image_convert_buffer_size(int width, int height, kp_image_format_t format);
+
+/**
+ * @brief Convert RGB888/BGR888 pixels to a raw image format.
+ *
+ * YCbCr422 formats need an even width and YUV420 needs an even width and height.
+ *
+ * @param[in] src first row of the 3-byte pixels.
+ * @param[in] src_stride bytes from one row to the next, a negative stride reads bottom-up rows (e.g. BMP pixel data from its last row).
+ * @param[in] src_order byte order of the pixels, refer to image_convert_order_t.
+ * @param[in] width image width.
+ * @param[in] height image height.
+ * @param[in] format raw image format of the output, refer to kp_image_format_t.
+ * @param[out] dst output buffer of image_convert_buffer_size() bytes, rows are packed.
+ * @param[in] thread_count max number of threads converting bands of rows, 1 converts in the calling thread.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int image_convert_from_rgb888(const uint8_t *src, int src_stride, image_convert_order_t src_order, int width, int height,
+                              kp_image_format_t format, uint8_t *dst, int thread_count);
+
+/**
+ * @brief Convert a raw image format to RGB888/BGR888 pixels.
+ *
+ * @param[in] src input buffer of image_convert_buffer_size() bytes, rows are packed.
+ * @param[in] width image width.
+ * @param[in] height image height.
+ * @param[in] format raw image format of the input, refer to kp_image_format_t.
+ * @param[out] dst first row of the 3-byte pixels.
+ * @param[in] dst_stride bytes from one row to the next, a negative stride writes bottom-up rows (e.g. BMP pixel data from its last row).
+ * @param[in] dst_order byte order of the pixels, refer to image_convert_order_t.
+ * @param[in] thread_count max number of threads converting bands of rows, 1 converts in the calling thread.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int image_convert_to_rgb888(const uint8_t *src, int width, int height, kp_image_format_t format,
+                            uint8_t *dst, int dst_stride, image_convert_order_t dst_order, int thread_count);
+
+/**
+ * @brief Get the size a host resize should produce for the device pre-process to only pad it into the model input.
+ *
+ * With KP_PADDING_CORNER or KP_PADDING_SYMMETRIC the image keeps its aspect ratio and fills the model input along one side,
+ * with KP_PADDING_DISABLE it is stretched to the model input. The image is never upscaled, and the size is rounded down to
+ * even numbers if the format needs them.
+ *
+ * @param[in] width image width.
+ * @param[in] height image height.
+ * @param[in] model_width model input width.
+ * @param[in] model_height model input height.
+ * @param[in] padding_mode padding mode of the inference, refer to kp_padding_mode_t.
+ * @param[in] format raw image format to be sent, refer to kp_image_format_t.
+ * @param[out] resized_width width of the resized image.
+ * @param[out] resized_height height of the resized image.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int image_convert_letterbox_size(int width, int height, int model_width, int model_height, kp_padding_mode_t padding_mode,
+                                 kp_image_format_t format, int *resized_width, int *resized_height);
+
+/**
+ * @brief Resize RGB888/BGR888 pixels, the byte order is kept.
+ *
+ * @param[in] src first row of the source pixels.
+ * @param[in] src_stride bytes from one source row to the next, a negative stride reads bottom-up rows.
+ * @param[in] src_width source width.
+ * @param[in] src_height source height.
+ * @param[out] dst first row of the resized pixels.
+ * @param[in] dst_stride bytes from one resized row to the next.
+ * @param[in] dst_width resized width.
+ * @param[in] dst_height resized height.
+ * @param[in] mode resize method, refer to image_convert_resize_mode_t.
+ * @param[in] thread_count max number of threads resizing bands of rows, 1 resizes in the calling thread.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int image_convert_resize_rgb888(const uint8_t *src, int src_stride, int src_width, int src_height,
+                                uint8_t *dst, int dst_stride, int dst_width, int dst_height, image_convert_resize_mode_t mode, int thread_count);
+
+/**
+ * @brief Make the pre-process info of an image resized on the host refer to the original image.
+ *
+ * The device reports the size of the image it received, this replaces it (and scales the crop area) with the original size,
+ * so post-process functions map boxes to the original image.
+ *
+ * @param[in,out] pre_proc_info pre-process info of an inference result.
+ * @param[in] img_width width of the original image.
+ * @param[in] img_height height of the original image.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int image_convert_restore_pre_proc_info(kp_hw_pre_proc_info_t *pre_proc_info, int img_width, int img_height);
+
+/**
+ * @brief Get the buffer size image_convert_pack_crops() needs for the crop regions of an input image.
+ *
+ * @param[in] input_node input image with crop boxes.
+ *
+ * @return buffer size in bytes, 0 if packing does not make the image smaller, -1 if the crop boxes or the image are not valid.
+ */
+int image_convert_crop_pack_size(const kp_generic_input_node_image_t *input_node);
+
+/**
+ * @brief Replace an input image with its crop regions packed into a smaller image.
+ *
+ * Each crop is extracted with a margin that keeps its position modulo 4 pixels (which also meets the pixel pair alignment
+ * of YCbCr422 and YUV420), the regions are stacked from top to bottom and the crop boxes are moved to the packed image.
+ * The device crops the same pixels from the packed image, so only the pre-process info of the results differs, which
+ * image_convert_restore_crop_pre_proc_info() restores.
+ * If packing does not make the image smaller, the input image is kept and 'packed' of the layout is false.
+ *
+ * @param[in,out] input_node input image with crop boxes, its size, crop boxes and image buffer are replaced by the packed ones.
+ * @param[out] packed_buffer buffer of image_convert_crop_pack_size() bytes for the packed image.
+ * @param[in] packed_buffer_size size of 'packed_buffer'.
+ * @param[out] pack layout of the packed image, needed to restore the pre-process info of the results.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int image_convert_pack_crops(kp_generic_input_node_image_t *input_node, uint8_t *packed_buffer, int packed_buffer_size,
+                             image_convert_crop_pack_t *pack);
+
+/**
+ * @brief Make the pre-process info of a crop result of a packed image refer to the original image.
+ *
+ * @param[in] pack layout from image_convert_pack_crops().
+ * @param[in] crop_number 'crop_number' of the result header.
+ * @param[in,out] pre_proc_info pre-process info of the result.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int image_convert_restore_crop_pre_proc_info(const image_convert_crop_pack_t *pack, uint32_t crop_number, kp_hw_pre_proc_info_t *pre_proc_info);
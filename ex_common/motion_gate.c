@@ -0,0 +1,341 @@
+/**
+ * @file        motion_gate.c
+ * @brief       motion gate to skip inferences of static scenes
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "motion_gate.h"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MOTION_GATE_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MOTION_GATE_NEON
+#endif
+
+#define MOTION_GATE_CELL_SIZE 16            // cells of 16x16 pixels
+#define MOTION_GATE_ROW_STEP 4              // every 4th row of a cell is sampled
+
+typedef enum
+{
+    LUMA_BYTE = 0,                          // 8-bit luma (RAW8, Y plane of YUV420)
+    LUMA_LOW_BYTE,                          // 16-bit pixels with luma in the first byte (YUYV, Y0CbY1Cr, ...)
+    LUMA_HIGH_BYTE,                         // 16-bit pixels with luma in the second byte (CbY0CrY1, ...)
+    LUMA_RGB565_GREEN                       // 6-bit green channel of RGB565
+} luma_type_t;
+
+struct motion_gate_s
+{
+    int width;
+    int height;
+    luma_type_t luma_type;
+    int bytes_per_pixel;
+    float motion_threshold;
+    int refresh_interval;
+    int cells_x;
+    int cells_y;
+    int cell_count;
+    uint16_t *signature;                    // luma sum of each cell of the frame checked
+    uint16_t *reference;                    // luma sum of each cell of the last frame sent
+    uint16_t *cell_thresholds;              // changed luma sum of each cell, as cells at the edges sample less pixels
+    bool has_reference;
+    int skipped_in_row;
+    motion_gate_statistics_t statistics;
+};
+
+/* sum of the luma of 16 pixels */
+static inline uint32_t sum_16_pixels(const uint8_t *pixels, luma_type_t luma_type)
+{
+#if defined(MOTION_GATE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i luma;
+    __m128i sad;
+
+    if (LUMA_BYTE == luma_type)
+    {
+        luma = _mm_loadu_si128((const __m128i *)pixels);
+    }
+    else
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)pixels);
+        __m128i b = _mm_loadu_si128((const __m128i *)(pixels + 16));
+
+        if (LUMA_LOW_BYTE == luma_type)
+        {
+            a = _mm_and_si128(a, _mm_set1_epi16(0x00ff));
+            b = _mm_and_si128(b, _mm_set1_epi16(0x00ff));
+        }
+        else if (LUMA_HIGH_BYTE == luma_type)
+        {
+            a = _mm_srli_epi16(a, 8);
+            b = _mm_srli_epi16(b, 8);
+        }
+        else
+        {
+            a = _mm_and_si128(_mm_srli_epi16(a, 5), _mm_set1_epi16(0x003f));
+            b = _mm_and_si128(_mm_srli_epi16(b, 5), _mm_set1_epi16(0x003f));
+        }
+
+        luma = _mm_packus_epi16(a, b);
+    }
+
+    sad = _mm_sad_epu8(luma, zero);
+
+    return (uint32_t)(_mm_cvtsi128_si32(sad) + _mm_cvtsi128_si32(_mm_srli_si128(sad, 8)));
+#elif defined(MOTION_GATE_NEON)
+    switch (luma_type)
+    {
+    case LUMA_BYTE:
+        return vaddlvq_u8(vld1q_u8(pixels));
+    case LUMA_LOW_BYTE:
+        return vaddlvq_u8(vld2q_u8(pixels).val[0]);
+    case LUMA_HIGH_BYTE:
+        return vaddlvq_u8(vld2q_u8(pixels).val[1]);
+    default:
+    {
+        uint16x8_t a = vandq_u16(vshrq_n_u16(vld1q_u16((const uint16_t *)pixels), 5), vdupq_n_u16(0x003f));
+        uint16x8_t b = vandq_u16(vshrq_n_u16(vld1q_u16((const uint16_t *)(pixels + 16)), 5), vdupq_n_u16(0x003f));
+
+        return vaddvq_u16(vaddq_u16(a, b));
+    }
+    }
+#else
+    uint32_t sum = 0;
+
+    for (int i = 0; i < MOTION_GATE_CELL_SIZE; i++)
+    {
+        if (LUMA_BYTE == luma_type)
+            sum += pixels[i];
+        else if (LUMA_LOW_BYTE == luma_type)
+            sum += pixels[2 * i];
+        else if (LUMA_HIGH_BYTE == luma_type)
+            sum += pixels[2 * i + 1];
+        else
+            sum += ((pixels[2 * i] | (pixels[2 * i + 1] << 8)) >> 5) & 0x3f;
+    }
+
+    return sum;
+#endif
+}
+
+static inline uint32_t luma_of_pixel(const uint8_t *pixel, luma_type_t luma_type)
+{
+    switch (luma_type)
+    {
+    case LUMA_BYTE:
+    case LUMA_LOW_BYTE:
+        return pixel[0];
+    case LUMA_HIGH_BYTE:
+        return pixel[1];
+    default:
+        return ((pixel[0] | (pixel[1] << 8)) >> 5) & 0x3f;
+    }
+}
+
+motion_gate_t *motion_gate_create(int width, int height, kp_image_format_t format, float motion_threshold, int cell_threshold,
+                                  int refresh_interval)
+{
+    motion_gate_t *gate;
+
+    if ((0 >= width) || (0 >= height) || (0 > motion_threshold) || (0 > cell_threshold) || (0 > refresh_interval))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return NULL;
+    }
+
+    gate = (motion_gate_t *)calloc(1, sizeof(motion_gate_t));
+    if (NULL == gate)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return NULL;
+    }
+
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_RAW8:
+    case KP_IMAGE_FORMAT_YUV420:
+        gate->luma_type = LUMA_BYTE;
+        gate->bytes_per_pixel = 1;
+        break;
+    case KP_IMAGE_FORMAT_YUYV:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
+        gate->luma_type = LUMA_LOW_BYTE;
+        gate->bytes_per_pixel = 2;
+        break;
+    case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
+        gate->luma_type = LUMA_HIGH_BYTE;
+        gate->bytes_per_pixel = 2;
+        break;
+    case KP_IMAGE_FORMAT_RGB565:
+        gate->luma_type = LUMA_RGB565_GREEN;
+        gate->bytes_per_pixel = 2;
+        break;
+    default:
+        printf("Error! %s(): image format 0x%x is not supported\n", __FUNCTION__, format);
+        free(gate);
+        return NULL;
+    }
+
+    gate->width = width;
+    gate->height = height;
+    gate->motion_threshold = motion_threshold;
+    gate->refresh_interval = refresh_interval;
+    gate->cells_x = (width + MOTION_GATE_CELL_SIZE - 1) / MOTION_GATE_CELL_SIZE;
+    gate->cells_y = (height + MOTION_GATE_CELL_SIZE - 1) / MOTION_GATE_CELL_SIZE;
+    gate->cell_count = gate->cells_x * gate->cells_y;
+
+    gate->signature = (uint16_t *)malloc(sizeof(uint16_t) * gate->cell_count);
+    gate->reference = (uint16_t *)malloc(sizeof(uint16_t) * gate->cell_count);
+    gate->cell_thresholds = (uint16_t *)malloc(sizeof(uint16_t) * gate->cell_count);
+
+    if ((NULL == gate->signature) || (NULL == gate->reference) || (NULL == gate->cell_thresholds))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        motion_gate_release(gate);
+        return NULL;
+    }
+
+    // RGB565 green is 6-bit, its threshold is scaled instead of its sums
+    if (LUMA_RGB565_GREEN == gate->luma_type)
+        cell_threshold = (cell_threshold + 2) / 4;
+
+    for (int cell_y = 0; cell_y < gate->cells_y; cell_y++)
+    {
+        int rows = height - cell_y * MOTION_GATE_CELL_SIZE;
+        rows = (rows > MOTION_GATE_CELL_SIZE) ? MOTION_GATE_CELL_SIZE : rows;
+        rows = (rows + MOTION_GATE_ROW_STEP - 1) / MOTION_GATE_ROW_STEP;
+
+        for (int cell_x = 0; cell_x < gate->cells_x; cell_x++)
+        {
+            int pixels = width - cell_x * MOTION_GATE_CELL_SIZE;
+            pixels = (pixels > MOTION_GATE_CELL_SIZE) ? MOTION_GATE_CELL_SIZE : pixels;
+
+            gate->cell_thresholds[cell_y * gate->cells_x + cell_x] = (uint16_t)((cell_threshold * rows * pixels > 0xffff) ? 0xffff : cell_threshold * rows * pixels);
+        }
+    }
+
+    return gate;
+}
+
+void motion_gate_release(motion_gate_t *gate)
+{
+    if (NULL == gate)
+        return;
+
+    free(gate->signature);
+    free(gate->reference);
+    free(gate->cell_thresholds);
+    free(gate);
+}
+
+bool motion_gate_check(motion_gate_t *gate, const uint8_t *image_buffer)
+{
+    int full_cells;
+    size_t row_size;
+    int changed_count = 0;
+    bool send;
+
+    if ((NULL == gate) || (NULL == image_buffer))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return true;
+    }
+
+    full_cells = gate->width / MOTION_GATE_CELL_SIZE;
+    row_size = (size_t)gate->width * gate->bytes_per_pixel;
+
+    /* luma sums of the cells on every MOTION_GATE_ROW_STEP rows */
+    memset(gate->signature, 0, sizeof(uint16_t) * gate->cell_count);
+
+    for (int y = 0; y < gate->height; y += MOTION_GATE_ROW_STEP)
+    {
+        const uint8_t *row = image_buffer + row_size * y;
+        uint16_t *signature = gate->signature + (y / MOTION_GATE_CELL_SIZE) * gate->cells_x;
+
+        for (int cell_x = 0; cell_x < full_cells; cell_x++)
+            signature[cell_x] += (uint16_t)sum_16_pixels(row + (size_t)cell_x * MOTION_GATE_CELL_SIZE * gate->bytes_per_pixel, gate->luma_type);
+
+        if (full_cells < gate->cells_x)
+        {
+            uint32_t sum = 0;
+
+            for (int x = full_cells * MOTION_GATE_CELL_SIZE; x < gate->width; x++)
+                sum += luma_of_pixel(row + (size_t)x * gate->bytes_per_pixel, gate->luma_type);
+
+            signature[full_cells] += (uint16_t)sum;
+        }
+    }
+
+    gate->statistics.frame_count++;
+
+    if (!gate->has_reference)
+    {
+        send = true;
+        gate->statistics.last_motion = 1.0f;
+    }
+    else
+    {
+        for (int i = 0; i < gate->cell_count; i++)
+        {
+            int diff = (int)gate->signature[i] - (int)gate->reference[i];
+
+            changed_count += ((diff < 0) ? -diff : diff) > gate->cell_thresholds[i];
+        }
+
+        gate->statistics.last_motion = (float)changed_count / gate->cell_count;
+        send = (gate->statistics.last_motion > gate->motion_threshold);
+
+        if (!send && (0 < gate->refresh_interval) && (gate->skipped_in_row >= gate->refresh_interval))
+        {
+            send = true;
+            gate->statistics.refresh_count++;
+        }
+    }
+
+    if (send)
+    {
+        // the frame sent becomes the reference
+        uint16_t *reference = gate->reference;
+
+        gate->reference = gate->signature;
+        gate->signature = reference;
+        gate->has_reference = true;
+        gate->skipped_in_row = 0;
+        gate->statistics.sent_count++;
+    }
+    else
+    {
+        gate->skipped_in_row++;
+        gate->statistics.skipped_count++;
+    }
+
+    return send;
+}
+
+void motion_gate_reset(motion_gate_t *gate)
+{
+    if (NULL != gate)
+        gate->has_reference = false;
+}
+
+void motion_gate_get_statistics(motion_gate_t *gate, motion_gate_statistics_t *statistics)
+{
+    if ((NULL == gate) || (NULL == statistics))
+        return;
+
+    *statistics = gate->statistics;
+}
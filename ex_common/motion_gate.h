@@ -0,0 +1,97 @@
+/**
+ * @file        motion_gate.h
+ * @brief       motion gate to skip inferences of static scenes
+ *
+ * A gate compares a downsampled luma signature of each frame, computed on the raw image buffer to be sent, with the one of
+ * the last frame sent. Frames of a static scene are not sent, the result of the last sent frame is reused instead:
+ *
+ *     if (motion_gate_check(gate, frame_buffer))
+ *     {
+ *         kp_generic_image_inference_send(device, &inf_desc);
+ *         kp_generic_image_inference_receive(device, &output_desc, raw_output_buf, raw_buf_size);
+ *         post_process_yolo_v3(...);                           // updates the kp_yolo_result_t of the scene
+ *     }
+ *     // otherwise the kp_yolo_result_t of the last sent frame is still the result of this frame
+ *
+ * The signature is the mean luma of 16x16 cells, sampled on every 4th row: Y of YUYV/YCbCr422, the Y plane of YUV420, RAW8,
+ * and the green channel of RGB565. A frame is sent if the mean of more than 'motion_threshold' of the cells changed by more
+ * than 'cell_threshold', or if 'refresh_interval' frames were skipped in a row.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "kp_struct.h"
+
+/**
+ * @brief Statistics of a motion gate.
+ */
+typedef struct
+{
+    uint32_t frame_count;                   /**< number of frames checked */
+    uint32_t sent_count;                    /**< number of frames to be sent, including refreshes */
+    uint32_t skipped_count;                 /**< number of frames skipped, reusing the result of the last sent frame */
+    uint32_t refresh_count;                 /**< number of frames sent only because 'refresh_interval' frames were skipped */
+    float last_motion;                      /**< fraction of changed cells of the last frame checked */
+} motion_gate_statistics_t;
+
+/**
+ * @brief Motion gate of one stream of frames.
+ */
+typedef struct motion_gate_s motion_gate_t;
+
+/**
+ * @brief Create a motion gate.
+ *
+ * @param[in] width frame width.
+ * @param[in] height frame height.
+ * @param[in] format image format of the frames, refer to kp_image_format_t (RGBA8888 is not supported).
+ * @param[in] motion_threshold fraction of changed cells (0 ~ 1) above which a frame is sent, 0 sends every changed frame.
+ * @param[in] cell_threshold change of the mean luma (0 ~ 255) above which a cell is changed, it should be above sensor noise.
+ * @param[in] refresh_interval a frame is sent after this many frames were skipped in a row, 0 for no forced refresh.
+ *
+ * @return the gate, NULL if failed.
+ */
+motion_gate_t *motion_gate_create(int width, int height, kp_image_format_t format, float motion_threshold, int cell_threshold,
+                                  int refresh_interval);
+
+/**
+ * @brief Release a motion gate.
+ *
+ * @param[in] gate the gate.
+ */
+void motion_gate_release(motion_gate_t *gate);
+
+/**
+ * @brief Check whether a frame has to be sent, the first frame is always sent.
+ *
+ * The signature of a frame to be sent becomes the reference of the following frames, so slow changes accumulate until they
+ * exceed the thresholds.
+ *
+ * @param[in] gate the gate.
+ * @param[in] image_buffer frame in the format and size of the gate, rows are packed.
+ *
+ * @return true if the frame has to be sent, false if the result of the last sent frame can be reused.
+ */
+bool motion_gate_check(motion_gate_t *gate, const uint8_t *image_buffer);
+
+/**
+ * @brief Force the next frame to be sent, e.g. after its inference failed or was dropped.
+ *
+ * @param[in] gate the gate.
+ */
+void motion_gate_reset(motion_gate_t *gate);
+
+/**
+ * @brief Get the statistics of a motion gate.
+ *
+ * @param[in] gate the gate.
+ * @param[out] statistics the statistics.
+ */
+void motion_gate_get_statistics(motion_gate_t *gate, motion_gate_statistics_t *statistics);
@@ -8,12 +8,19 @@
  */
 
 #include <math.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "postprocess.h"
 
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #define YOLO_V3_CELL_BOX_NUM 3
 #define YOLO_V3_BOX_FIX_CH 5
 #define NMS_THRESH_YOLOV3_520 0.45
@@ -22,6 +29,12 @@
 #define MODEL_SHIRNK_RATIO_TYV3 32
 #define MODEL_SHIRNK_RATIO_V5 8
 #define YOLO_MAX_DETECTION_PER_CLASS 100
+#define YOLO_NMS_MIN_CHUNK 64
+#define NMS_THRESH_SSD_FD 0.45
+#define SSD_LOGIT_MARGIN_SLACK 0.01f
+#define TRACKER_VELOCITY_GAIN 0.5f
+#define TRACKER_GRID_CELLS_PER_TRACK 4
+#define TRACKER_MIN_CAPACITY 64
 
 /* IOU Methods */
 enum IOU_TYPE
@@ -30,16 +43,6 @@ enum IOU_TYPE
     IOU_MIN,
 };
 
-const float yolo_v3_anchers[3][3][2] = {
-    {{81, 82}, {135, 169}, {344, 319}},
-    {{23, 27}, {37, 58}, {81, 82}},
-    {{0, 0}, {0, 0}, {0, 0}}};
-
-const float yolo_v5_anchers[3][3][2] = {
-    {{10, 13}, {16, 30}, {33, 23}},
-    {{30, 61}, {62, 45}, {59, 119}},
-    {{116, 90}, {156, 198}, {373, 326}}};
-
 static float sigmoid(float x)
 {
     float exp_value;
@@ -52,6 +55,45 @@ static float sigmoid(float x)
     return return_value;
 }
 
+static post_process_node_lut_t *yolo_node_lut(post_process_yolo_context_t *context, int node_idx)
+{
+    if ((node_idx >= context->node_lut_count) || (KP_FIXED_POINT_DTYPE_UNKNOWN == context->node_luts[node_idx].fixed_point_dtype))
+        return NULL;
+
+    return &context->node_luts[node_idx];
+}
+
+/* table index of x if x is dequantized from a fixed-point value by the quantization of lut, otherwise -1 */
+static inline int node_lut_index(post_process_node_lut_t *lut, float x)
+{
+    float fixed_point = x * lut->quantization_factor;
+
+    if ((fixed_point > (lut->fixed_point_min - 0.5f)) && (fixed_point < (lut->fixed_point_max + 0.5f)))
+    {
+        int value = (int)lrintf(fixed_point);
+
+        // the same dequantization as kp_generic_inference_retrieve_float_node()
+        if ((float)value / lut->quantization_factor == x)
+            return value - lut->fixed_point_min;
+    }
+
+    return -1;
+}
+
+static inline float node_lut_sigmoid(post_process_node_lut_t *lut, float x)
+{
+    int index = (NULL == lut) ? -1 : node_lut_index(lut, x);
+
+    return (0 <= index) ? lut->sigmoid_table[index] : sigmoid(x);
+}
+
+static inline double node_lut_exp(post_process_node_lut_t *lut, float x)
+{
+    int index = (NULL == lut) ? -1 : node_lut_index(lut, x);
+
+    return (0 <= index) ? lut->exp_table[index] : exp(x);
+}
+
 static int float_score_comparator(float float_num_1, float float_num_2)
 {
     float diff = float_num_1 - float_num_2;
@@ -155,395 +197,499 @@ static float box_iou(kp_bounding_box_t *a, kp_bounding_box_t *b, int nms_type)
     return c;
 }
 
-void boxes_scale(kp_bounding_box_t *boxes, int size, kp_hw_pre_proc_info_t *pre_proc_info)
+/*
+ * NMS over boxes in structure-of-arrays form: the IoU of one kept box is computed against a block of the remaining boxes.
+ * Every lane repeats the scalar operations of box_iou() in the same order (IEEE add/sub/mul/div, ternary min/max as select),
+ * so the suppression decisions are identical to box_iou().
+ */
+#if defined(__AVX2__)
+#define NMS_VEC_WIDTH 8
+typedef __m256 nms_vec_t;
+typedef __m256 nms_mask_t;
+#define nms_vec_set1(v) _mm256_set1_ps(v)
+#define nms_vec_load(p) _mm256_loadu_ps(p)
+#define nms_vec_add(a, b) _mm256_add_ps(a, b)
+#define nms_vec_sub(a, b) _mm256_sub_ps(a, b)
+#define nms_vec_mul(a, b) _mm256_mul_ps(a, b)
+#define nms_vec_div(a, b) _mm256_div_ps(a, b)
+#define nms_vec_gt(a, b) _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define nms_vec_lt(a, b) _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define nms_mask_or(a, b) _mm256_or_ps(a, b)
+#define nms_vec_select(m, a, b) _mm256_blendv_ps(b, a, m)
+#define nms_mask_bits(m) _mm256_movemask_ps(m)
+#elif defined(__SSE2__) || defined(_M_X64)
+#define NMS_VEC_WIDTH 4
+typedef __m128 nms_vec_t;
+typedef __m128 nms_mask_t;
+#define nms_vec_set1(v) _mm_set1_ps(v)
+#define nms_vec_load(p) _mm_loadu_ps(p)
+#define nms_vec_add(a, b) _mm_add_ps(a, b)
+#define nms_vec_sub(a, b) _mm_sub_ps(a, b)
+#define nms_vec_mul(a, b) _mm_mul_ps(a, b)
+#define nms_vec_div(a, b) _mm_div_ps(a, b)
+#define nms_vec_gt(a, b) _mm_cmpgt_ps(a, b)
+#define nms_vec_lt(a, b) _mm_cmplt_ps(a, b)
+#define nms_mask_or(a, b) _mm_or_ps(a, b)
+#define nms_vec_select(m, a, b) _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define nms_mask_bits(m) _mm_movemask_ps(m)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define NMS_VEC_WIDTH 4
+typedef float32x4_t nms_vec_t;
+typedef uint32x4_t nms_mask_t;
+#define nms_vec_set1(v) vdupq_n_f32(v)
+#define nms_vec_load(p) vld1q_f32(p)
+#define nms_vec_add(a, b) vaddq_f32(a, b)
+#define nms_vec_sub(a, b) vsubq_f32(a, b)
+#define nms_vec_mul(a, b) vmulq_f32(a, b)
+#define nms_vec_div(a, b) vdivq_f32(a, b)
+#define nms_vec_gt(a, b) vcgtq_f32(a, b)
+#define nms_vec_lt(a, b) vcltq_f32(a, b)
+#define nms_mask_or(a, b) vorrq_u32(a, b)
+#define nms_vec_select(m, a, b) vbslq_f32(m, a, b)
+#define nms_mask_bits(m) ((vgetq_lane_u32(m, 0) & 1) | (vgetq_lane_u32(m, 1) & 2) | (vgetq_lane_u32(m, 2) & 4) | (vgetq_lane_u32(m, 3) & 8))
+#endif
+
+enum
 {
-    int img_width = pre_proc_info->img_width;
-    int img_height = pre_proc_info->img_height;
-    int pad_left = pre_proc_info->pad_left;
-    int pad_top = pre_proc_info->pad_top;
-    float ratio_w = (float)img_width / pre_proc_info->resized_img_width;
-    float ratio_h = (float)img_height / pre_proc_info->resized_img_height;
+    NMS_SOA_X1 = 0,
+    NMS_SOA_Y1,
+    NMS_SOA_X2,
+    NMS_SOA_Y2,
+    NMS_SOA_AREA,   // (y2 - y1) * (x2 - x1), as in box_union()
+    NMS_SOA_SELF,   // box_intersection() of a box with itself, as in IOU_MIN
+    NMS_SOA_NUM
+};
 
-    for (int i = 0; i < size; i++)
-    {
-        boxes[i].x2 = (boxes[i].x2 - boxes[i].x1) * ratio_w; // w
-        boxes[i].y2 = (boxes[i].y2 - boxes[i].y1) * ratio_h; // h
-        boxes[i].x1 -= pad_left;
-        boxes[i].y1 -= pad_top;
-        boxes[i].x1 *= ratio_w;
-        boxes[i].y1 *= ratio_h;
-        boxes[i].x2 += boxes[i].x1;
-        boxes[i].y2 += boxes[i].y1;
+/* the float threshold 't' which gives 'iou > t' the same result as comparing the float iou with the double threshold */
+static float nms_float_threshold(double nms_thresh)
+{
+    float thresh = (float)nms_thresh;
 
-        // limit Rectangle
-        boxes[i].x1 = ((int)(boxes[i].x1 + 0.5) > 0) ? (int)(boxes[i].x1 + 0.5) : 0;
-        boxes[i].y1 = ((int)(boxes[i].y1 + 0.5) > 0) ? (int)(boxes[i].y1 + 0.5) : 0;
-        boxes[i].x2 = ((int)(boxes[i].x2 + 0.5) < (img_width - 1)) ? (int)(boxes[i].x2 + 0.5) : img_width - 1;
-        boxes[i].y2 = ((int)(boxes[i].y2 + 0.5) < (img_height - 1)) ? (int)(boxes[i].y2 + 0.5) : img_height - 1;
-    }
+    if ((double)thresh > nms_thresh)
+        thresh = nextafterf(thresh, -INFINITY);
+
+    return thresh;
 }
 
-int post_process_yolo_v3(kp_inf_float_node_output_t *node_output[], int num_output_node,
-                         kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+#ifdef NMS_VEC_WIDTH
+static int nms_soa_block_suppress_bits(float **soa, int a, int b, int nms_type, nms_vec_t thresh)
 {
-    int class_count = (node_output[0]->shape[1] / YOLO_V3_CELL_BOX_NUM) - YOLO_V3_BOX_FIX_CH;
-    float *box_class_probs = NULL;
-    kp_bounding_box_t *possible_boxes = NULL;
-    kp_bounding_box_t *temp_boxes = NULL;
-    int good_box_count = 0;
-    int good_result_count = 0;
+    nms_vec_t zero = nms_vec_set1(0.f);
+    nms_vec_t a_x1 = nms_vec_set1(soa[NMS_SOA_X1][a]);
+    nms_vec_t a_y1 = nms_vec_set1(soa[NMS_SOA_Y1][a]);
+    nms_vec_t a_x2 = nms_vec_set1(soa[NMS_SOA_X2][a]);
+    nms_vec_t a_y2 = nms_vec_set1(soa[NMS_SOA_Y2][a]);
+    nms_vec_t b_x1 = nms_vec_load(&soa[NMS_SOA_X1][b]);
+    nms_vec_t b_y1 = nms_vec_load(&soa[NMS_SOA_Y1][b]);
+    nms_vec_t b_x2 = nms_vec_load(&soa[NMS_SOA_X2][b]);
+    nms_vec_t b_y2 = nms_vec_load(&soa[NMS_SOA_Y2][b]);
+    nms_vec_t c;
+
+    // overlap(): left = l1 > l2 ? l1 : l2, right = r1 < r2 ? r1 : r2
+    nms_vec_t w = nms_vec_sub(nms_vec_select(nms_vec_lt(a_x2, b_x2), a_x2, b_x2), nms_vec_select(nms_vec_gt(a_x1, b_x1), a_x1, b_x1));
+    nms_vec_t h = nms_vec_sub(nms_vec_select(nms_vec_lt(a_y2, b_y2), a_y2, b_y2), nms_vec_select(nms_vec_gt(a_y1, b_y1), a_y1, b_y1));
+    nms_vec_t inter = nms_vec_select(nms_mask_or(nms_vec_lt(w, zero), nms_vec_lt(h, zero)), zero, nms_vec_mul(w, h));
 
-    box_class_probs = (float *)malloc(class_count * sizeof(float));
-    if (NULL == box_class_probs ) {
-        printf("Error! %s(): malloc memory for probs failed\n", __FUNCTION__);
-        goto err;
+    switch (nms_type)
+    {
+    case IOU_MIN:
+    {
+        nms_vec_t ratio_a = nms_vec_div(inter, nms_vec_set1(soa[NMS_SOA_SELF][a]));
+        nms_vec_t ratio_b = nms_vec_div(inter, nms_vec_load(&soa[NMS_SOA_SELF][b]));
+        c = nms_vec_select(nms_vec_gt(ratio_a, ratio_b), ratio_a, ratio_b);
+        break;
     }
-
-    possible_boxes = (kp_bounding_box_t *)malloc(MAX_POSSIBLE_BOXES * sizeof(kp_bounding_box_t));
-    if (NULL == possible_boxes) {
-        printf("Error! %s(): malloc memory for boxes failed\n", __FUNCTION__);
-        goto err;
+    default:
+    {
+        nms_vec_t u = nms_vec_sub(nms_vec_add(nms_vec_set1(soa[NMS_SOA_AREA][a]), nms_vec_load(&soa[NMS_SOA_AREA][b])), inter);
+        nms_vec_t ratio = nms_vec_div(inter, u);
+        c = nms_vec_select(nms_vec_lt(zero, ratio), ratio, zero);
+        break;
     }
-    temp_boxes = (kp_bounding_box_t *)malloc(MAX_POSSIBLE_BOXES * sizeof(kp_bounding_box_t));
-    if (NULL == temp_boxes) {
-        printf("Error! %s(): malloc memory for temp boxes failed\n", __FUNCTION__);
-        goto err;
     }
 
-    for (int i = 0; i < num_output_node; i++)
-    {
-        int grid_w = node_output[i]->shape[3];
-        int grid_h = node_output[i]->shape[2];
-        int grid_c = node_output[i]->shape[1];
+    return nms_mask_bits(nms_vec_gt(c, thresh));
+}
+#endif
 
-        int width_size = grid_w * grid_c;
-        int anchor_offset = width_size / 3;
+/*
+ * same suppression as the pairwise box_iou() loop over 'boxes' sorted by box_comparator(), 'soa' holds NMS_SOA_NUM arrays of at least 'end' floats.
+ * boxes[0, begin) are suppressed by a previous call, boxes[begin, end) are appended to them. The suppression stops once 'keep_limit' boxes are kept
+ * since the following boxes can not be output, the returned prefix of boxes is final.
+ */
+static int nms_soa_suppress(kp_bounding_box_t *boxes, int begin, int end, float **soa, int nms_type, float thresh, int keep_limit)
+{
+    int keep_count = 0;
 
-        float ratio_w = (float)pre_proc_info->model_input_width / grid_w;
-        float ratio_h = (float)pre_proc_info->model_input_height / grid_h;
+    for (int i = begin; i < end; i++)
+    {
+        float w = boxes[i].x2 - boxes[i].x1;
+        float h = boxes[i].y2 - boxes[i].y1;
+
+        soa[NMS_SOA_X1][i] = boxes[i].x1;
+        soa[NMS_SOA_Y1][i] = boxes[i].y1;
+        soa[NMS_SOA_X2][i] = boxes[i].x2;
+        soa[NMS_SOA_Y2][i] = boxes[i].y2;
+        soa[NMS_SOA_AREA][i] = (boxes[i].y2 - boxes[i].y1) * (boxes[i].x2 - boxes[i].x1);
+        soa[NMS_SOA_SELF][i] = (w < 0 || h < 0) ? 0 : w * h;
+    }
 
-        for (int row = 0; row < grid_h; row++)
-        {
-            for (int an = 0; an < YOLO_V3_CELL_BOX_NUM; an++)
-            {
-                float *data = node_output[i]->data + row * width_size + an * anchor_offset;
+    for (int j = 0; j < end; j++)
+    {
+        if (boxes[j].score == 0)
+            continue;
 
-                float *x_p = data;
-                float *y_p = x_p + grid_w;
-                float *width_p = y_p + grid_w;
-                float *height_p = width_p + grid_w;
-                float *score_p = height_p + grid_w;
-                float *class_p = score_p + grid_w;
+        if ((boxes[j].score > 0) && (++keep_count == keep_limit))
+            return j + 1;
 
-                for (int col = 0; col < grid_w; col++)
-                {
-                    float box_x = *(x_p + col);
-                    float box_y = *(y_p + col);
-                    float box_w = *(width_p + col);
-                    float box_h = *(height_p + col);
-                    float box_confidence = sigmoid(*(score_p + col));
+        int k = (j + 1 > begin) ? j + 1 : begin;
 
-                    float x1, y1, x2, y2;
-                    bool first_box = false;
+#ifdef NMS_VEC_WIDTH
+        nms_vec_t thresh_vec = nms_vec_set1(thresh);
 
-                    for (int j = 0; j < class_count; j++)
-                    {
-                        box_class_probs[j] = (float)*(class_p + col + j * grid_w);
-                    }
+        for (; k + NMS_VEC_WIDTH <= end; k += NMS_VEC_WIDTH)
+        {
+            int bits = nms_soa_block_suppress_bits(soa, j, k, nms_type, thresh_vec);
 
-                    /* Get scores of all class */
-                    for (int j = 0; j < class_count; j++)
-                    {
-                        float max_score = sigmoid(box_class_probs[j]) * box_confidence;
-                        if (max_score >= thresh_value)
-                        {
-                            if (!first_box)
-                            {
-                                first_box = true;
-
-                                box_x = (sigmoid(box_x) + col) * ratio_w;
-                                box_y = (sigmoid(box_y) + row) * ratio_h;
-                                box_w = exp(box_w) * yolo_v3_anchers[i][an][0];
-                                box_h = exp(box_h) * yolo_v3_anchers[i][an][1];
-
-                                x1 = box_x - (box_w / 2);
-                                y1 = box_y - (box_h / 2);
-                                x2 = box_x + (box_w / 2);
-                                y2 = box_y + (box_h / 2);
-                            }
-
-                            possible_boxes[good_box_count].x1 = x1;
-                            possible_boxes[good_box_count].y1 = y1;
-                            possible_boxes[good_box_count].x2 = x2;
-                            possible_boxes[good_box_count].y2 = y2;
-                            possible_boxes[good_box_count].score = max_score;
-                            possible_boxes[good_box_count].class_num = j;
-                            good_box_count++;
-
-                            if (good_box_count >= MAX_POSSIBLE_BOXES)
-                            {
-                                printf("post yolo v3: error ! aborted due to too many boxes\n");
-                                goto err;
-                            }
-                        }
-                    }
-                }
+            for (int lane = 0; bits; lane++, bits >>= 1)
+            {
+                if (bits & 1)
+                    boxes[k + lane].score = 0;
             }
         }
+#endif
+
+        for (; k < end; k++)
+        {
+            if (box_iou(&boxes[j], &boxes[k], nms_type) > thresh)
+                boxes[k].score = 0;
+        }
     }
 
-    for (int i = 0; i < class_count; i++)
+    return end;
+}
+
+static inline void box_swap(kp_bounding_box_t *a, kp_bounding_box_t *b)
+{
+    kp_bounding_box_t tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void box_sift_down(kp_bounding_box_t *heap, int size, int idx, int (*comparator)(const void *, const void *))
+{
+    while (1)
     {
-        kp_bounding_box_t *bbox = possible_boxes;
-        kp_bounding_box_t *r_tmp_p = temp_boxes;
+        int child = 2 * idx + 1;
 
-        int class_good_box_count = 0;
+        if (child >= size)
+            break;
 
-        for (int j = 0; j < good_box_count; j++)
-        {
-            if (bbox->class_num == i)
-            {
-                memcpy(r_tmp_p, bbox, sizeof(kp_bounding_box_t));
-                r_tmp_p++;
-                class_good_box_count++;
-            }
-            bbox++;
-        }
+        // the root of the heap is the worst box by comparator
+        if ((child + 1 < size) && (comparator(&heap[child + 1], &heap[child]) > 0))
+            child++;
 
-        if (class_good_box_count == 1)
-        {
-            if (good_result_count < YOLO_GOOD_BOX_MAX)
-            {
-                memcpy(&(yoloResult->boxes[good_result_count]), &temp_boxes[0], sizeof(kp_bounding_box_t));
-                good_result_count++;
-            }
-        }
-        else if (class_good_box_count >= 2)
+        if (comparator(&heap[child], &heap[idx]) <= 0)
+            break;
+
+        box_swap(&heap[child], &heap[idx]);
+        idx = child;
+    }
+}
+
+/* move the best 'top_k' boxes by comparator to boxes[0, top_k) in any order, introselect with a heap selection fallback */
+static void box_select_top(kp_bounding_box_t *boxes, int count, int top_k, int (*comparator)(const void *, const void *))
+{
+    int left = 0;
+    int right = count - 1;
+    int depth_limit = 0;
+
+    if ((top_k <= 0) || (top_k >= count))
+        return;
+
+    for (int n = count; n > 1; n >>= 1)
+        depth_limit += 2;
+
+    while (right > left)
+    {
+        if (0 == depth_limit--)
         {
-            qsort(temp_boxes, class_good_box_count, sizeof(kp_bounding_box_t), box_comparator);
-            for (int j = 0; j < class_good_box_count; j++)
-            {
-                if (temp_boxes[j].score == 0)
-                    continue;
-                for (int k = j + 1; k < class_good_box_count; k++)
-                {
-                    if (box_iou(&temp_boxes[j], &temp_boxes[k], IOU_UNION) > NMS_THRESH_YOLOV3_520)
-                    {
-                        temp_boxes[k].score = 0;
-                    }
-                }
-            }
+            // keep the best (top_k - left) boxes of [left, right] in a heap whose root is the worst of them
+            kp_bounding_box_t *heap = &boxes[left];
+            int heap_size = top_k - left;
 
-            int good_count = 0;
-            for (int j = 0; j < class_good_box_count; j++)
+            if (0 == heap_size)
+                return;
+
+            for (int i = heap_size / 2 - 1; i >= 0; i--)
+                box_sift_down(heap, heap_size, i, comparator);
+
+            for (int i = left + heap_size; i <= right; i++)
             {
-                if (temp_boxes[j].score > 0 && good_result_count < YOLO_GOOD_BOX_MAX)
-                {
-                    memcpy(&(yoloResult->boxes[good_result_count]), &temp_boxes[j], sizeof(kp_bounding_box_t));
-                    good_result_count++;
-                    good_count++;
-                }
-                if (YOLO_MAX_DETECTION_PER_CLASS == good_count)
+                if (comparator(&boxes[i], &heap[0]) < 0)
                 {
-                    break;
+                    box_swap(&boxes[i], &heap[0]);
+                    box_sift_down(heap, heap_size, 0, comparator);
                 }
             }
+            return;
         }
 
-        // FIXME: find a better policy to filter the detected bounding box result if total box count exceeds YOLO_GOOD_BOX_MAX
-        if (good_result_count >= YOLO_GOOD_BOX_MAX)
-            break;
+        // median of three as pivot, moved to boxes[right]
+        int mid = left + (right - left) / 2;
+        if (comparator(&boxes[mid], &boxes[left]) < 0)
+            box_swap(&boxes[mid], &boxes[left]);
+        if (comparator(&boxes[right], &boxes[left]) < 0)
+            box_swap(&boxes[right], &boxes[left]);
+        if (comparator(&boxes[mid], &boxes[right]) < 0)
+            box_swap(&boxes[mid], &boxes[right]);
+
+        int store = left;
+        for (int i = left; i < right; i++)
+        {
+            if (comparator(&boxes[i], &boxes[right]) < 0)
+                box_swap(&boxes[i], &boxes[store++]);
+        }
+        box_swap(&boxes[store], &boxes[right]);
+
+        if (store == top_k)
+            return;
+        else if (store < top_k)
+            left = store + 1;
+        else
+            right = store - 1;
     }
+}
 
-    yoloResult->box_count = good_result_count;
-    yoloResult->class_count = class_count;
+/* box_comparator() with class as the last key, for selecting candidates of all classes */
+static int box_class_comparator(const void *box_1, const void *box_2)
+{
+    int res = box_comparator(box_1, box_2);
+    if (res != 0)
+        return res;
+
+    return ((kp_bounding_box_t *)box_1)->class_num - ((kp_bounding_box_t *)box_2)->class_num;
+}
 
-    // convert the coordinate of all bounding boxes to raw image
-    boxes_scale(yoloResult->boxes, yoloResult->box_count, pre_proc_info);
+/*
+ * sort and suppress the boxes of one class, only the prefix NMS consumes is sorted: the best boxes are selected and sorted chunk by chunk
+ * until 'keep_limit' boxes are kept or all boxes are suppressed, returns the length of the final prefix
+ */
+static int nms_partial_sort_suppress(kp_bounding_box_t *boxes, int count, float **soa, int nms_type, double nms_thresh, int keep_limit)
+{
+    float thresh = nms_float_threshold(nms_thresh);
+    int chunk = (2 * keep_limit > YOLO_NMS_MIN_CHUNK) ? 2 * keep_limit : YOLO_NMS_MIN_CHUNK;
+    int sorted = 0;
+    int processed = 0;
 
-    free(box_class_probs);
-    free(possible_boxes);
-    free(temp_boxes);
+    while (sorted < count)
+    {
+        int size = (chunk < count - sorted) ? chunk : count - sorted;
 
-    return 0;
+        box_select_top(&boxes[sorted], count - sorted, size, box_comparator);
+        qsort(&boxes[sorted], size, sizeof(kp_bounding_box_t), box_comparator);
 
-err:
-    free(box_class_probs);
-    free(possible_boxes);
-    free(temp_boxes);
+        processed = nms_soa_suppress(boxes, sorted, sorted + size, soa, nms_type, thresh, keep_limit);
+        sorted += size;
 
-    return -1;
+        if (processed < sorted)
+            break;
+
+        chunk *= 2;
+    }
+
+    return processed;
 }
 
-int post_process_yolo_v5_520(kp_inf_float_node_output_t *node_output[], int num_output_node,
-                             kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+void post_process_box_transform_init(post_process_box_transform_t *box_transform, kp_hw_pre_proc_info_t *pre_proc_info)
 {
-    int class_count = (node_output[0]->shape[1] / YOLO_V3_CELL_BOX_NUM) - YOLO_V3_BOX_FIX_CH;
-    float *box_class_probs = NULL;
-    kp_bounding_box_t *possible_boxes = NULL;
-    kp_bounding_box_t *temp_boxes = NULL;
+    box_transform->scale_x = (float)pre_proc_info->img_width / pre_proc_info->resized_img_width;
+    box_transform->scale_y = (float)pre_proc_info->img_height / pre_proc_info->resized_img_height;
+    box_transform->pad_left = (float)pre_proc_info->pad_left;
+    box_transform->pad_top = (float)pre_proc_info->pad_top;
+    box_transform->origin_x = 0;
+    box_transform->origin_y = 0;
+    box_transform->min_x = 0;
+    box_transform->min_y = 0;
+    box_transform->max_x = (int)pre_proc_info->img_width - 1;
+    box_transform->max_y = (int)pre_proc_info->img_height - 1;
+}
 
-    int good_box_count = 0;
-    int good_result_count = 0;
+/*
+ * map a box in model input to the pre-processed image, the operations are those of the former separate scaling pass after NMS,
+ * the origin is added to the rounded output box so that NMS sees the same coordinates for any origin
+ */
+static inline void box_transform_map(const post_process_box_transform_t *box_transform, kp_bounding_box_t *box)
+{
+    float w = (box->x2 - box->x1) * box_transform->scale_x;
+    float h = (box->y2 - box->y1) * box_transform->scale_y;
 
-    box_class_probs = (float *)malloc(class_count * sizeof(float));
-    if (NULL == box_class_probs) {
-        printf("error! malloc %s temp space failed\n", "box class probs");
-        goto err;
-    }
+    box->x1 = (box->x1 - box_transform->pad_left) * box_transform->scale_x;
+    box->y1 = (box->y1 - box_transform->pad_top) * box_transform->scale_y;
+    box->x2 = box->x1 + w;
+    box->y2 = box->y1 + h;
+}
 
-    possible_boxes = (kp_bounding_box_t *)malloc(MAX_POSSIBLE_BOXES * sizeof(kp_bounding_box_t));
-    if (NULL == possible_boxes){
-        printf("error! malloc %s temp space failed\n", "possible_boxes");
-        goto err;
-    }
-    temp_boxes = (kp_bounding_box_t *)malloc(MAX_POSSIBLE_BOXES * sizeof(kp_bounding_box_t));
-    if (NULL == temp_boxes){
-        printf("error! malloc %s temp space failed\n", "temp_boxes");
-        goto err;
-    }
+/* write a mapped box to the result in integer pixels moved by the origin, limit Rectangle */
+static inline void box_transform_output(const post_process_box_transform_t *box_transform, kp_bounding_box_t *dst, kp_bounding_box_t *src)
+{
+    int x1 = (int)(src->x1 + 0.5) + box_transform->origin_x;
+    int y1 = (int)(src->y1 + 0.5) + box_transform->origin_y;
+    int x2 = (int)(src->x2 + 0.5) + box_transform->origin_x;
+    int y2 = (int)(src->y2 + 0.5) + box_transform->origin_y;
+
+    dst->x1 = (x1 > box_transform->min_x) ? x1 : box_transform->min_x;
+    dst->y1 = (y1 > box_transform->min_y) ? y1 : box_transform->min_y;
+    dst->x2 = (x2 < box_transform->max_x) ? x2 : box_transform->max_x;
+    dst->y2 = (y2 < box_transform->max_y) ? y2 : box_transform->max_y;
+    dst->score = src->score;
+    dst->class_num = src->class_num;
+}
 
-    for (int i = 0; i < num_output_node; i++)
+static int prepare_yolo_context(post_process_yolo_context_t *context, int class_count, int candidate_capacity)
+{
+    if (class_count > context->class_count)
     {
-        int grid_w = node_output[i]->shape[3];
-        int grid_h = node_output[i]->shape[2];
-        int grid_c = node_output[i]->shape[1];
+        int *class_box_offset = (int *)realloc(context->class_box_offset, (class_count + 1) * sizeof(int));
+        if (NULL == class_box_offset)
+            return -1;
+        context->class_box_offset = class_box_offset;
 
-        int width_size = grid_w * grid_c;
-        int anchor_offset = width_size / 3;
+        float *box_class_probs = (float *)realloc(context->box_class_probs, class_count * sizeof(float));
+        if (NULL == box_class_probs)
+            return -1;
+        context->box_class_probs = box_class_probs;
 
-        float ratio_w = (float)pre_proc_info->model_input_width / grid_w;
-        float ratio_h = (float)pre_proc_info->model_input_height / grid_h;
+        context->class_count = class_count;
+    }
 
-        for (int row = 0; row < grid_h; row++)
-        {
-            for (int an = 0; an < YOLO_V3_CELL_BOX_NUM; an++)
-            {
-                float *data = node_output[i]->data + row * width_size + an * anchor_offset;
+    if (candidate_capacity > context->candidate_capacity)
+    {
+        kp_bounding_box_t *candidate_boxes = (kp_bounding_box_t *)realloc(context->candidate_boxes, candidate_capacity * sizeof(kp_bounding_box_t));
+        if (NULL == candidate_boxes)
+            return -1;
+        context->candidate_boxes = candidate_boxes;
+
+        kp_bounding_box_t *class_boxes = (kp_bounding_box_t *)realloc(context->class_boxes, candidate_capacity * sizeof(kp_bounding_box_t));
+        if (NULL == class_boxes)
+            return -1;
+        context->class_boxes = class_boxes;
+
+        float *box_soa = (float *)realloc(context->box_soa, NMS_SOA_NUM * candidate_capacity * sizeof(float));
+        if (NULL == box_soa)
+            return -1;
+        context->box_soa = box_soa;
+
+        context->candidate_capacity = candidate_capacity;
+    }
 
-                float *x_p = data;
-                float *y_p = x_p + grid_w;
-                float *width_p = y_p + grid_w;
-                float *height_p = width_p + grid_w;
-                float *score_p = height_p + grid_w;
-                float *class_p = score_p + grid_w;
+    return 0;
+}
 
-                for (int col = 0; col < grid_w; col++)
-                {
-                    float box_x = *(x_p + col);
-                    float box_y = *(y_p + col);
-                    float box_w = *(width_p + col);
-                    float box_h = *(height_p + col);
-                    float box_confidence = sigmoid(*(score_p + col));
+static int prepare_yolo_cell_buffer(post_process_yolo_context_t *context, int cell_capacity)
+{
+    if (cell_capacity > context->cell_capacity)
+    {
+        int *cell_index = (int *)realloc(context->cell_index, cell_capacity * sizeof(int));
+        if (NULL == cell_index)
+            return -1;
+        context->cell_index = cell_index;
+
+        float *cell_confidence = (float *)realloc(context->cell_confidence, cell_capacity * sizeof(float));
+        if (NULL == cell_confidence)
+            return -1;
+        context->cell_confidence = cell_confidence;
+
+        kp_bounding_box_t *cell_boxes = (kp_bounding_box_t *)realloc(context->cell_boxes, cell_capacity * sizeof(kp_bounding_box_t));
+        if (NULL == cell_boxes)
+            return -1;
+        context->cell_boxes = cell_boxes;
+
+        bool *cell_decoded = (bool *)realloc(context->cell_decoded, cell_capacity * sizeof(bool));
+        if (NULL == cell_decoded)
+            return -1;
+        context->cell_decoded = cell_decoded;
+
+        context->cell_capacity = cell_capacity;
+    }
 
-                    float x1, y1, x2, y2;
-                    bool first_box = false;
+    return 0;
+}
 
-                    for (int j = 0; j < class_count; j++)
-                    {
-                        box_class_probs[j] = (float)*(class_p + col + j * grid_w);
-                    }
+/* bucket candidates by class in one pass, then sort and suppress only the non-empty classes in class order */
+static int yolo_class_bucket_nms(post_process_yolo_context_t *context, int class_count, int candidate_count, double nms_thresh, int max_detection_per_class,
+                                 const post_process_box_transform_t *box_transform, kp_yolo_result_t *yoloResult)
+{
+    int *class_box_offset = context->class_box_offset;
+    int good_result_count = 0;
 
-                    /* Get scores of all class */
-                    for (int j = 0; j < class_count; j++)
-                    {
-                        float max_score = sigmoid(box_class_probs[j]) * box_confidence;
-                        if (max_score >= thresh_value)
-                        {
-                            if (!first_box)
-                            {
-                                first_box = true;
-
-                                box_x = sigmoid(box_x);
-                                box_y = sigmoid(box_y);
-                                box_w = sigmoid(box_w);
-                                box_h = sigmoid(box_h);
-
-                                box_x = ((box_x * 2 - 0.5f + col) * ratio_w);
-                                box_y = ((box_y * 2 - 0.5f + row) * ratio_h);
-                                box_w *= 2;
-                                box_h *= 2;
-                                box_w = box_w * box_w * yolo_v5_anchers[i][an][0];
-                                box_h = box_h * box_h * yolo_v5_anchers[i][an][1];
-
-                                x1 = (box_x - (box_w / 2));
-                                y1 = (box_y - (box_h / 2));
-                                x2 = (box_x + (box_w / 2));
-                                y2 = (box_y + (box_h / 2));
-                            }
-
-                            possible_boxes[good_box_count].x1 = x1;
-                            possible_boxes[good_box_count].y1 = y1;
-                            possible_boxes[good_box_count].x2 = x2;
-                            possible_boxes[good_box_count].y2 = y2;
-                            possible_boxes[good_box_count].score = max_score;
-                            possible_boxes[good_box_count].class_num = j;
-                            good_box_count++;
-
-                            if (good_box_count >= MAX_POSSIBLE_BOXES)
-                            {
-                                printf("post yolo v5: error ! aborted due to too many boxes\n");
-                                goto err;
-                            }
-                        }
-                    }
-                }
-            }
-        }
+    // global pre-NMS cap, the best candidates of all classes
+    if ((0 < context->pre_nms_top_k) && (candidate_count > context->pre_nms_top_k))
+    {
+        box_select_top(context->candidate_boxes, candidate_count, context->pre_nms_top_k, box_class_comparator);
+        candidate_count = context->pre_nms_top_k;
     }
 
+    memset(class_box_offset, 0, (class_count + 1) * sizeof(int));
+
+    for (int i = 0; i < candidate_count; i++)
+        class_box_offset[context->candidate_boxes[i].class_num + 1]++;
+
     for (int i = 0; i < class_count; i++)
+        class_box_offset[i + 1] += class_box_offset[i];
+
+    // stable scatter, boxes of one class keep their decoding order
+    for (int i = 0; i < candidate_count; i++)
     {
-        kp_bounding_box_t *bbox = possible_boxes;
-        kp_bounding_box_t *r_tmp_p = temp_boxes;
+        kp_bounding_box_t *bbox = &context->candidate_boxes[i];
+        memcpy(&context->class_boxes[class_box_offset[bbox->class_num]++], bbox, sizeof(kp_bounding_box_t));
+    }
 
-        int class_good_box_count = 0;
+    // after scattering, class_box_offset[i] is the end of class i
+    for (int i = 0; i < class_count; i++)
+    {
+        int class_begin = (0 == i) ? 0 : class_box_offset[i - 1];
+        int class_good_box_count = class_box_offset[i] - class_begin;
+        kp_bounding_box_t *temp_boxes = &context->class_boxes[class_begin];
 
-        for (int j = 0; j < good_box_count; j++)
+        // per-class pre-NMS cap
+        if ((0 < context->pre_nms_top_k_per_class) && (class_good_box_count > context->pre_nms_top_k_per_class))
         {
-            if (bbox->class_num == i)
-            {
-                memcpy(r_tmp_p, bbox, sizeof(kp_bounding_box_t));
-                r_tmp_p++;
-                class_good_box_count++;
-            }
-            bbox++;
+            box_select_top(temp_boxes, class_good_box_count, context->pre_nms_top_k_per_class, box_comparator);
+            class_good_box_count = context->pre_nms_top_k_per_class;
         }
 
         if (class_good_box_count == 1)
         {
             if (good_result_count < YOLO_GOOD_BOX_MAX)
             {
-                memcpy(&(yoloResult->boxes[good_result_count]), &temp_boxes[0], sizeof(kp_bounding_box_t));
+                box_transform_output(box_transform, &(yoloResult->boxes[good_result_count]), &temp_boxes[0]);
                 good_result_count++;
             }
         }
         else if (class_good_box_count >= 2)
         {
-            qsort(temp_boxes, class_good_box_count, sizeof(kp_bounding_box_t), box_comparator);
-            for (int j = 0; j < class_good_box_count; j++)
-            {
-                if (temp_boxes[j].score == 0)
-                    continue;
-                for (int k = j + 1; k < class_good_box_count; k++)
-                {
-                    if (box_iou(&temp_boxes[j], &temp_boxes[k], IOU_UNION) > NMS_THRESH_YOLOV3_520)
-                    {
-                        temp_boxes[k].score = 0;
-                    }
-                }
-            }
+            float *soa[NMS_SOA_NUM];
+            for (int j = 0; j < NMS_SOA_NUM; j++)
+                soa[j] = &context->box_soa[j * class_good_box_count];
+
+            // boxes after the last one which can be output are neither sorted nor suppressed
+            int keep_limit = YOLO_GOOD_BOX_MAX - good_result_count;
+            if ((0 < max_detection_per_class) && (keep_limit > max_detection_per_class))
+                keep_limit = max_detection_per_class;
+
+            int nms_box_count = nms_partial_sort_suppress(temp_boxes, class_good_box_count, soa, IOU_UNION, nms_thresh, keep_limit);
 
             int good_count = 0;
-            for (int j = 0; j < class_good_box_count; j++)
+            for (int j = 0; j < nms_box_count; j++)
             {
                 if (temp_boxes[j].score > 0 && good_result_count < YOLO_GOOD_BOX_MAX)
                 {
-                    memcpy(&(yoloResult->boxes[good_result_count]), &temp_boxes[j], sizeof(kp_bounding_box_t));
+                    box_transform_output(box_transform, &(yoloResult->boxes[good_result_count]), &temp_boxes[j]);
                     good_result_count++;
                     good_count++;
                 }
-                if (YOLO_MAX_DETECTION_PER_CLASS == good_count)
+                if (max_detection_per_class == good_count)
                 {
                     break;
                 }
@@ -555,252 +701,1737 @@ int post_process_yolo_v5_520(kp_inf_float_node_output_t *node_output[], int num_
             break;
     }
 
-    yoloResult->box_count = good_result_count;
-    yoloResult->class_count = class_count;
-
-    // convert the coordinate of all bounding boxes to raw image
-    boxes_scale(yoloResult->boxes, yoloResult->box_count, pre_proc_info);
+    return good_result_count;
+}
 
-    free(box_class_probs);
-    free(possible_boxes);
-    free(temp_boxes);
+post_process_yolo_context_t *post_process_yolo_create_context(void)
+{
+    post_process_yolo_context_t *context = (post_process_yolo_context_t *)calloc(1, sizeof(post_process_yolo_context_t));
+    if (NULL == context)
+        printf("Error! %s(): malloc memory for context failed\n", __FUNCTION__);
 
-    return 0;
+    return context;
+}
 
-err:
-    free(box_class_probs);
-    free(possible_boxes);
-    free(temp_boxes);
+void post_process_yolo_release_context(post_process_yolo_context_t *context)
+{
+    if (NULL == context)
+        return;
 
-    return -1;
+    for (int i = 0; i < context->node_lut_count; i++)
+    {
+        free(context->node_luts[i].sigmoid_table);
+        free(context->node_luts[i].exp_table);
+    }
+    free(context->node_luts);
+
+    free(context->class_box_offset);
+    free(context->box_class_probs);
+    free(context->candidate_boxes);
+    free(context->class_boxes);
+    free(context->box_soa);
+    free(context->cell_index);
+    free(context->cell_confidence);
+    free(context->cell_boxes);
+    free(context->cell_decoded);
+    free(context);
 }
 
-// Use to record candidate bounding box properties of each class
-typedef struct candidate_boxes
+void post_process_yolo_set_pre_nms_top_k(post_process_yolo_context_t *context, int top_k_per_class, int top_k)
 {
-    int boxes_count;
-    float *boxes; // size should be maximum number of possible bounding boxes
-    float **scores; // size should be yolo_v5 class number * maximum number of possible bounding boxes
-} candidate_boxes;
+    if (NULL == context)
+        return;
 
-int post_process_yolo_v5_720(kp_inf_float_node_output_t *node_output[], int num_output_node,
-                             kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+    context->pre_nms_top_k_per_class = (0 < top_k_per_class) ? top_k_per_class : 0;
+    context->pre_nms_top_k = (0 < top_k) ? top_k : 0;
+}
+
+int post_process_yolo_set_node_quantization(post_process_yolo_context_t *context, int node_idx, kp_inf_node_view_t *node_view)
 {
-    int class_count = (node_output[0]->shape[1] / YOLO_V3_CELL_BOX_NUM) - YOLO_V3_BOX_FIX_CH;
-    int offset = 0;
-    float *updated_boxes = NULL;
-    kp_bounding_box_t *temp_boxes = NULL;
-    int good_result_count = 0;
-    candidate_boxes cand_boxes = {0};
-    cand_boxes.boxes_count = 0;
+    post_process_node_lut_t *lut = NULL;
+    int32_t fixed_point_min = 0;
+    int32_t fixed_point_max = 0;
+    int table_size = 0;
 
-    updated_boxes = (float *)malloc(node_output[0]->shape[3] * node_output[0]->shape[2] * 4 * sizeof(float));
-    if (NULL == updated_boxes){
-        printf("error! malloc failed\n");
-        goto err;
+    if ((NULL == context) || (NULL == node_view) || (0 > node_idx))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
     }
 
-    for (int i = 0; i < num_output_node; i++)
-        cand_boxes.boxes_count += node_output[i]->shape[3] * node_output[i]->shape[2] * 3;
+    if (node_idx >= context->node_lut_count)
+    {
+        post_process_node_lut_t *node_luts = (post_process_node_lut_t *)realloc(context->node_luts, (node_idx + 1) * sizeof(post_process_node_lut_t));
+        if (NULL == node_luts)
+        {
+            printf("Error! %s(): malloc memory for node lookup tables failed\n", __FUNCTION__);
+            return -1;
+        }
 
-    cand_boxes.boxes = (float *)malloc(cand_boxes.boxes_count * 4 * sizeof(float)); // 4 means (x1, y1, x2, y2)
-    if(NULL == cand_boxes.boxes) {
-        printf("error! malloc failed\n");
-        goto err;
-    }
-    cand_boxes.scores = (float **)malloc(class_count * sizeof(float *));
-    if(NULL == cand_boxes.scores) {
-        printf("error! malloc failed\n");
-        goto err;
+        memset(&node_luts[context->node_lut_count], 0, (node_idx + 1 - context->node_lut_count) * sizeof(post_process_node_lut_t));
+        context->node_luts = node_luts;
+        context->node_lut_count = node_idx + 1;
     }
 
-    for (int i = 0; i < class_count; i++) {
-        cand_boxes.scores[i] = (float*)malloc(cand_boxes.boxes_count * sizeof(float));
-        if(NULL == cand_boxes.scores[i]) {
-            printf("error! malloc failed\n");
-            goto err;
-        }
+    lut = &context->node_luts[node_idx];
+
+    if (KP_FIXED_POINT_DTYPE_INT8 == node_view->fixed_point_dtype)
+    {
+        fixed_point_min = INT8_MIN;
+        fixed_point_max = INT8_MAX;
+    }
+    else if (KP_FIXED_POINT_DTYPE_INT16 == node_view->fixed_point_dtype)
+    {
+        fixed_point_min = INT16_MIN;
+        fixed_point_max = INT16_MAX;
     }
 
-    for (int i = 0; i < num_output_node; i++)
+    // channel-wise quantized nodes are not tabulated
+    if ((0 == fixed_point_max) || (0 != node_view->quantized_axis_stride) || (0 == node_view->quantization_factor))
     {
-        int ratio_w = pre_proc_info->model_input_width / node_output[i]->shape[3];
-        int ratio_h = pre_proc_info->model_input_height / node_output[i]->shape[2];
-        int nrows = node_output[i]->shape[2];
-        int ncols = node_output[i]->shape[3];
-        int nchs = node_output[i]->shape[1];
-
-        // following comments are from kdp
-        // node 0 : 1 x 255 x 80 x 80, reshape to 1 x 3 x 85 x 80 x 80, transpose to 1 x 3 x 80 x 80 x 85
-        // node 1 : 1 x 255 x 40 x 40, reshape to 1 x 3 x 85 x 40 x 40, transpose to 1 x 3 x 40 x 40 x 85
-        // node 2 : 1 x 255 x 20 x 20, reshape to 1 x 3 x 85 x 20 x 20, transpose to 1 x 3 x 20 x 20 x 85
-        int stride1 = (nchs / YOLO_V3_CELL_BOX_NUM) * nrows * ncols;
-        int stride2 = nrows * ncols;
-        int stride3 = ncols;
-
-        // scan scores -> divide to 3 (YOLO_V3_CELL_BOX_NUM) hunks of data
-        for (int k = 0; k < YOLO_V3_CELL_BOX_NUM; k++)
-        {
-            // update anchor
-            for (int row = 0; row < nrows; row++)
-            {
-                for (int col = 0; col < ncols; col++)
-                {
-                    float *boxes = &node_output[i]->data[k * stride1];
-
-                    int index = row * stride3 + col;
-                    float box_x = boxes[index + 0 * stride2];
-                    float box_y = boxes[index + 1 * stride2];
-                    float box_w = boxes[index + 2 * stride2];
-                    float box_h = boxes[index + 3 * stride2];
-                    float grid_x = (float)col;
-                    float grid_y = (float)row;
-
-                    box_w = (box_w * box_w);
-                    box_h = (box_h * box_h);
-                    float _x = (box_x * 2 - 0.5 + grid_x) * ratio_w;
-                    float _y = (box_y * 2 - 0.5 + grid_y) * ratio_h;
-                    float _w = box_w * 4 * yolo_v5_anchers[i][k][0];
-                    float _h = box_h * 4 * yolo_v5_anchers[i][k][1];
-                    float xleft = (_x - _w / 2);
-                    float yleft = (_y - _h / 2);
-
-                    updated_boxes[4 * index + 0] = xleft;
-                    updated_boxes[4 * index + 1] = yleft;
-                    updated_boxes[4 * index + 2] = xleft + _w;
-                    updated_boxes[4 * index + 3] = yleft + _h;
-                }
-            }
+        lut->fixed_point_dtype = KP_FIXED_POINT_DTYPE_UNKNOWN;
+        return 0;
+    }
 
-            // Collect all boxes candidates from 3 nodes and put them in a 1D long array
-            memcpy(&cand_boxes.boxes[(offset + k * nrows * ncols) * 4], updated_boxes, 4 * nrows * ncols * sizeof(float));
+    if ((lut->fixed_point_dtype == node_view->fixed_point_dtype) && (lut->quantization_factor == node_view->quantization_factor))
+        return 0;
 
-            // Find probability of each bounding box
-            float *box_prob = &node_output[i]->data[k * stride1 + 4 * stride2];
+    lut->fixed_point_dtype = KP_FIXED_POINT_DTYPE_UNKNOWN;
+    table_size = fixed_point_max - fixed_point_min + 1;
 
-            // Find probability of each class
-            for (int c = YOLO_V3_BOX_FIX_CH; c < nchs / YOLO_V3_CELL_BOX_NUM; c++)
-            {
-                float *class_prob = &node_output[i]->data[k * stride1 + c * stride2];
-                int count = 0;
-                for (int row = 0; row < nrows; row++)
-                {
-                    for (int col = 0; col < ncols; col++)
-                    {
-                        // Find score by multiplying probability of each bounding box and that of each class
-                        cand_boxes.scores[c - YOLO_V3_BOX_FIX_CH][offset + k * nrows * ncols + count] = box_prob[row * ncols + col] * class_prob[row * ncols + col];
-                        count++;
-                    }
-                }
-            }
-        }
-        offset += (YOLO_V3_CELL_BOX_NUM * nrows * ncols);
+    float *sigmoid_table = (float *)realloc(lut->sigmoid_table, table_size * sizeof(float));
+    if (NULL == sigmoid_table)
+    {
+        printf("Error! %s(): malloc memory for sigmoid table failed\n", __FUNCTION__);
+        return -1;
     }
+    lut->sigmoid_table = sigmoid_table;
 
-    temp_boxes = (kp_bounding_box_t *)malloc(cand_boxes.boxes_count * sizeof(kp_bounding_box_t));
-    if (NULL == temp_boxes) {
-        printf("error! malloc temp working buffer failed\n");
-        goto err;
+    double *exp_table = (double *)realloc(lut->exp_table, table_size * sizeof(double));
+    if (NULL == exp_table)
+    {
+        printf("Error! %s(): malloc memory for exp table failed\n", __FUNCTION__);
+        return -1;
     }
+    lut->exp_table = exp_table;
 
-    for (int i = 0; i < class_count; i++)
+    for (int i = 0; i < table_size; i++)
     {
-        kp_bounding_box_t *r_tmp_p = temp_boxes;
+        float value = (float)(fixed_point_min + i) / node_view->quantization_factor;
 
-        int class_good_box_count = 0;
-
-        for (int box_idx = 0; box_idx < cand_boxes.boxes_count; box_idx++)
-        {
-            if (cand_boxes.scores[i][box_idx] > thresh_value)
-            {
-                memcpy(r_tmp_p, cand_boxes.boxes + 4 * box_idx, 4 * sizeof(float)); // copy (x1, y1, x2, y2) //-V::512
-                r_tmp_p->class_num = i;
-                r_tmp_p->score = cand_boxes.scores[i][box_idx];
+        sigmoid_table[i] = sigmoid(value);
+        exp_table[i] = exp(value);
+    }
 
-                r_tmp_p++;
-                class_good_box_count++;
-            }
-        }
+    lut->quantization_factor = node_view->quantization_factor;
+    lut->fixed_point_min = fixed_point_min;
+    lut->fixed_point_max = fixed_point_max;
+    lut->fixed_point_dtype = node_view->fixed_point_dtype;
 
-        if (class_good_box_count == 1)
+    return 0;
+}
+
+static const post_process_yolo_descriptor_t yolo_v3_descriptor = {
+    .head_count = 3,
+    .heads = {
+        {.anchor_count = 3, .anchors = {{81, 82}, {135, 169}, {344, 319}}},
+        {.anchor_count = 3, .anchors = {{23, 27}, {37, 58}, {81, 82}}},
+        {.anchor_count = 3, .anchors = {{0, 0}, {0, 0}, {0, 0}}}},
+    .channel_ordering = KP_CHANNEL_ORDERING_HCW,
+    .box_encoding = POST_PROCESS_YOLO_BOX_V3,
+    .xy_activation = POST_PROCESS_ACTIVATION_SIGMOID,
+    .wh_activation = POST_PROCESS_ACTIVATION_EXP,
+    .objectness_activation = POST_PROCESS_ACTIVATION_SIGMOID,
+    .class_activation = POST_PROCESS_ACTIVATION_SIGMOID,
+    .score_threshold_exclusive = false,
+    .max_candidate_count = MAX_POSSIBLE_BOXES,
+    .nms_thresh = NMS_THRESH_YOLOV3_520,
+    .max_detection_per_class = YOLO_MAX_DETECTION_PER_CLASS,
+};
+
+static const post_process_yolo_descriptor_t yolo_v5_520_descriptor = {
+    .head_count = 3,
+    .heads = {
+        {.anchor_count = 3, .anchors = {{10, 13}, {16, 30}, {33, 23}}},
+        {.anchor_count = 3, .anchors = {{30, 61}, {62, 45}, {59, 119}}},
+        {.anchor_count = 3, .anchors = {{116, 90}, {156, 198}, {373, 326}}}},
+    .channel_ordering = KP_CHANNEL_ORDERING_HCW,
+    .box_encoding = POST_PROCESS_YOLO_BOX_V5,
+    .xy_activation = POST_PROCESS_ACTIVATION_SIGMOID,
+    .wh_activation = POST_PROCESS_ACTIVATION_SIGMOID,
+    .objectness_activation = POST_PROCESS_ACTIVATION_SIGMOID,
+    .class_activation = POST_PROCESS_ACTIVATION_SIGMOID,
+    .score_threshold_exclusive = false,
+    .max_candidate_count = MAX_POSSIBLE_BOXES,
+    .nms_thresh = NMS_THRESH_YOLOV3_520,
+    .max_detection_per_class = YOLO_MAX_DETECTION_PER_CLASS,
+};
+
+static const post_process_yolo_descriptor_t yolo_v5_720_descriptor = {
+    .head_count = 3,
+    .heads = {
+        {.anchor_count = 3, .anchors = {{10, 13}, {16, 30}, {33, 23}}},
+        {.anchor_count = 3, .anchors = {{30, 61}, {62, 45}, {59, 119}}},
+        {.anchor_count = 3, .anchors = {{116, 90}, {156, 198}, {373, 326}}}},
+    .channel_ordering = KP_CHANNEL_ORDERING_CHW,
+    .box_encoding = POST_PROCESS_YOLO_BOX_V5_LEFT_TOP,
+    .xy_activation = POST_PROCESS_ACTIVATION_NONE,
+    .wh_activation = POST_PROCESS_ACTIVATION_NONE,
+    .objectness_activation = POST_PROCESS_ACTIVATION_NONE,
+    .class_activation = POST_PROCESS_ACTIVATION_NONE,
+    .score_threshold_exclusive = true,
+    .max_candidate_count = 0,
+    .nms_thresh = NMS_THRESH_YOLOV5_720,
+    .max_detection_per_class = YOLO_MAX_DETECTION_PER_CLASS,
+};
+
+const post_process_yolo_descriptor_t *post_process_yolo_builtin_descriptor(post_process_yolo_type_t type)
+{
+    switch (type)
+    {
+    case POST_PROCESS_YOLO_V3:
+        return &yolo_v3_descriptor;
+    case POST_PROCESS_YOLO_V5_520:
+        return &yolo_v5_520_descriptor;
+    case POST_PROCESS_YOLO_V5_720:
+        return &yolo_v5_720_descriptor;
+    default:
+        return NULL;
+    }
+}
+
+/* activation of one value of a node, sigmoid and exp are read from the node lookup tables if they are set */
+static inline double yolo_activation(uint32_t activation, post_process_node_lut_t *lut, float x)
+{
+    switch (activation)
+    {
+    case POST_PROCESS_ACTIVATION_SIGMOID:
+        return node_lut_sigmoid(lut, x);
+    case POST_PROCESS_ACTIVATION_EXP:
+        return node_lut_exp(lut, x);
+    default:
+        return x;
+    }
+}
+
+/* decoding parameters of one anchor of one head */
+typedef struct
+{
+    const post_process_yolo_descriptor_t *descriptor;
+    const post_process_box_transform_t *box_transform;
+    post_process_node_lut_t *lut;
+    const float *anchor;
+    int channel_stride;         // data access stride of channels
+    int col_stride;             // data access stride of cells in a segment
+    int grid_w;
+    float ratio_w;
+    float ratio_h;
+    int int_ratio_w;
+    int int_ratio_h;
+} yolo_anchor_decoder_t;
+
+/* (x1, y1, x2, y2) of one anchor box in image, 'data' points to its x */
+static void yolo_decode_box(yolo_anchor_decoder_t *decoder, float *data, int col, int row, kp_bounding_box_t *box)
+{
+    const post_process_yolo_descriptor_t *descriptor = decoder->descriptor;
+    post_process_node_lut_t *lut = decoder->lut;
+    const float *anchor = decoder->anchor;
+    float box_x = data[0];
+    float box_y = data[decoder->channel_stride];
+    float box_w = data[2 * decoder->channel_stride];
+    float box_h = data[3 * decoder->channel_stride];
+
+    switch (descriptor->box_encoding)
+    {
+    case POST_PROCESS_YOLO_BOX_V5:
+    {
+        box_x = (float)yolo_activation(descriptor->xy_activation, lut, box_x);
+        box_y = (float)yolo_activation(descriptor->xy_activation, lut, box_y);
+        box_w = (float)yolo_activation(descriptor->wh_activation, lut, box_w);
+        box_h = (float)yolo_activation(descriptor->wh_activation, lut, box_h);
+
+        box_x = ((box_x * 2 - 0.5f + col) * decoder->ratio_w);
+        box_y = ((box_y * 2 - 0.5f + row) * decoder->ratio_h);
+        box_w *= 2;
+        box_h *= 2;
+        box_w = box_w * box_w * anchor[0];
+        box_h = box_h * box_h * anchor[1];
+
+        box->x1 = (box_x - (box_w / 2));
+        box->y1 = (box_y - (box_h / 2));
+        box->x2 = (box_x + (box_w / 2));
+        box->y2 = (box_y + (box_h / 2));
+        break;
+    }
+    case POST_PROCESS_YOLO_BOX_V5_LEFT_TOP:
+    {
+        box_x = (float)yolo_activation(descriptor->xy_activation, lut, box_x);
+        box_y = (float)yolo_activation(descriptor->xy_activation, lut, box_y);
+        box_w = (float)yolo_activation(descriptor->wh_activation, lut, box_w);
+        box_h = (float)yolo_activation(descriptor->wh_activation, lut, box_h);
+
+        box_w = (box_w * box_w);
+        box_h = (box_h * box_h);
+        float _x = (box_x * 2 - 0.5 + (float)col) * decoder->int_ratio_w;
+        float _y = (box_y * 2 - 0.5 + (float)row) * decoder->int_ratio_h;
+        float _w = box_w * 4 * anchor[0];
+        float _h = box_h * 4 * anchor[1];
+        float xleft = (_x - _w / 2);
+        float yleft = (_y - _h / 2);
+
+        box->x1 = xleft;
+        box->y1 = yleft;
+        box->x2 = xleft + _w;
+        box->y2 = yleft + _h;
+        break;
+    }
+    default:
+    {
+        box_x = ((float)yolo_activation(descriptor->xy_activation, lut, box_x) + col) * decoder->ratio_w;
+        box_y = ((float)yolo_activation(descriptor->xy_activation, lut, box_y) + row) * decoder->ratio_h;
+        box_w = yolo_activation(descriptor->wh_activation, lut, box_w) * anchor[0];
+        box_h = yolo_activation(descriptor->wh_activation, lut, box_h) * anchor[1];
+
+        box->x1 = box_x - (box_w / 2);
+        box->y1 = box_y - (box_h / 2);
+        box->x2 = box_x + (box_w / 2);
+        box->y2 = box_y + (box_h / 2);
+        break;
+    }
+    }
+
+    box_transform_map(decoder->box_transform, box);
+}
+
+/* append the box of cell 'cell' in a segment starting at 'row' as a candidate, the box is decoded once and kept in 'cell_box' for other classes */
+static int yolo_add_candidate(post_process_yolo_context_t *context, yolo_anchor_decoder_t *decoder, int class_count, int *candidate_count,
+                              float *segment, int row, int cell, kp_bounding_box_t *cell_box, bool *cell_decoded, float score, int class_num)
+{
+    if ((*candidate_count >= context->candidate_capacity) &&
+        (0 != prepare_yolo_context(context, class_count, context->candidate_capacity * 2)))
+    {
+        printf("Error! %s(): malloc memory for candidates failed\n", __FUNCTION__);
+        return -1;
+    }
+
+    kp_bounding_box_t *candidate = &context->candidate_boxes[*candidate_count];
+
+    if (!*cell_decoded)
+    {
+        yolo_decode_box(decoder, segment + cell * decoder->col_stride, cell % decoder->grid_w, row + cell / decoder->grid_w, cell_box);
+        *cell_decoded = true;
+    }
+
+    candidate->x1 = cell_box->x1;
+    candidate->y1 = cell_box->y1;
+    candidate->x2 = cell_box->x2;
+    candidate->y2 = cell_box->y2;
+    candidate->score = score;
+    candidate->class_num = class_num;
+    (*candidate_count)++;
+
+    if ((0 < decoder->descriptor->max_candidate_count) && (*candidate_count >= decoder->descriptor->max_candidate_count))
+    {
+        printf("Error! %s(): aborted due to too many boxes\n", __FUNCTION__);
+        return -1;
+    }
+
+    return 0;
+}
+
+int post_process_yolo_generic_with_context(post_process_yolo_context_t *context, const post_process_yolo_descriptor_t *descriptor,
+                                           kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                           kp_hw_pre_proc_info_t *pre_proc_info, const post_process_box_transform_t *box_transform,
+                                           float thresh_value, kp_yolo_result_t *yoloResult)
+{
+    post_process_box_transform_t pre_proc_box_transform;
+    int class_count = 0;
+    int candidate_capacity = 0;
+    int good_box_count = 0;
+    int good_result_count = 0;
+    float min_score = thresh_value;
+    uint32_t objectness_activation = POST_PROCESS_ACTIVATION_NONE;
+    uint32_t class_activation = POST_PROCESS_ACTIVATION_NONE;
+
+    if ((NULL == context) || (NULL == descriptor) || (NULL == node_output) || (0 >= num_output_node) || (num_output_node > descriptor->head_count) ||
+        (0 >= descriptor->heads[0].anchor_count))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    // boxes are mapped to image coordinates as they are decoded, so NMS and output need no separate scaling pass
+    if (NULL == box_transform)
+    {
+        post_process_box_transform_init(&pre_proc_box_transform, pre_proc_info);
+        box_transform = &pre_proc_box_transform;
+    }
+
+    // 'score > thresh_value' is the same as 'score >= min_score'
+    if (descriptor->score_threshold_exclusive)
+        min_score = nextafterf(thresh_value, INFINITY);
+
+    objectness_activation = descriptor->objectness_activation;
+    class_activation = descriptor->class_activation;
+    class_count = (node_output[0]->shape[1] / descriptor->heads[0].anchor_count) - YOLO_V3_BOX_FIX_CH;
+    candidate_capacity = (0 < descriptor->max_candidate_count) ? descriptor->max_candidate_count : MAX_POSSIBLE_BOXES;
+    if (candidate_capacity < context->candidate_capacity)
+        candidate_capacity = context->candidate_capacity;
+
+    if ((0 >= class_count) || (0 != prepare_yolo_context(context, class_count, candidate_capacity)))
+    {
+        printf("Error! %s(): malloc memory for context failed\n", __FUNCTION__);
+        return -1;
+    }
+
+    for (int i = 0; i < num_output_node; i++)
+    {
+        const post_process_yolo_head_t *head = &descriptor->heads[i];
+        yolo_anchor_decoder_t decoder;
+
+        int grid_c = node_output[i]->shape[1];
+        int grid_h = node_output[i]->shape[2];
+        int grid_w = node_output[i]->shape[3];
+        int box_ch = grid_c / head->anchor_count;
+        int node_class_count = box_ch - YOLO_V3_BOX_FIX_CH;
+        int row_stride = 0;
+
+        if (node_class_count > class_count)
+            node_class_count = class_count;
+
+        decoder.descriptor = descriptor;
+        decoder.box_transform = box_transform;
+        decoder.lut = yolo_node_lut(context, i);
+        decoder.grid_w = grid_w;
+        decoder.ratio_w = (0 < head->stride) ? head->stride : (float)pre_proc_info->model_input_width / grid_w;
+        decoder.ratio_h = (0 < head->stride) ? head->stride : (float)pre_proc_info->model_input_height / grid_h;
+        decoder.int_ratio_w = (0 < head->stride) ? (int)head->stride : pre_proc_info->model_input_width / grid_w;
+        decoder.int_ratio_h = (0 < head->stride) ? (int)head->stride : pre_proc_info->model_input_height / grid_h;
+
+        switch (descriptor->channel_ordering)
         {
-            if (good_result_count < YOLO_GOOD_BOX_MAX)
-            {
-                memcpy(&(yoloResult->boxes[good_result_count]), &temp_boxes[0], sizeof(kp_bounding_box_t));
-                good_result_count++;
-            }
+        case KP_CHANNEL_ORDERING_HCW:
+            decoder.channel_stride = grid_w;
+            decoder.col_stride = 1;
+            row_stride = grid_c * grid_w;
+            break;
+        case KP_CHANNEL_ORDERING_HWC:
+            decoder.channel_stride = 1;
+            decoder.col_stride = grid_c;
+            row_stride = grid_w * grid_c;
+            break;
+        default:
+            decoder.channel_stride = grid_h * grid_w;
+            decoder.col_stride = 1;
+            row_stride = grid_w;
+            break;
         }
-        else if (class_good_box_count >= 2)
+
+        // a segment is a run of cells which are 'col_stride' apart: one row for HCW, the whole grid for CHW and HWC
+        int segment_count = (KP_CHANNEL_ORDERING_HCW == descriptor->channel_ordering) ? grid_h : 1;
+        int segment_len = grid_h * grid_w / segment_count;
+        int channel_stride = decoder.channel_stride;
+        int col_stride = decoder.col_stride;
+
+        if (0 != prepare_yolo_cell_buffer(context, segment_len))
+        {
+            printf("Error! %s(): malloc memory for cells failed\n", __FUNCTION__);
+            return -1;
+        }
+
+        int *cell_index = context->cell_index;
+        float *cell_confidence = context->cell_confidence;
+        kp_bounding_box_t *cell_boxes = context->cell_boxes;
+        bool *cell_decoded = context->cell_decoded;
+
+        for (int an = 0; an < head->anchor_count; an++)
         {
-            qsort(temp_boxes, class_good_box_count, sizeof(kp_bounding_box_t), box_comparator);
-            for (int j = 0; j < class_good_box_count; j++)
+            decoder.anchor = head->anchors[an];
+
+            for (int seg = 0; seg < segment_count; seg++)
             {
-                if (temp_boxes[j].score == 0)
-                    continue;
-                for (int k = j + 1; k < class_good_box_count; k++)
+                float *segment = node_output[i]->data + an * box_ch * channel_stride + seg * row_stride;
+                int row = seg;
+                int cell_count = 0;
+                float *confidence = cell_confidence;
+                int confidence_stride = 1;
+                bool all_cells = false;
+
+                if ((POST_PROCESS_ACTIVATION_NONE == objectness_activation) && (POST_PROCESS_ACTIVATION_SIGMOID != class_activation))
+                {
+                    // no cell can be skipped, read objectness from the node directly
+                    confidence = segment + 4 * channel_stride;
+                    confidence_stride = col_stride;
+                    cell_count = segment_len;
+                }
+                else
                 {
-                    if (box_iou(&temp_boxes[j], &temp_boxes[k], IOU_UNION) > NMS_THRESH_YOLOV5_720)
+                    // objectness of each cell, cells which can not pass the threshold are skipped for all classes
+                    for (int k = 0; k < segment_len; k++)
                     {
-                        temp_boxes[k].score = 0;
+                        float box_confidence = (float)yolo_activation(objectness_activation, decoder.lut, segment[k * col_stride + 4 * channel_stride]);
+
+                        // a sigmoid class probability is at most 1, so no class score can pass a positive threshold over the confidence
+                        if ((POST_PROCESS_ACTIVATION_SIGMOID == class_activation) && (0 < min_score) && (box_confidence < min_score))
+                            continue;
+
+                        cell_index[cell_count] = k;
+                        cell_confidence[cell_count] = box_confidence;
+                        cell_count++;
                     }
                 }
-            }
 
-            int good_count = 0;
-            for (int j = 0; j < class_good_box_count; j++)
-            {
-                if (temp_boxes[j].score > 0 && good_result_count < YOLO_GOOD_BOX_MAX)
+                all_cells = (cell_count == segment_len);
+                memset(cell_decoded, 0, cell_count * sizeof(bool));
+
+                // visit class probabilities in memory order, boxes are decoded only for the scores over threshold
+                if (1 == channel_stride)
                 {
-                    memcpy(&(yoloResult->boxes[good_result_count]), &temp_boxes[j], sizeof(kp_bounding_box_t));
-                    good_result_count++;
-                    good_count++;
+                    for (int c = 0; c < cell_count; c++)
+                    {
+                        int k = all_cells ? c : cell_index[c];
+                        float *class_p = segment + k * col_stride + YOLO_V3_BOX_FIX_CH;
+                        float box_confidence = confidence[c * confidence_stride];
+
+                        for (int j = 0; j < node_class_count; j++)
+                        {
+                            float class_prob = class_p[j];
+
+                            if (POST_PROCESS_ACTIVATION_NONE != class_activation)
+                                class_prob = (float)yolo_activation(class_activation, decoder.lut, class_prob);
+
+                            float score = class_prob * box_confidence;
+
+                            if ((score >= min_score) &&
+                                (0 != yolo_add_candidate(context, &decoder, class_count, &good_box_count, segment, row, k, &cell_boxes[c], &cell_decoded[c], score, j)))
+                                return -1;
+                        }
+                    }
                 }
-                if (YOLO_MAX_DETECTION_PER_CLASS == good_count)
+                else if (all_cells)
                 {
-                    break;
+                    for (int j = 0; j < node_class_count; j++)
+                    {
+                        float *class_p = segment + (YOLO_V3_BOX_FIX_CH + j) * channel_stride;
+
+                        for (int k = 0; k < cell_count; k++)
+                        {
+                            float class_prob = class_p[k];
+
+                            if (POST_PROCESS_ACTIVATION_NONE != class_activation)
+                                class_prob = (float)yolo_activation(class_activation, decoder.lut, class_prob);
+
+                            float score = class_prob * confidence[k];
+
+                            if ((score >= min_score) &&
+                                (0 != yolo_add_candidate(context, &decoder, class_count, &good_box_count, segment, row, k, &cell_boxes[k], &cell_decoded[k], score, j)))
+                                return -1;
+                        }
+                    }
+                }
+                else
+                {
+                    for (int j = 0; j < node_class_count; j++)
+                    {
+                        float *class_p = segment + (YOLO_V3_BOX_FIX_CH + j) * channel_stride;
+
+                        for (int c = 0; c < cell_count; c++)
+                        {
+                            int k = cell_index[c];
+                            float class_prob = class_p[k];
+
+                            if (POST_PROCESS_ACTIVATION_NONE != class_activation)
+                                class_prob = (float)yolo_activation(class_activation, decoder.lut, class_prob);
+
+                            float score = class_prob * confidence[c];
+
+                            if ((score >= min_score) &&
+                                (0 != yolo_add_candidate(context, &decoder, class_count, &good_box_count, segment, row, k, &cell_boxes[c], &cell_decoded[c], score, j)))
+                                return -1;
+                        }
+                    }
                 }
             }
         }
-
-        // FIXME: find a better policy to filter the detected bounding box result if total box count exceeds YOLO_GOOD_BOX_MAX
-        if (good_result_count >= YOLO_GOOD_BOX_MAX)
-            break;
     }
 
+    good_result_count = yolo_class_bucket_nms(context, class_count, good_box_count, descriptor->nms_thresh, descriptor->max_detection_per_class,
+                                              box_transform, yoloResult);
+
     yoloResult->box_count = good_result_count;
     yoloResult->class_count = class_count;
 
-    // convert the coordinate of all bounding boxes to raw image
-    boxes_scale(yoloResult->boxes, yoloResult->box_count, pre_proc_info);
+    return 0;
+}
+
+int post_process_yolo_v3_with_context(post_process_yolo_context_t *context, kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                      kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+{
+    return post_process_yolo_generic_with_context(context, &yolo_v3_descriptor, node_output, num_output_node, pre_proc_info, NULL, thresh_value, yoloResult);
+}
+
+int post_process_yolo_v3(kp_inf_float_node_output_t *node_output[], int num_output_node,
+                         kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+{
+    post_process_yolo_context_t *context = post_process_yolo_create_context();
+    if (NULL == context)
+        return -1;
 
-    free(updated_boxes);
+    int ret = post_process_yolo_v3_with_context(context, node_output, num_output_node, pre_proc_info, thresh_value, yoloResult);
 
-    free(cand_boxes.boxes);
-    for(int i = 0; i < class_count; i++)
-        free(cand_boxes.scores[i]);
-    free(cand_boxes.scores);
+    post_process_yolo_release_context(context);
 
-    free(temp_boxes);
+    return ret;
+}
 
-    return 0;
+int post_process_yolo_v5_520_with_context(post_process_yolo_context_t *context, kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                          kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+{
+    return post_process_yolo_generic_with_context(context, &yolo_v5_520_descriptor, node_output, num_output_node, pre_proc_info, NULL, thresh_value, yoloResult);
+}
+
+int post_process_yolo_v5_520(kp_inf_float_node_output_t *node_output[], int num_output_node,
+                             kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+{
+    post_process_yolo_context_t *context = post_process_yolo_create_context();
+    if (NULL == context)
+        return -1;
+
+    int ret = post_process_yolo_v5_520_with_context(context, node_output, num_output_node, pre_proc_info, thresh_value, yoloResult);
+
+    post_process_yolo_release_context(context);
+
+    return ret;
+}
+
+int post_process_yolo_v5_720_with_context(post_process_yolo_context_t *context, kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                          kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+{
+    return post_process_yolo_generic_with_context(context, &yolo_v5_720_descriptor, node_output, num_output_node, pre_proc_info, NULL, thresh_value, yoloResult);
+}
+
+int post_process_yolo_v5_720(kp_inf_float_node_output_t *node_output[], int num_output_node,
+                             kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult)
+{
+    post_process_yolo_context_t *context = post_process_yolo_create_context();
+    if (NULL == context)
+    {
+        yoloResult->box_count = 0;
+        return -1;
+    }
+
+    int ret = post_process_yolo_v5_720_with_context(context, node_output, num_output_node, pre_proc_info, thresh_value, yoloResult);
+    if (0 != ret)
+        yoloResult->box_count = 0;
+
+    post_process_yolo_release_context(context);
+
+    return ret;
+}
+
+/* heads match the NEF output nodes of model 32, the prior box sizes and the variances are unverified (not in the NEF) */
+static const post_process_ssd_descriptor_t ssd_fd_mask_descriptor = {
+    .head_count = 4,
+    .heads = {
+        {.anchor_count = 2, .min_sizes = {96, 128}},
+        {.anchor_count = 2, .min_sizes = {48, 64}},
+        {.anchor_count = 2, .min_sizes = {24, 32}},
+        {.anchor_count = 2, .min_sizes = {10, 16}}},
+    .channel_ordering = KP_CHANNEL_ORDERING_CHW,
+    .center_variance = 0.1f,
+    .size_variance = 0.2f,
+    .nms_thresh = NMS_THRESH_SSD_FD,
+    .max_detection_per_class = YOLO_MAX_DETECTION_PER_CLASS,
+};
+
+const post_process_ssd_descriptor_t *post_process_ssd_fd_mask_descriptor(void)
+{
+    return &ssd_fd_mask_descriptor;
+}
+
+/* data access strides of a C x H x W node in the given channel ordering */
+static void node_strides(kp_inf_float_node_output_t *node, uint32_t channel_ordering, int *channel_stride, int *row_stride, int *col_stride)
+{
+    int grid_c = node->shape[1];
+    int grid_h = node->shape[2];
+    int grid_w = node->shape[3];
+
+    switch (channel_ordering)
+    {
+    case KP_CHANNEL_ORDERING_HCW:
+        *channel_stride = grid_w;
+        *row_stride = grid_c * grid_w;
+        *col_stride = 1;
+        break;
+    case KP_CHANNEL_ORDERING_HWC:
+        *channel_stride = 1;
+        *row_stride = grid_w * grid_c;
+        *col_stride = grid_c;
+        break;
+    default:
+        *channel_stride = grid_h * grid_w;
+        *row_stride = grid_w;
+        *col_stride = 1;
+        break;
+    }
+}
+
+int post_process_ssd_with_context(post_process_yolo_context_t *context, const post_process_ssd_descriptor_t *descriptor,
+                                  kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                  kp_hw_pre_proc_info_t *pre_proc_info, const post_process_box_transform_t *box_transform,
+                                  float thresh_value, kp_yolo_result_t *result)
+{
+    post_process_box_transform_t pre_proc_box_transform;
+    int class_count = 0;
+    int prior_count = 0;
+    int candidate_count = 0;
+    int good_result_count = 0;
+    float logit_margin = -INFINITY;
+
+    if ((NULL == context) || (NULL == descriptor) || (NULL == node_output) || (NULL == pre_proc_info) || (NULL == result) ||
+        (0 >= descriptor->head_count) || (POST_PROCESS_SSD_MAX_HEAD < descriptor->head_count) || (2 * descriptor->head_count != num_output_node))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    // class logits include background, every head must have the same classes and match the prior boxes of the descriptor
+    for (int i = 0; i < descriptor->head_count; i++)
+    {
+        kp_inf_float_node_output_t *conf = node_output[2 * i];
+        kp_inf_float_node_output_t *loc = node_output[2 * i + 1];
+        int anchor_count = descriptor->heads[i].anchor_count;
+
+        if ((0 >= anchor_count) || (POST_PROCESS_SSD_MAX_ANCHOR < anchor_count) || (4 != conf->shape_len) || (4 != loc->shape_len) ||
+            (loc->shape[1] != 4 * anchor_count) || (0 != conf->shape[1] % anchor_count) ||
+            (loc->shape[2] != conf->shape[2]) || (loc->shape[3] != conf->shape[3]) ||
+            ((0 < i) && (conf->shape[1] / anchor_count != class_count + 1)))
+        {
+            printf("Error! %s(): output node %d and %d do not match the descriptor\n", __FUNCTION__, 2 * i, 2 * i + 1);
+            return -1;
+        }
+
+        class_count = conf->shape[1] / anchor_count - 1;
+        prior_count += anchor_count * conf->shape[2] * conf->shape[3];
+    }
+
+    if (0 >= class_count)
+    {
+        printf("Error! %s(): no class other than background\n", __FUNCTION__);
+        return -1;
+    }
 
-err:
-    if (NULL != updated_boxes) {
-        free(updated_boxes);
+    // every prior box can be a candidate of every class
+    if (0 != prepare_yolo_context(context, class_count + 1, prior_count * class_count))
+    {
+        printf("Error! %s(): malloc memory for context failed\n", __FUNCTION__);
+        return -1;
     }
 
-    if (NULL != cand_boxes.boxes) {
-        free(cand_boxes.boxes);
+    if (NULL == box_transform)
+    {
+        post_process_box_transform_init(&pre_proc_box_transform, pre_proc_info);
+        box_transform = &pre_proc_box_transform;
     }
 
-    if (NULL != cand_boxes.scores) {
-        for (int i = 0; i < class_count; i++) {
-            if (NULL != cand_boxes.scores[i]) {
-                free(cand_boxes.scores[i]);
+    // softmax of class c can reach the threshold only if l_c - l_j >= log(t / (1 - t)) for every other logit l_j
+    if ((0 < thresh_value) && (1 > thresh_value))
+        logit_margin = logf(thresh_value / (1 - thresh_value)) - SSD_LOGIT_MARGIN_SLACK;
+
+    for (int i = 0; i < descriptor->head_count; i++)
+    {
+        const post_process_ssd_head_t *head = &descriptor->heads[i];
+        kp_inf_float_node_output_t *conf = node_output[2 * i];
+        kp_inf_float_node_output_t *loc = node_output[2 * i + 1];
+        int grid_h = conf->shape[2];
+        int grid_w = conf->shape[3];
+        int logit_count = class_count + 1;
+        float step_w = (float)pre_proc_info->model_input_width / grid_w;
+        float step_h = (float)pre_proc_info->model_input_height / grid_h;
+        int conf_channel_stride, conf_row_stride, conf_col_stride;
+        int loc_channel_stride, loc_row_stride, loc_col_stride;
+        float *logits = context->box_class_probs;
+
+        node_strides(conf, descriptor->channel_ordering, &conf_channel_stride, &conf_row_stride, &conf_col_stride);
+        node_strides(loc, descriptor->channel_ordering, &loc_channel_stride, &loc_row_stride, &loc_col_stride);
+
+        for (int row = 0; row < grid_h; row++)
+        {
+            for (int col = 0; col < grid_w; col++)
+            {
+                for (int an = 0; an < head->anchor_count; an++)
+                {
+                    float *conf_data = conf->data + row * conf_row_stride + col * conf_col_stride + an * logit_count * conf_channel_stride;
+                    float max_logit = -INFINITY;
+                    float second_logit = -INFINITY;
+                    bool softmax_ready = false;
+                    bool box_ready = false;
+                    float exp_sum = 0;
+                    kp_bounding_box_t prior_box;
+
+                    for (int j = 0; j < logit_count; j++)
+                    {
+                        logits[j] = conf_data[j * conf_channel_stride];
+
+                        if (logits[j] > max_logit)
+                        {
+                            second_logit = max_logit;
+                            max_logit = logits[j];
+                        }
+                        else if (logits[j] > second_logit)
+                        {
+                            second_logit = logits[j];
+                        }
+                    }
+
+                    for (int j = 1; j < logit_count; j++)
+                    {
+                        float other_logit = (logits[j] == max_logit) ? second_logit : max_logit;
+
+                        if (logits[j] - other_logit < logit_margin)
+                            continue;
+
+                        if (!softmax_ready)
+                        {
+                            for (int k = 0; k < logit_count; k++)
+                                exp_sum += expf(logits[k] - max_logit);
+                            softmax_ready = true;
+                        }
+
+                        float score = expf(logits[j] - max_logit) / exp_sum;
+                        if (score < thresh_value)
+                            continue;
+
+                        // the prior box is centered on the cell, decode it once for all classes
+                        if (!box_ready)
+                        {
+                            float *loc_data = loc->data + row * loc_row_stride + col * loc_col_stride + an * 4 * loc_channel_stride;
+                            float prior_size = head->min_sizes[an];
+                            float box_x = (col + 0.5f) * step_w + loc_data[0] * descriptor->center_variance * prior_size;
+                            float box_y = (row + 0.5f) * step_h + loc_data[loc_channel_stride] * descriptor->center_variance * prior_size;
+                            float box_w = prior_size * expf(loc_data[2 * loc_channel_stride] * descriptor->size_variance);
+                            float box_h = prior_size * expf(loc_data[3 * loc_channel_stride] * descriptor->size_variance);
+
+                            prior_box.x1 = box_x - (box_w / 2);
+                            prior_box.y1 = box_y - (box_h / 2);
+                            prior_box.x2 = box_x + (box_w / 2);
+                            prior_box.y2 = box_y + (box_h / 2);
+                            box_transform_map(box_transform, &prior_box);
+                            box_ready = true;
+                        }
+
+                        kp_bounding_box_t *candidate = &context->candidate_boxes[candidate_count++];
+
+                        memcpy(candidate, &prior_box, sizeof(kp_bounding_box_t));
+                        candidate->score = score;
+                        candidate->class_num = j - 1;
+                    }
+                }
             }
         }
+    }
+
+    good_result_count = yolo_class_bucket_nms(context, class_count, candidate_count, descriptor->nms_thresh, descriptor->max_detection_per_class,
+                                              box_transform, result);
+
+    result->box_count = good_result_count;
+    result->class_count = class_count;
+
+    return 0;
+}
+
+int post_process_face_landmark(kp_inf_float_node_output_t *node_output[], int num_output_node, kp_bounding_box_t *face_box,
+                               kp_landmark_result_t *landmark)
+{
+    if ((NULL == node_output) || (2 > num_output_node) || (NULL == face_box) || (NULL == landmark) ||
+        (2 > node_output[0]->num_data) || (2 * LAND_MARK_POINTS > node_output[1]->num_data))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    float *logits = node_output[0]->data;
+    float *points = node_output[1]->data;
+    float box_w = face_box->x2 - face_box->x1;
+    float box_h = face_box->y2 - face_box->y1;
+
+    for (int i = 0; i < LAND_MARK_POINTS; i++)
+    {
+        float x = face_box->x1 + points[2 * i] * box_w;
+        float y = face_box->y1 + points[2 * i + 1] * box_h;
+
+        landmark->marks[i].x = (x > 0) ? (uint32_t)(x + 0.5f) : 0;
+        landmark->marks[i].y = (y > 0) ? (uint32_t)(y + 0.5f) : 0;
+    }
+
+    // softmax of the face logit
+    landmark->score = 1 / (1 + expf(logits[0] - logits[1]));
+    landmark->blur = 0;
+    landmark->class_num = face_box->class_num;
+
+    return 0;
+}
+
+/* whether logit 'a' of class 'a_class' ranks after logit 'b' of class 'b_class', equal logits rank in class order */
+static inline bool classification_worse(float a, int32_t a_class, float b, int32_t b_class)
+{
+    return (a < b) || ((a == b) && (a_class > b_class));
+}
+
+/* min-heap whose root is the worst kept logit, 'score' holds the logit until the probabilities are computed */
+static void classification_sift_down(kp_classification_result_t *heap, int size, int idx)
+{
+    while (1)
+    {
+        int child = 2 * idx + 1;
+        if (child >= size)
+            break;
+
+        if ((child + 1 < size) && classification_worse(heap[child + 1].score, heap[child + 1].class_num, heap[child].score, heap[child].class_num))
+            child++;
+
+        if (!classification_worse(heap[child].score, heap[child].class_num, heap[idx].score, heap[idx].class_num))
+            break;
+
+        kp_classification_result_t temp = heap[idx];
+        heap[idx] = heap[child];
+        heap[child] = temp;
+        idx = child;
+    }
+}
+
+/* logit of a class, fixed-point value for per-tensor quantization (the order is the same as floating-point), floating-point value otherwise */
+static inline float classification_logit(kp_inf_fixed_node_output_t *node_output, bool per_tensor, int idx)
+{
+    float logit = 0;
+
+    if (KP_FIXED_POINT_DTYPE_INT8 == node_output->fixed_point_dtype)
+        logit = node_output->data.int8[idx];
+    else
+        logit = node_output->data.int16[idx];
+
+    if (!per_tensor)
+    {
+        kp_quantized_fixed_point_descriptor_t *descriptor = &node_output->quantization_parameters.quantization_parameters_data.v1.quantized_fixed_point_descriptor[idx];
+        logit /= descriptor->scale.scale_float32 * ldexpf(1.0f, descriptor->radix);
+    }
+
+    return logit;
+}
+
+static int classification_comparator(const void *result_1, const void *result_2)
+{
+    const kp_classification_result_t *a = (const kp_classification_result_t *)result_1;
+    const kp_classification_result_t *b = (const kp_classification_result_t *)result_2;
+
+    if (classification_worse(a->score, a->class_num, b->score, b->class_num))
+        return 1;
+    if (classification_worse(b->score, b->class_num, a->score, a->class_num))
+        return -1;
+
+    return 0;
+}
+
+int post_process_classification_top_k(kp_inf_fixed_node_output_t *node_output, int top_k, kp_classification_result_t results[], int *result_count)
+{
+    kp_quantization_parameters_v1_t *quantization_parameters = NULL;
+    int class_count = 0;
+    int heap_size = 0;
+    bool per_tensor = true;
+    float quantization_factor = 1;
+    float max_logit = -INFINITY;
+    double exp_sum = 0;
+    uint32_t value_histogram[256];
+
+    if ((NULL == node_output) || (0 >= top_k) || (NULL == results) || (NULL == result_count) || (0 >= node_output->num_data) ||
+        ((KP_FIXED_POINT_DTYPE_INT8 != node_output->fixed_point_dtype) && (KP_FIXED_POINT_DTYPE_INT16 != node_output->fixed_point_dtype)))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    quantization_parameters = &node_output->quantization_parameters.quantization_parameters_data.v1;
+    class_count = node_output->num_data;
+    per_tensor = (1 == quantization_parameters->quantized_fixed_point_descriptor_num);
+
+    if ((!per_tensor) && (class_count != quantization_parameters->quantized_fixed_point_descriptor_num))
+    {
+        printf("Error! %s(): quantization info len (%d) does not match data len (%d)\n", __FUNCTION__,
+               quantization_parameters->quantized_fixed_point_descriptor_num, class_count);
+        return -1;
+    }
+
+    if (per_tensor)
+    {
+        quantization_factor = quantization_parameters->quantized_fixed_point_descriptor[0].scale.scale_float32 *
+                              ldexpf(1.0f, quantization_parameters->quantized_fixed_point_descriptor[0].radix);
+
+        // a positive factor keeps the order of logits, so they are compared as fixed-point values
+        if (!(0 < quantization_factor))
+        {
+            printf("Error! %s(): invalid quantization factor %f\n", __FUNCTION__, quantization_factor);
+            return -1;
+        }
+    }
+
+    bool use_histogram = per_tensor && (KP_FIXED_POINT_DTYPE_INT8 == node_output->fixed_point_dtype);
+    if (use_histogram)
+        memset(value_histogram, 0, sizeof(value_histogram));
+
+    for (int i = 0; i < class_count; i++)
+    {
+        float logit = classification_logit(node_output, per_tensor, i);
+
+        if (use_histogram)
+            value_histogram[node_output->data.int8[i] + 128]++;
+
+        if (logit > max_logit)
+            max_logit = logit;
+
+        // bounded heap, most logits are rejected by one comparison against the root
+        if (heap_size < top_k)
+        {
+            int idx = heap_size++;
+
+            results[idx].class_num = i;
+            results[idx].score = logit;
+
+            while (0 < idx)
+            {
+                int parent = (idx - 1) / 2;
+                if (!classification_worse(results[idx].score, results[idx].class_num, results[parent].score, results[parent].class_num))
+                    break;
+
+                kp_classification_result_t temp = results[idx];
+                results[idx] = results[parent];
+                results[parent] = temp;
+                idx = parent;
+            }
+        }
+        else if (logit > results[0].score)
+        {
+            results[0].class_num = i;
+            results[0].score = logit;
+            classification_sift_down(results, heap_size, 0);
+        }
+    }
+
+    // softmax denominator with the max logit subtracted, an int8 node needs at most 256 exp() through the histogram of its values
+    if (use_histogram)
+    {
+        for (int value = 0; value < 256; value++)
+        {
+            if (0 != value_histogram[value])
+                exp_sum += value_histogram[value] * exp((double)(value - 128 - max_logit) / quantization_factor);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < class_count; i++)
+        {
+            float logit = classification_logit(node_output, per_tensor, i);
+
+            exp_sum += exp(per_tensor ? (double)(logit - max_logit) / quantization_factor : (double)(logit - max_logit));
+        }
+    }
+
+    qsort(results, heap_size, sizeof(kp_classification_result_t), classification_comparator);
+
+    for (int i = 0; i < heap_size; i++)
+    {
+        double logit_diff = per_tensor ? (double)(results[i].score - max_logit) / quantization_factor : (double)(results[i].score - max_logit);
+        results[i].score = (float)(exp(logit_diff) / exp_sum);
+    }
+
+    *result_count = heap_size;
+
+    return 0;
+}
+
+int post_process_classification_top_k_batch(kp_inf_fixed_node_output_t *node_output[], int batch_size, int top_k, kp_classification_result_t results[],
+                                            int result_counts[])
+{
+    int ret = 0;
+
+    if ((NULL == node_output) || (0 > batch_size) || (0 >= top_k) || (NULL == results) || (NULL == result_counts))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    for (int i = 0; i < batch_size; i++)
+    {
+        result_counts[i] = 0;
+
+        if (0 != post_process_classification_top_k(node_output[i], top_k, &results[i * top_k], &result_counts[i]))
+            ret = -1;
+    }
+
+    return ret;
+}
+
+struct post_process_executor_s
+{
+    int worker_count;
+    int thread_count;
+    pthread_t *threads;
+    post_process_yolo_context_t **contexts;
+    pthread_mutex_t mutex;
+    pthread_cond_t start_cond;
+    pthread_cond_t done_cond;
+    unsigned int generation;
+    int busy_thread_count;
+    bool exit;
+
+    // current batch
+    post_process_yolo_type_t type;
+    float thresh_value;
+    post_process_yolo_batch_item_t *items;
+    int item_count;
+    int next_item;
+};
+
+typedef struct
+{
+    post_process_executor_t *executor;
+    int worker_idx;
+} post_process_worker_arg_t;
+
+static void post_process_executor_drain(post_process_executor_t *executor, post_process_yolo_context_t *context)
+{
+    while (1)
+    {
+        pthread_mutex_lock(&executor->mutex);
+        int idx = executor->next_item++;
+        pthread_mutex_unlock(&executor->mutex);
+
+        if (idx >= executor->item_count)
+            break;
+
+        post_process_yolo_batch_item_t *item = &executor->items[idx];
+
+        switch (executor->type)
+        {
+        case POST_PROCESS_YOLO_V3:
+            item->status = post_process_yolo_v3_with_context(context, item->node_output, item->num_output_node, item->pre_proc_info, executor->thresh_value, item->yolo_result);
+            break;
+        case POST_PROCESS_YOLO_V5_520:
+            item->status = post_process_yolo_v5_520_with_context(context, item->node_output, item->num_output_node, item->pre_proc_info, executor->thresh_value, item->yolo_result);
+            break;
+        case POST_PROCESS_YOLO_V5_720:
+            item->status = post_process_yolo_v5_720_with_context(context, item->node_output, item->num_output_node, item->pre_proc_info, executor->thresh_value, item->yolo_result);
+            break;
+        default:
+            item->status = -1;
+            break;
+        }
+    }
+}
+
+static void *post_process_worker_thread(void *data)
+{
+    post_process_worker_arg_t *arg = (post_process_worker_arg_t *)data;
+    post_process_executor_t *executor = arg->executor;
+    post_process_yolo_context_t *context = executor->contexts[arg->worker_idx];
+    unsigned int generation = 0;
+
+    free(arg);
+
+    pthread_mutex_lock(&executor->mutex);
+
+    while (1)
+    {
+        while (!executor->exit && (generation == executor->generation))
+            pthread_cond_wait(&executor->start_cond, &executor->mutex);
+
+        if (executor->exit)
+            break;
+
+        generation = executor->generation;
+        pthread_mutex_unlock(&executor->mutex);
+
+        post_process_executor_drain(executor, context);
+
+        pthread_mutex_lock(&executor->mutex);
+        if (0 == --executor->busy_thread_count)
+            pthread_cond_signal(&executor->done_cond);
+    }
+
+    pthread_mutex_unlock(&executor->mutex);
+
+    return NULL;
+}
+
+post_process_executor_t *post_process_executor_create(int worker_count)
+{
+    post_process_executor_t *executor = NULL;
+
+    if (0 >= worker_count)
+    {
+        printf("Error! %s(): invalid worker count %d\n", __FUNCTION__, worker_count);
+        return NULL;
+    }
+
+    executor = (post_process_executor_t *)calloc(1, sizeof(post_process_executor_t));
+    if (NULL == executor)
+    {
+        printf("Error! %s(): malloc memory for executor failed\n", __FUNCTION__);
+        return NULL;
+    }
+
+    pthread_mutex_init(&executor->mutex, NULL);
+    pthread_cond_init(&executor->start_cond, NULL);
+    pthread_cond_init(&executor->done_cond, NULL);
+
+    executor->contexts = (post_process_yolo_context_t **)calloc(worker_count, sizeof(post_process_yolo_context_t *));
+    executor->threads = (pthread_t *)calloc(worker_count, sizeof(pthread_t));
+    if ((NULL == executor->contexts) || (NULL == executor->threads))
+    {
+        printf("Error! %s(): malloc memory for workers failed\n", __FUNCTION__);
+        goto FUNC_OUT_ERROR;
+    }
+
+    executor->worker_count = worker_count;
+
+    for (int i = 0; i < worker_count; i++)
+    {
+        executor->contexts[i] = post_process_yolo_create_context();
+        if (NULL == executor->contexts[i])
+            goto FUNC_OUT_ERROR;
+    }
+
+    // worker 0 is the calling thread of post_process_executor_run_yolo()
+    for (int i = 1; i < worker_count; i++)
+    {
+        post_process_worker_arg_t *arg = (post_process_worker_arg_t *)malloc(sizeof(post_process_worker_arg_t));
+        if (NULL == arg)
+        {
+            printf("Error! %s(): malloc memory for worker failed\n", __FUNCTION__);
+            goto FUNC_OUT_ERROR;
+        }
+
+        arg->executor = executor;
+        arg->worker_idx = i;
+
+        if (0 != pthread_create(&executor->threads[i], NULL, post_process_worker_thread, (void *)arg))
+        {
+            printf("Error! %s(): create worker thread failed\n", __FUNCTION__);
+            free(arg);
+            goto FUNC_OUT_ERROR;
+        }
+
+        executor->thread_count = i;
+    }
+
+    return executor;
+
+FUNC_OUT_ERROR:
+    post_process_executor_release(executor);
+
+    return NULL;
+}
+
+void post_process_executor_release(post_process_executor_t *executor)
+{
+    if (NULL == executor)
+        return;
+
+    pthread_mutex_lock(&executor->mutex);
+    executor->exit = true;
+    pthread_cond_broadcast(&executor->start_cond);
+    pthread_mutex_unlock(&executor->mutex);
+
+    for (int i = 1; i <= executor->thread_count; i++)
+        pthread_join(executor->threads[i], NULL);
+
+    for (int i = 0; (NULL != executor->contexts) && (i < executor->worker_count); i++)
+        post_process_yolo_release_context(executor->contexts[i]);
+
+    pthread_cond_destroy(&executor->done_cond);
+    pthread_cond_destroy(&executor->start_cond);
+    pthread_mutex_destroy(&executor->mutex);
+
+    free(executor->threads);
+    free(executor->contexts);
+    free(executor);
+}
+
+void post_process_executor_set_pre_nms_top_k(post_process_executor_t *executor, int top_k_per_class, int top_k)
+{
+    if (NULL == executor)
+        return;
+
+    for (int i = 0; i < executor->worker_count; i++)
+        post_process_yolo_set_pre_nms_top_k(executor->contexts[i], top_k_per_class, top_k);
+}
+
+int post_process_executor_set_node_quantization(post_process_executor_t *executor, int node_idx, kp_inf_node_view_t *node_view)
+{
+    if (NULL == executor)
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    for (int i = 0; i < executor->worker_count; i++)
+    {
+        if (0 != post_process_yolo_set_node_quantization(executor->contexts[i], node_idx, node_view))
+            return -1;
+    }
+
+    return 0;
+}
+
+int post_process_executor_run_yolo(post_process_executor_t *executor, post_process_yolo_type_t type, float thresh_value,
+                                   post_process_yolo_batch_item_t items[], int item_count)
+{
+    int ret = 0;
+
+    if ((NULL == executor) || ((NULL == items) && (0 < item_count)))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    pthread_mutex_lock(&executor->mutex);
+    executor->type = type;
+    executor->thresh_value = thresh_value;
+    executor->items = items;
+    executor->item_count = item_count;
+    executor->next_item = 0;
+    executor->busy_thread_count = executor->thread_count;
+    executor->generation++;
+    pthread_cond_broadcast(&executor->start_cond);
+    pthread_mutex_unlock(&executor->mutex);
+
+    post_process_executor_drain(executor, executor->contexts[0]);
+
+    pthread_mutex_lock(&executor->mutex);
+    while (0 < executor->busy_thread_count)
+        pthread_cond_wait(&executor->done_cond, &executor->mutex);
+    pthread_mutex_unlock(&executor->mutex);
+
+    for (int i = 0; i < item_count; i++)
+    {
+        if (0 != items[i].status)
+            ret = -1;
+    }
+
+    return ret;
+}
+
+/* one tracked object, the box is kept as center and size */
+typedef struct
+{
+    uint32_t id;
+    int32_t class_num;
+    float cx;
+    float cy;
+    float w;
+    float h;
+    float vx;                   // center velocity in pixels per frame
+    float vy;
+    int lost_frames;            // consecutive frames without a matched detection
+    bool matched;
+    unsigned int visit;         // last grid search which visited this track
+    kp_bounding_box_t predicted;
+} tracker_track_t;
+
+/* a detection and a track of the same class with IoU over the threshold */
+typedef struct
+{
+    float iou;
+    int box_idx;
+    int track_idx;
+} tracker_pair_t;
+
+struct post_process_tracker_s
+{
+    float iou_thresh;
+    int max_lost_frames;
+    uint32_t next_track_id;
+    unsigned int visit;
+
+    int track_count;
+    int track_capacity;
+    tracker_track_t *tracks;
+
+    // uniform grid over the predicted boxes, tracks in cell i are cell_tracks[cell_offset[i] .. cell_offset[i + 1])
+    float grid_x;
+    float grid_y;
+    float cell_size;
+    int grid_cols;
+    int grid_rows;
+    int cell_capacity;
+    int *cell_offset;
+    int cell_track_capacity;
+    int *cell_tracks;
+
+    int pair_count;
+    int pair_capacity;
+    tracker_pair_t *pairs;
+};
+
+/* grow a buffer to hold at least 'count' elements */
+static int tracker_reserve(void **buffer, int *capacity, int count, size_t element_size)
+{
+    if (count <= *capacity)
+        return 0;
+
+    int new_capacity = (0 < *capacity) ? *capacity : TRACKER_MIN_CAPACITY;
+    while (new_capacity < count)
+        new_capacity *= 2;
+
+    void *new_buffer = realloc(*buffer, new_capacity * element_size);
+    if (NULL == new_buffer)
+        return -1;
+
+    *buffer = new_buffer;
+    *capacity = new_capacity;
+
+    return 0;
+}
+
+/* grid cells covering [low, high] along one axis, coordinates outside the grid fall into the border cells */
+static inline void tracker_cell_range(float low, float high, float origin, float cell_size, int cell_count, int *first, int *last)
+{
+    float first_cell = (low - origin) / cell_size;
+    float last_cell = (high - origin) / cell_size;
+
+    *first = !(first_cell >= 0) ? 0 : (first_cell >= cell_count) ? cell_count - 1 : (int)first_cell;
+    *last = !(last_cell >= 0) ? 0 : (last_cell >= cell_count) ? cell_count - 1 : (int)last_cell;
+}
+
+/* bucket tracks into every grid cell their predicted boxes cover, a detection only visits tracks in the cells it covers */
+static int tracker_build_grid(post_process_tracker_t *tracker)
+{
+    float min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    float size_sum = 0;
+    int track_count = tracker->track_count;
+
+    tracker->grid_cols = 0;
+    tracker->grid_rows = 0;
+
+    if (0 == track_count)
+        return 0;
+
+    for (int i = 0; i < track_count; i++)
+    {
+        kp_bounding_box_t *box = &tracker->tracks[i].predicted;
+
+        min_x = (box->x1 < min_x) ? box->x1 : min_x;
+        min_y = (box->y1 < min_y) ? box->y1 : min_y;
+        max_x = (box->x2 > max_x) ? box->x2 : max_x;
+        max_y = (box->y2 > max_y) ? box->y2 : max_y;
+        size_sum += (tracker->tracks[i].w > tracker->tracks[i].h) ? tracker->tracks[i].w : tracker->tracks[i].h;
+    }
+
+    // cells of the mean object size, coarser if the objects are sparse over a large area
+    float cell_size = size_sum / track_count;
+    float max_cell_count = (float)TRACKER_GRID_CELLS_PER_TRACK * track_count;
+    float cols = 0, rows = 0;
+
+    if (!(cell_size >= 1))
+        cell_size = 1;
+
+    cols = floorf((max_x - min_x) / cell_size) + 1;
+    rows = floorf((max_y - min_y) / cell_size) + 1;
+
+    while (!(cols * rows <= max_cell_count))
+    {
+        // no finite cell size fits, e.g. NaN coordinates, one cell holds all tracks
+        if (isinf(cell_size))
+        {
+            cols = rows = 1;
+            break;
+        }
+
+        cell_size *= 2;
+        cols = floorf((max_x - min_x) / cell_size) + 1;
+        rows = floorf((max_y - min_y) / cell_size) + 1;
+    }
+
+    int cell_count = (int)cols * (int)rows;
+    if (0 != tracker_reserve((void **)&tracker->cell_offset, &tracker->cell_capacity, cell_count + 1, sizeof(int)))
+        return -1;
+
+    int *cell_offset = tracker->cell_offset;
+    memset(cell_offset, 0, (cell_count + 1) * sizeof(int));
+
+    tracker->grid_x = min_x;
+    tracker->grid_y = min_y;
+    tracker->cell_size = cell_size;
+    tracker->grid_cols = (int)cols;
+    tracker->grid_rows = (int)rows;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < track_count; i++)
+        {
+            kp_bounding_box_t *box = &tracker->tracks[i].predicted;
+            int col_first, col_last, row_first, row_last;
+
+            tracker_cell_range(box->x1, box->x2, min_x, cell_size, tracker->grid_cols, &col_first, &col_last);
+            tracker_cell_range(box->y1, box->y2, min_y, cell_size, tracker->grid_rows, &row_first, &row_last);
+
+            for (int r = row_first; r <= row_last; r++)
+            {
+                for (int c = col_first; c <= col_last; c++)
+                {
+                    int cell = r * tracker->grid_cols + c;
+
+                    // count the tracks of each cell first, then fill them after the prefix sum
+                    if (0 == pass)
+                        cell_offset[cell + 1]++;
+                    else
+                        tracker->cell_tracks[cell_offset[cell]++] = i;
+                }
+            }
+        }
+
+        if (0 == pass)
+        {
+            for (int i = 0; i < cell_count; i++)
+                cell_offset[i + 1] += cell_offset[i];
+
+            if (0 != tracker_reserve((void **)&tracker->cell_tracks, &tracker->cell_track_capacity, cell_offset[cell_count], sizeof(int)))
+                return -1;
+        }
+    }
+
+    // after filling, cell_offset[i] is the end of cell i
+    for (int i = cell_count; i > 0; i--)
+        cell_offset[i] = cell_offset[i - 1];
+    cell_offset[0] = 0;
+
+    return 0;
+}
+
+/* add the pairs of one detection and the tracks in the grid cells its box covers */
+static int tracker_search(post_process_tracker_t *tracker, kp_bounding_box_t *box, int box_idx)
+{
+    int col_first, col_last, row_first, row_last;
+
+    if (0 == tracker->grid_cols)
+        return 0;
+
+    // a track covering several cells is visited once
+    if (0 == ++tracker->visit)
+    {
+        for (int i = 0; i < tracker->track_count; i++)
+            tracker->tracks[i].visit = 0;
+        tracker->visit = 1;
+    }
+
+    tracker_cell_range(box->x1, box->x2, tracker->grid_x, tracker->cell_size, tracker->grid_cols, &col_first, &col_last);
+    tracker_cell_range(box->y1, box->y2, tracker->grid_y, tracker->cell_size, tracker->grid_rows, &row_first, &row_last);
+
+    for (int r = row_first; r <= row_last; r++)
+    {
+        for (int c = col_first; c <= col_last; c++)
+        {
+            int cell = r * tracker->grid_cols + c;
+
+            for (int k = tracker->cell_offset[cell]; k < tracker->cell_offset[cell + 1]; k++)
+            {
+                int track_idx = tracker->cell_tracks[k];
+                tracker_track_t *track = &tracker->tracks[track_idx];
+
+                if ((track->visit == tracker->visit) || (track->class_num != box->class_num))
+                    continue;
+                track->visit = tracker->visit;
+
+                float intersection = box_intersection(box, &track->predicted);
+                if (0 >= intersection)
+                    continue;
+
+                float iou = intersection / box_union(box, &track->predicted);
+                if (iou < tracker->iou_thresh)
+                    continue;
+
+                if (0 != tracker_reserve((void **)&tracker->pairs, &tracker->pair_capacity, tracker->pair_count + 1, sizeof(tracker_pair_t)))
+                    return -1;
+
+                tracker->pairs[tracker->pair_count].iou = iou;
+                tracker->pairs[tracker->pair_count].box_idx = box_idx;
+                tracker->pairs[tracker->pair_count].track_idx = track_idx;
+                tracker->pair_count++;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* higher IoU first, ties in detection and track order so matching does not depend on the sort algorithm */
+static int tracker_pair_comparator(const void *pair_1, const void *pair_2)
+{
+    const tracker_pair_t *a = (const tracker_pair_t *)pair_1;
+    const tracker_pair_t *b = (const tracker_pair_t *)pair_2;
+
+    if (a->iou != b->iou)
+        return (a->iou > b->iou) ? -1 : 1;
+    if (a->box_idx != b->box_idx)
+        return (a->box_idx < b->box_idx) ? -1 : 1;
+    if (a->track_idx != b->track_idx)
+        return (a->track_idx < b->track_idx) ? -1 : 1;
+
+    return 0;
+}
+
+static void tracker_track_predict(tracker_track_t *track)
+{
+    track->cx += track->vx;
+    track->cy += track->vy;
+    track->matched = false;
+
+    track->predicted.x1 = track->cx - track->w / 2;
+    track->predicted.y1 = track->cy - track->h / 2;
+    track->predicted.x2 = track->cx + track->w / 2;
+    track->predicted.y2 = track->cy + track->h / 2;
+    track->predicted.score = 0;
+    track->predicted.class_num = track->class_num;
+}
+
+/* move the track to its detection, the velocity follows the prediction error spread over the frames since the last match */
+static void tracker_track_correct(tracker_track_t *track, kp_bounding_box_t *box)
+{
+    float cx = (box->x1 + box->x2) / 2;
+    float cy = (box->y1 + box->y2) / 2;
+    float frames = (float)(track->lost_frames + 1);
+
+    track->vx += TRACKER_VELOCITY_GAIN * (cx - track->cx) / frames;
+    track->vy += TRACKER_VELOCITY_GAIN * (cy - track->cy) / frames;
+    track->cx = cx;
+    track->cy = cy;
+    track->w = box->x2 - box->x1;
+    track->h = box->y2 - box->y1;
+    track->lost_frames = 0;
+    track->matched = true;
+}
+
+post_process_tracker_t *post_process_tracker_create(float iou_thresh, int max_lost_frames)
+{
+    post_process_tracker_t *tracker = NULL;
+
+    if (!(0 < iou_thresh) || (1 < iou_thresh) || (0 > max_lost_frames))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return NULL;
+    }
+
+    tracker = (post_process_tracker_t *)calloc(1, sizeof(post_process_tracker_t));
+    if (NULL == tracker)
+    {
+        printf("Error! %s(): malloc memory for tracker failed\n", __FUNCTION__);
+        return NULL;
+    }
+
+    tracker->iou_thresh = iou_thresh;
+    tracker->max_lost_frames = max_lost_frames;
+    tracker->next_track_id = 1;
+
+    return tracker;
+}
+
+void post_process_tracker_release(post_process_tracker_t *tracker)
+{
+    if (NULL == tracker)
+        return;
+
+    free(tracker->tracks);
+    free(tracker->cell_offset);
+    free(tracker->cell_tracks);
+    free(tracker->pairs);
+    free(tracker);
+}
+
+int post_process_tracker_update(post_process_tracker_t *tracker, kp_bounding_box_t boxes[], int box_count, uint32_t track_ids[])
+{
+    int track_count = 0;
+
+    if ((NULL == tracker) || (0 > box_count) || ((0 < box_count) && ((NULL == boxes) || (NULL == track_ids))))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    for (int i = 0; i < tracker->track_count; i++)
+        tracker_track_predict(&tracker->tracks[i]);
+
+    if (0 != tracker_build_grid(tracker))
+    {
+        printf("Error! %s(): malloc memory for grid failed\n", __FUNCTION__);
+        return -1;
+    }
+
+    // candidate pairs of detections and nearby tracks
+    tracker->pair_count = 0;
+    for (int i = 0; i < box_count; i++)
+    {
+        track_ids[i] = 0;
+
+        if (0 != tracker_search(tracker, &boxes[i], i))
+        {
+            printf("Error! %s(): malloc memory for pairs failed\n", __FUNCTION__);
+            return -1;
+        }
+    }
+
+    // greedy matching, the pair of the highest IoU first
+    qsort(tracker->pairs, tracker->pair_count, sizeof(tracker_pair_t), tracker_pair_comparator);
+
+    for (int i = 0; i < tracker->pair_count; i++)
+    {
+        tracker_pair_t *pair = &tracker->pairs[i];
+        tracker_track_t *track = &tracker->tracks[pair->track_idx];
+
+        if ((0 != track_ids[pair->box_idx]) || track->matched)
+            continue;
+
+        tracker_track_correct(track, &boxes[pair->box_idx]);
+        track_ids[pair->box_idx] = track->id;
+    }
+
+    // remove the tracks lost for too long, the others keep their order
+    for (int i = 0; i < tracker->track_count; i++)
+    {
+        tracker_track_t *track = &tracker->tracks[i];
+
+        if ((!track->matched) && (++track->lost_frames > tracker->max_lost_frames))
+            continue;
+
+        if (track_count != i)
+            memcpy(&tracker->tracks[track_count], track, sizeof(tracker_track_t));
+        track_count++;
+    }
+    tracker->track_count = track_count;
+
+    // unmatched detections start new tracks
+    for (int i = 0; i < box_count; i++)
+    {
+        if (0 != track_ids[i])
+            continue;
+
+        if (0 != tracker_reserve((void **)&tracker->tracks, &tracker->track_capacity, tracker->track_count + 1, sizeof(tracker_track_t)))
+        {
+            printf("Error! %s(): malloc memory for tracks failed\n", __FUNCTION__);
+            return -1;
+        }
+
+        tracker_track_t *track = &tracker->tracks[tracker->track_count++];
+
+        memset(track, 0, sizeof(tracker_track_t));
+        track->id = tracker->next_track_id++;
+        track->class_num = boxes[i].class_num;
+        tracker_track_correct(track, &boxes[i]);
+        track->vx = 0;
+        track->vy = 0;
+
+        if (0 == tracker->next_track_id)
+            tracker->next_track_id = 1;
 
-        free(cand_boxes.scores);
+        track_ids[i] = track->id;
     }
 
     return 0;
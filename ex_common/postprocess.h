@@ -15,6 +15,218 @@
 #include <stdint.h>
 #include "kp_struct.h"
 
+/**
+ * @brief Lookup tables of sigmoid and exp over all fixed-point values of one output node.
+ *
+ * An int8 node has 256 possible values and an int16 node has 65536, each table entry is the result of the dequantized value,
+ * so the decoding loop reads a table entry instead of calling exp().
+ */
+typedef struct
+{
+    uint32_t fixed_point_dtype;             /**< enum kp_fixed_point_dtype_t of the tables, KP_FIXED_POINT_DTYPE_UNKNOWN if the node is not tabulated */
+    float quantization_factor;              /**< quantization factor (scale * 2^radix) the tables are built for */
+    int32_t fixed_point_min;                /**< fixed-point value of the first table entry */
+    int32_t fixed_point_max;                /**< fixed-point value of the last table entry */
+    float *sigmoid_table;                   /**< sigmoid of each dequantized value */
+    double *exp_table;                      /**< exp of each dequantized value */
+} post_process_node_lut_t;
+
+/**
+ * @brief Affine mapping of boxes from model input coordinates to image coordinates.
+ *
+ * image x = (model x - pad_left) * scale_x + origin_x, and the same for y. Boxes are mapped to the pre-processed image for NMS,
+ * output boxes are rounded to integer pixels there and moved by (origin_x, origin_y), so they are the boxes of the pre-processed image
+ * moved by the origin. Then left/top are clipped to (min_x, min_y) and right/bottom are clipped to (max_x, max_y).
+ */
+typedef struct
+{
+    float scale_x;                          /**< image pixels per model input pixel in width, image width / resized width */
+    float scale_y;                          /**< image pixels per model input pixel in height, image height / resized height */
+    float pad_left;                         /**< pixels padding on left of model input */
+    float pad_top;                          /**< pixels padding on top of model input */
+    int origin_x;                           /**< x of the pre-processed image in the output image, e.g. x of the crop area, 0 for the pre-processed image itself */
+    int origin_y;                           /**< y of the pre-processed image in the output image, e.g. y of the crop area, 0 for the pre-processed image itself */
+    int min_x;                              /**< min x of output boxes */
+    int min_y;                              /**< min y of output boxes */
+    int max_x;                              /**< max x of output boxes */
+    int max_y;                              /**< max y of output boxes */
+} post_process_box_transform_t;
+
+/**
+ * @brief Reusable working buffers of the YOLO post-processing functions.
+ *
+ * Create it once for a model by post_process_yolo_create_context() and pass it to the '_with_context' functions for every frame,
+ * the buffers grow on the first frame and are reused afterwards. Release it by post_process_yolo_release_context().
+ */
+typedef struct
+{
+    int class_count;                        /**< number of classes the class buffers can hold */
+    int candidate_capacity;                 /**< number of boxes candidate_boxes and class_boxes can hold */
+    int *class_box_offset;                  /**< bucket boundary of each class in class_boxes (class_count + 1 entries) */
+    float *box_class_probs;                 /**< class probabilities of one grid cell */
+    kp_bounding_box_t *candidate_boxes;     /**< candidate boxes over threshold in decoding order */
+    kp_bounding_box_t *class_boxes;         /**< candidate boxes bucketed by class */
+    float *box_soa;                         /**< coordinates and areas of one class in structure-of-arrays form for NMS */
+    int cell_capacity;                      /**< number of grid cells the cell buffers can hold */
+    int *cell_index;                        /**< grid cells of one anchor whose objectness can pass the threshold */
+    float *cell_confidence;                 /**< activated objectness of the cells in cell_index */
+    kp_bounding_box_t *cell_boxes;          /**< decoded box of the cells in cell_index in image coordinates */
+    bool *cell_decoded;                     /**< whether the box of the cells in cell_index is decoded */
+    int node_lut_count;                     /**< number of output nodes node_luts can hold */
+    post_process_node_lut_t *node_luts;     /**< sigmoid/exp lookup tables of each output node, set by post_process_yolo_set_node_quantization() */
+    int pre_nms_top_k_per_class;            /**< max number of candidates of one class entering NMS, 0 for no limit */
+    int pre_nms_top_k;                      /**< max number of candidates of all classes entering NMS, 0 for no limit */
+} post_process_yolo_context_t;
+
+/**
+ * @brief Built-in YOLO post-processing functions.
+ */
+typedef enum
+{
+    POST_PROCESS_YOLO_V3 = 0,               /**< post_process_yolo_v3_with_context() */
+    POST_PROCESS_YOLO_V5_520,               /**< post_process_yolo_v5_520_with_context() */
+    POST_PROCESS_YOLO_V5_720,               /**< post_process_yolo_v5_720_with_context() */
+} post_process_yolo_type_t;
+
+#define POST_PROCESS_YOLO_MAX_HEAD 4        /**< MAX number of heads (output nodes) of a YOLO descriptor */
+#define POST_PROCESS_YOLO_MAX_ANCHOR 9      /**< MAX number of anchors of a head */
+
+/**
+ * @brief Activation functions applied to raw output values.
+ */
+typedef enum
+{
+    POST_PROCESS_ACTIVATION_NONE = 0,       /**< the value is used as it is */
+    POST_PROCESS_ACTIVATION_SIGMOID,        /**< 1 / (1 + exp(-x)) */
+    POST_PROCESS_ACTIVATION_EXP,            /**< exp(x) */
+} post_process_activation_t;
+
+/**
+ * @brief Box encodings of anchor-based YOLO heads, tx/ty/tw/th are the activated box values and stride is the grid cell size.
+ */
+typedef enum
+{
+    POST_PROCESS_YOLO_BOX_V3 = 0,           /**< x = (tx + col) * stride, w = tw * anchor_w, box = center -/+ size / 2 */
+    POST_PROCESS_YOLO_BOX_V5,               /**< x = (tx * 2 - 0.5 + col) * stride, w = (tw * 2)^2 * anchor_w, box = center -/+ size / 2 */
+    POST_PROCESS_YOLO_BOX_V5_LEFT_TOP,      /**< YOLO V5 with integer stride and double precision center, box = (center - size / 2, left/top + size), as YOLO V5 for KL720 */
+} post_process_yolo_box_encoding_t;
+
+/**
+ * @brief Anchor set of one head.
+ */
+typedef struct
+{
+    int anchor_count;                                       /**< number of anchors */
+    float anchors[POST_PROCESS_YOLO_MAX_ANCHOR][2];         /**< (width, height) of each anchor in model input pixels */
+    float stride;                                           /**< grid cell size in model input pixels, 0 for model input size / grid size */
+} post_process_yolo_head_t;
+
+/**
+ * @brief Descriptor of an anchor-based YOLO detector for post_process_yolo_generic_with_context().
+ *
+ * Head i decodes node_output[i] of shape 1 x C x H x W, where C is anchor_count x (5 + class count) channels of (x, y, w, h, objectness, classes...) for each anchor.
+ * The score of a class is activated class probability x activated objectness.
+ */
+typedef struct
+{
+    int head_count;                                         /**< number of heads */
+    post_process_yolo_head_t heads[POST_PROCESS_YOLO_MAX_HEAD]; /**< anchor set of each head */
+    uint32_t channel_ordering;                              /**< data order of the output nodes, KP_CHANNEL_ORDERING_HCW, KP_CHANNEL_ORDERING_CHW or KP_CHANNEL_ORDERING_HWC */
+    uint32_t box_encoding;                                  /**< enum post_process_yolo_box_encoding_t */
+    uint32_t xy_activation;                                 /**< enum post_process_activation_t of box x and y */
+    uint32_t wh_activation;                                 /**< enum post_process_activation_t of box width and height */
+    uint32_t objectness_activation;                         /**< enum post_process_activation_t of objectness */
+    uint32_t class_activation;                              /**< enum post_process_activation_t of class probabilities */
+    bool score_threshold_exclusive;                         /**< true: keep scores > threshold, false: keep scores >= threshold */
+    int max_candidate_count;                                /**< post-processing fails if candidates over threshold reach it, 0 for no limit */
+    double nms_thresh;                                      /**< IoU threshold of NMS */
+    int max_detection_per_class;                            /**< max number of boxes of one class after NMS, 0 for no limit */
+} post_process_yolo_descriptor_t;
+
+/**
+ * @brief Create a reusable YOLO post-processing context.
+ *
+ * @return the context, NULL if memory allocation failed.
+ */
+post_process_yolo_context_t *post_process_yolo_create_context(void);
+
+/**
+ * @brief Release a YOLO post-processing context.
+ *
+ * @param[in] context the context created by post_process_yolo_create_context().
+ */
+void post_process_yolo_release_context(post_process_yolo_context_t *context);
+
+/**
+ * @brief Limit the number of candidates entering NMS of the YOLO post-processing functions.
+ *
+ * Only the candidates with the highest scores are kept before NMS, per class and over all classes.
+ * Without limits (default), the results are the same as sorting and suppressing all candidates.
+ *
+ * @param[in] context the context created by post_process_yolo_create_context().
+ * @param[in] top_k_per_class max number of candidates of one class, 0 for no limit.
+ * @param[in] top_k max number of candidates of all classes, 0 for no limit.
+ */
+void post_process_yolo_set_pre_nms_top_k(post_process_yolo_context_t *context, int top_k_per_class, int top_k);
+
+/**
+ * @brief Tabulate sigmoid and exp of an output node for the YOLO post-processing functions (KL520 YOLO V3 and YOLO V5).
+ *
+ * The tables are built once for the fixed-point data type and the quantization factor of the node, calling it again with the same
+ * quantization only checks the cached tables, so it can be called for every frame. Nodes with channel-wise quantization are not tabulated.
+ *
+ * The results are the same as without the tables, values of 'node_output' which are not dequantized by this quantization are computed by exp().
+ *
+ * @param[in] context the context created by post_process_yolo_create_context().
+ * @param[in] node_idx output node index, the same index of 'node_output' in the '_with_context' functions.
+ * @param[in] node_view node view of the output node from kp_generic_inference_retrieve_node_view().
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_yolo_set_node_quantization(post_process_yolo_context_t *context, int node_idx, kp_inf_node_view_t *node_view);
+
+/**
+ * @brief Initialize the box mapping from model input coordinates to pre-processed image coordinates.
+ *
+ * The boxes are relative to the pre-processed image (the crop area if it is cropped), set origin_x/origin_y and the clip range
+ * afterwards to map them into another image, e.g. the whole image of a crop area.
+ *
+ * @param[out] box_transform the box mapping.
+ * @param[in] pre_proc_info hardware pre-process related info.
+ */
+void post_process_box_transform_init(post_process_box_transform_t *box_transform, kp_hw_pre_proc_info_t *pre_proc_info);
+
+/**
+ * @brief Get the descriptor of a built-in YOLO post-processing function.
+ *
+ * @param[in] type built-in YOLO post-processing function.
+ *
+ * @return the descriptor, NULL if type is unknown.
+ */
+const post_process_yolo_descriptor_t *post_process_yolo_builtin_descriptor(post_process_yolo_type_t type);
+
+/**
+ * @brief Anchor-based YOLO post-processing function configured by a descriptor.
+ *
+ * Boxes are decoded straight from the output nodes and mapped to image coordinates as they are decoded, then NMS is performed per class.
+ * With the descriptor from post_process_yolo_builtin_descriptor() and no box_transform, the result is the same as the built-in function.
+ *
+ * @param[in] context the context created by post_process_yolo_create_context().
+ * @param[in] descriptor the descriptor of the detector.
+ * @param[in] node_output floating-point output node arrays, it should come from kp_generic_inference_retrieve_node() in 'channel_ordering' of the descriptor.
+ * @param[in] num_output_node total number of output node, at most 'head_count' of the descriptor.
+ * @param[in] pre_proc_info hardware pre-process related info.
+ * @param[in] box_transform mapping of output boxes, NULL for the one from post_process_box_transform_init() of pre_proc_info.
+ * @param[in] thresh_value range from 0 ~ 1
+ * @param[out] yoloResult this is the yolo result output, users need to prepare a buffer of 'kp_yolo_result_t' for this.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_yolo_generic_with_context(post_process_yolo_context_t *context, const post_process_yolo_descriptor_t *descriptor,
+                                           kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                           kp_hw_pre_proc_info_t *pre_proc_info, const post_process_box_transform_t *box_transform,
+                                           float thresh_value, kp_yolo_result_t *yoloResult);
+
 /**
  * @brief YOLO V3 post-processing function for KL520.
  *
@@ -29,6 +241,23 @@
 int post_process_yolo_v3(kp_inf_float_node_output_t *node_output[], int num_output_node,
                          kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
 
+/**
+ * @brief YOLO V3 post-processing function for KL520 with a reusable context.
+ *
+ * Same result as post_process_yolo_v3(), candidates are bucketed by class in one pass and the buffers of 'context' are reused.
+ *
+ * @param[in] context the context created by post_process_yolo_create_context().
+ * @param[in] node_output floating-point output node arrays, it should come from kp_generic_inference_retrieve_node().
+ * @param[in] num_output_node total number of output node.
+ * @param[in] pre_proc_info hardware pre-process related info.
+ * @param[in] thresh_value range from 0 ~ 1
+ * @param[out] yoloResult this is the yolo result output, users need to prepare a buffer of 'kp_yolo_result_t' for this.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_yolo_v3_with_context(post_process_yolo_context_t *context, kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                      kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
+
 /**
  * @brief YOLO V5 post-processing function (with sigmoid) for KL520.
  *
@@ -43,6 +272,23 @@ int post_process_yolo_v3(kp_inf_float_node_output_t *node_output[], int num_outp
 int post_process_yolo_v5_520(kp_inf_float_node_output_t *node_output[], int num_output_node,
                              kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
 
+/**
+ * @brief YOLO V5 post-processing function (with sigmoid) for KL520 with a reusable context.
+ *
+ * Same result as post_process_yolo_v5_520(), candidates are bucketed by class in one pass and the buffers of 'context' are reused.
+ *
+ * @param[in] context the context created by post_process_yolo_create_context().
+ * @param[in] node_output floating-point output node arrays, it should come from kp_generic_inference_retrieve_node().
+ * @param[in] num_output_node total number of output node.
+ * @param[in] pre_proc_info hardware pre-process related info.
+ * @param[in] thresh_value range from 0 ~ 1
+ * @param[out] yoloResult this is the yolo result output, users need to prepare a buffer of 'kp_yolo_result_t' for this.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_yolo_v5_520_with_context(post_process_yolo_context_t *context, kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                          kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
+
 /**
  * @brief YOLO V5 post-processing function (without sigmoid) for KL720.
  *
@@ -56,3 +302,245 @@ int post_process_yolo_v5_520(kp_inf_float_node_output_t *node_output[], int num_
  */
 int post_process_yolo_v5_720(kp_inf_float_node_output_t *node_output[], int num_output_node,
                              kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
+
+/**
+ * @brief YOLO V5 post-processing function (without sigmoid) for KL720 with a reusable context.
+ *
+ * Same result as post_process_yolo_v5_720(), candidates are bucketed by class in one pass and the buffers of 'context' are reused.
+ *
+ * @param[in] context the context created by post_process_yolo_create_context().
+ * @param[in] node_output floating-point output node arrays, it should come from kp_generic_inference_retrieve_node().
+ * @param[in] num_output_node total number of output node.
+ * @param[in] pre_proc_info hardware pre-process related info.
+ * @param[in] thresh_value range from 0 ~ 1
+ * @param[out] yoloResult this is the yolo result output, users need to prepare a buffer of 'kp_yolo_result_t' for this.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_yolo_v5_720_with_context(post_process_yolo_context_t *context, kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                          kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
+
+#define POST_PROCESS_SSD_MAX_HEAD 6         /**< MAX number of heads (pairs of confidence and location nodes) of a SSD descriptor */
+#define POST_PROCESS_SSD_MAX_ANCHOR 6       /**< MAX number of prior boxes of a cell */
+
+/**
+ * @brief Prior boxes of one SSD head, each cell has 'anchor_count' square prior boxes centered on it.
+ */
+typedef struct
+{
+    int anchor_count;                                       /**< number of prior boxes of a cell */
+    float min_sizes[POST_PROCESS_SSD_MAX_ANCHOR];           /**< side length of each prior box in model input pixels */
+} post_process_ssd_head_t;
+
+/**
+ * @brief Descriptor of a SSD detector for post_process_ssd_with_context().
+ *
+ * Head i decodes node_output[2 * i] of shape 1 x (anchor_count x class count) x H x W for class logits of each prior box, class 0 is background,
+ * and node_output[2 * i + 1] of shape 1 x (anchor_count x 4) x H x W for (dx, dy, dw, dh) of each prior box.
+ * The score of a class is the softmax of the logits, boxes of class c are output as 'class_num' c - 1.
+ */
+typedef struct
+{
+    int head_count;                                         /**< number of heads */
+    post_process_ssd_head_t heads[POST_PROCESS_SSD_MAX_HEAD]; /**< prior boxes of each head */
+    uint32_t channel_ordering;                              /**< data order of the output nodes, KP_CHANNEL_ORDERING_HCW, KP_CHANNEL_ORDERING_CHW or KP_CHANNEL_ORDERING_HWC */
+    float center_variance;                                  /**< variance of prior box center offsets dx and dy */
+    float size_variance;                                    /**< variance of prior box log sizes dw and dh */
+    double nms_thresh;                                      /**< IoU threshold of NMS */
+    int max_detection_per_class;                            /**< max number of boxes of one class after NMS, 0 for no limit */
+} post_process_ssd_descriptor_t;
+
+/**
+ * @brief Get the descriptor of the KL520 face detection SSD with mask class (model ID 32 in res/models/KL520/ssd_fd_lm).
+ *
+ * The output boxes of class 0 are faces and class 1 are masked faces.
+ *
+ * Only the node layout (4 heads of 3x3, 6x6, 12x12 and 25x25 cells, 2 prior boxes of 3 classes each, confidence node before location node)
+ * is checked against the output nodes of the NEF. The prior box sizes and the variances are not in the NEF and are UNVERIFIED:
+ * the sizes are guessed from the head strides and the variances are the common SSD values 0.1 / 0.2. Compare the boxes with the ones
+ * of a known-good host implementation of the model before relying on them, and copy the descriptor to correct them.
+ *
+ * @return the descriptor.
+ */
+const post_process_ssd_descriptor_t *post_process_ssd_fd_mask_descriptor(void);
+
+/**
+ * @brief SSD post-processing function configured by a descriptor.
+ *
+ * Prior boxes are derived from the cell position, so only the boxes over threshold are decoded. A class logit which is too small
+ * against the largest other logit to reach the threshold rejects the prior box without computing softmax. NMS is performed per class.
+ *
+ * The decoder takes floating-point nodes and does not threshold the fixed-point values. The logit margin test does the early rejection
+ * on the dequantized logits instead, so each node is dequantized in full by kp_generic_inference_retrieve_float_node() first.
+ *
+ * @param[in] context the context created by post_process_yolo_create_context().
+ * @param[in] descriptor the descriptor of the detector.
+ * @param[in] node_output floating-point output node arrays, it should come from kp_generic_inference_retrieve_node() in 'channel_ordering' of the descriptor.
+ * @param[in] num_output_node total number of output node, 2 x 'head_count' of the descriptor.
+ * @param[in] pre_proc_info hardware pre-process related info.
+ * @param[in] box_transform mapping of output boxes, NULL for the one from post_process_box_transform_init() of pre_proc_info.
+ * @param[in] thresh_value range from 0 ~ 1
+ * @param[out] result the detected boxes, users need to prepare a buffer of 'kp_yolo_result_t' for this.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_ssd_with_context(post_process_yolo_context_t *context, const post_process_ssd_descriptor_t *descriptor,
+                                  kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                  kp_hw_pre_proc_info_t *pre_proc_info, const post_process_box_transform_t *box_transform,
+                                  float thresh_value, kp_yolo_result_t *result);
+
+/**
+ * @brief 5-point face landmark post-processing function (model ID 5 in res/models/KL520/ssd_fd_lm).
+ *
+ * node_output[0] holds 2 logits of (non-face, face) and node_output[1] holds (x, y) of 5 points relative to the inference crop of the face,
+ * a point is (x1 + x * width, y1 + y * height) of 'face_box'.
+ *
+ * @param[in] node_output floating-point output node arrays, it should come from kp_generic_inference_retrieve_node().
+ * @param[in] num_output_node total number of output node.
+ * @param[in] face_box the face box in image coordinates which is cropped for the landmark model, e.g. a box from post_process_ssd_with_context().
+ * @param[out] landmark landmark points in image coordinates and face score of the crop.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_face_landmark(kp_inf_float_node_output_t *node_output[], int num_output_node, kp_bounding_box_t *face_box,
+                               kp_landmark_result_t *landmark);
+
+/**
+ * @brief Top-k classification post-processing function on the fixed-point logits of one output node.
+ *
+ * The k largest logits are kept by a bounded heap over the fixed-point values without dequantizing the node,
+ * and softmax probabilities are computed only for them. The order and probabilities (up to float rounding) are those of softmax over the floating-point node.
+ *
+ * @param[in] node_output fixed-point output node of logits, it should come from kp_generic_inference_retrieve_fixed_node().
+ * @param[in] top_k max number of results.
+ * @param[out] results classes of the k largest logits in descending order of score, users need to prepare a buffer of 'top_k' results for this.
+ * @param[out] result_count number of results, the smaller of 'top_k' and the number of classes.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_classification_top_k(kp_inf_fixed_node_output_t *node_output, int top_k, kp_classification_result_t results[], int *result_count);
+
+/**
+ * @brief Top-k classification post-processing function for a batch of logits nodes, e.g. the same node of multiple crop boxes.
+ *
+ * @param[in] node_output fixed-point output nodes of logits, one for each batch item.
+ * @param[in] batch_size number of batch items.
+ * @param[in] top_k max number of results of each batch item.
+ * @param[out] results results of batch item i are results[i * top_k] ~ results[i * top_k + result_counts[i] - 1], users need to prepare a buffer of 'batch_size x top_k' results for this.
+ * @param[out] result_counts number of results of each batch item, users need to prepare a buffer of 'batch_size' counts for this.
+ *
+ * @return return 0 means all batch items are sucessful, otherwise failed.
+ */
+int post_process_classification_top_k_batch(kp_inf_fixed_node_output_t *node_output[], int batch_size, int top_k, kp_classification_result_t results[],
+                                            int result_counts[]);
+
+/**
+ * @brief One item of a post-processing batch, e.g. the output nodes of one crop box or of one device.
+ */
+typedef struct
+{
+    kp_inf_float_node_output_t **node_output;   /**< floating-point output node arrays of this item */
+    int num_output_node;                        /**< total number of output node */
+    kp_hw_pre_proc_info_t *pre_proc_info;       /**< hardware pre-process related info of this item */
+    kp_yolo_result_t *yolo_result;              /**< result slot of this item, prepared by users */
+    int status;                                 /**< return value of the post-processing function of this item */
+} post_process_yolo_batch_item_t;
+
+/**
+ * @brief Post-processing executor, a bounded pool of workers with one YOLO context per worker.
+ */
+typedef struct post_process_executor_s post_process_executor_t;
+
+/**
+ * @brief Create a post-processing executor.
+ *
+ * The calling thread of post_process_executor_run_yolo() is one of the workers, (worker_count - 1) threads are created here.
+ *
+ * @param[in] worker_count number of workers, 1 runs all items on the calling thread.
+ *
+ * @return the executor, NULL if failed.
+ */
+post_process_executor_t *post_process_executor_create(int worker_count);
+
+/**
+ * @brief Release a post-processing executor, its threads are joined.
+ *
+ * @param[in] executor the executor created by post_process_executor_create().
+ */
+void post_process_executor_release(post_process_executor_t *executor);
+
+/**
+ * @brief Tabulate sigmoid and exp of an output node for all workers, refer to post_process_yolo_set_node_quantization().
+ *
+ * @param[in] executor the executor created by post_process_executor_create().
+ * @param[in] node_idx output node index.
+ * @param[in] node_view node view of the output node from kp_generic_inference_retrieve_node_view().
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_executor_set_node_quantization(post_process_executor_t *executor, int node_idx, kp_inf_node_view_t *node_view);
+
+/**
+ * @brief Limit the number of candidates entering NMS for all workers, refer to post_process_yolo_set_pre_nms_top_k().
+ *
+ * @param[in] executor the executor created by post_process_executor_create().
+ * @param[in] top_k_per_class max number of candidates of one class, 0 for no limit.
+ * @param[in] top_k max number of candidates of all classes, 0 for no limit.
+ */
+void post_process_executor_set_pre_nms_top_k(post_process_executor_t *executor, int top_k_per_class, int top_k);
+
+/**
+ * @brief Post-process a batch of items in parallel.
+ *
+ * Each idle worker takes the next unprocessed item, runs decoding, NMS and boxes scaling of it, and writes the result to the
+ * 'yolo_result' of the item, so the results are the same as post-processing the items one by one. This function returns after all items are done.
+ *
+ * @param[in] executor the executor created by post_process_executor_create().
+ * @param[in] type post-processing function of the items.
+ * @param[in] thresh_value range from 0 ~ 1
+ * @param[in,out] items batch items, 'status' of each item is set to the return value of its post-processing function.
+ * @param[in] item_count number of items.
+ *
+ * @return return 0 means all items are sucessful, otherwise failed.
+ */
+int post_process_executor_run_yolo(post_process_executor_t *executor, post_process_yolo_type_t type, float thresh_value,
+                                   post_process_yolo_batch_item_t items[], int item_count);
+
+/**
+ * @brief Multi-object IoU tracker, keeps an identity for each object over the detection results of consecutive frames.
+ *
+ * Every track predicts its box by constant velocity, the detections of a frame are matched to the predicted boxes of the same class
+ * greedily in IoU order. Tracks overlapping a detection are found by a uniform grid over the predicted boxes instead of comparing all pairs.
+ */
+typedef struct post_process_tracker_s post_process_tracker_t;
+
+/**
+ * @brief Create a tracker.
+ *
+ * @param[in] iou_thresh min IoU (0 ~ 1] of a detection and a predicted box to be matched.
+ * @param[in] max_lost_frames a track is removed after it is not matched in more than max_lost_frames consecutive frames.
+ *
+ * @return the tracker, NULL if failed.
+ */
+post_process_tracker_t *post_process_tracker_create(float iou_thresh, int max_lost_frames);
+
+/**
+ * @brief Release a tracker.
+ *
+ * @param[in] tracker the tracker created by post_process_tracker_create().
+ */
+void post_process_tracker_release(post_process_tracker_t *tracker);
+
+/**
+ * @brief Track the detections of the next frame.
+ *
+ * Matched tracks are updated by their detections, unmatched detections start new tracks.
+ *
+ * @param[in] tracker the tracker created by post_process_tracker_create().
+ * @param[in] boxes detections of the frame in image coordinates, e.g. 'boxes' of kp_yolo_result_t.
+ * @param[in] box_count number of detections.
+ * @param[out] track_ids track ID of each detection (starts from 1), users need to prepare a buffer of 'box_count' IDs for this.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int post_process_tracker_update(post_process_tracker_t *tracker, kp_bounding_box_t boxes[], int box_count, uint32_t track_ids[]);
@@ -0,0 +1,799 @@
+/**
+ * @file        raw_output_builder.c
+ * @brief       build synthetic RAW output buffers of generic inference
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raw_output_builder.h"
+
+/* RAW output header and node metadata are internal structures of kplus */
+#include "internal_func.h"
+#include "kdp2_inf_generic_raw.h"
+
+#define RAW_OUTPUT_DATA_ALIGNMENT 16
+
+typedef enum
+{
+    STORAGE_INT8 = 0,                       // one int8 for each scalar
+    STORAGE_INT16,                          // one int16 for each scalar
+    STORAGE_INT16_EVEN,                     // one int16 for each scalar, the lowest bit is not used (KL730/KL830 16-bit layouts)
+    STORAGE_HL                              // 16 low bytes and then 16 high bytes for each 16 scalars
+} storage_t;
+
+typedef struct
+{
+    storage_t storage;
+    uint32_t num_data;
+    uint32_t stride_onnx[KP_MAX_NODE_VIEW_SHAPE_LEN];
+    uint32_t stride_npu[KP_MAX_NODE_VIEW_SHAPE_LEN];
+    int32_t channel_group_axis;             // -1 if not grouped
+    uint32_t channel_group_stride;
+    uint32_t npu_data_len;                  // in bytes
+    uint32_t quantization_parameters_len;
+    int32_t *radix;
+    float *scale;
+    int32_t *fixed_values;                  // in the order of 'shape'
+} node_layout_t;
+
+/* growable buffer, the content is addressed by offset as it moves on each growth */
+typedef struct
+{
+    uint8_t *data;
+    uint32_t size;
+    uint32_t capacity;
+} byte_buffer_t;
+
+static uint32_t _random_state = 1;
+
+static uint32_t random_next()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return _random_state;
+}
+
+static int32_t random_range(int32_t min, int32_t max)
+{
+    return min + (int32_t)(random_next() % (uint32_t)(max - min + 1));
+}
+
+static uint32_t align_up(uint32_t value, uint32_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/* reserve 'size' zeroed bytes at an 'alignment' aligned offset and return the offset, 0xffffffff if out of memory */
+static uint32_t byte_buffer_reserve(byte_buffer_t *buffer, uint32_t size, uint32_t alignment)
+{
+    uint32_t offset = align_up(buffer->size, alignment);
+
+    if (offset + size > buffer->capacity)
+    {
+        uint32_t capacity = (buffer->capacity * 2 > offset + size) ? buffer->capacity * 2 : offset + size;
+        uint8_t *data = realloc(buffer->data, capacity);
+
+        if (NULL == data)
+            return 0xffffffff;
+
+        memset(data + buffer->capacity, 0, capacity - buffer->capacity);
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    buffer->size = offset + size;
+
+    return offset;
+}
+
+static float pow2(int exp)
+{
+    if (0 <= exp)
+        return (float)(0x1ULL << exp);
+    else
+        return (float)1 / (float)(0x1ULL << abs(exp));
+}
+
+static bool is_version_2(uint32_t product_id)
+{
+    return (KP_DEVICE_KL730 == product_id) || (KP_DEVICE_KL830 == product_id);
+}
+
+static int32_t get_scale_dtype(const raw_output_node_spec_t *node_spec)
+{
+    return (0 == node_spec->scale_dtype) ? KP_DTYPE_FLOAT32 : node_spec->scale_dtype;
+}
+
+static int32_t get_radix_dtype(const raw_output_node_spec_t *node_spec)
+{
+    return (0 == node_spec->radix_dtype) ? KP_DTYPE_INT32 : node_spec->radix_dtype;
+}
+
+static uint32_t get_dtype_size(int32_t dtype)
+{
+    switch (dtype)
+    {
+    case KP_DTYPE_INT8:
+    case KP_DTYPE_UINT8:
+        return 1;
+    case KP_DTYPE_INT16:
+    case KP_DTYPE_UINT16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+static bool is_integer_dtype(int32_t dtype)
+{
+    return KP_DTYPE_FLOAT32 != dtype;
+}
+
+/* scale as kplus reads it from the RAW output */
+static float store_scale(uint8_t *scale_array, uint32_t idx, int32_t dtype, float scale)
+{
+    int32_t integer_scale = (int32_t)(scale + 0.5f);
+
+    switch (dtype)
+    {
+    case KP_DTYPE_INT8:
+        ((int8_t *)scale_array)[idx] = (int8_t)integer_scale;
+        return (float)((int8_t *)scale_array)[idx];
+    case KP_DTYPE_INT16:
+        ((int16_t *)scale_array)[idx] = (int16_t)integer_scale;
+        return (float)((int16_t *)scale_array)[idx];
+    case KP_DTYPE_INT32:
+        ((int32_t *)scale_array)[idx] = integer_scale;
+        return (float)((int32_t *)scale_array)[idx];
+    case KP_DTYPE_UINT8:
+        ((uint8_t *)scale_array)[idx] = (uint8_t)integer_scale;
+        return (float)((uint8_t *)scale_array)[idx];
+    case KP_DTYPE_UINT16:
+        ((uint16_t *)scale_array)[idx] = (uint16_t)integer_scale;
+        return (float)((uint16_t *)scale_array)[idx];
+    case KP_DTYPE_UINT32:
+        ((uint32_t *)scale_array)[idx] = (uint32_t)integer_scale;
+        return (float)((uint32_t *)scale_array)[idx];
+    default:
+        ((float *)scale_array)[idx] = scale;
+        return scale;
+    }
+}
+
+static void store_radix(uint8_t *radix_array, uint32_t idx, int32_t dtype, int32_t radix)
+{
+    switch (dtype)
+    {
+    case KP_DTYPE_INT8:
+        ((int8_t *)radix_array)[idx] = (int8_t)radix;
+        break;
+    case KP_DTYPE_INT16:
+        ((int16_t *)radix_array)[idx] = (int16_t)radix;
+        break;
+    default:
+        ((int32_t *)radix_array)[idx] = radix;
+        break;
+    }
+}
+
+static uint32_t get_data_format(uint32_t product_id, uint32_t data_layout)
+{
+    switch (product_id)
+    {
+    case KP_DEVICE_KL520:
+        return DATA_FMT_KL520_16W1C8B;
+    case KP_DEVICE_KL720:
+        switch (data_layout)
+        {
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:    return DATA_FMT_KL720_1W16C8B;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:    return DATA_FMT_KL720_8W1C16B;
+        default:                                    return DATA_FMT_KL720_16W1C8B;
+        }
+    case KP_DEVICE_KL630:
+        switch (data_layout)
+        {
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:    return DATA_FMT_KL630_1W16C8B;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:    return DATA_FMT_KL630_8W1C16B;
+        default:                                    return DATA_FMT_KL630_16W1C8B;
+        }
+    default:
+        switch (data_layout)
+        {
+        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:                 return DATA_FMT_KL730_4W4C8B;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:                return DATA_FMT_KL730_1W16C8B;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B:                return DATA_FMT_KL730_16W1C8B;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:                return DATA_FMT_KL730_8W1C16B;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:               return DATA_FMT_KL730_4W4C8BHL;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:              return DATA_FMT_KL730_1W16C8BHL;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:              return DATA_FMT_KL730_16W1C8BHL;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B:                 return DATA_FMT_KL730_RAW8;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:                return DATA_FMT_KL730_RAW16;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT:     return DATA_FMT_KL730_1W16C8B_CH_COMPACT;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:   return DATA_FMT_KL730_1W16C8BHL_CH_COMPACT;
+        default:                                                return DATA_FMT_KL730_UNKNOWN;
+        }
+    }
+}
+
+uint32_t raw_output_get_quantization_parameters_len(uint32_t product_id, const raw_output_node_spec_t *node_spec)
+{
+    if (is_version_2(product_id) && node_spec->per_channel)
+        return node_spec->shape[node_spec->channel_axis];
+
+    return 1;
+}
+
+/* NPU data access of a node, the same rules as the device writes them (and kplus reads them) */
+static int get_node_layout(uint32_t product_id, const raw_output_node_spec_t *node_spec, node_layout_t *layout)
+{
+    uint32_t shape_len      = node_spec->shape_len;
+    uint32_t channel_axis   = is_version_2(product_id) ? node_spec->channel_axis : 1;
+    uint32_t width_axis     = shape_len - 1;
+    uint32_t width_aligned  = 0;
+    uint32_t alignment      = 1;
+    uint32_t max_offset     = 0;
+
+    memset(layout, 0, sizeof(node_layout_t));
+    layout->channel_group_axis = -1;
+    layout->num_data = 1;
+
+    if ((0 == shape_len) || (KP_MAX_NODE_VIEW_SHAPE_LEN < shape_len) || (channel_axis >= shape_len) ||
+        (!is_version_2(product_id) && (4 != shape_len)))
+    {
+        printf("Error! %s(): invalid shape\n", __FUNCTION__);
+        return -1;
+    }
+
+    for (int axis = shape_len - 1; axis >= 0; axis--)
+    {
+        layout->stride_onnx[axis] = layout->num_data;
+        layout->num_data *= node_spec->shape[axis];
+    }
+
+    switch (node_spec->data_layout)
+    {
+    case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
+        layout->storage = is_version_2(product_id) ? STORAGE_INT16_EVEN : STORAGE_INT16;
+        alignment = 8;
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
+        layout->storage = STORAGE_INT16_EVEN;
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+        layout->storage = STORAGE_HL;
+        alignment = 4;
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+        layout->storage = STORAGE_HL;
+        alignment = 16;
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:
+        layout->storage = STORAGE_INT8;
+        alignment = 4;
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B:
+        layout->storage = STORAGE_INT8;
+        break;
+    default:
+        layout->storage = STORAGE_INT8;
+        alignment = 16;
+        break;
+    }
+
+    if ((KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B == node_spec->data_layout) ||
+        (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL == node_spec->data_layout))
+    {
+        /* groups of 16 channels, each group is (axes after the channel axis) x 16 channels */
+        uint32_t group_size = 16;
+
+        layout->stride_npu[channel_axis] = 1;
+        for (int axis = shape_len - 1; axis > (int)channel_axis; axis--)
+        {
+            layout->stride_npu[axis] = group_size;
+            group_size *= node_spec->shape[axis];
+        }
+
+        /* axes before the channel axis are 1, their strides are one group as the largest stride is the group stride */
+        for (int axis = channel_axis - 1; axis >= 0; axis--)
+            layout->stride_npu[axis] = group_size;
+
+        layout->channel_group_axis = channel_axis;
+        layout->channel_group_stride = group_size - 16;
+    }
+    else if ((KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT == node_spec->data_layout) ||
+             (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT == node_spec->data_layout))
+    {
+        /* compact channels: channel axis innermost, other axes in order */
+        uint32_t stride = node_spec->shape[channel_axis];
+
+        layout->stride_npu[channel_axis] = 1;
+        for (int axis = shape_len - 1; axis >= 0; axis--)
+        {
+            if (axis == (int)channel_axis)
+                continue;
+
+            layout->stride_npu[axis] = stride;
+            stride *= node_spec->shape[axis];
+        }
+    }
+    else
+    {
+        /* rows of aligned width */
+        width_aligned = align_up(node_spec->shape[width_axis], alignment);
+
+        layout->stride_npu[width_axis] = 1;
+        if ((KP_DEVICE_KL520 == product_id) && (4 == shape_len))
+        {
+            /* height x channel x width */
+            layout->stride_npu[1] = width_aligned;
+            layout->stride_npu[2] = node_spec->shape[1] * width_aligned;
+            layout->stride_npu[0] = node_spec->shape[2] * node_spec->shape[1] * width_aligned;
+        }
+        else
+        {
+            uint32_t stride = width_aligned;
+
+            for (int axis = shape_len - 2; axis >= 0; axis--)
+            {
+                layout->stride_npu[axis] = stride;
+                stride *= node_spec->shape[axis];
+            }
+        }
+    }
+
+    /* the device writes whole aligned rows and groups, so the NPU data ends after the last (padded) row */
+    for (uint32_t axis = 0; axis < shape_len; axis++)
+        max_offset += (node_spec->shape[axis] - 1) * layout->stride_npu[axis];
+
+    if (0 <= layout->channel_group_axis)
+        max_offset += ((node_spec->shape[channel_axis] - 1) >> 4) * layout->channel_group_stride + 15;
+    else if (0 != width_aligned)
+        max_offset += width_aligned - node_spec->shape[width_axis];
+
+    switch (layout->storage)
+    {
+    case STORAGE_INT8:
+        layout->npu_data_len = max_offset + 1;
+        break;
+    case STORAGE_INT16:
+    case STORAGE_INT16_EVEN:
+        layout->npu_data_len = (max_offset + 1) * 2;
+        break;
+    case STORAGE_HL:
+        layout->npu_data_len = ((max_offset >> 4) + 1) * 32;
+        break;
+    }
+
+    layout->quantization_parameters_len = raw_output_get_quantization_parameters_len(product_id, node_spec);
+
+    return 0;
+}
+
+static void release_node_layouts(node_layout_t *layouts, uint32_t node_count)
+{
+    if (NULL == layouts)
+        return;
+
+    for (uint32_t i = 0; i < node_count; i++)
+    {
+        free(layouts[i].radix);
+        free(layouts[i].scale);
+        free(layouts[i].fixed_values);
+    }
+
+    free(layouts);
+}
+
+/* random quantization parameters and fixed-point values of a node, and the floating-point values they stand for */
+static int generate_node_values(uint32_t product_id, const raw_output_node_spec_t *node_spec, node_layout_t *layout, float *expected_values)
+{
+    int32_t scale_dtype     = is_version_2(product_id) ? get_scale_dtype(node_spec) : KP_DTYPE_FLOAT32;
+    uint8_t scale_value[4]  = {0};
+    uint32_t channel_stride = 1;
+
+    layout->radix           = calloc(layout->quantization_parameters_len, sizeof(int32_t));
+    layout->scale           = calloc(layout->quantization_parameters_len, sizeof(float));
+    layout->fixed_values    = calloc(layout->num_data, sizeof(int32_t));
+
+    if ((NULL == layout->radix) || (NULL == layout->scale) || (NULL == layout->fixed_values))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < layout->quantization_parameters_len; i++)
+    {
+        float scale = (NULL != node_spec->scale) ? node_spec->scale[i] :
+                      is_integer_dtype(scale_dtype) ? (float)random_range(1, 100) : (float)random_range(250, 2000) / 1000.0f;
+
+        layout->radix[i] = (NULL != node_spec->radix) ? node_spec->radix[i] : random_range(-4, 12);
+        layout->scale[i] = store_scale(scale_value, 0, scale_dtype, scale);
+    }
+
+    if (1 < layout->quantization_parameters_len)
+        channel_stride = layout->stride_onnx[node_spec->channel_axis];
+
+    for (uint32_t i = 0; i < layout->num_data; i++)
+    {
+        uint32_t idx = (1 < layout->quantization_parameters_len) ? (i / channel_stride) % layout->quantization_parameters_len : 0;
+        int32_t fixed_value = 0;
+
+        switch (layout->storage)
+        {
+        case STORAGE_INT8:
+            fixed_value = random_range(-128, 127);
+            break;
+        case STORAGE_INT16:
+            fixed_value = random_range(-32768, 32767);
+            break;
+        case STORAGE_INT16_EVEN:
+        case STORAGE_HL:
+            fixed_value = random_range(-16384, 16383) * 2;
+            break;
+        }
+
+        layout->fixed_values[i] = fixed_value;
+
+        if (NULL != expected_values)
+            expected_values[i] = (float)fixed_value / (float)(layout->scale[idx] * pow2(layout->radix[idx]));
+    }
+
+    return 0;
+}
+
+static void write_npu_data(const raw_output_node_spec_t *node_spec, const node_layout_t *layout, uint8_t *npu_data)
+{
+    int32_t index[KP_MAX_NODE_VIEW_SHAPE_LEN] = {0};
+
+    for (uint32_t i = 0; i < layout->num_data; i++)
+    {
+        uint32_t offset = 0;
+        int32_t fixed_value = layout->fixed_values[i];
+
+        for (uint32_t axis = 0; axis < node_spec->shape_len; axis++)
+            offset += index[axis] * layout->stride_npu[axis];
+
+        if (0 <= layout->channel_group_axis)
+            offset += (index[layout->channel_group_axis] >> 4) * layout->channel_group_stride;
+
+        switch (layout->storage)
+        {
+        case STORAGE_INT8:
+            ((int8_t *)npu_data)[offset] = (int8_t)fixed_value;
+            break;
+        case STORAGE_INT16:
+        case STORAGE_INT16_EVEN:
+            ((int16_t *)npu_data)[offset] = (int16_t)fixed_value;
+            break;
+        case STORAGE_HL:
+        {
+            /* value = ((low & 0x7f) + (high << 7)) << 1 */
+            uint32_t hl_offset = ((offset >> 4) << 5) + (offset & 15);
+            int32_t half_value = fixed_value / 2;
+
+            npu_data[hl_offset] = (uint8_t)(half_value & 0x7f);
+            npu_data[hl_offset + 16] = (uint8_t)((half_value >> 7) & 0xff);
+        }
+        break;
+        }
+
+        for (int axis = node_spec->shape_len - 1; axis >= 0; axis--)
+        {
+            if (++index[axis] < node_spec->shape[axis])
+                break;
+
+            index[axis] = 0;
+        }
+    }
+}
+
+static int build_raw_output_v1(uint32_t product_id, const raw_output_node_spec_t *node_specs, node_layout_t *layouts, uint32_t node_count, byte_buffer_t *buffer)
+{
+    uint32_t header_offset  = byte_buffer_reserve(buffer, sizeof(kdp2_ipc_generic_raw_result_t), 4);
+    uint32_t nodes_offset   = 0;
+    uint32_t data_offset    = 0;
+    uint32_t start_offset   = 0;
+
+    if (0xffffffff == header_offset)
+        return -1;
+
+    if (KP_DEVICE_KL520 == product_id)
+    {
+        _kl520_output_node_metadata_t *node_metadata = NULL;
+
+        nodes_offset = byte_buffer_reserve(buffer, 4 + node_count * sizeof(_kl520_output_node_metadata_t), 1);
+        if (0xffffffff == nodes_offset)
+            return -1;
+
+        /* NPU data of the nodes follow one another without alignment */
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            data_offset = byte_buffer_reserve(buffer, layouts[i].npu_data_len, 1);
+            if (0xffffffff == data_offset)
+                return -1;
+
+            write_npu_data(&node_specs[i], &layouts[i], buffer->data + data_offset);
+        }
+
+        *(uint32_t *)(buffer->data + nodes_offset) = node_count;
+        node_metadata = (_kl520_output_node_metadata_t *)(buffer->data + nodes_offset + 4);
+
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            node_metadata[i].height = node_specs[i].shape[2];
+            node_metadata[i].channel = node_specs[i].shape[1];
+            node_metadata[i].width = node_specs[i].shape[3];
+            node_metadata[i].radix = layouts[i].radix[0];
+            node_metadata[i].scale = layouts[i].scale[0];
+            node_metadata[i].data_layout = get_data_format(product_id, node_specs[i].data_layout);
+        }
+    }
+    else
+    {
+        uint32_t res_size = (KP_DEVICE_KL720 == product_id) ? sizeof(_720_raw_cnn_res_t) : sizeof(_630_raw_cnn_res_t);
+        uint32_t data_offsets[40] = {0};
+
+        if (40 < node_count)
+        {
+            printf("Error! %s(): at most 40 nodes\n", __FUNCTION__);
+            return -1;
+        }
+
+        nodes_offset = byte_buffer_reserve(buffer, res_size, 4);
+        if (0xffffffff == nodes_offset)
+            return -1;
+
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            data_offsets[i] = byte_buffer_reserve(buffer, layouts[i].npu_data_len, RAW_OUTPUT_DATA_ALIGNMENT);
+            if (0xffffffff == data_offsets[i])
+                return -1;
+
+            write_npu_data(&node_specs[i], &layouts[i], buffer->data + data_offsets[i]);
+        }
+
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            uint32_t scale_bits = 0;
+
+            start_offset = data_offsets[i] - (nodes_offset + res_size);
+            memcpy(&scale_bits, &layouts[i].scale[0], sizeof(float));
+
+            if (KP_DEVICE_KL720 == product_id)
+            {
+                _720_raw_cnn_res_t *raw_res = (_720_raw_cnn_res_t *)(buffer->data + nodes_offset);
+                _720_raw_onode_t *onode = &raw_res->onode_a[i];
+
+                raw_res->total_nodes = node_count;
+                onode->start_offset = start_offset;
+                onode->buf_len = layouts[i].npu_data_len;
+                onode->node_id = i;
+                onode->data_format = get_data_format(product_id, node_specs[i].data_layout);
+                onode->row_length = node_specs[i].shape[2];
+                onode->col_length = node_specs[i].shape[3];
+                onode->ch_length = node_specs[i].shape[1];
+                onode->output_index = i;
+                onode->output_radix = (uint32_t)layouts[i].radix[0];
+                onode->output_scale = scale_bits;
+            }
+            else
+            {
+                _630_raw_cnn_res_t *raw_res = (_630_raw_cnn_res_t *)(buffer->data + nodes_offset);
+                _630_raw_onode_t *onode = &raw_res->onode_a[i];
+
+                raw_res->total_nodes = node_count;
+                onode->idx = i;
+                onode->fmt = get_data_format(product_id, node_specs[i].data_layout);
+                onode->batch = node_specs[i].shape[0];
+                onode->ch_length = node_specs[i].shape[1];
+                onode->row_length = node_specs[i].shape[2];
+                onode->col_length = node_specs[i].shape[3];
+                onode->buf_len = layouts[i].npu_data_len;
+                onode->scale = scale_bits;
+                onode->radix = (uint32_t)layouts[i].radix[0];
+                onode->start_offset = start_offset;
+                onode->buf_aligned_len = align_up(layouts[i].npu_data_len, RAW_OUTPUT_DATA_ALIGNMENT);
+                onode->quant_vect_len = 1;
+            }
+        }
+
+        if (KP_DEVICE_KL720 == product_id)
+            ((_720_raw_cnn_res_t *)(buffer->data + nodes_offset))->total_raw_len = buffer->size - nodes_offset;
+        else
+            ((_630_raw_cnn_res_t *)(buffer->data + nodes_offset))->total_raw_len = buffer->size - nodes_offset;
+    }
+
+    kdp2_ipc_generic_raw_result_t *raw_result = (kdp2_ipc_generic_raw_result_t *)(buffer->data + header_offset);
+
+    raw_result->header_stamp.magic_type = KDP2_MAGIC_TYPE_INFERENCE;
+    raw_result->header_stamp.total_size = buffer->size;
+    raw_result->num_of_pre_proc_info = 1;
+    raw_result->product_id = product_id;
+    raw_result->is_last_crop = 1;
+
+    return 0;
+}
+
+static int build_raw_output_v2(uint32_t product_id, const raw_output_node_spec_t *node_specs, node_layout_t *layouts, uint32_t node_count, byte_buffer_t *buffer)
+{
+    uint32_t header_offset      = byte_buffer_reserve(buffer, sizeof(kdp2_ipc_generic_raw_result_t_v2) + sizeof(kp_hw_pre_proc_info_t), 4);
+    uint32_t npu_header_offset  = byte_buffer_reserve(buffer, sizeof(npu_data_header_t), 4);
+    uint32_t node_header_offset = byte_buffer_reserve(buffer, node_count * sizeof(npu_data_single_node_header_v2_t), 4);
+    uint32_t data_base          = npu_header_offset + sizeof(npu_data_header_t);
+
+    if ((0xffffffff == header_offset) || (0xffffffff == npu_header_offset) || (0xffffffff == node_header_offset))
+        return -1;
+
+    for (uint32_t i = 0; i < node_count; i++)
+    {
+        const raw_output_node_spec_t *node_spec = &node_specs[i];
+        node_layout_t *layout = &layouts[i];
+        int32_t radix_dtype = get_radix_dtype(node_spec);
+        int32_t scale_dtype = get_scale_dtype(node_spec);
+        char name[32];
+
+        snprintf(name, sizeof(name), "output_node_%u", i);
+
+        uint32_t name_offset        = byte_buffer_reserve(buffer, strlen(name) + 1, 1);
+        uint32_t shape_offset       = byte_buffer_reserve(buffer, node_spec->shape_len * sizeof(int32_t), 4);
+        uint32_t stride_onnx_offset = byte_buffer_reserve(buffer, node_spec->shape_len * sizeof(uint32_t), 4);
+        uint32_t stride_npu_offset  = byte_buffer_reserve(buffer, node_spec->shape_len * sizeof(uint32_t), 4);
+        uint32_t radix_offset       = byte_buffer_reserve(buffer, layout->quantization_parameters_len * get_dtype_size(radix_dtype), 4);
+        uint32_t scale_offset       = byte_buffer_reserve(buffer, layout->quantization_parameters_len * get_dtype_size(scale_dtype), 4);
+        uint32_t npu_data_offset    = byte_buffer_reserve(buffer, layout->npu_data_len, RAW_OUTPUT_DATA_ALIGNMENT);
+
+        if ((0xffffffff == name_offset) || (0xffffffff == shape_offset) || (0xffffffff == stride_onnx_offset) ||
+            (0xffffffff == stride_npu_offset) || (0xffffffff == radix_offset) || (0xffffffff == scale_offset) ||
+            (0xffffffff == npu_data_offset))
+            return -1;
+
+        strcpy((char *)(buffer->data + name_offset), name);
+        memcpy(buffer->data + shape_offset, node_spec->shape, node_spec->shape_len * sizeof(int32_t));
+        memcpy(buffer->data + stride_onnx_offset, layout->stride_onnx, node_spec->shape_len * sizeof(uint32_t));
+        memcpy(buffer->data + stride_npu_offset, layout->stride_npu, node_spec->shape_len * sizeof(uint32_t));
+
+        for (uint32_t idx = 0; idx < layout->quantization_parameters_len; idx++)
+        {
+            store_radix(buffer->data + radix_offset, idx, radix_dtype, layout->radix[idx]);
+            store_scale(buffer->data + scale_offset, idx, scale_dtype, layout->scale[idx]);
+        }
+
+        write_npu_data(node_spec, layout, buffer->data + npu_data_offset);
+
+        npu_data_single_node_header_v2_t *node_header = &((npu_data_single_node_header_v2_t *)(buffer->data + node_header_offset))[i];
+
+        node_header->index = i;
+        node_header->name_len = strlen(name);
+        node_header->name_start_offset = name_offset - data_base;
+        node_header->data_layout = get_data_format(product_id, node_spec->data_layout);
+        node_header->shape_len = node_spec->shape_len;
+        node_header->shape_data_type = KP_DTYPE_INT32;
+        node_header->shape_start_offset = shape_offset - data_base;
+        node_header->stride_onnx_data_type = KP_DTYPE_UINT32;
+        node_header->stride_onnx_start_offset = stride_onnx_offset - data_base;
+        node_header->stride_npu_data_type = KP_DTYPE_UINT32;
+        node_header->stride_npu_start_offset = stride_npu_offset - data_base;
+        node_header->quantized_axis = node_spec->channel_axis;
+        node_header->quantized_parameters_len = layout->quantization_parameters_len;
+        node_header->radix_data_type = radix_dtype;
+        node_header->radix_start_offset = radix_offset - data_base;
+        node_header->scale_data_type = scale_dtype;
+        node_header->scale_start_offset = scale_offset - data_base;
+        node_header->npu_data_len = layout->npu_data_len;
+        node_header->npu_data_start_offset = npu_data_offset - data_base;
+    }
+
+    npu_data_header_t *npu_data_header = (npu_data_header_t *)(buffer->data + npu_header_offset);
+
+    npu_data_header->npu_data_schema_version = NPU_DATA_SCHEMA_VERSION_2;
+    npu_data_header->data_size = buffer->size - data_base;
+    npu_data_header->npu_data_node_num = node_count;
+
+    kdp2_ipc_generic_raw_result_t_v2 *raw_result = (kdp2_ipc_generic_raw_result_t_v2 *)(buffer->data + header_offset);
+
+    raw_result->header_stamp.magic_type = KDP2_MAGIC_TYPE_INFERENCE_V2;
+    raw_result->header_stamp.total_size = buffer->size;
+    raw_result->product_id = product_id;
+    raw_result->is_last_crop = 1;
+    raw_result->num_of_pre_proc_info = 1;
+    raw_result->pre_proc_info_offset = sizeof(kdp2_ipc_generic_raw_result_t_v2);
+    raw_result->raw_data_offset = npu_header_offset;
+
+    return 0;
+}
+
+uint8_t *raw_output_build(uint32_t product_id, const raw_output_node_spec_t *node_specs, uint32_t node_count, uint32_t seed,
+                          float **expected_values, uint32_t *buffer_size)
+{
+    byte_buffer_t buffer = {NULL, 0, 0};
+    node_layout_t *layouts = NULL;
+    int ret = 0;
+
+    if ((NULL == node_specs) || (0 == node_count))
+    {
+        printf("Error! %s(): no output node\n", __FUNCTION__);
+        return NULL;
+    }
+
+    if ((KP_DEVICE_KL520 != product_id) && (KP_DEVICE_KL720 != product_id) && (KP_DEVICE_KL630 != product_id) && !is_version_2(product_id))
+    {
+        printf("Error! %s(): product id 0x%X is not supported\n", __FUNCTION__, product_id);
+        return NULL;
+    }
+
+    _random_state = (0 == seed) ? 1 : seed;
+
+    if (NULL != expected_values)
+        memset(expected_values, 0, node_count * sizeof(float *));
+
+    layouts = calloc(node_count, sizeof(node_layout_t));
+    if (NULL == layouts)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; (0 == ret) && (i < node_count); i++)
+    {
+        ret = get_node_layout(product_id, &node_specs[i], &layouts[i]);
+        if (0 != ret)
+            break;
+
+        if (NULL != expected_values)
+        {
+            expected_values[i] = malloc(layouts[i].num_data * sizeof(float));
+            if (NULL == expected_values[i])
+            {
+                printf("Error! %s(): out of memory\n", __FUNCTION__);
+                ret = -1;
+                break;
+            }
+        }
+
+        ret = generate_node_values(product_id, &node_specs[i], &layouts[i], (NULL != expected_values) ? expected_values[i] : NULL);
+    }
+
+    if (0 == ret)
+    {
+        if (is_version_2(product_id))
+            ret = build_raw_output_v2(product_id, node_specs, layouts, node_count, &buffer);
+        else
+            ret = build_raw_output_v1(product_id, node_specs, layouts, node_count, &buffer);
+
+        if (0 != ret)
+            printf("Error! %s(): out of memory\n", __FUNCTION__);
+    }
+
+    release_node_layouts(layouts, node_count);
+
+    if (0 != ret)
+    {
+        free(buffer.data);
+
+        if (NULL != expected_values)
+        {
+            for (uint32_t i = 0; i < node_count; i++)
+            {
+                free(expected_values[i]);
+                expected_values[i] = NULL;
+            }
+        }
+
+        return NULL;
+    }
+
+    if (NULL != buffer_size)
+        *buffer_size = buffer.size;
+
+    return buffer.data;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file        raw_output_builder.h
+ * @brief       build synthetic RAW output buffers of generic inference
+ *
+ * A built buffer has the same format as the RAW output received by kp_generic_image_inference_receive(): version 1
+ * (KL520/KL720/KL630) or version 2 (KL730/KL830) result header, node metadata and NPU data of each node in its data layout.
+ * The fixed-point values are random, the floating-point values they stand for are given back in the order of
+ * kp_inf_node_view_t (BxCxHxW or ONNX shape), so any retrieval of the buffer can be checked without a device:
+ *
+ *     raw_output_node_spec_t spec = {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, 4, {1, 20, 5, 19}};
+ *     float *expected_values[1];
+ *     uint8_t *raw_out_buffer = raw_output_build(KP_DEVICE_KL720, &spec, 1, 1, expected_values, NULL);
+ *
+ *     kp_inf_float_node_output_t *node = kp_generic_inference_retrieve_float_node(0, raw_out_buffer, KP_CHANNEL_ORDERING_CHW);
+ *     // node->data[i] == expected_values[0][i]
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "kp_struct.h"
+
+/**
+ * @brief Description of one output node of a built RAW output buffer.
+ *
+ * Supported data layouts:
+ *   KL520: 16W1C8B.
+ *   KL720/KL630: 16W1C8B, 1W16C8B, 8W1C16B.
+ *   KL730/KL830: every fixed-point layout (not RAW_FLOAT), 1W16C8B/1W16C8BHL are stored in groups of 16 channels along the
+ *   'channel_axis', other layouts by plain strides.
+ */
+typedef struct
+{
+    uint32_t data_layout;                           /**< NPU data layout, refer to kp_model_tensor_data_layout_t */
+    uint32_t shape_len;                             /**< KL520/KL720/KL630: 4 (BxCxHxW with B = 1), KL730/KL830: length of ONNX shape */
+    int32_t shape[KP_MAX_NODE_VIEW_SHAPE_LEN];      /**< shape */
+    uint32_t channel_axis;                          /**< KL730/KL830: channel axis of the NPU data, also the quantized axis, axes before it should be 1 */
+    bool per_channel;                               /**< KL730/KL830: one quantization parameter for each channel */
+    int32_t radix_dtype;                            /**< KL730/KL830: data type of radix (KP_DTYPE_INT8/INT16/INT32), 0 for KP_DTYPE_INT32 */
+    int32_t scale_dtype;                            /**< KL730/KL830: data type of scale (ref. kp_dtype_t, not 64 bits), 0 for KP_DTYPE_FLOAT32 */
+    const int32_t *radix;                           /**< radix of each quantization parameter, NULL for random values */
+    const float *scale;                             /**< scale of each quantization parameter (rounded for integer dtypes), NULL for random values */
+} raw_output_node_spec_t;
+
+/**
+ * @brief Build a RAW output buffer with random fixed-point values.
+ *
+ * @param[in] product_id KP_DEVICE_KL520/KL720/KL630 (version 1 buffer) or KP_DEVICE_KL730/KL830 (version 2 buffer).
+ * @param[in] node_specs description of each output node.
+ * @param[in] node_count number of output nodes.
+ * @param[in] seed seed of the random fixed-point values and quantization parameters.
+ * @param[out] expected_values floating-point values of each node (allocated, free() each of them), NULL if not needed.
+ * @param[out] buffer_size size of the built buffer in bytes, NULL if not needed.
+ *
+ * @return the RAW output buffer (allocated, free() it), NULL if failed.
+ */
+uint8_t *raw_output_build(uint32_t product_id, const raw_output_node_spec_t *node_specs, uint32_t node_count, uint32_t seed,
+                          float **expected_values, uint32_t *buffer_size);
+
+/**
+ * @brief Get the number of quantization parameters of a node built by raw_output_build().
+ *
+ * @param[in] product_id the product id given to raw_output_build().
+ * @param[in] node_spec description of the node.
+ *
+ * @return number of quantization parameters ('radix' and 'scale' array length).
+ */
+uint32_t raw_output_get_quantization_parameters_len(uint32_t product_id, const raw_output_node_spec_t *node_spec);
@@ -0,0 +1,594 @@
+/**
+ * @file        tiled_inference.c
+ * @brief       tiled inference APIs of high resolution images
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kp_inference.h"
+#include "tiled_inference.h"
+
+struct tiled_inference_s
+{
+    kp_device_group_t devices;
+    uint32_t model_id;
+    tiled_inference_config_t config;        // tile size of the model input if 0 in the config
+    uint32_t raw_buf_size;
+    uint8_t *raw_output_buf;
+    post_process_yolo_context_t *yolo_context;
+    kp_yolo_result_t tile_result;
+    kp_bounding_box_t *boxes;               // boxes of all tiles of an image
+    int box_capacity;
+    kp_inf_crop_box_t tiles[TILED_INFERENCE_MAX_TILE];
+    uint8_t *tile_buffer;                   // packed pixels of the tile being sent
+    size_t tile_buffer_size;
+    kp_generic_image_inference_desc_t inf_desc;
+
+    /* image being sent, shared with the send thread */
+    const uint8_t *image_buffer;
+    int image_width;
+    int bytes_per_pixel;
+    kp_image_format_t image_format;
+    int tile_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int sent_count;                         // tiles written to USB
+    bool send_done;
+    bool stop_sending;                      // set on a receive-side error, no more tiles are sent
+    int send_status;
+};
+
+static int bytes_per_pixel(kp_image_format_t format)
+{
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_RAW8:
+        return 1;
+    case KP_IMAGE_FORMAT_RGB565:
+    case KP_IMAGE_FORMAT_YUYV:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
+        return 2;
+    case KP_IMAGE_FORMAT_RGBA8888:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+/* tile positions on one axis, returns the number of tiles */
+static int layout_axis(int size, int tile, int overlap, int align, int *positions, int *lengths, int max_count)
+{
+    int count;
+
+    if (size <= tile)
+    {
+        positions[0] = 0;
+        lengths[0] = size;
+        return 1;
+    }
+
+    // n tiles spaced by (size - tile) / (n - 1) <= tile - overlap
+    count = (size - overlap + (tile - overlap) - 1) / (tile - overlap);
+    if (count > max_count)
+        return -1;
+
+    for (int i = 0; i < count; i++)
+    {
+        positions[i] = (int)((long long)(size - tile) * i / (count - 1));
+        positions[i] -= positions[i] % align;
+        lengths[i] = (i == count - 1) ? size - positions[i] : tile;
+    }
+
+    return count;
+}
+
+int tiled_inference_layout(int image_width, int image_height, int tile_width, int tile_height, int overlap,
+                           kp_inf_crop_box_t *tiles, int max_tile_count)
+{
+    int x[TILED_INFERENCE_MAX_TILE], width[TILED_INFERENCE_MAX_TILE];
+    int y[TILED_INFERENCE_MAX_TILE], height[TILED_INFERENCE_MAX_TILE];
+    int count_x, count_y;
+
+    if ((NULL == tiles) || (0 >= image_width) || (0 >= image_height) || (0 > overlap) || (overlap >= tile_width) || (overlap >= tile_height))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    count_x = layout_axis(image_width, tile_width, overlap, 2, x, width, TILED_INFERENCE_MAX_TILE);
+    count_y = layout_axis(image_height, tile_height, overlap, 1, y, height, TILED_INFERENCE_MAX_TILE);
+
+    if ((0 > count_x) || (0 > count_y) || (count_x * count_y > max_tile_count))
+    {
+        printf("Error! %s(): more than %d tiles\n", __FUNCTION__, max_tile_count);
+        return -1;
+    }
+
+    for (int j = 0; j < count_y; j++)
+    {
+        for (int i = 0; i < count_x; i++)
+        {
+            kp_inf_crop_box_t *tile = &tiles[j * count_x + i];
+
+            tile->crop_number = j * count_x + i;
+            tile->x1 = x[i];
+            tile->y1 = y[j];
+            tile->width = width[i];
+            tile->height = height[j];
+        }
+    }
+
+    return count_x * count_y;
+}
+
+static int box_score_comparator(const void *a, const void *b)
+{
+    const kp_bounding_box_t *box_a = (const kp_bounding_box_t *)a;
+    const kp_bounding_box_t *box_b = (const kp_bounding_box_t *)b;
+
+    if (box_a->score != box_b->score)
+        return (box_a->score < box_b->score) ? 1 : -1;
+
+    // ties in a fixed order, independent of the tile order
+    if (box_a->x1 != box_b->x1)
+        return (box_a->x1 < box_b->x1) ? -1 : 1;
+
+    if (box_a->y1 != box_b->y1)
+        return (box_a->y1 < box_b->y1) ? -1 : 1;
+
+    return box_a->class_num - box_b->class_num;
+}
+
+static float box_area(const kp_bounding_box_t *box)
+{
+    return (box->x2 - box->x1) * (box->y2 - box->y1);
+}
+
+/* IoU, or intersection over the smaller box */
+static float box_overlap_ratio(const kp_bounding_box_t *a, const kp_bounding_box_t *b, uint32_t merge_policy)
+{
+    float w = ((a->x2 < b->x2) ? a->x2 : b->x2) - ((a->x1 > b->x1) ? a->x1 : b->x1);
+    float h = ((a->y2 < b->y2) ? a->y2 : b->y2) - ((a->y1 > b->y1) ? a->y1 : b->y1);
+    float intersection;
+    float base;
+
+    if ((0 >= w) || (0 >= h))
+        return 0;
+
+    intersection = w * h;
+
+    if (TILED_INFERENCE_MERGE_NMS == merge_policy)
+        base = box_area(a) + box_area(b) - intersection;
+    else
+        base = (box_area(a) < box_area(b)) ? box_area(a) : box_area(b);
+
+    return (0 < base) ? intersection / base : 0;
+}
+
+int tiled_inference_merge_boxes(kp_bounding_box_t *boxes, int box_count, uint32_t merge_policy, float merge_threshold)
+{
+    int kept_count = 0;
+
+    if (((NULL == boxes) && (0 < box_count)) || (0 > box_count) || (TILED_INFERENCE_MERGE_UNION < merge_policy))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    qsort(boxes, box_count, sizeof(kp_bounding_box_t), box_score_comparator);
+
+    // kept boxes are compacted at the front, each box is merged into the first kept box of its class it overlaps
+    for (int i = 0; i < box_count; i++)
+    {
+        kp_bounding_box_t box = boxes[i];
+        bool merged = false;
+
+        for (int k = 0; k < kept_count; k++)
+        {
+            kp_bounding_box_t *kept = &boxes[k];
+
+            if ((kept->class_num != box.class_num) || (box_overlap_ratio(kept, &box, merge_policy) <= merge_threshold))
+                continue;
+
+            if (TILED_INFERENCE_MERGE_UNION == merge_policy)
+            {
+                kept->x1 = (box.x1 < kept->x1) ? box.x1 : kept->x1;
+                kept->y1 = (box.y1 < kept->y1) ? box.y1 : kept->y1;
+                kept->x2 = (box.x2 > kept->x2) ? box.x2 : kept->x2;
+                kept->y2 = (box.y2 > kept->y2) ? box.y2 : kept->y2;
+            }
+
+            merged = true;
+            break;
+        }
+
+        if (!merged)
+            boxes[kept_count++] = box;
+    }
+
+    return kept_count;
+}
+
+/* decode a tile by the YOLO descriptor of the config */
+static int decode_yolo_tile(tiled_inference_t *tiled, kp_generic_image_inference_result_header_t *output_desc,
+                            const post_process_box_transform_t *box_transform, kp_yolo_result_t *result)
+{
+    kp_inf_float_node_output_t *node_output[POST_PROCESS_YOLO_MAX_HEAD] = {NULL};
+    int node_count = (int)output_desc->num_output_node;
+    int ret = KP_SUCCESS;
+
+    if (POST_PROCESS_YOLO_MAX_HEAD < node_count)
+    {
+        printf("Error! %s(): %d output nodes are more than the YOLO heads\n", __FUNCTION__, node_count);
+        return KP_ERROR_INVALID_MODEL_21;
+    }
+
+    for (int i = 0; i < node_count; i++)
+    {
+        kp_inf_node_view_t node_view;
+
+        node_output[i] = kp_generic_inference_retrieve_float_node(i, tiled->raw_output_buf, (kp_channel_ordering_t)tiled->config.descriptor->channel_ordering);
+        if (NULL == node_output[i])
+        {
+            ret = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+            goto out;
+        }
+
+        if (KP_SUCCESS == kp_generic_inference_retrieve_node_view(i, tiled->raw_output_buf, &node_view))
+            post_process_yolo_set_node_quantization(tiled->yolo_context, i, &node_view);
+    }
+
+    ret = post_process_yolo_generic_with_context(tiled->yolo_context, tiled->config.descriptor, node_output, node_count,
+                                                 &output_desc->pre_proc_info[0], box_transform, tiled->config.thresh_value, result);
+
+out:
+    for (int i = 0; i < node_count; i++)
+        free(node_output[i]);
+
+    return ret;
+}
+
+static void *send_tiles_thread(void *data)
+{
+    tiled_inference_t *tiled = (tiled_inference_t *)data;
+    kp_generic_input_node_image_t *input_node = &tiled->inf_desc.input_node_image_list[0];
+    int ret = KP_SUCCESS;
+
+    for (int i = 0; i < tiled->tile_count; i++)
+    {
+        kp_inf_crop_box_t *tile = &tiled->tiles[i];
+        bool stop_sending;
+
+        pthread_mutex_lock(&tiled->mutex);
+        stop_sending = tiled->stop_sending;
+        pthread_mutex_unlock(&tiled->mutex);
+
+        if (stop_sending)
+            break;
+
+        size_t image_row_size = (size_t)tiled->image_width * tiled->bytes_per_pixel;
+        size_t tile_row_size = (size_t)tile->width * tiled->bytes_per_pixel;
+        const uint8_t *src = tiled->image_buffer + image_row_size * tile->y1 + (size_t)tile->x1 * tiled->bytes_per_pixel;
+
+        // a tile of whole rows is sent from the image, other tiles are packed first
+        if (tile_row_size == image_row_size)
+        {
+            input_node->image_buffer = (uint8_t *)src;
+        }
+        else
+        {
+            for (uint32_t row = 0; row < tile->height; row++)
+                memcpy(tiled->tile_buffer + tile_row_size * row, src + image_row_size * row, tile_row_size);
+
+            input_node->image_buffer = tiled->tile_buffer;
+        }
+
+        tiled->inf_desc.inference_number = i;
+        input_node->width = tile->width;
+        input_node->height = tile->height;
+        input_node->image_format = tiled->image_format;
+
+        // returns after the tile is written to USB, so the tile buffer can be reused
+        ret = kp_generic_image_inference_send(tiled->devices, &tiled->inf_desc);
+        if (KP_SUCCESS != ret)
+        {
+            printf("Error! %s(): kp_generic_image_inference_send() error = %d\n", __FUNCTION__, ret);
+            break;
+        }
+
+        pthread_mutex_lock(&tiled->mutex);
+        tiled->sent_count++;
+        pthread_cond_signal(&tiled->cond);
+        pthread_mutex_unlock(&tiled->mutex);
+    }
+
+    pthread_mutex_lock(&tiled->mutex);
+    tiled->send_status = ret;
+    tiled->send_done = true;
+    pthread_cond_signal(&tiled->cond);
+    pthread_mutex_unlock(&tiled->mutex);
+
+    return NULL;
+}
+
+void tiled_inference_release(tiled_inference_t *tiled)
+{
+    if (NULL == tiled)
+        return;
+
+    pthread_mutex_destroy(&tiled->mutex);
+    pthread_cond_destroy(&tiled->cond);
+    post_process_yolo_release_context(tiled->yolo_context);
+    free(tiled->raw_output_buf);
+    free(tiled->boxes);
+    free(tiled->tile_buffer);
+    free(tiled);
+}
+
+tiled_inference_t *tiled_inference_create(kp_device_group_t devices, kp_single_model_descriptor_t *model, const tiled_inference_config_t *config)
+{
+    tiled_inference_t *tiled;
+    kp_tensor_descriptor_t *input_node;
+    int model_width = 0;
+    int model_height = 0;
+
+    if ((NULL == devices) || (NULL == model) || (NULL == config) || (0 == model->input_nodes_num) ||
+        ((NULL == config->decode) && (NULL == config->descriptor)) || (TILED_INFERENCE_MERGE_UNION < config->merge_policy))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return NULL;
+    }
+
+    input_node = &model->input_nodes[0];
+
+    if ((KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1 == input_node->tensor_shape_info.version) &&
+        (4 <= input_node->tensor_shape_info.tensor_shape_info_data.v1.shape_npu_len))
+    {
+        model_width = input_node->tensor_shape_info.tensor_shape_info_data.v1.shape_npu[3];
+        model_height = input_node->tensor_shape_info.tensor_shape_info_data.v1.shape_npu[2];
+    }
+    else if ((KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2 == input_node->tensor_shape_info.version) &&
+             (4 <= input_node->tensor_shape_info.tensor_shape_info_data.v2.shape_len))
+    {
+        model_width = input_node->tensor_shape_info.tensor_shape_info_data.v2.shape[3];
+        model_height = input_node->tensor_shape_info.tensor_shape_info_data.v2.shape[2];
+    }
+
+    if ((0 >= model_width) || (0 >= model_height))
+    {
+        printf("Error! %s(): unknown model input size\n", __FUNCTION__);
+        return NULL;
+    }
+
+    tiled = (tiled_inference_t *)calloc(1, sizeof(tiled_inference_t));
+    if (NULL == tiled)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return NULL;
+    }
+
+    pthread_mutex_init(&tiled->mutex, NULL);
+    pthread_cond_init(&tiled->cond, NULL);
+
+    tiled->devices = devices;
+    tiled->model_id = model->id;
+    tiled->config = *config;
+    tiled->config.tile_width = (0 < config->tile_width) ? config->tile_width : model_width;
+    tiled->config.tile_height = (0 < config->tile_height) ? config->tile_height : model_height;
+
+    tiled->raw_buf_size = model->max_raw_out_size;
+    tiled->raw_output_buf = (uint8_t *)malloc(tiled->raw_buf_size);
+    tiled->yolo_context = post_process_yolo_create_context();
+
+    if ((NULL == tiled->raw_output_buf) || (NULL == tiled->yolo_context))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        tiled_inference_release(tiled);
+        return NULL;
+    }
+
+    /* the device resizes and pads each tile into the model input */
+    tiled->inf_desc.model_id = tiled->model_id;
+    tiled->inf_desc.num_input_node_image = 1;
+    tiled->inf_desc.input_node_image_list[0].resize_mode = KP_RESIZE_ENABLE;
+    tiled->inf_desc.input_node_image_list[0].padding_mode = KP_PADDING_CORNER;
+    tiled->inf_desc.input_node_image_list[0].normalize_mode = config->normalize_mode;
+    tiled->inf_desc.input_node_image_list[0].crop_count = 0;
+
+    return tiled;
+}
+
+static void stop_sending_tiles(tiled_inference_t *tiled)
+{
+    pthread_mutex_lock(&tiled->mutex);
+    tiled->stop_sending = true;
+    pthread_mutex_unlock(&tiled->mutex);
+}
+
+/* decode the result of a tile and append its boxes to the boxes of the image */
+static int append_tile_result(tiled_inference_t *tiled, int tile_index, kp_generic_image_inference_result_header_t *output_desc, int width,
+                              int height, int *box_count)
+{
+    post_process_box_transform_t box_transform;
+    int ret;
+
+    // boxes of the tile are mapped to the image, a box is clipped by the image instead of the tile
+    post_process_box_transform_init(&box_transform, &output_desc->pre_proc_info[0]);
+    box_transform.origin_x = tiled->tiles[tile_index].x1;
+    box_transform.origin_y = tiled->tiles[tile_index].y1;
+    box_transform.max_x = width - 1;
+    box_transform.max_y = height - 1;
+
+    tiled->tile_result.box_count = 0;
+
+    if (NULL != tiled->config.decode)
+        ret = tiled->config.decode(tiled->config.user_data, tiled->raw_output_buf, output_desc, &box_transform, &tiled->tile_result);
+    else
+        ret = decode_yolo_tile(tiled, output_desc, &box_transform, &tiled->tile_result);
+
+    if (KP_SUCCESS != ret)
+        return ret;
+
+    if (*box_count + (int)tiled->tile_result.box_count > tiled->box_capacity)
+    {
+        int capacity = (*box_count + (int)tiled->tile_result.box_count) * 2;
+        kp_bounding_box_t *boxes = (kp_bounding_box_t *)realloc(tiled->boxes, sizeof(kp_bounding_box_t) * capacity);
+
+        if (NULL == boxes)
+        {
+            printf("Error! %s(): out of memory\n", __FUNCTION__);
+            return KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+        }
+
+        tiled->boxes = boxes;
+        tiled->box_capacity = capacity;
+    }
+
+    memcpy(&tiled->boxes[*box_count], tiled->tile_result.boxes, sizeof(kp_bounding_box_t) * tiled->tile_result.box_count);
+    *box_count += tiled->tile_result.box_count;
+
+    return KP_SUCCESS;
+}
+
+int tiled_inference_run(tiled_inference_t *tiled, const uint8_t *image_buffer, int width, int height, kp_image_format_t format,
+                        kp_yolo_result_t *result, int *tile_count)
+{
+    pthread_t send_thread;
+    int box_count = 0;
+    int received_count = 0;
+    int ret = KP_SUCCESS;
+    int status = KP_SUCCESS;
+    size_t tile_buffer_size;
+
+    if ((NULL == tiled) || (NULL == image_buffer) || (NULL == result) || (0 >= width) || (0 >= height))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    tiled->bytes_per_pixel = bytes_per_pixel(format);
+    if (0 == tiled->bytes_per_pixel)
+    {
+        printf("Error! %s(): image format 0x%x is not supported\n", __FUNCTION__, format);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    tiled->tile_count = tiled_inference_layout(width, height, tiled->config.tile_width, tiled->config.tile_height, tiled->config.overlap,
+                                               tiled->tiles, TILED_INFERENCE_MAX_TILE);
+    if (0 > tiled->tile_count)
+        return KP_ERROR_INVALID_PARAM_12;
+
+    // the last tile of an axis may be one pixel longer to keep x even
+    tile_buffer_size = (size_t)(tiled->config.tile_width + 1) * (tiled->config.tile_height + 1) * tiled->bytes_per_pixel;
+    if (tile_buffer_size > tiled->tile_buffer_size)
+    {
+        free(tiled->tile_buffer);
+        tiled->tile_buffer_size = 0;
+        tiled->tile_buffer = (uint8_t *)malloc(tile_buffer_size);
+
+        if (NULL == tiled->tile_buffer)
+        {
+            printf("Error! %s(): out of memory\n", __FUNCTION__);
+            return KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+        }
+
+        tiled->tile_buffer_size = tile_buffer_size;
+    }
+
+    tiled->image_buffer = image_buffer;
+    tiled->image_width = width;
+    tiled->image_format = format;
+    tiled->sent_count = 0;
+    tiled->send_done = false;
+    tiled->stop_sending = false;
+    tiled->send_status = KP_SUCCESS;
+
+    if (0 != pthread_create(&send_thread, NULL, send_tiles_thread, tiled))
+    {
+        printf("Error! %s(): failed to create the send thread\n", __FUNCTION__);
+        return KP_ERROR_OTHER_99;
+    }
+
+    /*
+     * results come back in the order the tiles are sent, while later tiles are being sent.
+     * after a decode error or a wrong result the send thread stops, and the results of tiles already sent are drained so that
+     * they are not received by the next run, only a failed receive leaves them on the devices.
+     */
+    while (true)
+    {
+        kp_generic_image_inference_result_header_t output_desc;
+        bool can_receive;
+
+        pthread_mutex_lock(&tiled->mutex);
+        while ((tiled->sent_count <= received_count) && !tiled->send_done)
+            pthread_cond_wait(&tiled->cond, &tiled->mutex);
+        can_receive = (tiled->sent_count > received_count);
+        pthread_mutex_unlock(&tiled->mutex);
+
+        if (!can_receive)
+            break;
+
+        ret = kp_generic_image_inference_receive(tiled->devices, &output_desc, tiled->raw_output_buf, tiled->raw_buf_size);
+        if (KP_SUCCESS != ret)
+        {
+            printf("Error! %s(): kp_generic_image_inference_receive() error = %d\n", __FUNCTION__, ret);
+            stop_sending_tiles(tiled);
+            break;
+        }
+
+        received_count++;
+
+        if (KP_SUCCESS != status)
+            continue;
+
+        if ((int)output_desc.inference_number != received_count - 1)
+        {
+            printf("Error! %s(): result of tile %u is received for tile %d\n", __FUNCTION__, output_desc.inference_number, received_count - 1);
+            status = KP_ERROR_RECV_DATA_FAIL_17;
+        }
+        else
+        {
+            status = append_tile_result(tiled, received_count - 1, &output_desc, width, height, &box_count);
+        }
+
+        if (KP_SUCCESS != status)
+            stop_sending_tiles(tiled);
+    }
+
+    pthread_join(send_thread, NULL);
+
+    if (KP_SUCCESS == ret)
+        ret = status;
+
+    if ((KP_SUCCESS == ret) && (KP_SUCCESS != tiled->send_status))
+        ret = tiled->send_status;
+
+    if (NULL != tile_count)
+        *tile_count = received_count;
+
+    if (KP_SUCCESS != ret)
+        return ret;
+
+    box_count = tiled_inference_merge_boxes(tiled->boxes, box_count, tiled->config.merge_policy, tiled->config.merge_threshold);
+
+    result->class_count = tiled->tile_result.class_count;
+    result->box_count = (box_count > YOLO_GOOD_BOX_MAX) ? YOLO_GOOD_BOX_MAX : box_count;
+    memcpy(result->boxes, tiled->boxes, sizeof(kp_bounding_box_t) * result->box_count);
+
+    return KP_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file        tiled_inference.h
+ * @brief       tiled inference APIs of high resolution images
+ *
+ * An image much larger than the model input is split into overlapping tiles of about the model input size instead of being
+ * resized into the model input, so small objects keep their pixels. The tiles are sent one by one to the device group,
+ * which dispatches them to its devices in turn, and the results are received while later tiles are being sent, so all
+ * devices of the group infer tiles at the same time. Boxes of each tile are mapped into image coordinates and the boxes
+ * of objects seen by more than one tile are merged across tiles.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "kp_struct.h"
+#include "postprocess.h"
+
+#define TILED_INFERENCE_MAX_TILE 1024       /**< MAX number of tiles of an image */
+
+/**
+ * @brief Policies of merging boxes of the same class across tiles, boxes are visited from the highest score.
+ */
+typedef enum
+{
+    TILED_INFERENCE_MERGE_NMS = 0,          /**< drop a box whose IoU with a kept box is over the threshold */
+    TILED_INFERENCE_MERGE_NMS_MIN,          /**< drop a box whose intersection over the smaller box is over the threshold, which also drops the part of an object cut by a tile border */
+    TILED_INFERENCE_MERGE_UNION,            /**< as TILED_INFERENCE_MERGE_NMS_MIN, but the kept box grows to the union of both boxes */
+} tiled_inference_merge_policy_t;
+
+/**
+ * @brief Decoder of the result of one tile.
+ *
+ * @param[in] user_data 'user_data' of the config.
+ * @param[in] raw_output_buf raw output of the tile from kp_generic_image_inference_receive().
+ * @param[in] output_desc output descriptor of the tile.
+ * @param[in] box_transform mapping of boxes from model input coordinates to image coordinates.
+ * @param[out] result the boxes of the tile in image coordinates.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+typedef int (*tiled_inference_decode_t)(void *user_data, uint8_t *raw_output_buf, kp_generic_image_inference_result_header_t *output_desc,
+                                        const post_process_box_transform_t *box_transform, kp_yolo_result_t *result);
+
+/**
+ * @brief Configuration of tiled inference.
+ */
+typedef struct
+{
+    int tile_width;                         /**< tile width in image pixels, 0 for the model input width */
+    int tile_height;                        /**< tile height in image pixels, 0 for the model input height */
+    int overlap;                            /**< min overlap in pixels of neighbor tiles, objects up to this size are whole in at least one tile */
+    uint32_t normalize_mode;                /**< inference normalization of the model, refer to kp_normalize_mode_t */
+    uint32_t merge_policy;                  /**< enum tiled_inference_merge_policy_t */
+    float merge_threshold;                  /**< overlap ratio (0 ~ 1) over which boxes of the same class are merged */
+    const post_process_yolo_descriptor_t *descriptor; /**< YOLO detector decoding the tiles if 'decode' is NULL */
+    float thresh_value;                     /**< score threshold of the YOLO detector, range from 0 ~ 1 */
+    tiled_inference_decode_t decode;        /**< custom decoder of the tiles, NULL to decode by 'descriptor' */
+    void *user_data;                        /**< user data of 'decode' */
+} tiled_inference_config_t;
+
+/**
+ * @brief Tiled inference of one model on a device group.
+ */
+typedef struct tiled_inference_s tiled_inference_t;
+
+/**
+ * @brief Split an image into overlapping tiles.
+ *
+ * Tiles are evenly spread over each axis, so neighbor tiles overlap by at least 'overlap' pixels (x of tiles is even to keep
+ * YUV422 pixel pairs, which may cost one pixel of overlap). An axis not larger than the tile has one tile of the image size.
+ *
+ * @param[in] image_width image width.
+ * @param[in] image_height image height.
+ * @param[in] tile_width tile width.
+ * @param[in] tile_height tile height.
+ * @param[in] overlap min overlap in pixels of neighbor tiles, less than the tile width and height.
+ * @param[out] tiles the tiles in row-major order, 'crop_number' is the tile index.
+ * @param[in] max_tile_count number of tiles 'tiles' can hold.
+ *
+ * @return number of tiles, -1 if the parameters are invalid or there are more than 'max_tile_count' tiles.
+ */
+int tiled_inference_layout(int image_width, int image_height, int tile_width, int tile_height, int overlap,
+                           kp_inf_crop_box_t *tiles, int max_tile_count);
+
+/**
+ * @brief Merge boxes of the same class which overlap, e.g. boxes of one object from neighbor tiles.
+ *
+ * @param[in,out] boxes the boxes, the merged boxes are stored from the highest score.
+ * @param[in] box_count number of boxes.
+ * @param[in] merge_policy enum tiled_inference_merge_policy_t.
+ * @param[in] merge_threshold overlap ratio (0 ~ 1) over which boxes are merged.
+ *
+ * @return number of merged boxes, -1 if failed.
+ */
+int tiled_inference_merge_boxes(kp_bounding_box_t *boxes, int box_count, uint32_t merge_policy, float merge_threshold);
+
+/**
+ * @brief Create a tiled inference of a model loaded to a device group.
+ *
+ * @param[in] devices a connected device group, the model is loaded to all of its devices.
+ * @param[in] model the model, its first input node receives the tiles.
+ * @param[in] config configuration of tiled inference.
+ *
+ * @return the tiled inference, NULL if failed.
+ */
+tiled_inference_t *tiled_inference_create(kp_device_group_t devices, kp_single_model_descriptor_t *model, const tiled_inference_config_t *config);
+
+/**
+ * @brief Release a tiled inference.
+ *
+ * @param[in] tiled the tiled inference.
+ */
+void tiled_inference_release(tiled_inference_t *tiled);
+
+/**
+ * @brief Detect objects of an image tile by tile.
+ *
+ * No other inference should be sent to or received from the device group at the same time.
+ * On a decode error or a result of a wrong tile no more tiles are sent, and the results of the tiles already sent are received
+ * before returning, so the device group is left empty unless receiving itself failed.
+ *
+ * @param[in] tiled the tiled inference.
+ * @param[in] image_buffer the image, rows are packed.
+ * @param[in] width image width.
+ * @param[in] height image height.
+ * @param[in] format image format, KP_IMAGE_FORMAT_RGB565, KP_IMAGE_FORMAT_RGBA8888, KP_IMAGE_FORMAT_YUYV, KP_IMAGE_FORMAT_YCBCR422_* or KP_IMAGE_FORMAT_RAW8.
+ * @param[out] result the merged boxes in image coordinates, at most YOLO_GOOD_BOX_MAX boxes with the highest scores.
+ * @param[out] tile_count number of tile results received, NULL to ignore.
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int tiled_inference_run(tiled_inference_t *tiled, const uint8_t *image_buffer, int width, int height, kp_image_format_t format,
+                        kp_yolo_result_t *result, int *tile_count);
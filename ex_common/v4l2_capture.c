@@ -0,0 +1,484 @@
+/**
+ * @file        v4l2_capture.c
+ * @brief       V4L2 camera capture functions
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "v4l2_capture.h"
+
+/* macOS builds define __linux__ as well */
+#if defined(__linux__) && !defined(OS_TYPE_MACOS)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/videodev2.h>
+
+#define V4L2_CAPTURE_MAX_BUFFER_COUNT 32
+
+struct v4l2_capture_s
+{
+    int fd;
+    bool is_file;               // file of raw frames instead of a video device
+    uint32_t width;
+    uint32_t height;
+    kp_image_format_t format;
+    uint32_t frame_size;
+    int buffer_count;
+    uint8_t *buffers[V4L2_CAPTURE_MAX_BUFFER_COUNT];        // mmap'd driver buffers
+    size_t buffer_lengths[V4L2_CAPTURE_MAX_BUFFER_COUNT];
+    bool held[V4L2_CAPTURE_MAX_BUFFER_COUNT];               // given out by v4l2_capture_get_frame() and not released yet
+    bool streaming;
+
+    // file source
+    uint8_t *file_data;
+    size_t file_size;
+    uint32_t file_frame_count;
+    uint32_t sequence;
+};
+
+static int xioctl(int fd, unsigned long request, void *arg)
+{
+    int ret;
+
+    do
+    {
+        ret = ioctl(fd, request, arg);
+    } while ((-1 == ret) && (EINTR == errno));
+
+    return ret;
+}
+
+static uint32_t v4l2_pixel_format(kp_image_format_t format)
+{
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_YUYV:
+        return V4L2_PIX_FMT_YUYV;
+    case KP_IMAGE_FORMAT_YUV420:
+        return V4L2_PIX_FMT_YUV420;
+    case KP_IMAGE_FORMAT_RGB565:
+        return V4L2_PIX_FMT_RGB565;
+    case KP_IMAGE_FORMAT_RAW8:
+        return V4L2_PIX_FMT_GREY;
+    default:
+        return 0;
+    }
+}
+
+static int frame_size_of(int width, int height, kp_image_format_t format)
+{
+    long long pixel_count = (long long)width * height;
+
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_YUYV:
+        return (0 == width % 2) ? (int)(pixel_count * 2) : -1;
+    case KP_IMAGE_FORMAT_YUV420:
+        return ((0 == width % 2) && (0 == height % 2)) ? (int)(pixel_count * 3 / 2) : -1;
+    case KP_IMAGE_FORMAT_RGB565:
+        return (int)(pixel_count * 2);
+    case KP_IMAGE_FORMAT_RAW8:
+        return (int)pixel_count;
+    default:
+        return -1;
+    }
+}
+
+static int open_file_source(v4l2_capture_t *capture, const char *path)
+{
+    struct stat file_stat;
+
+    if (0 != fstat(capture->fd, &file_stat))
+        return -1;
+
+    capture->file_size = (size_t)file_stat.st_size;
+    capture->file_frame_count = (uint32_t)(capture->file_size / capture->frame_size);
+
+    if (0 == capture->file_frame_count)
+    {
+        printf("Error! %s(): %s has no complete frame of %u bytes\n", __FUNCTION__, path, capture->frame_size);
+        return -1;
+    }
+
+    capture->file_data = (uint8_t *)mmap(NULL, capture->file_size, PROT_READ, MAP_PRIVATE, capture->fd, 0);
+    if (MAP_FAILED == capture->file_data)
+    {
+        capture->file_data = NULL;
+        printf("Error! %s(): mmap %s failed (%s)\n", __FUNCTION__, path, strerror(errno));
+        return -1;
+    }
+
+    capture->is_file = true;
+
+    return 0;
+}
+
+static int open_device_source(v4l2_capture_t *capture, const char *path)
+{
+    struct v4l2_capability cap;
+    struct v4l2_format fmt;
+    struct v4l2_requestbuffers req;
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    uint32_t pixel_format = v4l2_pixel_format(capture->format);
+    uint32_t bytes_per_line;
+    int frame_size;
+
+    memset(&cap, 0, sizeof(cap));
+    if ((0 != xioctl(capture->fd, VIDIOC_QUERYCAP, &cap)) ||
+        !(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) || !(cap.capabilities & V4L2_CAP_STREAMING))
+    {
+        printf("Error! %s(): %s is not a V4L2 streaming capture device\n", __FUNCTION__, path);
+        return -1;
+    }
+
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = capture->width;
+    fmt.fmt.pix.height = capture->height;
+    fmt.fmt.pix.pixelformat = pixel_format;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+
+    if (0 != xioctl(capture->fd, VIDIOC_S_FMT, &fmt))
+    {
+        printf("Error! %s(): VIDIOC_S_FMT failed (%s)\n", __FUNCTION__, strerror(errno));
+        return -1;
+    }
+
+    // the driver may change the size, but a frame is only sent as it is in the requested format with packed rows
+    frame_size = frame_size_of((int)fmt.fmt.pix.width, (int)fmt.fmt.pix.height, capture->format);
+    bytes_per_line = ((KP_IMAGE_FORMAT_YUV420 == capture->format) || (KP_IMAGE_FORMAT_RAW8 == capture->format)) ? fmt.fmt.pix.width : fmt.fmt.pix.width * 2;
+
+    if ((pixel_format != fmt.fmt.pix.pixelformat) || (0 > frame_size) || (fmt.fmt.pix.sizeimage < (uint32_t)frame_size) ||
+        (bytes_per_line != fmt.fmt.pix.bytesperline))
+    {
+        printf("Error! %s(): %s gives %u x %u frames of format 0x%x with %u bytes per line, not supported\n", __FUNCTION__, path,
+               fmt.fmt.pix.width, fmt.fmt.pix.height, fmt.fmt.pix.pixelformat, fmt.fmt.pix.bytesperline);
+        return -1;
+    }
+
+    capture->width = fmt.fmt.pix.width;
+    capture->height = fmt.fmt.pix.height;
+    capture->frame_size = (uint32_t)frame_size;
+
+    memset(&req, 0, sizeof(req));
+    req.count = capture->buffer_count;
+    capture->buffer_count = 0;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+
+    if ((0 != xioctl(capture->fd, VIDIOC_REQBUFS, &req)) || (0 == req.count))
+    {
+        printf("Error! %s(): VIDIOC_REQBUFS failed (%s)\n", __FUNCTION__, strerror(errno));
+        return -1;
+    }
+
+    if (V4L2_CAPTURE_MAX_BUFFER_COUNT < req.count)
+        req.count = V4L2_CAPTURE_MAX_BUFFER_COUNT;
+
+    for (uint32_t i = 0; i < req.count; i++)
+    {
+        struct v4l2_buffer buf;
+
+        memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+
+        if (0 != xioctl(capture->fd, VIDIOC_QUERYBUF, &buf))
+        {
+            printf("Error! %s(): VIDIOC_QUERYBUF failed (%s)\n", __FUNCTION__, strerror(errno));
+            return -1;
+        }
+
+        capture->buffers[i] = (uint8_t *)mmap(NULL, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, capture->fd, buf.m.offset);
+        if (MAP_FAILED == capture->buffers[i])
+        {
+            capture->buffers[i] = NULL;
+            printf("Error! %s(): mmap buffer %u failed (%s)\n", __FUNCTION__, i, strerror(errno));
+            return -1;
+        }
+
+        capture->buffer_lengths[i] = buf.length;
+        capture->buffer_count = i + 1;
+
+        if (0 != xioctl(capture->fd, VIDIOC_QBUF, &buf))
+        {
+            printf("Error! %s(): VIDIOC_QBUF failed (%s)\n", __FUNCTION__, strerror(errno));
+            return -1;
+        }
+    }
+
+    if (0 != xioctl(capture->fd, VIDIOC_STREAMON, &type))
+    {
+        printf("Error! %s(): VIDIOC_STREAMON failed (%s)\n", __FUNCTION__, strerror(errno));
+        return -1;
+    }
+
+    capture->streaming = true;
+
+    return 0;
+}
+
+v4l2_capture_t *v4l2_capture_open(const char *path, int width, int height, kp_image_format_t format, int buffer_count)
+{
+    v4l2_capture_t *capture;
+    struct stat path_stat;
+    int frame_size = frame_size_of(width, height, format);
+    int ret;
+
+    if ((NULL == path) || (0 >= width) || (0 >= height) || (0 >= buffer_count) || (V4L2_CAPTURE_MAX_BUFFER_COUNT < buffer_count))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return NULL;
+    }
+
+    if (0 > frame_size)
+    {
+        printf("Error! %s(): image format 0x%x is not supported for %d x %d\n", __FUNCTION__, format, width, height);
+        return NULL;
+    }
+
+    capture = (v4l2_capture_t *)calloc(1, sizeof(v4l2_capture_t));
+    if (NULL == capture)
+    {
+        printf("Error! %s(): memory allocation failed\n", __FUNCTION__);
+        return NULL;
+    }
+
+    capture->width = width;
+    capture->height = height;
+    capture->format = format;
+    capture->frame_size = (uint32_t)frame_size;
+    capture->buffer_count = buffer_count;
+    capture->fd = open(path, O_RDWR | O_NONBLOCK);
+
+    // files of raw frames can be read only
+    if ((0 > capture->fd) && ((EACCES == errno) || (EROFS == errno)))
+        capture->fd = open(path, O_RDONLY);
+
+    if ((0 > capture->fd) || (0 != fstat(capture->fd, &path_stat)))
+    {
+        printf("Error! %s(): open %s failed (%s)\n", __FUNCTION__, path, strerror(errno));
+        v4l2_capture_close(capture);
+        return NULL;
+    }
+
+    if (S_ISREG(path_stat.st_mode))
+        ret = open_file_source(capture, path);
+    else
+        ret = open_device_source(capture, path);
+
+    if (0 != ret)
+    {
+        v4l2_capture_close(capture);
+        return NULL;
+    }
+
+    return capture;
+}
+
+void v4l2_capture_close(v4l2_capture_t *capture)
+{
+    if (NULL == capture)
+        return;
+
+    if (capture->streaming)
+    {
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(capture->fd, VIDIOC_STREAMOFF, &type);
+    }
+
+    if (!capture->is_file)
+    {
+        for (int i = 0; i < capture->buffer_count; i++)
+        {
+            if (NULL != capture->buffers[i])
+                munmap(capture->buffers[i], capture->buffer_lengths[i]);
+        }
+    }
+
+    if (NULL != capture->file_data)
+        munmap(capture->file_data, capture->file_size);
+
+    if (0 <= capture->fd)
+        close(capture->fd);
+
+    free(capture);
+}
+
+static int get_file_frame(v4l2_capture_t *capture, v4l2_capture_frame_t *frame)
+{
+    struct timespec now;
+    int index = -1;
+
+    for (int i = 0; i < capture->buffer_count; i++)
+    {
+        if (!capture->held[i])
+        {
+            index = i;
+            break;
+        }
+    }
+
+    if (0 > index)
+        return 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    capture->held[index] = true;
+
+    frame->index = index;
+    frame->data = capture->file_data + (size_t)(capture->sequence % capture->file_frame_count) * capture->frame_size;
+    frame->sequence = capture->sequence++;
+    frame->timestamp_us = (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+
+    return 0;
+}
+
+static int get_device_frame(v4l2_capture_t *capture, int timeout_ms, v4l2_capture_frame_t *frame)
+{
+    struct pollfd poll_fd = {.fd = capture->fd, .events = POLLIN};
+    struct v4l2_buffer buf;
+    int ret;
+
+    do
+    {
+        ret = poll(&poll_fd, 1, timeout_ms);
+    } while ((-1 == ret) && (EINTR == errno));
+
+    if (0 > ret)
+    {
+        printf("Error! %s(): poll failed (%s)\n", __FUNCTION__, strerror(errno));
+        return -1;
+    }
+
+    if (0 == ret)
+        return 1;
+
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+
+    if (0 != xioctl(capture->fd, VIDIOC_DQBUF, &buf))
+    {
+        if (EAGAIN == errno)
+            return 1;
+
+        printf("Error! %s(): VIDIOC_DQBUF failed (%s)\n", __FUNCTION__, strerror(errno));
+        return -1;
+    }
+
+    // a corrupted or short frame goes back to the driver
+    if ((buf.flags & V4L2_BUF_FLAG_ERROR) || ((0 != buf.bytesused) && (buf.bytesused < capture->frame_size)))
+    {
+        xioctl(capture->fd, VIDIOC_QBUF, &buf);
+        return 1;
+    }
+
+    capture->held[buf.index] = true;
+
+    frame->index = (int)buf.index;
+    frame->data = capture->buffers[buf.index];
+    frame->sequence = buf.sequence;
+    frame->timestamp_us = (uint64_t)buf.timestamp.tv_sec * 1000000 + buf.timestamp.tv_usec;
+
+    return 0;
+}
+
+int v4l2_capture_get_frame(v4l2_capture_t *capture, int timeout_ms, v4l2_capture_frame_t *frame)
+{
+    int ret;
+
+    if ((NULL == capture) || (NULL == frame))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    ret = capture->is_file ? get_file_frame(capture, frame) : get_device_frame(capture, timeout_ms, frame);
+
+    if (0 == ret)
+    {
+        frame->size = capture->frame_size;
+        frame->width = capture->width;
+        frame->height = capture->height;
+        frame->format = capture->format;
+    }
+
+    return ret;
+}
+
+int v4l2_capture_release_frame(v4l2_capture_t *capture, const v4l2_capture_frame_t *frame)
+{
+    if ((NULL == capture) || (NULL == frame) || (0 > frame->index) || (capture->buffer_count <= frame->index) || !capture->held[frame->index])
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return -1;
+    }
+
+    if (!capture->is_file)
+    {
+        struct v4l2_buffer buf;
+
+        memset(&buf, 0, sizeof(buf));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = frame->index;
+
+        if (0 != xioctl(capture->fd, VIDIOC_QBUF, &buf))
+        {
+            printf("Error! %s(): VIDIOC_QBUF failed (%s)\n", __FUNCTION__, strerror(errno));
+            return -1;
+        }
+    }
+
+    capture->held[frame->index] = false;
+
+    return 0;
+}
+
+#else
+
+v4l2_capture_t *v4l2_capture_open(const char *path, int width, int height, kp_image_format_t format, int buffer_count)
+{
+    printf("Error! %s(): V4L2 is not supported on this system\n", __FUNCTION__);
+    return NULL;
+}
+
+void v4l2_capture_close(v4l2_capture_t *capture)
+{
+}
+
+int v4l2_capture_get_frame(v4l2_capture_t *capture, int timeout_ms, v4l2_capture_frame_t *frame)
+{
+    return -1;
+}
+
+int v4l2_capture_release_frame(v4l2_capture_t *capture, const v4l2_capture_frame_t *frame)
+{
+    return -1;
+}
+
+#endif
+
+void v4l2_capture_set_input_node(const v4l2_capture_frame_t *frame, kp_generic_input_node_image_t *input_node)
+{
+    input_node->width = frame->width;
+    input_node->height = frame->height;
+    input_node->image_format = frame->format;
+    input_node->image_buffer = frame->data;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file        v4l2_capture.h
+ * @brief       V4L2 camera capture APIs
+ *
+ * Frames are captured into mmap'd V4L2 buffers in a pixel format the device pre-process reads directly, so a frame buffer
+ * is sent by kp_generic_image_inference_send() as it is, without color conversion or copies on the host:
+ *
+ *     v4l2_capture_get_frame(capture, 1000, &frame);
+ *     v4l2_capture_set_input_node(&frame, &inf_desc.input_node_image_list[0]);
+ *     kp_generic_image_inference_send(device, &inf_desc);      // returns after the image is written to USB
+ *     v4l2_capture_release_frame(capture, &frame);             // the driver can fill the buffer again
+ *
+ * A regular file of raw frames can be opened instead of a video device, it is mmap'd and its frames are returned in a loop.
+ * V4L2 is only available on Linux, v4l2_capture_open() fails on other systems.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "kp_struct.h"
+
+/**
+ * @brief One captured frame, its buffer is owned by the capture until v4l2_capture_release_frame().
+ */
+typedef struct
+{
+    int index;                              /**< buffer index */
+    uint8_t *data;                          /**< frame data in 'format', rows are packed (read only) */
+    uint32_t size;                          /**< bytes of the frame */
+    uint32_t width;                         /**< frame width */
+    uint32_t height;                        /**< frame height */
+    kp_image_format_t format;               /**< image format, refer to kp_image_format_t */
+    uint32_t sequence;                      /**< frame sequence number */
+    uint64_t timestamp_us;                  /**< capture time in microseconds */
+} v4l2_capture_frame_t;
+
+/**
+ * @brief V4L2 capture or file-backed fake capture.
+ */
+typedef struct v4l2_capture_s v4l2_capture_t;
+
+/**
+ * @brief Open a capture and start streaming.
+ *
+ * The formats map to V4L2 pixel formats without conversion: KP_IMAGE_FORMAT_YUYV to YUYV, KP_IMAGE_FORMAT_YUV420 to YU12
+ * (planar I420), KP_IMAGE_FORMAT_RGB565 to RGBP and KP_IMAGE_FORMAT_RAW8 to GREY.
+ * A driver may adjust the size, refer to 'width' and 'height' of the frames. Drivers padding the rows are not supported.
+ *
+ * @param[in] path path of a video device (e.g. "/dev/video0") or of a file of raw frames in 'format'.
+ * @param[in] width frame width.
+ * @param[in] height frame height.
+ * @param[in] format image format, refer to kp_image_format_t.
+ * @param[in] buffer_count number of frame buffers, a frame being sent holds its buffer.
+ *
+ * @return the capture, NULL if failed.
+ */
+v4l2_capture_t *v4l2_capture_open(const char *path, int width, int height, kp_image_format_t format, int buffer_count);
+
+/**
+ * @brief Stop streaming and close a capture, all frames must be released before.
+ *
+ * @param[in] capture the capture.
+ */
+void v4l2_capture_close(v4l2_capture_t *capture);
+
+/**
+ * @brief Get the next captured frame.
+ *
+ * @param[in] capture the capture.
+ * @param[in] timeout_ms max milliseconds to wait for a frame, -1 waits forever.
+ * @param[out] frame the frame.
+ *
+ * @return return 0 means sucessful, 1 if no frame is ready in time (or every buffer is held), otherwise failed.
+ */
+int v4l2_capture_get_frame(v4l2_capture_t *capture, int timeout_ms, v4l2_capture_frame_t *frame);
+
+/**
+ * @brief Give the buffer of a frame back to the capture, after the frame has been sent.
+ *
+ * @param[in] capture the capture.
+ * @param[in] frame the frame from v4l2_capture_get_frame().
+ *
+ * @return return 0 means sucessful, otherwise failed.
+ */
+int v4l2_capture_release_frame(v4l2_capture_t *capture, const v4l2_capture_frame_t *frame);
+
+/**
+ * @brief Point an input image of an inference descriptor to a frame.
+ *
+ * Only the size, format and image buffer are set, the resize, padding, normalize and crop settings are kept.
+ *
+ * @param[in] frame the frame.
+ * @param[out] input_node the input image.
+ */
+void v4l2_capture_set_input_node(const v4l2_capture_frame_t *frame, kp_generic_input_node_image_t *input_node);
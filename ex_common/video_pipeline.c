@@ -0,0 +1,629 @@
+/**
+ * @file        video_pipeline.c
+ * @brief       pipelined video inference APIs
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "kp_inference.h"
+#include "image_convert.h"
+#include "video_pipeline.h"
+
+/* bounded FIFO of slot indexes */
+typedef struct
+{
+    int *items;
+    int capacity;
+    int head;
+    int count;
+    bool closed;                            // no more items will be pushed
+    bool aborted;                           // the pipeline failed, push and pop return at once
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    double occupancy_sum;                   // count x milliseconds, for the average occupancy
+    double last_change_ms;
+} ring_t;
+
+typedef struct
+{
+    uint8_t *frame;                         // RGB888 frame read
+    uint8_t *resized;                       // RGB888 frame letterbox-resized, NULL without host resize
+    uint8_t *image;                         // frame converted to the image format to be sent
+    uint32_t frame_index;
+} frame_slot_t;
+
+typedef struct
+{
+    uint8_t *raw_output_buf;
+    kp_generic_image_inference_result_header_t output_desc;
+    uint32_t frame_index;
+} raw_slot_t;
+
+struct video_pipeline_s
+{
+    kp_device_group_t devices;
+    video_pipeline_config_t config;
+    int send_width;                         // size of the images sent
+    int send_height;
+    frame_slot_t *frame_slots;
+    raw_slot_t *raw_slots;
+    ring_t free_frames;
+    ring_t free_raws;
+    ring_t queues[VIDEO_PIPELINE_QUEUE_COUNT];
+    kp_generic_image_inference_desc_t inf_desc;
+    double stage_busy_ms[VIDEO_PIPELINE_STAGE_COUNT];
+    uint32_t frame_count;
+    pthread_mutex_t status_mutex;
+    int status;                             // error of the first stage which failed
+};
+
+static double time_ms(void)
+{
+    struct timeval time;
+
+    gettimeofday(&time, NULL);
+
+    return time.tv_sec * 1000.0 + time.tv_usec / 1000.0;
+}
+
+static int ring_init(ring_t *ring, int capacity)
+{
+    memset(ring, 0, sizeof(ring_t));
+
+    ring->items = (int *)malloc(sizeof(int) * capacity);
+    if (NULL == ring->items)
+        return -1;
+
+    ring->capacity = capacity;
+    pthread_mutex_init(&ring->mutex, NULL);
+    pthread_cond_init(&ring->not_empty, NULL);
+    pthread_cond_init(&ring->not_full, NULL);
+
+    return 0;
+}
+
+static void ring_destroy(ring_t *ring)
+{
+    if (NULL == ring->items)
+        return;
+
+    free(ring->items);
+    ring->items = NULL;
+    pthread_mutex_destroy(&ring->mutex);
+    pthread_cond_destroy(&ring->not_empty);
+    pthread_cond_destroy(&ring->not_full);
+}
+
+static void ring_reset(ring_t *ring, double now_ms)
+{
+    ring->head = 0;
+    ring->count = 0;
+    ring->closed = false;
+    ring->aborted = false;
+    ring->occupancy_sum = 0;
+    ring->last_change_ms = now_ms;
+}
+
+/* the count changes, accumulate the time the ring held the previous count */
+static void ring_account(ring_t *ring)
+{
+    double now_ms = time_ms();
+
+    ring->occupancy_sum += ring->count * (now_ms - ring->last_change_ms);
+    ring->last_change_ms = now_ms;
+}
+
+/* return 0 if pushed, -1 if the pipeline is aborted */
+static int ring_push(ring_t *ring, int item)
+{
+    int ret = -1;
+
+    pthread_mutex_lock(&ring->mutex);
+
+    while ((ring->count == ring->capacity) && !ring->aborted)
+        pthread_cond_wait(&ring->not_full, &ring->mutex);
+
+    if (!ring->aborted)
+    {
+        ring_account(ring);
+        ring->items[(ring->head + ring->count) % ring->capacity] = item;
+        ring->count++;
+        pthread_cond_signal(&ring->not_empty);
+        ret = 0;
+    }
+
+    pthread_mutex_unlock(&ring->mutex);
+
+    return ret;
+}
+
+/* return 0 if popped, 1 if the ring is closed and empty, -1 if the pipeline is aborted */
+static int ring_pop(ring_t *ring, int *item)
+{
+    int ret;
+
+    pthread_mutex_lock(&ring->mutex);
+
+    while ((0 == ring->count) && !ring->closed && !ring->aborted)
+        pthread_cond_wait(&ring->not_empty, &ring->mutex);
+
+    if (ring->aborted)
+    {
+        ret = -1;
+    }
+    else if (0 == ring->count)
+    {
+        ret = 1;
+    }
+    else
+    {
+        ring_account(ring);
+        *item = ring->items[ring->head];
+        ring->head = (ring->head + 1) % ring->capacity;
+        ring->count--;
+        pthread_cond_signal(&ring->not_full);
+        ret = 0;
+    }
+
+    pthread_mutex_unlock(&ring->mutex);
+
+    return ret;
+}
+
+static void ring_close(ring_t *ring, bool abort)
+{
+    pthread_mutex_lock(&ring->mutex);
+
+    ring->closed = true;
+    ring->aborted |= abort;
+    pthread_cond_broadcast(&ring->not_empty);
+    pthread_cond_broadcast(&ring->not_full);
+
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+/*
+ * a stage failed, no more frames are read or sent. If 'drain', the results of the frames already sent are still received
+ * (and post-processed up to the failed frame), so no result is left in the devices for the next run.
+ */
+static void pipeline_fail(video_pipeline_t *pipeline, int status, bool drain)
+{
+    pthread_mutex_lock(&pipeline->status_mutex);
+    if (0 == pipeline->status)
+        pipeline->status = status;
+    pthread_mutex_unlock(&pipeline->status_mutex);
+
+    ring_close(&pipeline->free_frames, true);
+    ring_close(&pipeline->queues[VIDEO_PIPELINE_QUEUE_DECODED], true);
+    ring_close(&pipeline->queues[VIDEO_PIPELINE_QUEUE_CONVERTED], true);
+
+    if (!drain)
+    {
+        ring_close(&pipeline->free_raws, true);
+        ring_close(&pipeline->queues[VIDEO_PIPELINE_QUEUE_IN_FLIGHT], true);
+        ring_close(&pipeline->queues[VIDEO_PIPELINE_QUEUE_RECEIVED], true);
+    }
+}
+
+static void *read_stage(void *data)
+{
+    video_pipeline_t *pipeline = (video_pipeline_t *)data;
+    uint32_t frame_index = 0;
+    int slot;
+
+    while (0 == ring_pop(&pipeline->free_frames, &slot))
+    {
+        double begin_ms = time_ms();
+        int ret = pipeline->config.read_frame(pipeline->config.user_data, pipeline->frame_slots[slot].frame, pipeline->config.frame_width * 3);
+
+        pipeline->stage_busy_ms[VIDEO_PIPELINE_STAGE_READ] += time_ms() - begin_ms;
+
+        if (1 == ret)
+            break;
+
+        if (0 != ret)
+        {
+            printf("Error! %s(): read_frame() error = %d\n", __FUNCTION__, ret);
+            pipeline_fail(pipeline, ret, true);
+            break;
+        }
+
+        pipeline->frame_slots[slot].frame_index = frame_index++;
+
+        if (0 != ring_push(&pipeline->queues[VIDEO_PIPELINE_QUEUE_DECODED], slot))
+            break;
+    }
+
+    ring_close(&pipeline->queues[VIDEO_PIPELINE_QUEUE_DECODED], false);
+
+    return NULL;
+}
+
+static void *convert_stage(void *data)
+{
+    video_pipeline_t *pipeline = (video_pipeline_t *)data;
+    video_pipeline_config_t *config = &pipeline->config;
+    int slot;
+
+    while (0 == ring_pop(&pipeline->queues[VIDEO_PIPELINE_QUEUE_DECODED], &slot))
+    {
+        frame_slot_t *frame_slot = &pipeline->frame_slots[slot];
+        const uint8_t *src = frame_slot->frame;
+        double begin_ms = time_ms();
+        int ret = 0;
+
+        if (NULL != frame_slot->resized)
+        {
+            ret = image_convert_resize_rgb888(frame_slot->frame, config->frame_width * 3, config->frame_width, config->frame_height,
+                                              frame_slot->resized, pipeline->send_width * 3, pipeline->send_width, pipeline->send_height,
+                                              IMAGE_CONVERT_RESIZE_AREA, config->convert_thread_count);
+            src = frame_slot->resized;
+        }
+
+        if (0 == ret)
+            ret = image_convert_from_rgb888(src, pipeline->send_width * 3, (image_convert_order_t)config->frame_order, pipeline->send_width,
+                                            pipeline->send_height, (kp_image_format_t)config->image_format, frame_slot->image,
+                                            config->convert_thread_count);
+
+        pipeline->stage_busy_ms[VIDEO_PIPELINE_STAGE_CONVERT] += time_ms() - begin_ms;
+
+        if (0 != ret)
+        {
+            printf("Error! %s(): failed to convert frame %u\n", __FUNCTION__, frame_slot->frame_index);
+            pipeline_fail(pipeline, KP_ERROR_INVALID_PARAM_12, true);
+            break;
+        }
+
+        if (0 != ring_push(&pipeline->queues[VIDEO_PIPELINE_QUEUE_CONVERTED], slot))
+            break;
+    }
+
+    ring_close(&pipeline->queues[VIDEO_PIPELINE_QUEUE_CONVERTED], false);
+
+    return NULL;
+}
+
+static void *send_stage(void *data)
+{
+    video_pipeline_t *pipeline = (video_pipeline_t *)data;
+    int slot;
+
+    while (0 == ring_pop(&pipeline->queues[VIDEO_PIPELINE_QUEUE_CONVERTED], &slot))
+    {
+        frame_slot_t *frame_slot = &pipeline->frame_slots[slot];
+        uint32_t frame_index = frame_slot->frame_index;
+        double begin_ms = time_ms();
+        int ret;
+
+        pipeline->inf_desc.inference_number = frame_index;
+        pipeline->inf_desc.input_node_image_list[0].image_buffer = frame_slot->image;
+
+        // returns after the image is written to USB, so the frame slot can be reused
+        ret = kp_generic_image_inference_send(pipeline->devices, &pipeline->inf_desc);
+
+        pipeline->stage_busy_ms[VIDEO_PIPELINE_STAGE_SEND] += time_ms() - begin_ms;
+
+        if (KP_SUCCESS != ret)
+        {
+            printf("Error! %s(): kp_generic_image_inference_send() error = %d\n", __FUNCTION__, ret);
+            pipeline_fail(pipeline, ret, true);
+            break;
+        }
+
+        // the frame is in flight before its slot is freed, its result is received even if the pipeline fails now
+        if ((0 != ring_push(&pipeline->queues[VIDEO_PIPELINE_QUEUE_IN_FLIGHT], (int)frame_index)) ||
+            (0 != ring_push(&pipeline->free_frames, slot)))
+            break;
+    }
+
+    ring_close(&pipeline->queues[VIDEO_PIPELINE_QUEUE_IN_FLIGHT], false);
+
+    return NULL;
+}
+
+static void *receive_stage(void *data)
+{
+    video_pipeline_t *pipeline = (video_pipeline_t *)data;
+    int frame_index;
+    int slot;
+
+    while ((0 == ring_pop(&pipeline->queues[VIDEO_PIPELINE_QUEUE_IN_FLIGHT], &frame_index)) &&
+           (0 == ring_pop(&pipeline->free_raws, &slot)))
+    {
+        raw_slot_t *raw_slot = &pipeline->raw_slots[slot];
+        double begin_ms = time_ms();
+        int ret;
+
+        ret = kp_generic_image_inference_receive(pipeline->devices, &raw_slot->output_desc, raw_slot->raw_output_buf, pipeline->config.raw_buf_size);
+
+        pipeline->stage_busy_ms[VIDEO_PIPELINE_STAGE_RECEIVE] += time_ms() - begin_ms;
+
+        if (KP_SUCCESS != ret)
+        {
+            printf("Error! %s(): kp_generic_image_inference_receive() error = %d\n", __FUNCTION__, ret);
+            pipeline_fail(pipeline, ret, false);
+            break;
+        }
+
+        if (raw_slot->output_desc.inference_number != (uint32_t)frame_index)
+        {
+            printf("Error! %s(): result of frame %u is received for frame %d\n", __FUNCTION__, raw_slot->output_desc.inference_number, frame_index);
+            pipeline_fail(pipeline, KP_ERROR_RECV_DATA_FAIL_17, false);
+            break;
+        }
+
+        // boxes are mapped to the frame read instead of the host-resized image
+        if (pipeline->config.host_resize)
+            image_convert_restore_pre_proc_info(&raw_slot->output_desc.pre_proc_info[0], pipeline->config.frame_width, pipeline->config.frame_height);
+
+        raw_slot->frame_index = (uint32_t)frame_index;
+
+        if (0 != ring_push(&pipeline->queues[VIDEO_PIPELINE_QUEUE_RECEIVED], slot))
+            break;
+    }
+
+    ring_close(&pipeline->queues[VIDEO_PIPELINE_QUEUE_RECEIVED], false);
+
+    return NULL;
+}
+
+static void *post_process_stage(void *data)
+{
+    video_pipeline_t *pipeline = (video_pipeline_t *)data;
+    bool failed = false;
+    int slot;
+
+    while (0 == ring_pop(&pipeline->queues[VIDEO_PIPELINE_QUEUE_RECEIVED], &slot))
+    {
+        raw_slot_t *raw_slot = &pipeline->raw_slots[slot];
+        double begin_ms = time_ms();
+        int ret = 0;
+
+        // results after a failed post-process are only drained
+        if (failed)
+        {
+            if (0 != ring_push(&pipeline->free_raws, slot))
+                break;
+
+            continue;
+        }
+
+        if (NULL != pipeline->config.post_process)
+            ret = pipeline->config.post_process(pipeline->config.user_data, raw_slot->frame_index, &raw_slot->output_desc, raw_slot->raw_output_buf);
+
+        pipeline->stage_busy_ms[VIDEO_PIPELINE_STAGE_POST_PROCESS] += time_ms() - begin_ms;
+
+        if (0 != ret)
+        {
+            printf("Error! %s(): post_process() error = %d\n", __FUNCTION__, ret);
+            pipeline_fail(pipeline, ret, true);
+            failed = true;
+        }
+        else
+        {
+            pipeline->frame_count++;
+        }
+
+        if (0 != ring_push(&pipeline->free_raws, slot))
+            break;
+    }
+
+    return NULL;
+}
+
+void video_pipeline_release(video_pipeline_t *pipeline)
+{
+    if (NULL == pipeline)
+        return;
+
+    if (NULL != pipeline->frame_slots)
+    {
+        for (int i = 0; i < pipeline->config.frame_slot_count; i++)
+        {
+            free(pipeline->frame_slots[i].frame);
+            free(pipeline->frame_slots[i].resized);
+            free(pipeline->frame_slots[i].image);
+        }
+    }
+
+    if (NULL != pipeline->raw_slots)
+    {
+        for (int i = 0; i < pipeline->config.raw_slot_count; i++)
+            free(pipeline->raw_slots[i].raw_output_buf);
+    }
+
+    ring_destroy(&pipeline->free_frames);
+    ring_destroy(&pipeline->free_raws);
+
+    for (int i = 0; i < VIDEO_PIPELINE_QUEUE_COUNT; i++)
+        ring_destroy(&pipeline->queues[i]);
+
+    pthread_mutex_destroy(&pipeline->status_mutex);
+    free(pipeline->frame_slots);
+    free(pipeline->raw_slots);
+    free(pipeline);
+}
+
+video_pipeline_t *video_pipeline_create(kp_device_group_t devices, const video_pipeline_config_t *config)
+{
+    video_pipeline_t *pipeline;
+    int image_size;
+    bool failed = false;
+
+    if ((NULL == devices) || (NULL == config) || (NULL == config->read_frame) || (0 >= config->frame_width) || (0 >= config->frame_height) ||
+        (2 > config->frame_slot_count) || (2 > config->raw_slot_count) || (1 > config->max_in_flight) || (0 == config->raw_buf_size) ||
+        (1 > config->convert_thread_count))
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return NULL;
+    }
+
+    pipeline = (video_pipeline_t *)calloc(1, sizeof(video_pipeline_t));
+    if (NULL == pipeline)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pipeline->status_mutex, NULL);
+    pipeline->devices = devices;
+    pipeline->config = *config;
+
+    /* the device still pads the host-resized image into the model input */
+    pipeline->send_width = config->frame_width;
+    pipeline->send_height = config->frame_height;
+
+    if (config->host_resize &&
+        (0 != image_convert_letterbox_size(config->frame_width, config->frame_height, config->model_width, config->model_height,
+                                           (kp_padding_mode_t)config->padding_mode, (kp_image_format_t)config->image_format,
+                                           &pipeline->send_width, &pipeline->send_height)))
+    {
+        printf("Error! %s(): failed to get the resized size\n", __FUNCTION__);
+        video_pipeline_release(pipeline);
+        return NULL;
+    }
+
+    // no resize if the frame fits in the model input
+    pipeline->config.host_resize = config->host_resize && ((pipeline->send_width != config->frame_width) || (pipeline->send_height != config->frame_height));
+
+    image_size = image_convert_buffer_size(pipeline->send_width, pipeline->send_height, (kp_image_format_t)config->image_format);
+    if (0 >= image_size)
+    {
+        printf("Error! %s(): image format 0x%x is not supported\n", __FUNCTION__, config->image_format);
+        video_pipeline_release(pipeline);
+        return NULL;
+    }
+
+    pipeline->frame_slots = (frame_slot_t *)calloc(config->frame_slot_count, sizeof(frame_slot_t));
+    pipeline->raw_slots = (raw_slot_t *)calloc(config->raw_slot_count, sizeof(raw_slot_t));
+    failed = (NULL == pipeline->frame_slots) || (NULL == pipeline->raw_slots);
+
+    for (int i = 0; !failed && (i < config->frame_slot_count); i++)
+    {
+        frame_slot_t *slot = &pipeline->frame_slots[i];
+
+        slot->frame = (uint8_t *)malloc((size_t)config->frame_width * config->frame_height * 3);
+        slot->image = (uint8_t *)malloc(image_size);
+        if (pipeline->config.host_resize)
+            slot->resized = (uint8_t *)malloc((size_t)pipeline->send_width * pipeline->send_height * 3);
+
+        failed = (NULL == slot->frame) || (NULL == slot->image) || (pipeline->config.host_resize && (NULL == slot->resized));
+    }
+
+    for (int i = 0; !failed && (i < config->raw_slot_count); i++)
+    {
+        pipeline->raw_slots[i].raw_output_buf = (uint8_t *)malloc(config->raw_buf_size);
+        failed = (NULL == pipeline->raw_slots[i].raw_output_buf);
+    }
+
+    failed = failed || (0 != ring_init(&pipeline->free_frames, config->frame_slot_count)) ||
+             (0 != ring_init(&pipeline->free_raws, config->raw_slot_count)) ||
+             (0 != ring_init(&pipeline->queues[VIDEO_PIPELINE_QUEUE_DECODED], config->frame_slot_count)) ||
+             (0 != ring_init(&pipeline->queues[VIDEO_PIPELINE_QUEUE_CONVERTED], config->frame_slot_count)) ||
+             (0 != ring_init(&pipeline->queues[VIDEO_PIPELINE_QUEUE_IN_FLIGHT], config->max_in_flight)) ||
+             (0 != ring_init(&pipeline->queues[VIDEO_PIPELINE_QUEUE_RECEIVED], config->raw_slot_count));
+
+    if (failed)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        video_pipeline_release(pipeline);
+        return NULL;
+    }
+
+    /* the input descriptor is the same for all frames except the buffer and the inference number */
+    pipeline->inf_desc.model_id = config->model_id;
+    pipeline->inf_desc.num_input_node_image = 1;
+    pipeline->inf_desc.input_node_image_list[0].resize_mode = KP_RESIZE_ENABLE;
+    pipeline->inf_desc.input_node_image_list[0].padding_mode = config->padding_mode;
+    pipeline->inf_desc.input_node_image_list[0].normalize_mode = config->normalize_mode;
+    pipeline->inf_desc.input_node_image_list[0].image_format = config->image_format;
+    pipeline->inf_desc.input_node_image_list[0].width = pipeline->send_width;
+    pipeline->inf_desc.input_node_image_list[0].height = pipeline->send_height;
+    pipeline->inf_desc.input_node_image_list[0].crop_count = 0;
+
+    return pipeline;
+}
+
+int video_pipeline_run(video_pipeline_t *pipeline, video_pipeline_statistics_t *statistics)
+{
+    void *(*stages[VIDEO_PIPELINE_STAGE_COUNT])(void *) = {read_stage, convert_stage, send_stage, receive_stage, post_process_stage};
+    pthread_t threads[VIDEO_PIPELINE_STAGE_COUNT];
+    bool created[VIDEO_PIPELINE_STAGE_COUNT] = {false};
+    double begin_ms;
+    double elapsed_ms;
+
+    if (NULL == pipeline)
+    {
+        printf("Error! %s(): invalid parameters\n", __FUNCTION__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    begin_ms = time_ms();
+
+    ring_reset(&pipeline->free_frames, begin_ms);
+    ring_reset(&pipeline->free_raws, begin_ms);
+
+    for (int i = 0; i < VIDEO_PIPELINE_QUEUE_COUNT; i++)
+        ring_reset(&pipeline->queues[i], begin_ms);
+
+    for (int i = 0; i < pipeline->config.frame_slot_count; i++)
+        ring_push(&pipeline->free_frames, i);
+
+    for (int i = 0; i < pipeline->config.raw_slot_count; i++)
+        ring_push(&pipeline->free_raws, i);
+
+    memset(pipeline->stage_busy_ms, 0, sizeof(pipeline->stage_busy_ms));
+    pipeline->frame_count = 0;
+    pipeline->status = 0;
+
+    for (int i = 0; i < VIDEO_PIPELINE_STAGE_COUNT; i++)
+    {
+        created[i] = (0 == pthread_create(&threads[i], NULL, stages[i], pipeline));
+
+        if (!created[i])
+        {
+            printf("Error! %s(): failed to create the thread of stage %d\n", __FUNCTION__, i);
+            pipeline_fail(pipeline, KP_ERROR_OTHER_99, false);
+            break;
+        }
+    }
+
+    for (int i = 0; i < VIDEO_PIPELINE_STAGE_COUNT; i++)
+    {
+        if (created[i])
+            pthread_join(threads[i], NULL);
+    }
+
+    elapsed_ms = time_ms() - begin_ms;
+
+    if (NULL != statistics)
+    {
+        memset(statistics, 0, sizeof(video_pipeline_statistics_t));
+
+        statistics->frame_count = pipeline->frame_count;
+        statistics->elapsed_ms = elapsed_ms;
+        statistics->fps = (0 < elapsed_ms) ? pipeline->frame_count * 1000.0 / elapsed_ms : 0;
+
+        for (int i = 0; (i < VIDEO_PIPELINE_STAGE_COUNT) && (0 < elapsed_ms); i++)
+            statistics->stage_busy[i] = pipeline->stage_busy_ms[i] / elapsed_ms;
+
+        for (int i = 0; (i < VIDEO_PIPELINE_QUEUE_COUNT) && (0 < elapsed_ms); i++)
+        {
+            ring_t *ring = &pipeline->queues[i];
+
+            ring_account(ring);
+            statistics->queue_occupancy[i] = ring->occupancy_sum / elapsed_ms / ring->capacity;
+        }
+    }
+
+    return pipeline->status;
+}
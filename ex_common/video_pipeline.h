@@ -0,0 +1,147 @@
+/**
+ * @file        video_pipeline.h
+ * @brief       pipelined video inference APIs
+ *
+ * Frames of a video are read, color-converted, sent, received and post-processed by five stages, each in its own thread.
+ * The stages are connected by bounded ring buffers of frame slots and raw output slots, so the host works on the next frames
+ * while the device infers the current one, and a stage blocks when the stage after it falls behind (back-pressure):
+ *
+ *     read -> [decoded] -> convert -> [converted] -> send -> [in flight] -> receive -> [received] -> post-process
+ *
+ * Frames are read as RGB888/BGR888 pixels by a callback (e.g. from cv::VideoCapture or a file of raw frames), converted by
+ * image_convert (optionally letterbox-resized to the model input on the host), and the raw output of each frame is given
+ * to a post-process callback in frame order.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "kp_struct.h"
+
+/**
+ * @brief Stages of a video pipeline.
+ */
+typedef enum
+{
+    VIDEO_PIPELINE_STAGE_READ = 0,          /**< read a frame by 'read_frame' */
+    VIDEO_PIPELINE_STAGE_CONVERT,           /**< resize and convert the frame to the image format to be sent */
+    VIDEO_PIPELINE_STAGE_SEND,              /**< kp_generic_image_inference_send() */
+    VIDEO_PIPELINE_STAGE_RECEIVE,           /**< kp_generic_image_inference_receive() */
+    VIDEO_PIPELINE_STAGE_POST_PROCESS,      /**< post-process the raw output by 'post_process' */
+    VIDEO_PIPELINE_STAGE_COUNT
+} video_pipeline_stage_t;
+
+/**
+ * @brief Ring buffers between the stages, the ring i is the input of stage i + 1.
+ */
+typedef enum
+{
+    VIDEO_PIPELINE_QUEUE_DECODED = 0,       /**< frames read, waiting for conversion */
+    VIDEO_PIPELINE_QUEUE_CONVERTED,         /**< frames converted, waiting to be sent */
+    VIDEO_PIPELINE_QUEUE_IN_FLIGHT,         /**< frames sent, waiting for their results */
+    VIDEO_PIPELINE_QUEUE_RECEIVED,          /**< raw outputs received, waiting for post-processing */
+    VIDEO_PIPELINE_QUEUE_COUNT
+} video_pipeline_queue_t;
+
+/**
+ * @brief Read the next frame.
+ *
+ * @param[in] user_data 'user_data' of the config.
+ * @param[out] rgb888 first row of the frame, 'frame_width' x 'frame_height' pixels in 'frame_order'.
+ * @param[in] stride bytes from one row to the next.
+ *
+ * @return 0 if a frame is read, 1 at the end of the video, otherwise failed.
+ */
+typedef int (*video_pipeline_read_frame_t)(void *user_data, uint8_t *rgb888, int stride);
+
+/**
+ * @brief Post-process the result of a frame, results are given in frame order.
+ *
+ * @param[in] user_data 'user_data' of the config.
+ * @param[in] frame_index index of the frame from 0.
+ * @param[in] output_desc output descriptor, pre_proc_info[0] refers to the frame read even if it is resized on the host.
+ * @param[in] raw_output_buf raw output of the frame.
+ *
+ * @return return 0 means sucessful, otherwise failed and the pipeline stops.
+ */
+typedef int (*video_pipeline_post_process_t)(void *user_data, uint32_t frame_index, kp_generic_image_inference_result_header_t *output_desc,
+                                             uint8_t *raw_output_buf);
+
+/**
+ * @brief Configuration of a video pipeline.
+ */
+typedef struct
+{
+    int frame_width;                        /**< width of the frames read */
+    int frame_height;                       /**< height of the frames read */
+    uint32_t frame_order;                   /**< byte order of the frames read, refer to image_convert_order_t */
+    uint32_t model_id;                      /**< target inference model ID */
+    int model_width;                        /**< model input width, used by 'host_resize' */
+    int model_height;                       /**< model input height, used by 'host_resize' */
+    uint32_t image_format;                  /**< image format sent to the device, refer to kp_image_format_t */
+    uint32_t normalize_mode;                /**< inference normalization of the model, refer to kp_normalize_mode_t */
+    uint32_t padding_mode;                  /**< padding mode of the device pre-process, refer to kp_padding_mode_t */
+    bool host_resize;                       /**< letterbox-resize frames to the model input on the host, USB carries model-sized images */
+    int convert_thread_count;               /**< max number of threads converting one frame */
+    int frame_slot_count;                   /**< number of frame buffers shared by the read, convert and send stages, at least 2 */
+    int raw_slot_count;                     /**< number of raw output buffers shared by the receive and post-process stages, at least 2 */
+    int max_in_flight;                      /**< max number of frames sent and not received yet, at least 1 */
+    uint32_t raw_buf_size;                  /**< size of a raw output buffer, e.g. max_raw_out_size of the model */
+    video_pipeline_read_frame_t read_frame; /**< frame reader */
+    video_pipeline_post_process_t post_process; /**< post-processing of the raw outputs */
+    void *user_data;                        /**< user data of the callbacks */
+} video_pipeline_config_t;
+
+/**
+ * @brief Statistics of a video pipeline run.
+ */
+typedef struct
+{
+    uint32_t frame_count;                                   /**< number of frames post-processed */
+    double elapsed_ms;                                      /**< time of the run in milliseconds */
+    double fps;                                             /**< frames post-processed per second */
+    double stage_busy[VIDEO_PIPELINE_STAGE_COUNT];          /**< fraction of the run each stage was working (not waiting for a ring buffer) */
+    double queue_occupancy[VIDEO_PIPELINE_QUEUE_COUNT];     /**< average fraction of each ring buffer holding items */
+} video_pipeline_statistics_t;
+
+/**
+ * @brief Video inference pipeline of one model on a device group.
+ */
+typedef struct video_pipeline_s video_pipeline_t;
+
+/**
+ * @brief Create a video pipeline.
+ *
+ * @param[in] devices a connected device group with the model loaded.
+ * @param[in] config configuration of the pipeline.
+ *
+ * @return the pipeline, NULL if failed.
+ */
+video_pipeline_t *video_pipeline_create(kp_device_group_t devices, const video_pipeline_config_t *config);
+
+/**
+ * @brief Release a video pipeline.
+ *
+ * @param[in] pipeline the pipeline.
+ */
+void video_pipeline_release(video_pipeline_t *pipeline);
+
+/**
+ * @brief Run the pipeline until the end of the video or an error of a stage.
+ *
+ * No other inference should be sent to or received from the device group at the same time. If a stage fails, no more frames
+ * are read or sent, and the results of the frames already sent are still received (unless receiving failed), so the devices
+ * hold no stale results. The pipeline can be run again, e.g. on the next video.
+ *
+ * @param[in] pipeline the pipeline.
+ * @param[out] statistics statistics of the run, NULL to ignore.
+ *
+ * @return return 0 means sucessful, otherwise the error of the first stage which failed.
+ */
+int video_pipeline_run(video_pipeline_t *pipeline, video_pipeline_statistics_t *statistics);
@@ -127,6 +127,103 @@ kp_inf_fixed_node_output_t *kp_generic_inference_retrieve_fixed_node(uint32_t no
  */
 kp_inf_float_node_output_t *kp_generic_inference_retrieve_float_node(uint32_t node_idx, uint8_t *raw_out_buffer, kp_channel_ordering_t ordering);
 
+/**
+ * @brief Retrieve a lightweight view of single node output data from raw output buffer.
+ *
+ * This function only parses the node metadata, the NPU data is neither copied nor converted. Values can be read by kp_inf_node_view_get_float(), kp_inf_node_view_get_float_row() and kp_inf_node_view_extract_float_region().
+ *
+ * The view actually points to raw_out_buffer so do not free raw_out_buffer before completing the use of the view. No release is needed for the view.
+ *
+ * @param[in] node_idx wanted output node index, starts from 0. Number of total output nodes can be known from 'kp_generic_raw_result_header_t'
+ * @param[in] raw_out_buffer the RAW output buffer, it should come from kp_generic_raw_inference_receive().
+ * @param[out] node_view refer to kp_inf_node_view_t, a user-allocated view to be filled.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+int kp_generic_inference_retrieve_node_view(uint32_t node_idx, uint8_t *raw_out_buffer, kp_inf_node_view_t *node_view);
+
+/**
+ * @brief Attach the reciprocal quantization factor table of the model output node to a node view.
+ *
+ * The table is built for each output node at model loading ('quantization_reciprocal_factor' of the quantization parameters).
+ * An attached view multiplies the fixed-point values by it instead of dividing them by the factors of the RAW output buffer,
+ * so its values may differ from kp_generic_inference_retrieve_float_node() in the last bit.
+ *
+ * @param[in,out] node_view node view from kp_generic_inference_retrieve_node_view().
+ * @param[in] output_node the output node of the inference model with the same index as the view, it should come from 'output_nodes' of kp_single_model_descriptor_t.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+int kp_inf_node_view_attach_model_output_node(kp_inf_node_view_t *node_view, kp_tensor_descriptor_t *output_node);
+
+/**
+ * @brief Read single floating-point value from a node view.
+ *
+ * @param[in] node_view node view from kp_generic_inference_retrieve_node_view().
+ * @param[in] index index of each axis, length should be 'shape_len' of node view.
+ * @param[out] value dequantized floating-point value.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+int kp_inf_node_view_get_float(kp_inf_node_view_t *node_view, int32_t *index, float *value);
+
+/**
+ * @brief Read one row (all values along the last axis) of floating-point values from a node view.
+ *
+ * @param[in] node_view node view from kp_generic_inference_retrieve_node_view().
+ * @param[in] index index of each axis, length should be 'shape_len' of node view, index of the last axis is ignored.
+ * @param[out] row_buffer a user-allocated buffer for the floating-point values.
+ * @param[in] buf_len number of floating-point values the row_buffer can hold, should be larger than or equal to the last dimension of shape.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+int kp_inf_node_view_get_float_row(kp_inf_node_view_t *node_view, int32_t *index, float *row_buffer, uint32_t buf_len);
+
+/**
+ * @brief Extract a sub-region of floating-point values from a node view, values outside the region are not converted.
+ *
+ * @param[in] node_view node view from kp_generic_inference_retrieve_node_view().
+ * @param[in] start start index of each axis, length should be 'shape_len' of node view.
+ * @param[in] size region size of each axis, length should be 'shape_len' of node view.
+ * @param[out] region_buffer a user-allocated buffer for the floating-point values in sequential order of the region.
+ * @param[in] buf_len number of floating-point values the region_buffer can hold, should be larger than or equal to the product of size.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+int kp_inf_node_view_extract_float_region(kp_inf_node_view_t *node_view, int32_t *start, int32_t *size, float *region_buffer, uint32_t buf_len);
+
+/**
+ * @brief Get the arena size needed by kp_generic_inference_retrieve_float_node_list() for a model.
+ *
+ * The size only depends on the model, so it can be computed once after kp_load_model() and reused for every inference.
+ *
+ * @param[in] single_model_desc model descriptor of the inference model, it should come from 'models' of kp_model_nef_descriptor_t.
+ * @param[out] arena_size needed arena size in bytes.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+int kp_generic_inference_get_float_node_list_size(kp_single_model_descriptor_t *single_model_desc, uint32_t *arena_size);
+
+/**
+ * @brief Retrieve all output nodes data from raw output buffer into one contiguous arena.
+ *
+ * This function converts RAW format data of every output node to floating-point data (same as kp_generic_inference_retrieve_float_node()), and lays out all nodes in a single arena.
+ *
+ * If 'arena' is NULL, one buffer is allocated internally and must be released by kp_release_float_node_output_list(), otherwise no memory is allocated and the user-provided arena can be reused for the next inference.
+ *
+ * If 'single_model_desc' is given, every node is converted with the reciprocal quantization factor table of its model output node (ref. kp_inf_node_view_attach_model_output_node()).
+ *
+ * @param[in] raw_out_buffer the RAW output buffer, it should come from kp_generic_raw_inference_receive().
+ * @param[in] ordering the RAW output channel ordering
+ * @param[in] single_model_desc model descriptor of the inference model from 'models' of kp_model_nef_descriptor_t, or NULL to convert with the quantization parameters of the RAW output buffer.
+ * @param[in] arena a user-provided buffer aligned to 16 bytes, or NULL to allocate it internally.
+ * @param[in] arena_size size of the user-provided arena, the needed size can be known from kp_generic_inference_get_float_node_list_size().
+ * @param[out] node_output_list refer to kp_inf_float_node_output_list_t, it points to the beginning of the arena.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+int kp_generic_inference_retrieve_float_node_list(uint8_t *raw_out_buffer, kp_channel_ordering_t ordering, kp_single_model_descriptor_t *single_model_desc, void *arena, uint32_t arena_size, kp_inf_float_node_output_list_t **node_output_list);
+
 /**
  * @brief send image for age gender inference
  *
@@ -237,6 +334,13 @@ void kp_release_fixed_node_output(kp_inf_fixed_node_output_t *fixed_node_output)
  */
 void kp_release_float_node_output(kp_inf_float_node_output_t *float_node_output);
 
+/**
+ * @brief Release all output nodes data retrieved by kp_generic_inference_retrieve_float_node_list() in one operation
+ *
+ * @param node_output_list kp_inf_float_node_output_list_t to be released (nothing is freed for user-provided arena)
+ */
+void kp_release_float_node_output_list(kp_inf_float_node_output_list_t *node_output_list);
+
 /**
  * @brief Release the debug checkpoint data
  *
@@ -0,0 +1,380 @@
+/**
+ * @file        kp_inference.hpp
+ * @brief       Kneron PLUS inference C++ kernels (header-only, C++17)
+ *
+ * Compile-time specialized node conversion kernels over kp_inf_node_view_t.
+ * Each kernel is instantiated on <Layout, SrcT, DstT, PerChannel> so the inner loops carry no layout or element size branches,
+ * kp::retrieve_node() dispatches from the node metadata to the right instantiation at runtime.
+ *
+ * The results are identical to kp_inf_node_view_extract_float_region() over the whole node (DstT = float),
+ * or the fixed-point values of the node in the same ordering (DstT = int8_t/int16_t/int32_t).
+ * A view with the reciprocal quantization factor table attached (kp_inf_node_view_attach_model_output_node()) is converted by
+ * multiplication (Reciprocal = true), as kp_inf_node_view_extract_float_region() does for it.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+extern "C"
+{
+#include "kp_struct.h"
+#include "kp_inference.h"
+}
+
+namespace kp
+{
+
+/**
+ * @brief NPU data access pattern of a node, resolved from kp_model_tensor_data_layout_t and the RAW output schema version.
+ */
+enum class npu_layout
+{
+    int8,                               /**< 8-bit values at stride_npu offsets (4W4C8B, 16W1C8B, RAW_8B, 1W16C8B_CH_COMPACT, all 8-bit KL520/KL720/KL630 outputs) */
+    int8_channel_group,                 /**< 8-bit values grouped by 16 channels (1W16C8B) */
+    int16,                              /**< 16-bit values at stride_npu offsets (KL720/KL630 8W1C16B) */
+    int16_lsb_masked,                   /**< 16-bit values with LSB cleared (KL730/KL830 8W1C16B, RAW_16B) */
+    int16_high_low,                     /**< 16-bit values split into low/high 16 bytes planes (4W4C8BHL, 16W1C8BHL, 1W16C8BHL_CH_COMPACT) */
+    int16_high_low_channel_group,       /**< 16-bit values split into low/high planes and grouped by 16 channels (1W16C8BHL) */
+    unknown,                            /**< not supported */
+};
+
+namespace detail
+{
+
+template <npu_layout Layout>
+struct npu_layout_traits
+{
+    using fixed_type = int8_t;
+    static constexpr bool channel_group = (npu_layout::int8_channel_group == Layout) || (npu_layout::int16_high_low_channel_group == Layout);
+};
+
+template <> struct npu_layout_traits<npu_layout::int16> { using fixed_type = int16_t; static constexpr bool channel_group = false; };
+template <> struct npu_layout_traits<npu_layout::int16_lsb_masked> { using fixed_type = int16_t; static constexpr bool channel_group = false; };
+template <> struct npu_layout_traits<npu_layout::int16_high_low> { using fixed_type = int16_t; static constexpr bool channel_group = false; };
+template <> struct npu_layout_traits<npu_layout::int16_high_low_channel_group> { using fixed_type = int16_t; static constexpr bool channel_group = true; };
+
+template <npu_layout Layout>
+inline int32_t read_fixed_point_value(const uint8_t *npu_data, uint32_t npu_data_buf_offset)
+{
+    if constexpr ((npu_layout::int8 == Layout) || (npu_layout::int8_channel_group == Layout)) {
+        return reinterpret_cast<const int8_t *>(npu_data)[npu_data_buf_offset];
+    } else if constexpr (npu_layout::int16 == Layout) {
+        return reinterpret_cast<const int16_t *>(npu_data)[npu_data_buf_offset];
+    } else if constexpr (npu_layout::int16_lsb_masked == Layout) {
+        return static_cast<int16_t>(reinterpret_cast<const uint16_t *>(npu_data)[npu_data_buf_offset] & 0xfffeu);
+    } else {
+        /* npu_data_buf_offset = (npu_data_buf_offset / 16) * 32 + (npu_data_buf_offset % 16) */
+        npu_data_buf_offset = ((npu_data_buf_offset >> 4) << 5) + (npu_data_buf_offset & 15u);
+
+        return static_cast<int16_t>(((static_cast<uint16_t>(npu_data[npu_data_buf_offset]) & 0x007fu) +
+                                     (static_cast<uint16_t>(npu_data[npu_data_buf_offset + 16]) << 7)) << 1);
+    }
+}
+
+inline float pow2(int exp)
+{
+    if (0 <= exp)
+        return static_cast<float>(0x1ULL << exp);
+    else
+        return 1.0f / static_cast<float>(0x1ULL << -exp);
+}
+
+template <bool Reciprocal = false>
+inline bool get_quantization_factor(const kp_inf_node_view_t &node_view, uint32_t quantized_fixed_point_descriptor_idx, float &quantization_factor)
+{
+    int32_t radix   = 0;
+    float scale     = 0;
+
+    if (quantized_fixed_point_descriptor_idx >= node_view.quantization_parameters_len)
+        return false;
+
+    if constexpr (Reciprocal) {
+        /* table built at model loading: 1 / (scale * 2^radix) */
+        quantization_factor = node_view.quantization_reciprocal_factor[quantized_fixed_point_descriptor_idx];
+        return true;
+    }
+
+    switch (node_view.radix_dtype)
+    {
+    case KP_DTYPE_INT8:     radix = static_cast<const int8_t *>(node_view.radix)[quantized_fixed_point_descriptor_idx]; break;
+    case KP_DTYPE_INT16:    radix = static_cast<const int16_t *>(node_view.radix)[quantized_fixed_point_descriptor_idx]; break;
+    case KP_DTYPE_INT32:    radix = static_cast<const int32_t *>(node_view.radix)[quantized_fixed_point_descriptor_idx]; break;
+    default:                return false;
+    }
+
+    switch (node_view.scale_dtype)
+    {
+    case KP_DTYPE_INT8:     scale = static_cast<float>(static_cast<const int8_t *>(node_view.scale)[quantized_fixed_point_descriptor_idx]); break;
+    case KP_DTYPE_INT16:    scale = static_cast<float>(static_cast<const int16_t *>(node_view.scale)[quantized_fixed_point_descriptor_idx]); break;
+    case KP_DTYPE_INT32:    scale = static_cast<float>(static_cast<const int32_t *>(node_view.scale)[quantized_fixed_point_descriptor_idx]); break;
+    case KP_DTYPE_UINT8:    scale = static_cast<float>(static_cast<const uint8_t *>(node_view.scale)[quantized_fixed_point_descriptor_idx]); break;
+    case KP_DTYPE_UINT16:   scale = static_cast<float>(static_cast<const uint16_t *>(node_view.scale)[quantized_fixed_point_descriptor_idx]); break;
+    case KP_DTYPE_UINT32:   scale = static_cast<float>(static_cast<const uint32_t *>(node_view.scale)[quantized_fixed_point_descriptor_idx]); break;
+    case KP_DTYPE_FLOAT32:  scale = static_cast<const float *>(node_view.scale)[quantized_fixed_point_descriptor_idx]; break;
+    default:                return false;
+    }
+
+    quantization_factor = static_cast<float>(scale * pow2(radix));
+
+    return true;
+}
+
+template <npu_layout Layout, typename DstT, bool Reciprocal = false>
+inline void convert_row(const uint8_t *npu_data, uint32_t npu_data_buf_offset, uint32_t npu_stride, int32_t count, float quantization_factor, DstT *dst)
+{
+    if (1 == npu_stride) {
+        /* contiguous row, the common case for the innermost axis */
+        for (int32_t i = 0; i < count; i++) {
+            if constexpr (std::is_floating_point<DstT>::value && Reciprocal)
+                dst[i] = static_cast<float>(read_fixed_point_value<Layout>(npu_data, npu_data_buf_offset + i)) * quantization_factor;
+            else if constexpr (std::is_floating_point<DstT>::value)
+                dst[i] = static_cast<float>(read_fixed_point_value<Layout>(npu_data, npu_data_buf_offset + i)) / quantization_factor;
+            else
+                dst[i] = static_cast<DstT>(read_fixed_point_value<Layout>(npu_data, npu_data_buf_offset + i));
+        }
+    } else {
+        for (int32_t i = 0; i < count; i++) {
+            if constexpr (std::is_floating_point<DstT>::value && Reciprocal)
+                dst[i] = static_cast<float>(read_fixed_point_value<Layout>(npu_data, npu_data_buf_offset + i * npu_stride)) * quantization_factor;
+            else if constexpr (std::is_floating_point<DstT>::value)
+                dst[i] = static_cast<float>(read_fixed_point_value<Layout>(npu_data, npu_data_buf_offset + i * npu_stride)) / quantization_factor;
+            else
+                dst[i] = static_cast<DstT>(read_fixed_point_value<Layout>(npu_data, npu_data_buf_offset + i * npu_stride));
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Resolve the NPU data access pattern of a node view.
+ *
+ * @param[in] node_view node view from kp_generic_inference_retrieve_node_view().
+ *
+ * @return refer to kp::npu_layout.
+ */
+inline npu_layout get_npu_layout(const kp_inf_node_view_t &node_view)
+{
+    if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1 == node_view.shape_version) {
+        if (KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B == node_view.data_layout)
+            return npu_layout::int16;
+        else if (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B == node_view.data_layout)
+            return npu_layout::int8_channel_group;
+        else
+            return npu_layout::int8;
+    }
+
+    switch (node_view.data_layout)
+    {
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B:
+        return npu_layout::int8;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
+        return npu_layout::int8_channel_group;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
+        return npu_layout::int16_lsb_masked;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+        return npu_layout::int16_high_low;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+        return npu_layout::int16_high_low_channel_group;
+    default:
+        return npu_layout::unknown;
+    }
+}
+
+/**
+ * @brief Convert a whole node into a sequential buffer with a compile-time specialized kernel.
+ *
+ * @tparam Layout NPU data access pattern, should be the same as kp::get_npu_layout() of node_view.
+ * @tparam SrcT fixed-point storage type of Layout (int8_t or int16_t).
+ * @tparam DstT float for dequantized values, otherwise an integer type to keep fixed-point values.
+ * @tparam PerChannel true for channel-wise quantization (more than one quantization parameter).
+ * @tparam Reciprocal true to multiply by the attached reciprocal quantization factor table ('quantization_reciprocal_factor' of node_view should not be NULL).
+ *
+ * @param[in] node_view node view from kp_generic_inference_retrieve_node_view().
+ * @param[out] dst a user-allocated buffer in sequential order of node_view shape.
+ * @param[in] dst_len number of values dst can hold.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+template <npu_layout Layout, typename SrcT, typename DstT, bool PerChannel, bool Reciprocal = false>
+int convert_node(const kp_inf_node_view_t &node_view, DstT *dst, uint32_t dst_len)
+{
+    static_assert(std::is_same<SrcT, typename detail::npu_layout_traits<Layout>::fixed_type>::value, "SrcT does not match the NPU layout");
+    static_assert(std::is_floating_point<DstT>::value || (sizeof(DstT) >= sizeof(SrcT)), "DstT cannot hold the fixed-point values");
+
+    constexpr bool channel_group                    = detail::npu_layout_traits<Layout>::channel_group;
+
+    int32_t index[KP_MAX_NODE_VIEW_SHAPE_LEN]       = {0};
+    int32_t last_axis                               = static_cast<int32_t>(node_view.shape_len) - 1;
+    int32_t row_len                                 = 0;
+    uint32_t num_data                               = 1;
+    uint32_t n                                      = 0;
+    float quantization_factor                       = node_view.quantization_factor;
+
+    if ((0 > last_axis) || (nullptr == dst) || (Reciprocal && (nullptr == node_view.quantization_reciprocal_factor))) {
+        printf("%s, invalid input parameter.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    for (uint32_t axis = 0; axis < node_view.shape_len; axis++)
+        num_data *= node_view.shape[axis];
+
+    if (dst_len < num_data) {
+        printf("%s, buffer is insufficient.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    row_len = node_view.shape[last_axis];
+
+    if constexpr (Reciprocal) {
+        if (!detail::get_quantization_factor<Reciprocal>(node_view, 0, quantization_factor)) {
+            printf("%s, get quantization parameters fail.\n", __func__);
+            return KP_ERROR_INVALID_MODEL_21;
+        }
+    }
+
+    while (true) {
+        uint32_t npu_data_buf_offset    = 0;
+        uint32_t onnx_data_buf_offset   = 0;
+
+        for (int32_t axis = 0; axis < last_axis; axis++) {
+            npu_data_buf_offset     += index[axis] * node_view.stride_npu[axis];
+            onnx_data_buf_offset    += index[axis] * node_view.stride_onnx[axis];
+        }
+
+        if constexpr (channel_group) {
+            if ((0 <= node_view.channel_group_axis) && (last_axis != node_view.channel_group_axis))
+                npu_data_buf_offset += (index[node_view.channel_group_axis] >> 4) * node_view.channel_group_stride;
+        }
+
+        bool row_is_uniform = true;
+
+        if constexpr (PerChannel) {
+            uint32_t first_idx  = onnx_data_buf_offset / node_view.quantized_axis_stride;
+            uint32_t last_idx   = (onnx_data_buf_offset + (row_len - 1) * node_view.stride_onnx[last_axis]) / node_view.quantized_axis_stride;
+
+            row_is_uniform = (first_idx == last_idx);
+
+            if (row_is_uniform && !detail::get_quantization_factor<Reciprocal>(node_view, first_idx, quantization_factor)) {
+                printf("%s, get quantization parameters fail.\n", __func__);
+                return KP_ERROR_INVALID_MODEL_21;
+            }
+        }
+
+        if (channel_group && (last_axis == node_view.channel_group_axis)) {
+            /* rare: channel axis is the innermost axis */
+            for (int32_t i = 0; i < row_len; i++) {
+                uint32_t npu_offset = npu_data_buf_offset + i * node_view.stride_npu[last_axis] + (i >> 4) * node_view.channel_group_stride;
+
+                if constexpr (PerChannel) {
+                    if (!row_is_uniform && !detail::get_quantization_factor<Reciprocal>(node_view, (onnx_data_buf_offset + i * node_view.stride_onnx[last_axis]) / node_view.quantized_axis_stride, quantization_factor)) {
+                        printf("%s, get quantization parameters fail.\n", __func__);
+                        return KP_ERROR_INVALID_MODEL_21;
+                    }
+                }
+
+                detail::convert_row<Layout, DstT, Reciprocal>(node_view.data, npu_offset, 1, 1, quantization_factor, &dst[n + i]);
+            }
+        } else if (!row_is_uniform) {
+            for (int32_t i = 0; i < row_len; i++) {
+                if (!detail::get_quantization_factor<Reciprocal>(node_view, (onnx_data_buf_offset + i * node_view.stride_onnx[last_axis]) / node_view.quantized_axis_stride, quantization_factor)) {
+                    printf("%s, get quantization parameters fail.\n", __func__);
+                    return KP_ERROR_INVALID_MODEL_21;
+                }
+
+                detail::convert_row<Layout, DstT, Reciprocal>(node_view.data, npu_data_buf_offset + i * node_view.stride_npu[last_axis], 1, 1, quantization_factor, &dst[n + i]);
+            }
+        } else {
+            detail::convert_row<Layout, DstT, Reciprocal>(node_view.data, npu_data_buf_offset, node_view.stride_npu[last_axis], row_len, quantization_factor, &dst[n]);
+        }
+
+        n += row_len;
+
+        int32_t axis = last_axis - 1;
+        for (; axis >= 0; axis--) {
+            index[axis]++;
+            if (index[axis] < node_view.shape[axis])
+                break;
+
+            index[axis] = 0;
+        }
+
+        if (0 > axis)
+            break;
+    }
+
+    return KP_SUCCESS;
+}
+
+/**
+ * @brief Convert a whole node into a sequential buffer, dispatching to the specialized kernel from the node metadata.
+ *
+ * @tparam DstT float for dequantized values, otherwise int16_t/int32_t to keep fixed-point values (int8_t only for 8-bit nodes).
+ *
+ * @param[in] node_view node view from kp_generic_inference_retrieve_node_view().
+ * @param[out] dst a user-allocated buffer in sequential order of node_view shape.
+ * @param[in] dst_len number of values dst can hold.
+ *
+ * @return refer to KP_API_RETURN_CODE in kp_struct.h
+ */
+template <typename DstT>
+int retrieve_node(const kp_inf_node_view_t &node_view, DstT *dst, uint32_t dst_len)
+{
+    const bool per_channel  = (0 != node_view.quantized_axis_stride);
+    const bool reciprocal   = std::is_floating_point<DstT>::value && (nullptr != node_view.quantization_reciprocal_factor);
+
+#define KP_DISPATCH_NODE_KERNEL(layout, src_type)                                                                   \
+    if (reciprocal)                                                                                                 \
+        return per_channel ? convert_node<layout, src_type, DstT, true, true>(node_view, dst, dst_len)              \
+                           : convert_node<layout, src_type, DstT, false, true>(node_view, dst, dst_len);            \
+    return per_channel ? convert_node<layout, src_type, DstT, true>(node_view, dst, dst_len)                        \
+                       : convert_node<layout, src_type, DstT, false>(node_view, dst, dst_len)
+
+    switch (get_npu_layout(node_view))
+    {
+    case npu_layout::int8:
+        KP_DISPATCH_NODE_KERNEL(npu_layout::int8, int8_t);
+    case npu_layout::int8_channel_group:
+        KP_DISPATCH_NODE_KERNEL(npu_layout::int8_channel_group, int8_t);
+    default:
+        break;
+    }
+
+    if constexpr (std::is_floating_point<DstT>::value || (sizeof(DstT) >= sizeof(int16_t))) {
+        switch (get_npu_layout(node_view))
+        {
+        case npu_layout::int16:
+            KP_DISPATCH_NODE_KERNEL(npu_layout::int16, int16_t);
+        case npu_layout::int16_lsb_masked:
+            KP_DISPATCH_NODE_KERNEL(npu_layout::int16_lsb_masked, int16_t);
+        case npu_layout::int16_high_low:
+            KP_DISPATCH_NODE_KERNEL(npu_layout::int16_high_low, int16_t);
+        case npu_layout::int16_high_low_channel_group:
+            KP_DISPATCH_NODE_KERNEL(npu_layout::int16_high_low_channel_group, int16_t);
+        default:
+            break;
+        }
+    }
+
+#undef KP_DISPATCH_NODE_KERNEL
+
+    printf("%s, unsupported NPU data layout %u for the destination type.\n", __func__, node_view.data_layout);
+
+    return KP_ERROR_INVALID_PARAM_12;
+}
+
+} // namespace kp
@@ -490,6 +490,7 @@ typedef struct
     uint32_t                                quantized_axis;                         /**< the axis along which the fixed-point quantization information performed */
     uint32_t                                quantized_fixed_point_descriptor_num;   /**< numbers of fixed-point quantization information */
     kp_quantized_fixed_point_descriptor_t*  quantized_fixed_point_descriptor;       /**< array of fixed-point quantization information */
+    float*                                  quantization_reciprocal_factor;         /**< array of 1 / (scale * 2^radix) for each fixed-point quantization information, built for output nodes at model loading (NULL if not built) */
 } __attribute__((packed, aligned(4))) kp_quantization_parameters_v1_t;
 
 /**
@@ -835,6 +836,54 @@ typedef struct
     float data[];                                           /**< array of floating-point values */
 } __attribute__((packed, aligned(4))) kp_inf_float_node_output_t;
 
+#define KP_MAX_NODE_VIEW_SHAPE_LEN 8 /**< MAX dimension count of a node view */
+
+/**
+ * @brief Lightweight view of a RAW output node
+ *
+ * The view refers to NPU data and quantization parameters inside the RAW output buffer directly (no copy, no allocation).
+ * Values are dequantized on demand and indexed by 'shape' (KL520/KL720/KL630: BxCxHxW, KL730/KL830: ONNX shape),
+ * the same values as kp_generic_inference_retrieve_float_node() in KP_CHANNEL_ORDERING_CHW (KL730/KL830: KP_CHANNEL_ORDERING_DEFAULT).
+ */
+typedef struct
+{
+    uint32_t index;                                         /**< index of node */
+    char *name;                                             /**< name of node in RAW output buffer ("" for KL520/KL720/KL630) */
+    uint32_t product_id;                                    /**< product id, refer to kp_product_id_t */
+    uint32_t shape_version;                                 /**< enum kp_model_tensor_shape_info_version_t of RAW output */
+    uint32_t data_layout;                                   /**< npu memory layout (ref. kp_model_tensor_data_layout_t) */
+    uint32_t fixed_point_dtype;                             /**< enum kp_fixed_point_dtype_t */
+    uint32_t shape_len;                                     /**< length of shape */
+    int32_t shape[KP_MAX_NODE_VIEW_SHAPE_LEN];              /**< shape */
+    uint32_t stride_npu[KP_MAX_NODE_VIEW_SHAPE_LEN];        /**< NPU data access stride of each axis (in scalar) */
+    uint32_t stride_onnx[KP_MAX_NODE_VIEW_SHAPE_LEN];       /**< sequential data access stride of each axis (in scalar) */
+    int32_t channel_group_axis;                             /**< axis grouped by 16 channels in NPU data (1W16C8B/1W16C8BHL), -1 if not grouped */
+    uint32_t channel_group_stride;                          /**< extra NPU data access stride of each 16 channels group (in scalar) */
+    uint32_t quantized_axis_stride;                         /**< sequential data length sharing one quantization parameter (0 for per-tensor quantization) */
+    uint32_t quantization_parameters_len;                   /**< numbers of fixed-point quantization information */
+    float quantization_factor;                              /**< quantization factor (scale * 2^radix) of per-tensor quantization */
+    int32_t radix_dtype;                                    /**< data type of 'radix' (ref. kp_dtype_t) */
+    int32_t scale_dtype;                                    /**< data type of 'scale' (ref. kp_dtype_t) */
+    void *radix;                                            /**< per-channel radix array in RAW output buffer */
+    void *scale;                                            /**< per-channel scale array in RAW output buffer */
+    const float *quantization_reciprocal_factor;            /**< reciprocal quantization factor table of the model output node (ref. kp_inf_node_view_attach_model_output_node()), NULL to divide by the factors of RAW output buffer */
+    uint8_t *data;                                          /**< NPU raw data in RAW output buffer */
+} __attribute__((aligned(4))) kp_inf_node_view_t;
+
+/**
+ * @brief all output nodes in floating-point format placed in one contiguous arena
+ *
+ * The list itself, the node pointer array and every node (data, shape and name) are all located inside the arena,
+ * data of each node is aligned to 16 bytes.
+ */
+typedef struct
+{
+    uint32_t num_output_node;                               /**< total number of output nodes */
+    uint32_t arena_size;                                    /**< used size of the arena in bytes */
+    void *allocated_buffer;                                 /**< buffer allocated by kp_generic_inference_retrieve_float_node_list() (NULL for user-provided arena) */
+    kp_inf_float_node_output_t **node_output;               /**< array of output nodes in floating-point format */
+} __attribute__((aligned(4))) kp_inf_float_node_output_list_t;
+
 /**
  * @brief describe a bounding box
  */
@@ -0,0 +1,213 @@
+/**
+ * @file        benchmark_crop_pack.c
+ * @brief       bytes per inference, host time and latency of sending a whole image with crop boxes or only its packed crop regions, over a simulated USB link
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "image_convert.h"
+
+#define IMAGE_WIDTH 1920
+#define IMAGE_HEIGHT 1080
+
+static int _loop = 100;
+static double _usb_mbps = 40;       // USB 2.0 bulk throughput in MB/s, the 480 Mbit/s signaling rate is about 60 MB/s
+
+/* face crops of a second stage, about 5% of the image, at odd positions */
+static const kp_inf_crop_box_t _crops[] = {
+    {0, 101, 203, 160, 180},
+    {1, 1003, 517, 112, 112},
+    {2, 1501, 87, 200, 200},
+    {3, 7, 899, 150, 181},
+};
+
+static const struct
+{
+    const char *name;
+    kp_image_format_t format;
+} _formats[] = {
+    {"RGB565", KP_IMAGE_FORMAT_RGB565},
+    {"RGBA8888", KP_IMAGE_FORMAT_RGBA8888},
+    {"YUYV", KP_IMAGE_FORMAT_YUYV},
+    {"RAW8", KP_IMAGE_FORMAT_RAW8},
+    {"YUV420", KP_IMAGE_FORMAT_YUV420},
+};
+
+static uint32_t _random_state = 0xbb67ae85;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static void fill_random(uint8_t *buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        _random_state ^= _random_state << 13;
+        _random_state ^= _random_state >> 17;
+        _random_state ^= _random_state << 5;
+        buffer[i] = (uint8_t)(_random_state >> 24);
+    }
+}
+
+/* transfer time of 'bytes' over the simulated link */
+static double usb_ms(int bytes)
+{
+    return (double)bytes / (_usb_mbps * 1000.0);
+}
+
+/* the device crops the same pixels from the packed image as from the whole one: both are decoded and the crop pixels compared */
+static bool check_crops(const kp_generic_input_node_image_t *image, const kp_generic_input_node_image_t *packed)
+{
+    uint8_t *image_rgb = malloc((size_t)image->width * image->height * 3);
+    uint8_t *packed_rgb = malloc((size_t)packed->width * packed->height * 3);
+    bool identical = (NULL != image_rgb) && (NULL != packed_rgb);
+
+    if (identical &&
+        ((0 != image_convert_to_rgb888(image->image_buffer, image->width, image->height, image->image_format, image_rgb, image->width * 3,
+                                       IMAGE_CONVERT_ORDER_BGR, 1)) ||
+         (0 != image_convert_to_rgb888(packed->image_buffer, packed->width, packed->height, packed->image_format, packed_rgb, packed->width * 3,
+                                       IMAGE_CONVERT_ORDER_BGR, 1))))
+        identical = false;
+
+    for (uint32_t i = 0; identical && (i < image->crop_count); i++)
+    {
+        const kp_inf_crop_box_t *crop = &image->inf_crop[i];
+        const kp_inf_crop_box_t *packed_crop = &packed->inf_crop[i];
+
+        if ((crop->width != packed_crop->width) || (crop->height != packed_crop->height))
+        {
+            identical = false;
+            break;
+        }
+
+        for (uint32_t row = 0; row < crop->height; row++)
+        {
+            if (0 != memcmp(image_rgb + ((size_t)(crop->y1 + row) * image->width + crop->x1) * 3,
+                            packed_rgb + ((size_t)(packed_crop->y1 + row) * packed->width + packed_crop->x1) * 3, (size_t)crop->width * 3))
+            {
+                identical = false;
+                break;
+            }
+        }
+    }
+
+    free(image_rgb);
+    free(packed_rgb);
+
+    return identical;
+}
+
+int main(int argc, char *argv[])
+{
+    int crop_pixels = 0;
+    int mismatch_count = 0;
+
+    if (argc > 1)
+        _loop = atoi(argv[1]);
+
+    if (argc > 2)
+        _usb_mbps = atof(argv[2]);
+
+    if ((0 >= _loop) || (0 >= _usb_mbps))
+    {
+        printf("usage: %s [loop] [USB MB/s]\n", argv[0]);
+        return -1;
+    }
+
+    for (size_t c = 0; c < sizeof(_crops) / sizeof(_crops[0]); c++)
+        crop_pixels += _crops[c].width * _crops[c].height;
+
+    printf("%dx%d image with %d crops (%.1f%% of the image), %d loops, simulated USB link of %.1f MB/s, device inference time not included\n\n",
+           IMAGE_WIDTH, IMAGE_HEIGHT, (int)(sizeof(_crops) / sizeof(_crops[0])), 100.0 * crop_pixels / (IMAGE_WIDTH * IMAGE_HEIGHT), _loop,
+           _usb_mbps);
+    printf("%-9s %12s %13s %9s %17s %8s %21s %10s\n", "format", "whole bytes", "packed image", "bytes", "usb ms", "pack ms",
+           "latency ms", "identical");
+
+    for (size_t f = 0; f < sizeof(_formats) / sizeof(_formats[0]); f++)
+    {
+        kp_generic_input_node_image_t image;
+        kp_generic_input_node_image_t packed;
+        image_convert_crop_pack_t pack;
+        int image_size = image_convert_buffer_size(IMAGE_WIDTH, IMAGE_HEIGHT, _formats[f].format);
+        uint8_t *image_buffer = malloc(image_size);
+        uint8_t *packed_buffer = NULL;
+        int packed_size = 0;
+        double pack_ms = 0;
+        bool identical = false;
+
+        if (NULL == image_buffer)
+        {
+            printf("Error! %s(): out of memory\n", __FUNCTION__);
+            return -1;
+        }
+
+        fill_random(image_buffer, image_size);
+
+        memset(&image, 0, sizeof(image));
+        image.width = IMAGE_WIDTH;
+        image.height = IMAGE_HEIGHT;
+        image.image_format = _formats[f].format;
+        image.crop_count = sizeof(_crops) / sizeof(_crops[0]);
+        memcpy(image.inf_crop, _crops, sizeof(_crops));
+        image.image_buffer = image_buffer;
+
+        packed_size = image_convert_crop_pack_size(&image);
+        packed_buffer = (0 < packed_size) ? malloc(packed_size) : NULL;
+        if (NULL == packed_buffer)
+        {
+            printf("Error! %s(): %s crops are not packed\n", __FUNCTION__, _formats[f].name);
+            free(image_buffer);
+            return -1;
+        }
+
+        for (int l = 0; l < _loop; l++)
+        {
+            packed = image;
+
+            double begin = get_time_ms();
+            int status = image_convert_pack_crops(&packed, packed_buffer, packed_size, &pack);
+            pack_ms += get_time_ms() - begin;
+
+            if ((0 != status) || !pack.packed)
+            {
+                printf("Error! %s(): image_convert_pack_crops() failed\n", __FUNCTION__);
+                free(image_buffer);
+                free(packed_buffer);
+                return -1;
+            }
+        }
+
+        pack_ms /= _loop;
+        identical = check_crops(&image, &packed);
+        if (!identical)
+            mismatch_count++;
+
+        printf("%-9s %12d %6ux%-6u %9d %7.2f -> %6.2f %8.3f %9.2f -> %7.2f %10s\n", _formats[f].name, image_size, packed.width, packed.height,
+               packed_size, usb_ms(image_size), usb_ms(packed_size), pack_ms, usb_ms(image_size), pack_ms + usb_ms(packed_size),
+               identical ? "yes" : "NO");
+
+        free(image_buffer);
+        free(packed_buffer);
+    }
+
+    if (0 < mismatch_count)
+    {
+        printf("\n%d formats give other crop pixels than the whole image\n", mismatch_count);
+        return -1;
+    }
+
+    return 0;
+}
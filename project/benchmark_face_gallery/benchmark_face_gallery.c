@@ -0,0 +1,248 @@
+/**
+ * @file        benchmark_face_gallery.c
+ * @brief       recall and latency of face gallery search (int8/fp16, flat/IVF) against a flat fp32 search
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "face_gallery.h"
+
+#define TOP_K 10
+#define SAMPLES_PER_IDENTITY 4
+
+static int _gallery_size = 20000;
+static int _dim = 512;
+static int _query_count = 500;
+
+static uint64_t _random_state = 0x853c49e6748fea9bULL;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+/* uniform in (0, 1], reproducible across platforms */
+static double random_uniform()
+{
+    _random_state = _random_state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    return ((double)(_random_state >> 11) + 1.0) / 9007199254740992.0;
+}
+
+static float random_gaussian()
+{
+    return (float)(sqrt(-2.0 * log(random_uniform())) * cos(6.283185307179586 * random_uniform()));
+}
+
+static void normalize(float *vector, int dim)
+{
+    double norm = 0;
+    for (int i = 0; i < dim; i++)
+        norm += (double)vector[i] * vector[i];
+
+    norm = (0 < norm) ? 1.0 / sqrt(norm) : 0;
+    for (int i = 0; i < dim; i++)
+        vector[i] = (float)(vector[i] * norm);
+}
+
+/* a sample of an identity, the noise level gives a cosine similarity of about 0.6~0.8 to other samples of the identity */
+static void make_sample(const float *identity, float *sample, int dim)
+{
+    for (int i = 0; i < dim; i++)
+        sample[i] = identity[i] + 0.7f * random_gaussian() / sqrtf((float)dim);
+
+    normalize(sample, dim);
+}
+
+/* exhaustive fp32 cosine search, the ground truth */
+static void search_fp32(const float *embeddings, int count, int dim, const float *query, uint32_t top_ids[TOP_K])
+{
+    float top_scores[TOP_K];
+    int top_count = 0;
+
+    for (int n = 0; n < count; n++)
+    {
+        const float *embedding = &embeddings[(size_t)n * dim];
+        float score = 0;
+
+        for (int i = 0; i < dim; i++)
+            score += embedding[i] * query[i];
+
+        if ((TOP_K == top_count) && (score <= top_scores[TOP_K - 1]))
+            continue;
+
+        int pos = (TOP_K == top_count) ? TOP_K - 1 : top_count++;
+        while ((0 < pos) && (top_scores[pos - 1] < score))
+        {
+            top_scores[pos] = top_scores[pos - 1];
+            top_ids[pos] = top_ids[pos - 1];
+            pos--;
+        }
+
+        top_scores[pos] = score;
+        top_ids[pos] = (uint32_t)n;
+    }
+}
+
+static void run_case(const char *name, face_gallery_t *gallery, int probe_count, const float *queries, const uint32_t *truth)
+{
+    face_gallery_match_t matches[TOP_K];
+    int match_count = 0;
+    int hit_count = 0;
+    int top1_count = 0;
+
+    if (0 < probe_count)
+        face_gallery_set_probe_count(gallery, probe_count);
+
+    double time_begin = get_time_ms();
+
+    for (int q = 0; q < _query_count; q++)
+    {
+        if (0 != face_gallery_search(gallery, &queries[(size_t)q * _dim], FACE_GALLERY_METRIC_COSINE, TOP_K, matches, &match_count))
+        {
+            printf("Error! search of %s failed\n", name);
+            return;
+        }
+
+        const uint32_t *top_ids = &truth[q * TOP_K];
+
+        if ((0 < match_count) && (matches[0].id == top_ids[0]))
+            top1_count++;
+
+        for (int i = 0; i < match_count; i++)
+        {
+            for (int j = 0; j < TOP_K; j++)
+            {
+                if (matches[i].id == top_ids[j])
+                {
+                    hit_count++;
+                    break;
+                }
+            }
+        }
+    }
+
+    double time_spent = get_time_ms() - time_begin;
+
+    printf("%-24s %10.1f %12.4f %10.4f\n", name, time_spent * 1000.0 / _query_count, (double)hit_count / (_query_count * TOP_K),
+           (double)top1_count / _query_count);
+}
+
+int main(int argc, char *argv[])
+{
+    if (1 < argc)
+        _gallery_size = atoi(argv[1]);
+
+    if (2 < argc)
+        _dim = atoi(argv[2]);
+
+    if (3 < argc)
+        _query_count = atoi(argv[3]);
+
+    if ((TOP_K > _gallery_size) || (0 >= _dim) || (0 >= _query_count))
+    {
+        printf("usage: %s [gallery size] [dim] [query count]\n", argv[0]);
+        return -1;
+    }
+
+    int identity_count = (_gallery_size + SAMPLES_PER_IDENTITY - 1) / SAMPLES_PER_IDENTITY;
+    int list_count = (int)sqrt((double)_gallery_size);
+
+    float *identities = (float *)malloc((size_t)identity_count * _dim * sizeof(float));
+    float *embeddings = (float *)malloc((size_t)_gallery_size * _dim * sizeof(float));
+    float *queries = (float *)malloc((size_t)_query_count * _dim * sizeof(float));
+    uint32_t *truth = (uint32_t *)malloc((size_t)_query_count * TOP_K * sizeof(uint32_t));
+
+    face_gallery_t *gallery_int8 = face_gallery_create(_dim, FACE_GALLERY_STORAGE_INT8);
+    face_gallery_t *gallery_fp16 = face_gallery_create(_dim, FACE_GALLERY_STORAGE_FP16);
+
+    if ((NULL == identities) || (NULL == embeddings) || (NULL == queries) || (NULL == truth) || (NULL == gallery_int8) ||
+        (NULL == gallery_fp16))
+    {
+        printf("Error! malloc memory failed\n");
+        return -1;
+    }
+
+    /******* gallery of SAMPLES_PER_IDENTITY samples per identity, queries are new samples of random identities *******/
+    for (int i = 0; i < identity_count; i++)
+    {
+        for (int j = 0; j < _dim; j++)
+            identities[(size_t)i * _dim + j] = random_gaussian();
+
+        normalize(&identities[(size_t)i * _dim], _dim);
+    }
+
+    for (int n = 0; n < _gallery_size; n++)
+    {
+        float *embedding = &embeddings[(size_t)n * _dim];
+
+        make_sample(&identities[(size_t)(n / SAMPLES_PER_IDENTITY) * _dim], embedding, _dim);
+
+        if ((0 != face_gallery_add(gallery_int8, (uint32_t)n, embedding)) || (0 != face_gallery_add(gallery_fp16, (uint32_t)n, embedding)))
+        {
+            printf("Error! add embedding failed\n");
+            return -1;
+        }
+    }
+
+    for (int q = 0; q < _query_count; q++)
+        make_sample(&identities[(size_t)(random_uniform() * (identity_count - 1)) * _dim], &queries[(size_t)q * _dim], _dim);
+
+    /******* ground truth and latency of the flat fp32 search *******/
+    double time_begin = get_time_ms();
+
+    for (int q = 0; q < _query_count; q++)
+        search_fp32(embeddings, _gallery_size, _dim, &queries[(size_t)q * _dim], &truth[q * TOP_K]);
+
+    double fp32_time = get_time_ms() - time_begin;
+
+    printf("gallery %d x %d, %d queries, top-%d, IVF with %d lists\n\n", _gallery_size, _dim, _query_count, TOP_K, list_count);
+    printf("%-24s %10s %12s %10s\n", "search", "us/query", "recall@10", "top-1");
+    printf("%-24s %10.1f %12.4f %10.4f\n", "flat fp32 (reference)", fp32_time * 1000.0 / _query_count, 1.0, 1.0);
+
+    run_case("flat fp16", gallery_fp16, 0, queries, truth);
+    run_case("flat int8", gallery_int8, 0, queries, truth);
+
+    time_begin = get_time_ms();
+    if ((0 != face_gallery_build_index(gallery_int8, list_count, 10)) || (0 != face_gallery_build_index(gallery_fp16, list_count, 10)))
+    {
+        printf("Error! build index failed\n");
+        return -1;
+    }
+    printf("(index of both galleries built in %.1f ms)\n", get_time_ms() - time_begin);
+
+    int probe_counts[] = {1, 4, 8, 16, 32};
+    char name[64];
+
+    for (size_t i = 0; i < sizeof(probe_counts) / sizeof(probe_counts[0]); i++)
+    {
+        if (probe_counts[i] > list_count)
+            break;
+
+        snprintf(name, sizeof(name), "IVF int8, %d probes", probe_counts[i]);
+        run_case(name, gallery_int8, probe_counts[i], queries, truth);
+    }
+
+    snprintf(name, sizeof(name), "IVF fp16, %d probes", (8 < list_count) ? 8 : list_count);
+    run_case(name, gallery_fp16, 8, queries, truth);
+
+    face_gallery_release(gallery_int8);
+    face_gallery_release(gallery_fp16);
+    free(identities);
+    free(embeddings);
+    free(queries);
+    free(truth);
+
+    return 0;
+}
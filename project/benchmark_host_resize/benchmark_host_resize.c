@@ -0,0 +1,160 @@
+/**
+ * @file        benchmark_host_resize.c
+ * @brief       bytes per inference, host time, latency and fps of sending camera frames as they are or letterbox-resized on the host, over a simulated USB link
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "image_convert.h"
+
+#define MODEL_INPUT_SIZE 416
+
+static int _loop = 20;
+static double _usb_mbps = 40;       // USB 2.0 bulk throughput in MB/s, the 480 Mbit/s signaling rate is about 60 MB/s
+
+static const int _frame_sizes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}};
+
+static const struct
+{
+    const char *name;
+    kp_image_format_t format;
+} _formats[] = {
+    {"RGB565", KP_IMAGE_FORMAT_RGB565},
+    {"YUYV", KP_IMAGE_FORMAT_YUYV},
+    {"RAW8", KP_IMAGE_FORMAT_RAW8},
+};
+
+static uint32_t _random_state = 0x6a09e667;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static void fill_random(uint8_t *buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        _random_state ^= _random_state << 13;
+        _random_state ^= _random_state >> 17;
+        _random_state ^= _random_state << 5;
+        buffer[i] = (uint8_t)(_random_state >> 24);
+    }
+}
+
+/* transfer time of 'bytes' over the simulated link */
+static double usb_ms(int bytes)
+{
+    return (double)bytes / (_usb_mbps * 1000.0);
+}
+
+/*
+ * one row of the table: the host time is the conversion (and resize) of a BGR camera frame, the frame is sent while the next one
+ * is prepared (double buffering), so the fps is limited by the slower of the two; the device inference time is not included
+ */
+static void print_row(const char *path, const char *format, int width, int height, int bytes, double host_ms)
+{
+    double transfer_ms = usb_ms(bytes);
+    double period_ms = (host_ms > transfer_ms) ? host_ms : transfer_ms;
+
+    printf("%-12s %-7s %5dx%-5d %9d %9.2f %9.2f %11.2f %8.1f\n", path, format, width, height, bytes, host_ms, transfer_ms,
+           host_ms + transfer_ms, 1000.0 / period_ms);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+        _loop = atoi(argv[1]);
+
+    if (argc > 2)
+        _usb_mbps = atof(argv[2]);
+
+    if ((0 >= _loop) || (0 >= _usb_mbps))
+    {
+        printf("usage: %s [loop] [USB MB/s]\n", argv[0]);
+        return -1;
+    }
+
+    printf("%dx%d model input, symmetric padding, %d loops, simulated USB link of %.1f MB/s, device inference time not included\n\n",
+           MODEL_INPUT_SIZE, MODEL_INPUT_SIZE, _loop, _usb_mbps);
+    printf("%-12s %-7s %11s %9s %9s %9s %11s %8s\n", "path", "format", "sent image", "bytes", "host ms", "usb ms", "latency ms", "fps");
+
+    for (size_t s = 0; s < sizeof(_frame_sizes) / sizeof(_frame_sizes[0]); s++)
+    {
+        int frame_width = _frame_sizes[s][0];
+        int frame_height = _frame_sizes[s][1];
+        uint8_t *frame = malloc((size_t)frame_width * frame_height * 3);
+        uint8_t *resized = malloc((size_t)frame_width * frame_height * 3);
+        uint8_t *image = malloc((size_t)frame_width * frame_height * 4);
+
+        if (!frame || !resized || !image)
+        {
+            printf("Error! %s(): out of memory\n", __FUNCTION__);
+            free(frame);
+            free(resized);
+            free(image);
+            return -1;
+        }
+
+        fill_random(frame, (size_t)frame_width * frame_height * 3);
+
+        for (size_t f = 0; f < sizeof(_formats) / sizeof(_formats[0]); f++)
+        {
+            kp_image_format_t format = _formats[f].format;
+            int resized_width = 0;
+            int resized_height = 0;
+            double full_ms = 0;
+            double resize_ms = 0;
+
+            if (0 != image_convert_letterbox_size(frame_width, frame_height, MODEL_INPUT_SIZE, MODEL_INPUT_SIZE, KP_PADDING_SYMMETRIC, format,
+                                                  &resized_width, &resized_height))
+                return -1;
+
+            for (int l = 0; l < _loop; l++)
+            {
+                double begin = get_time_ms();
+
+                // the whole frame in the format of the inference, the device resizes it
+                if (0 != image_convert_from_rgb888(frame, frame_width * 3, IMAGE_CONVERT_ORDER_BGR, frame_width, frame_height, format, image, 1))
+                    return -1;
+
+                double middle = get_time_ms();
+
+                // the letterboxed size, the device only pads it
+                if ((0 != image_convert_resize_rgb888(frame, frame_width * 3, frame_width, frame_height, resized, resized_width * 3, resized_width,
+                                                      resized_height, IMAGE_CONVERT_RESIZE_AREA, 1)) ||
+                    (0 != image_convert_from_rgb888(resized, resized_width * 3, IMAGE_CONVERT_ORDER_BGR, resized_width, resized_height, format,
+                                                    image, 1)))
+                    return -1;
+
+                double end = get_time_ms();
+
+                full_ms += middle - begin;
+                resize_ms += end - middle;
+            }
+
+            print_row("full frame", _formats[f].name, frame_width, frame_height, image_convert_buffer_size(frame_width, frame_height, format),
+                      full_ms / _loop);
+            print_row("host resize", _formats[f].name, resized_width, resized_height,
+                      image_convert_buffer_size(resized_width, resized_height, format), resize_ms / _loop);
+        }
+
+        printf("\n");
+
+        free(frame);
+        free(resized);
+        free(image);
+    }
+
+    return 0;
+}
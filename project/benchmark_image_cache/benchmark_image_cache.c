@@ -0,0 +1,205 @@
+/**
+ * @file        benchmark_image_cache.c
+ * @brief       benchmark of loading the BMP images of res/images: helper_bmp_file_to_raw_buffer(), first use and cached use of image_cache
+ *
+ * Every image got from the cache is compared with helper_bmp_file_to_raw_buffer(). The files are read once before timing,
+ * so they are in the page cache and the first use is the cost of mapping and converting, not of the disk.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "kp_struct.h"
+#include "helper_functions.h"
+#include "image_cache.h"
+
+#define IMAGE_CACHE_MAX_BYTES (512 * 1024 * 1024)
+
+static char _image_dir[128] = "../../res/images";
+static int _loop = 5;
+
+static const char *_image_names[] = {
+    "ArchVizInterior03Data_Night_l_1_left.bmp", "ArchVizInterior03Data_Night_l_1_right.bmp", "a_man_640x480.bmp", "a_woman_640x480.bmp",
+    "bike_cars_street_224x224.bmp", "bike_cars_street_416x416.bmp", "car_park_barrier_608x608.bmp", "car_plate_1280x720.bmp",
+    "car_plate_AAE-8772_1280x720.bmp", "desert_ant_812x642.bmp", "dms_640x360.bmp", "headpose_gesture_640x480.bmp",
+    "one_bike_many_cars_224x224.bmp", "one_bike_many_cars_416x224.bmp", "one_bike_many_cars_416x416.bmp", "one_bike_many_cars_608x608.bmp",
+    "one_bike_many_cars_800x800.bmp", "one_car_900x900.bmp", "pd_forklift.bmp", "people_talk_in_street_640x320.bmp",
+    "people_talk_in_street_640x640.bmp", "raft_optical_flow_0_1024x436.bmp", "raft_optical_flow_1_1024x436.bmp", "skeleton_960x540.bmp",
+    "street_1280x720.bmp", "street_traffic_cone.bmp", "tiny_dms_800x540.bmp", "travel_walk_480x256.bmp", "video_conference_928x192.bmp",
+};
+
+#define IMAGE_COUNT ((int)(sizeof(_image_names) / sizeof(_image_names[0])))
+
+static const struct
+{
+    const char *name;
+    kp_image_format_t format;
+} _formats[] = {
+    {"RGB565", KP_IMAGE_FORMAT_RGB565},
+    {"YUYV", KP_IMAGE_FORMAT_YUYV},
+    {"RAW8", KP_IMAGE_FORMAT_RAW8},
+};
+
+static char _image_paths[IMAGE_COUNT][256];
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+/* one pass over all images with helper_bmp_file_to_raw_buffer(), a buffer is read, converted and freed per image */
+static int helper_pass(kp_image_format_t format, double *time_spent)
+{
+    double time_begin = get_time_ms();
+
+    for (int i = 0; i < IMAGE_COUNT; i++)
+    {
+        int width = 0;
+        int height = 0;
+        char *buffer = helper_bmp_file_to_raw_buffer(_image_paths[i], &width, &height, format);
+
+        if (NULL == buffer)
+            return -1;
+
+        free(buffer);
+    }
+
+    *time_spent = get_time_ms() - time_begin;
+
+    return 0;
+}
+
+/* one pass over all images with the cache */
+static int cache_pass(image_cache_t *cache, kp_image_format_t format, double *time_spent)
+{
+    image_cache_image_t image;
+    double time_begin = get_time_ms();
+
+    for (int i = 0; i < IMAGE_COUNT; i++)
+    {
+        if (0 != image_cache_get_bmp(cache, _image_paths[i], format, &image))
+            return -1;
+    }
+
+    *time_spent = get_time_ms() - time_begin;
+
+    return 0;
+}
+
+/* cached images are the images of helper_bmp_file_to_raw_buffer() */
+static int check_images(image_cache_t *cache, kp_image_format_t format)
+{
+    for (int i = 0; i < IMAGE_COUNT; i++)
+    {
+        image_cache_image_t image;
+        int width = 0;
+        int height = 0;
+        char *buffer = helper_bmp_file_to_raw_buffer(_image_paths[i], &width, &height, format);
+        int ret = 0;
+
+        if ((NULL == buffer) || (0 != image_cache_get_bmp(cache, _image_paths[i], format, &image)))
+            ret = -1;
+        else if ((width != image.width) || (height != image.height) || (0 != memcmp(buffer, image.buffer, image.size)))
+            ret = -1;
+
+        free(buffer);
+
+        if (0 != ret)
+        {
+            printf("Error! %s(): %s from the cache differs from helper_bmp_file_to_raw_buffer()\n", __FUNCTION__, _image_paths[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (1 < argc)
+        _loop = atoi(argv[1]);
+
+    if (2 < argc)
+        strncpy(_image_dir, argv[2], sizeof(_image_dir) - 1);
+
+    if (0 >= _loop)
+    {
+        printf("usage: %s [loop] [image folder]\n", argv[0]);
+        return -1;
+    }
+
+    for (int i = 0; i < IMAGE_COUNT; i++)
+        snprintf(_image_paths[i], sizeof(_image_paths[i]), "%s/%s", _image_dir, _image_names[i]);
+
+    printf("%d BMP images of %s, %d loops, files in the page cache\n\n", IMAGE_COUNT, _image_dir, _loop);
+    printf("%-8s %-40s %12s\n", "format", "load", "ms/image");
+
+    for (int f = 0; f < (int)(sizeof(_formats) / sizeof(_formats[0])); f++)
+    {
+        double helper_sum = 0;
+        double first_sum = 0;
+        double cached_sum = 0;
+        double time_spent = 0;
+        image_cache_t *cache;
+
+        // the files are read once, then the helper is timed
+        if (0 != helper_pass(_formats[f].format, &time_spent))
+            return -1;
+
+        for (int loop = 0; loop < _loop; loop++)
+        {
+            if (0 != helper_pass(_formats[f].format, &time_spent))
+                return -1;
+
+            helper_sum += time_spent;
+        }
+
+        // first use on a new cache per loop, then the cached images
+        for (int loop = 0; loop < _loop; loop++)
+        {
+            cache = image_cache_create(IMAGE_CACHE_MAX_BYTES);
+            if (NULL == cache)
+                return -1;
+
+            if (0 != cache_pass(cache, _formats[f].format, &time_spent))
+            {
+                image_cache_release(cache);
+                return -1;
+            }
+
+            first_sum += time_spent;
+
+            if (0 != cache_pass(cache, _formats[f].format, &time_spent))
+            {
+                image_cache_release(cache);
+                return -1;
+            }
+
+            cached_sum += time_spent;
+
+            if ((0 == loop) && (0 != check_images(cache, _formats[f].format)))
+            {
+                image_cache_release(cache);
+                return -1;
+            }
+
+            image_cache_release(cache);
+        }
+
+        printf("%-8s %-40s %12.4f\n", _formats[f].name, "helper fread + convert + malloc", helper_sum / _loop / IMAGE_COUNT);
+        printf("%-8s %-40s %12.4f\n", _formats[f].name, "cache first use (mmap + convert)", first_sum / _loop / IMAGE_COUNT);
+        printf("%-8s %-40s %12.4f\n", _formats[f].name, "cache hit", cached_sum / _loop / IMAGE_COUNT);
+    }
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file        benchmark_motion_gate.cpp
+ * @brief       skip rate and check time of the motion gate on a video clip, MOT16-03 by default
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern "C"
+{
+#include "image_convert.h"
+#include "motion_gate.h"
+}
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+static char _video_file_path[128] = "../../res/images/MOT16-03_trim.mp4";
+
+// frames are resized as a camera would give them, the thresholds are those of the KL520 camera demo
+static int _width = 960;
+static int _height = 540;
+static float _motion_threshold = 0.002f;
+static int _cell_threshold = 12;
+static int _refresh_interval = 30;
+
+#define NOISE_AMPLITUDE 2           // luma noise of the static scene, below _cell_threshold
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+/* all frames of the clip in 'format', resized to _width x _height */
+static int load_frames(kp_image_format_t format, std::vector<uint8_t> &frames, int *frame_count)
+{
+    cv::VideoCapture video;
+    cv::Mat frame;
+    cv::Mat resized;
+    int frame_size = image_convert_buffer_size(_width, _height, format);
+
+    if (!video.open(_video_file_path))
+    {
+        printf("Error! %s(): cannot open %s\n", __FUNCTION__, _video_file_path);
+        return -1;
+    }
+
+    frames.clear();
+    *frame_count = 0;
+
+    while (video.read(frame))
+    {
+        cv::resize(frame, resized, cv::Size(_width, _height), 0, 0, cv::INTER_AREA);
+
+        frames.resize((size_t)(*frame_count + 1) * frame_size);
+        if (0 != image_convert_from_rgb888(resized.data, (int)resized.step, IMAGE_CONVERT_ORDER_BGR, _width, _height, format,
+                                           &frames[(size_t)*frame_count * frame_size], 1))
+        {
+            printf("Error! %s(): converting frame %d failed\n", __FUNCTION__, *frame_count);
+            return -1;
+        }
+
+        (*frame_count)++;
+    }
+
+    video.release();
+
+    if (0 == *frame_count)
+    {
+        printf("Error! %s(): no frame in %s\n", __FUNCTION__, _video_file_path);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* sent and skipped frames of the gate over 'frame_count' frames, 'frames' is called for each frame */
+template <typename frame_source_t>
+static int run_gate(const char *name, kp_image_format_t format, int frame_count, frame_source_t frames)
+{
+    motion_gate_t *gate = motion_gate_create(_width, _height, format, _motion_threshold, _cell_threshold, _refresh_interval);
+    motion_gate_statistics_t statistics;
+    double check_ms = 0;
+
+    if (NULL == gate)
+    {
+        printf("Error! %s(): motion_gate_create() failed\n", __FUNCTION__);
+        return -1;
+    }
+
+    for (int i = 0; i < frame_count; i++)
+    {
+        const uint8_t *frame = frames(i);
+
+        double begin = get_time_ms();
+        motion_gate_check(gate, frame);
+        check_ms += get_time_ms() - begin;
+    }
+
+    motion_gate_get_statistics(gate, &statistics);
+    motion_gate_release(gate);
+
+    printf("%-30s %7u %6u %8u %9u %11.1f%% %10.3f\n", name, statistics.frame_count, statistics.sent_count, statistics.skipped_count,
+           statistics.refresh_count, 100.0 * statistics.skipped_count / statistics.frame_count, check_ms / frame_count);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    static const struct
+    {
+        const char *name;
+        kp_image_format_t format;
+    } formats[] = {{"YUYV", KP_IMAGE_FORMAT_YUYV}, {"RGB565", KP_IMAGE_FORMAT_RGB565}, {"YUV420", KP_IMAGE_FORMAT_YUV420}};
+
+    // usage: [video file] [width height] [motion_threshold cell_threshold refresh_interval]
+    if (argc > 1)
+        snprintf(_video_file_path, sizeof(_video_file_path), "%s", argv[1]);
+
+    if (argc > 3)
+    {
+        _width = atoi(argv[2]);
+        _height = atoi(argv[3]);
+    }
+
+    if (argc > 6)
+    {
+        _motion_threshold = (float)atof(argv[4]);
+        _cell_threshold = atoi(argv[5]);
+        _refresh_interval = atoi(argv[6]);
+    }
+
+    if ((0 >= _width) || (0 != _width % 2) || (0 >= _height) || (0 != _height % 2))
+    {
+        printf("usage: %s [video file] [width height] [motion_threshold cell_threshold refresh_interval], even width and height\n", argv[0]);
+        return -1;
+    }
+
+    printf("%s at %dx%d, motion threshold %.4f, cell threshold %d, refresh interval %d\n\n", _video_file_path, _width, _height,
+           _motion_threshold, _cell_threshold, _refresh_interval);
+    printf("%-30s %7s %6s %8s %9s %12s %10s\n", "frames of", "checked", "sent", "skipped", "refreshes", "NPU saved", "check (ms)");
+
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+    {
+        std::vector<uint8_t> frames;
+        int frame_count = 0;
+        int frame_size = image_convert_buffer_size(_width, _height, formats[f].format);
+        char name[64];
+
+        if (0 != load_frames(formats[f].format, frames, &frame_count))
+            return -1;
+
+        snprintf(name, sizeof(name), "clip %s", formats[f].name);
+        if (0 != run_gate(name, formats[f].format, frame_count, [&](int i) { return &frames[(size_t)i * frame_size]; }))
+            return -1;
+
+        // a static scene: the first frame again and again with sensor noise on luma, only refreshes are sent
+        if (KP_IMAGE_FORMAT_YUYV == formats[f].format)
+        {
+            std::vector<uint8_t> noisy(frame_size);
+            uint32_t random_state = 0x1234567u;
+
+            snprintf(name, sizeof(name), "static scene %s, noise +-%d", formats[f].name, NOISE_AMPLITUDE);
+            if (0 != run_gate(name, formats[f].format, frame_count, [&](int i) {
+                    for (int k = 0; k < frame_size; k += 2)
+                    {
+                        random_state = random_state * 1664525u + 1013904223u;
+                        int value = frames[k] + (int)((random_state >> 24) % (2 * NOISE_AMPLITUDE + 1)) - NOISE_AMPLITUDE;
+                        noisy[k] = (uint8_t)((value < 0) ? 0 : (value > 255) ? 255 : value);
+                        noisy[k + 1] = frames[k + 1];
+                    }
+                    return noisy.data();
+                }))
+                return -1;
+        }
+    }
+
+    return 0;
+}
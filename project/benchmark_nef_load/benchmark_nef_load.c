@@ -0,0 +1,208 @@
+/**
+ * @file        benchmark_nef_load.c
+ * @brief       benchmark of parsing a NEF into kp_model_nef_descriptor_t, first load and reload of the same NEF buffer and file
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "kp_core.h"
+#include "internal_func.h"
+
+static char _model_file_path[128] = "../../res/models/KL520/ssd_fd_lm/models_520.nef";
+static int _loop = 50;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static char *read_file(const char *file_path, int *file_size)
+{
+    FILE *file = fopen(file_path, "rb");
+    if (NULL == file)
+    {
+        printf("Error! %s(): open file %s failed\n", __FUNCTION__, file_path);
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *buffer = (0 < size) ? (char *)malloc(size) : NULL;
+    if ((NULL == buffer) || ((size_t)size != fread(buffer, 1, size, file)))
+    {
+        printf("Error! %s(): read file %s failed\n", __FUNCTION__, file_path);
+        free(buffer);
+        buffer = NULL;
+    }
+
+    fclose(file);
+    *file_size = (int)size;
+
+    return buffer;
+}
+
+static kp_product_id_t get_product_id(uint32_t model_target_chip)
+{
+    switch (model_target_chip)
+    {
+    case KP_MODEL_TARGET_CHIP_KL720:
+        return KP_DEVICE_KL720;
+    case KP_MODEL_TARGET_CHIP_KL530:
+        return KP_DEVICE_KL530;
+    case KP_MODEL_TARGET_CHIP_KL730:
+        return KP_DEVICE_KL730;
+    case KP_MODEL_TARGET_CHIP_KL630:
+        return KP_DEVICE_KL630;
+    default:
+        return KP_DEVICE_KL520;
+    }
+}
+
+/*
+ * one load as kp_load_model() does it: CRC check, header and model information, descriptor of the loaded models,
+ * or as kp_load_model_from_file() does it if 'file_path' is not NULL (the file read is not timed)
+ */
+static int load_nef(const char *file_path, char *nef_buf, int nef_size, kp_product_id_t target, double *time_spent)
+{
+    kp_metadata_t metadata;
+    kp_nef_info_t nef_info;
+    kp_nef_file_stat_t file_stat;
+    kp_model_nef_descriptor_t model_desc;
+    int ret;
+
+    memset(&model_desc, 0, sizeof(model_desc));
+
+    double time_begin = get_time_ms();
+
+    if (NULL == file_path)
+        ret = load_model_info_from_nef(nef_buf, nef_size, target, &metadata, &nef_info, &model_desc);
+    else if (KP_SUCCESS == (ret = get_nef_file_stat(file_path, &file_stat)))
+        ret = load_model_info_from_nef_file(file_path, &file_stat, nef_buf, nef_size, target, &metadata, &nef_info, &model_desc);
+
+    *time_spent = get_time_ms() - time_begin;
+
+    if ((KP_SUCCESS == ret) && (0 == model_desc.num_models))
+        ret = KP_ERROR_INVALID_MODEL_21;
+
+    kp_release_model_nef_descriptor(&model_desc);
+
+    return ret;
+}
+
+/* average and min of 'loop' reloads */
+static int reload_nef(const char *file_path, char *nef_buf, int nef_size, kp_product_id_t target, double *average, double *min)
+{
+    double time_spent = 0;
+    double sum = 0;
+
+    for (int i = 0; i < _loop; i++)
+    {
+        int ret = load_nef(file_path, nef_buf, nef_size, target, &time_spent);
+        if (KP_SUCCESS != ret)
+        {
+            printf("reload NEF failed, error = %d (%s)\n", ret, kp_error_string(ret));
+            return ret;
+        }
+
+        sum += time_spent;
+        if ((0 == i) || (time_spent < *min))
+            *min = time_spent;
+    }
+
+    *average = sum / _loop;
+
+    return KP_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    int nef_size = 0;
+    double first_load = 0;
+    double first_file_load = 0;
+    double reload_average = 0;
+    double reload_min = 0;
+    double file_reload_average = 0;
+    double file_reload_min = 0;
+    double crc_sum = 0;
+
+    if (1 < argc)
+        strncpy(_model_file_path, argv[1], sizeof(_model_file_path) - 1);
+
+    if (2 < argc)
+        _loop = atoi(argv[2]);
+
+    if (0 >= _loop)
+    {
+        printf("usage: %s [nef path] [loop]\n", argv[0]);
+        return -1;
+    }
+
+    char *nef_buf = read_file(_model_file_path, &nef_size);
+    if (NULL == nef_buf)
+        return -1;
+
+    /* the target chip of the NEF, the descriptor builder rejects a mismatched platform */
+    kp_nef_handler_t nef_handler = 0;
+    kp_metadata_t metadata;
+    memset(&metadata, 0, sizeof(metadata));
+
+    if ((KP_SUCCESS != read_nef_content_table(nef_buf, nef_size, true, &nef_handler)) ||
+        (KP_SUCCESS != read_nef_header_information(&nef_handler, &metadata)))
+    {
+        printf("Error! %s is not a valid NEF\n", _model_file_path);
+        free(nef_buf);
+        return -1;
+    }
+
+    kp_product_id_t target = get_product_id(metadata.target);
+
+    printf("NEF: %s, %d bytes, target 0x%X\n", _model_file_path, nef_size, (unsigned int)target);
+
+    /******* first load parses setup.bin, later loads copy the cached descriptor but verify the CRC again *******/
+    int ret = load_nef(NULL, nef_buf, nef_size, target, &first_load);
+    if (KP_SUCCESS == ret)
+        ret = reload_nef(NULL, nef_buf, nef_size, target, &reload_average, &reload_min);
+
+    /******* first load of the file verifies its CRC, reloads of the unchanged file do not *******/
+    if (KP_SUCCESS == ret)
+        ret = load_nef(_model_file_path, nef_buf, nef_size, target, &first_file_load);
+    if (KP_SUCCESS == ret)
+        ret = reload_nef(_model_file_path, nef_buf, nef_size, target, &file_reload_average, &file_reload_min);
+
+    if (KP_SUCCESS != ret)
+    {
+        printf("load NEF failed, error = %d (%s)\n", ret, kp_error_string(ret));
+        free(nef_buf);
+        return -1;
+    }
+
+    /******* the CRC over the whole NEF, verified on every load of a buffer *******/
+    for (int i = 0; i < _loop; i++)
+    {
+        double time_begin = get_time_ms();
+        read_nef_content_table(nef_buf, nef_size, true, &nef_handler);
+        crc_sum += get_time_ms() - time_begin;
+    }
+
+    printf("first load  : %8.3f ms\n", first_load);
+    printf("reload      : %8.3f ms average, %8.3f ms min (%d loops)\n", reload_average, reload_min, _loop);
+    printf("file load   : %8.3f ms (descriptor cached, CRC verified)\n", first_file_load);
+    printf("file reload : %8.3f ms average, %8.3f ms min (%d loops)\n", file_reload_average, file_reload_min, _loop);
+    printf("CRC check   : %8.3f ms average\n", crc_sum / _loop);
+
+    free(nef_buf);
+
+    return 0;
+}
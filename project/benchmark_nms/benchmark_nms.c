@@ -0,0 +1,190 @@
+/**
+ * @file        benchmark_nms.c
+ * @brief       benchmark of the vector NMS of postprocess.c against the pairwise box_iou() loop at 100, 500 and 2000 candidates
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* the NMS functions are static, postprocess.c is built as part of this file */
+#include "../../ex_common/postprocess.c"
+
+#define BENCHMARK_NMS_THRESH 0.45
+
+static int _loop = 100;
+
+static const int _candidate_counts[] = {100, 500, 2000};
+
+static uint32_t _random_state = 0x2545f491;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static float random_float(float min, float max)
+{
+    _random_state = _random_state * 1664525u + 1013904223u;
+
+    return min + (max - min) * (float)(_random_state >> 8) / (float)(1 << 24);
+}
+
+/* candidates in clusters of about 8 boxes around objects of a 640x640 image, sorted as NMS expects them */
+static void make_candidates(kp_bounding_box_t *boxes, int count)
+{
+    int cluster_count = (count + 7) / 8;
+    float cx = 0, cy = 0, w = 0, h = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (0 == i % (count / cluster_count))
+        {
+            w = random_float(16, 200);
+            h = random_float(16, 200);
+            cx = random_float(0, 640);
+            cy = random_float(0, 640);
+        }
+
+        float jitter_w = w * random_float(0.8f, 1.2f);
+        float jitter_h = h * random_float(0.8f, 1.2f);
+        float jitter_x = cx + w * random_float(-0.15f, 0.15f);
+        float jitter_y = cy + h * random_float(-0.15f, 0.15f);
+
+        boxes[i].x1 = jitter_x - jitter_w / 2;
+        boxes[i].y1 = jitter_y - jitter_h / 2;
+        boxes[i].x2 = jitter_x + jitter_w / 2;
+        boxes[i].y2 = jitter_y + jitter_h / 2;
+        boxes[i].score = random_float(0.05f, 1.0f);
+        boxes[i].class_num = 0;
+    }
+
+    qsort(boxes, count, sizeof(kp_bounding_box_t), box_comparator);
+}
+
+/* the NMS loop postprocess.c used before nms_soa_suppress() */
+static void pairwise_suppress(kp_bounding_box_t *boxes, int count, int nms_type, double nms_thresh)
+{
+    for (int j = 0; j < count; j++)
+    {
+        if (boxes[j].score == 0)
+            continue;
+
+        for (int k = j + 1; k < count; k++)
+        {
+            if (box_iou(&boxes[j], &boxes[k], nms_type) > nms_thresh)
+                boxes[k].score = 0;
+        }
+    }
+}
+
+static int count_kept(kp_bounding_box_t *boxes, int count)
+{
+    int kept = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (boxes[i].score > 0)
+            kept++;
+    }
+
+    return kept;
+}
+
+int main(int argc, char *argv[])
+{
+    static const struct
+    {
+        const char *name;
+        int nms_type;
+    } nms_types[] = {{"union", IOU_UNION}, {"min", IOU_MIN}};
+
+    int max_count = _candidate_counts[sizeof(_candidate_counts) / sizeof(_candidate_counts[0]) - 1];
+    kp_bounding_box_t *candidates = malloc(max_count * sizeof(kp_bounding_box_t));
+    kp_bounding_box_t *expected = malloc(max_count * sizeof(kp_bounding_box_t));
+    kp_bounding_box_t *boxes = malloc(max_count * sizeof(kp_bounding_box_t));
+    float *box_soa = malloc(NMS_SOA_NUM * max_count * sizeof(float));
+    float thresh = nms_float_threshold(BENCHMARK_NMS_THRESH);
+    int mismatch_count = 0;
+
+    if (argc > 1)
+        _loop = atoi(argv[1]);
+
+    if (0 >= _loop)
+    {
+        printf("usage: %s [loop]\n", argv[0]);
+        return -1;
+    }
+
+    if (!candidates || !expected || !boxes || !box_soa)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return -1;
+    }
+
+#ifdef NMS_VEC_WIDTH
+    printf("NMS threshold %.2f, %d loops, %d lanes\n\n", BENCHMARK_NMS_THRESH, _loop, NMS_VEC_WIDTH);
+#else
+    printf("NMS threshold %.2f, %d loops, no vector code for this target\n\n", BENCHMARK_NMS_THRESH, _loop);
+#endif
+    printf("%10s %6s %6s %14s %14s %9s %10s\n", "candidates", "iou", "kept", "pairwise (ms)", "vector (ms)", "speedup", "identical");
+
+    for (size_t c = 0; c < sizeof(_candidate_counts) / sizeof(_candidate_counts[0]); c++)
+    {
+        int count = _candidate_counts[c];
+        float *soa[NMS_SOA_NUM];
+
+        for (int i = 0; i < NMS_SOA_NUM; i++)
+            soa[i] = &box_soa[i * count];
+
+        make_candidates(candidates, count);
+
+        for (size_t t = 0; t < sizeof(nms_types) / sizeof(nms_types[0]); t++)
+        {
+            double pairwise_ms = 0;
+            double vector_ms = 0;
+
+            for (int i = 0; i < _loop; i++)
+            {
+                memcpy(expected, candidates, count * sizeof(kp_bounding_box_t));
+                double begin = get_time_ms();
+                pairwise_suppress(expected, count, nms_types[t].nms_type, BENCHMARK_NMS_THRESH);
+                pairwise_ms += get_time_ms() - begin;
+
+                memcpy(boxes, candidates, count * sizeof(kp_bounding_box_t));
+                begin = get_time_ms();
+                // keep_limit above the count, all boxes are suppressed as in the pairwise loop
+                nms_soa_suppress(boxes, 0, count, soa, nms_types[t].nms_type, thresh, count + 1);
+                vector_ms += get_time_ms() - begin;
+            }
+
+            bool identical = (0 == memcmp(boxes, expected, count * sizeof(kp_bounding_box_t)));
+            if (!identical)
+                mismatch_count++;
+
+            printf("%10d %6s %6d %14.4f %14.4f %8.2fx %10s\n", count, nms_types[t].name, count_kept(boxes, count),
+                   pairwise_ms / _loop, vector_ms / _loop, pairwise_ms / vector_ms, identical ? "yes" : "NO");
+        }
+    }
+
+    free(candidates);
+    free(expected);
+    free(boxes);
+    free(box_soa);
+
+    if (0 < mismatch_count)
+    {
+        printf("\n%d cases differ from the pairwise loop\n", mismatch_count);
+        return -1;
+    }
+
+    return 0;
+}
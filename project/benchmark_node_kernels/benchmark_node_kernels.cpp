@@ -0,0 +1,207 @@
+/**
+ * @file        benchmark_node_kernels.cpp
+ * @brief       benchmark of the C++ node conversion kernels (kp_inference.hpp) against the C node view path for each NPU layout
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include "kp_inference.hpp"
+
+static int _loop = 20;
+
+// YOLOv3 416x416 largest output node by default
+static int _channel = 255;
+static int _height = 52;
+static int _width = 52;
+
+typedef struct
+{
+    const char *name;
+    uint32_t shape_version;
+    uint32_t data_layout;
+    bool per_channel;
+} node_case_t;
+
+static const node_case_t _cases[] = {
+    {"KL720 16W1C8B", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, false},
+    {"KL720 1W16C8B", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, false},
+    {"KL720 8W1C16B", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1, KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, false},
+    {"KL730 16W1C8B", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, false},
+    {"KL730 16W1C8B per-channel", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, true},
+    {"KL730 1W16C8B", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, false},
+    {"KL730 1W16C8B per-channel", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, true},
+    {"KL730 8W1C16B", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, false},
+    {"KL730 16W1C8BHL", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL, false},
+    {"KL730 16W1C8BHL per-channel", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL, true},
+    {"KL730 1W16C8BHL", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL, false},
+    {"KL730 1W16C8BHL per-channel", KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL, true},
+};
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+/*
+ * A BxCxHxW node view as kp_generic_inference_retrieve_node_view() makes it: 1W16C8B layouts group 16 channels,
+ * the other layouts keep rows of 16 (8 for 8W1C16B) aligned width. Returns the NPU data size in bytes.
+ */
+static size_t make_node_view(const node_case_t *node_case, std::vector<int32_t> &radix, std::vector<float> &scale, kp_inf_node_view_t &view)
+{
+    bool channel_group = (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B == node_case->data_layout) || (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL == node_case->data_layout);
+    bool high_low = (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL == node_case->data_layout) || (KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL == node_case->data_layout);
+    bool int16 = (KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B == node_case->data_layout);
+    uint32_t channel_aligned = (_channel + 15) / 16 * 16;
+    uint32_t width_aligned = int16 ? (_width + 7) / 8 * 8 : (_width + 15) / 16 * 16;
+    size_t scalar_count;
+
+    memset(&view, 0, sizeof(view));
+    view.name = (char *)"";
+    view.shape_version = node_case->shape_version;
+    view.data_layout = node_case->data_layout;
+    view.fixed_point_dtype = (int16 || high_low) ? KP_FIXED_POINT_DTYPE_INT16 : KP_FIXED_POINT_DTYPE_INT8;
+    view.channel_group_axis = -1;
+
+    view.shape_len = 4;
+    view.shape[0] = 1;
+    view.shape[1] = _channel;
+    view.shape[2] = _height;
+    view.shape[3] = _width;
+
+    view.stride_onnx[3] = 1;
+    view.stride_onnx[2] = _width;
+    view.stride_onnx[1] = _height * _width;
+    view.stride_onnx[0] = _channel * _height * _width;
+
+    if (channel_group)
+    {
+        view.stride_npu[3] = 16;
+        view.stride_npu[2] = _width * 16;
+        view.stride_npu[1] = 1;
+        view.stride_npu[0] = channel_aligned * _height * _width;
+        view.channel_group_axis = 1;
+        view.channel_group_stride = _height * _width * 16 - 16;
+        scalar_count = (size_t)channel_aligned * _height * _width;
+    }
+    else
+    {
+        view.stride_npu[3] = 1;
+        view.stride_npu[2] = width_aligned;
+        view.stride_npu[1] = _height * width_aligned;
+        view.stride_npu[0] = _channel * _height * width_aligned;
+        scalar_count = (size_t)_channel * _height * width_aligned;
+    }
+
+    radix.assign(node_case->per_channel ? _channel : 1, 0);
+    scale.assign(radix.size(), 0);
+    for (size_t i = 0; i < radix.size(); i++)
+    {
+        radix[i] = 4 + (int32_t)(i % 5);
+        scale[i] = 0.75f + 0.01f * (float)(i % 17);
+    }
+
+    view.quantization_parameters_len = (uint32_t)radix.size();
+    view.radix_dtype = KP_DTYPE_INT32;
+    view.scale_dtype = KP_DTYPE_FLOAT32;
+    view.radix = radix.data();
+    view.scale = scale.data();
+    view.quantization_factor = scale[0] * (float)(1 << radix[0]);
+    view.quantized_axis_stride = node_case->per_channel ? _height * _width : 0;
+
+    // high/low layouts keep 16 low bytes then 16 high bytes for each 16 scalars
+    return (int16 || high_low) ? scalar_count * 2 + 32 : scalar_count;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+        _loop = atoi(argv[1]);
+
+    if (argc > 4)
+    {
+        _channel = atoi(argv[2]);
+        _height = atoi(argv[3]);
+        _width = atoi(argv[4]);
+    }
+
+    if ((0 >= _loop) || (0 >= _channel) || (0 >= _height) || (0 >= _width))
+    {
+        printf("usage: %s [loop] [channel height width]\n", argv[0]);
+        return -1;
+    }
+
+    uint32_t num_data = (uint32_t)_channel * _height * _width;
+    std::vector<float> c_result(num_data);
+    std::vector<float> cpp_result(num_data);
+    int32_t start[4] = {0, 0, 0, 0};
+    int32_t size[4] = {1, _channel, _height, _width};
+    int mismatch_count = 0;
+
+    printf("node 1x%dx%dx%d, %d loops, float values\n\n", _channel, _height, _width, _loop);
+    printf("%-30s %12s %12s %9s %10s\n", "layout", "C (ms)", "C++ (ms)", "speedup", "identical");
+
+    for (const node_case_t &node_case : _cases)
+    {
+        std::vector<int32_t> radix;
+        std::vector<float> scale;
+        kp_inf_node_view_t view;
+        size_t data_size = make_node_view(&node_case, radix, scale, view);
+        std::vector<uint8_t> data(data_size);
+        uint32_t random_state = 0x1234567u;
+
+        for (size_t i = 0; i < data_size; i++)
+        {
+            random_state = random_state * 1664525u + 1013904223u;
+            data[i] = (uint8_t)(random_state >> 24);
+        }
+        view.data = data.data();
+
+        double begin = get_time_ms();
+        for (int i = 0; i < _loop; i++)
+        {
+            if (KP_SUCCESS != kp_inf_node_view_extract_float_region(&view, start, size, c_result.data(), num_data))
+            {
+                printf("%s: kp_inf_node_view_extract_float_region() failed\n", node_case.name);
+                return -1;
+            }
+        }
+        double c_ms = (get_time_ms() - begin) / _loop;
+
+        begin = get_time_ms();
+        for (int i = 0; i < _loop; i++)
+        {
+            if (KP_SUCCESS != kp::retrieve_node<float>(view, cpp_result.data(), num_data))
+            {
+                printf("%s: kp::retrieve_node() failed\n", node_case.name);
+                return -1;
+            }
+        }
+        double cpp_ms = (get_time_ms() - begin) / _loop;
+
+        bool identical = (0 == memcmp(c_result.data(), cpp_result.data(), sizeof(float) * num_data));
+        if (!identical)
+            mismatch_count++;
+
+        printf("%-30s %12.3f %12.3f %8.2fx %10s\n", node_case.name, c_ms, cpp_ms, c_ms / cpp_ms, identical ? "yes" : "NO");
+    }
+
+    if (0 < mismatch_count)
+    {
+        printf("\n%d layouts differ from the C path\n", mismatch_count);
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,332 @@
+/**
+ * @file        benchmark_tracker.c
+ * @brief       latency and identity switches of post_process_tracker_t on MOTChallenge files or synthetic scenes
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "postprocess.h"
+
+#define MAX_BOX_PER_FRAME 4096
+
+typedef struct
+{
+    int frame;
+    int object_id;                  // ground truth ID, -1 for detections
+    kp_bounding_box_t box;
+} record_t;
+
+typedef struct
+{
+    float x, y, w, h, vx, vy;
+} object_t;
+
+static float _iou_thresh = 0.3f;
+static int _max_lost_frames = 10;
+
+static kp_bounding_box_t _boxes[MAX_BOX_PER_FRAME];
+static int _object_ids[MAX_BOX_PER_FRAME];
+static uint32_t _track_ids[MAX_BOX_PER_FRAME];
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+/* identity switches: a ground truth object is given a track ID other than the one of its last detection */
+typedef struct
+{
+    uint32_t *last_track_id;        // indexed by ground truth ID
+    int object_capacity;
+    int switch_count;
+    int detection_count;
+} switch_counter_t;
+
+static void count_switches(switch_counter_t *counter, const int *object_ids, const uint32_t *track_ids, int box_count)
+{
+    for (int i = 0; i < box_count; i++)
+    {
+        if ((0 > object_ids[i]) || (object_ids[i] >= counter->object_capacity))
+            continue;
+
+        uint32_t *last = &counter->last_track_id[object_ids[i]];
+
+        if ((0 != *last) && (*last != track_ids[i]))
+            counter->switch_count++;
+
+        *last = track_ids[i];
+        counter->detection_count++;
+    }
+}
+
+static int compare_record(const void *a, const void *b)
+{
+    return ((const record_t *)a)->frame - ((const record_t *)b)->frame;
+}
+
+/* MOTChallenge text file, one box per line: frame, id, left, top, width, height, confidence, ... */
+static record_t *read_mot_file(const char *file_path, int *record_count, int *max_object_id)
+{
+    FILE *file = fopen(file_path, "r");
+    if (NULL == file)
+    {
+        printf("Error! %s(): open file %s failed\n", __FUNCTION__, file_path);
+        return NULL;
+    }
+
+    int capacity = 4096;
+    int count = 0;
+    record_t *records = (record_t *)malloc(capacity * sizeof(record_t));
+    char line[256];
+
+    *max_object_id = -1;
+
+    while ((NULL != records) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        int frame;
+        float object_id, left, top, width, height, confidence = 1.0f;
+
+        if (6 > sscanf(line, "%d,%f,%f,%f,%f,%f,%f", &frame, &object_id, &left, &top, &width, &height, &confidence))
+            continue;
+
+        // boxes of ground truth files marked as ignored or not pedestrians are skipped
+        if (0 == confidence)
+            continue;
+
+        if (count == capacity)
+        {
+            record_t *grown = (record_t *)realloc(records, capacity * 2 * sizeof(record_t));
+            if (NULL == grown)
+            {
+                free(records);
+                records = NULL;
+                break;
+            }
+
+            records = grown;
+            capacity *= 2;
+        }
+
+        record_t *record = &records[count++];
+        record->frame = frame;
+        record->object_id = (0 < object_id) ? (int)object_id : -1;
+        record->box.x1 = left;
+        record->box.y1 = top;
+        record->box.x2 = left + width;
+        record->box.y2 = top + height;
+        record->box.score = confidence;
+        record->box.class_num = 0;
+
+        if (record->object_id > *max_object_id)
+            *max_object_id = record->object_id;
+    }
+
+    fclose(file);
+
+    if (NULL == records)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return NULL;
+    }
+
+    qsort(records, count, sizeof(record_t), compare_record);
+    *record_count = count;
+
+    return records;
+}
+
+static int run_mot_file(const char *file_path)
+{
+    int record_count = 0;
+    int max_object_id = -1;
+    record_t *records = read_mot_file(file_path, &record_count, &max_object_id);
+
+    if (NULL == records)
+        return -1;
+
+    post_process_tracker_t *tracker = post_process_tracker_create(_iou_thresh, _max_lost_frames);
+    switch_counter_t counter = {0};
+
+    counter.object_capacity = max_object_id + 1;
+    counter.last_track_id = (uint32_t *)calloc(counter.object_capacity + 1, sizeof(uint32_t));
+
+    if ((NULL == tracker) || (NULL == counter.last_track_id))
+    {
+        printf("Error! out of memory\n");
+        return -1;
+    }
+
+    double time_spent = 0;
+    double time_max = 0;
+    int frame_count = 0;
+    uint32_t max_track_id = 0;
+
+    for (int i = 0; i < record_count;)
+    {
+        int frame = records[i].frame;
+        int box_count = 0;
+
+        for (; (i < record_count) && (records[i].frame == frame); i++)
+        {
+            if (MAX_BOX_PER_FRAME == box_count)
+                continue;
+
+            _boxes[box_count] = records[i].box;
+            _object_ids[box_count] = records[i].object_id;
+            box_count++;
+        }
+
+        double time_begin = get_time_ms();
+        post_process_tracker_update(tracker, _boxes, box_count, _track_ids);
+        double time_frame = get_time_ms() - time_begin;
+
+        time_spent += time_frame;
+        if (time_frame > time_max)
+            time_max = time_frame;
+
+        for (int k = 0; k < box_count; k++)
+        {
+            if (_track_ids[k] > max_track_id)
+                max_track_id = _track_ids[k];
+        }
+
+        count_switches(&counter, _object_ids, _track_ids, box_count);
+        frame_count++;
+    }
+
+    printf("%s: %d frames, %d boxes, %.1f boxes per frame\n", file_path, frame_count, record_count, (double)record_count / frame_count);
+    printf("per frame: %.4f ms average, %.4f ms max\n", time_spent / frame_count, time_max);
+    printf("tracks started: %u\n", max_track_id);
+
+    if (0 <= max_object_id)
+        printf("identity switches: %d of %d boxes with ground truth IDs (%d objects)\n", counter.switch_count, counter.detection_count,
+               max_object_id);
+
+    post_process_tracker_release(tracker);
+    free(counter.last_track_id);
+    free(records);
+
+    return 0;
+}
+
+/* pedestrian-sized boxes bouncing in a 1920x1080 frame, with pixel jitter, 5% misses and false positives */
+static int run_synthetic(int object_count, int frame_count)
+{
+    object_t *objects = (object_t *)malloc(object_count * sizeof(object_t));
+    post_process_tracker_t *tracker = post_process_tracker_create(_iou_thresh, _max_lost_frames);
+    switch_counter_t counter = {0};
+
+    counter.object_capacity = object_count;
+    counter.last_track_id = (uint32_t *)calloc(object_count, sizeof(uint32_t));
+
+    if ((NULL == objects) || (NULL == tracker) || (NULL == counter.last_track_id) || (MAX_BOX_PER_FRAME < object_count + object_count / 50))
+    {
+        printf("Error! out of memory\n");
+        return -1;
+    }
+
+    srand(object_count);
+
+    for (int i = 0; i < object_count; i++)
+    {
+        objects[i].w = 15 + rand() % 40;
+        objects[i].h = objects[i].w * 2.2f;
+        objects[i].x = rand() % 1920;
+        objects[i].y = rand() % 1080;
+        objects[i].vx = (rand() % 100 - 50) / 25.0f;
+        objects[i].vy = (rand() % 100 - 50) / 50.0f;
+    }
+
+    double time_spent = 0;
+
+    for (int frame = 0; frame < frame_count; frame++)
+    {
+        int box_count = 0;
+
+        for (int i = 0; i < object_count; i++)
+        {
+            object_t *object = &objects[i];
+
+            object->x += object->vx;
+            object->y += object->vy;
+            if ((0 > object->x) || (1920 < object->x))
+                object->vx = -object->vx;
+            if ((0 > object->y) || (1080 < object->y))
+                object->vy = -object->vy;
+
+            if (0 == rand() % 20)
+                continue;
+
+            float noise_x = (rand() % 5 - 2) * 0.7f;
+            float noise_y = (rand() % 5 - 2) * 0.7f;
+            kp_bounding_box_t *box = &_boxes[box_count];
+
+            box->x1 = (int)(object->x - object->w / 2 + noise_x);
+            box->y1 = (int)(object->y - object->h / 2 + noise_y);
+            box->x2 = (int)(object->x + object->w / 2 + noise_x);
+            box->y2 = (int)(object->y + object->h / 2 + noise_y);
+            box->score = 0.9f;
+            box->class_num = 0;
+            _object_ids[box_count++] = i;
+        }
+
+        for (int k = 0; k < object_count / 50; k++)
+        {
+            kp_bounding_box_t *box = &_boxes[box_count];
+
+            box->x1 = rand() % 1900;
+            box->y1 = rand() % 1000;
+            box->x2 = box->x1 + 30;
+            box->y2 = box->y1 + 60;
+            box->score = 0.5f;
+            box->class_num = 0;
+            _object_ids[box_count++] = -1;
+        }
+
+        double time_begin = get_time_ms();
+        post_process_tracker_update(tracker, _boxes, box_count, _track_ids);
+        time_spent += get_time_ms() - time_begin;
+
+        count_switches(&counter, _object_ids, _track_ids, box_count);
+    }
+
+    printf("%4d objects: %.4f ms per frame, identity switches %d of %d boxes\n", object_count, time_spent / frame_count, counter.switch_count,
+           counter.detection_count);
+
+    post_process_tracker_release(tracker);
+    free(counter.last_track_id);
+    free(objects);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (1 < argc)
+    {
+        // e.g. det/det.txt (recorded detections) or gt/gt.txt (ground truth boxes and IDs) of MOT16-03
+        return run_mot_file(argv[1]);
+    }
+
+    printf("synthetic 1920x1080 scenes, 600 frames (pass a MOTChallenge det.txt or gt.txt to track its boxes)\n");
+
+    int object_counts[] = {50, 100, 200, 500};
+
+    for (size_t i = 0; i < sizeof(object_counts) / sizeof(object_counts[0]); i++)
+    {
+        if (0 != run_synthetic(object_counts[i], 600))
+            return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file        benchmark_yolo_executor.c
+ * @brief       benchmark of post_process_executor_run_yolo() at 1 ~ 8 workers, the results are checked against one context post-processing the items one by one
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "postprocess.h"
+
+#define BATCH_SIZE 16
+#define MAX_HEAD_COUNT 3
+#define CLASS_COUNT 80
+#define ANCHOR_COUNT 3
+#define BOX_CHANNEL (5 + CLASS_COUNT)
+
+static int _loop = 20;
+
+static const int _worker_counts[] = {1, 2, 3, 4, 6, 8};
+
+static const struct
+{
+    const char *name;
+    post_process_yolo_type_t type;
+    float thresh_value;
+    uint32_t model_input_size;
+    int head_count;
+    int grid_sizes[MAX_HEAD_COUNT];
+    bool logits;                    // node values are logits (sigmoid in post-processing) or already activated
+} _models[] = {
+    {"yolo_v3 416", POST_PROCESS_YOLO_V3, 0.2f, 416, 2, {13, 26}, true},
+    {"yolo_v5_520 640", POST_PROCESS_YOLO_V5_520, 0.3f, 640, 3, {80, 40, 20}, true},
+    {"yolo_v5_720 640", POST_PROCESS_YOLO_V5_720, 0.3f, 640, 3, {80, 40, 20}, false},
+};
+
+static uint32_t _random_state = 0x1f83d9ab;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static float random_uniform()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return ((float)(_random_state >> 8) + 1.0f) / (float)((1 << 24) + 1);
+}
+
+static float random_gauss()
+{
+    float u = random_uniform();
+    float v = random_uniform();
+
+    return sqrtf(-2 * logf(u)) * cosf(6.2831853f * v);
+}
+
+/* one head of 'ANCHOR_COUNT' anchors, about 1% of the cells hold an object with a few likely classes */
+static kp_inf_float_node_output_t *make_node(int grid_size, bool logits)
+{
+    int channel = ANCHOR_COUNT * BOX_CHANNEL;
+    uint32_t num_data = (uint32_t)channel * grid_size * grid_size;
+    kp_inf_float_node_output_t *node = calloc(1, sizeof(kp_inf_float_node_output_t) + num_data * sizeof(float));
+
+    if (NULL == node)
+        return NULL;
+
+    node->shape = malloc(4 * sizeof(int32_t));
+    if (NULL == node->shape)
+    {
+        free(node);
+        return NULL;
+    }
+
+    node->name = "";
+    node->shape_len = 4;
+    node->shape[0] = 1;
+    node->shape[1] = channel;
+    node->shape[2] = grid_size;
+    node->shape[3] = grid_size;
+    node->num_data = num_data;
+
+    for (uint32_t i = 0; i < num_data; i++)
+    {
+        float logit = random_gauss() * 1.5f - 6;
+
+        if (0.01f > random_uniform())
+            logit = random_gauss() + 2;
+
+        node->data[i] = logits ? logit : 1 / (1 + expf(-logit));
+    }
+
+    return node;
+}
+
+static void release_node(kp_inf_float_node_output_t *node)
+{
+    if (NULL == node)
+        return;
+
+    free(node->shape);
+    free(node);
+}
+
+int main(int argc, char *argv[])
+{
+    kp_inf_float_node_output_t *nodes[BATCH_SIZE][MAX_HEAD_COUNT];
+    kp_inf_float_node_output_t *item_nodes[BATCH_SIZE][MAX_HEAD_COUNT];
+    kp_hw_pre_proc_info_t pre_proc_info[BATCH_SIZE];
+    post_process_yolo_batch_item_t items[BATCH_SIZE];
+    kp_yolo_result_t *expected = malloc(BATCH_SIZE * sizeof(kp_yolo_result_t));
+    kp_yolo_result_t *results = malloc(BATCH_SIZE * sizeof(kp_yolo_result_t));
+    int expected_status[BATCH_SIZE];
+    int mismatch_count = 0;
+
+    if (argc > 1)
+        _loop = atoi(argv[1]);
+
+    if (0 >= _loop)
+    {
+        printf("usage: %s [loop]\n", argv[0]);
+        return -1;
+    }
+
+    if (!expected || !results)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return -1;
+    }
+
+    memset(nodes, 0, sizeof(nodes));
+
+    printf("batch of %d items, %d loops\n\n", BATCH_SIZE, _loop);
+    printf("%16s %8s %7s %16s %9s %10s\n", "model", "workers", "boxes", "per batch (ms)", "speedup", "identical");
+
+    for (size_t m = 0; m < sizeof(_models) / sizeof(_models[0]); m++)
+    {
+        post_process_yolo_context_t *context = post_process_yolo_create_context();
+        double single_worker_ms = 0;
+        int box_count = 0;
+
+        if (NULL == context)
+            return -1;
+
+        // letterbox of a 1280x720 image, the padding changes along the batch
+        for (int i = 0; i < BATCH_SIZE; i++)
+        {
+            for (int h = 0; h < _models[m].head_count; h++)
+            {
+                nodes[i][h] = make_node(_models[m].grid_sizes[h], _models[m].logits);
+                if (NULL == nodes[i][h])
+                {
+                    printf("Error! %s(): out of memory\n", __FUNCTION__);
+                    return -1;
+                }
+
+                item_nodes[i][h] = nodes[i][h];
+            }
+
+            memset(&pre_proc_info[i], 0, sizeof(kp_hw_pre_proc_info_t));
+            pre_proc_info[i].img_width = 1280;
+            pre_proc_info[i].img_height = 720;
+            pre_proc_info[i].model_input_width = _models[m].model_input_size;
+            pre_proc_info[i].model_input_height = _models[m].model_input_size;
+            pre_proc_info[i].resized_img_width = _models[m].model_input_size;
+            pre_proc_info[i].resized_img_height = _models[m].model_input_size * 720 / 1280;
+            pre_proc_info[i].pad_top = (_models[m].model_input_size - pre_proc_info[i].resized_img_height) / 2 + i % 4;
+
+            // the single-context reference, items one by one
+            memset(&expected[i], 0, sizeof(kp_yolo_result_t));
+
+            switch (_models[m].type)
+            {
+            case POST_PROCESS_YOLO_V3:
+                expected_status[i] = post_process_yolo_v3_with_context(context, nodes[i], _models[m].head_count, &pre_proc_info[i], _models[m].thresh_value, &expected[i]);
+                break;
+            case POST_PROCESS_YOLO_V5_520:
+                expected_status[i] = post_process_yolo_v5_520_with_context(context, nodes[i], _models[m].head_count, &pre_proc_info[i], _models[m].thresh_value, &expected[i]);
+                break;
+            default:
+                expected_status[i] = post_process_yolo_v5_720_with_context(context, nodes[i], _models[m].head_count, &pre_proc_info[i], _models[m].thresh_value, &expected[i]);
+                break;
+            }
+
+            box_count += expected[i].box_count;
+        }
+
+        post_process_yolo_release_context(context);
+
+        for (size_t w = 0; w < sizeof(_worker_counts) / sizeof(_worker_counts[0]); w++)
+        {
+            post_process_executor_t *executor = post_process_executor_create(_worker_counts[w]);
+            bool identical = true;
+            double run_ms = 0;
+
+            if (NULL == executor)
+                return -1;
+
+            for (int l = 0; l < _loop; l++)
+            {
+                for (int i = 0; i < BATCH_SIZE; i++)
+                {
+                    items[i].node_output = item_nodes[i];
+                    items[i].num_output_node = _models[m].head_count;
+                    items[i].pre_proc_info = &pre_proc_info[i];
+                    items[i].yolo_result = &results[i];
+                    items[i].status = -1;
+                }
+
+                memset(results, 0, BATCH_SIZE * sizeof(kp_yolo_result_t));
+
+                double begin = get_time_ms();
+                post_process_executor_run_yolo(executor, _models[m].type, _models[m].thresh_value, items, BATCH_SIZE);
+                run_ms += get_time_ms() - begin;
+
+                for (int i = 0; i < BATCH_SIZE; i++)
+                {
+                    if ((items[i].status != expected_status[i]) || (results[i].box_count != expected[i].box_count) ||
+                        (results[i].class_count != expected[i].class_count) ||
+                        (0 != memcmp(results[i].boxes, expected[i].boxes, expected[i].box_count * sizeof(kp_bounding_box_t))))
+                        identical = false;
+                }
+            }
+
+            post_process_executor_release(executor);
+
+            if (!identical)
+                mismatch_count++;
+
+            if (1 == _worker_counts[w])
+                single_worker_ms = run_ms;
+
+            printf("%16s %8d %7d %16.3f %8.2fx %10s\n", _models[m].name, _worker_counts[w], box_count, run_ms / _loop,
+                   single_worker_ms / run_ms, identical ? "yes" : "NO");
+        }
+
+        for (int i = 0; i < BATCH_SIZE; i++)
+        {
+            for (int h = 0; h < _models[m].head_count; h++)
+                release_node(nodes[i][h]);
+        }
+    }
+
+    free(expected);
+    free(results);
+
+    if (0 < mismatch_count)
+    {
+        printf("\n%d cases differ from post-processing the items one by one\n", mismatch_count);
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * @file        benchmark_yolo_partial_sort.c
+ * @brief       benchmark of the partial sort before YOLO NMS against sorting all candidates, on dense synthetic score maps
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* the NMS functions are static, postprocess.c is built as part of this file */
+#include "../../ex_common/postprocess.c"
+
+#define MODEL_INPUT_SIZE 640
+#define CLASS_COUNT 80
+#define OBJECT_CLASS_COUNT 10       // classes of the objects in the score maps, the others only have low scores
+#define HEAD_COUNT 3
+
+static int _loop = 20;
+
+static const float _thresholds[] = {0.9f, 0.8f, 0.7f, 0.6f};
+
+static uint32_t _random_state = 0x6c078965;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static float random_float(float min, float max)
+{
+    _random_state = _random_state * 1664525u + 1013904223u;
+
+    return min + (max - min) * (float)(_random_state >> 8) / (float)(1 << 24);
+}
+
+/*
+ * YOLO V5 output node for KL720 (activated values, CHW) of a 640x640 input: every cell of every anchor has a likely object
+ * of one of OBJECT_CLASS_COUNT classes, so thousands of candidates of each class pass the thresholds
+ */
+static kp_inf_float_node_output_t *make_node(int grid_size, int32_t *shape)
+{
+    int anchor_count = 3;
+    int box_ch = YOLO_V3_BOX_FIX_CH + CLASS_COUNT;
+    int cell_count = grid_size * grid_size;
+    uint32_t num_data = (uint32_t)anchor_count * box_ch * cell_count;
+    kp_inf_float_node_output_t *node = malloc(sizeof(kp_inf_float_node_output_t) + num_data * sizeof(float));
+
+    if (NULL == node)
+        return NULL;
+
+    shape[0] = 1;
+    shape[1] = anchor_count * box_ch;
+    shape[2] = grid_size;
+    shape[3] = grid_size;
+
+    node->name = "";
+    node->shape_len = 4;
+    node->shape = shape;
+    node->num_data = num_data;
+
+    for (int a = 0; a < anchor_count; a++)
+    {
+        float *anchor_data = &node->data[a * box_ch * cell_count];
+
+        for (int k = 0; k < cell_count; k++)
+        {
+            int object_class = (int)random_float(0, OBJECT_CLASS_COUNT);
+
+            anchor_data[0 * cell_count + k] = random_float(0.2f, 0.8f);
+            anchor_data[1 * cell_count + k] = random_float(0.2f, 0.8f);
+            anchor_data[2 * cell_count + k] = random_float(0.3f, 0.7f);
+            anchor_data[3 * cell_count + k] = random_float(0.3f, 0.7f);
+            anchor_data[4 * cell_count + k] = random_float(0.6f, 1.0f);
+
+            for (int j = 0; j < CLASS_COUNT; j++)
+                anchor_data[(YOLO_V3_BOX_FIX_CH + j) * cell_count + k] = (j == object_class) ? random_float(0.5f, 1.0f) : random_float(0, 0.3f);
+        }
+    }
+
+    return node;
+}
+
+/* yolo_class_bucket_nms() as it was before the partial sort: every class is sorted and suppressed as a whole */
+static int full_sort_class_bucket_nms(post_process_yolo_context_t *context, int class_count, int candidate_count, double nms_thresh,
+                                      int max_detection_per_class, const post_process_box_transform_t *box_transform, kp_yolo_result_t *yoloResult)
+{
+    int *class_box_offset = context->class_box_offset;
+    float thresh = nms_float_threshold(nms_thresh);
+    int good_result_count = 0;
+
+    memset(class_box_offset, 0, (class_count + 1) * sizeof(int));
+
+    for (int i = 0; i < candidate_count; i++)
+        class_box_offset[context->candidate_boxes[i].class_num + 1]++;
+
+    for (int i = 0; i < class_count; i++)
+        class_box_offset[i + 1] += class_box_offset[i];
+
+    for (int i = 0; i < candidate_count; i++)
+    {
+        kp_bounding_box_t *bbox = &context->candidate_boxes[i];
+        memcpy(&context->class_boxes[class_box_offset[bbox->class_num]++], bbox, sizeof(kp_bounding_box_t));
+    }
+
+    for (int i = 0; i < class_count; i++)
+    {
+        int class_begin = (0 == i) ? 0 : class_box_offset[i - 1];
+        int class_good_box_count = class_box_offset[i] - class_begin;
+        kp_bounding_box_t *temp_boxes = &context->class_boxes[class_begin];
+
+        if (class_good_box_count == 1)
+        {
+            if (good_result_count < YOLO_GOOD_BOX_MAX)
+            {
+                box_transform_output(box_transform, &(yoloResult->boxes[good_result_count]), &temp_boxes[0]);
+                good_result_count++;
+            }
+        }
+        else if (class_good_box_count >= 2)
+        {
+            float *soa[NMS_SOA_NUM];
+            for (int j = 0; j < NMS_SOA_NUM; j++)
+                soa[j] = &context->box_soa[j * class_good_box_count];
+
+            qsort(temp_boxes, class_good_box_count, sizeof(kp_bounding_box_t), box_comparator);
+            nms_soa_suppress(temp_boxes, 0, class_good_box_count, soa, IOU_UNION, thresh, class_good_box_count + 1);
+
+            int good_count = 0;
+            for (int j = 0; j < class_good_box_count; j++)
+            {
+                if (temp_boxes[j].score > 0 && good_result_count < YOLO_GOOD_BOX_MAX)
+                {
+                    box_transform_output(box_transform, &(yoloResult->boxes[good_result_count]), &temp_boxes[j]);
+                    good_result_count++;
+                    good_count++;
+                }
+                if (max_detection_per_class == good_count)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (good_result_count >= YOLO_GOOD_BOX_MAX)
+            break;
+    }
+
+    return good_result_count;
+}
+
+int main(int argc, char *argv[])
+{
+    static const int grid_sizes[HEAD_COUNT] = {80, 40, 20};
+    static int32_t shapes[HEAD_COUNT][4];
+
+    kp_inf_float_node_output_t *node_output[HEAD_COUNT];
+    kp_hw_pre_proc_info_t pre_proc_info;
+    post_process_box_transform_t box_transform;
+    kp_yolo_result_t *yolo_result = malloc(sizeof(kp_yolo_result_t));
+    kp_yolo_result_t *full_sort_result = malloc(sizeof(kp_yolo_result_t));
+    post_process_yolo_context_t *context = post_process_yolo_create_context();
+    int mismatch_count = 0;
+
+    if (argc > 1)
+        _loop = atoi(argv[1]);
+
+    if (0 >= _loop)
+    {
+        printf("usage: %s [loop]\n", argv[0]);
+        return -1;
+    }
+
+    if (!yolo_result || !full_sort_result || !context)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return -1;
+    }
+
+    for (int i = 0; i < HEAD_COUNT; i++)
+    {
+        node_output[i] = make_node(grid_sizes[i], shapes[i]);
+        if (NULL == node_output[i])
+        {
+            printf("Error! %s(): out of memory\n", __FUNCTION__);
+            return -1;
+        }
+    }
+
+    memset(&pre_proc_info, 0, sizeof(pre_proc_info));
+    pre_proc_info.img_width = pre_proc_info.resized_img_width = pre_proc_info.model_input_width = MODEL_INPUT_SIZE;
+    pre_proc_info.img_height = pre_proc_info.resized_img_height = pre_proc_info.model_input_height = MODEL_INPUT_SIZE;
+    post_process_box_transform_init(&box_transform, &pre_proc_info);
+
+    printf("YOLO V5 for KL720, 80x80/40x40/20x20 heads, %d classes, %d loops\n\n", CLASS_COUNT, _loop);
+    printf("%9s %11s %7s %11s %17s %17s %9s %10s\n", "threshold", "candidates", "boxes", "frame (ms)", "full sort (ms)", "partial sort (ms)",
+           "speedup", "identical");
+
+    for (size_t t = 0; t < sizeof(_thresholds) / sizeof(_thresholds[0]); t++)
+    {
+        double begin = get_time_ms();
+        for (int i = 0; i < _loop; i++)
+        {
+            if (0 != post_process_yolo_v5_720_with_context(context, node_output, HEAD_COUNT, &pre_proc_info, _thresholds[t], yolo_result))
+            {
+                printf("post_process_yolo_v5_720_with_context() failed\n");
+                return -1;
+            }
+        }
+        double frame_ms = (get_time_ms() - begin) / _loop;
+
+        // the candidates of the last frame stay in the context, after bucketing class_box_offset[i] is the end of class i
+        int candidate_count = context->class_box_offset[CLASS_COUNT - 1];
+        int max_detection = yolo_v5_720_descriptor.max_detection_per_class;
+        int box_count = 0;
+        int full_sort_box_count = 0;
+
+        begin = get_time_ms();
+        for (int i = 0; i < _loop; i++)
+            full_sort_box_count = full_sort_class_bucket_nms(context, CLASS_COUNT, candidate_count, yolo_v5_720_descriptor.nms_thresh, max_detection,
+                                                             &box_transform, full_sort_result);
+        double full_sort_ms = (get_time_ms() - begin) / _loop;
+
+        begin = get_time_ms();
+        for (int i = 0; i < _loop; i++)
+            box_count = yolo_class_bucket_nms(context, CLASS_COUNT, candidate_count, yolo_v5_720_descriptor.nms_thresh, max_detection,
+                                              &box_transform, yolo_result);
+        double partial_sort_ms = (get_time_ms() - begin) / _loop;
+
+        bool identical = (box_count == full_sort_box_count) &&
+                         (0 == memcmp(yolo_result->boxes, full_sort_result->boxes, box_count * sizeof(kp_bounding_box_t)));
+        if (!identical)
+            mismatch_count++;
+
+        printf("%9.2f %11d %7d %11.3f %17.3f %17.3f %8.2fx %10s\n", _thresholds[t], candidate_count, box_count, frame_ms, full_sort_ms,
+               partial_sort_ms, full_sort_ms / partial_sort_ms, identical ? "yes" : "NO");
+    }
+
+    for (int i = 0; i < HEAD_COUNT; i++)
+        free(node_output[i]);
+    post_process_yolo_release_context(context);
+    free(yolo_result);
+    free(full_sort_result);
+
+    if (0 < mismatch_count)
+    {
+        printf("\n%d thresholds differ from sorting all candidates\n", mismatch_count);
+        return -1;
+    }
+
+    return 0;
+}
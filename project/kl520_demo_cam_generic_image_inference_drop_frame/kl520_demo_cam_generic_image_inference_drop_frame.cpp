@@ -19,6 +19,8 @@ extern "C"
 #include "kp_inference.h"
 #include "helper_functions.h"
 #include "postprocess.h"
+#include "image_convert.h"
+#include "motion_gate.h"
 }
 
 #include <opencv2/opencv.hpp>
@@ -33,10 +35,13 @@ static std::mutex _mutex_result;
 static kp_device_group_t _device;
 static kp_model_nef_descriptor_t _model_desc;
 static kp_yolo_result_t _yolo_result_latest = {0};
+static uint32_t _track_ids_latest[YOLO_GOOD_BOX_MAX];   // track ID of each box of _yolo_result_latest
 static kp_generic_image_inference_desc_t _input_data;
 static kp_generic_image_inference_result_header_t _output_desc;
 static int _image_width;
 static int _image_height;
+static bool _host_resize = false;   // letterbox-resize frames on the host, USB carries model-sized images instead of camera frames
+static bool _motion_gate = false;   // skip sending frames of a static scene, the boxes of the last sent frame are kept
 static int _cur_result_index = 0;
 
 void *image_send_function(void *data)
@@ -51,17 +56,14 @@ void *image_send_function(void *data)
     char strModelRes[60];
     char box_info[128];
 
-    // record last result
-    static kp_yolo_result_t _yolo_result_last = {0};
-
-    // record stabilized bounding boxes result
-    static uint32_t box_count_stabilized;
-    static kp_bounding_box_t boxes_stabilized[YOLO_GOOD_BOX_MAX];
-
     cv::Mat _cv_img_cam;
     cv::Mat _cv_img_rgb565;
+    cv::Mat _cv_img_resized;
+    int send_width;
+    int send_height;
     int img_count = 0;
     int result_count = 0;
+    motion_gate_t *gate = NULL;
 
     /* Open camera on index 0 */
     bool opened = _cv_camera_cap.open(0);
@@ -73,7 +75,27 @@ void *image_send_function(void *data)
 
     // to print image and model resolution
     sprintf(strImgRes, "image: %d x %d", _image_width, _image_height);
-    sprintf(strModelRes, "model: %d x %d", _model_desc.models[0].input_nodes[0].tensor_shape_info.tensor_shape_info_data.v1.shape_npu[3], _model_desc.models[0].input_nodes[0].tensor_shape_info.tensor_shape_info_data.v1.shape_npu[2]);
+    int model_width = _model_desc.models[0].input_nodes[0].tensor_shape_info.tensor_shape_info_data.v1.shape_npu[3];
+    int model_height = _model_desc.models[0].input_nodes[0].tensor_shape_info.tensor_shape_info_data.v1.shape_npu[2];
+    sprintf(strModelRes, "model: %d x %d", model_width, model_height);
+
+    /* the device still pads the host-resized image into the model input */
+    send_width = _image_width;
+    send_height = _image_height;
+    if (_host_resize && (0 != image_convert_letterbox_size(_image_width, _image_height, model_width, model_height, KP_PADDING_CORNER,
+                                                           KP_IMAGE_FORMAT_RGB565, &send_width, &send_height)))
+    {
+        _host_resize = false;
+        send_width = _image_width;
+        send_height = _image_height;
+    }
+
+    _cv_img_resized.create(send_height, send_width, CV_8UC3);
+    _cv_img_rgb565.create(send_height, send_width, CV_8UC2);
+
+    /* a frame is sent if more than 0.2% of its cells changed, or after 30 skipped frames */
+    if (_motion_gate)
+        gate = motion_gate_create(send_width, send_height, KP_IMAGE_FORMAT_RGB565, 0.002f, 12, 30);
 
     /******* set up the input descriptor *******/
     _input_data.model_id = _model_desc.models[0].id;    // first model ID
@@ -84,8 +106,8 @@ void *image_send_function(void *data)
     _input_data.input_node_image_list[0].padding_mode = KP_PADDING_CORNER;      // enable corner padding in pre-process
     _input_data.input_node_image_list[0].normalize_mode = KP_NORMALIZE_KNERON;  // this depends on models
     _input_data.input_node_image_list[0].image_format = KP_IMAGE_FORMAT_RGB565; // image format
-    _input_data.input_node_image_list[0].width = _image_width;                  // image width
-    _input_data.input_node_image_list[0].height = _image_height;                // image height
+    _input_data.input_node_image_list[0].width = send_width;                    // image width
+    _input_data.input_node_image_list[0].height = send_height;                  // image height
     _input_data.input_node_image_list[0].crop_count = 0;                        // number of crop area, 0 means no cropping
 
     /* Prepare display window */
@@ -96,45 +118,58 @@ void *image_send_function(void *data)
         /* Get one frame from camera */
         _cv_camera_cap.read(_cv_img_cam);
 
-        cv::cvtColor(_cv_img_cam, _cv_img_rgb565, cv::COLOR_BGR2BGR565); // convert image color fomart to Kneron-specified
+        if (_host_resize)
+        {
+            image_convert_resize_rgb888(_cv_img_cam.data, (int)_cv_img_cam.step, _cv_img_cam.cols, _cv_img_cam.rows, _cv_img_resized.data,
+                                        (int)_cv_img_resized.step, send_width, send_height, IMAGE_CONVERT_RESIZE_AREA, 2);
+            image_convert_from_rgb888(_cv_img_resized.data, (int)_cv_img_resized.step, IMAGE_CONVERT_ORDER_BGR, send_width, send_height,
+                                      KP_IMAGE_FORMAT_RGB565, _cv_img_rgb565.data, 2);
+        }
+        else
+        {
+            cv::cvtColor(_cv_img_cam, _cv_img_rgb565, cv::COLOR_BGR2BGR565); // convert image color fomart to Kneron-specified
+        }
 
-        /* Send buffer to generic inference */
-        _input_data.input_node_image_list[0].image_buffer = (uint8_t *)_cv_img_rgb565.data;    // buffer of image data
-        int ret = kp_generic_image_inference_send(_device, &_input_data);
-        if (ret != KP_SUCCESS)
+        /* Send buffer to generic inference, unless the scene is static and the last result still applies */
+        if ((NULL == gate) || motion_gate_check(gate, _cv_img_rgb565.data))
         {
-            printf("kp_generic_raw_inference_send() error = %d (%s)\n", ret, kp_error_string(ret));
-            break;
+            _input_data.input_node_image_list[0].image_buffer = (uint8_t *)_cv_img_rgb565.data;    // buffer of image data
+            int ret = kp_generic_image_inference_send(_device, &_input_data);
+            if (ret != KP_SUCCESS)
+            {
+                printf("kp_generic_raw_inference_send() error = %d (%s)\n", ret, kp_error_string(ret));
+                break;
+            }
         }
 
         img_count++;
 
         _mutex_result.lock();
 
-        /* This function is optional to avoid box "jumping" */
-        helper_bounding_box_stabilization(_yolo_result_last.box_count, _yolo_result_last.boxes, _yolo_result_latest.box_count, _yolo_result_latest.boxes,
-                                          &box_count_stabilized, boxes_stabilized, 20, 0.3);
-
-        /* Draw all bounding boxes */
-        for (uint32_t i = 0; i < box_count_stabilized; i++)
+        /* Draw all bounding boxes with their track IDs */
+        for (uint32_t i = 0; i < _yolo_result_latest.box_count; i++)
         {
-            int x1 = boxes_stabilized[i].x1;
-            int y1 = boxes_stabilized[i].y1;
-            int x2 = boxes_stabilized[i].x2;
-            int y2 = boxes_stabilized[i].y2;
+            kp_bounding_box_t *box = &_yolo_result_latest.boxes[i];
+
+            if (box->score < 0.3)
+                continue;
+
+            int x1 = box->x1;
+            int y1 = box->y1;
+            int x2 = box->x2;
+            int y2 = box->y2;
 
             int textX = x1;
             int textY = y1 - 10;
             if (textY < 0)
                 textY = y1 + 5;
 
-            sprintf(box_info, "class %d (%.2f)", boxes_stabilized[i].class_num, boxes_stabilized[i].score);
+            sprintf(box_info, "#%u class %d (%.2f)", _track_ids_latest[i], box->class_num, box->score);
 
             cv::rectangle(_cv_img_cam, cv::Point(x1, y1), cv::Point(x2, y2), cv::Scalar(50, 255, 50), 2);
             cv::putText(_cv_img_cam, box_info, cv::Point(textX, textY), cv::FONT_HERSHEY_COMPLEX_SMALL, 1, cv::Scalar(50, 50, 255), 1);
         }
 
-        memcpy((void *)&_yolo_result_last, (void *)&_yolo_result_latest, sizeof(kp_yolo_result_t));
         _mutex_result.unlock();
 
         /* calculate FPS every 60 frames */
@@ -167,6 +202,15 @@ void *image_send_function(void *data)
         }
     }
 
+    if (NULL != gate)
+    {
+        motion_gate_statistics_t statistics;
+        motion_gate_get_statistics(gate, &statistics);
+        printf("motion gate: %u frames, %u sent (%u refreshes), %u skipped\n", statistics.frame_count, statistics.sent_count,
+               statistics.refresh_count, statistics.skipped_count);
+        motion_gate_release(gate);
+    }
+
     _receive_running = false;
 
     return NULL;
@@ -182,6 +226,12 @@ void *result_receive_function(void *data)
     uint32_t raw_buf_size = _model_desc.models[0].max_raw_out_size;
     uint8_t *raw_output_buf = (uint8_t *)malloc(raw_buf_size);
 
+    // post-process working buffers are created once and reused for every frame
+    post_process_yolo_context_t *yolo_context = post_process_yolo_create_context();
+
+    // keeps an identity for each object over the results, a track is dropped after 10 results without its object
+    post_process_tracker_t *tracker = post_process_tracker_create(0.3f, 10);
+
     while (_receive_running)
     {
         /* Receive one result of generic inference */
@@ -198,10 +248,25 @@ void *result_receive_function(void *data)
         output_nodes[0] = kp_generic_inference_retrieve_float_node(0, raw_output_buf, KP_CHANNEL_ORDERING_HCW);
         output_nodes[1] = kp_generic_inference_retrieve_float_node(1, raw_output_buf, KP_CHANNEL_ORDERING_HCW);
 
+        // sigmoid/exp tables are built on the first frame, later frames only check the quantization
+        for (int i = 0; i < 2; i++)
+        {
+            kp_inf_node_view_t node_view;
+            if (KP_SUCCESS == kp_generic_inference_retrieve_node_view(i, raw_output_buf, &node_view))
+                post_process_yolo_set_node_quantization(yolo_context, i, &node_view);
+        }
+
+        // boxes are mapped to the camera frame instead of the host-resized image
+        if (_host_resize)
+            image_convert_restore_pre_proc_info(&_output_desc.pre_proc_info[0], _image_width, _image_height);
+
         _mutex_result.lock();
 
         // post-process yolo v3 output nodes to class/bounding boxes
-        post_process_yolo_v3(output_nodes, _output_desc.num_output_node, &_output_desc.pre_proc_info[0], 0.2, &_yolo_result_latest);
+        post_process_yolo_v3_with_context(yolo_context, output_nodes, _output_desc.num_output_node, &_output_desc.pre_proc_info[0], 0.2, &_yolo_result_latest);
+
+        if (NULL != tracker)
+            post_process_tracker_update(tracker, _yolo_result_latest.boxes, _yolo_result_latest.box_count, _track_ids_latest);
         _mutex_result.unlock();
 
         free(output_nodes[0]);
@@ -210,6 +275,9 @@ void *result_receive_function(void *data)
         ++_cur_result_index;
     }
 
+    post_process_yolo_release_context(yolo_context);
+    post_process_tracker_release(tracker);
+
     return NULL;
 }
 
@@ -219,6 +287,10 @@ int main(int argc, char *argv[])
     int port_id = (argc > 1) ? atoi(argv[1]) : 0;
     int ret;
 
+    // usage: [port_id] [host_resize 0|1], host resize is off by default
+    _host_resize = (argc > 2) && (0 != atoi(argv[2]));
+    printf("host resize ... %s\n", (_host_resize) ? "on" : "off");
+
     /******* reboot the device *******/
     _device = kp_connect_devices(1, &port_id, NULL);
     printf("connect device ... %s\n", (_device) ? "OK" : "failed");
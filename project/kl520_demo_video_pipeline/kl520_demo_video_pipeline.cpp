@@ -0,0 +1,313 @@
+/**
+ * @file        kl520_demo_video_pipeline.cpp
+ * @brief       tiny YOLO v3 on a video file, one frame after another and by the video pipeline, with frames/s and stage occupancy
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C"
+{
+#include "kp_core.h"
+#include "kp_inference.h"
+#include "helper_functions.h"
+#include "postprocess.h"
+#include "image_convert.h"
+#include "video_pipeline.h"
+}
+
+#include <opencv2/opencv.hpp>
+
+static char _scpu_fw_path[128] = "../../res/firmware/KL520/fw_scpu.bin";
+static char _ncpu_fw_path[128] = "../../res/firmware/KL520/fw_ncpu.bin";
+static char _model_file_path[128] = "../../res/models/KL520/tiny_yolo_v3/models_520.nef";
+static char _video_file_path[128] = "../../res/images/MOT16-03_trim.mp4";
+
+static kp_device_group_t _device;
+static kp_model_nef_descriptor_t _model_desc;
+static bool _host_resize = false;   // letterbox-resize frames on the host, USB carries model-sized images instead of video frames
+
+static const char *_stage_names[VIDEO_PIPELINE_STAGE_COUNT] = {"read", "convert", "send", "receive", "post-process"};
+static const char *_queue_names[VIDEO_PIPELINE_QUEUE_COUNT] = {"decoded", "converted", "in flight", "received"};
+
+typedef struct
+{
+    cv::VideoCapture video;
+    cv::Mat frame;
+    post_process_yolo_context_t *yolo_context;
+    kp_yolo_result_t yolo_result;
+    uint32_t box_count;                     // boxes of all frames, the same for both runs
+} video_context_t;
+
+static int read_frame(void *user_data, uint8_t *rgb888, int stride)
+{
+    video_context_t *context = (video_context_t *)user_data;
+
+    if (!context->video.read(context->frame))
+        return 1;
+
+    for (int row = 0; row < context->frame.rows; row++)
+        memcpy(rgb888 + (ptrdiff_t)row * stride, context->frame.ptr(row), context->frame.cols * 3);
+
+    return 0;
+}
+
+static int post_process(void *user_data, uint32_t frame_index, kp_generic_image_inference_result_header_t *output_desc, uint8_t *raw_output_buf)
+{
+    video_context_t *context = (video_context_t *)user_data;
+    // tiny yolo v3 outputs only two nodes
+    kp_inf_float_node_output_t *output_nodes[2] = {NULL};
+    int ret = -1;
+
+    output_nodes[0] = kp_generic_inference_retrieve_float_node(0, raw_output_buf, KP_CHANNEL_ORDERING_HCW);
+    output_nodes[1] = kp_generic_inference_retrieve_float_node(1, raw_output_buf, KP_CHANNEL_ORDERING_HCW);
+
+    if ((NULL != output_nodes[0]) && (NULL != output_nodes[1]))
+    {
+        // sigmoid/exp tables are built on the first frame, later frames only check the quantization
+        for (int i = 0; i < 2; i++)
+        {
+            kp_inf_node_view_t node_view;
+            if (KP_SUCCESS == kp_generic_inference_retrieve_node_view(i, raw_output_buf, &node_view))
+                post_process_yolo_set_node_quantization(context->yolo_context, i, &node_view);
+        }
+
+        ret = post_process_yolo_v3_with_context(context->yolo_context, output_nodes, output_desc->num_output_node, &output_desc->pre_proc_info[0],
+                                                0.2, &context->yolo_result);
+        context->box_count += context->yolo_result.box_count;
+    }
+
+    free(output_nodes[0]);
+    free(output_nodes[1]);
+
+    return ret;
+}
+
+/* the loop of the demos: read, convert, send, receive and post-process one frame after another in one thread */
+static int run_sequential(video_context_t *context, int model_width, int model_height, uint32_t raw_buf_size, double *fps)
+{
+    int frame_width = (int)context->video.get(cv::CAP_PROP_FRAME_WIDTH);
+    int frame_height = (int)context->video.get(cv::CAP_PROP_FRAME_HEIGHT);
+    int send_width = frame_width;
+    int send_height = frame_height;
+    int frame_count = 0;
+    int ret = 0;
+    double time_spent;
+    kp_generic_image_inference_desc_t input_data;
+    kp_generic_image_inference_result_header_t output_desc;
+
+    if (_host_resize)
+        image_convert_letterbox_size(frame_width, frame_height, model_width, model_height, KP_PADDING_CORNER, KP_IMAGE_FORMAT_RGB565,
+                                     &send_width, &send_height);
+
+    cv::Mat resized(send_height, send_width, CV_8UC3);
+    cv::Mat rgb565(send_height, send_width, CV_8UC2);
+    uint8_t *raw_output_buf = (uint8_t *)malloc(raw_buf_size);
+
+    if (NULL == raw_output_buf)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return -1;
+    }
+
+    memset(&input_data, 0, sizeof(input_data));
+    input_data.model_id = _model_desc.models[0].id;
+    input_data.num_input_node_image = 1;
+    input_data.input_node_image_list[0].resize_mode = KP_RESIZE_ENABLE;
+    input_data.input_node_image_list[0].padding_mode = KP_PADDING_CORNER;
+    input_data.input_node_image_list[0].normalize_mode = KP_NORMALIZE_KNERON;
+    input_data.input_node_image_list[0].image_format = KP_IMAGE_FORMAT_RGB565;
+    input_data.input_node_image_list[0].width = send_width;
+    input_data.input_node_image_list[0].height = send_height;
+    input_data.input_node_image_list[0].image_buffer = rgb565.data;
+
+    helper_measure_time_begin();
+
+    while (context->video.read(context->frame))
+    {
+        if (_host_resize)
+        {
+            image_convert_resize_rgb888(context->frame.data, (int)context->frame.step, frame_width, frame_height, resized.data, (int)resized.step,
+                                        send_width, send_height, IMAGE_CONVERT_RESIZE_AREA, 2);
+            image_convert_from_rgb888(resized.data, (int)resized.step, IMAGE_CONVERT_ORDER_BGR, send_width, send_height, KP_IMAGE_FORMAT_RGB565,
+                                      rgb565.data, 2);
+        }
+        else
+        {
+            image_convert_from_rgb888(context->frame.data, (int)context->frame.step, IMAGE_CONVERT_ORDER_BGR, send_width, send_height,
+                                      KP_IMAGE_FORMAT_RGB565, rgb565.data, 2);
+        }
+
+        input_data.inference_number = frame_count;
+
+        ret = kp_generic_image_inference_send(_device, &input_data);
+        if (KP_SUCCESS != ret)
+        {
+            printf("kp_generic_image_inference_send() error = %d (%s)\n", ret, kp_error_string(ret));
+            break;
+        }
+
+        ret = kp_generic_image_inference_receive(_device, &output_desc, raw_output_buf, raw_buf_size);
+        if (KP_SUCCESS != ret)
+        {
+            printf("kp_generic_image_inference_receive() error = %d (%s)\n", ret, kp_error_string(ret));
+            break;
+        }
+
+        // boxes are mapped to the video frame instead of the host-resized image
+        if (_host_resize)
+            image_convert_restore_pre_proc_info(&output_desc.pre_proc_info[0], frame_width, frame_height);
+
+        ret = post_process(context, frame_count, &output_desc, raw_output_buf);
+        if (0 != ret)
+            break;
+
+        frame_count++;
+    }
+
+    helper_measure_time_end(&time_spent);
+    *fps = (0 < time_spent) ? frame_count / time_spent : 0;
+
+    printf("sequential: %d frames, %.1f fps\n", frame_count, *fps);
+
+    free(raw_output_buf);
+
+    return ret;
+}
+
+static int run_pipeline(video_context_t *context, int model_width, int model_height, uint32_t raw_buf_size, double sequential_fps)
+{
+    video_pipeline_config_t config;
+    video_pipeline_statistics_t statistics;
+
+    memset(&config, 0, sizeof(config));
+    config.frame_width = (int)context->video.get(cv::CAP_PROP_FRAME_WIDTH);
+    config.frame_height = (int)context->video.get(cv::CAP_PROP_FRAME_HEIGHT);
+    config.frame_order = IMAGE_CONVERT_ORDER_BGR;
+    config.model_id = _model_desc.models[0].id;
+    config.model_width = model_width;
+    config.model_height = model_height;
+    config.image_format = KP_IMAGE_FORMAT_RGB565;
+    config.normalize_mode = KP_NORMALIZE_KNERON;
+    config.padding_mode = KP_PADDING_CORNER;
+    config.host_resize = _host_resize;
+    config.convert_thread_count = 2;
+    config.frame_slot_count = 4;
+    config.raw_slot_count = 4;
+    config.max_in_flight = 2;
+    config.raw_buf_size = raw_buf_size;
+    config.read_frame = read_frame;
+    config.post_process = post_process;
+    config.user_data = context;
+
+    video_pipeline_t *pipeline = video_pipeline_create(_device, &config);
+    if (NULL == pipeline)
+    {
+        printf("video_pipeline_create() failed\n");
+        return -1;
+    }
+
+    int ret = video_pipeline_run(pipeline, &statistics);
+    video_pipeline_release(pipeline);
+
+    if (0 != ret)
+    {
+        printf("video_pipeline_run() error = %d\n", ret);
+        return ret;
+    }
+
+    printf("pipeline: %u frames, %.1f fps (%.2fx)\n", statistics.frame_count, statistics.fps,
+           (0 < sequential_fps) ? statistics.fps / sequential_fps : 0);
+
+    printf("  stage busy:");
+    for (int i = 0; i < VIDEO_PIPELINE_STAGE_COUNT; i++)
+        printf(" %s %.0f%%%s", _stage_names[i], 100 * statistics.stage_busy[i], (i + 1 < VIDEO_PIPELINE_STAGE_COUNT) ? "," : "\n");
+
+    printf("  ring occupancy:");
+    for (int i = 0; i < VIDEO_PIPELINE_QUEUE_COUNT; i++)
+        printf(" %s %.0f%%%s", _queue_names[i], 100 * statistics.queue_occupancy[i], (i + 1 < VIDEO_PIPELINE_QUEUE_COUNT) ? "," : "\n");
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // each device has a unique port ID, 0 for auto-search
+    int port_id = (argc > 1) ? atoi(argv[1]) : 0;
+    int ret;
+    video_context_t context;
+    double sequential_fps = 0;
+    uint32_t sequential_box_count = 0;
+
+    // usage: [port_id] [host_resize 0|1] [video file], host resize is off by default
+    _host_resize = (argc > 2) && (0 != atoi(argv[2]));
+    printf("host resize ... %s\n", (_host_resize) ? "on" : "off");
+
+    if (argc > 3)
+        snprintf(_video_file_path, sizeof(_video_file_path), "%s", argv[3]);
+
+    /******* reboot the device *******/
+    _device = kp_connect_devices(1, &port_id, NULL);
+    printf("connect device ... %s\n", (_device) ? "OK" : "failed");
+    if (!_device)
+        return -1;
+
+    kp_set_timeout(_device, 5000); // 5 secs timeout
+
+    /******* upload firmware to device *******/
+    ret = kp_load_firmware_from_file(_device, _scpu_fw_path, _ncpu_fw_path);
+    printf("upload firmware ... %s\n", (ret == KP_SUCCESS) ? "OK" : "failed");
+
+    /******* upload model to device *******/
+    ret = kp_load_model_from_file(_device, _model_file_path, &_model_desc);
+    printf("upload model ... %s\n", (ret == KP_SUCCESS) ? "OK" : "failed");
+    if (KP_SUCCESS != ret)
+    {
+        kp_disconnect_devices(_device);
+        return -1;
+    }
+
+    // every frame is inferred, frames are not dropped
+    int model_width = _model_desc.models[0].input_nodes[0].tensor_shape_info.tensor_shape_info_data.v1.shape_npu[3];
+    int model_height = _model_desc.models[0].input_nodes[0].tensor_shape_info.tensor_shape_info_data.v1.shape_npu[2];
+    uint32_t raw_buf_size = _model_desc.models[0].max_raw_out_size;
+
+    context.yolo_context = post_process_yolo_create_context();
+    context.box_count = 0;
+
+    bool opened = (NULL != context.yolo_context) && context.video.open(_video_file_path);
+    printf("open video %s ... %s\n\n", _video_file_path, (opened) ? "OK" : "failed");
+
+    if (opened)
+    {
+        ret = run_sequential(&context, model_width, model_height, raw_buf_size, &sequential_fps);
+        context.video.release();
+        sequential_box_count = context.box_count;
+        context.box_count = 0;
+
+        if ((0 == ret) && context.video.open(_video_file_path))
+        {
+            ret = run_pipeline(&context, model_width, model_height, raw_buf_size, sequential_fps);
+            context.video.release();
+
+            // both runs infer every frame, so they find the same boxes
+            if (0 == ret)
+                printf("\nboxes: sequential %u, pipeline %u\n", sequential_box_count, context.box_count);
+        }
+    }
+
+    post_process_yolo_release_context(context.yolo_context);
+
+    printf("\ndisconnecting device ...\n");
+
+    kp_release_model_nef_descriptor(&_model_desc);
+    kp_disconnect_devices(_device);
+
+    return 0;
+}
@@ -0,0 +1,339 @@
+/**
+ * @file        test_classification_top_k.c
+ * @brief       check of the top-k classification post-processing against softmax and sorting of the dequantized logits, with timing
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "postprocess.h"
+
+#define MAX_TOP_K 10
+#define BATCH_SIZE 4
+#define TIMING_LOOP 200
+#define PROBABILITY_TOLERANCE 1e-5f
+
+static const int _class_counts[] = {1, 2, 5, 10, 100, 1000, 21843};
+static const int _top_ks[] = {1, 5, MAX_TOP_K};
+
+static uint32_t _random_state = 0xa0761d65;
+
+static int _failure_count = 0;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static uint32_t random_next()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return _random_state;
+}
+
+/*
+ * int8/int16 logits node as kp_generic_inference_retrieve_fixed_node() gives it, with one quantization for the node or one for each class.
+ * 'value_range' limits the values, a small range gives many equal logits.
+ */
+static kp_inf_fixed_node_output_t *make_node(int class_count, uint32_t fixed_point_dtype, bool per_channel, int value_range)
+{
+    size_t data_size = (size_t)class_count * ((KP_FIXED_POINT_DTYPE_INT8 == fixed_point_dtype) ? 1 : 2);
+    int descriptor_count = per_channel ? class_count : 1;
+    kp_inf_fixed_node_output_t *node = calloc(1, sizeof(kp_inf_fixed_node_output_t) + data_size);
+    kp_quantized_fixed_point_descriptor_t *descriptors = calloc(descriptor_count, sizeof(kp_quantized_fixed_point_descriptor_t));
+
+    if ((NULL == node) || (NULL == descriptors))
+    {
+        free(node);
+        free(descriptors);
+        return NULL;
+    }
+
+    node->name = "";
+    node->fixed_point_dtype = fixed_point_dtype;
+    node->num_data = class_count;
+    node->quantization_parameters.quantization_parameters_data.v1.quantized_fixed_point_descriptor_num = descriptor_count;
+    node->quantization_parameters.quantization_parameters_data.v1.quantized_fixed_point_descriptor = descriptors;
+
+    for (int i = 0; i < descriptor_count; i++)
+    {
+        descriptors[i].radix = (KP_FIXED_POINT_DTYPE_INT8 == fixed_point_dtype) ? 4 : 11;
+        descriptors[i].scale_dtype = KP_DTYPE_FLOAT32;
+        descriptors[i].scale.scale_float32 = per_channel ? 0.5f + (float)(random_next() % 1000) / 1000.0f : 0.8f;
+        if (per_channel)
+            descriptors[i].radix -= (int32_t)(random_next() % 3);
+    }
+
+    for (int i = 0; i < class_count; i++)
+    {
+        int value = (int)(random_next() % (2 * value_range + 1)) - value_range;
+
+        if (KP_FIXED_POINT_DTYPE_INT8 == fixed_point_dtype)
+            node->data.int8[i] = (int8_t)value;
+        else
+            node->data.int16[i] = (int16_t)value;
+    }
+
+    return node;
+}
+
+static void free_node(kp_inf_fixed_node_output_t *node)
+{
+    if (NULL != node)
+        free(node->quantization_parameters.quantization_parameters_data.v1.quantized_fixed_point_descriptor);
+    free(node);
+}
+
+static int reference_comparator(const void *result_1, const void *result_2)
+{
+    const kp_classification_result_t *a = (const kp_classification_result_t *)result_1;
+    const kp_classification_result_t *b = (const kp_classification_result_t *)result_2;
+
+    if (a->score != b->score)
+        return (a->score > b->score) ? -1 : 1;
+
+    return a->class_num - b->class_num;
+}
+
+/*
+ * what users did before: dequantize the whole node as kp_generic_inference_retrieve_float_node() does, softmax over every class
+ * and sort, equal probabilities rank in class order. 'results' holds all classes.
+ */
+static void reference_top_k(kp_inf_fixed_node_output_t *node, kp_classification_result_t *results)
+{
+    kp_quantization_parameters_v1_t *quantization_parameters = &node->quantization_parameters.quantization_parameters_data.v1;
+    int class_count = node->num_data;
+    float max_logit = -INFINITY;
+    double exp_sum = 0;
+
+    for (int i = 0; i < class_count; i++)
+    {
+        kp_quantized_fixed_point_descriptor_t *descriptor =
+            &quantization_parameters->quantized_fixed_point_descriptor[(1 == quantization_parameters->quantized_fixed_point_descriptor_num) ? 0 : i];
+        float value = (KP_FIXED_POINT_DTYPE_INT8 == node->fixed_point_dtype) ? node->data.int8[i] : node->data.int16[i];
+
+        results[i].class_num = i;
+        results[i].score = value / (descriptor->scale.scale_float32 * ldexpf(1.0f, descriptor->radix));
+        if (results[i].score > max_logit)
+            max_logit = results[i].score;
+    }
+
+    for (int i = 0; i < class_count; i++)
+        exp_sum += exp((double)results[i].score - max_logit);
+
+    for (int i = 0; i < class_count; i++)
+        results[i].score = (float)(exp((double)results[i].score - max_logit) / exp_sum);
+
+    qsort(results, class_count, sizeof(kp_classification_result_t), reference_comparator);
+}
+
+/* the classes must be those of the reference in its order, probabilities agree up to float rounding */
+static void check_results(const char *test, kp_classification_result_t *results, int result_count, kp_classification_result_t *expected,
+                          int expected_count)
+{
+    if (result_count != expected_count)
+    {
+        printf("FAIL %s: %d results, expected %d\n", test, result_count, expected_count);
+        _failure_count++;
+        return;
+    }
+
+    for (int i = 0; i < expected_count; i++)
+    {
+        if ((results[i].class_num != expected[i].class_num) ||
+            (fabsf(results[i].score - expected[i].score) > PROBABILITY_TOLERANCE * expected[i].score))
+        {
+            printf("FAIL %s: result %d is class %d probability %.8f, the reference gives class %d probability %.8f\n", test, i,
+                   results[i].class_num, results[i].score, expected[i].class_num, expected[i].score);
+            _failure_count++;
+            return;
+        }
+    }
+}
+
+static int test_node(int class_count, uint32_t fixed_point_dtype, bool per_channel, int value_range)
+{
+    kp_inf_fixed_node_output_t *node = make_node(class_count, fixed_point_dtype, per_channel, value_range);
+    kp_classification_result_t *expected = malloc(class_count * sizeof(kp_classification_result_t));
+    kp_classification_result_t results[MAX_TOP_K];
+    char test[128];
+
+    if ((NULL == node) || (NULL == expected))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        free_node(node);
+        free(expected);
+        return -1;
+    }
+
+    reference_top_k(node, expected);
+
+    for (size_t k = 0; k < sizeof(_top_ks) / sizeof(_top_ks[0]); k++)
+    {
+        int top_k = _top_ks[k];
+        int result_count = 0;
+
+        snprintf(test, sizeof(test), "%d classes %s%s range %d top %d", class_count,
+                 (KP_FIXED_POINT_DTYPE_INT8 == fixed_point_dtype) ? "int8" : "int16", per_channel ? " per-channel" : "", value_range, top_k);
+
+        if (0 != post_process_classification_top_k(node, top_k, results, &result_count))
+        {
+            printf("FAIL %s: post_process_classification_top_k() failed\n", test);
+            _failure_count++;
+            continue;
+        }
+
+        check_results(test, results, result_count, expected, (top_k < class_count) ? top_k : class_count);
+    }
+
+    free_node(node);
+    free(expected);
+
+    return 0;
+}
+
+/* crops of a batch are the same as one call for each crop, a bad crop fails only its own results */
+static int test_batch()
+{
+    kp_inf_fixed_node_output_t *nodes[BATCH_SIZE];
+    kp_classification_result_t results[BATCH_SIZE * MAX_TOP_K];
+    kp_classification_result_t expected[MAX_TOP_K];
+    int result_counts[BATCH_SIZE];
+    int ret = 0;
+
+    for (int i = 0; i < BATCH_SIZE; i++)
+        nodes[i] = make_node(1000, (0 == i % 2) ? KP_FIXED_POINT_DTYPE_INT8 : KP_FIXED_POINT_DTYPE_INT16, (3 == i), 100 + 1000 * (i % 2));
+
+    for (int i = 0; i < BATCH_SIZE; i++)
+    {
+        if (NULL == nodes[i])
+        {
+            printf("Error! %s(): out of memory\n", __FUNCTION__);
+            ret = -1;
+            goto FUNC_OUT;
+        }
+    }
+
+    if (0 != post_process_classification_top_k_batch(nodes, BATCH_SIZE, MAX_TOP_K, results, result_counts))
+    {
+        printf("FAIL batch: post_process_classification_top_k_batch() failed\n");
+        _failure_count++;
+        goto FUNC_OUT;
+    }
+
+    for (int i = 0; i < BATCH_SIZE; i++)
+    {
+        int expected_count = 0;
+
+        post_process_classification_top_k(nodes[i], MAX_TOP_K, expected, &expected_count);
+        if ((result_counts[i] != expected_count) || (0 != memcmp(&results[i * MAX_TOP_K], expected, expected_count * sizeof(kp_classification_result_t))))
+        {
+            printf("FAIL batch: crop %d differs from post_process_classification_top_k()\n", i);
+            _failure_count++;
+        }
+    }
+
+    // a crop with an unknown data type
+    nodes[1]->fixed_point_dtype = 0xFF;
+    if ((0 == post_process_classification_top_k_batch(nodes, BATCH_SIZE, MAX_TOP_K, results, result_counts)) ||
+        (0 != result_counts[1]) || (MAX_TOP_K != result_counts[0]) || (MAX_TOP_K != result_counts[2]))
+    {
+        printf("FAIL batch: a bad crop is not reported by its own result count\n");
+        _failure_count++;
+    }
+
+FUNC_OUT:
+    for (int i = 0; i < BATCH_SIZE; i++)
+        free_node(nodes[i]);
+
+    return ret;
+}
+
+static int print_timing(int class_count, uint32_t fixed_point_dtype, bool per_channel)
+{
+    kp_inf_fixed_node_output_t *node = make_node(class_count, fixed_point_dtype, per_channel, 100);
+    kp_classification_result_t *expected = malloc(class_count * sizeof(kp_classification_result_t));
+    kp_classification_result_t results[5];
+    int result_count = 0;
+
+    if ((NULL == node) || (NULL == expected))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        free_node(node);
+        free(expected);
+        return -1;
+    }
+
+    double begin = get_time_ms();
+    for (int i = 0; i < TIMING_LOOP; i++)
+        reference_top_k(node, expected);
+    double reference_ms = (get_time_ms() - begin) / TIMING_LOOP;
+
+    begin = get_time_ms();
+    for (int i = 0; i < TIMING_LOOP; i++)
+        post_process_classification_top_k(node, 5, results, &result_count);
+    double top_k_ms = (get_time_ms() - begin) / TIMING_LOOP;
+
+    printf("%6d classes %-5s %-11s top 5: reference %.4f ms, top-k %.4f ms, %.1fx\n", class_count,
+           (KP_FIXED_POINT_DTYPE_INT8 == fixed_point_dtype) ? "int8" : "int16", per_channel ? "per-channel" : "per-tensor",
+           reference_ms, top_k_ms, reference_ms / top_k_ms);
+
+    free_node(node);
+    free(expected);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int test_count = 0;
+
+    for (size_t c = 0; c < sizeof(_class_counts) / sizeof(_class_counts[0]); c++)
+    {
+        for (int dtype = 0; dtype < 2; dtype++)
+        {
+            uint32_t fixed_point_dtype = (0 == dtype) ? KP_FIXED_POINT_DTYPE_INT8 : KP_FIXED_POINT_DTYPE_INT16;
+            int max_value = (0 == dtype) ? 127 : 32767;
+
+            for (int per_channel = 0; per_channel < 2; per_channel++)
+            {
+                // full range, and a small range with many equal logits
+                if ((0 != test_node(_class_counts[c], fixed_point_dtype, per_channel, max_value)) ||
+                    (0 != test_node(_class_counts[c], fixed_point_dtype, per_channel, 3)))
+                    return -1;
+
+                test_count += 2;
+            }
+        }
+    }
+
+    if (0 != test_batch())
+        return -1;
+
+    if (0 < _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("%d logits nodes and a batch match the float reference\n\n", test_count);
+
+    if ((0 != print_timing(1000, KP_FIXED_POINT_DTYPE_INT8, false)) || (0 != print_timing(1000, KP_FIXED_POINT_DTYPE_INT16, false)) ||
+        (0 != print_timing(1000, KP_FIXED_POINT_DTYPE_INT8, true)) || (0 != print_timing(21843, KP_FIXED_POINT_DTYPE_INT8, false)))
+        return -1;
+
+    return 0;
+}
@@ -0,0 +1,324 @@
+/**
+ * @file        test_float_node_list.c
+ * @brief       check of the floating-point node arena against per-node retrieval of synthetic RAW output buffers
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kp_inference.h"
+#include "raw_output_builder.h"
+
+#define MAX_NODE_COUNT 4
+#define ARENA_ALIGNMENT 16
+
+/*
+ * allocations are counted by wrapping the glibc allocator, kplus allocates with malloc()/calloc()/realloc()
+ * (elsewhere the count is not checked)
+ */
+#ifdef __GLIBC__
+#define COUNT_ALLOCATIONS
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static int _allocation_count = 0;
+
+void *malloc(size_t size)
+{
+    _allocation_count++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    _allocation_count++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    _allocation_count++;
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+typedef struct
+{
+    const char *name;
+    uint32_t product_id;
+    uint32_t node_count;
+    raw_output_node_spec_t node_specs[MAX_NODE_COUNT];
+} test_case_t;
+
+static const test_case_t _test_cases[] = {
+    {"KL520", KP_DEVICE_KL520, 3, {
+        {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, 4, {1, 20, 5, 19}},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, 4, {1, 3, 7, 33}},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, 4, {1, 35, 2, 1}}}},
+    {"KL720", KP_DEVICE_KL720, 3, {
+        {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, 4, {1, 20, 5, 19}},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, 4, {1, 35, 7, 3}},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, 4, {1, 3, 2, 13}}}},
+    {"KL630", KP_DEVICE_KL630, 3, {
+        {KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, 4, {1, 5, 6, 7}},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, 4, {1, 17, 3, 3}},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, 4, {1, 1, 1, 85}}}},
+    {"KL730", KP_DEVICE_KL730, 4, {
+        {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL, 4, {1, 20, 5, 19}, 1, true},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, 4, {1, 3, 7, 33}, 1, false},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, 3, {24, 6, 10}, 0, true, KP_DTYPE_INT8, KP_DTYPE_UINT16},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B, 2, {1, 1000}, 1, false}}},
+    {"KL830", KP_DEVICE_KL830, 2, {
+        {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL, 4, {1, 9, 4, 4}, 1, true},
+        {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, 4, {1, 33, 2, 2}, 1, false}}},
+};
+
+static int _failure_count = 0;
+
+static void report_failure(const char *test, const char *what)
+{
+    printf("FAIL %s: %s\n", test, what);
+    _failure_count++;
+}
+
+static bool is_version_2(uint32_t product_id)
+{
+    return (KP_DEVICE_KL730 == product_id) || (KP_DEVICE_KL830 == product_id);
+}
+
+/* output nodes of the model descriptor, as kp_load_model() gives them for the model of the RAW output */
+static void make_model_descriptor(const test_case_t *test_case, kp_tensor_descriptor_t *output_nodes, char names[][32], kp_single_model_descriptor_t *single_model_desc)
+{
+    memset(single_model_desc, 0, sizeof(kp_single_model_descriptor_t));
+    memset(output_nodes, 0, MAX_NODE_COUNT * sizeof(kp_tensor_descriptor_t));
+
+    single_model_desc->output_nodes_num = test_case->node_count;
+    single_model_desc->output_nodes = output_nodes;
+
+    for (uint32_t i = 0; i < test_case->node_count; i++)
+    {
+        const raw_output_node_spec_t *node_spec = &test_case->node_specs[i];
+
+        output_nodes[i].index = i;
+        output_nodes[i].data_layout = node_spec->data_layout;
+
+        if (is_version_2(test_case->product_id))
+        {
+            /* node names are in the RAW output of KL730/KL830 */
+            snprintf(names[i], 32, "output_node_%u", i);
+            output_nodes[i].name = names[i];
+            output_nodes[i].tensor_shape_info.version = KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2;
+            output_nodes[i].tensor_shape_info.tensor_shape_info_data.v2.shape_len = node_spec->shape_len;
+            output_nodes[i].tensor_shape_info.tensor_shape_info_data.v2.shape = (int32_t *)node_spec->shape;
+        }
+        else
+        {
+            output_nodes[i].name = "";
+            output_nodes[i].tensor_shape_info.version = KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1;
+            output_nodes[i].tensor_shape_info.tensor_shape_info_data.v1.shape_npu_len = node_spec->shape_len;
+            output_nodes[i].tensor_shape_info.tensor_shape_info_data.v1.shape_npu = (int32_t *)node_spec->shape;
+        }
+    }
+}
+
+/* every node of the arena should be the same as kp_generic_inference_retrieve_float_node() gives it */
+static void check_node_list(const char *test, uint8_t *raw_out_buffer, kp_channel_ordering_t ordering, kp_inf_float_node_output_list_t *list,
+                            uint32_t node_count, uint8_t *arena_base)
+{
+    if (node_count != list->num_output_node)
+    {
+        report_failure(test, "num_output_node differs");
+        return;
+    }
+
+    for (uint32_t node_idx = 0; node_idx < node_count; node_idx++)
+    {
+        kp_inf_float_node_output_t *node = list->node_output[node_idx];
+        kp_inf_float_node_output_t *float_node = kp_generic_inference_retrieve_float_node(node_idx, raw_out_buffer, ordering);
+
+        if (NULL == float_node)
+        {
+            report_failure(test, "kp_generic_inference_retrieve_float_node() failed");
+            return;
+        }
+
+        if (((uint8_t *)node < arena_base) || ((uint8_t *)node->data + node->num_data * sizeof(float) > arena_base + list->arena_size) ||
+            ((uint8_t *)node->shape < arena_base) || ((uint8_t *)node->name + strlen(node->name) + 1 > arena_base + list->arena_size))
+            report_failure(test, "node is not inside the arena");
+        else if (0 != ((uintptr_t)node->data & (ARENA_ALIGNMENT - 1)))
+            report_failure(test, "node data is not aligned to 16 bytes");
+        else if ((float_node->num_data != node->num_data) ||
+                 (float_node->shape_len != node->shape_len) ||
+                 (0 != memcmp(float_node->shape, node->shape, node->shape_len * sizeof(int32_t))) ||
+                 (0 != strcmp(float_node->name, node->name)))
+            report_failure(test, "node metadata differs from kp_generic_inference_retrieve_float_node()");
+        else if (0 != memcmp(float_node->data, node->data, node->num_data * sizeof(float)))
+            report_failure(test, "node data differs from kp_generic_inference_retrieve_float_node()");
+
+        kp_release_float_node_output(float_node);
+    }
+}
+
+static void run_test_case(const test_case_t *test_case, kp_channel_ordering_t ordering, const char *ordering_name)
+{
+    kp_tensor_descriptor_t output_nodes[MAX_NODE_COUNT];
+    char names[MAX_NODE_COUNT][32];
+    kp_single_model_descriptor_t single_model_desc;
+    kp_inf_float_node_output_list_t *list = NULL;
+    uint8_t *raw_out_buffer = NULL;
+    void *arena = NULL;
+    uint32_t arena_size = 0;
+    uint32_t needed_size = 0;
+    int allocation_count = 0;
+    char test[64];
+    int ret = 0;
+
+    snprintf(test, sizeof(test), "%s %s", test_case->name, ordering_name);
+
+    raw_out_buffer = raw_output_build(test_case->product_id, test_case->node_specs, test_case->node_count, 1, NULL, NULL);
+    if (NULL == raw_out_buffer)
+    {
+        report_failure(test, "raw_output_build() failed");
+        return;
+    }
+
+    /* internally allocated arena: exactly one allocation, released by kp_release_float_node_output_list() */
+#ifdef COUNT_ALLOCATIONS
+    allocation_count = _allocation_count;
+#endif
+    ret = kp_generic_inference_retrieve_float_node_list(raw_out_buffer, ordering, NULL, NULL, 0, &list);
+#ifdef COUNT_ALLOCATIONS
+    allocation_count = _allocation_count - allocation_count;
+#endif
+
+    if ((KP_SUCCESS != ret) || (NULL == list))
+    {
+        report_failure(test, "kp_generic_inference_retrieve_float_node_list() failed");
+        goto OUT;
+    }
+
+#ifdef COUNT_ALLOCATIONS
+    if (1 != allocation_count)
+        report_failure(test, "internally allocated arena needs more than one allocation");
+#endif
+
+    if (NULL == list->allocated_buffer)
+        report_failure(test, "allocated_buffer of internally allocated arena is NULL");
+
+    needed_size = list->arena_size;
+    check_node_list(test, raw_out_buffer, ordering, list, test_case->node_count, (uint8_t *)list);
+    kp_release_float_node_output_list(list);
+    list = NULL;
+
+    /* the size from the model descriptor is the size the RAW output needs */
+    make_model_descriptor(test_case, output_nodes, names, &single_model_desc);
+
+    if ((KP_SUCCESS != kp_generic_inference_get_float_node_list_size(&single_model_desc, &arena_size)) || (needed_size != arena_size))
+    {
+        printf("FAIL %s: kp_generic_inference_get_float_node_list_size() gives %u bytes, %u bytes are needed\n", test, arena_size, needed_size);
+        _failure_count++;
+        goto OUT;
+    }
+
+    /* user-provided arena: no allocation, the list is at the beginning of the arena */
+    if (0 != posix_memalign(&arena, ARENA_ALIGNMENT, arena_size))
+    {
+        report_failure(test, "out of memory");
+        goto OUT;
+    }
+
+    memset(arena, 0xa5, arena_size);
+
+#ifdef COUNT_ALLOCATIONS
+    allocation_count = _allocation_count;
+#endif
+    ret = kp_generic_inference_retrieve_float_node_list(raw_out_buffer, ordering, NULL, arena, arena_size, &list);
+#ifdef COUNT_ALLOCATIONS
+    allocation_count = _allocation_count - allocation_count;
+#endif
+
+    if ((KP_SUCCESS != ret) || (NULL == list))
+    {
+        report_failure(test, "kp_generic_inference_retrieve_float_node_list() with arena failed");
+        goto OUT;
+    }
+
+#ifdef COUNT_ALLOCATIONS
+    if (0 != allocation_count)
+        report_failure(test, "user-provided arena still allocates");
+#endif
+
+    if (((void *)list != arena) || (NULL != list->allocated_buffer) || (arena_size != list->arena_size))
+        report_failure(test, "list is not at the beginning of the user-provided arena");
+
+    check_node_list(test, raw_out_buffer, ordering, list, test_case->node_count, (uint8_t *)arena);
+    kp_release_float_node_output_list(list);
+    list = NULL;
+
+    /* one byte short is rejected, and nothing is given back */
+    list = (kp_inf_float_node_output_list_t *)raw_out_buffer;
+    if ((KP_ERROR_INVALID_PARAM_12 != kp_generic_inference_retrieve_float_node_list(raw_out_buffer, ordering, NULL, arena, arena_size - 1, &list)) || (NULL != list))
+        report_failure(test, "undersized arena is not rejected");
+
+    /* an arena off the 16 bytes alignment is rejected */
+    list = NULL;
+    if (KP_ERROR_INVALID_PARAM_12 != kp_generic_inference_retrieve_float_node_list(raw_out_buffer, ordering, NULL, (uint8_t *)arena + 4, arena_size - 4, &list))
+        report_failure(test, "misaligned arena is not rejected");
+    list = NULL;
+
+OUT:
+    if (NULL != list)
+        kp_release_float_node_output_list(list);
+    free(arena);
+    free(raw_out_buffer);
+}
+
+int main(int argc, char *argv[])
+{
+    int test_count = sizeof(_test_cases) / sizeof(_test_cases[0]);
+    kp_single_model_descriptor_t single_model_desc;
+    uint32_t arena_size = 0;
+
+    for (int i = 0; i < test_count; i++)
+    {
+        if (is_version_2(_test_cases[i].product_id))
+        {
+            run_test_case(&_test_cases[i], KP_CHANNEL_ORDERING_DEFAULT, "DEFAULT");
+        }
+        else
+        {
+            run_test_case(&_test_cases[i], KP_CHANNEL_ORDERING_DEFAULT, "DEFAULT");
+            run_test_case(&_test_cases[i], KP_CHANNEL_ORDERING_CHW, "CHW");
+            run_test_case(&_test_cases[i], KP_CHANNEL_ORDERING_HCW, "HCW");
+            run_test_case(&_test_cases[i], KP_CHANNEL_ORDERING_HWC, "HWC");
+        }
+    }
+
+    /* an unknown shape version cannot be sized */
+    kp_tensor_descriptor_t output_node;
+    memset(&output_node, 0, sizeof(output_node));
+    memset(&single_model_desc, 0, sizeof(single_model_desc));
+    single_model_desc.output_nodes_num = 1;
+    single_model_desc.output_nodes = &output_node;
+
+    if (KP_SUCCESS == kp_generic_inference_get_float_node_list_size(&single_model_desc, &arena_size))
+        report_failure("shape version", "unknown tensor shape version is sized");
+
+    if (0 != _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("%d RAW output buffers: float node arenas match kp_generic_inference_retrieve_float_node()\n", test_count);
+
+    return 0;
+}
@@ -0,0 +1,395 @@
+/**
+ * @file        test_image_cache.c
+ * @brief       check of image_cache: BMP header validation, converted pixels, LRU eviction order and raw image files
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "image_cache.h"
+
+#define FILE_COUNT 10
+
+static char _paths[FILE_COUNT][64];
+static int _failure_count = 0;
+
+#define CHECK(condition, ...)                                   \
+    do                                                          \
+    {                                                           \
+        if (!(condition))                                       \
+        {                                                       \
+            printf("FAIL line %d: ", __LINE__);                 \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            _failure_count++;                                   \
+        }                                                       \
+    } while (0)
+
+/* header fields of a test BMP, a valid 24-bit BMP unless changed */
+typedef struct
+{
+    char magic[2];
+    int32_t width;
+    int32_t height;
+    uint16_t bit_count;
+    uint32_t offset;
+    long cut_bytes;                     // bytes taken off the end of the file
+} bmp_header_t;
+
+static void put_le(uint8_t *p, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        p[i] = (uint8_t)(value >> (8 * i));
+}
+
+/* B, G and R of the pixel at (x, y) from the top of the image */
+static uint8_t pixel_value(int x, int y, int channel)
+{
+    return (uint8_t)(x * 40 + y * 70 + channel * 85 + 3);
+}
+
+static void valid_header(bmp_header_t *header, int width, int height)
+{
+    memset(header, 0, sizeof(bmp_header_t));
+    header->magic[0] = 'B';
+    header->magic[1] = 'M';
+    header->width = width;
+    header->height = height;
+    header->bit_count = 24;
+    header->offset = 54;
+}
+
+/* a BMP file of the header, with pixel data of the header size when it is valid, bottom-up for a positive height */
+static int write_bmp(const char *path, const bmp_header_t *header)
+{
+    int width = header->width;
+    bool size_valid = (0 < width) && (32768 >= width) && (0 != header->height) && (-32768 <= header->height) && (32768 >= header->height);
+    int height = !size_valid ? 0 : ((0 > header->height) ? -header->height : header->height);
+    int stride = size_valid ? (width * 3 + 3) & ~3 : 0;
+    long pixel_size = (long)stride * (size_valid ? height : 0);
+    long data_offset = (header->offset < 54) ? 54 : ((header->offset > 1024) ? 54 : header->offset);
+    long file_size = data_offset + pixel_size - header->cut_bytes;
+    uint8_t *file = calloc(1, data_offset + pixel_size);
+    FILE *fp;
+
+    if (NULL == file)
+        return -1;
+
+    file[0] = header->magic[0];
+    file[1] = header->magic[1];
+    put_le(file + 2, (uint32_t)file_size, 4);
+    put_le(file + 10, header->offset, 4);
+    put_le(file + 14, 40, 4);
+    put_le(file + 18, (uint32_t)header->width, 4);
+    put_le(file + 22, (uint32_t)header->height, 4);
+    put_le(file + 26, 1, 2);
+    put_le(file + 28, header->bit_count, 2);
+
+    for (int row = 0; row < height; row++)
+    {
+        // rows of a positive height are stored from the bottom
+        int y = (0 < header->height) ? height - 1 - row : row;
+        uint8_t *p = file + data_offset + (long)row * stride;
+
+        for (int x = 0; x < width; x++)
+        {
+            for (int channel = 0; channel < 3; channel++)
+                p[x * 3 + channel] = pixel_value(x, y, channel);
+        }
+    }
+
+    fp = fopen(path, "wb");
+    if ((NULL == fp) || (1 != fwrite(file, file_size, 1, fp)))
+    {
+        if (NULL != fp)
+            fclose(fp);
+        free(file);
+        return -1;
+    }
+
+    fclose(fp);
+    free(file);
+
+    return 0;
+}
+
+static void check_statistics(image_cache_t *cache, uint32_t hit_count, uint32_t miss_count, size_t cached_bytes, const char *step)
+{
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    size_t bytes = 0;
+
+    image_cache_get_statistics(cache, &hits, &misses, &bytes);
+    CHECK((hit_count == hits) && (miss_count == misses) && (cached_bytes == bytes), "%s: %u hits, %u misses, %zu bytes, expected %u, %u, %zu",
+          step, hits, misses, bytes, hit_count, miss_count, cached_bytes);
+}
+
+/* bottom-up and top-down BMPs with padded rows convert to the same pixels, read back from RGBA8888 */
+static void test_bmp_pixels()
+{
+    bmp_header_t header;
+    image_cache_image_t image;
+    image_cache_t *cache = image_cache_create(1 << 20);
+
+    for (int top_down = 0; top_down <= 1; top_down++)
+    {
+        valid_header(&header, 5, top_down ? -3 : 3);
+        write_bmp(_paths[0], &header);
+
+        if ((NULL == cache) || (0 != image_cache_get_bmp(cache, _paths[0], KP_IMAGE_FORMAT_RGBA8888, &image)))
+        {
+            printf("FAIL %s 5 x 3 BMP is not loaded\n", top_down ? "top-down" : "bottom-up");
+            _failure_count++;
+            continue;
+        }
+
+        CHECK((5 == image.width) && (3 == image.height) && (5 * 3 * 4 == image.size) && (KP_IMAGE_FORMAT_RGBA8888 == image.format),
+              "%s BMP is %d x %d", top_down ? "top-down" : "bottom-up", image.width, image.height);
+
+        for (int y = 0; y < 3; y++)
+        {
+            for (int x = 0; x < 5; x++)
+            {
+                const uint8_t *rgba = image.buffer + (y * 5 + x) * 4;
+
+                CHECK((pixel_value(x, y, 2) == rgba[0]) && (pixel_value(x, y, 1) == rgba[1]) && (pixel_value(x, y, 0) == rgba[2]),
+                      "%s BMP pixel (%d, %d)", top_down ? "top-down" : "bottom-up", x, y);
+            }
+        }
+
+        // the file is written again with other rows, a new cache loads it
+        image_cache_release(cache);
+        cache = image_cache_create(1 << 20);
+    }
+
+    image_cache_release(cache);
+}
+
+/* files with a header not of a supported 24-bit BMP or without the pixel data of the header size are rejected */
+static void test_bmp_headers()
+{
+    static const struct
+    {
+        const char *name;
+        int width;
+        int height;
+        bool accepted;
+    } sizes[] = {
+        {"width 0", 0, 4, false},
+        {"negative width", -4, 4, false},
+        {"width 32769", 32769, 1, false},
+        {"height 0", 4, 0, false},
+        {"height INT_MIN", 4, INT_MIN, false},
+        {"height 32769", 1, 32769, false},
+        {"height -32769", 1, -32769, false},
+        {"width 32768", 32768, 1, true},
+        {"height -32768", 1, -32768, true},
+    };
+    bmp_header_t header;
+    image_cache_image_t image;
+    image_cache_t *cache = image_cache_create(1 << 20);
+    uint32_t miss_count = 0;
+    size_t cached_bytes = 0;
+    FILE *fp;
+
+    if (NULL == cache)
+    {
+        printf("FAIL image_cache_create() failed\n");
+        _failure_count++;
+        return;
+    }
+
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+        // a path per size, an accepted file stays cached
+        valid_header(&header, sizes[i].width, sizes[i].height);
+        write_bmp(_paths[i % FILE_COUNT], &header);
+
+        CHECK(sizes[i].accepted == (0 == image_cache_get_bmp(cache, _paths[i % FILE_COUNT], KP_IMAGE_FORMAT_RAW8, &image)), "BMP of %s", sizes[i].name);
+
+        if (sizes[i].accepted)
+        {
+            miss_count++;
+            cached_bytes += image.size;
+        }
+
+        remove(_paths[i % FILE_COUNT]);
+    }
+
+    valid_header(&header, 4, 4);
+    header.magic[1] = 'A';
+    write_bmp(_paths[0], &header);
+    CHECK(0 != image_cache_get_bmp(cache, _paths[0], KP_IMAGE_FORMAT_RAW8, &image), "BMP of magic BA");
+
+    valid_header(&header, 4, 4);
+    header.bit_count = 32;
+    write_bmp(_paths[0], &header);
+    CHECK(0 != image_cache_get_bmp(cache, _paths[0], KP_IMAGE_FORMAT_RAW8, &image), "32-bit BMP");
+
+    valid_header(&header, 4, 4);
+    header.cut_bytes = 1;
+    write_bmp(_paths[0], &header);
+    CHECK(0 != image_cache_get_bmp(cache, _paths[0], KP_IMAGE_FORMAT_RAW8, &image), "BMP without the last pixel byte");
+
+    valid_header(&header, 4, 4);
+    header.offset = 0xFFFFFFF0;
+    write_bmp(_paths[0], &header);
+    CHECK(0 != image_cache_get_bmp(cache, _paths[0], KP_IMAGE_FORMAT_RAW8, &image), "BMP of pixel data offset 0xFFFFFFF0");
+
+    // a file shorter than the headers
+    fp = fopen(_paths[0], "wb");
+    if (NULL != fp)
+    {
+        fwrite("BM", 2, 1, fp);
+        fclose(fp);
+    }
+    CHECK(0 != image_cache_get_bmp(cache, _paths[0], KP_IMAGE_FORMAT_RAW8, &image), "BMP of 2 bytes");
+
+    remove(_paths[0]);
+    CHECK(0 != image_cache_get_bmp(cache, _paths[0], KP_IMAGE_FORMAT_RAW8, &image), "missing BMP");
+
+    // a rejected file is neither counted nor cached
+    check_statistics(cache, 0, miss_count, cached_bytes, "after rejected BMPs");
+
+    image_cache_release(cache);
+}
+
+static void get_bmp(image_cache_t *cache, int file, kp_image_format_t format, const char *step)
+{
+    image_cache_image_t image;
+
+    CHECK(0 == image_cache_get_bmp(cache, _paths[file], format, &image), "%s: image %d is not loaded", step, file);
+}
+
+/* the least recently used images are evicted beyond the max bytes, a get makes an image the most recently used */
+static void test_lru()
+{
+    bmp_header_t header;
+    image_cache_t *cache = image_cache_create(300);     // three 10 x 10 RAW8 images
+
+    if (NULL == cache)
+    {
+        printf("FAIL image_cache_create() failed\n");
+        _failure_count++;
+        return;
+    }
+
+    // files 0..3 are 10 x 10, file 4 is 20 x 20
+    for (int i = 0; i < 5; i++)
+    {
+        valid_header(&header, (4 == i) ? 20 : 10, (4 == i) ? 20 : 10);
+        write_bmp(_paths[i], &header);
+    }
+
+    get_bmp(cache, 0, KP_IMAGE_FORMAT_RAW8, "load 0");
+    get_bmp(cache, 1, KP_IMAGE_FORMAT_RAW8, "load 1");
+    get_bmp(cache, 2, KP_IMAGE_FORMAT_RAW8, "load 2");
+    check_statistics(cache, 0, 3, 300, "0, 1, 2 loaded");
+
+    // 0 is used again, 1 is the least recently used and goes for 3
+    get_bmp(cache, 0, KP_IMAGE_FORMAT_RAW8, "get 0");
+    get_bmp(cache, 3, KP_IMAGE_FORMAT_RAW8, "load 3");
+    check_statistics(cache, 1, 4, 300, "3 loaded");
+
+    // from the least recently used: 2, 0, 3, all hits
+    get_bmp(cache, 2, KP_IMAGE_FORMAT_RAW8, "get 2");
+    get_bmp(cache, 0, KP_IMAGE_FORMAT_RAW8, "get 0");
+    get_bmp(cache, 3, KP_IMAGE_FORMAT_RAW8, "get 3");
+    check_statistics(cache, 4, 4, 300, "2, 0, 3 used");
+
+    // 1 is loaded again for 2, then 0 and 3 are used: 1, 0, 3
+    get_bmp(cache, 1, KP_IMAGE_FORMAT_RAW8, "load 1 again");
+    get_bmp(cache, 0, KP_IMAGE_FORMAT_RAW8, "get 0");
+    get_bmp(cache, 3, KP_IMAGE_FORMAT_RAW8, "get 3");
+    check_statistics(cache, 6, 5, 300, "1 loaded again");
+
+    // 2 is loaded again for 1: 0, 3, 2
+    get_bmp(cache, 2, KP_IMAGE_FORMAT_RAW8, "load 2 again");
+    check_statistics(cache, 6, 6, 300, "2 loaded again");
+
+    // another format of a path is another image: 200 bytes of RGB565 evict 0 and 3, the least recently used
+    get_bmp(cache, 3, KP_IMAGE_FORMAT_RGB565, "load 3 RGB565");
+    check_statistics(cache, 6, 7, 300, "3 RGB565 loaded");
+    get_bmp(cache, 2, KP_IMAGE_FORMAT_RAW8, "get 2");
+    get_bmp(cache, 3, KP_IMAGE_FORMAT_RGB565, "get 3 RGB565");
+    check_statistics(cache, 8, 7, 300, "2 and 3 RGB565 used");
+    get_bmp(cache, 3, KP_IMAGE_FORMAT_RAW8, "load 3 again");
+    check_statistics(cache, 8, 8, 300, "3 loaded again");
+
+    // an image larger than the max bytes evicts all others and is kept while it is the image returned last
+    get_bmp(cache, 4, KP_IMAGE_FORMAT_RAW8, "load 4");
+    check_statistics(cache, 8, 9, 400, "4 loaded");
+    get_bmp(cache, 4, KP_IMAGE_FORMAT_RAW8, "get 4");
+    check_statistics(cache, 9, 9, 400, "4 used");
+    get_bmp(cache, 0, KP_IMAGE_FORMAT_RAW8, "load 0 again");
+    check_statistics(cache, 9, 10, 100, "0 loaded again");
+
+    for (int i = 0; i < 5; i++)
+        remove(_paths[i]);
+
+    image_cache_release(cache);
+}
+
+/* a raw image file is the image buffer itself, a file not of the image size is rejected */
+static void test_raw()
+{
+    uint8_t data[8 * 4 * 2];
+    image_cache_image_t image;
+    image_cache_t *cache = image_cache_create(1 << 20);
+    FILE *fp = fopen(_paths[0], "wb");
+
+    for (int i = 0; i < (int)sizeof(data); i++)
+        data[i] = (uint8_t)(i * 13);
+
+    if ((NULL == cache) || (NULL == fp))
+    {
+        printf("FAIL raw image file can not be written\n");
+        _failure_count++;
+        if (NULL != fp)
+            fclose(fp);
+        image_cache_release(cache);
+        return;
+    }
+
+    fwrite(data, sizeof(data), 1, fp);
+    fclose(fp);
+
+    CHECK((0 == image_cache_get_raw(cache, _paths[0], 8, 4, KP_IMAGE_FORMAT_RGB565, &image)) && (sizeof(data) == (size_t)image.size) &&
+          (0 == memcmp(data, image.buffer, sizeof(data))), "8 x 4 RGB565 raw file");
+    CHECK(0 == image_cache_get_raw(cache, _paths[0], 8, 4, KP_IMAGE_FORMAT_RGB565, &image), "8 x 4 RGB565 raw file again");
+    CHECK(0 != image_cache_get_raw(cache, _paths[0], 8, 4, KP_IMAGE_FORMAT_RGBA8888, &image), "8 x 4 RGBA8888 of a RGB565 raw file");
+    CHECK(0 != image_cache_get_raw(cache, _paths[0], 7, 4, KP_IMAGE_FORMAT_RGB565, &image), "7 x 4 RGB565 of a 8 x 4 raw file");
+    check_statistics(cache, 1, 1, sizeof(data), "raw file");
+
+    remove(_paths[0]);
+    image_cache_release(cache);
+}
+
+int main(int argc, char *argv[])
+{
+    for (int i = 0; i < FILE_COUNT; i++)
+        snprintf(_paths[i], sizeof(_paths[i]), "/tmp/test_image_cache_%d_%d", (int)getpid(), i);
+
+    test_bmp_pixels();
+    test_bmp_headers();
+    test_lru();
+    test_raw();
+
+    if (0 < _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("image_cache: BMP headers, pixels, LRU eviction order and raw files are right\n");
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file        image_convert_scalar.c
+ * @brief       scalar build of image_convert.c with renamed functions, the reference of the vector code
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#ifndef EX_COMMON_NO_SIMD
+#define EX_COMMON_NO_SIMD
+#endif
+
+#define image_convert_buffer_size scalar_image_convert_buffer_size
+#define image_convert_from_rgb888 scalar_image_convert_from_rgb888
+#define image_convert_to_rgb888 scalar_image_convert_to_rgb888
+#define image_convert_letterbox_size scalar_image_convert_letterbox_size
+#define image_convert_resize_rgb888 scalar_image_convert_resize_rgb888
+#define image_convert_restore_pre_proc_info scalar_image_convert_restore_pre_proc_info
+#define image_convert_crop_pack_size scalar_image_convert_crop_pack_size
+#define image_convert_pack_crops scalar_image_convert_pack_crops
+#define image_convert_restore_crop_pre_proc_info scalar_image_convert_restore_crop_pre_proc_info
+
+#include "../../ex_common/image_convert.c"
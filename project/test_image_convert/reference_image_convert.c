@@ -0,0 +1,531 @@
+/**
+ * @file        reference_image_convert.c
+ * @brief       frozen copy of the image conversion loops of helper_functions.c before image_convert.c, the reference of test_image_convert
+ *
+ * The loops are copied unchanged from helper_bmp_file_to_raw_buffer() and convert_bin_to_bmp_pixel_data() of the baseline
+ * helper_functions.c, with the file reading and the buffer allocation taken out. One line differs: the second Y of the lower row
+ * of a YUV420 pixel pair is y[1][1], the former code wrote y[1][0] again (fixed by image_convert.c).
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "reference_image_convert.h"
+
+static void generate_ycbcr_to_ycbcr_order_mapping(kp_image_format_t in_format, kp_image_format_t out_format, int order_mapping[])
+{
+    // initialize
+    int y0_index = 0;
+    int cb_index = 0;
+    int y1_index = 0;
+    int cr_index = 0;
+
+    switch (in_format)
+    {
+        case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
+            cr_index = 0;
+            y1_index = 1;
+            cb_index = 2;
+            y0_index = 3;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
+            cb_index = 0;
+            y1_index = 1;
+            cr_index = 2;
+            y0_index = 3;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
+            y1_index = 0;
+            cr_index = 1;
+            y0_index = 2;
+            cb_index = 3;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
+            y1_index = 0;
+            cb_index = 1;
+            y0_index = 2;
+            cr_index = 3;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
+            cr_index = 0;
+            y0_index = 1;
+            cb_index = 2;
+            y1_index = 3;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
+            cb_index = 0;
+            y0_index = 1;
+            cr_index = 2;
+            y1_index = 3;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
+            y0_index = 0;
+            cr_index = 1;
+            y1_index = 2;
+            cb_index = 3;
+            break;
+        case KP_IMAGE_FORMAT_YUYV:
+        case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
+            y0_index = 0;
+            cb_index = 1;
+            y1_index = 2;
+            cr_index = 3;
+            break;
+        default:
+            printf("input format is not supported\n");
+            break;
+    }
+
+    switch (out_format)
+    {
+        case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
+            order_mapping[0] = cr_index;
+            order_mapping[1] = y1_index;
+            order_mapping[2] = cb_index;
+            order_mapping[3] = y0_index;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
+            order_mapping[0] = cb_index;
+            order_mapping[1] = y1_index;
+            order_mapping[2] = cr_index;
+            order_mapping[3] = y0_index;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
+            order_mapping[0] = y1_index;
+            order_mapping[1] = cr_index;
+            order_mapping[2] = y0_index;
+            order_mapping[3] = cb_index;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
+            order_mapping[0] = y1_index;
+            order_mapping[1] = cb_index;
+            order_mapping[2] = y0_index;
+            order_mapping[3] = cr_index;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
+            order_mapping[0] = cr_index;
+            order_mapping[1] = y0_index;
+            order_mapping[2] = cb_index;
+            order_mapping[3] = y1_index;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
+            order_mapping[0] = cb_index;
+            order_mapping[1] = y0_index;
+            order_mapping[2] = cr_index;
+            order_mapping[3] = y1_index;
+            break;
+        case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
+            order_mapping[0] = y0_index;
+            order_mapping[1] = cr_index;
+            order_mapping[2] = y1_index;
+            order_mapping[3] = cb_index;
+            break;
+        case KP_IMAGE_FORMAT_YUYV:
+        case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
+            order_mapping[0] = y0_index;
+            order_mapping[1] = cb_index;
+            order_mapping[2] = y1_index;
+            order_mapping[3] = cr_index;
+            break;
+        default:
+            printf("output format is not supported\n");
+            break;
+    }
+}
+
+int reference_bmp_pixel_data_to_raw(const unsigned char *bmp_buf, int width, int height, kp_image_format_t format, unsigned char *raw_buf)
+{
+    unsigned short *b16_buf = NULL;
+    unsigned char *b8_buf = NULL;
+
+    // length of bmp image width in byte should be aligned with 4
+    int padding_byte_num = 0;
+    if (width * 3 % 4 != 0)
+        padding_byte_num = 4 - width * 3 % 4;
+
+    switch (format)
+    {
+    case KP_IMAGE_FORMAT_RGB565:
+    {
+        b16_buf = (unsigned short *)raw_buf;
+        int rgb565_pos = 0;
+
+        for (int row = height - 1; row >= 0; row--)
+        {
+            int bmp_pos = (width * 3 + padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+            for (int col = 0; col < width; col++)
+            {
+                unsigned char blue = bmp_buf[bmp_pos];
+                unsigned char green = bmp_buf[bmp_pos + 1];
+                unsigned char red = bmp_buf[bmp_pos + 2];
+
+                b16_buf[rgb565_pos] = ((red & 0b11111000) << 8) | ((green & 0b11111100) << 3) | (blue >> 3);
+
+                bmp_pos += 3;
+                rgb565_pos++;
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_RGBA8888:
+    {
+        b8_buf = raw_buf;
+        int rgba8888_pos = 0;
+
+        for (int row = height - 1; row >= 0; row--)
+        {
+            int bmp_pos = (width * 3 + padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+            for (int col = 0; col < width; col++)
+            {
+                unsigned char blue = bmp_buf[bmp_pos];
+                unsigned char green = bmp_buf[bmp_pos + 1];
+                unsigned char red = bmp_buf[bmp_pos + 2];
+
+                b8_buf[rgba8888_pos++] = red;
+                b8_buf[rgba8888_pos++] = green;
+                b8_buf[rgba8888_pos++] = blue;
+                b8_buf[rgba8888_pos++] = 0;
+
+                bmp_pos += 3;
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_YUYV:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
+    {
+        b8_buf = raw_buf;
+        int write_pos = 0;
+
+        // generate the order mappings of (y0, cb, y1, cr) to (cr, y1, cb, y0), (cb, y1, cr, y0), ... described in the yuyv or ycbcr image format
+        int order_mapping[4] = {0};
+        generate_ycbcr_to_ycbcr_order_mapping(KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR, format, order_mapping);
+
+        for (int row = height - 1; row >= 0; row--)
+        {
+            int bmp_pos = (width * 3 + padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+
+            // FIXME? How if the width is an odd number?
+            for (int col = 0; col < width / 2; col++)
+            {
+                unsigned char blue0 = bmp_buf[bmp_pos];
+                unsigned char green0 = bmp_buf[bmp_pos + 1];
+                unsigned char red0 = bmp_buf[bmp_pos + 2];
+
+                unsigned char blue1 = bmp_buf[bmp_pos + 3];
+                unsigned char green1 = bmp_buf[bmp_pos + 4];
+                unsigned char red1 = bmp_buf[bmp_pos + 5];
+
+                // FIXME: use integer method to speed up
+                float output[4];
+                output[0] = 0.299 * red0 + 0.587 * green0 + 0.114 * blue0; // y0
+                output[1] = -0.169 * (red0 + red1) / 2 - 0.331 * (green0 + green1) / 2 + 0.5 * (blue0 + blue1) / 2 + 128; // cb
+                output[2] = 0.299 * red1 + 0.587 * green1 + 0.114 * blue1; // y1
+                output[3] = 0.5 * (red0 + red1) / 2 - 0.419 * (green0 + green1) / 2 - 0.081 * (blue0 + blue1) / 2 + 128;  // cr
+
+                b8_buf[write_pos++] = (unsigned char)output[order_mapping[0]];
+                b8_buf[write_pos++] = (unsigned char)output[order_mapping[1]];
+                b8_buf[write_pos++] = (unsigned char)output[order_mapping[2]];
+                b8_buf[write_pos++] = (unsigned char)output[order_mapping[3]];
+
+                bmp_pos += 6;
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_YUV420:
+    {
+        if ((0 != width % 2) || (0 != height % 2)) {
+            printf("Error! width or height is not even number\n");
+            return -1;
+        }
+
+        b8_buf = raw_buf;
+
+        int y_bias = width * height;
+        int u_bias = y_bias / 4;
+        int u_pos = y_bias;
+        int v_pos = y_bias + u_bias;
+
+        for (int row = height - 1; row >= 0; row -= 2)
+        {
+            int bmp_pos_row_0 = (width * 3 + padding_byte_num) * row;       // we only support bmp file with 3 bytes per pixel
+            int bmp_pos_row_1 = (width * 3 + padding_byte_num) * (row - 1); // we only support bmp file with 3 bytes per pixel
+            int y_write_pos_row_0 = width * (height - row - 1);
+            int y_write_pos_row_1 = width * (height - row);
+
+            for (int col = 0; col < width; col += 2)
+            {
+                unsigned char blue0 = bmp_buf[bmp_pos_row_0];
+                unsigned char green0 = bmp_buf[bmp_pos_row_0 + 1];
+                unsigned char red0 = bmp_buf[bmp_pos_row_0 + 2];
+
+                unsigned char blue1 = bmp_buf[bmp_pos_row_0 + 3];
+                unsigned char green1 = bmp_buf[bmp_pos_row_0 + 4];
+                unsigned char red1 = bmp_buf[bmp_pos_row_0 + 5];
+
+                unsigned char blue2 = bmp_buf[bmp_pos_row_1];
+                unsigned char green2 = bmp_buf[bmp_pos_row_1 + 1];
+                unsigned char red2 = bmp_buf[bmp_pos_row_1 + 2];
+
+                unsigned char blue3 = bmp_buf[bmp_pos_row_1 + 3];
+                unsigned char green3 = bmp_buf[bmp_pos_row_1 + 4];
+                unsigned char red3 = bmp_buf[bmp_pos_row_1 + 5];
+
+                float y[2][2];
+                float u, v;
+
+                y[0][0] = 0.299 * red0 + 0.587 * green0 + 0.114 * blue0;
+                y[0][1] = 0.299 * red1 + 0.587 * green1 + 0.114 * blue1;
+                y[1][0] = 0.299 * red2 + 0.587 * green2 + 0.114 * blue2;
+                y[1][1] = 0.299 * red3 + 0.587 * green3 + 0.114 * blue3;
+
+                u = -0.169 * (red0 + red1 + red2 + red3) / 4 - 0.331 * (green0 + green1 + green2 + green3) / 4 + 0.5 * (blue0 + blue1 + blue2 + blue3) / 4 + 128;
+                v = 0.5 * (red0 + red1 + red2 + red3) / 4 - 0.419 * (green0 + green1 + green2 + green3) / 4 - 0.081 * (blue0 + blue1 + blue2 + blue3) / 4 + 128;
+
+                b8_buf[y_write_pos_row_0++] = (unsigned char)y[0][0];
+                b8_buf[y_write_pos_row_0++] = (unsigned char)y[0][1];
+                b8_buf[y_write_pos_row_1++] = (unsigned char)y[1][0];
+                b8_buf[y_write_pos_row_1++] = (unsigned char)y[1][1]; // the former code wrote y[1][0] again
+                b8_buf[u_pos++] = (unsigned char)u;
+                b8_buf[v_pos++] = (unsigned char)v;
+
+                bmp_pos_row_0 += 6;
+                bmp_pos_row_1 += 6;
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_RAW8:
+    {
+        b8_buf = raw_buf;
+        int gray_pos = 0;
+
+        for (int row = height - 1; row >= 0; row--)
+        {
+            int bmp_pos = (width * 3 + padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+            for (int col = 0; col < width; col++)
+            {
+                unsigned char blue = bmp_buf[bmp_pos];
+                unsigned char green = bmp_buf[bmp_pos + 1];
+                unsigned char red = bmp_buf[bmp_pos + 2];
+
+                b8_buf[gray_pos++] = (0.3 * red) + (0.59 * green) + (0.11 * blue);
+
+                bmp_pos += 3;
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_UNKNOWN:
+    default:
+        printf("image format is not supported\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static unsigned char clamp_to_0_255(float num)
+{
+    if (num > 255)
+        return 255;
+    else if (num < 0)
+        return 0;
+    else
+        return (unsigned char)num;
+}
+
+// Passing bmp_padding_byte_num to avoid recalculation
+// bmp_buf is used to store pixel data of bmp image
+void reference_raw_to_bmp_pixel_data(unsigned char *bin_buf, unsigned char *bmp_buf, int width, int height, kp_image_format_t bin_format, int bmp_padding_byte_num)
+{
+    switch (bin_format)
+    {
+    case KP_IMAGE_FORMAT_RGB565:
+    {
+        unsigned short *rgb565_buf = (unsigned short *)bin_buf;
+
+        int rgb565_pos = 0;
+
+        for (int row = height - 1; row >= 0; row--)
+        {
+            int bmp_pos = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+            for (int col = 0; col < width; col++)
+            {
+                bmp_buf[bmp_pos] = (rgb565_buf[rgb565_pos] << 3) & 0b11111000;     // blue
+                bmp_buf[bmp_pos + 1] = (rgb565_buf[rgb565_pos] >> 3) & 0b11111100; // green
+                bmp_buf[bmp_pos + 2] = (rgb565_buf[rgb565_pos] >> 8) & 0b11111000; // red
+
+                bmp_pos += 3;
+                rgb565_pos++;
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_RGBA8888:
+    {
+        // Just an alias for buffer naming consistency
+        unsigned char *rgba8888_buf = bin_buf;
+
+        int rgba8888_pos = 0;
+
+        for (int row = height - 1; row >= 0; row--)
+        {
+            int bmp_pos = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+            for (int col = 0; col < width; col++)
+            {
+                bmp_buf[bmp_pos] = rgba8888_buf[rgba8888_pos + 2];     // blue
+                bmp_buf[bmp_pos + 1] = rgba8888_buf[rgba8888_pos + 1]; // green
+                bmp_buf[bmp_pos + 2] = rgba8888_buf[rgba8888_pos];     // red
+
+                bmp_pos += 3;
+                rgba8888_pos += 4;
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_YUYV:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR:
+    case KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1:
+    case KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB:
+    case KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR:
+    {
+        // Just an alias for buffer naming consistency
+        unsigned char *ycbcr_buf = bin_buf;
+
+        int ycbcr_pos = 0;
+
+        // generate the order mappings of (cr, y1, cb, y0), (cb, y1, cr, y0) to (y0, cb, y1, cr)... described in the yuyv or ycbcr image format
+        int order_mapping[4] = {0};
+        generate_ycbcr_to_ycbcr_order_mapping(bin_format, KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR, order_mapping);
+
+        for (int row = height - 1; row >= 0; row--)
+        {
+            int bmp_pos = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+
+            // FIXME: How if the width is an odd number?
+            for (int col = 0; col < width / 2; col++)
+            {
+                unsigned char output[4];
+                output[0] = ycbcr_buf[ycbcr_pos++]; // one of (y0, cb, y1, cr)
+                output[1] = ycbcr_buf[ycbcr_pos++]; // one of (y0, cb, y1, cr)
+                output[2] = ycbcr_buf[ycbcr_pos++]; // one of (y0, cb, y1, cr)
+                output[3] = ycbcr_buf[ycbcr_pos++]; // one of (y0, cb, y1, cr)
+
+                unsigned char y0 = output[order_mapping[0]];
+                unsigned char cb = output[order_mapping[1]];
+                unsigned char y1 = output[order_mapping[2]];
+                unsigned char cr = output[order_mapping[3]];
+
+                // FIXME: use integer method to speed up
+                float b_diff = 1.77 * (cb - 128);
+                float g_diff = -0.343 * (cb - 128) - 0.714 * (cr - 128);
+                float r_diff = 1.403 * (cr - 128);
+
+                bmp_buf[bmp_pos++] = clamp_to_0_255(y0 + b_diff);
+                bmp_buf[bmp_pos++] = clamp_to_0_255(y0 + g_diff);
+                bmp_buf[bmp_pos++] = clamp_to_0_255(y0 + r_diff);
+                bmp_buf[bmp_pos++] = clamp_to_0_255(y1 + b_diff);
+                bmp_buf[bmp_pos++] = clamp_to_0_255(y1 + g_diff);
+                bmp_buf[bmp_pos++] = clamp_to_0_255(y1 + r_diff);
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_RAW8:
+    {
+        // Just an alias for buffer naming consistency
+        unsigned char *raw8_buf = bin_buf;
+
+        int raw8_pos = 0;
+
+        for (int row = height - 1; row >= 0; row--)
+        {
+            int bmp_pos = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+            for (int col = 0; col < width; col++)
+            {
+                memset(bmp_buf + bmp_pos, raw8_buf[raw8_pos++], 3);
+                bmp_pos += 3;
+            }
+        }
+        break;
+    }
+    case KP_IMAGE_FORMAT_YUV420:
+    {
+        if ((0 != width % 2) || (0 != height % 2)) {
+            printf("Error! width or height is not even number\n");
+            return;
+        }
+
+        // Just an alias for buffer naming consistency
+        unsigned char *yuv_buf = bin_buf;
+        int y_bias = width * height;
+        int u_bias = y_bias / 4;
+        int u_pos = y_bias;
+        int v_pos = y_bias + u_bias;
+
+        for (int row = height - 1; row >= 0; row -= 2)
+        {
+            int bmp_pos_row_0 = (width * 3 + bmp_padding_byte_num) * row; // we only support bmp file with 3 bytes per pixel
+            int bmp_pos_row_1 = (width * 3 + bmp_padding_byte_num) * (row - 1); // we only support bmp file with 3 bytes per pixel
+            int y_pos_row_0 = width * (height - row - 1);
+            int y_pos_row_1 = width * (height - row);
+
+            for (int col = 0; col < width; col += 2)
+            {
+                unsigned char y[2][2];
+                unsigned char u, v;
+
+                y[0][0] = yuv_buf[y_pos_row_0++];
+                y[0][1] = yuv_buf[y_pos_row_0++];
+                y[1][0] = yuv_buf[y_pos_row_1++];
+                y[1][1] = yuv_buf[y_pos_row_1++];
+
+                u = yuv_buf[u_pos++];
+                v = yuv_buf[v_pos++];
+
+                // FIXME: use integer method to speed up
+                float b_diff = 1.77 * (u - 128);
+                float g_diff = -0.343 * (u - 128) - 0.714 * (v - 128);
+                float r_diff = 1.403 * (v - 128);
+
+                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][0] + b_diff);
+                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][0] + g_diff);
+                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][0] + r_diff);
+                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][1] + b_diff);
+                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][1] + g_diff);
+                bmp_buf[bmp_pos_row_0++] = clamp_to_0_255(y[0][1] + r_diff);
+
+                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][0] + b_diff);
+                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][0] + g_diff);
+                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][0] + r_diff);
+                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][1] + b_diff);
+                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][1] + g_diff);
+                bmp_buf[bmp_pos_row_1++] = clamp_to_0_255(y[1][1] + r_diff);
+            }
+        }
+        break;
+    }
+    default:
+    case KP_IMAGE_FORMAT_UNKNOWN:
+        printf("image format is not supported\n");
+        return;
+    }
+}
@@ -0,0 +1,25 @@
+/**
+ * @file        reference_image_convert.h
+ * @brief       frozen copy of the image conversion loops of helper_functions.c before image_convert.c
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include "kp_struct.h"
+
+/**
+ * @brief Former conversion of 24-bit BMP pixel data (bottom-up BGR rows padded to 4 bytes) to a raw image format.
+ *
+ * @return 0 if converted, -1 if the format or the size is not supported.
+ */
+int reference_bmp_pixel_data_to_raw(const unsigned char *bmp_buf, int width, int height, kp_image_format_t format, unsigned char *raw_buf);
+
+/**
+ * @brief Former conversion of a raw image format to 24-bit BMP pixel data, the padding bytes of each row are not written.
+ */
+void reference_raw_to_bmp_pixel_data(unsigned char *bin_buf, unsigned char *bmp_buf, int width, int height, kp_image_format_t bin_format,
+                                     int bmp_padding_byte_num);
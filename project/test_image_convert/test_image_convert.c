@@ -0,0 +1,482 @@
+/**
+ * @file        test_image_convert.c
+ * @brief       byte-for-byte check of the image conversion against the former helper_functions.c loops, of the resize against worked-out pixels,
+ *              and of the vector code against the scalar code
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "image_convert.h"
+#include "reference_image_convert.h"
+
+/* image_convert.c built with EX_COMMON_NO_SIMD, see image_convert_scalar.c */
+int scalar_image_convert_from_rgb888(const uint8_t *src, int src_stride, image_convert_order_t src_order, int width, int height,
+                                     kp_image_format_t format, uint8_t *dst, int thread_count);
+int scalar_image_convert_to_rgb888(const uint8_t *src, int width, int height, kp_image_format_t format,
+                                   uint8_t *dst, int dst_stride, image_convert_order_t dst_order, int thread_count);
+int scalar_image_convert_resize_rgb888(const uint8_t *src, int src_stride, int src_width, int src_height,
+                                       uint8_t *dst, int dst_stride, int dst_width, int dst_height, image_convert_resize_mode_t mode, int thread_count);
+
+#define STRIDE_PADDING 5
+
+typedef enum
+{
+    STRIDE_PACKED = 0,
+    STRIDE_PADDED,
+    STRIDE_BOTTOM_UP,
+} stride_type_t;
+
+static const kp_image_format_t _formats[] = {
+    KP_IMAGE_FORMAT_RGB565,
+    KP_IMAGE_FORMAT_RGBA8888,
+    KP_IMAGE_FORMAT_YUYV,
+    KP_IMAGE_FORMAT_YCBCR422_CRY1CBY0,
+    KP_IMAGE_FORMAT_YCBCR422_CBY1CRY0,
+    KP_IMAGE_FORMAT_YCBCR422_Y1CRY0CB,
+    KP_IMAGE_FORMAT_YCBCR422_Y1CBY0CR,
+    KP_IMAGE_FORMAT_YCBCR422_CRY0CBY1,
+    KP_IMAGE_FORMAT_YCBCR422_CBY0CRY1,
+    KP_IMAGE_FORMAT_YCBCR422_Y0CRY1CB,
+    KP_IMAGE_FORMAT_YCBCR422_Y0CBY1CR,
+    KP_IMAGE_FORMAT_RAW8,
+    KP_IMAGE_FORMAT_YUV420,
+};
+
+/* odd sizes for the scalar tails, 640x480 and up are split into bands for 4 threads */
+static const int _sizes[][2] = {
+    {1, 1}, {2, 2}, {7, 3}, {16, 2}, {33, 17}, {64, 48}, {258, 130}, {640, 480}, {642, 482},
+};
+
+static const int _resizes[][4] = {
+    {1, 1, 1, 1}, {7, 5, 3, 2}, {33, 17, 64, 40}, {640, 480, 416, 416}, {640, 480, 224, 168},
+    {642, 482, 321, 241}, {300, 200, 900, 600}, {800, 600, 13, 7},
+};
+
+static uint32_t _random_state = 0x9e3779b9;
+
+static int _failure_count = 0;
+
+static void fill_random(uint8_t *buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        _random_state ^= _random_state << 13;
+        _random_state ^= _random_state >> 17;
+        _random_state ^= _random_state << 5;
+        buffer[i] = (uint8_t)(_random_state >> 24);
+    }
+}
+
+static void check_equal(const uint8_t *result, const uint8_t *expected, size_t size, const char *test, const char *reference, int width, int height,
+                        int format, int order, int stride_type, int thread_count)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (result[i] != expected[i])
+        {
+            printf("FAIL %s %dx%d format 0x%02X order %d stride %d threads %d: byte %zu is %u, %s gives %u\n",
+                   test, width, height, format, order, stride_type, thread_count, i, result[i], reference, expected[i]);
+            _failure_count++;
+            return;
+        }
+    }
+}
+
+/* bytes of an RGB888 row in the buffer */
+static int rgb_stride(int width, stride_type_t stride_type)
+{
+    return (STRIDE_PACKED == stride_type) ? width * 3 : width * 3 + STRIDE_PADDING;
+}
+
+/* first row of an RGB888 image in a buffer of 'height' rows, 'stride' is set to the stride from one row to the next */
+static uint8_t *first_row(uint8_t *buffer, int width, int height, stride_type_t stride_type, int *stride)
+{
+    int row_size = rgb_stride(width, stride_type);
+
+    if (STRIDE_BOTTOM_UP == stride_type)
+    {
+        *stride = -row_size;
+        return buffer + (size_t)(height - 1) * row_size;
+    }
+
+    *stride = row_size;
+    return buffer;
+}
+
+static int test_from_rgb888(int width, int height, kp_image_format_t format)
+{
+    int dst_size = image_convert_buffer_size(width, height, format);
+    size_t src_size = (size_t)rgb_stride(width, STRIDE_PADDED) * height;
+    uint8_t *src = malloc(src_size);
+    uint8_t *dst = malloc(dst_size);
+    uint8_t *expected = malloc(dst_size);
+
+    if (!src || !dst || !expected)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        free(src);
+        free(dst);
+        free(expected);
+        return -1;
+    }
+
+    fill_random(src, src_size);
+
+    for (int order = IMAGE_CONVERT_ORDER_BGR; order <= IMAGE_CONVERT_ORDER_RGB; order++)
+    {
+        for (int stride_type = STRIDE_PACKED; stride_type <= STRIDE_BOTTOM_UP; stride_type++)
+        {
+            int stride;
+            const uint8_t *row = first_row(src, width, height, stride_type, &stride);
+
+            memset(expected, 0xA5, dst_size);
+            if (0 != scalar_image_convert_from_rgb888(row, stride, order, width, height, format, expected, 1))
+            {
+                printf("FAIL from_rgb888 %dx%d format 0x%02X: scalar conversion failed\n", width, height, format);
+                _failure_count++;
+                continue;
+            }
+
+            for (int thread_count = 1; thread_count <= 4; thread_count += 3)
+            {
+                memset(dst, 0x5A, dst_size);
+                if (0 != image_convert_from_rgb888(row, stride, order, width, height, format, dst, thread_count))
+                {
+                    printf("FAIL from_rgb888 %dx%d format 0x%02X: conversion failed\n", width, height, format);
+                    _failure_count++;
+                    continue;
+                }
+
+                check_equal(dst, expected, dst_size, "from_rgb888", "scalar code", width, height, format, order, stride_type, thread_count);
+            }
+        }
+    }
+
+    free(src);
+    free(dst);
+    free(expected);
+
+    return 0;
+}
+
+static int test_to_rgb888(int width, int height, kp_image_format_t format)
+{
+    int src_size = image_convert_buffer_size(width, height, format);
+    size_t dst_size = (size_t)rgb_stride(width, STRIDE_PADDED) * height;
+    uint8_t *src = malloc(src_size);
+    uint8_t *dst = malloc(dst_size);
+    uint8_t *expected = malloc(dst_size);
+
+    if (!src || !dst || !expected)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        free(src);
+        free(dst);
+        free(expected);
+        return -1;
+    }
+
+    fill_random(src, src_size);
+
+    for (int order = IMAGE_CONVERT_ORDER_BGR; order <= IMAGE_CONVERT_ORDER_RGB; order++)
+    {
+        for (int stride_type = STRIDE_PACKED; stride_type <= STRIDE_BOTTOM_UP; stride_type++)
+        {
+            int stride;
+            uint8_t *row = first_row(expected, width, height, stride_type, &stride);
+
+            // the padding bytes are compared too, neither code may write them
+            memset(expected, 0xA5, dst_size);
+            if (0 != scalar_image_convert_to_rgb888(src, width, height, format, row, stride, order, 1))
+            {
+                printf("FAIL to_rgb888 %dx%d format 0x%02X: scalar conversion failed\n", width, height, format);
+                _failure_count++;
+                continue;
+            }
+
+            for (int thread_count = 1; thread_count <= 4; thread_count += 3)
+            {
+                memset(dst, 0xA5, dst_size);
+                row = first_row(dst, width, height, stride_type, &stride);
+                if (0 != image_convert_to_rgb888(src, width, height, format, row, stride, order, thread_count))
+                {
+                    printf("FAIL to_rgb888 %dx%d format 0x%02X: conversion failed\n", width, height, format);
+                    _failure_count++;
+                    continue;
+                }
+
+                check_equal(dst, expected, dst_size, "to_rgb888", "scalar code", width, height, format, order, stride_type, thread_count);
+            }
+        }
+    }
+
+    free(src);
+    free(dst);
+    free(expected);
+
+    return 0;
+}
+
+static int test_resize(int src_width, int src_height, int dst_width, int dst_height)
+{
+    size_t src_size = (size_t)rgb_stride(src_width, STRIDE_PADDED) * src_height;
+    size_t dst_size = (size_t)rgb_stride(dst_width, STRIDE_PADDED) * dst_height;
+    uint8_t *src = malloc(src_size);
+    uint8_t *dst = malloc(dst_size);
+    uint8_t *expected = malloc(dst_size);
+
+    if (!src || !dst || !expected)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        free(src);
+        free(dst);
+        free(expected);
+        return -1;
+    }
+
+    fill_random(src, src_size);
+
+    for (int mode = IMAGE_CONVERT_RESIZE_AREA; mode <= IMAGE_CONVERT_RESIZE_BILINEAR; mode++)
+    {
+        for (int stride_type = STRIDE_PACKED; stride_type <= STRIDE_BOTTOM_UP; stride_type++)
+        {
+            int src_stride;
+            int dst_stride = rgb_stride(dst_width, (STRIDE_PACKED == stride_type) ? STRIDE_PACKED : STRIDE_PADDED);
+            const uint8_t *row = first_row(src, src_width, src_height, stride_type, &src_stride);
+
+            memset(expected, 0xA5, dst_size);
+            if (0 != scalar_image_convert_resize_rgb888(row, src_stride, src_width, src_height, expected, dst_stride, dst_width, dst_height,
+                                                        mode, 1))
+            {
+                printf("FAIL resize %dx%d to %dx%d: scalar resize failed\n", src_width, src_height, dst_width, dst_height);
+                _failure_count++;
+                continue;
+            }
+
+            for (int thread_count = 1; thread_count <= 4; thread_count += 3)
+            {
+                memset(dst, 0xA5, dst_size);
+                if (0 != image_convert_resize_rgb888(row, src_stride, src_width, src_height, dst, dst_stride, dst_width, dst_height,
+                                                     mode, thread_count))
+                {
+                    printf("FAIL resize %dx%d to %dx%d: resize failed\n", src_width, src_height, dst_width, dst_height);
+                    _failure_count++;
+                    continue;
+                }
+
+                // the mode is reported in place of the format
+                check_equal(dst, expected, dst_size, "resize", "scalar code", dst_width, dst_height, mode, 0, stride_type, thread_count);
+            }
+        }
+    }
+
+    free(src);
+    free(dst);
+    free(expected);
+
+    return 0;
+}
+
+/*
+ * BMP pixel data (bottom-up BGR rows padded to 4 bytes) to a raw format and back, against the loops of helper_functions.c
+ * before image_convert.c; the padding bytes of the BMP rows are compared too, neither code may write them
+ */
+static int test_former_code(int width, int height, kp_image_format_t format)
+{
+    int raw_size = image_convert_buffer_size(width, height, format);
+    int bmp_row_size = (width * 3 + 3) & ~3;
+    size_t bmp_size = (size_t)bmp_row_size * height;
+    uint8_t *bmp = malloc(bmp_size);
+    uint8_t *raw = malloc(raw_size);
+    uint8_t *raw_copy = malloc(raw_size);
+    uint8_t *result_raw = malloc(raw_size);
+    uint8_t *expected_raw = malloc(raw_size);
+    uint8_t *result_bmp = malloc(bmp_size);
+    uint8_t *expected_bmp = malloc(bmp_size);
+    int ret = -1;
+
+    if (!bmp || !raw || !raw_copy || !result_raw || !expected_raw || !result_bmp || !expected_bmp)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        goto FUNC_OUT;
+    }
+
+    fill_random(bmp, bmp_size);
+    fill_random(raw, raw_size);
+
+    memset(expected_raw, 0xA5, raw_size);
+    if (0 != reference_bmp_pixel_data_to_raw(bmp, width, height, format, expected_raw))
+    {
+        printf("FAIL former code %dx%d format 0x%02X: conversion failed\n", width, height, format);
+        _failure_count++;
+        ret = 0;
+        goto FUNC_OUT;
+    }
+
+    // the former code takes a non-const buffer, it is given a copy
+    memcpy(raw_copy, raw, raw_size);
+    memset(expected_bmp, 0xA5, bmp_size);
+    reference_raw_to_bmp_pixel_data(raw_copy, expected_bmp, width, height, format, bmp_row_size - width * 3);
+
+    for (int thread_count = 1; thread_count <= 4; thread_count += 3)
+    {
+        memset(result_raw, 0x5A, raw_size);
+        if (0 != image_convert_from_rgb888(bmp + (size_t)(height - 1) * bmp_row_size, -bmp_row_size, IMAGE_CONVERT_ORDER_BGR, width, height,
+                                           format, result_raw, thread_count))
+        {
+            printf("FAIL from_rgb888 %dx%d format 0x%02X: conversion failed\n", width, height, format);
+            _failure_count++;
+        }
+        else
+        {
+            check_equal(result_raw, expected_raw, raw_size, "from BMP", "former code", width, height, format, IMAGE_CONVERT_ORDER_BGR,
+                        STRIDE_BOTTOM_UP, thread_count);
+        }
+
+        memset(result_bmp, 0xA5, bmp_size);
+        if (0 != image_convert_to_rgb888(raw, width, height, format, result_bmp + (size_t)(height - 1) * bmp_row_size, -bmp_row_size,
+                                         IMAGE_CONVERT_ORDER_BGR, thread_count))
+        {
+            printf("FAIL to_rgb888 %dx%d format 0x%02X: conversion failed\n", width, height, format);
+            _failure_count++;
+        }
+        else
+        {
+            check_equal(result_bmp, expected_bmp, bmp_size, "to BMP", "former code", width, height, format, IMAGE_CONVERT_ORDER_BGR,
+                        STRIDE_BOTTOM_UP, thread_count);
+        }
+    }
+
+    ret = 0;
+
+FUNC_OUT:
+    free(bmp);
+    free(raw);
+    free(raw_copy);
+    free(result_raw);
+    free(expected_raw);
+    free(result_bmp);
+    free(expected_bmp);
+
+    return ret;
+}
+
+/*
+ * resizes with worked-out pixels, there is no former resize code: the area pixels are averages of the covered source pixels
+ * rounded half up, the bilinear pixels interpolate the source pixels at aligned pixel centers
+ */
+static void test_resize_pixels()
+{
+    static const struct
+    {
+        const char *name;
+        image_convert_resize_mode_t mode;
+        int src_width, src_height, dst_width, dst_height;
+        uint8_t src[8 * 3];
+        uint8_t expected[4 * 3];
+    } cases[] = {
+        // 2x2 blocks: (10 + 20 + 30 + 41) / 4 = 25.25, (0 + 1 + 1 + 1) / 4 = 0.75, (200 + 201 + 200 + 201) / 4 = 200.5
+        {"area 4x2 to 2x1", IMAGE_CONVERT_RESIZE_AREA, 4, 2, 2, 1,
+         {10, 0, 200, 20, 1, 201, 0, 0, 0, 0, 0, 0, 30, 1, 200, 41, 1, 201, 0, 0, 0, 0, 0, 0},
+         {25, 1, 201, 0, 0, 0}},
+        // a pixel covers 1.5 source pixels: (30 + 60 / 2) / 1.5 = 40, (60 / 2 + 90) / 1.5 = 80
+        {"area 3x1 to 2x1", IMAGE_CONVERT_RESIZE_AREA, 3, 1, 2, 1,
+         {30, 0, 255, 60, 0, 255, 90, 3, 255},
+         {40, 0, 255, 80, 2, 255}},
+        // source positions -0.25 (clamped to 0), 0.25, 0.75 and 1.25 (clamped to 1)
+        {"bilinear 2x1 to 4x1", IMAGE_CONVERT_RESIZE_BILINEAR, 2, 1, 4, 1,
+         {0, 100, 255, 200, 100, 55},
+         {0, 100, 255, 50, 100, 205, 150, 100, 105, 200, 100, 55}},
+        // the area mode upscales bilinearly
+        {"area 2x1 to 4x1", IMAGE_CONVERT_RESIZE_AREA, 2, 1, 4, 1,
+         {0, 100, 255, 200, 100, 55},
+         {0, 100, 255, 50, 100, 205, 150, 100, 105, 200, 100, 55}},
+        // (10 + 21) / 2 = 15.5 is rounded up
+        {"area 1x2 to 1x1", IMAGE_CONVERT_RESIZE_AREA, 1, 2, 1, 1,
+         {10, 0, 7, 21, 1, 8},
+         {16, 1, 8}},
+    };
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        uint8_t dst[4 * 3];
+        int src_stride = cases[c].src_width * 3;
+        int dst_size = cases[c].dst_width * cases[c].dst_height * 3;
+
+        memset(dst, 0xA5, sizeof(dst));
+        if (0 != image_convert_resize_rgb888(cases[c].src, src_stride, cases[c].src_width, cases[c].src_height, dst, cases[c].dst_width * 3,
+                                             cases[c].dst_width, cases[c].dst_height, cases[c].mode, 1))
+        {
+            printf("FAIL resize %s: resize failed\n", cases[c].name);
+            _failure_count++;
+            continue;
+        }
+
+        for (int i = 0; i < dst_size; i++)
+        {
+            if (dst[i] != cases[c].expected[i])
+            {
+                printf("FAIL resize %s: byte %d is %u, expected %u\n", cases[c].name, i, dst[i], cases[c].expected[i]);
+                _failure_count++;
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int test_count = 0;
+
+#if defined(EX_COMMON_NO_SIMD)
+    printf("image_convert.c built without vector code, checking the scalar code with threads\n");
+#else
+    printf("checking the vector code of image_convert.c against its scalar code\n");
+#endif
+
+    for (size_t s = 0; s < sizeof(_sizes) / sizeof(_sizes[0]); s++)
+    {
+        int width = _sizes[s][0];
+        int height = _sizes[s][1];
+
+        for (size_t f = 0; f < sizeof(_formats) / sizeof(_formats[0]); f++)
+        {
+            // e.g. YCbCr422 with an odd width
+            if (0 >= image_convert_buffer_size(width, height, _formats[f]))
+                continue;
+
+            if ((0 != test_former_code(width, height, _formats[f])) || (0 != test_from_rgb888(width, height, _formats[f])) ||
+                (0 != test_to_rgb888(width, height, _formats[f])))
+                return -1;
+
+            test_count += 4;
+        }
+    }
+
+    for (size_t r = 0; r < sizeof(_resizes) / sizeof(_resizes[0]); r++)
+    {
+        if (0 != test_resize(_resizes[r][0], _resizes[r][1], _resizes[r][2], _resizes[r][3]))
+            return -1;
+
+        test_count++;
+    }
+
+    test_resize_pixels();
+
+    if (0 < _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("%d conversions match the former helper_functions.c code and the scalar code, resizes match worked-out pixels and the scalar code\n",
+           test_count);
+
+    return 0;
+}
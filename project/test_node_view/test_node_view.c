@@ -0,0 +1,296 @@
+/**
+ * @file        test_node_view.c
+ * @brief       check of node view reads against the full floating-point retrieval of synthetic RAW output buffers
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kp_inference.h"
+#include "raw_output_builder.h"
+
+#define NODE_COUNT 3
+#define REGION_COUNT 16
+
+typedef struct
+{
+    const char *name;
+    uint32_t product_id;
+    uint32_t data_layout;
+    bool per_channel;
+    int32_t radix_dtype;
+    int32_t scale_dtype;
+} test_case_t;
+
+static const test_case_t _test_cases[] = {
+    {"KL520 16W1C8B", KP_DEVICE_KL520, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, false, 0, 0},
+    {"KL720 16W1C8B", KP_DEVICE_KL720, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, false, 0, 0},
+    {"KL720 1W16C8B", KP_DEVICE_KL720, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, false, 0, 0},
+    {"KL720 8W1C16B", KP_DEVICE_KL720, KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, false, 0, 0},
+    {"KL630 16W1C8B", KP_DEVICE_KL630, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, false, 0, 0},
+    {"KL630 1W16C8B", KP_DEVICE_KL630, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, false, 0, 0},
+    {"KL630 8W1C16B", KP_DEVICE_KL630, KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, false, 0, 0},
+    {"KL730 16W1C8B", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, false, 0, 0},
+    {"KL730 16W1C8B per-channel", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, true, 0, 0},
+    {"KL730 1W16C8B", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, false, 0, 0},
+    {"KL730 1W16C8B per-channel", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, true, KP_DTYPE_INT8, KP_DTYPE_UINT16},
+    {"KL730 8W1C16B per-channel", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, true, KP_DTYPE_INT16, KP_DTYPE_FLOAT32},
+    {"KL730 4W4C8B", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B, false, 0, KP_DTYPE_INT8},
+    {"KL730 16W1C8BHL", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL, false, 0, 0},
+    {"KL730 16W1C8BHL per-channel", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL, true, 0, KP_DTYPE_INT32},
+    {"KL730 1W16C8BHL", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL, false, 0, 0},
+    {"KL730 1W16C8BHL per-channel", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL, true, KP_DTYPE_INT16, KP_DTYPE_UINT8},
+    {"KL730 4W4C8BHL per-channel", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL, true, 0, KP_DTYPE_INT16},
+    {"KL730 1W16C8B_CH_COMPACT", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT, true, 0, 0},
+    {"KL730 1W16C8BHL_CH_COMPACT", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT, true, 0, KP_DTYPE_UINT32},
+    {"KL730 RAW_8B", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B, true, 0, 0},
+    {"KL730 RAW_16B", KP_DEVICE_KL730, KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B, false, 0, 0},
+    {"KL830 1W16C8BHL per-channel", KP_DEVICE_KL830, KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL, true, 0, 0},
+};
+
+/* channels across several groups of 16 and widths off the 4/8/16 alignment */
+static const int32_t _shapes[NODE_COUNT][4] = {
+    {1, 20, 5, 19},
+    {1, 3, 7, 33},
+    {1, 35, 2, 1},
+};
+
+static uint32_t _random_state = 0x6d2b79f5;
+
+static int _failure_count = 0;
+
+static uint32_t random_next()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return _random_state;
+}
+
+static void report_failure(const char *test, uint32_t node_idx, const char *what)
+{
+    printf("FAIL %s node %u: %s\n", test, node_idx, what);
+    _failure_count++;
+}
+
+static uint32_t get_num_data(const int32_t *shape, uint32_t shape_len)
+{
+    uint32_t num_data = 1;
+
+    for (uint32_t axis = 0; axis < shape_len; axis++)
+        num_data *= shape[axis];
+
+    return num_data;
+}
+
+static uint32_t get_offset(const int32_t *shape, uint32_t shape_len, const int32_t *index)
+{
+    uint32_t offset = 0;
+
+    for (uint32_t axis = 0; axis < shape_len; axis++)
+        offset = offset * shape[axis] + index[axis];
+
+    return offset;
+}
+
+/* every single value, every row and random regions of the view should be the same bits as the full retrieval */
+static void check_node_view(const char *test, uint32_t node_idx, kp_inf_node_view_t *node_view, const float *full_data)
+{
+    uint32_t shape_len = node_view->shape_len;
+    uint32_t last_axis = shape_len - 1;
+    uint32_t num_data = get_num_data(node_view->shape, shape_len);
+    int32_t index[KP_MAX_NODE_VIEW_SHAPE_LEN] = {0};
+    int32_t start[KP_MAX_NODE_VIEW_SHAPE_LEN] = {0};
+    int32_t size[KP_MAX_NODE_VIEW_SHAPE_LEN] = {0};
+    float *buffer = malloc(num_data * sizeof(float));
+    float *expected = malloc(num_data * sizeof(float));
+    float value = 0;
+
+    if ((NULL == buffer) || (NULL == expected))
+    {
+        report_failure(test, node_idx, "out of memory");
+        goto OUT;
+    }
+
+    for (uint32_t i = 0; i < num_data; i++)
+    {
+        if ((KP_SUCCESS != kp_inf_node_view_get_float(node_view, index, &value)) ||
+            (0 != memcmp(&value, &full_data[i], sizeof(float))))
+        {
+            report_failure(test, node_idx, "kp_inf_node_view_get_float() differs");
+            goto OUT;
+        }
+
+        for (int axis = last_axis; axis >= 0; axis--)
+        {
+            if (++index[axis] < node_view->shape[axis])
+                break;
+
+            index[axis] = 0;
+        }
+    }
+
+    for (uint32_t row = 0; row < num_data / node_view->shape[last_axis]; row++)
+    {
+        uint32_t offset = row * node_view->shape[last_axis];
+
+        for (int axis = last_axis; axis >= 0; axis--)
+        {
+            index[axis] = offset % node_view->shape[axis];
+            offset /= node_view->shape[axis];
+        }
+
+        if ((KP_SUCCESS != kp_inf_node_view_get_float_row(node_view, index, buffer, node_view->shape[last_axis])) ||
+            (0 != memcmp(buffer, &full_data[row * node_view->shape[last_axis]], node_view->shape[last_axis] * sizeof(float))))
+        {
+            report_failure(test, node_idx, "kp_inf_node_view_get_float_row() differs");
+            goto OUT;
+        }
+    }
+
+    /* the whole node first, then random regions */
+    for (int region = 0; region < REGION_COUNT; region++)
+    {
+        uint32_t region_num_data = 1;
+        uint32_t n = 0;
+
+        for (uint32_t axis = 0; axis < shape_len; axis++)
+        {
+            start[axis] = (0 == region) ? 0 : random_next() % node_view->shape[axis];
+            size[axis] = (0 == region) ? node_view->shape[axis] : 1 + random_next() % (node_view->shape[axis] - start[axis]);
+            region_num_data *= size[axis];
+            index[axis] = start[axis];
+        }
+
+        while (true)
+        {
+            expected[n++] = full_data[get_offset(node_view->shape, shape_len, index)];
+
+            int axis = last_axis;
+            for (; axis >= 0; axis--)
+            {
+                if (++index[axis] < start[axis] + size[axis])
+                    break;
+
+                index[axis] = start[axis];
+            }
+
+            if (0 > axis)
+                break;
+        }
+
+        if ((KP_SUCCESS != kp_inf_node_view_extract_float_region(node_view, start, size, buffer, region_num_data)) ||
+            (0 != memcmp(buffer, expected, region_num_data * sizeof(float))))
+        {
+            report_failure(test, node_idx, "kp_inf_node_view_extract_float_region() differs");
+            goto OUT;
+        }
+
+        /* a buffer one value short is rejected */
+        if ((0 == region) && (KP_SUCCESS == kp_inf_node_view_extract_float_region(node_view, start, size, buffer, region_num_data - 1)))
+        {
+            report_failure(test, node_idx, "kp_inf_node_view_extract_float_region() accepts an insufficient buffer");
+            goto OUT;
+        }
+    }
+
+OUT:
+    free(buffer);
+    free(expected);
+}
+
+static void run_test_case(const test_case_t *test_case)
+{
+    raw_output_node_spec_t node_specs[NODE_COUNT];
+    float *expected_values[NODE_COUNT] = {NULL};
+    kp_channel_ordering_t ordering = (KP_DEVICE_KL730 == test_case->product_id || KP_DEVICE_KL830 == test_case->product_id) ?
+                                     KP_CHANNEL_ORDERING_DEFAULT : KP_CHANNEL_ORDERING_CHW;
+    uint8_t *raw_out_buffer = NULL;
+
+    memset(node_specs, 0, sizeof(node_specs));
+
+    for (int i = 0; i < NODE_COUNT; i++)
+    {
+        node_specs[i].data_layout = test_case->data_layout;
+        node_specs[i].shape_len = 4;
+        memcpy(node_specs[i].shape, _shapes[i], sizeof(_shapes[i]));
+        node_specs[i].channel_axis = 1;
+        node_specs[i].per_channel = test_case->per_channel;
+        node_specs[i].radix_dtype = test_case->radix_dtype;
+        node_specs[i].scale_dtype = test_case->scale_dtype;
+    }
+
+    raw_out_buffer = raw_output_build(test_case->product_id, node_specs, NODE_COUNT, random_next(), expected_values, NULL);
+    if (NULL == raw_out_buffer)
+    {
+        report_failure(test_case->name, 0, "raw_output_build() failed");
+        return;
+    }
+
+    for (uint32_t node_idx = 0; node_idx < NODE_COUNT; node_idx++)
+    {
+        kp_inf_float_node_output_t *float_node = kp_generic_inference_retrieve_float_node(node_idx, raw_out_buffer, ordering);
+        kp_inf_node_view_t node_view;
+        uint32_t num_data = get_num_data(_shapes[node_idx], 4);
+
+        if (NULL == float_node)
+        {
+            report_failure(test_case->name, node_idx, "kp_generic_inference_retrieve_float_node() failed");
+            continue;
+        }
+
+        /* the full retrieval itself should give the values the buffer was built from */
+        if ((num_data != float_node->num_data) ||
+            (0 != memcmp(float_node->data, expected_values[node_idx], num_data * sizeof(float))))
+            report_failure(test_case->name, node_idx, "kp_generic_inference_retrieve_float_node() differs from the built values");
+        else if (KP_SUCCESS != kp_generic_inference_retrieve_node_view(node_idx, raw_out_buffer, &node_view))
+            report_failure(test_case->name, node_idx, "kp_generic_inference_retrieve_node_view() failed");
+        else if ((4 != node_view.shape_len) || (0 != memcmp(node_view.shape, _shapes[node_idx], sizeof(_shapes[node_idx]))))
+            report_failure(test_case->name, node_idx, "node view shape differs");
+        else
+            check_node_view(test_case->name, node_idx, &node_view, float_node->data);
+
+        kp_release_float_node_output(float_node);
+    }
+
+    for (int i = 0; i < NODE_COUNT; i++)
+        free(expected_values[i]);
+    free(raw_out_buffer);
+}
+
+int main(int argc, char *argv[])
+{
+    kp_inf_node_view_t node_view;
+    int test_count = sizeof(_test_cases) / sizeof(_test_cases[0]);
+
+    for (int i = 0; i < test_count; i++)
+        run_test_case(&_test_cases[i]);
+
+    /* a node index out of range is rejected */
+    raw_output_node_spec_t node_spec = {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, 4, {1, 4, 4, 4}};
+    uint8_t *raw_out_buffer = raw_output_build(KP_DEVICE_KL720, &node_spec, 1, 1, NULL, NULL);
+
+    if ((NULL == raw_out_buffer) || (KP_SUCCESS == kp_generic_inference_retrieve_node_view(1, raw_out_buffer, &node_view)))
+    {
+        printf("FAIL node index out of range is not rejected\n");
+        _failure_count++;
+    }
+
+    free(raw_out_buffer);
+
+    if (0 != _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("%d RAW output layouts: node view reads match kp_generic_inference_retrieve_float_node()\n", test_count);
+
+    return 0;
+}
@@ -0,0 +1,447 @@
+/**
+ * @file        reference_onnx_to_npu_data.c
+ * @brief       frozen copy of the ONNX to NPU data conversion of helper_functions.c before the plan and vector code, the reference of test_onnx_to_npu_data
+ *
+ * kneron_round() and helper_convert_onnx_data_to_npu_data() are copied unchanged from the baseline helper_functions.c, only the
+ * conversion is renamed. It quantizes onnx_data_buf in place and leaves the scalars of RAW_FLOAT not covered by the tensor as
+ * realloc() gives them.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helper_functions.h"
+#include "reference_onnx_to_npu_data.h"
+
+#define MIN(a,b) (((a)<(b))?(a):(b))
+#define MAX(a,b) (((a)>(b))?(a):(b))
+
+static int kneron_round(float _input)
+{
+    if (_input > (float)INT_MAX) {
+        return INT_MAX;
+    } else if (_input < (float)INT_MIN) {
+        return INT_MIN;
+    }
+
+    int f               = (int)_input;
+    float fractionPart  = _input - f;
+
+    if (fractionPart < 0) {
+        fractionPart *= -1;
+    }
+
+    bool oddFlag = true;
+
+    if (f % 2 == 0) {
+        oddFlag = false;
+    }
+
+    if (fractionPart > 0.5) {
+        // always round to nearest
+        if (_input >= 0) {
+            ++f;
+        } else {
+            --f;
+        }
+    } else if (fractionPart == 0.5) {
+        // ties to even depending odd or even
+        if (oddFlag) {
+            if (_input >= 0) {
+                ++f;
+            } else {
+                --f;
+            }
+        }
+    }
+
+    return f;
+}
+
+int reference_convert_onnx_data_to_npu_data(kp_tensor_descriptor_t *tensor_descriptor, float *onnx_data_buf, int32_t onnx_data_buf_size, int8_t **npu_data_buf, int32_t *npu_data_buf_size)
+{
+    int status                                                  = KP_SUCCESS;
+
+    kp_tensor_shape_info_v2_t *tensor_shape_info                = NULL;
+
+    uint32_t npu_data_layout                                    = KP_MODEL_TENSOR_DATA_LAYOUT_UNKNOWN;
+
+    kp_quantization_parameters_v1_t *quantization_parameters_v1 = NULL;
+    float quantization_max_value                                = 0;
+    float quantization_min_value                                = 0;
+    int32_t radix                                               = 0;
+    float scale                                                 = 0;
+    float quantization_factor                                   = 0;
+    int quantized_axis_stride                                   = 0;
+
+    int channel_idx                                             = 0;
+    int npu_channel_group_stride_tmp                            = 0;
+    int npu_channel_group_stride                                = -1;
+
+    int32_t *onnx_data_shape_index                              = NULL;
+    int32_t onnx_data_buf_offset                                = 0;
+    int32_t npu_data_buf_offset                                 = 0;
+
+    int max_npu_stride_axis                                     = 0;
+    uint32_t max_npu_stride                                     = 0;
+    uint16_t npu_data_element_u16b                              = 0;
+    uint16_t npu_data_element_i16b                              = 0;
+    uint16_t npu_data_high_bit_offset                           = 16;
+
+    if (NULL == tensor_descriptor ||
+        NULL == onnx_data_buf ||
+        0 == onnx_data_buf_size ||
+        NULL == npu_data_buf ||
+        NULL == npu_data_buf_size) {
+        printf("convert onnx data to npu data fail: NULL pointer input parameters ...\n");
+        status = KP_ERROR_INVALID_PARAM_12;
+        goto FUNC_OUT;
+    }
+
+    if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2 != tensor_descriptor->tensor_shape_info.version) {
+        printf("convert onnx data to npu data fail: only support KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2 tensor shape ...\n");
+        status = KP_ERROR_INVALID_PARAM_12;
+        goto FUNC_OUT;
+    }
+
+    quantization_parameters_v1  = &(tensor_descriptor->quantization_parameters.quantization_parameters_data.v1);
+    tensor_shape_info           = &(tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2);
+    npu_data_layout             = tensor_descriptor->data_layout;
+
+    /* input data quantization */
+    {
+        // get clip value by data layout
+        switch (npu_data_layout)
+        {
+        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B:
+            quantization_max_value = 127.0f;
+            quantization_min_value = -128.0f;
+            break;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+            quantization_max_value = 32766.0f;
+            quantization_min_value = -32768.0f;
+            break;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT:
+            quantization_max_value = FLT_MAX;
+            quantization_min_value = FLT_MIN;
+            break;
+        default:
+            printf("error: get invalide data layout ...\n");
+            status = KP_ERROR_INVALID_MODEL_21;
+            goto FUNC_OUT;
+        }
+
+        // toolchain calculate the radix value from input data (after normalization), and set it into NEF model.
+        // NPU will divide input data "2^radix" automatically, so, we have to scaling the input data here due to this reason.
+        if (1 == quantization_parameters_v1->quantized_fixed_point_descriptor_num) {
+            // layer-wise quantize
+            radix = 0;
+            scale = 0;
+            if (KP_SUCCESS != helper_get_quantization_parameters_v1_information(quantization_parameters_v1, 0, &radix, &scale)) {
+                printf("error: get invalide KneronKNE_DataType_enum_t ...\n");
+                status = KP_ERROR_INVALID_MODEL_21;
+                goto FUNC_OUT;
+            }
+
+            quantization_factor = powf(2, (float)radix) * scale;
+
+            for (onnx_data_buf_offset = 0; onnx_data_buf_offset < onnx_data_buf_size; onnx_data_buf_offset++) {
+                onnx_data_buf[onnx_data_buf_offset] = (float)kneron_round(onnx_data_buf[onnx_data_buf_offset] * quantization_factor);
+                onnx_data_buf[onnx_data_buf_offset] = MAX(quantization_min_value, MIN(onnx_data_buf[onnx_data_buf_offset], quantization_max_value));
+            }
+        } else if (1 < quantization_parameters_v1->quantized_fixed_point_descriptor_num) {
+            // channel-wise quantize
+            quantized_axis_stride = 1;
+            for (int axis = 0; axis < tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2.shape_len; axis++) {
+                if (axis != quantization_parameters_v1->quantized_axis) {
+                    quantized_axis_stride *= tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2.shape[axis];
+                }
+            }
+
+            onnx_data_buf_offset = 0;
+            for (int quantized_fixed_point_descriptor_idx = 0; quantized_fixed_point_descriptor_idx < quantization_parameters_v1->quantized_fixed_point_descriptor_num; quantized_fixed_point_descriptor_idx++) {
+                radix = 0;
+                scale = 0;
+
+                if (KP_SUCCESS != helper_get_quantization_parameters_v1_information(quantization_parameters_v1, quantized_fixed_point_descriptor_idx, &radix, &scale)) {
+                    printf("error: get invalide KneronKNE_DataType_enum_t ...\n");
+                    status = KP_ERROR_INVALID_MODEL_21;
+                    goto FUNC_OUT;
+                }
+
+                quantization_factor = powf(2, (float)radix) * scale;
+
+                for (int quantized_axis_offset = 0; quantized_axis_offset < quantized_axis_stride; quantized_axis_offset++) {
+                    onnx_data_buf[onnx_data_buf_offset] = (float)kneron_round(onnx_data_buf[onnx_data_buf_offset] * quantization_factor);
+                    onnx_data_buf[onnx_data_buf_offset] = MAX(quantization_min_value, MIN(onnx_data_buf[onnx_data_buf_offset], quantization_max_value));
+                    onnx_data_buf_offset += 1;
+                }
+            }
+        } else {
+            printf("error: get invalide number of quantized_fixed_point_descriptor ...\n");
+            status = KP_ERROR_INVALID_MODEL_21;
+            goto FUNC_OUT;
+        }
+    }
+
+    /* re-layout the data to fit NPU data layout format */
+    {
+        onnx_data_shape_index = calloc(tensor_shape_info->shape_len, sizeof(int32_t));
+        if (NULL == onnx_data_shape_index) {
+            printf("error: malloc working buffer onnx_data_shape_index fail ...\n");
+            status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+            goto FUNC_OUT;
+        }
+
+        switch (npu_data_layout)
+        {
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+            for (int axis = 0; axis < (int)tensor_shape_info->shape_len; axis++) {
+                if (1 == tensor_shape_info->stride_npu[axis]) {
+                    channel_idx = axis;
+                    continue;
+                }
+
+                npu_channel_group_stride_tmp = tensor_shape_info->stride_npu[axis] * tensor_shape_info->shape[axis];
+                if (npu_channel_group_stride_tmp > npu_channel_group_stride)
+                    npu_channel_group_stride = npu_channel_group_stride_tmp;
+            }
+
+            *npu_data_buf_size = (tensor_shape_info->shape[channel_idx] >> 4) * npu_channel_group_stride;
+
+            if (0 != (tensor_shape_info->shape[channel_idx] % 16)) {
+                *npu_data_buf_size += npu_channel_group_stride;
+            }
+
+            /* reuse for npu_data_buf_offset calculate (without reset the ) */
+            npu_channel_group_stride -= 16;
+            break;
+        default:
+        for (int axis = 0; axis < tensor_shape_info->shape_len; axis++) {
+            if (tensor_shape_info->stride_npu[axis] > max_npu_stride) {
+                max_npu_stride      = tensor_shape_info->stride_npu[axis];
+                max_npu_stride_axis = axis;
+            }
+        }
+
+            *npu_data_buf_size = tensor_shape_info->shape[max_npu_stride_axis] * max_npu_stride;
+            break;
+        }
+
+        switch (npu_data_layout)
+        {
+        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B:
+            *npu_data_buf_size  = *npu_data_buf_size * sizeof(int8_t);
+            *npu_data_buf       = realloc(*npu_data_buf, *npu_data_buf_size);
+
+            if (NULL == *npu_data_buf) {
+                printf("error: malloc working buffer npu_data_buf fail ...\n");
+                status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+                goto FUNC_OUT;
+            }
+
+            memset(*npu_data_buf, 0, *npu_data_buf_size);
+
+            while (true) {
+                onnx_data_buf_offset    = 0;
+                npu_data_buf_offset     = 0;
+
+                for (int32_t axis = 0; axis < tensor_shape_info->shape_len; axis++) {
+                    onnx_data_buf_offset    += onnx_data_shape_index[axis] * tensor_shape_info->stride_onnx[axis];
+                    npu_data_buf_offset     += onnx_data_shape_index[axis] * tensor_shape_info->stride_npu[axis];
+                }
+
+                if (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B == npu_data_layout) {
+                    /* npu_data_buf_offset += (onnx_data_shape_index[channel_idx] / 16) * npu_channel_group_stride; */
+                    npu_data_buf_offset += (onnx_data_shape_index[channel_idx] >> 4) * npu_channel_group_stride;
+                }
+
+                ((int8_t *)*npu_data_buf)[npu_data_buf_offset] = (int8_t)onnx_data_buf[onnx_data_buf_offset];
+
+                for (int32_t axis = tensor_shape_info->shape_len - 1; axis >= 0; axis--) {
+                    onnx_data_shape_index[axis]++;
+                    if (onnx_data_shape_index[axis] == tensor_shape_info->shape[axis]) {
+                        if (axis == 0)
+                            break;
+
+                        onnx_data_shape_index[axis] = 0;
+                        continue;
+                    } else {
+                        break;
+                    }
+                }
+
+                if (onnx_data_shape_index[0] == tensor_shape_info->shape[0]) {
+                    break;
+                }
+            }
+            break;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
+            *npu_data_buf_size  = *npu_data_buf_size * sizeof(int16_t);
+            *npu_data_buf       = realloc(*npu_data_buf, *npu_data_buf_size);
+
+            if (NULL == *npu_data_buf) {
+                printf("error: malloc working buffer npu_data_buf fail ...\n");
+                status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+                goto FUNC_OUT;
+            }
+
+            memset(*npu_data_buf, 0, *npu_data_buf_size);
+
+            while (true) {
+                onnx_data_buf_offset    = 0;
+                npu_data_buf_offset     = 0;
+
+                for (int32_t axis = 0; axis < tensor_shape_info->shape_len; axis++) {
+                    onnx_data_buf_offset    += onnx_data_shape_index[axis] * tensor_shape_info->stride_onnx[axis];
+                    npu_data_buf_offset     += onnx_data_shape_index[axis] * tensor_shape_info->stride_npu[axis];
+                }
+
+                npu_data_element_i16b                               = (int16_t)onnx_data_buf[onnx_data_buf_offset];
+                npu_data_element_u16b                               = *((uint16_t *)(&npu_data_element_i16b));
+                ((uint16_t *)*npu_data_buf)[npu_data_buf_offset]    = (npu_data_element_u16b & 0xfffeu);
+
+                for (int32_t axis = tensor_shape_info->shape_len - 1; axis >= 0; axis--) {
+                    onnx_data_shape_index[axis]++;
+                    if (onnx_data_shape_index[axis] == tensor_shape_info->shape[axis]) {
+                        if (axis == 0)
+                            break;
+
+                        onnx_data_shape_index[axis] = 0;
+                        continue;
+                    } else {
+                        break;
+                    }
+                }
+
+                if (onnx_data_shape_index[0] == tensor_shape_info->shape[0])
+                    break;
+            }
+            break;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+        case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+            *npu_data_buf_size  = *npu_data_buf_size * sizeof(uint16_t);
+            *npu_data_buf       = realloc(*npu_data_buf, *npu_data_buf_size);
+
+            if (NULL == *npu_data_buf) {
+                printf("error: malloc working buffer npu_data_buf fail ...\n");
+                status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+                goto FUNC_OUT;
+            }
+
+            memset(*npu_data_buf, 0, *npu_data_buf_size);
+
+            while (true) {
+                onnx_data_buf_offset    = 0;
+                npu_data_buf_offset     = 0;
+
+                for (int32_t axis = 0; axis < tensor_shape_info->shape_len; axis++) {
+                    onnx_data_buf_offset    += onnx_data_shape_index[axis] * tensor_shape_info->stride_onnx[axis];
+                    npu_data_buf_offset     += onnx_data_shape_index[axis] * tensor_shape_info->stride_npu[axis];
+                }
+
+                if (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL == npu_data_layout) {
+                    /* npu_data_buf_offset += (onnx_data_shape_index[channel_idx] / 16) * npu_channel_group_stride; */
+                    npu_data_buf_offset += (onnx_data_shape_index[channel_idx] >> 4) * npu_channel_group_stride;
+                }
+
+                /* npu_data_buf_offset = (npu_data_buf_offset / 16) * 32 + (npu_data_buf_offset % 16) */
+                npu_data_buf_offset = ((npu_data_buf_offset >> 4) << 5) + (npu_data_buf_offset & 15u);
+
+                npu_data_element_i16b                                                       = (int16_t)onnx_data_buf[onnx_data_buf_offset];
+                npu_data_element_u16b                                                       = ((*((uint16_t *)(&npu_data_element_i16b))) >> 1);
+                ((uint8_t *)*npu_data_buf)[npu_data_buf_offset]                             = (uint8_t)(npu_data_element_u16b & 0x007fu);
+                ((uint8_t *)*npu_data_buf)[npu_data_buf_offset + npu_data_high_bit_offset]  = (uint8_t)((npu_data_element_u16b >> 7) & 0x00ffu);
+
+                for (int32_t axis = tensor_shape_info->shape_len - 1; axis >= 0; axis--) {
+                    onnx_data_shape_index[axis]++;
+                    if (onnx_data_shape_index[axis] == tensor_shape_info->shape[axis]) {
+                        if (axis == 0)
+                            break;
+
+                        onnx_data_shape_index[axis] = 0;
+                        continue;
+                    } else {
+                        break;
+                    }
+                }
+
+                if (onnx_data_shape_index[0] == tensor_shape_info->shape[0])
+                    break;
+            }
+            break;
+        case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT:
+            *npu_data_buf_size  = *npu_data_buf_size * sizeof(float);
+            *npu_data_buf        = realloc(*npu_data_buf, *npu_data_buf_size);
+
+            if (NULL == *npu_data_buf) {
+                printf("error: malloc working buffer npu_data_buf fail ...\n");
+                status = KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+                goto FUNC_OUT;
+            }
+
+            while (true) {
+                onnx_data_buf_offset    = 0;
+                npu_data_buf_offset     = 0;
+
+                for (int32_t axis = 0; axis < tensor_shape_info->shape_len; axis++) {
+                    onnx_data_buf_offset    += onnx_data_shape_index[axis] * tensor_shape_info->stride_onnx[axis];
+                    npu_data_buf_offset     += onnx_data_shape_index[axis] * tensor_shape_info->stride_npu[axis];
+                }
+
+                ((float *)*npu_data_buf)[npu_data_buf_offset] = (float)onnx_data_buf[onnx_data_buf_offset];
+
+                for (int32_t axis = tensor_shape_info->shape_len - 1; axis >= 0; axis--) {
+                    onnx_data_shape_index[axis]++;
+                    if (onnx_data_shape_index[axis] == tensor_shape_info->shape[axis]) {
+                        if (axis == 0)
+                            break;
+
+                        onnx_data_shape_index[axis] = 0;
+                        continue;
+                    } else {
+                        break;
+                    }
+                }
+
+                if (onnx_data_shape_index[0] == tensor_shape_info->shape[0]) {
+                    break;
+                }
+            }
+            break;
+        }
+    }
+
+FUNC_OUT:
+    if (NULL != onnx_data_shape_index)
+        free(onnx_data_shape_index);
+
+    return status;
+}
@@ -0,0 +1,20 @@
+/**
+ * @file        reference_onnx_to_npu_data.h
+ * @brief       frozen copy of the ONNX to NPU data conversion of helper_functions.c before the plan and vector code
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include "kp_struct.h"
+
+/**
+ * @brief Former helper_convert_onnx_data_to_npu_data(): onnx_data_buf is quantized in place, *npu_data_buf is realloc'ed.
+ *
+ * @return KP_SUCCESS if converted.
+ */
+int reference_convert_onnx_data_to_npu_data(kp_tensor_descriptor_t *tensor_descriptor, float *onnx_data_buf, int32_t onnx_data_buf_size,
+                                            int8_t **npu_data_buf, int32_t *npu_data_buf_size);
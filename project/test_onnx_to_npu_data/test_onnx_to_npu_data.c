@@ -0,0 +1,380 @@
+/**
+ * @file        test_onnx_to_npu_data.c
+ * @brief       byte-for-byte check of the ONNX to NPU data conversion against the former element-by-element code for every npu data layout
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helper_functions.h"
+#include "reference_onnx_to_npu_data.h"
+
+#define SHAPE_LEN 4
+
+typedef struct
+{
+    uint32_t layout;
+    const char *name;
+} layout_t;
+
+static const layout_t _layouts[] = {
+    {KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B, "4W4C8B"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B, "1W16C8B"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, "16W1C8B"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B, "8W1C16B"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL, "4W4C8BHL"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL, "1W16C8BHL"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL, "16W1C8BHL"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_RAW_8B, "RAW_8B"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B, "RAW_16B"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT, "RAW_FLOAT"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT, "1W16C8B_CH_COMPACT"},
+    {KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT, "1W16C8BHL_CH_COMPACT"},
+};
+
+/* BxCxHxW, odd sizes for the scalar tails, 1x32x96x96 is split into bands for 4 threads */
+static const int32_t _shapes[][SHAPE_LEN] = {
+    {1, 1, 1, 1}, {1, 3, 7, 13}, {1, 40, 1, 1}, {2, 5, 3, 9}, {1, 16, 33, 17}, {1, 35, 20, 31}, {1, 32, 96, 96},
+};
+
+static uint32_t _random_state = 0x2545f491;
+
+static int _failure_count = 0;
+
+/* uniform in [0, 1) */
+static float random_uniform()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return (float)(_random_state >> 8) / 16777216.f;
+}
+
+static int align(int value, int alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/* npu strides of a BxCxHxW tensor, the layouts interleaving channels are stored channel-last (HWC) */
+static void set_npu_strides(uint32_t layout, const int32_t *shape, uint32_t *stride_npu)
+{
+    int channel_size;
+    int width_size;
+
+    switch (layout)
+    {
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
+        width_size = align(shape[3], (KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B == layout) ? 8 : 16);
+        stride_npu[3] = 1;
+        stride_npu[2] = width_size;
+        stride_npu[1] = width_size * shape[2];
+        stride_npu[0] = stride_npu[1] * shape[1];
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+        // groups of 16 channels are placed by the conversion after the last group
+        stride_npu[1] = 1;
+        stride_npu[3] = 16;
+        stride_npu[2] = 16 * shape[3];
+        stride_npu[0] = stride_npu[2] * shape[2];
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+        // blocks of 4 pixels x 4 channels, 16 scalars as the high/low entries need
+        channel_size = align(shape[1], 4);
+        stride_npu[1] = 1;
+        stride_npu[3] = channel_size;
+        stride_npu[2] = channel_size * align(shape[3], 4);
+        stride_npu[0] = stride_npu[2] * shape[2];
+        break;
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+        channel_size = align(shape[1], 16);
+        stride_npu[1] = 1;
+        stride_npu[3] = channel_size;
+        stride_npu[2] = channel_size * shape[3];
+        stride_npu[0] = stride_npu[2] * shape[2];
+        break;
+    default:
+        stride_npu[3] = 1;
+        stride_npu[2] = shape[3];
+        stride_npu[1] = shape[3] * shape[2];
+        stride_npu[0] = stride_npu[1] * shape[1];
+        break;
+    }
+}
+
+/*
+ * Values are spread over the clip range of the layout, with some beyond it, exactly at the bounds and at ties (scale 1 makes
+ * x.5 exact after the quantization factor).
+ */
+static void fill_onnx_data(float *onnx_data, int size, const kp_quantized_fixed_point_descriptor_t *descriptors, int descriptor_count,
+                           int quantized_axis_stride, float max_value)
+{
+    for (int i = 0; i < size; i++)
+    {
+        const kp_quantized_fixed_point_descriptor_t *descriptor = &descriptors[(1 == descriptor_count) ? 0 : i / quantized_axis_stride];
+        float factor = powf(2, (float)descriptor->radix) * descriptor->scale.scale_float32;
+        float kind = random_uniform();
+        float value;
+
+        if (0.1f > kind)
+            value = floorf((random_uniform() * 2.f - 1.f) * max_value) + 0.5f;
+        else if (0.12f > kind)
+            value = (0.5f > random_uniform()) ? max_value : -max_value - 1.f;
+        else
+            value = (random_uniform() * 2.4f - 1.2f) * max_value;
+
+        onnx_data[i] = value / factor;
+    }
+}
+
+/*
+ * bytes of the tensor against the former code, the scalars of RAW_FLOAT not covered by the tensor ('covered' is 0) are left
+ * uninitialized by the former code and are zero now
+ */
+static void check_equal(const int8_t *result, const int8_t *expected, const uint8_t *covered, int size, const char *layout_name,
+                        const int32_t *shape, bool channel_last_onnx, int descriptor_count, int thread_count)
+{
+    for (int i = 0; i < size; i++)
+    {
+        int8_t expected_byte = ((NULL == covered) || covered[i]) ? expected[i] : 0;
+
+        if (result[i] != expected_byte)
+        {
+            printf("FAIL %s %dx%dx%dx%d %s %d descriptors threads %d: byte %d is %d, former code gives %d\n", layout_name,
+                   shape[0], shape[1], shape[2], shape[3], channel_last_onnx ? "onnx HWC" : "onnx CHW", descriptor_count, thread_count,
+                   i, result[i], expected_byte);
+            _failure_count++;
+            return;
+        }
+    }
+}
+
+/* bytes of the npu floats written for a RAW_FLOAT tensor */
+static uint8_t *raw_float_covered_bytes(const int32_t *shape, const uint32_t *stride_npu, int npu_data_size)
+{
+    uint8_t *covered = calloc(1, npu_data_size);
+
+    if (NULL == covered)
+        return NULL;
+
+    for (int b = 0; b < shape[0]; b++)
+        for (int c = 0; c < shape[1]; c++)
+            for (int h = 0; h < shape[2]; h++)
+                for (int w = 0; w < shape[3]; w++)
+                    memset(covered + (b * stride_npu[0] + c * stride_npu[1] + h * stride_npu[2] + w * stride_npu[3]) * sizeof(float), 1, sizeof(float));
+
+    return covered;
+}
+
+static int test_layout(const layout_t *layout, const int32_t *shape, bool channel_last_onnx, bool channel_wise)
+{
+    kp_quantized_fixed_point_descriptor_t descriptors[64];
+    uint32_t stride_onnx[SHAPE_LEN];
+    uint32_t stride_npu[SHAPE_LEN];
+    kp_tensor_descriptor_t tensor_descriptor;
+    kp_quantization_parameters_v1_t *quantization_parameters;
+    helper_onnx_to_npu_plan_t *plan = NULL;
+    float max_value = (layout->layout == KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT) ? 1000.f : 127.f;
+    int descriptor_count = channel_wise ? shape[1] : 1;
+    int onnx_data_size = shape[0] * shape[1] * shape[2] * shape[3];
+    int32_t npu_data_size = 0;
+    float *onnx_data = NULL;
+    float *former_onnx_data = NULL;
+    int8_t *npu_data = NULL;
+    int8_t *expected = NULL;
+    uint8_t *covered = NULL;
+    int8_t *converted = NULL;
+    int32_t converted_size = 0;
+    int status = -1;
+
+    switch (layout->layout)
+    {
+    case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+        max_value = 32766.f;
+        break;
+    default:
+        break;
+    }
+
+    if (channel_last_onnx)
+    {
+        stride_onnx[1] = 1;
+        stride_onnx[3] = shape[1];
+        stride_onnx[2] = shape[1] * shape[3];
+        stride_onnx[0] = stride_onnx[2] * shape[2];
+    }
+    else
+    {
+        stride_onnx[3] = 1;
+        stride_onnx[2] = shape[3];
+        stride_onnx[1] = shape[3] * shape[2];
+        stride_onnx[0] = stride_onnx[1] * shape[1];
+    }
+
+    set_npu_strides(layout->layout, shape, stride_npu);
+
+    for (int i = 0; i < descriptor_count; i++)
+    {
+        descriptors[i].radix = (int32_t)(random_uniform() * 8.f);
+        descriptors[i].scale_dtype = KP_DTYPE_FLOAT32;
+        descriptors[i].scale.scale_float32 = (0.5f > random_uniform()) ? 1.f : 0.5f + random_uniform();
+    }
+
+    memset(&tensor_descriptor, 0, sizeof(tensor_descriptor));
+    tensor_descriptor.data_layout = layout->layout;
+    tensor_descriptor.tensor_shape_info.version = KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2;
+    tensor_descriptor.tensor_shape_info.tensor_shape_info_data.v2.shape_len = SHAPE_LEN;
+    tensor_descriptor.tensor_shape_info.tensor_shape_info_data.v2.shape = (int32_t *)shape;
+    tensor_descriptor.tensor_shape_info.tensor_shape_info_data.v2.stride_onnx = stride_onnx;
+    tensor_descriptor.tensor_shape_info.tensor_shape_info_data.v2.stride_npu = stride_npu;
+
+    quantization_parameters = &tensor_descriptor.quantization_parameters.quantization_parameters_data.v1;
+    quantization_parameters->quantized_axis = 1;
+    quantization_parameters->quantized_fixed_point_descriptor_num = descriptor_count;
+    quantization_parameters->quantized_fixed_point_descriptor = descriptors;
+
+    onnx_data = malloc(sizeof(float) * onnx_data_size);
+    former_onnx_data = malloc(sizeof(float) * onnx_data_size);
+
+    if (!onnx_data || !former_onnx_data)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        goto out;
+    }
+
+    // channel-wise descriptors are consecutive onnx blocks along the channel axis, only with onnx CHW
+    fill_onnx_data(onnx_data, onnx_data_size, descriptors, descriptor_count, onnx_data_size / shape[1], max_value);
+
+    // the former code quantizes its input in place
+    memcpy(former_onnx_data, onnx_data, sizeof(float) * onnx_data_size);
+    if (KP_SUCCESS != reference_convert_onnx_data_to_npu_data(&tensor_descriptor, former_onnx_data, onnx_data_size, &expected, &npu_data_size))
+    {
+        printf("FAIL %s %dx%dx%dx%d: former conversion failed\n", layout->name, shape[0], shape[1], shape[2], shape[3]);
+        _failure_count++;
+        status = 0;
+        goto out;
+    }
+
+    npu_data = malloc(npu_data_size);
+    if (KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT == layout->layout)
+        covered = raw_float_covered_bytes(shape, stride_npu, npu_data_size);
+
+    if (!npu_data || ((KP_MODEL_TENSOR_DATA_LAYOUT_RAW_FLOAT == layout->layout) && !covered))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        goto out;
+    }
+
+    // former_onnx_data is reused as the untouched input
+    memcpy(former_onnx_data, onnx_data, sizeof(float) * onnx_data_size);
+
+    for (int thread_count = 1; thread_count <= 4; thread_count += 3)
+    {
+        plan = helper_create_onnx_to_npu_plan(&tensor_descriptor, thread_count);
+        if ((NULL == plan) || (npu_data_size != helper_get_onnx_to_npu_plan_npu_data_size(plan)))
+        {
+            printf("FAIL %s %dx%dx%dx%d: plan failed\n", layout->name, shape[0], shape[1], shape[2], shape[3]);
+            _failure_count++;
+            helper_release_onnx_to_npu_plan(plan);
+            continue;
+        }
+
+        memset(npu_data, 0xA5, npu_data_size);
+        if (KP_SUCCESS != helper_convert_onnx_data_to_npu_data_with_plan(plan, onnx_data, onnx_data_size, npu_data, npu_data_size))
+        {
+            printf("FAIL %s %dx%dx%dx%d: conversion failed\n", layout->name, shape[0], shape[1], shape[2], shape[3]);
+            _failure_count++;
+        }
+        else
+        {
+            check_equal(npu_data, expected, covered, npu_data_size, layout->name, shape, channel_last_onnx, descriptor_count, thread_count);
+        }
+
+        helper_release_onnx_to_npu_plan(plan);
+    }
+
+    // the one-shot conversion used by the examples
+    if ((KP_SUCCESS != helper_convert_onnx_data_to_npu_data(&tensor_descriptor, onnx_data, onnx_data_size, &converted, &converted_size)) ||
+        (npu_data_size != converted_size))
+    {
+        printf("FAIL %s %dx%dx%dx%d: helper_convert_onnx_data_to_npu_data() failed\n", layout->name, shape[0], shape[1], shape[2], shape[3]);
+        _failure_count++;
+    }
+    else
+    {
+        check_equal(converted, expected, covered, npu_data_size, layout->name, shape, channel_last_onnx, descriptor_count, 4);
+    }
+
+    // unlike the former code, the conversion leaves the onnx data as it is
+    if (0 != memcmp(onnx_data, former_onnx_data, sizeof(float) * onnx_data_size))
+    {
+        printf("FAIL %s %dx%dx%dx%d: onnx data is overwritten\n", layout->name, shape[0], shape[1], shape[2], shape[3]);
+        _failure_count++;
+    }
+
+    status = 0;
+
+out:
+    free(onnx_data);
+    free(former_onnx_data);
+    free(npu_data);
+    free(expected);
+    free(covered);
+    free(converted);
+
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    int test_count = 0;
+
+#if defined(EX_COMMON_NO_SIMD)
+    printf("helper_functions.c built without vector code, checking the scalar conversion against the former code\n");
+#else
+    printf("checking the vector ONNX to NPU data conversion of helper_functions.c against the former code\n");
+#endif
+
+    for (size_t l = 0; l < sizeof(_layouts) / sizeof(_layouts[0]); l++)
+    {
+        for (size_t s = 0; s < sizeof(_shapes) / sizeof(_shapes[0]); s++)
+        {
+            const int32_t *shape = _shapes[s];
+
+            // layer-wise and channel-wise quantization of onnx CHW data, layer-wise of onnx HWC data (the channel axis is contiguous)
+            if ((0 != test_layout(&_layouts[l], shape, false, false)) ||
+                ((1 == shape[0]) && (0 != test_layout(&_layouts[l], shape, false, true))) ||
+                (0 != test_layout(&_layouts[l], shape, true, false)))
+                return -1;
+
+            test_count += (1 == shape[0]) ? 3 : 2;
+        }
+    }
+
+    if (0 < _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("%d tensors of %d npu data layouts match the former code\n", test_count, (int)(sizeof(_layouts) / sizeof(_layouts[0])));
+
+    return 0;
+}
@@ -0,0 +1,542 @@
+/**
+ * @file        test_quantization_factor_table.c
+ * @brief       check of the reciprocal quantization factor table built at model loading against the per-element factor, with timing
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+/* get_quantization_parameters_factor() is static, kp_inference.c is built as part of this file */
+#include "../../src/kp_inference.c"
+
+#include <math.h>
+#include <time.h>
+
+#include "raw_output_builder.h"
+
+#define MIN_RADIX -15
+#define MAX_RADIX 15
+#define RADIX_COUNT (MAX_RADIX - MIN_RADIX + 1)
+#define CHANNEL_SIZE 8              // values of each channel in the synthetic per-channel nodes
+#define MAX_ULP_DIFF 2              // reciprocal then product (two roundings) against one division
+#define TIMING_LOOP 20
+
+static char _model_file_path[256] = "../../res/models/KL520/ssd_fd_lm/models_520.nef";
+
+static const int32_t _scale_dtypes[] = {
+    KP_DTYPE_INT8, KP_DTYPE_INT16, KP_DTYPE_INT32, KP_DTYPE_UINT8, KP_DTYPE_UINT16, KP_DTYPE_UINT32, KP_DTYPE_FLOAT32,
+};
+
+static const struct
+{
+    const char *name;
+    uint32_t data_layout;
+} _timing_layouts[] = {
+    {"16W1C8B", KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B},
+    {"1W16C8B", KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B},
+    {"8W1C16B", KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B},
+    {"1W16C8BHL", KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL},
+};
+
+static uint32_t _random_state = 0x9e3779b9;
+
+static int _failure_count = 0;
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static uint32_t random_next()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return _random_state;
+}
+
+static int32_t get_ulp_diff(float a, float b)
+{
+    int32_t a_bits = 0;
+    int32_t b_bits = 0;
+
+    memcpy(&a_bits, &a, sizeof(float));
+    memcpy(&b_bits, &b, sizeof(float));
+
+    if ((0 > a_bits) != (0 > b_bits))
+        return (a == b) ? 0 : INT32_MAX;
+
+    return abs(a_bits - b_bits);
+}
+
+static void set_scale(kp_quantized_fixed_point_descriptor_t *descriptor, int32_t scale_dtype)
+{
+    uint32_t value = 1 + random_next() % 100;
+
+    descriptor->scale_dtype = scale_dtype;
+
+    switch (scale_dtype)
+    {
+    case KP_DTYPE_INT8:     descriptor->scale.scale_int8 = (int8_t)value; break;
+    case KP_DTYPE_INT16:    descriptor->scale.scale_int16 = (int16_t)(value * 300); break;
+    case KP_DTYPE_INT32:    descriptor->scale.scale_int32 = (int32_t)(value * 70001); break;
+    case KP_DTYPE_UINT8:    descriptor->scale.scale_uint8 = (uint8_t)(value * 2); break;
+    case KP_DTYPE_UINT16:   descriptor->scale.scale_uint16 = (uint16_t)(value * 600); break;
+    case KP_DTYPE_UINT32:   descriptor->scale.scale_uint32 = value * 3000017u; break;
+    default:                descriptor->scale.scale_float32 = (float)(random_next() % 100000) / 1000.0f + 0.001f; break;
+    }
+}
+
+/*
+ * walk every value of a node the way kp_generic_inference_retrieve_float_node() does, and check the table entry of each value
+ * against the factor get_quantization_parameters_factor() gives for it
+ */
+static void check_table_against_factor(const char *test, kp_quantization_parameters_v1_t *quantization_parameters_v1, bool is_channel_wise, uint32_t num_data, uint32_t quantized_axis_stride)
+{
+    int quantized_fixed_point_descriptor_idx = 0;
+    float quantization_factor = 0;
+
+    for (uint32_t offset = 0; offset < num_data; offset++)
+    {
+        uint32_t table_idx = is_channel_wise ? offset / quantized_axis_stride : 0;
+        float reciprocal_factor = 0;
+        float expected = 0;
+
+        if (KP_SUCCESS != get_quantization_parameters_factor(quantization_parameters_v1, is_channel_wise, offset, quantized_axis_stride,
+                                                             &quantized_fixed_point_descriptor_idx, &quantization_factor))
+        {
+            printf("FAIL %s: get_quantization_parameters_factor() failed\n", test);
+            _failure_count++;
+            return;
+        }
+
+        reciprocal_factor = quantization_parameters_v1->quantization_reciprocal_factor[table_idx];
+        expected = (float)1 / quantization_factor;
+
+        if (0 != memcmp(&reciprocal_factor, &expected, sizeof(float)))
+        {
+            printf("FAIL %s: value %u: table %.9g, 1 / factor %.9g\n", test, offset, reciprocal_factor, expected);
+            _failure_count++;
+            return;
+        }
+
+        /* dequantized values by the table against division by the factor, over the whole int16 range */
+        for (int32_t fixed_value = -32768; (0 == offset % quantized_axis_stride) && (fixed_value <= 32767); fixed_value += 7)
+        {
+            if (MAX_ULP_DIFF < get_ulp_diff((float)fixed_value * reciprocal_factor, (float)fixed_value / quantization_factor))
+            {
+                printf("FAIL %s: value %d: %.9g by table, %.9g by factor\n", test, fixed_value, (float)fixed_value * reciprocal_factor,
+                       (float)fixed_value / quantization_factor);
+                _failure_count++;
+                return;
+            }
+        }
+    }
+}
+
+/* the table of synthetic output nodes over every radix and scale data type, per-channel and per-tensor */
+static int test_synthetic_descriptors()
+{
+    kp_quantized_fixed_point_descriptor_t descriptors[RADIX_COUNT];
+    int32_t shape[4] = {1, RADIX_COUNT, 2, CHANNEL_SIZE / 2};
+    kp_tensor_descriptor_t output_node;
+    kp_single_model_descriptor_t single_model_desc;
+    kp_model_nef_descriptor_t model_desc;
+    kp_quantization_parameters_v1_t *quantization_parameters_v1 = &output_node.quantization_parameters.quantization_parameters_data.v1;
+    int test_count = 0;
+    char test[64];
+
+    memset(&single_model_desc, 0, sizeof(single_model_desc));
+    memset(&model_desc, 0, sizeof(model_desc));
+    single_model_desc.output_nodes_num = 1;
+    single_model_desc.output_nodes = &output_node;
+    model_desc.num_models = 1;
+    model_desc.models = &single_model_desc;
+
+    for (int dtype_idx = 0; dtype_idx < (int)(sizeof(_scale_dtypes) / sizeof(_scale_dtypes[0])); dtype_idx++)
+    {
+        for (int per_channel = 0; per_channel <= 1; per_channel++)
+        {
+            for (int radix = MIN_RADIX; radix <= MAX_RADIX; radix++)
+            {
+                /* per-channel: one node with every radix, per-tensor: one node for each radix */
+                if (per_channel && (MIN_RADIX != radix))
+                    break;
+
+                memset(&output_node, 0, sizeof(output_node));
+                output_node.tensor_shape_info.version = KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2;
+                output_node.tensor_shape_info.tensor_shape_info_data.v2.shape_len = 4;
+                output_node.tensor_shape_info.tensor_shape_info_data.v2.shape = shape;
+                output_node.quantization_parameters.version = KP_MODEL_QUANTIZATION_PARAMS_VERSION_1;
+                quantization_parameters_v1->quantized_axis = 1;
+                quantization_parameters_v1->quantized_fixed_point_descriptor_num = per_channel ? RADIX_COUNT : 1;
+                quantization_parameters_v1->quantized_fixed_point_descriptor = descriptors;
+
+                for (int i = 0; i < RADIX_COUNT; i++)
+                {
+                    descriptors[i].radix = per_channel ? MIN_RADIX + i : radix;
+                    set_scale(&descriptors[i], _scale_dtypes[dtype_idx]);
+                }
+
+                snprintf(test, sizeof(test), "scale dtype %d %s radix %d", _scale_dtypes[dtype_idx], per_channel ? "per-channel" : "per-tensor", radix);
+
+                if ((KP_SUCCESS != construct_model_des_quantization_reciprocal_factor(&model_desc)) ||
+                    (NULL == quantization_parameters_v1->quantization_reciprocal_factor))
+                {
+                    printf("FAIL %s: construct_model_des_quantization_reciprocal_factor() failed\n", test);
+                    _failure_count++;
+                    return -1;
+                }
+
+                check_table_against_factor(test, quantization_parameters_v1, per_channel, RADIX_COUNT * CHANNEL_SIZE, CHANNEL_SIZE);
+
+                free(quantization_parameters_v1->quantization_reciprocal_factor);
+                test_count++;
+            }
+        }
+    }
+
+    printf("%d synthetic output nodes: reciprocal factor table matches get_quantization_parameters_factor()\n", test_count);
+
+    return 0;
+}
+
+/* every output node of a real NEF has its table after loading */
+static int test_nef()
+{
+    kp_metadata_t metadata;
+    kp_nef_info_t nef_info;
+    kp_model_nef_descriptor_t model_desc;
+    int node_count = 0;
+    int nef_size = 0;
+    FILE *file = fopen(_model_file_path, "rb");
+    char *nef_buf = NULL;
+
+    if (NULL == file)
+    {
+        printf("FAIL read NEF %s\n", _model_file_path);
+        _failure_count++;
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    nef_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    nef_buf = malloc(nef_size);
+    if ((NULL == nef_buf) || (nef_size != (int)fread(nef_buf, 1, nef_size, file)))
+    {
+        printf("FAIL read NEF %s\n", _model_file_path);
+        _failure_count++;
+        fclose(file);
+        free(nef_buf);
+        return -1;
+    }
+
+    fclose(file);
+
+    memset(&model_desc, 0, sizeof(model_desc));
+
+    if (KP_SUCCESS != load_model_info_from_nef(nef_buf, nef_size, KP_DEVICE_KL520, &metadata, &nef_info, &model_desc))
+    {
+        printf("FAIL load_model_info_from_nef() of %s\n", _model_file_path);
+        _failure_count++;
+        free(nef_buf);
+        return -1;
+    }
+
+    for (uint32_t model_idx = 0; model_idx < model_desc.num_models; model_idx++)
+    {
+        kp_single_model_descriptor_t *single_model_desc = &model_desc.models[model_idx];
+
+        for (uint32_t node_idx = 0; node_idx < single_model_desc->output_nodes_num; node_idx++)
+        {
+            kp_tensor_descriptor_t *output_node = &single_model_desc->output_nodes[node_idx];
+            kp_quantization_parameters_v1_t *quantization_parameters_v1 = &output_node->quantization_parameters.quantization_parameters_data.v1;
+            uint32_t num_data = 0;
+            uint32_t shape_len = 0;
+            char test[64];
+
+            snprintf(test, sizeof(test), "NEF model %u node %u", single_model_desc->id, node_idx);
+
+            if ((NULL == quantization_parameters_v1->quantization_reciprocal_factor) ||
+                (KP_SUCCESS != get_tensor_descriptor_data_size(output_node, &num_data, &shape_len)))
+            {
+                printf("FAIL %s: no reciprocal factor table\n", test);
+                _failure_count++;
+                continue;
+            }
+
+            bool is_channel_wise = (1 < quantization_parameters_v1->quantized_fixed_point_descriptor_num);
+            check_table_against_factor(test, quantization_parameters_v1, is_channel_wise, num_data,
+                                       is_channel_wise ? num_data / quantization_parameters_v1->quantized_fixed_point_descriptor_num : num_data);
+            node_count++;
+        }
+    }
+
+    kp_release_model_nef_descriptor(&model_desc);
+    free(nef_buf);
+
+    printf("%d output nodes of %s: reciprocal factor table matches get_quantization_parameters_factor()\n", node_count, _model_file_path);
+
+    return 0;
+}
+
+/* model output node with the same quantization parameters as a node built by raw_output_build() */
+static int make_output_node(uint32_t product_id, const raw_output_node_spec_t *node_spec, uint32_t index, kp_tensor_descriptor_t *output_node,
+                            kp_quantized_fixed_point_descriptor_t *descriptors)
+{
+    uint32_t quantization_parameters_len = raw_output_get_quantization_parameters_len(product_id, node_spec);
+    kp_quantization_parameters_v1_t *quantization_parameters_v1 = &output_node->quantization_parameters.quantization_parameters_data.v1;
+    kp_single_model_descriptor_t single_model_desc;
+    kp_model_nef_descriptor_t model_desc;
+
+    memset(output_node, 0, sizeof(kp_tensor_descriptor_t));
+    output_node->index = index;
+    output_node->data_layout = node_spec->data_layout;
+    output_node->tensor_shape_info.version = KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2;
+    output_node->tensor_shape_info.tensor_shape_info_data.v2.shape_len = node_spec->shape_len;
+    output_node->tensor_shape_info.tensor_shape_info_data.v2.shape = (int32_t *)node_spec->shape;
+    output_node->quantization_parameters.version = KP_MODEL_QUANTIZATION_PARAMS_VERSION_1;
+    quantization_parameters_v1->quantized_axis = node_spec->channel_axis;
+    quantization_parameters_v1->quantized_fixed_point_descriptor_num = quantization_parameters_len;
+    quantization_parameters_v1->quantized_fixed_point_descriptor = descriptors;
+
+    for (uint32_t i = 0; i < quantization_parameters_len; i++)
+    {
+        descriptors[i].radix = node_spec->radix[i];
+        descriptors[i].scale_dtype = KP_DTYPE_FLOAT32;
+        descriptors[i].scale.scale_float32 = node_spec->scale[i];
+    }
+
+    memset(&single_model_desc, 0, sizeof(single_model_desc));
+    memset(&model_desc, 0, sizeof(model_desc));
+    single_model_desc.output_nodes_num = 1;
+    single_model_desc.output_nodes = output_node;
+    model_desc.num_models = 1;
+    model_desc.models = &single_model_desc;
+
+    return construct_model_des_quantization_reciprocal_factor(&model_desc);
+}
+
+/*
+ * per-channel KL730 nodes: values of the view with the table attached against kp_generic_inference_retrieve_float_node(),
+ * the arena with the model descriptor against the view, and timing of the three ways
+ */
+static int test_node_view_and_timing()
+{
+    int32_t radix[64];
+    float scale[64];
+    kp_quantized_fixed_point_descriptor_t descriptors[64];
+    kp_tensor_descriptor_t output_node;
+    kp_single_model_descriptor_t single_model_desc;
+    int ret = 0;
+
+    for (int i = 0; i < 64; i++)
+    {
+        radix[i] = (int32_t)(random_next() % 12) - 2;
+        scale[i] = (float)(random_next() % 2000) / 1000.0f + 0.25f;
+    }
+
+    for (int layout_idx = 0; layout_idx < (int)(sizeof(_timing_layouts) / sizeof(_timing_layouts[0])); layout_idx++)
+    {
+        raw_output_node_spec_t node_spec = {_timing_layouts[layout_idx].data_layout, 4, {1, 64, 80, 80}, 1, true, 0, 0, radix, scale};
+        uint32_t num_data = 64 * 80 * 80;
+        int32_t start[4] = {0, 0, 0, 0};
+        float *expected_values[1] = {NULL};
+        float *without_table = malloc(num_data * sizeof(float));
+        float *with_table = malloc(num_data * sizeof(float));
+        kp_inf_float_node_output_t *float_node = NULL;
+        kp_inf_float_node_output_list_t *list = NULL;
+        kp_inf_node_view_t node_view;
+        uint8_t *raw_out_buffer = raw_output_build(KP_DEVICE_KL730, &node_spec, 1, 1, expected_values, NULL);
+        double retrieve_time = 0, view_time = 0, table_time = 0, start_time = 0;
+        int32_t max_ulp_diff = 0;
+
+        memset(&output_node, 0, sizeof(output_node));
+
+        if ((NULL == raw_out_buffer) || (NULL == without_table) || (NULL == with_table) ||
+            (KP_SUCCESS != make_output_node(KP_DEVICE_KL730, &node_spec, 0, &output_node, descriptors)))
+        {
+            printf("FAIL %s: out of memory\n", _timing_layouts[layout_idx].name);
+            _failure_count++;
+            ret = -1;
+            goto NEXT;
+        }
+
+        for (int loop = 0; loop < TIMING_LOOP; loop++)
+        {
+            start_time = get_time_ms();
+            float_node = kp_generic_inference_retrieve_float_node(0, raw_out_buffer, KP_CHANNEL_ORDERING_DEFAULT);
+            retrieve_time += get_time_ms() - start_time;
+
+            if (NULL == float_node)
+                break;
+
+            if (TIMING_LOOP - 1 != loop)
+                kp_release_float_node_output(float_node);
+        }
+
+        start_time = get_time_ms();
+        for (int loop = 0; loop < TIMING_LOOP; loop++)
+        {
+            if ((KP_SUCCESS != kp_generic_inference_retrieve_node_view(0, raw_out_buffer, &node_view)) ||
+                (KP_SUCCESS != kp_inf_node_view_extract_float_region(&node_view, start, node_view.shape, without_table, num_data)))
+                break;
+        }
+        view_time = get_time_ms() - start_time;
+
+        start_time = get_time_ms();
+        for (int loop = 0; loop < TIMING_LOOP; loop++)
+        {
+            if ((KP_SUCCESS != kp_generic_inference_retrieve_node_view(0, raw_out_buffer, &node_view)) ||
+                (KP_SUCCESS != kp_inf_node_view_attach_model_output_node(&node_view, &output_node)) ||
+                (KP_SUCCESS != kp_inf_node_view_extract_float_region(&node_view, start, node_view.shape, with_table, num_data)))
+                break;
+        }
+        table_time = get_time_ms() - start_time;
+
+        if ((NULL == float_node) || (NULL == node_view.quantization_reciprocal_factor))
+        {
+            printf("FAIL %s: retrieval failed\n", _timing_layouts[layout_idx].name);
+            _failure_count++;
+            goto NEXT;
+        }
+
+        if ((0 != memcmp(float_node->data, expected_values[0], num_data * sizeof(float))) ||
+            (0 != memcmp(without_table, float_node->data, num_data * sizeof(float))))
+        {
+            printf("FAIL %s: view without table differs from kp_generic_inference_retrieve_float_node()\n", _timing_layouts[layout_idx].name);
+            _failure_count++;
+        }
+
+        for (uint32_t i = 0; i < num_data; i++)
+        {
+            int32_t ulp_diff = get_ulp_diff(with_table[i], float_node->data[i]);
+            if (ulp_diff > max_ulp_diff)
+                max_ulp_diff = ulp_diff;
+        }
+
+        if (MAX_ULP_DIFF < max_ulp_diff)
+        {
+            printf("FAIL %s: view with table differs from kp_generic_inference_retrieve_float_node() by %d ulp\n", _timing_layouts[layout_idx].name, max_ulp_diff);
+            _failure_count++;
+        }
+
+        /* the arena with the model descriptor converts each node the same way as the attached view */
+        memset(&single_model_desc, 0, sizeof(single_model_desc));
+        single_model_desc.output_nodes_num = 1;
+        single_model_desc.output_nodes = &output_node;
+
+        if ((KP_SUCCESS != kp_generic_inference_retrieve_float_node_list(raw_out_buffer, KP_CHANNEL_ORDERING_DEFAULT, &single_model_desc, NULL, 0, &list)) ||
+            (0 != memcmp(list->node_output[0]->data, with_table, num_data * sizeof(float))))
+        {
+            printf("FAIL %s: arena with model descriptor differs from the view with table\n", _timing_layouts[layout_idx].name);
+            _failure_count++;
+        }
+
+        printf("%-9s 1x64x80x80 per-channel: retrieve_float_node %.3f ms, view %.3f ms, view with table %.3f ms (max %d ulp)\n",
+               _timing_layouts[layout_idx].name, retrieve_time / TIMING_LOOP, view_time / TIMING_LOOP, table_time / TIMING_LOOP, max_ulp_diff);
+
+NEXT:
+        kp_release_float_node_output_list(list);
+        kp_release_float_node_output(float_node);
+        free(output_node.quantization_parameters.quantization_parameters_data.v1.quantization_reciprocal_factor);
+        free(expected_values[0]);
+        free(without_table);
+        free(with_table);
+        free(raw_out_buffer);
+    }
+
+    return ret;
+}
+
+/* a table of another node is not attached */
+static void test_attach_mismatch()
+{
+    int32_t radix[4] = {1, 2, 3, 4};
+    float scale[4] = {1.0f, 0.5f, 0.25f, 2.0f};
+    raw_output_node_spec_t node_spec = {KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8B, 4, {1, 4, 3, 3}, 1, true, 0, 0, radix, scale};
+    kp_quantized_fixed_point_descriptor_t descriptors[4];
+    kp_tensor_descriptor_t output_node;
+    kp_inf_node_view_t node_view;
+    uint8_t *raw_out_buffer = raw_output_build(KP_DEVICE_KL730, &node_spec, 1, 1, NULL, NULL);
+    float *table = NULL;
+
+    if ((NULL == raw_out_buffer) ||
+        (KP_SUCCESS != make_output_node(KP_DEVICE_KL730, &node_spec, 0, &output_node, descriptors)) ||
+        (KP_SUCCESS != kp_generic_inference_retrieve_node_view(0, raw_out_buffer, &node_view)))
+    {
+        printf("FAIL attach: setup failed\n");
+        _failure_count++;
+        free(raw_out_buffer);
+        return;
+    }
+
+    table = output_node.quantization_parameters.quantization_parameters_data.v1.quantization_reciprocal_factor;
+
+    output_node.index = 1;
+    if (KP_SUCCESS == kp_inf_node_view_attach_model_output_node(&node_view, &output_node))
+    {
+        printf("FAIL attach: node of another index is attached\n");
+        _failure_count++;
+    }
+
+    output_node.index = 0;
+    output_node.quantization_parameters.quantization_parameters_data.v1.quantized_fixed_point_descriptor_num = 1;
+    if (KP_SUCCESS == kp_inf_node_view_attach_model_output_node(&node_view, &output_node))
+    {
+        printf("FAIL attach: node of another quantization parameters count is attached\n");
+        _failure_count++;
+    }
+
+    output_node.quantization_parameters.quantization_parameters_data.v1.quantized_fixed_point_descriptor_num = 4;
+    output_node.quantization_parameters.quantization_parameters_data.v1.quantization_reciprocal_factor = NULL;
+    if (KP_SUCCESS == kp_inf_node_view_attach_model_output_node(&node_view, &output_node))
+    {
+        printf("FAIL attach: node without table is attached\n");
+        _failure_count++;
+    }
+
+    output_node.quantization_parameters.quantization_parameters_data.v1.quantization_reciprocal_factor = table;
+    if ((KP_SUCCESS != kp_inf_node_view_attach_model_output_node(&node_view, &output_node)) ||
+        (table != node_view.quantization_reciprocal_factor))
+    {
+        printf("FAIL attach: matching node is not attached\n");
+        _failure_count++;
+    }
+
+    free(table);
+    free(raw_out_buffer);
+}
+
+int main(int argc, char *argv[])
+{
+    if (2 <= argc)
+        strncpy(_model_file_path, argv[1], sizeof(_model_file_path) - 1);
+
+    test_synthetic_descriptors();
+    test_nef();
+    test_attach_mismatch();
+
+    if (0 != _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("\n");
+
+    if ((0 != test_node_view_and_timing()) || (0 != _failure_count))
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    return 0;
+}
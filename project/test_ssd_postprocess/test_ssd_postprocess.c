@@ -0,0 +1,784 @@
+/**
+ * @file        test_ssd_postprocess.c
+ * @brief       hand-built frames, check against a plain decoder and per-frame timing of the SSD face detection and 5-point landmark post-processing
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "postprocess.h"
+#include "kp_core.h"
+#include "internal_func.h"
+
+#define HEAD_COUNT 4
+#define ANCHOR_COUNT 2
+#define LOGIT_COUNT 3               // background, face, masked face
+#define MODEL_INPUT_SIZE 200
+#define RANDOM_FRAME_COUNT 300
+#define FD_MODEL_ID 32                      // KNERON_FD_MASK_MBSSD_200_200_3
+#define LANDMARK_MODEL_ID 5                 // KNERON_LM_5PTS_ONET_56_56_3
+#define MAX_CANDIDATES (ANCHOR_COUNT * (3 * 3 + 6 * 6 + 12 * 12 + 25 * 25) * (LOGIT_COUNT - 1))
+
+/* output nodes of KNERON_FD_MASK_MBSSD_200_200_3 (model ID 32 of res/models/KL520/ssd_fd_lm), heads of post_process_ssd_fd_mask_descriptor() */
+static const int _grid_sizes[HEAD_COUNT] = {3, 6, 12, 25};
+
+static char _model_file_path[256] = "../../res/models/KL520/ssd_fd_lm/models_520.nef";
+
+static uint32_t _random_state = 0x3c6ef372;
+
+static int _failure_count = 0;
+
+static kp_bounding_box_t _candidates[MAX_CANDIDATES];
+static kp_bounding_box_t _class_boxes[MAX_CANDIDATES];
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static float random_uniform()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return ((float)(_random_state >> 8) + 1.0f) / (float)((1 << 24) + 1);
+}
+
+static float random_gauss()
+{
+    float u = random_uniform();
+    float v = random_uniform();
+
+    return sqrtf(-2 * logf(u)) * cosf(6.2831853f * v);
+}
+
+static kp_inf_float_node_output_t *make_node(int channel, int height, int width)
+{
+    uint32_t num_data = (uint32_t)channel * height * width;
+    kp_inf_float_node_output_t *node = calloc(1, sizeof(kp_inf_float_node_output_t) + num_data * sizeof(float));
+
+    if (NULL == node)
+        return NULL;
+
+    node->shape = malloc(4 * sizeof(int32_t));
+    if (NULL == node->shape)
+    {
+        free(node);
+        return NULL;
+    }
+
+    node->name = "";
+    node->shape_len = 4;
+    node->shape[0] = 1;
+    node->shape[1] = channel;
+    node->shape[2] = height;
+    node->shape[3] = width;
+    node->num_data = num_data;
+
+    return node;
+}
+
+static void free_nodes(kp_inf_float_node_output_t *node_output[], int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (NULL != node_output[i])
+            free(node_output[i]->shape);
+        free(node_output[i]);
+    }
+}
+
+/* confidence and location nodes of every head in CHW */
+static int make_ssd_nodes(kp_inf_float_node_output_t *node_output[])
+{
+    for (int i = 0; i < HEAD_COUNT; i++)
+    {
+        node_output[2 * i] = make_node(ANCHOR_COUNT * LOGIT_COUNT, _grid_sizes[i], _grid_sizes[i]);
+        node_output[2 * i + 1] = make_node(ANCHOR_COUNT * 4, _grid_sizes[i], _grid_sizes[i]);
+
+        if ((NULL == node_output[2 * i]) || (NULL == node_output[2 * i + 1]))
+            return -1;
+    }
+
+    return 0;
+}
+
+/* CHW value of a node */
+static float *node_value(kp_inf_float_node_output_t *node, int channel, int row, int col)
+{
+    return &node->data[(channel * node->shape[2] + row) * node->shape[3] + col];
+}
+
+/* a frame without faces: every prior box is background with a logit of 5 and has no location deltas */
+static void clear_frame(kp_inf_float_node_output_t *node_output[])
+{
+    for (int i = 0; i < HEAD_COUNT; i++)
+    {
+        kp_inf_float_node_output_t *conf = node_output[2 * i];
+
+        memset(conf->data, 0, conf->num_data * sizeof(float));
+        memset(node_output[2 * i + 1]->data, 0, node_output[2 * i + 1]->num_data * sizeof(float));
+
+        for (int an = 0; an < ANCHOR_COUNT; an++)
+        {
+            for (int row = 0; row < _grid_sizes[i]; row++)
+            {
+                for (int col = 0; col < _grid_sizes[i]; col++)
+                    *node_value(conf, an * LOGIT_COUNT, row, col) = 5;
+            }
+        }
+    }
+}
+
+/* logits and location deltas of one prior box */
+static void set_prior(kp_inf_float_node_output_t *node_output[], int head, int row, int col, int anchor, const float logits[LOGIT_COUNT],
+                      const float deltas[4])
+{
+    for (int j = 0; j < LOGIT_COUNT; j++)
+        *node_value(node_output[2 * head], anchor * LOGIT_COUNT + j, row, col) = logits[j];
+
+    for (int j = 0; j < 4; j++)
+        *node_value(node_output[2 * head + 1], anchor * 4 + j, row, col) = deltas[j];
+}
+
+static void check_boxes(const char *test, kp_yolo_result_t *result, const kp_bounding_box_t *expected, int expected_count)
+{
+    if ((int)result->box_count != expected_count)
+    {
+        printf("FAIL %s: %u boxes, expected %d\n", test, result->box_count, expected_count);
+        _failure_count++;
+        return;
+    }
+
+    for (int i = 0; i < expected_count; i++)
+    {
+        kp_bounding_box_t *box = &result->boxes[i];
+
+        if ((box->x1 != expected[i].x1) || (box->y1 != expected[i].y1) || (box->x2 != expected[i].x2) || (box->y2 != expected[i].y2) ||
+            (box->class_num != expected[i].class_num) || (fabsf(box->score - expected[i].score) > 1e-5f))
+        {
+            printf("FAIL %s: box %d is (%g, %g, %g, %g) score %.6f class %d, expected (%g, %g, %g, %g) score %.6f class %d\n", test, i,
+                   box->x1, box->y1, box->x2, box->y2, box->score, box->class_num,
+                   expected[i].x1, expected[i].y1, expected[i].x2, expected[i].y2, expected[i].score, expected[i].class_num);
+            _failure_count++;
+            return;
+        }
+    }
+}
+
+/* NPU shape (B x C x H x W) of a node of the NEF */
+static int32_t *get_node_shape(kp_tensor_descriptor_t *node, uint32_t *shape_len)
+{
+    if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1 == node->tensor_shape_info.version)
+    {
+        *shape_len = node->tensor_shape_info.tensor_shape_info_data.v1.shape_npu_len;
+        return node->tensor_shape_info.tensor_shape_info_data.v1.shape_npu;
+    }
+
+    *shape_len = node->tensor_shape_info.tensor_shape_info_data.v2.shape_len;
+    return node->tensor_shape_info.tensor_shape_info_data.v2.shape;
+}
+
+static void check_node_shape(kp_single_model_descriptor_t *model, uint32_t node_idx, int channel, int height, int width)
+{
+    uint32_t shape_len = 0;
+    int32_t *shape = get_node_shape(&model->output_nodes[node_idx], &shape_len);
+
+    if ((4 != shape_len) || (1 != shape[0]) || (channel != shape[1]) || (height != shape[2]) || (width != shape[3]))
+    {
+        printf("FAIL NEF model %u node %u: shape is not 1 x %d x %d x %d\n", model->id, node_idx, channel, height, width);
+        _failure_count++;
+    }
+}
+
+/*
+ * the output nodes of the models in the NEF have the layout of post_process_ssd_fd_mask_descriptor() and post_process_face_landmark();
+ * the NEF has no prior box sizes or variances, they are not checked
+ */
+static int test_nef_node_layout()
+{
+    const post_process_ssd_descriptor_t *descriptor = post_process_ssd_fd_mask_descriptor();
+    kp_metadata_t metadata;
+    kp_nef_info_t nef_info;
+    kp_model_nef_descriptor_t model_desc;
+    int checked_model_count = 0;
+    int nef_size = 0;
+    FILE *file = fopen(_model_file_path, "rb");
+    char *nef_buf = NULL;
+
+    if (NULL == file)
+    {
+        printf("FAIL read NEF %s\n", _model_file_path);
+        _failure_count++;
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    nef_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    nef_buf = malloc(nef_size);
+    if ((NULL == nef_buf) || (nef_size != (int)fread(nef_buf, 1, nef_size, file)))
+    {
+        printf("FAIL read NEF %s\n", _model_file_path);
+        _failure_count++;
+        fclose(file);
+        free(nef_buf);
+        return -1;
+    }
+
+    fclose(file);
+
+    memset(&model_desc, 0, sizeof(model_desc));
+
+    if (KP_SUCCESS != load_model_info_from_nef(nef_buf, nef_size, KP_DEVICE_KL520, &metadata, &nef_info, &model_desc))
+    {
+        printf("FAIL load_model_info_from_nef() of %s\n", _model_file_path);
+        _failure_count++;
+        free(nef_buf);
+        return -1;
+    }
+
+    for (uint32_t model_idx = 0; model_idx < model_desc.num_models; model_idx++)
+    {
+        kp_single_model_descriptor_t *model = &model_desc.models[model_idx];
+
+        if (FD_MODEL_ID == model->id)
+        {
+            uint32_t shape_len = 0;
+            int32_t *input_shape = get_node_shape(&model->input_nodes[0], &shape_len);
+
+            if ((1 != model->input_nodes_num) || (4 != shape_len) || (MODEL_INPUT_SIZE != input_shape[2]) || (MODEL_INPUT_SIZE != input_shape[3]))
+            {
+                printf("FAIL NEF model %u: input is not %d x %d\n", model->id, MODEL_INPUT_SIZE, MODEL_INPUT_SIZE);
+                _failure_count++;
+            }
+
+            if ((HEAD_COUNT != descriptor->head_count) || (2 * HEAD_COUNT != (int)model->output_nodes_num))
+            {
+                printf("FAIL NEF model %u: %u output nodes, the descriptor has %d heads\n", model->id, model->output_nodes_num, descriptor->head_count);
+                _failure_count++;
+                continue;
+            }
+
+            for (int i = 0; i < HEAD_COUNT; i++)
+            {
+                int anchor_count = descriptor->heads[i].anchor_count;
+
+                check_node_shape(model, 2 * i, anchor_count * LOGIT_COUNT, _grid_sizes[i], _grid_sizes[i]);
+                check_node_shape(model, 2 * i + 1, anchor_count * 4, _grid_sizes[i], _grid_sizes[i]);
+            }
+
+            checked_model_count++;
+        }
+        else if (LANDMARK_MODEL_ID == model->id)
+        {
+            if (2 != model->output_nodes_num)
+            {
+                printf("FAIL NEF model %u: %u output nodes, expected 2\n", model->id, model->output_nodes_num);
+                _failure_count++;
+                continue;
+            }
+
+            check_node_shape(model, 0, 2, 1, 1);
+            check_node_shape(model, 1, 2 * LAND_MARK_POINTS, 1, 1);
+
+            checked_model_count++;
+        }
+    }
+
+    kp_release_model_nef_descriptor(&model_desc);
+    free(nef_buf);
+
+    if (2 != checked_model_count)
+    {
+        printf("FAIL NEF %s: models %d and %d not found\n", _model_file_path, FD_MODEL_ID, LANDMARK_MODEL_ID);
+        _failure_count++;
+        return -1;
+    }
+
+    printf("output nodes of models %d and %d in %s match the descriptor heads and the landmark nodes\n", FD_MODEL_ID, LANDMARK_MODEL_ID,
+           _model_file_path);
+
+    return 0;
+}
+
+/*
+ * hand-built frames whose results are worked out from the prior boxes of the descriptor: a prior box of size s at cell (row, col) of a g x g head
+ * is centered at ((col + 0.5) * 200 / g, (row + 0.5) * 200 / g) of the model input; the prior box sizes are the unverified ones
+ * of post_process_ssd_fd_mask_descriptor(), so these check the decoding arithmetic, not the boxes of the real model
+ */
+static int test_hand_built_frames(post_process_yolo_context_t *context)
+{
+    const post_process_ssd_descriptor_t *descriptor = post_process_ssd_fd_mask_descriptor();
+    kp_inf_float_node_output_t *node_output[2 * HEAD_COUNT] = {NULL};
+    kp_hw_pre_proc_info_t pre_proc_info;
+    kp_yolo_result_t *result = malloc(sizeof(kp_yolo_result_t));
+    static const float no_delta[4] = {0, 0, 0, 0};
+
+    if ((NULL == result) || (0 != make_ssd_nodes(node_output)))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        free_nodes(node_output, 2 * HEAD_COUNT);
+        free(result);
+        return -1;
+    }
+
+    memset(&pre_proc_info, 0, sizeof(pre_proc_info));
+    pre_proc_info.img_width = pre_proc_info.resized_img_width = pre_proc_info.model_input_width = MODEL_INPUT_SIZE;
+    pre_proc_info.img_height = pre_proc_info.resized_img_height = pre_proc_info.model_input_height = MODEL_INPUT_SIZE;
+
+    // no face: background logit 5 gives faces a score of 1 / (e^5 + 2)
+    clear_frame(node_output);
+    post_process_ssd_with_context(context, descriptor, node_output, 2 * HEAD_COUNT, &pre_proc_info, NULL, 0.5f, result);
+    check_boxes("background", result, NULL, 0);
+
+    // a face of score e^3 / (e^3 + 2) on the 32x32 prior box of cell (5, 6) of the 12x12 head, centered at (108.33, 91.67)
+    {
+        static const float logits[LOGIT_COUNT] = {0, 3, 0};
+        static const kp_bounding_box_t expected[] = {{92, 76, 124, 108, 0.909443f, 0}};
+
+        set_prior(node_output, 2, 5, 6, 1, logits, no_delta);
+        post_process_ssd_with_context(context, descriptor, node_output, 2 * HEAD_COUNT, &pre_proc_info, NULL, 0.5f, result);
+        check_boxes("one face", result, expected, 1);
+    }
+
+    // the 24x24 prior box of the same cell has IoU 576 / 1024 with the face and is suppressed, a masked face on the 25x25 head is kept
+    {
+        static const float face_logits[LOGIT_COUNT] = {0, 2, 0};
+        static const float mask_logits[LOGIT_COUNT] = {-1, 0, 4};
+        static const float mask_deltas[4] = {5, 5, 0, 0};
+        static const kp_bounding_box_t expected[] = {{92, 76, 124, 108, 0.909443f, 0}, {180, 164, 196, 180, 0.975559f, 1}};
+
+        set_prior(node_output, 2, 5, 6, 0, face_logits, no_delta);
+        // the 16x16 prior box of cell (20, 22) is centered at (180, 164), moved by 5 * 0.1 * 16 to the right and down
+        set_prior(node_output, 3, 20, 22, 1, mask_logits, mask_deltas);
+        post_process_ssd_with_context(context, descriptor, node_output, 2 * HEAD_COUNT, &pre_proc_info, NULL, 0.5f, result);
+        check_boxes("face and masked face", result, expected, 2);
+
+        // the suppressed face is output by a higher IoU threshold, after the better one
+        post_process_ssd_descriptor_t loose_descriptor = *descriptor;
+        static const kp_bounding_box_t loose_expected[] = {{92, 76, 124, 108, 0.909443f, 0}, {96, 80, 120, 104, 0.786986f, 0},
+                                                           {180, 164, 196, 180, 0.975559f, 1}};
+
+        loose_descriptor.nms_thresh = 0.6;
+        post_process_ssd_with_context(context, &loose_descriptor, node_output, 2 * HEAD_COUNT, &pre_proc_info, NULL, 0.5f, result);
+        check_boxes("NMS threshold 0.6", result, loose_expected, 3);
+    }
+
+    // a 640x480 image letterboxed to 200x150 with 25 rows padding on top, boxes are scaled by 3.2 and clipped to the image
+    {
+        static const float logits[LOGIT_COUNT] = {0, 3, 0};
+        static const float deltas[4] = {0, 0, 2.5f, 2.5f};
+        static const kp_bounding_box_t expected[] = {{0, 0, 639, 479, 0.909443f, 0}, {295, 162, 398, 265, 0.909443f, 0},
+                                                     {576, 445, 627, 479, 0.975559f, 1}};
+
+        pre_proc_info.img_width = 640;
+        pre_proc_info.img_height = 480;
+        pre_proc_info.resized_img_height = 150;
+        pre_proc_info.pad_top = 25;
+        pre_proc_info.pad_bottom = 25;
+
+        // a 128 * e^0.5 prior box at the center of the 3x3 head covers the whole image, it comes first of the equal scores by its x1
+        set_prior(node_output, 0, 1, 1, 1, logits, deltas);
+        post_process_ssd_with_context(context, descriptor, node_output, 2 * HEAD_COUNT, &pre_proc_info, NULL, 0.5f, result);
+        check_boxes("letterbox", result, expected, 3);
+    }
+
+    free_nodes(node_output, 2 * HEAD_COUNT);
+    free(result);
+
+    return 0;
+}
+
+static int test_landmark_hand_built()
+{
+    kp_inf_float_node_output_t *node_output[2] = {make_node(2, 1, 1), make_node(2 * LAND_MARK_POINTS, 1, 1)};
+    kp_bounding_box_t face_box = {100, 50, 200, 170, 0.9f, 1};
+    kp_landmark_result_t landmark;
+    static const uint32_t expected[LAND_MARK_POINTS][2] = {{100, 62}, {120, 86}, {140, 110}, {160, 134}, {180, 158}};
+
+    if ((NULL == node_output[0]) || (NULL == node_output[1]))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        free_nodes(node_output, 2);
+        return -1;
+    }
+
+    // points (0.0, 0.1), (0.2, 0.3) ... of a 100x120 box, the face score is 1 / (1 + e^-3)
+    node_output[0]->data[0] = -1;
+    node_output[0]->data[1] = 2;
+    for (int i = 0; i < 2 * LAND_MARK_POINTS; i++)
+        node_output[1]->data[i] = 0.1f * i;
+
+    if (0 != post_process_face_landmark(node_output, 2, &face_box, &landmark))
+    {
+        printf("FAIL landmark: post_process_face_landmark() failed\n");
+        _failure_count++;
+    }
+    else
+    {
+        for (int i = 0; i < LAND_MARK_POINTS; i++)
+        {
+            if ((landmark.marks[i].x != expected[i][0]) || (landmark.marks[i].y != expected[i][1]))
+            {
+                printf("FAIL landmark: point %d is (%u, %u), expected (%u, %u)\n", i, landmark.marks[i].x, landmark.marks[i].y,
+                       expected[i][0], expected[i][1]);
+                _failure_count++;
+            }
+        }
+
+        if ((fabsf(landmark.score - 0.952574f) > 1e-5f) || (1 != landmark.class_num))
+        {
+            printf("FAIL landmark: score %.6f class %d, expected 0.952574 class 1\n", landmark.score, landmark.class_num);
+            _failure_count++;
+        }
+    }
+
+    free_nodes(node_output, 2);
+
+    return 0;
+}
+
+static int reference_box_comparator(const void *box_1, const void *box_2)
+{
+    const kp_bounding_box_t *a = (const kp_bounding_box_t *)box_1;
+    const kp_bounding_box_t *b = (const kp_bounding_box_t *)box_2;
+
+    if (a->score != b->score)
+        return (a->score > b->score) ? -1 : 1;
+    if (a->x1 != b->x1)
+        return (a->x1 < b->x1) ? -1 : 1;
+    if (a->y1 != b->y1)
+        return (a->y1 < b->y1) ? -1 : 1;
+    if (a->x2 != b->x2)
+        return (a->x2 < b->x2) ? -1 : 1;
+    if (a->y2 != b->y2)
+        return (a->y2 < b->y2) ? -1 : 1;
+
+    return 0;
+}
+
+static float reference_iou(const kp_bounding_box_t *a, const kp_bounding_box_t *b)
+{
+    float w = ((a->x2 < b->x2) ? a->x2 : b->x2) - ((a->x1 > b->x1) ? a->x1 : b->x1);
+    float h = ((a->y2 < b->y2) ? a->y2 : b->y2) - ((a->y1 > b->y1) ? a->y1 : b->y1);
+    float inter = (w < 0 || h < 0) ? 0 : w * h;
+
+    return inter / ((a->y2 - a->y1) * (a->x2 - a->x1) + (b->y2 - b->y1) * (b->x2 - b->x1) - inter);
+}
+
+/* straightforward SSD decoding of CHW nodes: softmax and box of every prior box, then sort and pairwise NMS of every class */
+static void reference_ssd(const post_process_ssd_descriptor_t *descriptor, kp_inf_float_node_output_t *node_output[], kp_hw_pre_proc_info_t *pre_proc_info,
+                          float thresh_value, kp_yolo_result_t *result)
+{
+    float scale_x = (float)pre_proc_info->img_width / pre_proc_info->resized_img_width;
+    float scale_y = (float)pre_proc_info->img_height / pre_proc_info->resized_img_height;
+    int candidate_count = 0;
+    int box_count = 0;
+
+    for (int i = 0; i < descriptor->head_count; i++)
+    {
+        kp_inf_float_node_output_t *conf = node_output[2 * i];
+        kp_inf_float_node_output_t *loc = node_output[2 * i + 1];
+        int grid = conf->shape[2];
+        float step_w = (float)pre_proc_info->model_input_width / grid;
+        float step_h = (float)pre_proc_info->model_input_height / grid;
+
+        for (int row = 0; row < grid; row++)
+        {
+            for (int col = 0; col < grid; col++)
+            {
+                for (int an = 0; an < descriptor->heads[i].anchor_count; an++)
+                {
+                    float logits[LOGIT_COUNT];
+                    float max_logit = -INFINITY;
+                    float exp_sum = 0;
+
+                    for (int j = 0; j < LOGIT_COUNT; j++)
+                    {
+                        logits[j] = *node_value(conf, an * LOGIT_COUNT + j, row, col);
+                        if (logits[j] > max_logit)
+                            max_logit = logits[j];
+                    }
+
+                    for (int j = 0; j < LOGIT_COUNT; j++)
+                        exp_sum += expf(logits[j] - max_logit);
+
+                    for (int j = 1; j < LOGIT_COUNT; j++)
+                    {
+                        float score = expf(logits[j] - max_logit) / exp_sum;
+                        if (score < thresh_value)
+                            continue;
+
+                        float prior_size = descriptor->heads[i].min_sizes[an];
+                        float box_x = (col + 0.5f) * step_w + *node_value(loc, an * 4, row, col) * descriptor->center_variance * prior_size;
+                        float box_y = (row + 0.5f) * step_h + *node_value(loc, an * 4 + 1, row, col) * descriptor->center_variance * prior_size;
+                        float box_w = prior_size * expf(*node_value(loc, an * 4 + 2, row, col) * descriptor->size_variance);
+                        float box_h = prior_size * expf(*node_value(loc, an * 4 + 3, row, col) * descriptor->size_variance);
+                        kp_bounding_box_t *box = &_candidates[candidate_count++];
+
+                        box->x1 = box_x - (box_w / 2);
+                        box->y1 = box_y - (box_h / 2);
+                        box->x2 = box_x + (box_w / 2);
+                        box->y2 = box_y + (box_h / 2);
+                        box->score = score;
+                        box->class_num = j - 1;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int c = 0; c < LOGIT_COUNT - 1; c++)
+    {
+        int class_box_count = 0;
+        int class_result_count = 0;
+
+        for (int i = 0; i < candidate_count; i++)
+        {
+            if (_candidates[i].class_num == c)
+                _class_boxes[class_box_count++] = _candidates[i];
+        }
+
+        qsort(_class_boxes, class_box_count, sizeof(kp_bounding_box_t), reference_box_comparator);
+
+        for (int j = 0; j < class_box_count; j++)
+        {
+            if (_class_boxes[j].score == 0)
+                continue;
+
+            for (int k = j + 1; k < class_box_count; k++)
+            {
+                if (reference_iou(&_class_boxes[j], &_class_boxes[k]) > descriptor->nms_thresh)
+                    _class_boxes[k].score = 0;
+            }
+        }
+
+        for (int j = 0; (j < class_box_count) && (box_count < YOLO_GOOD_BOX_MAX); j++)
+        {
+            kp_bounding_box_t *box = &_class_boxes[j];
+            kp_bounding_box_t *dst = &result->boxes[box_count];
+
+            if (box->score <= 0)
+                continue;
+
+            // to the image: remove padding, scale, round and clip
+            float x1 = (box->x1 - pre_proc_info->pad_left) * scale_x;
+            float y1 = (box->y1 - pre_proc_info->pad_top) * scale_y;
+            float x2 = x1 + (box->x2 - box->x1) * scale_x;
+            float y2 = y1 + (box->y2 - box->y1) * scale_y;
+            int max_x = (int)pre_proc_info->img_width - 1;
+            int max_y = (int)pre_proc_info->img_height - 1;
+
+            dst->x1 = ((int)(x1 + 0.5) > 0) ? (int)(x1 + 0.5) : 0;
+            dst->y1 = ((int)(y1 + 0.5) > 0) ? (int)(y1 + 0.5) : 0;
+            dst->x2 = ((int)(x2 + 0.5) < max_x) ? (int)(x2 + 0.5) : max_x;
+            dst->y2 = ((int)(y2 + 0.5) < max_y) ? (int)(y2 + 0.5) : max_y;
+            dst->score = box->score;
+            dst->class_num = box->class_num;
+            box_count++;
+
+            if (++class_result_count == descriptor->max_detection_per_class)
+                break;
+        }
+    }
+
+    result->box_count = box_count;
+    result->class_count = LOGIT_COUNT - 1;
+}
+
+/* HWC copy of CHW nodes */
+static int to_hwc(kp_inf_float_node_output_t *node_output[], kp_inf_float_node_output_t *hwc_output[], int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int channel = node_output[i]->shape[1];
+        int height = node_output[i]->shape[2];
+        int width = node_output[i]->shape[3];
+
+        hwc_output[i] = make_node(channel, height, width);
+        if (NULL == hwc_output[i])
+            return -1;
+
+        for (int c = 0; c < channel; c++)
+        {
+            for (int k = 0; k < height * width; k++)
+                hwc_output[i]->data[k * channel + c] = node_output[i]->data[c * height * width + k];
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * random frames as the model outputs them: mostly background with faces in one frame out of three,
+ * the decoder has to give the boxes of the reference in the same order for CHW and HWC nodes
+ */
+static int test_random_frames(post_process_yolo_context_t *context)
+{
+    const post_process_ssd_descriptor_t *descriptor = post_process_ssd_fd_mask_descriptor();
+    post_process_ssd_descriptor_t hwc_descriptor = *descriptor;
+    kp_inf_float_node_output_t *node_output[2 * HEAD_COUNT] = {NULL};
+    kp_inf_float_node_output_t *hwc_output[2 * HEAD_COUNT] = {NULL};
+    kp_yolo_result_t *result = malloc(sizeof(kp_yolo_result_t));
+    kp_yolo_result_t *expected = malloc(sizeof(kp_yolo_result_t));
+    kp_hw_pre_proc_info_t pre_proc_info;
+    double reference_ms = 0, decoder_ms = 0, sparse_reference_ms = 0, sparse_decoder_ms = 0;
+    int box_count = 0, sparse_frame_count = 0;
+    int ret = -1;
+
+    if ((NULL == result) || (NULL == expected) || (0 != make_ssd_nodes(node_output)))
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        goto FUNC_OUT;
+    }
+
+    hwc_descriptor.channel_ordering = KP_CHANNEL_ORDERING_HWC;
+
+    memset(&pre_proc_info, 0, sizeof(pre_proc_info));
+    pre_proc_info.img_width = 640;
+    pre_proc_info.img_height = 480;
+    pre_proc_info.resized_img_width = MODEL_INPUT_SIZE;
+    pre_proc_info.resized_img_height = 150;
+    pre_proc_info.pad_top = 25;
+    pre_proc_info.pad_bottom = 25;
+    pre_proc_info.model_input_width = MODEL_INPUT_SIZE;
+    pre_proc_info.model_input_height = MODEL_INPUT_SIZE;
+
+    for (int frame = 0; frame < RANDOM_FRAME_COUNT; frame++)
+    {
+        bool sparse = (0 != frame % 3);
+        float thresh_value = 0.3f + 0.15f * (frame % 4);
+
+        for (int i = 0; i < 2 * HEAD_COUNT; i++)
+        {
+            float sigma = (0 == i % 2) ? 2.0f : 0.7f;
+
+            for (uint32_t k = 0; k < node_output[i]->num_data; k++)
+                node_output[i]->data[k] = random_gauss() * sigma;
+        }
+
+        // background logits of sparse frames are 5 higher, except for a few prior boxes
+        for (int i = 0; sparse && (i < HEAD_COUNT); i++)
+        {
+            for (int an = 0; an < ANCHOR_COUNT; an++)
+            {
+                for (int row = 0; row < _grid_sizes[i]; row++)
+                {
+                    for (int col = 0; col < _grid_sizes[i]; col++)
+                        *node_value(node_output[2 * i], an * LOGIT_COUNT, row, col) += (random_uniform() < 0.02f) ? -3.0f : 5.0f;
+                }
+            }
+        }
+
+        double begin = get_time_ms();
+        reference_ssd(descriptor, node_output, &pre_proc_info, thresh_value, expected);
+        double middle = get_time_ms();
+        int status = post_process_ssd_with_context(context, descriptor, node_output, 2 * HEAD_COUNT, &pre_proc_info, NULL, thresh_value, result);
+        double end = get_time_ms();
+
+        reference_ms += middle - begin;
+        decoder_ms += end - middle;
+        box_count += expected->box_count;
+        if (sparse)
+        {
+            sparse_reference_ms += middle - begin;
+            sparse_decoder_ms += end - middle;
+            sparse_frame_count++;
+        }
+
+        if ((0 != status) || (result->box_count != expected->box_count) ||
+            (0 != memcmp(result->boxes, expected->boxes, expected->box_count * sizeof(kp_bounding_box_t))))
+        {
+            printf("FAIL random frame %d threshold %.2f: %u boxes differ from the %u boxes of the reference\n", frame, thresh_value,
+                   result->box_count, expected->box_count);
+            _failure_count++;
+            continue;
+        }
+
+        // HWC nodes of every fourth frame
+        if (0 == frame % 4)
+        {
+            if (0 != to_hwc(node_output, hwc_output, 2 * HEAD_COUNT))
+            {
+                printf("Error! %s(): out of memory\n", __FUNCTION__);
+                goto FUNC_OUT;
+            }
+
+            status = post_process_ssd_with_context(context, &hwc_descriptor, hwc_output, 2 * HEAD_COUNT, &pre_proc_info, NULL, thresh_value, result);
+            free_nodes(hwc_output, 2 * HEAD_COUNT);
+            memset(hwc_output, 0, sizeof(hwc_output));
+
+            if ((0 != status) || (result->box_count != expected->box_count) ||
+                (0 != memcmp(result->boxes, expected->boxes, expected->box_count * sizeof(kp_bounding_box_t))))
+            {
+                printf("FAIL random frame %d threshold %.2f: HWC nodes give %u boxes, the reference %u\n", frame, thresh_value,
+                       result->box_count, expected->box_count);
+                _failure_count++;
+            }
+        }
+    }
+
+    printf("%d random frames, %d boxes\n", RANDOM_FRAME_COUNT, box_count);
+    printf("per frame: reference %.3f ms, decoder %.3f ms (frames with faces and background)\n", reference_ms / RANDOM_FRAME_COUNT,
+           decoder_ms / RANDOM_FRAME_COUNT);
+    printf("per frame: reference %.3f ms, decoder %.3f ms (mostly background frames)\n", sparse_reference_ms / sparse_frame_count,
+           sparse_decoder_ms / sparse_frame_count);
+
+    ret = 0;
+
+FUNC_OUT:
+    free_nodes(node_output, 2 * HEAD_COUNT);
+    free_nodes(hwc_output, 2 * HEAD_COUNT);
+    free(result);
+    free(expected);
+
+    return ret;
+}
+
+int main(int argc, char *argv[])
+{
+    post_process_yolo_context_t *context = NULL;
+
+    if (argc > 1)
+        snprintf(_model_file_path, sizeof(_model_file_path), "%s", argv[1]);
+
+    context = post_process_yolo_create_context();
+
+    if (NULL == context)
+    {
+        printf("Error! %s(): out of memory\n", __FUNCTION__);
+        return -1;
+    }
+
+    if ((0 != test_nef_node_layout()) || (0 != test_hand_built_frames(context)) || (0 != test_landmark_hand_built()) ||
+        (0 != test_random_frames(context)))
+    {
+        post_process_yolo_release_context(context);
+        return -1;
+    }
+
+    post_process_yolo_release_context(context);
+
+    if (0 < _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("SSD face detection and landmark results match the worked-out results and the reference\n");
+
+    return 0;
+}
@@ -0,0 +1,371 @@
+/**
+ * @file        test_tiled_inference.c
+ * @brief       check of tiled_inference_run() on a stub device group: tile pixels, boxes in image coordinates, and the tiles sent
+ *              and received when sending, receiving or decoding fails
+ *
+ * kp_generic_image_inference_send() and kp_generic_image_inference_receive() are replaced by a stub device group (GNU linker
+ * --wrap) holding up to STUB_QUEUE_DEPTH results per device, a send blocks while the devices are full as it does on USB.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "kp_inference.h"
+#include "tiled_inference.h"
+
+#define IMAGE_WIDTH 1920
+#define IMAGE_HEIGHT 1080
+#define MODEL_INPUT_SIZE 416
+#define TILE_OVERLAP 64
+#define STUB_DEVICE_COUNT 2
+#define STUB_QUEUE_DEPTH 2
+#define STUB_MAX_PENDING (STUB_DEVICE_COUNT * STUB_QUEUE_DEPTH)
+#define BOX_OFFSET 8                        // a box of a tile starts at this offset from the tile origin
+#define BOX_SIZE 16
+
+/* stub device group, tiles are "inferred" in the order they are sent */
+static struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int sent_count;
+    int received_count;
+    uint32_t inference_numbers[TILED_INFERENCE_MAX_TILE];
+    int fail_send_at;                       // tile whose send fails, -1 for none
+    int fail_receive_at;                    // tile whose receive fails
+    int wrong_tile_at;                      // tile whose result has another inference number
+    int fail_decode_at;                     // tile whose decoding fails
+
+    /* expected tiles of the image */
+    const uint8_t *image;
+    int bytes_per_pixel;
+    kp_inf_crop_box_t tiles[TILED_INFERENCE_MAX_TILE];
+    int tile_count;
+    int pixel_error_count;
+} _stub = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+static int _failure_count = 0;
+
+#define CHECK(condition, ...)                                   \
+    do                                                          \
+    {                                                           \
+        if (!(condition))                                       \
+        {                                                       \
+            printf("FAIL line %d: ", __LINE__);                 \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            _failure_count++;                                   \
+        }                                                       \
+    } while (0)
+
+int __wrap_kp_generic_image_inference_send(kp_device_group_t devices, kp_generic_image_inference_desc_t *inf_data)
+{
+    kp_generic_input_node_image_t *input_node = &inf_data->input_node_image_list[0];
+    struct timespec deadline;
+    int ret = KP_SUCCESS;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 2;
+
+    pthread_mutex_lock(&_stub.mutex);
+
+    // the devices are full, a timeout if no result is received
+    while ((_stub.sent_count - _stub.received_count >= STUB_MAX_PENDING) && (KP_SUCCESS == ret))
+    {
+        if (ETIMEDOUT == pthread_cond_timedwait(&_stub.cond, &_stub.mutex, &deadline))
+            ret = KP_ERROR_USB_TIMEOUT_N7;
+    }
+
+    if ((KP_SUCCESS == ret) && (_stub.sent_count == _stub.fail_send_at))
+        ret = KP_ERROR_SEND_DATA_FAIL_14;
+
+    if (KP_SUCCESS == ret)
+    {
+        const kp_inf_crop_box_t *tile = &_stub.tiles[_stub.sent_count];
+        size_t row_size = (size_t)tile->width * _stub.bytes_per_pixel;
+
+        // the pixels sent are the pixels of the tile
+        if ((inf_data->inference_number != (uint32_t)_stub.sent_count) || (input_node->width != tile->width) ||
+            (input_node->height != tile->height))
+        {
+            _stub.pixel_error_count++;
+        }
+        else
+        {
+            for (uint32_t row = 0; row < tile->height; row++)
+            {
+                const uint8_t *src = _stub.image + ((size_t)(tile->y1 + row) * IMAGE_WIDTH + tile->x1) * _stub.bytes_per_pixel;
+
+                if (0 != memcmp(input_node->image_buffer + row_size * row, src, row_size))
+                {
+                    _stub.pixel_error_count++;
+                    break;
+                }
+            }
+        }
+
+        _stub.inference_numbers[_stub.sent_count++] = inf_data->inference_number;
+        pthread_cond_broadcast(&_stub.cond);
+    }
+
+    pthread_mutex_unlock(&_stub.mutex);
+
+    return ret;
+}
+
+int __wrap_kp_generic_image_inference_receive(kp_device_group_t devices, kp_generic_image_inference_result_header_t *output_desc,
+                                              uint8_t *raw_out_buffer, uint32_t buf_size)
+{
+    struct timespec deadline;
+    const kp_inf_crop_box_t *tile;
+    int tile_index;
+    int ret = KP_SUCCESS;
+
+    // nothing sent is a timeout, as the devices do not answer
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 2;
+
+    pthread_mutex_lock(&_stub.mutex);
+
+    while (_stub.sent_count == _stub.received_count)
+    {
+        if (ETIMEDOUT == pthread_cond_timedwait(&_stub.cond, &_stub.mutex, &deadline))
+        {
+            pthread_mutex_unlock(&_stub.mutex);
+            return KP_ERROR_USB_TIMEOUT_N7;
+        }
+    }
+
+    tile_index = _stub.received_count;
+
+    if (tile_index == _stub.fail_receive_at)
+    {
+        ret = KP_ERROR_RECV_DESC_FAIL_16;
+        goto out;
+    }
+
+    tile = &_stub.tiles[tile_index];
+
+    memset(output_desc, 0, sizeof(kp_generic_image_inference_result_header_t));
+    output_desc->inference_number = _stub.inference_numbers[tile_index] + ((tile_index == _stub.wrong_tile_at) ? 1 : 0);
+    output_desc->num_pre_proc_info = 1;
+    output_desc->pre_proc_info[0].img_width = tile->width;
+    output_desc->pre_proc_info[0].img_height = tile->height;
+    output_desc->pre_proc_info[0].resized_img_width = MODEL_INPUT_SIZE;
+    output_desc->pre_proc_info[0].resized_img_height = MODEL_INPUT_SIZE;
+    output_desc->pre_proc_info[0].model_input_width = MODEL_INPUT_SIZE;
+    output_desc->pre_proc_info[0].model_input_height = MODEL_INPUT_SIZE;
+
+    // the raw output of a tile is its index
+    memcpy(raw_out_buffer, &tile_index, sizeof(tile_index));
+
+    _stub.received_count++;
+    pthread_cond_broadcast(&_stub.cond);
+
+out:
+    pthread_mutex_unlock(&_stub.mutex);
+
+    return ret;
+}
+
+/* one box per tile, at a fixed offset from the tile origin, a later tile has a higher score */
+static int decode_tile(void *user_data, uint8_t *raw_output_buf, kp_generic_image_inference_result_header_t *output_desc,
+                       const post_process_box_transform_t *box_transform, kp_yolo_result_t *result)
+{
+    int tile_index;
+
+    memcpy(&tile_index, raw_output_buf, sizeof(tile_index));
+
+    if (tile_index == _stub.fail_decode_at)
+        return KP_ERROR_INVALID_MODEL_21;
+
+    result->class_count = 1;
+    result->box_count = 1;
+    result->boxes[0].x1 = (float)(box_transform->origin_x + BOX_OFFSET);
+    result->boxes[0].y1 = (float)(box_transform->origin_y + BOX_OFFSET);
+    result->boxes[0].x2 = result->boxes[0].x1 + BOX_SIZE;
+    result->boxes[0].y2 = result->boxes[0].y1 + BOX_SIZE;
+    result->boxes[0].score = 0.5f + 0.001f * tile_index;
+    result->boxes[0].class_num = 0;
+
+    return KP_SUCCESS;
+}
+
+static void reset_stub(const uint8_t *image, int bytes_per_pixel)
+{
+    pthread_mutex_lock(&_stub.mutex);
+    _stub.sent_count = 0;
+    _stub.received_count = 0;
+    _stub.fail_send_at = -1;
+    _stub.fail_receive_at = -1;
+    _stub.wrong_tile_at = -1;
+    _stub.fail_decode_at = -1;
+    _stub.image = image;
+    _stub.bytes_per_pixel = bytes_per_pixel;
+    _stub.pixel_error_count = 0;
+    pthread_mutex_unlock(&_stub.mutex);
+}
+
+/* a run without errors: every tile is sent with its pixels and one box of each tile is mapped to the image */
+static void check_run(tiled_inference_t *tiled, const uint8_t *image, kp_image_format_t format, int bytes_per_pixel, const char *name)
+{
+    static kp_yolo_result_t result;
+    int tile_count = 0;
+    int ret;
+
+    reset_stub(image, bytes_per_pixel);
+    memset(&result, 0, sizeof(result));
+
+    ret = tiled_inference_run(tiled, image, IMAGE_WIDTH, IMAGE_HEIGHT, format, &result, &tile_count);
+
+    CHECK((KP_SUCCESS == ret) && (_stub.tile_count == tile_count) && (_stub.tile_count == _stub.sent_count) &&
+          (_stub.sent_count == _stub.received_count) && (0 == _stub.pixel_error_count),
+          "%s run: error %d, %d tiles received, %d sent, %d pixel errors", name, ret, tile_count, _stub.sent_count, _stub.pixel_error_count);
+
+    if ((KP_SUCCESS != ret) || ((uint32_t)_stub.tile_count != result.box_count))
+    {
+        printf("FAIL %s run: %u boxes of %d tiles\n", name, result.box_count, _stub.tile_count);
+        _failure_count++;
+        return;
+    }
+
+    // boxes from the highest score, the last tile first
+    for (int i = 0; i < _stub.tile_count; i++)
+    {
+        const kp_inf_crop_box_t *tile = &_stub.tiles[_stub.tile_count - 1 - i];
+        const kp_bounding_box_t *box = &result.boxes[i];
+
+        CHECK((box->x1 == tile->x1 + BOX_OFFSET) && (box->y1 == tile->y1 + BOX_OFFSET) && (box->x2 == box->x1 + BOX_SIZE) &&
+              (box->y2 == box->y1 + BOX_SIZE), "%s run: box %d at (%.0f, %.0f) for tile at (%u, %u)", name, i, box->x1, box->y1,
+              tile->x1, tile->y1);
+    }
+}
+
+/*
+ * a failure at tile 'at': sending stops within the tiles the devices can hold, the tiles sent are received (drained) unless
+ * the receive failed, and the next run is not disturbed
+ */
+static void check_failure(tiled_inference_t *tiled, const uint8_t *image, const char *name, int at, int *fail_field, int expected_ret)
+{
+    static kp_yolo_result_t result;
+    int tile_count = 0;
+    int ret;
+    bool receive_failed = (fail_field == &_stub.fail_receive_at);
+    bool send_failed = (fail_field == &_stub.fail_send_at);
+
+    reset_stub(image, 2);
+    *fail_field = at;
+
+    ret = tiled_inference_run(tiled, image, IMAGE_WIDTH, IMAGE_HEIGHT, KP_IMAGE_FORMAT_RGB565, &result, &tile_count);
+
+    CHECK(expected_ret == ret, "%s at tile %d: error %d, expected %d", name, at, ret, expected_ret);
+
+    if (send_failed)
+    {
+        // tiles before the failed one are sent and all of them are received
+        CHECK((at == _stub.sent_count) && (at == _stub.received_count) && (at == tile_count),
+              "%s at tile %d: %d sent, %d received", name, at, _stub.sent_count, _stub.received_count);
+    }
+    else
+    {
+        // the tiles sent before the error is seen are at most the tiles the devices hold after the failed one
+        CHECK(_stub.sent_count <= at + 1 + STUB_MAX_PENDING, "%s at tile %d: %d tiles sent", name, at, _stub.sent_count);
+
+        if (receive_failed)
+            CHECK(at == _stub.received_count, "%s at tile %d: %d received", name, at, _stub.received_count);
+        else
+            CHECK((_stub.sent_count == _stub.received_count) && (_stub.received_count == tile_count),
+                  "%s at tile %d: %d sent, %d received, %d reported", name, at, _stub.sent_count, _stub.received_count, tile_count);
+    }
+
+    // tiles left on the devices by a failed receive are dropped by the stub, otherwise nothing is left to disturb the next run
+    check_run(tiled, image, KP_IMAGE_FORMAT_RGB565, 2, name);
+}
+
+int main(int argc, char *argv[])
+{
+    kp_device_group_s device_group;
+    kp_single_model_descriptor_t model;
+    kp_tensor_descriptor_t input_node;
+    int32_t shape[4] = {1, 3, MODEL_INPUT_SIZE, MODEL_INPUT_SIZE};
+    tiled_inference_config_t config;
+    tiled_inference_t *tiled;
+    uint8_t *image = malloc((size_t)IMAGE_WIDTH * IMAGE_HEIGHT * 4);
+    const int fail_tiles[] = {0, 3, -1};    // -1 is the last tile
+
+    if (NULL == image)
+        return -1;
+
+    for (size_t i = 0; i < (size_t)IMAGE_WIDTH * IMAGE_HEIGHT * 4; i++)
+        image[i] = (uint8_t)(i * 2654435761u >> 24);
+
+    memset(&device_group, 0, sizeof(device_group));
+    device_group.num_device = STUB_DEVICE_COUNT;
+
+    memset(&input_node, 0, sizeof(input_node));
+    input_node.tensor_shape_info.version = KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2;
+    input_node.tensor_shape_info.tensor_shape_info_data.v2.shape_len = 4;
+    input_node.tensor_shape_info.tensor_shape_info_data.v2.shape = shape;
+
+    memset(&model, 0, sizeof(model));
+    model.id = 19;
+    model.input_nodes_num = 1;
+    model.input_nodes = &input_node;
+    model.max_raw_out_size = 64;
+
+    memset(&config, 0, sizeof(config));
+    config.overlap = TILE_OVERLAP;
+    config.merge_policy = TILED_INFERENCE_MERGE_NMS;
+    config.merge_threshold = 0.5f;
+    config.decode = decode_tile;
+
+    _stub.tile_count = tiled_inference_layout(IMAGE_WIDTH, IMAGE_HEIGHT, MODEL_INPUT_SIZE, MODEL_INPUT_SIZE, TILE_OVERLAP, _stub.tiles,
+                                              TILED_INFERENCE_MAX_TILE);
+    tiled = tiled_inference_create(&device_group, &model, &config);
+
+    if ((NULL == tiled) || (STUB_MAX_PENDING + 2 > _stub.tile_count))
+    {
+        printf("FAIL tiled_inference_create() or tiled_inference_layout() failed\n");
+        free(image);
+        tiled_inference_release(tiled);
+        return -1;
+    }
+
+    check_run(tiled, image, KP_IMAGE_FORMAT_RGB565, 2, "RGB565");
+    check_run(tiled, image, KP_IMAGE_FORMAT_RAW8, 1, "RAW8");
+    check_run(tiled, image, KP_IMAGE_FORMAT_RGBA8888, 4, "RGBA8888");
+
+    for (int i = 0; i < (int)(sizeof(fail_tiles) / sizeof(fail_tiles[0])); i++)
+    {
+        int at = (0 <= fail_tiles[i]) ? fail_tiles[i] : _stub.tile_count - 1;
+
+        check_failure(tiled, image, "decode error", at, &_stub.fail_decode_at, KP_ERROR_INVALID_MODEL_21);
+        check_failure(tiled, image, "wrong tile", at, &_stub.wrong_tile_at, KP_ERROR_RECV_DATA_FAIL_17);
+        check_failure(tiled, image, "send error", at, &_stub.fail_send_at, KP_ERROR_SEND_DATA_FAIL_14);
+        check_failure(tiled, image, "receive error", at, &_stub.fail_receive_at, KP_ERROR_RECV_DESC_FAIL_16);
+    }
+
+    tiled_inference_release(tiled);
+    free(image);
+
+    if (0 < _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("%d tiles on %d stub devices: pixels, boxes, and sending and draining on send, receive and decode errors are right\n",
+           _stub.tile_count, STUB_DEVICE_COUNT);
+
+    return 0;
+}
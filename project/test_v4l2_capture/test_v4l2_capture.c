@@ -0,0 +1,469 @@
+/**
+ * @file        test_v4l2_capture.c
+ * @brief       check of v4l2_capture with a file of raw frames and with a fake V4L2 driver fed from a file (mmap, dequeue, requeue)
+ *
+ * The fake driver replaces ioctl(), mmap(), munmap() and poll() of v4l2_capture.c for the opened device (/dev/null) by the
+ * --wrap options of the GNU linker, every other call goes to the system.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+
+#include "v4l2_capture.h"
+
+#define FRAME_WIDTH 64
+#define FRAME_HEIGHT 48
+#define FRAME_SIZE (FRAME_WIDTH * FRAME_HEIGHT * 2)     // YUYV
+#define FILE_FRAME_COUNT 5
+#define FAKE_MAX_BUFFER_COUNT 8
+
+int __real_ioctl(int fd, unsigned long request, ...);
+void *__real_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset);
+int __real_munmap(void *addr, size_t length);
+int __real_poll(struct pollfd *fds, nfds_t nfds, int timeout);
+
+/* fake V4L2 driver of one device, frames are read from a file of raw frames when a buffer is dequeued */
+static struct
+{
+    bool enabled;
+    int fd;                                     // the device fd seen by VIDIOC_QUERYCAP
+    FILE *frame_file;
+    int max_buffer_count;                       // buffers the driver grants at most
+    int width_adjust;                           // pixels VIDIOC_S_FMT takes off the requested width
+    int bytes_per_line_padding;                 // padding of each row set by VIDIOC_S_FMT
+    bool other_pixel_format;                    // VIDIOC_S_FMT gives YU12 whatever is requested
+    uint32_t error_sequence;                    // frame flagged with V4L2_BUF_FLAG_ERROR
+    uint32_t short_sequence;                    // frame with fewer bytes than a frame
+
+    int buffer_count;
+    uint8_t *buffers[FAKE_MAX_BUFFER_COUNT];
+    bool mapped[FAKE_MAX_BUFFER_COUNT];
+    int queue[FAKE_MAX_BUFFER_COUNT];           // queued buffers, in order
+    int queue_length;
+    bool streaming;
+    uint32_t sequence;
+    int qbuf_count;
+} _fake;
+
+static int _failure_count = 0;
+
+#define CHECK(condition, ...)                                   \
+    do                                                          \
+    {                                                           \
+        if (!(condition))                                       \
+        {                                                       \
+            printf("FAIL line %d: ", __LINE__);                 \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            _failure_count++;                                   \
+        }                                                       \
+    } while (0)
+
+static uint8_t frame_byte(uint32_t frame, uint32_t offset)
+{
+    return (uint8_t)(frame * 31 + offset * 7 + (offset >> 8));
+}
+
+/* a file of 'frame_count' frames and 'tail_size' bytes of a partial frame */
+static FILE *make_frame_file(const char *path, int frame_count, int tail_size)
+{
+    FILE *file = fopen(path, "w+b");
+
+    if (NULL == file)
+        return NULL;
+
+    for (int frame = 0; frame < frame_count; frame++)
+    {
+        for (uint32_t i = 0; i < FRAME_SIZE; i++)
+            fputc(frame_byte(frame, i), file);
+    }
+
+    for (int i = 0; i < tail_size; i++)
+        fputc(0xEE, file);
+
+    fflush(file);
+
+    return file;
+}
+
+static bool frame_matches(const uint8_t *data, uint32_t frame)
+{
+    for (uint32_t i = 0; i < FRAME_SIZE; i++)
+    {
+        if (data[i] != frame_byte(frame, i))
+            return false;
+    }
+
+    return true;
+}
+
+static int fake_ioctl(int fd, unsigned long request, void *arg)
+{
+    switch (request)
+    {
+    case VIDIOC_QUERYCAP:
+    {
+        struct v4l2_capability *cap = (struct v4l2_capability *)arg;
+
+        _fake.fd = fd;
+        cap->capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+        return 0;
+    }
+    case VIDIOC_S_FMT:
+    {
+        struct v4l2_pix_format *pix = &((struct v4l2_format *)arg)->fmt.pix;
+
+        pix->width -= _fake.width_adjust;
+        if (_fake.other_pixel_format)
+            pix->pixelformat = V4L2_PIX_FMT_YUV420;
+        pix->bytesperline = pix->width * 2 + _fake.bytes_per_line_padding;
+        pix->sizeimage = pix->bytesperline * pix->height;
+        return 0;
+    }
+    case VIDIOC_REQBUFS:
+    {
+        struct v4l2_requestbuffers *req = (struct v4l2_requestbuffers *)arg;
+
+        if (req->count > (uint32_t)_fake.max_buffer_count)
+            req->count = _fake.max_buffer_count;
+
+        _fake.buffer_count = req->count;
+        for (int i = 0; i < _fake.buffer_count; i++)
+            _fake.buffers[i] = malloc(FRAME_SIZE);
+        return 0;
+    }
+    case VIDIOC_QUERYBUF:
+    {
+        struct v4l2_buffer *buf = (struct v4l2_buffer *)arg;
+
+        buf->length = FRAME_SIZE;
+        buf->m.offset = buf->index * FRAME_SIZE;
+        return 0;
+    }
+    case VIDIOC_QBUF:
+    {
+        struct v4l2_buffer *buf = (struct v4l2_buffer *)arg;
+
+        for (int i = 0; i < _fake.queue_length; i++)
+        {
+            if (_fake.queue[i] == (int)buf->index)
+            {
+                errno = EINVAL;
+                return -1;
+            }
+        }
+
+        _fake.queue[_fake.queue_length++] = buf->index;
+        _fake.qbuf_count++;
+        return 0;
+    }
+    case VIDIOC_DQBUF:
+    {
+        struct v4l2_buffer *buf = (struct v4l2_buffer *)arg;
+        uint32_t frame = _fake.sequence % FILE_FRAME_COUNT;
+        int index;
+
+        if (!_fake.streaming || (0 == _fake.queue_length))
+        {
+            errno = EAGAIN;
+            return -1;
+        }
+
+        index = _fake.queue[0];
+        memmove(_fake.queue, _fake.queue + 1, (--_fake.queue_length) * sizeof(int));
+
+        // the camera fills the buffer
+        if ((0 != fseek(_fake.frame_file, (long)frame * FRAME_SIZE, SEEK_SET)) || (1 != fread(_fake.buffers[index], FRAME_SIZE, 1, _fake.frame_file)))
+        {
+            errno = EIO;
+            return -1;
+        }
+
+        buf->index = index;
+        buf->sequence = _fake.sequence;
+        buf->bytesused = (_fake.sequence == _fake.short_sequence) ? FRAME_SIZE / 2 : FRAME_SIZE;
+        buf->flags = (_fake.sequence == _fake.error_sequence) ? V4L2_BUF_FLAG_ERROR : 0;
+        buf->timestamp.tv_sec = 100 + _fake.sequence;
+        buf->timestamp.tv_usec = 250;
+        _fake.sequence++;
+        return 0;
+    }
+    case VIDIOC_STREAMON:
+        _fake.streaming = true;
+        return 0;
+    case VIDIOC_STREAMOFF:
+        _fake.streaming = false;
+        _fake.queue_length = 0;
+        return 0;
+    default:
+        errno = ENOTTY;
+        return -1;
+    }
+}
+
+int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+    va_list args;
+    void *arg;
+
+    va_start(args, request);
+    arg = va_arg(args, void *);
+    va_end(args);
+
+    if (_fake.enabled)
+        return fake_ioctl(fd, request, arg);
+
+    return __real_ioctl(fd, request, arg);
+}
+
+void *__wrap_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset)
+{
+    if (_fake.enabled && (fd == _fake.fd))
+    {
+        int index = (int)(offset / FRAME_SIZE);
+
+        if ((FRAME_SIZE != length) || (0 > index) || (_fake.buffer_count <= index))
+            return MAP_FAILED;
+
+        _fake.mapped[index] = true;
+        return _fake.buffers[index];
+    }
+
+    return __real_mmap(addr, length, prot, flags, fd, offset);
+}
+
+int __wrap_munmap(void *addr, size_t length)
+{
+    for (int i = 0; _fake.enabled && (i < _fake.buffer_count); i++)
+    {
+        if (addr == _fake.buffers[i])
+        {
+            _fake.mapped[i] = false;
+            return 0;
+        }
+    }
+
+    return __real_munmap(addr, length);
+}
+
+int __wrap_poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    if (_fake.enabled && (1 == nfds) && (fds[0].fd == _fake.fd))
+        return (_fake.streaming && (0 < _fake.queue_length)) ? 1 : 0;
+
+    return __real_poll(fds, nfds, timeout);
+}
+
+static void reset_fake(FILE *frame_file)
+{
+    for (int i = 0; i < _fake.buffer_count; i++)
+        free(_fake.buffers[i]);
+
+    memset(&_fake, 0, sizeof(_fake));
+    _fake.enabled = true;
+    _fake.fd = -1;
+    _fake.frame_file = frame_file;
+    _fake.max_buffer_count = FAKE_MAX_BUFFER_COUNT;
+    _fake.error_sequence = UINT32_MAX;
+    _fake.short_sequence = UINT32_MAX;
+}
+
+/* frames of a file are mmap'd in a loop, a frame holds a buffer until it is released */
+static void test_file_source(const char *path)
+{
+    v4l2_capture_frame_t frames[3];
+    v4l2_capture_frame_t frame;
+    kp_generic_input_node_image_t input_node;
+    v4l2_capture_t *capture = v4l2_capture_open(path, FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 3);
+
+    if (NULL == capture)
+    {
+        printf("FAIL file source: v4l2_capture_open() failed\n");
+        _failure_count++;
+        return;
+    }
+
+    // every buffer held: no frame
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK(0 == v4l2_capture_get_frame(capture, 0, &frames[i]), "file frame %d", i);
+        CHECK((i == frames[i].index) && ((uint32_t)i == frames[i].sequence) && frame_matches(frames[i].data, i),
+              "file frame %d is buffer %d sequence %u", i, frames[i].index, frames[i].sequence);
+    }
+
+    CHECK((FRAME_SIZE == frames[0].size) && (FRAME_WIDTH == frames[0].width) && (FRAME_HEIGHT == frames[0].height) &&
+          (KP_IMAGE_FORMAT_YUYV == frames[0].format), "file frame size");
+    CHECK(1 == v4l2_capture_get_frame(capture, 0, &frame), "a frame while every buffer is held");
+
+    // the released buffer is given out again with the next frame, the 5 frames of the file loop
+    CHECK(0 == v4l2_capture_release_frame(capture, &frames[1]), "release file frame 1");
+    CHECK(-1 == v4l2_capture_release_frame(capture, &frames[1]), "second release of file frame 1");
+
+    for (uint32_t sequence = 3; sequence < 12; sequence++)
+    {
+        CHECK(0 == v4l2_capture_get_frame(capture, 0, &frame), "file frame %u", sequence);
+        CHECK((1 == frame.index) && (sequence == frame.sequence) && frame_matches(frame.data, sequence % FILE_FRAME_COUNT),
+              "file frame %u is buffer %d sequence %u", sequence, frame.index, frame.sequence);
+        CHECK(0 == v4l2_capture_release_frame(capture, &frame), "release file frame %u", sequence);
+    }
+
+    frame.index = 3;
+    CHECK(-1 == v4l2_capture_release_frame(capture, &frame), "release of a buffer out of range");
+
+    memset(&input_node, 0, sizeof(input_node));
+    input_node.crop_count = 1;
+    v4l2_capture_set_input_node(&frames[0], &input_node);
+    CHECK((FRAME_WIDTH == input_node.width) && (FRAME_HEIGHT == input_node.height) && (KP_IMAGE_FORMAT_YUYV == input_node.image_format) &&
+          (frames[0].data == input_node.image_buffer) && (1 == input_node.crop_count), "input node of a frame");
+
+    v4l2_capture_release_frame(capture, &frames[0]);
+    v4l2_capture_release_frame(capture, &frames[2]);
+    v4l2_capture_close(capture);
+}
+
+/* buffers are mmap'd and queued at open, a frame is dequeued and filled, a released frame is queued again */
+static void test_device(FILE *frame_file)
+{
+    v4l2_capture_frame_t frames[3];
+    v4l2_capture_frame_t frame;
+    v4l2_capture_t *capture;
+
+    reset_fake(frame_file);
+    _fake.max_buffer_count = 3;     // fewer buffers than requested
+
+    capture = v4l2_capture_open("/dev/null", FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 4);
+    if (NULL == capture)
+    {
+        printf("FAIL fake device: v4l2_capture_open() failed\n");
+        _failure_count++;
+        return;
+    }
+
+    CHECK(_fake.streaming && (3 == _fake.queue_length) && _fake.mapped[0] && _fake.mapped[1] && _fake.mapped[2],
+          "fake device after open: %d buffers queued", _fake.queue_length);
+
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK(0 == v4l2_capture_get_frame(capture, 10, &frames[i]), "device frame %d", i);
+        CHECK((i == frames[i].index) && (_fake.buffers[i] == frames[i].data) && ((uint32_t)i == frames[i].sequence) &&
+              ((uint64_t)(100 + i) * 1000000 + 250 == frames[i].timestamp_us) && frame_matches(frames[i].data, i),
+              "device frame %d is buffer %d sequence %u", i, frames[i].index, frames[i].sequence);
+    }
+
+    CHECK(1 == v4l2_capture_get_frame(capture, 10, &frame), "a device frame while every buffer is dequeued");
+
+    // released out of order, the buffers are queued in the order of release
+    CHECK(0 == v4l2_capture_release_frame(capture, &frames[2]), "release device frame 2");
+    CHECK(0 == v4l2_capture_release_frame(capture, &frames[0]), "release device frame 0");
+    CHECK(-1 == v4l2_capture_release_frame(capture, &frames[0]), "second release of device frame 0");
+    CHECK((2 == _fake.queue_length) && (2 == _fake.queue[0]) && (0 == _fake.queue[1]), "queued buffers after release");
+
+    CHECK((0 == v4l2_capture_get_frame(capture, 10, &frame)) && (2 == frame.index) && (3 == frame.sequence) && frame_matches(frame.data, 3),
+          "device frame 3 is buffer %d sequence %u", frame.index, frame.sequence);
+    CHECK(0 == v4l2_capture_release_frame(capture, &frame), "release device frame 3");
+
+    // a frame with the error flag and a short frame go back to the driver
+    _fake.error_sequence = 4;
+    _fake.short_sequence = 5;
+    CHECK(1 == v4l2_capture_get_frame(capture, 10, &frame), "device frame with the error flag");
+    CHECK(1 == v4l2_capture_get_frame(capture, 10, &frame), "short device frame");
+    CHECK(2 == _fake.queue_length, "%d buffers queued after dropped frames", _fake.queue_length);
+    CHECK((0 == v4l2_capture_get_frame(capture, 10, &frame)) && (6 == frame.sequence) && frame_matches(frame.data, 6 % FILE_FRAME_COUNT),
+          "device frame after dropped frames has sequence %u", frame.sequence);
+
+    v4l2_capture_release_frame(capture, &frame);
+    v4l2_capture_release_frame(capture, &frames[1]);
+    v4l2_capture_close(capture);
+
+    CHECK(!_fake.streaming && !_fake.mapped[0] && !_fake.mapped[1] && !_fake.mapped[2], "fake device after close");
+
+    // the driver may change the size
+    reset_fake(frame_file);
+    _fake.width_adjust = 2;
+    capture = v4l2_capture_open("/dev/null", FRAME_WIDTH + 2, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 2);
+    CHECK((NULL != capture) && (0 == v4l2_capture_get_frame(capture, 10, &frame)) && (FRAME_WIDTH == frame.width) && (FRAME_SIZE == frame.size),
+          "size adjusted by the driver");
+    v4l2_capture_release_frame(capture, &frame);
+    v4l2_capture_close(capture);
+
+    // frames which can not be sent as they are
+    reset_fake(frame_file);
+    _fake.bytes_per_line_padding = 32;
+    capture = v4l2_capture_open("/dev/null", FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 2);
+    CHECK(NULL == capture, "padded rows are accepted");
+    v4l2_capture_close(capture);
+
+    reset_fake(frame_file);
+    _fake.other_pixel_format = true;
+    capture = v4l2_capture_open("/dev/null", FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 2);
+    CHECK(NULL == capture, "another pixel format is accepted");
+    v4l2_capture_close(capture);
+
+    reset_fake(NULL);
+    _fake.enabled = false;
+}
+
+static void test_open_errors(const char *path, const char *short_path)
+{
+    CHECK(NULL == v4l2_capture_open(short_path, FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 2), "file without a complete frame");
+    CHECK(NULL == v4l2_capture_open(path, FRAME_WIDTH + 1, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 2), "odd YUYV width");
+    CHECK(NULL == v4l2_capture_open(path, FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_RGBA8888, 2), "RGBA8888");
+    CHECK(NULL == v4l2_capture_open(path, FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 0), "no buffer");
+    CHECK(NULL == v4l2_capture_open(path, FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 33), "33 buffers");
+    CHECK(NULL == v4l2_capture_open("/nonexistent/video", FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 2), "missing path");
+    // a character device which is not a V4L2 device
+    CHECK(NULL == v4l2_capture_open("/dev/null", FRAME_WIDTH, FRAME_HEIGHT, KP_IMAGE_FORMAT_YUYV, 2), "/dev/null");
+}
+
+int main(int argc, char *argv[])
+{
+    char path[64];
+    char short_path[64];
+    FILE *frame_file;
+    FILE *short_file;
+
+    snprintf(path, sizeof(path), "/tmp/test_v4l2_capture_%d.yuyv", (int)getpid());
+    snprintf(short_path, sizeof(short_path), "/tmp/test_v4l2_capture_%d_short.yuyv", (int)getpid());
+
+    // a partial frame at the end of the file is never returned
+    frame_file = make_frame_file(path, FILE_FRAME_COUNT, 100);
+    short_file = make_frame_file(short_path, 0, FRAME_SIZE - 1);
+
+    if ((NULL == frame_file) || (NULL == short_file))
+    {
+        printf("Error! %s(): can not write %s\n", __FUNCTION__, path);
+        return -1;
+    }
+
+    test_file_source(path);
+    test_device(frame_file);
+    test_open_errors(path, short_path);
+
+    fclose(frame_file);
+    fclose(short_file);
+    remove(path);
+    remove(short_path);
+
+    if (0 < _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("file source and fake V4L2 device: frames, hold, release and requeue are right\n");
+
+    return 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * @file        test_yolo_box_transform.c
+ * @brief       check of YOLO NMS on image coordinates (post_process_box_transform_t) against NMS on model input coordinates followed by boxes scaling
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "postprocess.h"
+#include "reference_yolo_postprocess.h"
+
+#define FRAMES_PER_CONFIGURATION 4
+#define MAX_HEAD_COUNT 3
+#define ANCHOR_COUNT 3
+#define CLASS_COUNT 20
+
+typedef int (*yolo_function_t)(kp_inf_float_node_output_t *node_output[], int num_output_node, kp_hw_pre_proc_info_t *pre_proc_info,
+                               float thresh_value, kp_yolo_result_t *yoloResult);
+
+static const struct
+{
+    const char *name;
+    post_process_yolo_type_t type;
+    yolo_function_t reference_function;
+    uint32_t model_input_size;
+    int head_count;
+    int grid_sizes[MAX_HEAD_COUNT];
+    bool logits;                    // node values are logits (sigmoid in post-processing) or already activated
+    float thresh_value;
+} _models[] = {
+    {"yolo_v3", POST_PROCESS_YOLO_V3, reference_post_process_yolo_v3, 416, 2, {13, 26}, true, 0.2f},
+    {"yolo_v5_520", POST_PROCESS_YOLO_V5_520, reference_post_process_yolo_v5_520, 640, 3, {80, 40, 20}, true, 0.3f},
+    {"yolo_v5_720", POST_PROCESS_YOLO_V5_720, reference_post_process_yolo_v5_720, 640, 3, {80, 40, 20}, false, 0.3f},
+};
+
+typedef enum
+{
+    PADDING_CENTERED = 0,           // letterbox, padding on both sides
+    PADDING_BOTTOM_RIGHT,           // letterbox, padding on bottom/right only
+    NO_PADDING,                     // resized to the model input, non-uniform scale
+    PADDING_TYPE_NUM
+} padding_type_t;
+
+static const char *_padding_names[PADDING_TYPE_NUM] = {"centered padding", "bottom/right padding", "non-uniform scale"};
+
+/* sizes of the pre-processed image (the crop area if cropped), smaller and larger than the model input, landscape and portrait */
+static const uint32_t _image_sizes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}, {1000, 700}, {416, 416}, {300, 500}, {333, 217}, {2592, 1944}};
+
+static uint32_t _random_state = 0x3c6ef372;
+
+static int _failure_count = 0;
+
+static kp_yolo_result_t _reference_result;
+static kp_yolo_result_t _result;
+
+static float random_uniform()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return ((float)(_random_state >> 8) + 1.0f) / (float)((1 << 24) + 1);
+}
+
+static float random_gauss()
+{
+    float u = random_uniform();
+    float v = random_uniform();
+
+    return sqrtf(-2 * logf(u)) * cosf(6.2831853f * v);
+}
+
+static kp_inf_float_node_output_t *make_node(int channel, int grid_size)
+{
+    uint32_t num_data = (uint32_t)channel * grid_size * grid_size;
+    kp_inf_float_node_output_t *node = calloc(1, sizeof(kp_inf_float_node_output_t) + num_data * sizeof(float));
+
+    if (NULL == node)
+        return NULL;
+
+    node->shape = malloc(4 * sizeof(int32_t));
+    if (NULL == node->shape)
+    {
+        free(node);
+        return NULL;
+    }
+
+    node->name = "";
+    node->shape_len = 4;
+    node->shape[0] = 1;
+    node->shape[1] = channel;
+    node->shape[2] = grid_size;
+    node->shape[3] = grid_size;
+    node->num_data = num_data;
+
+    return node;
+}
+
+static void release_node(kp_inf_float_node_output_t *node)
+{
+    if (NULL == node)
+        return;
+
+    free(node->shape);
+    free(node);
+}
+
+/* random head values, 'object_ratio' of the values are high logits, the others low ones */
+static void fill_node(kp_inf_float_node_output_t *node, bool logits, float object_ratio)
+{
+    for (uint32_t i = 0; i < node->num_data; i++)
+    {
+        float logit = random_gauss() * 1.5f - 6;
+
+        if (object_ratio > random_uniform())
+            logit = random_gauss() + 2;
+
+        node->data[i] = logits ? logit : 1 / (1 + expf(-logit));
+    }
+}
+
+static void make_pre_proc_info(kp_hw_pre_proc_info_t *pre_proc_info, uint32_t model_input_size, const uint32_t *image_size, padding_type_t padding_type)
+{
+    uint32_t img_width = image_size[0];
+    uint32_t img_height = image_size[1];
+
+    memset(pre_proc_info, 0, sizeof(kp_hw_pre_proc_info_t));
+    pre_proc_info->img_width = img_width;
+    pre_proc_info->img_height = img_height;
+    pre_proc_info->model_input_width = model_input_size;
+    pre_proc_info->model_input_height = model_input_size;
+    pre_proc_info->resized_img_width = model_input_size;
+    pre_proc_info->resized_img_height = model_input_size;
+
+    if (NO_PADDING == padding_type)
+        return;
+
+    if (img_width >= img_height)
+        pre_proc_info->resized_img_height = model_input_size * img_height / img_width;
+    else
+        pre_proc_info->resized_img_width = model_input_size * img_width / img_height;
+
+    if (PADDING_CENTERED == padding_type)
+    {
+        pre_proc_info->pad_left = (model_input_size - pre_proc_info->resized_img_width) / 2;
+        pre_proc_info->pad_top = (model_input_size - pre_proc_info->resized_img_height) / 2;
+    }
+
+    pre_proc_info->pad_right = model_input_size - pre_proc_info->resized_img_width - pre_proc_info->pad_left;
+    pre_proc_info->pad_bottom = model_input_size - pre_proc_info->resized_img_height - pre_proc_info->pad_top;
+}
+
+static bool compare_results(int m, const char *configuration, int frame)
+{
+    if ((_reference_result.box_count != _result.box_count) ||
+        (0 != memcmp(_reference_result.boxes, _result.boxes, _reference_result.box_count * sizeof(kp_bounding_box_t))))
+    {
+        printf("FAIL %s %s frame %d: %u boxes, two passes %u boxes\n", _models[m].name, configuration, frame, _result.box_count,
+               _reference_result.box_count);
+        _failure_count++;
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * frames of one model over all configurations: boxes of the one-pass decoder (mapped while decoding, NMS on image coordinates)
+ * against the former decoder (NMS on model input coordinates, then boxes scaling), with and without the crop offset
+ */
+static void test_model(int m, post_process_yolo_context_t *context)
+{
+    kp_inf_float_node_output_t *nodes[MAX_HEAD_COUNT] = {NULL};
+    const post_process_yolo_descriptor_t *descriptor = post_process_yolo_builtin_descriptor(_models[m].type);
+    int configuration_count = 0;
+    int box_total = 0;
+
+    for (int h = 0; h < _models[m].head_count; h++)
+    {
+        nodes[h] = make_node(ANCHOR_COUNT * (5 + CLASS_COUNT), _models[m].grid_sizes[h]);
+        if (NULL == nodes[h])
+        {
+            printf("FAIL %s: out of memory\n", _models[m].name);
+            _failure_count++;
+            goto EXIT;
+        }
+    }
+
+    for (int padding_type = 0; padding_type < PADDING_TYPE_NUM; padding_type++)
+    {
+        for (int s = 0; s < (int)(sizeof(_image_sizes) / sizeof(_image_sizes[0])); s++)
+        {
+            kp_hw_pre_proc_info_t pre_proc_info;
+            char configuration[64];
+
+            make_pre_proc_info(&pre_proc_info, _models[m].model_input_size, _image_sizes[s], (padding_type_t)padding_type);
+            snprintf(configuration, sizeof(configuration), "%ux%u %s", _image_sizes[s][0], _image_sizes[s][1], _padding_names[padding_type]);
+            configuration_count++;
+
+            for (int frame = 0; frame < FRAMES_PER_CONFIGURATION; frame++)
+            {
+                post_process_box_transform_t box_transform;
+                int crop_x = (int)(random_uniform() * 3000);
+                int crop_y = (int)(random_uniform() * 2000);
+
+                for (int h = 0; h < _models[m].head_count; h++)
+                    fill_node(nodes[h], _models[m].logits, 0.002f + 0.01f * frame);
+
+                // two passes: NMS on model input coordinates, then boxes scaling
+                memset(&_reference_result, 0, sizeof(_reference_result));
+                if (0 != _models[m].reference_function(nodes, _models[m].head_count, &pre_proc_info, _models[m].thresh_value, &_reference_result))
+                    continue;
+
+                box_total += _reference_result.box_count;
+
+                // one pass to the pre-processed image
+                memset(&_result, 0, sizeof(_result));
+                post_process_yolo_generic_with_context(context, descriptor, nodes, _models[m].head_count, &pre_proc_info, NULL,
+                                                       _models[m].thresh_value, &_result);
+
+                if (!compare_results(m, configuration, frame))
+                    continue;
+
+                // one pass to the whole image of a crop area at (crop_x, crop_y), the two-pass boxes are moved by the crop offset
+                post_process_box_transform_init(&box_transform, &pre_proc_info);
+                box_transform.origin_x = crop_x;
+                box_transform.origin_y = crop_y;
+                box_transform.min_x += crop_x;
+                box_transform.min_y += crop_y;
+                box_transform.max_x += crop_x;
+                box_transform.max_y += crop_y;
+
+                for (uint32_t i = 0; i < _reference_result.box_count; i++)
+                {
+                    _reference_result.boxes[i].x1 += crop_x;
+                    _reference_result.boxes[i].y1 += crop_y;
+                    _reference_result.boxes[i].x2 += crop_x;
+                    _reference_result.boxes[i].y2 += crop_y;
+                }
+
+                memset(&_result, 0, sizeof(_result));
+                post_process_yolo_generic_with_context(context, descriptor, nodes, _models[m].head_count, &pre_proc_info, &box_transform,
+                                                       _models[m].thresh_value, &_result);
+
+                strncat(configuration, " crop offset", sizeof(configuration) - strlen(configuration) - 1);
+                compare_results(m, configuration, frame);
+                configuration[strlen(configuration) - strlen(" crop offset")] = '\0';
+            }
+        }
+    }
+
+    printf("%-11s: %d pre_proc_info configurations x %d frames (%d boxes), NMS on image coordinates matches two passes\n", _models[m].name,
+           configuration_count, FRAMES_PER_CONFIGURATION, box_total);
+
+EXIT:
+    for (int h = 0; h < _models[m].head_count; h++)
+        release_node(nodes[h]);
+}
+
+int main(int argc, char *argv[])
+{
+    for (int m = 0; m < (int)(sizeof(_models) / sizeof(_models[0])); m++)
+    {
+        post_process_yolo_context_t *context = post_process_yolo_create_context();
+        if (NULL == context)
+            return -1;
+
+        test_model(m, context);
+
+        post_process_yolo_release_context(context);
+    }
+
+    if (0 != _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    return 0;
+}
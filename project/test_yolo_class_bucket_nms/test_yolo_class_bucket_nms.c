@@ -0,0 +1,300 @@
+/**
+ * @file        test_yolo_class_bucket_nms.c
+ * @brief       check of the class-bucketed YOLO NMS of postprocess.c and its context against the former per-class rescan, sort and NMS
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* yolo_class_bucket_nms() and prepare_yolo_context() are static, postprocess.c is built as part of this file */
+#include "../../ex_common/postprocess.c"
+
+#define RANDOM_FRAME_COUNT 300
+#define MAX_CLASS_COUNT 80
+#define IMAGE_SIZE 640
+
+static uint32_t _random_state = 0x6a09e667;
+
+static int _failure_count = 0;
+
+static kp_bounding_box_t _candidates[MAX_POSSIBLE_BOXES];
+static kp_bounding_box_t _temp_boxes[MAX_POSSIBLE_BOXES];
+
+static kp_yolo_result_t _reference_result;
+static kp_yolo_result_t _result;
+
+static uint32_t random_next()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return _random_state;
+}
+
+/* multiple of 1/4 in [min, max), the width/height round trip of the reference scaling is exact for such coordinates */
+static float random_coordinate(int min, int max)
+{
+    return (float)(min * 4 + (int)(random_next() % ((max - min) * 4))) / 4;
+}
+
+/*
+ * candidates in clusters of overlapping boxes of random classes, scores on a 1/64 grid so boxes of one class often tie on score
+ * and are ordered by coordinates, some boxes are exact duplicates
+ */
+static void make_candidates(kp_bounding_box_t *boxes, int count, int class_count, int cluster_size)
+{
+    float x = 0, y = 0, w = 0, h = 0;
+    int class_num = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (0 == i % cluster_size)
+        {
+            w = random_coordinate(8, 160);
+            h = random_coordinate(8, 160);
+            x = random_coordinate(0, IMAGE_SIZE - 160);
+            y = random_coordinate(0, IMAGE_SIZE - 160);
+            class_num = random_next() % class_count;
+        }
+
+        if ((0 < i) && (0 == random_next() % 16))
+        {
+            boxes[i] = boxes[i - 1];
+            continue;
+        }
+
+        boxes[i].x1 = x + random_coordinate(-8, 8);
+        boxes[i].y1 = y + random_coordinate(-8, 8);
+        boxes[i].x2 = boxes[i].x1 + w + random_coordinate(-8, 8);
+        boxes[i].y2 = boxes[i].y1 + h + random_coordinate(-8, 8);
+        boxes[i].score = (float)(1 + random_next() % 64) / 64;
+        boxes[i].class_num = (0 == random_next() % 4) ? (int32_t)(random_next() % class_count) : class_num;
+    }
+}
+
+/* the scaling pass postprocess.c used after NMS before the box transform, kept as the reference */
+static void reference_boxes_scale(kp_bounding_box_t *boxes, int size, kp_hw_pre_proc_info_t *pre_proc_info)
+{
+    int img_width = pre_proc_info->img_width;
+    int img_height = pre_proc_info->img_height;
+    int pad_left = pre_proc_info->pad_left;
+    int pad_top = pre_proc_info->pad_top;
+    float ratio_w = (float)img_width / pre_proc_info->resized_img_width;
+    float ratio_h = (float)img_height / pre_proc_info->resized_img_height;
+
+    for (int i = 0; i < size; i++)
+    {
+        boxes[i].x2 = (boxes[i].x2 - boxes[i].x1) * ratio_w; // w
+        boxes[i].y2 = (boxes[i].y2 - boxes[i].y1) * ratio_h; // h
+        boxes[i].x1 -= pad_left;
+        boxes[i].y1 -= pad_top;
+        boxes[i].x1 *= ratio_w;
+        boxes[i].y1 *= ratio_h;
+        boxes[i].x2 += boxes[i].x1;
+        boxes[i].y2 += boxes[i].y1;
+
+        // limit Rectangle
+        boxes[i].x1 = ((int)(boxes[i].x1 + 0.5) > 0) ? (int)(boxes[i].x1 + 0.5) : 0;
+        boxes[i].y1 = ((int)(boxes[i].y1 + 0.5) > 0) ? (int)(boxes[i].y1 + 0.5) : 0;
+        boxes[i].x2 = ((int)(boxes[i].x2 + 0.5) < (img_width - 1)) ? (int)(boxes[i].x2 + 0.5) : img_width - 1;
+        boxes[i].y2 = ((int)(boxes[i].y2 + 0.5) < (img_height - 1)) ? (int)(boxes[i].y2 + 0.5) : img_height - 1;
+    }
+}
+
+/* the per-class rescan, sort and NMS loop of post_process_yolo_v3() before yolo_class_bucket_nms(), kept as the reference */
+static int reference_class_nms(kp_bounding_box_t *possible_boxes, int good_box_count, int class_count, double nms_thresh, kp_yolo_result_t *yoloResult)
+{
+    kp_bounding_box_t *temp_boxes = _temp_boxes;
+    int good_result_count = 0;
+
+    for (int i = 0; i < class_count; i++)
+    {
+        kp_bounding_box_t *bbox = possible_boxes;
+        kp_bounding_box_t *r_tmp_p = temp_boxes;
+
+        int class_good_box_count = 0;
+
+        for (int j = 0; j < good_box_count; j++)
+        {
+            if (bbox->class_num == i)
+            {
+                memcpy(r_tmp_p, bbox, sizeof(kp_bounding_box_t));
+                r_tmp_p++;
+                class_good_box_count++;
+            }
+            bbox++;
+        }
+
+        if (class_good_box_count == 1)
+        {
+            if (good_result_count < YOLO_GOOD_BOX_MAX)
+            {
+                memcpy(&(yoloResult->boxes[good_result_count]), &temp_boxes[0], sizeof(kp_bounding_box_t));
+                good_result_count++;
+            }
+        }
+        else if (class_good_box_count >= 2)
+        {
+            qsort(temp_boxes, class_good_box_count, sizeof(kp_bounding_box_t), box_comparator);
+            for (int j = 0; j < class_good_box_count; j++)
+            {
+                if (temp_boxes[j].score == 0)
+                    continue;
+                for (int k = j + 1; k < class_good_box_count; k++)
+                {
+                    if (box_iou(&temp_boxes[j], &temp_boxes[k], IOU_UNION) > nms_thresh)
+                    {
+                        temp_boxes[k].score = 0;
+                    }
+                }
+            }
+
+            int good_count = 0;
+            for (int j = 0; j < class_good_box_count; j++)
+            {
+                if (temp_boxes[j].score > 0 && good_result_count < YOLO_GOOD_BOX_MAX)
+                {
+                    memcpy(&(yoloResult->boxes[good_result_count]), &temp_boxes[j], sizeof(kp_bounding_box_t));
+                    good_result_count++;
+                    good_count++;
+                }
+                if (YOLO_MAX_DETECTION_PER_CLASS == good_count)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (good_result_count >= YOLO_GOOD_BOX_MAX)
+            break;
+    }
+
+    return good_result_count;
+}
+
+static int run_bucket_nms(post_process_yolo_context_t *context, int candidate_count, int class_count, double nms_thresh,
+                          kp_hw_pre_proc_info_t *pre_proc_info, kp_yolo_result_t *yoloResult)
+{
+    post_process_box_transform_t box_transform;
+
+    if (0 != prepare_yolo_context(context, class_count, (0 < candidate_count) ? candidate_count : 1))
+        return -1;
+
+    memcpy(context->candidate_boxes, _candidates, candidate_count * sizeof(kp_bounding_box_t));
+    post_process_box_transform_init(&box_transform, pre_proc_info);
+
+    return yolo_class_bucket_nms(context, class_count, candidate_count, nms_thresh, YOLO_MAX_DETECTION_PER_CLASS, &box_transform, yoloResult);
+}
+
+static void compare_results(const char *test, int frame, int reference_count, int count)
+{
+    if (reference_count != count)
+    {
+        printf("FAIL %s frame %d: %d boxes, reference %d boxes\n", test, frame, count, reference_count);
+        _failure_count++;
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (0 != memcmp(&_result.boxes[i], &_reference_result.boxes[i], sizeof(kp_bounding_box_t)))
+        {
+            kp_bounding_box_t *box = &_result.boxes[i];
+            kp_bounding_box_t *reference_box = &_reference_result.boxes[i];
+
+            printf("FAIL %s frame %d box %d: (%g %g %g %g %g %d), reference (%g %g %g %g %g %d)\n", test, frame, i,
+                   box->x1, box->y1, box->x2, box->y2, box->score, box->class_num,
+                   reference_box->x1, reference_box->y1, reference_box->x2, reference_box->y2, reference_box->score, reference_box->class_num);
+            _failure_count++;
+            return;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    kp_hw_pre_proc_info_t pre_proc_info;
+    post_process_yolo_context_t *reused_context = post_process_yolo_create_context();
+    int box_total = 0;
+
+    if (NULL == reused_context)
+        return -1;
+
+    memset(&pre_proc_info, 0, sizeof(pre_proc_info));
+    pre_proc_info.img_width = IMAGE_SIZE;
+    pre_proc_info.img_height = IMAGE_SIZE;
+    pre_proc_info.resized_img_width = IMAGE_SIZE;
+    pre_proc_info.resized_img_height = IMAGE_SIZE;
+
+    for (int frame = 0; frame < RANDOM_FRAME_COUNT; frame++)
+    {
+        int class_count = 1 + random_next() % MAX_CLASS_COUNT;
+        int candidate_count = random_next() % (MAX_POSSIBLE_BOXES + 1);
+        int cluster_size = 1 + random_next() % 16;
+        double nms_thresh = (0 == frame % 2) ? NMS_THRESH_YOLOV3_520 : NMS_THRESH_YOLOV5_720;
+        int reference_count = 0;
+        int count = 0;
+
+        // frames over YOLO_MAX_DETECTION_PER_CLASS boxes in one class and over YOLO_GOOD_BOX_MAX boxes in total
+        if (0 == frame % 10)
+        {
+            class_count = 1;
+            candidate_count = MAX_POSSIBLE_BOXES;
+            cluster_size = 1;
+        }
+        else if (1 == frame % 10)
+        {
+            class_count = MAX_CLASS_COUNT;
+            candidate_count = MAX_POSSIBLE_BOXES;
+            cluster_size = 1;
+        }
+        else if (2 == frame % 10)
+        {
+            candidate_count = random_next() % 3;
+        }
+
+        make_candidates(_candidates, candidate_count, class_count, cluster_size);
+
+        memset(&_reference_result, 0, sizeof(_reference_result));
+        reference_count = reference_class_nms(_candidates, candidate_count, class_count, nms_thresh, &_reference_result);
+        reference_boxes_scale(_reference_result.boxes, reference_count, &pre_proc_info);
+
+        // one context reused over frames of growing and shrinking class and candidate counts
+        memset(&_result, 0, sizeof(_result));
+        count = run_bucket_nms(reused_context, candidate_count, class_count, nms_thresh, &pre_proc_info, &_result);
+        compare_results("reused context", frame, reference_count, count);
+
+        // a new context with pre-NMS caps which no frame reaches
+        post_process_yolo_context_t *context = post_process_yolo_create_context();
+        if (NULL == context)
+            return -1;
+
+        post_process_yolo_set_pre_nms_top_k(context, MAX_POSSIBLE_BOXES, MAX_POSSIBLE_BOXES);
+
+        memset(&_result, 0, sizeof(_result));
+        count = run_bucket_nms(context, candidate_count, class_count, nms_thresh, &pre_proc_info, &_result);
+        compare_results("new context", frame, reference_count, count);
+
+        post_process_yolo_release_context(context);
+
+        box_total += reference_count;
+    }
+
+    post_process_yolo_release_context(reused_context);
+
+    if (0 != _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    printf("%d random frames (%d output boxes): yolo_class_bucket_nms() matches the per-class sort and NMS\n", RANDOM_FRAME_COUNT, box_total);
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file        reference_yolo_postprocess.h
+ * @brief       YOLO V3 / V5 post-processing functions of postprocess.c before the descriptor-driven decoder, kept as the test reference
+ *
+ * Candidates are decoded in model input coordinates, NMS runs class by class over a full rescan of the candidates,
+ * and the kept boxes are scaled to the image afterwards.
+ *
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "kp_struct.h"
+
+/**
+ * @brief YOLO V3 post-processing function for KL520, refer to post_process_yolo_v3().
+ */
+int reference_post_process_yolo_v3(kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                   kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
+
+/**
+ * @brief YOLO V5 post-processing function (with sigmoid) for KL520, refer to post_process_yolo_v5_520().
+ */
+int reference_post_process_yolo_v5_520(kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                       kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
+
+/**
+ * @brief YOLO V5 post-processing function (without sigmoid) for KL720, refer to post_process_yolo_v5_720().
+ */
+int reference_post_process_yolo_v5_720(kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                       kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
@@ -0,0 +1,304 @@
+/**
+ * @file        test_yolo_descriptor_decoder.c
+ * @brief       check of the descriptor-driven YOLO decoder of postprocess.c against the former yolo_v3 / yolo_v5_520 / yolo_v5_720 decoders
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "postprocess.h"
+#include "reference_yolo_postprocess.h"
+
+#define RANDOM_FRAME_COUNT 60
+#define MAX_HEAD_COUNT 3
+#define ANCHOR_COUNT 3
+
+typedef int (*yolo_function_t)(kp_inf_float_node_output_t *node_output[], int num_output_node, kp_hw_pre_proc_info_t *pre_proc_info,
+                               float thresh_value, kp_yolo_result_t *yoloResult);
+
+typedef int (*yolo_context_function_t)(post_process_yolo_context_t *context, kp_inf_float_node_output_t *node_output[], int num_output_node,
+                                       kp_hw_pre_proc_info_t *pre_proc_info, float thresh_value, kp_yolo_result_t *yoloResult);
+
+static const struct
+{
+    const char *name;
+    post_process_yolo_type_t type;
+    yolo_function_t function;
+    yolo_context_function_t context_function;
+    yolo_function_t reference_function;
+    uint32_t model_input_size;
+    int head_count;
+    int grid_sizes[MAX_HEAD_COUNT];
+    int class_count;
+    bool logits;                    // node values are logits (sigmoid in post-processing) or already activated
+} _models[] = {
+    {"yolo_v3 2 heads", POST_PROCESS_YOLO_V3, post_process_yolo_v3, post_process_yolo_v3_with_context, reference_post_process_yolo_v3,
+     416, 2, {13, 26}, 80, true},
+    // the third head of yolo_v3 has {0, 0} anchors, its boxes have no width and height
+    {"yolo_v3 3 heads", POST_PROCESS_YOLO_V3, post_process_yolo_v3, post_process_yolo_v3_with_context, reference_post_process_yolo_v3,
+     416, 3, {13, 26, 52}, 20, true},
+    {"yolo_v5_520", POST_PROCESS_YOLO_V5_520, post_process_yolo_v5_520, post_process_yolo_v5_520_with_context, reference_post_process_yolo_v5_520,
+     640, 3, {80, 40, 20}, 80, true},
+    {"yolo_v5_720", POST_PROCESS_YOLO_V5_720, post_process_yolo_v5_720, post_process_yolo_v5_720_with_context, reference_post_process_yolo_v5_720,
+     640, 3, {80, 40, 20}, 80, false},
+};
+
+/* share of cells holding an object, the densest frames go over the candidate limit of yolo_v3 and yolo_v5_520 */
+static const float _object_ratios[] = {0.0f, 0.002f, 0.01f, 0.05f, 0.3f};
+
+static const float _thresh_values[] = {0.15f, 0.3f, 0.5f};
+
+static uint32_t _random_state = 0xbb67ae85;
+
+static int _failure_count = 0;
+
+static kp_yolo_result_t _reference_result;
+static kp_yolo_result_t _result;
+
+static float random_uniform()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return ((float)(_random_state >> 8) + 1.0f) / (float)((1 << 24) + 1);
+}
+
+static float random_gauss()
+{
+    float u = random_uniform();
+    float v = random_uniform();
+
+    return sqrtf(-2 * logf(u)) * cosf(6.2831853f * v);
+}
+
+static kp_inf_float_node_output_t *make_node(int channel, int grid_size)
+{
+    uint32_t num_data = (uint32_t)channel * grid_size * grid_size;
+    kp_inf_float_node_output_t *node = calloc(1, sizeof(kp_inf_float_node_output_t) + num_data * sizeof(float));
+
+    if (NULL == node)
+        return NULL;
+
+    node->shape = malloc(4 * sizeof(int32_t));
+    if (NULL == node->shape)
+    {
+        free(node);
+        return NULL;
+    }
+
+    node->name = "";
+    node->shape_len = 4;
+    node->shape[0] = 1;
+    node->shape[1] = channel;
+    node->shape[2] = grid_size;
+    node->shape[3] = grid_size;
+    node->num_data = num_data;
+
+    return node;
+}
+
+static void release_node(kp_inf_float_node_output_t *node)
+{
+    if (NULL == node)
+        return;
+
+    free(node->shape);
+    free(node);
+}
+
+/*
+ * random head values, 'object_ratio' of the values are high logits, the others low ones; with a quantization factor
+ * the values are on its int8 grid as they are dequantized by kp_generic_inference_retrieve_float_node()
+ */
+static void fill_node(kp_inf_float_node_output_t *node, bool logits, float object_ratio, float quantization_factor)
+{
+    for (uint32_t i = 0; i < node->num_data; i++)
+    {
+        float logit = random_gauss() * 1.5f - 6;
+
+        if (object_ratio > random_uniform())
+            logit = random_gauss() + 2;
+
+        float value = logits ? logit : 1 / (1 + expf(-logit));
+
+        if (0 < quantization_factor)
+        {
+            int32_t fixed_point = (int32_t)lrintf(value * quantization_factor);
+            fixed_point = (fixed_point < INT8_MIN) ? INT8_MIN : ((fixed_point > INT8_MAX) ? INT8_MAX : fixed_point);
+            value = (float)fixed_point / quantization_factor;
+        }
+
+        node->data[i] = value;
+    }
+}
+
+static void random_pre_proc_info(kp_hw_pre_proc_info_t *pre_proc_info, uint32_t model_input_size)
+{
+    static const uint32_t image_sizes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}, {416, 416}, {300, 500}};
+    int image_idx = (int)(random_uniform() * 5) % 5;
+    uint32_t img_width = image_sizes[image_idx][0];
+    uint32_t img_height = image_sizes[image_idx][1];
+
+    memset(pre_proc_info, 0, sizeof(kp_hw_pre_proc_info_t));
+    pre_proc_info->img_width = img_width;
+    pre_proc_info->img_height = img_height;
+    pre_proc_info->model_input_width = model_input_size;
+    pre_proc_info->model_input_height = model_input_size;
+
+    // letterbox resize, padding centered or on the bottom/right only
+    if (img_width >= img_height)
+    {
+        pre_proc_info->resized_img_width = model_input_size;
+        pre_proc_info->resized_img_height = model_input_size * img_height / img_width;
+    }
+    else
+    {
+        pre_proc_info->resized_img_width = model_input_size * img_width / img_height;
+        pre_proc_info->resized_img_height = model_input_size;
+    }
+
+    if (0.5f > random_uniform())
+    {
+        pre_proc_info->pad_left = (model_input_size - pre_proc_info->resized_img_width) / 2;
+        pre_proc_info->pad_top = (model_input_size - pre_proc_info->resized_img_height) / 2;
+    }
+
+    pre_proc_info->pad_right = model_input_size - pre_proc_info->resized_img_width - pre_proc_info->pad_left;
+    pre_proc_info->pad_bottom = model_input_size - pre_proc_info->resized_img_height - pre_proc_info->pad_top;
+}
+
+static void compare_results(const char *model, const char *path, int frame, int reference_status, int status)
+{
+    if (reference_status != status)
+    {
+        printf("FAIL %s %s frame %d: return %d, reference %d\n", model, path, frame, status, reference_status);
+        _failure_count++;
+        return;
+    }
+
+    // a failed frame has no result to compare
+    if (0 != reference_status)
+        return;
+
+    if ((_reference_result.class_count != _result.class_count) || (_reference_result.box_count != _result.box_count) ||
+        (0 != memcmp(_reference_result.boxes, _result.boxes, _reference_result.box_count * sizeof(kp_bounding_box_t))))
+    {
+        printf("FAIL %s %s frame %d: %u boxes, reference %u boxes\n", model, path, frame, _result.box_count, _reference_result.box_count);
+        _failure_count++;
+    }
+}
+
+/* every frame through the former decoder, the wrapper, the wrapper with a reused context and the generic decoder with the built-in descriptor */
+static void test_model(int m, post_process_yolo_context_t *context, bool quantized)
+{
+    kp_inf_float_node_output_t *nodes[MAX_HEAD_COUNT] = {NULL};
+    int channel = ANCHOR_COUNT * (5 + _models[m].class_count);
+    int box_total = 0;
+    int failed_frame_count = 0;
+
+    for (int h = 0; h < _models[m].head_count; h++)
+    {
+        nodes[h] = make_node(channel, _models[m].grid_sizes[h]);
+        if (NULL == nodes[h])
+        {
+            printf("FAIL %s: out of memory\n", _models[m].name);
+            _failure_count++;
+            goto EXIT;
+        }
+    }
+
+    for (int frame = 0; frame < RANDOM_FRAME_COUNT; frame++)
+    {
+        kp_hw_pre_proc_info_t pre_proc_info;
+        float object_ratio = _object_ratios[frame % (sizeof(_object_ratios) / sizeof(_object_ratios[0]))];
+        float thresh_value = _thresh_values[frame % (sizeof(_thresh_values) / sizeof(_thresh_values[0]))];
+        int reference_status = 0;
+        int status = 0;
+
+        random_pre_proc_info(&pre_proc_info, _models[m].model_input_size);
+
+        for (int h = 0; h < _models[m].head_count; h++)
+        {
+            // int8 quantization of about +-8 for logits, of [0, 1) for activated values
+            float quantization_factor = quantized ? (_models[m].logits ? 16.0f : 128.0f) : 0;
+            kp_inf_node_view_t node_view;
+
+            fill_node(nodes[h], _models[m].logits, object_ratio, quantization_factor);
+
+            memset(&node_view, 0, sizeof(node_view));
+            node_view.fixed_point_dtype = quantized ? KP_FIXED_POINT_DTYPE_INT8 : KP_FIXED_POINT_DTYPE_UNKNOWN;
+            node_view.quantization_parameters_len = 1;
+            node_view.quantization_factor = quantization_factor;
+            post_process_yolo_set_node_quantization(context, h, &node_view);
+        }
+
+        memset(&_reference_result, 0, sizeof(_reference_result));
+        reference_status = _models[m].reference_function(nodes, _models[m].head_count, &pre_proc_info, thresh_value, &_reference_result);
+
+        memset(&_result, 0, sizeof(_result));
+        status = _models[m].function(nodes, _models[m].head_count, &pre_proc_info, thresh_value, &_result);
+        compare_results(_models[m].name, "wrapper", frame, reference_status, status);
+
+        memset(&_result, 0, sizeof(_result));
+        status = _models[m].context_function(context, nodes, _models[m].head_count, &pre_proc_info, thresh_value, &_result);
+        compare_results(_models[m].name, quantized ? "context with lookup tables" : "context", frame, reference_status, status);
+
+        memset(&_result, 0, sizeof(_result));
+        status = post_process_yolo_generic_with_context(context, post_process_yolo_builtin_descriptor(_models[m].type), nodes, _models[m].head_count,
+                                                        &pre_proc_info, NULL, thresh_value, &_result);
+        compare_results(_models[m].name, "descriptor", frame, reference_status, status);
+
+        if (0 == reference_status)
+            box_total += _reference_result.box_count;
+        else
+            failed_frame_count++;
+    }
+
+    printf("%-16s %s: %d random frames (%d output boxes, %d frames over the candidate limit) match the former decoder\n", _models[m].name,
+           quantized ? "int8 values" : "float values", RANDOM_FRAME_COUNT, box_total, failed_frame_count);
+
+EXIT:
+    for (int h = 0; h < _models[m].head_count; h++)
+        release_node(nodes[h]);
+}
+
+int main(int argc, char *argv[])
+{
+    for (int m = 0; m < (int)(sizeof(_models) / sizeof(_models[0])); m++)
+    {
+        for (int quantized = 0; quantized <= 1; quantized++)
+        {
+            post_process_yolo_context_t *context = post_process_yolo_create_context();
+            if (NULL == context)
+                return -1;
+
+            test_model(m, context, quantized);
+
+            post_process_yolo_release_context(context);
+        }
+    }
+
+    // a failed post_process_yolo_v5_720() reports the error and leaves no boxes of a former frame
+    _result.box_count = 1;
+    if ((0 == post_process_yolo_v5_720(NULL, 0, NULL, 0.5f, &_result)) || (0 != _result.box_count))
+    {
+        printf("FAIL yolo_v5_720: failure is not reported\n");
+        _failure_count++;
+    }
+
+    if (0 != _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    return 0;
+}
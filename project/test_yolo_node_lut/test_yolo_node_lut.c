@@ -0,0 +1,230 @@
+/**
+ * @file        test_yolo_node_lut.c
+ * @brief       max error of the per-node sigmoid/exp lookup tables of postprocess.c against expf() and a float sigmoid, with timing
+ * @version     0.1
+ * @date        2026-10-18
+ *
+ * @copyright   Copyright (c) 2026 Kneron Inc. All rights reserved.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* the lookup functions are static, postprocess.c is built as part of this file */
+#include "../../ex_common/postprocess.c"
+
+#define MAX_SIGMOID_ERROR 2.5e-7    // absolute, about 2 float ulp near 1
+#define MAX_EXP_RELATIVE_ERROR 2.5e-7
+#define TIMING_VALUE_COUNT 4000000
+
+typedef struct
+{
+    int32_t radix;
+    float scale;
+} quantization_t;
+
+/* quantization of int8/int16 nodes from a coarse one (range of about +-128) to a fine one (about +-0.25) */
+static const quantization_t _quantizations[] = {
+    {0, 1.0f}, {2, 1.0f}, {4, 0.7f}, {5, 1.3f}, {7, 0.9f}, {9, 1.0f},
+};
+
+static uint32_t _random_state = 0x510e527f;
+
+static int _failure_count = 0;
+
+static float _timing_values[TIMING_VALUE_COUNT];
+
+static double get_time_ms()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec * 1000.0 + (double)time.tv_nsec / 1000000.0;
+}
+
+static uint32_t random_next()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 17;
+    _random_state ^= _random_state << 5;
+
+    return _random_state;
+}
+
+static float reference_sigmoid(float x)
+{
+    return 1.0f / (1.0f + expf(-x));
+}
+
+static void make_node_view(kp_inf_node_view_t *node_view, uint32_t fixed_point_dtype, const quantization_t *quantization)
+{
+    memset(node_view, 0, sizeof(kp_inf_node_view_t));
+    node_view->fixed_point_dtype = fixed_point_dtype;
+    node_view->quantization_parameters_len = 1;
+    node_view->quantization_factor = quantization->scale * powf(2.0f, (float)quantization->radix);
+}
+
+/* every fixed-point value of one node: the table is hit and its entries are within the error bounds */
+static void check_node_lut(uint32_t fixed_point_dtype, const quantization_t *quantization, post_process_yolo_context_t *context)
+{
+    kp_inf_node_view_t node_view;
+    post_process_node_lut_t *lut = NULL;
+    int32_t fixed_point_min = (KP_FIXED_POINT_DTYPE_INT8 == fixed_point_dtype) ? INT8_MIN : INT16_MIN;
+    int32_t fixed_point_max = (KP_FIXED_POINT_DTYPE_INT8 == fixed_point_dtype) ? INT8_MAX : INT16_MAX;
+    const char *dtype_name = (KP_FIXED_POINT_DTYPE_INT8 == fixed_point_dtype) ? "int8" : "int16";
+    double max_sigmoid_error = 0;
+    double max_exp_error = 0;
+    int miss_count = 0;
+
+    make_node_view(&node_view, fixed_point_dtype, quantization);
+
+    if ((0 != post_process_yolo_set_node_quantization(context, 0, &node_view)) || (NULL == (lut = yolo_node_lut(context, 0))))
+    {
+        printf("FAIL %s radix %d scale %g: node is not tabulated\n", dtype_name, quantization->radix, quantization->scale);
+        _failure_count++;
+        return;
+    }
+
+    for (int32_t value = fixed_point_min; value <= fixed_point_max; value++)
+    {
+        // the same dequantization as kp_generic_inference_retrieve_float_node()
+        float x = (float)value / node_view.quantization_factor;
+
+        if (value - fixed_point_min != node_lut_index(lut, x))
+        {
+            miss_count++;
+            continue;
+        }
+
+        double sigmoid_error = fabs((double)node_lut_sigmoid(lut, x) - (double)reference_sigmoid(x));
+        double exp_error = 0;
+
+        // the double table goes on where expf() overflows or underflows, it is checked against exp() there
+        if (isnormal(expf(x)))
+            exp_error = fabs(node_lut_exp(lut, x) - (double)expf(x)) / (double)expf(x);
+        else if (node_lut_exp(lut, x) != exp(x))
+            exp_error = INFINITY;
+
+        if (sigmoid_error > max_sigmoid_error)
+            max_sigmoid_error = sigmoid_error;
+        if (exp_error > max_exp_error)
+            max_exp_error = exp_error;
+
+        // values off the fixed-point grid are not looked up
+        float off_grid = nextafterf(x, INFINITY);
+        if ((0 <= node_lut_index(lut, off_grid)) || (node_lut_sigmoid(lut, off_grid) != sigmoid(off_grid)) || (node_lut_exp(lut, off_grid) != exp(off_grid)))
+        {
+            printf("FAIL %s radix %d scale %g: value %.9g off the grid is looked up\n", dtype_name, quantization->radix, quantization->scale, off_grid);
+            _failure_count++;
+            return;
+        }
+    }
+
+    printf("%-5s radix %2d scale %.1f: [%9.4f, %9.4f], max sigmoid error %.3g, max exp relative error %.3g\n", dtype_name, quantization->radix,
+           quantization->scale, (float)fixed_point_min / node_view.quantization_factor, (float)fixed_point_max / node_view.quantization_factor,
+           max_sigmoid_error, max_exp_error);
+
+    if ((0 != miss_count) || (MAX_SIGMOID_ERROR < max_sigmoid_error) || (MAX_EXP_RELATIVE_ERROR < max_exp_error))
+    {
+        printf("FAIL %s radix %d scale %g: %d values not looked up or error over bound\n", dtype_name, quantization->radix, quantization->scale, miss_count);
+        _failure_count++;
+    }
+}
+
+/* channel-wise quantized and float nodes are not tabulated, a retabulated node follows its new quantization */
+static void check_untabulated_nodes(post_process_yolo_context_t *context)
+{
+    kp_inf_node_view_t node_view;
+
+    make_node_view(&node_view, KP_FIXED_POINT_DTYPE_INT8, &_quantizations[0]);
+    node_view.quantized_axis_stride = 16;
+
+    if ((0 != post_process_yolo_set_node_quantization(context, 1, &node_view)) || (NULL != yolo_node_lut(context, 1)))
+    {
+        printf("FAIL channel-wise quantized node is tabulated\n");
+        _failure_count++;
+    }
+
+    make_node_view(&node_view, KP_FIXED_POINT_DTYPE_UNKNOWN, &_quantizations[0]);
+
+    if ((0 != post_process_yolo_set_node_quantization(context, 2, &node_view)) || (NULL != yolo_node_lut(context, 2)))
+    {
+        printf("FAIL node of unknown fixed-point type is tabulated\n");
+        _failure_count++;
+    }
+
+    make_node_view(&node_view, KP_FIXED_POINT_DTYPE_INT8, &_quantizations[1]);
+    post_process_yolo_set_node_quantization(context, 3, &node_view);
+    make_node_view(&node_view, KP_FIXED_POINT_DTYPE_INT8, &_quantizations[2]);
+    post_process_yolo_set_node_quantization(context, 3, &node_view);
+
+    if ((NULL == yolo_node_lut(context, 3)) || (yolo_node_lut(context, 3)->quantization_factor != node_view.quantization_factor) ||
+        (yolo_node_lut(context, 3)->sigmoid_table[0] != sigmoid((float)INT8_MIN / node_view.quantization_factor)))
+    {
+        printf("FAIL retabulated node keeps its former quantization\n");
+        _failure_count++;
+    }
+}
+
+/* lookups of random fixed-point values of an int8 node against sigmoid()/exp() */
+static void time_node_lut(post_process_yolo_context_t *context)
+{
+    kp_inf_node_view_t node_view;
+    post_process_node_lut_t *lut = NULL;
+    double start_time = 0;
+    double lut_time = 0, function_time = 0;
+    volatile double sum = 0;
+
+    make_node_view(&node_view, KP_FIXED_POINT_DTYPE_INT8, &_quantizations[3]);
+    post_process_yolo_set_node_quantization(context, 0, &node_view);
+    lut = yolo_node_lut(context, 0);
+
+    for (int i = 0; i < TIMING_VALUE_COUNT; i++)
+        _timing_values[i] = (float)((int32_t)(random_next() % 256) + INT8_MIN) / node_view.quantization_factor;
+
+    start_time = get_time_ms();
+    for (int i = 0; i < TIMING_VALUE_COUNT; i++)
+        sum += node_lut_sigmoid(lut, _timing_values[i]) + node_lut_exp(lut, _timing_values[i]);
+    lut_time = get_time_ms() - start_time;
+
+    start_time = get_time_ms();
+    for (int i = 0; i < TIMING_VALUE_COUNT; i++)
+        sum += sigmoid(_timing_values[i]) + exp(_timing_values[i]);
+    function_time = get_time_ms() - start_time;
+
+    printf("\n%d int8 values, sigmoid + exp: lookup tables %.2f ns, sigmoid()/exp() %.2f ns per value\n", TIMING_VALUE_COUNT,
+           lut_time * 1000000.0 / TIMING_VALUE_COUNT, function_time * 1000000.0 / TIMING_VALUE_COUNT);
+}
+
+int main(int argc, char *argv[])
+{
+    post_process_yolo_context_t *context = post_process_yolo_create_context();
+
+    if (NULL == context)
+        return -1;
+
+    for (int i = 0; i < (int)(sizeof(_quantizations) / sizeof(_quantizations[0])); i++)
+        check_node_lut(KP_FIXED_POINT_DTYPE_INT8, &_quantizations[i], context);
+
+    for (int i = 0; i < (int)(sizeof(_quantizations) / sizeof(_quantizations[0])); i++)
+    {
+        quantization_t quantization = {_quantizations[i].radix + 8, _quantizations[i].scale};
+        check_node_lut(KP_FIXED_POINT_DTYPE_INT16, &quantization, context);
+    }
+
+    check_untabulated_nodes(context);
+    time_node_lut(context);
+
+    post_process_yolo_release_context(context);
+
+    if (0 != _failure_count)
+    {
+        printf("%d failures\n", _failure_count);
+        return -1;
+    }
+
+    return 0;
+}
@@ -170,6 +170,17 @@ typedef struct
  */
 typedef uintptr_t kp_nef_handler_t;
 
+/**
+ * @brief state of a NEF file on disk, a file whose state is unchanged since its CRC was verified is not verified again
+ */
+typedef struct
+{
+    long long size;                             /**< file size */
+    long long ino;                              /**< inode number, 0 if the file system has none */
+    long long mtime_sec;                        /**< last modification time */
+    long mtime_nsec;                            /**< nanoseconds of the last modification time, 0 if not available */
+} kp_nef_file_stat_t;
+
 /******************************************************************
  * [private] utils
  ******************************************************************/
@@ -219,7 +230,7 @@ uint32_t convert_data_format_to_kp_tensor_format(uint32_t data_format, uint32_t
  * [public] kneron_nef_reader
  ******************************************************************/
 
-int read_nef_content_table(char* nef_data, uint32_t nef_size, kp_nef_handler_t *nef_handler);
+int read_nef_content_table(char* nef_data, uint32_t nef_size, bool check_crc, kp_nef_handler_t *nef_handler);
 int read_nef_header_information(kp_nef_handler_t *nef_handler, kp_metadata_t *metadata);
 int read_nef_model_info_list(kp_nef_handler_t *nef_handler, kp_nef_model_info_list_t *model_info_handler);
 int read_nef_model_info(kp_nef_model_info_list_t *model_info_handler, uint32_t index, kp_nef_model_info_t *model_info);
@@ -234,6 +245,15 @@ int deconstruct_model_nef_descriptor(kp_model_nef_descriptor_t* loaded_model_des
 int build_model_nef_descriptor_from_nef(kp_nef_handler_t *nef_handler, kp_metadata_t *metadata, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t* loaded_model_desc);
 int build_model_nef_descriptor_from_device(kp_nef_handler_t *nef_handler, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t* loaded_model_desc);
 int load_model_info_from_nef(void *nef_buf, int nef_size, kp_product_id_t target_pid /* input */, kp_metadata_t *metadata, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t *loaded_model_desc /* output */);
+int get_nef_file_stat(const char *file_path, kp_nef_file_stat_t *file_stat);
+int load_model_info_from_nef_file(const char *file_path, const kp_nef_file_stat_t *file_stat, void *nef_buf, int nef_size, kp_product_id_t target_pid /* input */, kp_metadata_t *metadata, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t *loaded_model_desc /* output */);
+int construct_model_des_quantization_reciprocal_factor(kp_model_nef_descriptor_t* loaded_model_desc);
+
+/******************************************************************
+ * [public] kp_inference
+ ******************************************************************/
+
+int build_quantization_factor_table(kp_quantization_parameters_v1_t* quantization_parameters_v1, bool is_reciprocal, float *quantization_factor_table);
 
 /******************************************************************
  * [public] model_descriptor_copier
@@ -1279,7 +1279,9 @@ static int check_fw_is_loaded(kp_device_group_t devices)
     return ret;
 }
 
-int kp_load_model(kp_device_group_t devices, void *nef_buf, int nef_size, kp_model_nef_descriptor_t *model_desc)
+/* 'file_path' and 'file_stat' describe the file 'nef_buf' was read from, NULL for a NEF given in a buffer */
+static int _load_model(kp_device_group_t devices, const char *file_path, const kp_nef_file_stat_t *file_stat, void *nef_buf, int nef_size,
+                       kp_model_nef_descriptor_t *model_desc)
 {
     _kp_devices_group_t *_devices_grp = (_kp_devices_group_t *)devices;
 
@@ -1296,7 +1298,11 @@ int kp_load_model(kp_device_group_t devices, void *nef_buf, int nef_size, kp_mod
     if (KP_SUCCESS != ret)
         return ret;
 
-    ret = load_model_info_from_nef(nef_buf, nef_size, _devices_grp->product_id, &metadata, &nef_info, &(_devices_grp->loaded_model_desc));
+    if (NULL == file_path)
+        ret = load_model_info_from_nef(nef_buf, nef_size, _devices_grp->product_id, &metadata, &nef_info, &(_devices_grp->loaded_model_desc));
+    else
+        ret = load_model_info_from_nef_file(file_path, file_stat, nef_buf, nef_size, _devices_grp->product_id, &metadata, &nef_info,
+                                            &(_devices_grp->loaded_model_desc));
 
     if (KP_SUCCESS != ret)
         return ret;
@@ -1369,8 +1375,9 @@ int kp_load_model(kp_device_group_t devices, void *nef_buf, int nef_size, kp_mod
             return ret;
     }
 
+    // the NEF was parsed into the device group descriptor above
     if ((KP_SUCCESS == ret) && (NULL != model_desc))
-        ret = load_model_info_from_nef(nef_buf, nef_size, _devices_grp->product_id, &metadata, &nef_info, model_desc);
+        ret = copy_model_nef_descriptor(model_desc, &(_devices_grp->loaded_model_desc));
 
     if (KP_SUCCESS == ret)
         ret = _kp_allocate_ddr_memory(devices);
@@ -1378,6 +1385,11 @@ int kp_load_model(kp_device_group_t devices, void *nef_buf, int nef_size, kp_mod
     return ret;
 }
 
+int kp_load_model(kp_device_group_t devices, void *nef_buf, int nef_size, kp_model_nef_descriptor_t *model_desc)
+{
+    return _load_model(devices, NULL, NULL, nef_buf, nef_size, model_desc);
+}
+
 // coverity[ -taint_source : arg-0 ]
 static size_t custom_fread(void *ptr, size_t size, size_t count, FILE *stream)
 {
@@ -1434,11 +1446,16 @@ static char *read_file_to_buffer_auto_malloc(const char *file_path, long *buffer
 int kp_load_model_from_file(kp_device_group_t devices, const char *file_path, kp_model_nef_descriptor_t *model_desc)
 {
     long nef_size;
+    kp_nef_file_stat_t file_stat;
+
+    // the state of the file before reading it, the CRC of an unchanged file verified before is not calculated again
+    bool file_stat_known = (KP_SUCCESS == get_nef_file_stat(file_path, &file_stat));
+
     char *nef_buf = read_file_to_buffer_auto_malloc(file_path, &nef_size);
     if (!nef_buf)
         return KP_ERROR_FILE_OPEN_FAILED_20;
 
-    int ret = kp_load_model(devices, (void *)nef_buf, (int)nef_size, model_desc);
+    int ret = _load_model(devices, file_path, file_stat_known ? &file_stat : NULL, (void *)nef_buf, (int)nef_size, model_desc);
 
     free(nef_buf);
 
@@ -1461,6 +1478,7 @@ int kp_load_encrypted_models(kp_device_group_t devices, void *nef_buf[], int nef
     kp_metadata_t metadata[MAX_GROUP_DEVICE];
     kp_nef_info_t nef_info[MAX_GROUP_DEVICE];
     kp_model_nef_descriptor_t temp_model_desc[MAX_GROUP_DEVICE];
+    memset(temp_model_desc, 0, sizeof(temp_model_desc));
 
     uint32_t transfer_size = 0;
     _load_model_command_package cmd_packs[MAX_GROUP_DEVICE];
@@ -1532,13 +1550,14 @@ int kp_load_encrypted_models(kp_device_group_t devices, void *nef_buf[], int nef
     _spawn_thread_to_load_model_to_devices(_devices_grp->num_device, cmd_packs, load_model_thd);
 
     if (ret == KP_SUCCESS) {
-        ret = load_model_info_from_nef(nef_buf[0], nef_size, _devices_grp->product_id, &metadata[0], &nef_info[0], &_devices_grp->loaded_model_desc);
+        // the NEFs were parsed into temp_model_desc above
+        ret = copy_model_nef_descriptor(&_devices_grp->loaded_model_desc, &temp_model_desc[0]);
         if (ret != KP_SUCCESS) {
             goto FUNC_OUT;
         }
 
         if (model_desc != NULL) {
-            ret = load_model_info_from_nef(nef_buf[0], nef_size, _devices_grp->product_id, &metadata[0], &nef_info[0], model_desc);
+            ret = copy_model_nef_descriptor(model_desc, &temp_model_desc[0]);
             if (ret != KP_SUCCESS) {
                 goto FUNC_OUT;
             }
@@ -15,6 +15,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <float.h>
+#include <stddef.h>
 
 #include "kp_inference.h"
 #include "kp_usb.h"
@@ -274,6 +275,33 @@ static int get_quantization_parameters_v1_information(kp_quantization_parameters
     return KP_SUCCESS;
 }
 
+int build_quantization_factor_table(kp_quantization_parameters_v1_t* quantization_parameters_v1, bool is_reciprocal, float *quantization_factor_table)
+{
+    int status  = KP_SUCCESS;
+    int radix   = 0;
+    float scale = 0;
+
+    if ((NULL == quantization_parameters_v1) ||
+        (NULL == quantization_factor_table)) {
+        printf("error: NULL pointer input parameter\n");
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    /* same factor as get_quantization_parameters_factor(), computed once for each fixed-point descriptor */
+    for (uint32_t idx = 0; idx < quantization_parameters_v1->quantized_fixed_point_descriptor_num; idx++) {
+        status = get_quantization_parameters_v1_information(quantization_parameters_v1, idx, &radix, &scale);
+        if (KP_SUCCESS != status)
+            return status;
+
+        if (is_reciprocal)
+            quantization_factor_table[idx] = (float)1 / (float)(scale * pow2(radix));
+        else
+            quantization_factor_table[idx] = (float)(scale * pow2(radix));
+    }
+
+    return KP_SUCCESS;
+}
+
 inline static int get_quantization_parameters_factor(kp_quantization_parameters_v1_t* quantization_parameters_v1, bool is_channel_wise_quantization, int onnx_data_buf_offset, int quantized_axis_stride, int *quantized_fixed_point_descriptor_idx, float *quantization_factor)
 {
     int status  = KP_SUCCESS;
@@ -1666,7 +1694,9 @@ kp_inf_float_node_output_t *kp_generic_inference_retrieve_float_node(uint32_t no
     kp_quantization_parameters_v1_t *quantization_parameters_v1 = NULL;
 
     float quantization_factor                                   = 0;
+    float *quantization_factor_table                            = NULL;
     int quantized_axis_stride                                   = 0;
+    uint32_t quantized_axis_end                                 = 0;
     int quantized_fixed_point_descriptor_idx                    = 0;
     bool is_channel_wise_quantization                           = false;
 
@@ -1980,6 +2010,26 @@ kp_inf_float_node_output_t *kp_generic_inference_retrieve_float_node(uint32_t no
                             quantized_axis_stride *= tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2.shape[axis];
                         }
                     }
+                } else {
+                    /* all data share the first fixed-point descriptor */
+                    quantized_axis_stride = (0 < num_data) ? num_data : 1;
+                }
+            }
+
+            /* precompute quantization factor of each channel, the factor is switched every quantized_axis_stride ONNX data */
+            {
+                quantization_factor_table = (float *)malloc(quantization_parameters_v1->quantized_fixed_point_descriptor_num * sizeof(float));
+
+                if ((0 >= quantized_axis_stride) ||
+                    (NULL == quantization_factor_table) ||
+                    (((num_data + quantized_axis_stride - 1) / quantized_axis_stride) > quantization_parameters_v1->quantized_fixed_point_descriptor_num)) {
+                    printf("error: build quantization factor table fail ...\n");
+                    goto FUNC_OUT_ERROR;
+                }
+
+                if (KP_SUCCESS != build_quantization_factor_table(quantization_parameters_v1, false, quantization_factor_table)) {
+                    printf("error: get quantization parameters factor fail ...\n");
+                    goto FUNC_OUT_ERROR;
                 }
             }
 
@@ -2023,14 +2073,9 @@ kp_inf_float_node_output_t *kp_generic_inference_retrieve_float_node(uint32_t no
                             npu_data_buf_offset += (onnx_data_shape_index[channel_idx] >> 4) * npu_channel_group_stride;
                         }
 
-                        if (KP_SUCCESS != get_quantization_parameters_factor(quantization_parameters_v1,
-                                                                             is_channel_wise_quantization,
-                                                                             onnx_data_buf_offset,
-                                                                             quantized_axis_stride,
-                                                                             &quantized_fixed_point_descriptor_idx,
-                                                                             &quantization_factor)) {
-                            printf("error: get quantization parameters factor fail ...\n");
-                            goto FUNC_OUT_ERROR;
+                        if (onnx_data_buf_offset == quantized_axis_end) {
+                            quantization_factor = quantization_factor_table[quantized_fixed_point_descriptor_idx++];
+                            quantized_axis_end += quantized_axis_stride;
                         }
 
                         float_node_output->data[onnx_data_buf_offset] = ((int8_t *)raw_fixed_node_output->data)[npu_data_buf_offset] / quantization_factor;
@@ -2062,14 +2107,9 @@ kp_inf_float_node_output_t *kp_generic_inference_retrieve_float_node(uint32_t no
                             npu_data_buf_offset += onnx_data_shape_index[axis] * tensor_shape_info_v2->stride_npu[axis];
                         }
 
-                        if (KP_SUCCESS != get_quantization_parameters_factor(quantization_parameters_v1,
-                                                                             is_channel_wise_quantization,
-                                                                             onnx_data_buf_offset,
-                                                                             quantized_axis_stride,
-                                                                             &quantized_fixed_point_descriptor_idx,
-                                                                             &quantization_factor)) {
-                            printf("error: get quantization parameters factor fail ...\n");
-                            goto FUNC_OUT_ERROR;
+                        if (onnx_data_buf_offset == quantized_axis_end) {
+                            quantization_factor = quantization_factor_table[quantized_fixed_point_descriptor_idx++];
+                            quantized_axis_end += quantized_axis_stride;
                         }
 
                         npu_data_element_16b                            = ((uint16_t *)raw_fixed_node_output->data)[npu_data_buf_offset];
@@ -2125,14 +2165,9 @@ kp_inf_float_node_output_t *kp_generic_inference_retrieve_float_node(uint32_t no
                         /* npu_data_buf_offset = (npu_data_buf_offset / 16) * 32 + (npu_data_buf_offset % 16) */
                         npu_data_buf_offset = ((npu_data_buf_offset >> 4) << 5) + (npu_data_buf_offset & 15u);
 
-                        if (KP_SUCCESS != get_quantization_parameters_factor(quantization_parameters_v1,
-                                                                             is_channel_wise_quantization,
-                                                                             onnx_data_buf_offset,
-                                                                             quantized_axis_stride,
-                                                                             &quantized_fixed_point_descriptor_idx,
-                                                                             &quantization_factor)) {
-                            printf("error: get quantization parameters factor fail ...\n");
-                            goto FUNC_OUT_ERROR;
+                        if (onnx_data_buf_offset == quantized_axis_end) {
+                            quantization_factor = quantization_factor_table[quantized_fixed_point_descriptor_idx++];
+                            quantized_axis_end += quantized_axis_stride;
                         }
 
                         float_node_output->data[onnx_data_buf_offset] = (float)((int16_t)(((((uint16_t)(((uint8_t *)raw_fixed_node_output->data)[npu_data_buf_offset])) & 0x007fu) +
@@ -2170,6 +2205,9 @@ kp_inf_float_node_output_t *kp_generic_inference_retrieve_float_node(uint32_t no
     if (NULL != onnx_data_shape_index)
         free(onnx_data_shape_index);
 
+    if (NULL != quantization_factor_table)
+        free(quantization_factor_table);
+
     return float_node_output;
 
 FUNC_OUT_ERROR:
@@ -2180,9 +2218,976 @@ FUNC_OUT_ERROR:
     if (NULL != onnx_data_shape_index)
         free(onnx_data_shape_index);
 
+    if (NULL != quantization_factor_table)
+        free(quantization_factor_table);
+
     return float_node_output;
 }
 
+static int get_node_view_quantization_parameter(kp_inf_node_view_t *node_view, uint32_t quantized_fixed_point_descriptor_idx, int32_t *radix, float *scale)
+{
+    if (quantized_fixed_point_descriptor_idx >= node_view->quantization_parameters_len) {
+        printf("error: index of quantization parameters out of range\n");
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    switch (node_view->radix_dtype)
+    {
+    case KP_DTYPE_INT8:
+        *radix = ((int8_t *)node_view->radix)[quantized_fixed_point_descriptor_idx];
+        break;
+    case KP_DTYPE_INT16:
+        *radix = ((int16_t *)node_view->radix)[quantized_fixed_point_descriptor_idx];
+        break;
+    case KP_DTYPE_INT32:
+        *radix = ((int32_t *)node_view->radix)[quantized_fixed_point_descriptor_idx];
+        break;
+    default:
+        printf("error: get invalide KneronKNE_DataType_enum_t ...\n");
+        return KP_ERROR_INVALID_MODEL_21;
+    }
+
+    switch (node_view->scale_dtype)
+    {
+    case KP_DTYPE_INT8:
+        *scale = (float)((int8_t *)node_view->scale)[quantized_fixed_point_descriptor_idx];
+        break;
+    case KP_DTYPE_INT16:
+        *scale = (float)((int16_t *)node_view->scale)[quantized_fixed_point_descriptor_idx];
+        break;
+    case KP_DTYPE_INT32:
+        *scale = (float)((int32_t *)node_view->scale)[quantized_fixed_point_descriptor_idx];
+        break;
+    case KP_DTYPE_UINT8:
+        *scale = (float)((uint8_t *)node_view->scale)[quantized_fixed_point_descriptor_idx];
+        break;
+    case KP_DTYPE_UINT16:
+        *scale = (float)((uint16_t *)node_view->scale)[quantized_fixed_point_descriptor_idx];
+        break;
+    case KP_DTYPE_UINT32:
+        *scale = (float)((uint32_t *)node_view->scale)[quantized_fixed_point_descriptor_idx];
+        break;
+    case KP_DTYPE_FLOAT32:
+        *scale = ((float *)node_view->scale)[quantized_fixed_point_descriptor_idx];
+        break;
+    default:
+        printf("error: get invalide KneronKNE_DataType_enum_t ...\n");
+        return KP_ERROR_INVALID_MODEL_21;
+    }
+
+    return KP_SUCCESS;
+}
+
+inline static int get_node_view_quantization_factor(kp_inf_node_view_t *node_view, uint32_t onnx_data_buf_offset, float *quantization_factor)
+{
+    int status  = KP_SUCCESS;
+    int32_t radix = 0;
+    float scale = 0;
+
+    if (0 == node_view->quantized_axis_stride) {
+        *quantization_factor = node_view->quantization_factor;
+        return KP_SUCCESS;
+    }
+
+    /* same descriptor index as the sequential walk of get_quantization_parameters_factor() */
+    status = get_node_view_quantization_parameter(node_view, onnx_data_buf_offset / node_view->quantized_axis_stride, &radix, &scale);
+    if (KP_SUCCESS != status)
+        return status;
+
+    *quantization_factor = (float)(scale * pow2(radix));
+
+    return KP_SUCCESS;
+}
+
+inline static int32_t read_node_view_fixed_point_value(kp_inf_node_view_t *node_view, uint32_t npu_data_buf_offset)
+{
+    uint8_t *npu_data = node_view->data;
+
+    if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1 == node_view->shape_version) {
+        if (KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B == node_view->data_layout)
+            return ((int16_t *)npu_data)[npu_data_buf_offset];
+
+        return ((int8_t *)npu_data)[npu_data_buf_offset];
+    }
+
+    switch (node_view->data_layout)
+    {
+    case KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_RAW_16B:
+        return (int16_t)(((uint16_t *)npu_data)[npu_data_buf_offset] & 0xfffeu);
+    case KP_MODEL_TENSOR_DATA_LAYOUT_4W4C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL_CH_COMPACT:
+    case KP_MODEL_TENSOR_DATA_LAYOUT_16W1C8BHL:
+        /* npu_data_buf_offset = (npu_data_buf_offset / 16) * 32 + (npu_data_buf_offset % 16) */
+        npu_data_buf_offset = ((npu_data_buf_offset >> 4) << 5) + (npu_data_buf_offset & 15u);
+
+        return (int16_t)((((uint16_t)npu_data[npu_data_buf_offset] & 0x007fu) + ((uint16_t)npu_data[npu_data_buf_offset + 16] << 7)) << 1);
+    default:
+        return ((int8_t *)npu_data)[npu_data_buf_offset];
+    }
+}
+
+static uint32_t get_node_view_npu_data_offset(kp_inf_node_view_t *node_view, int32_t *index)
+{
+    uint32_t npu_data_buf_offset = 0;
+
+    for (uint32_t axis = 0; axis < node_view->shape_len; axis++)
+        npu_data_buf_offset += index[axis] * node_view->stride_npu[axis];
+
+    if (0 <= node_view->channel_group_axis)
+        npu_data_buf_offset += (index[node_view->channel_group_axis] >> 4) * node_view->channel_group_stride;
+
+    return npu_data_buf_offset;
+}
+
+static uint32_t get_node_view_onnx_data_offset(kp_inf_node_view_t *node_view, int32_t *index)
+{
+    uint32_t onnx_data_buf_offset = 0;
+
+    for (uint32_t axis = 0; axis < node_view->shape_len; axis++)
+        onnx_data_buf_offset += index[axis] * node_view->stride_onnx[axis];
+
+    return onnx_data_buf_offset;
+}
+
+static int read_node_view_float_line(kp_inf_node_view_t *node_view, int32_t *index, int32_t axis, int32_t count, float *buffer)
+{
+    int status                      = KP_SUCCESS;
+    int32_t start                   = index[axis];
+    uint32_t npu_data_buf_offset    = get_node_view_npu_data_offset(node_view, index);
+    uint32_t onnx_data_buf_offset   = get_node_view_onnx_data_offset(node_view, index);
+    uint32_t npu_stride             = node_view->stride_npu[axis];
+    uint32_t onnx_stride            = node_view->stride_onnx[axis];
+    float quantization_factor       = node_view->quantization_factor;
+    const float *reciprocal_table   = node_view->quantization_reciprocal_factor;
+    float reciprocal_factor         = 0;
+    uint32_t first_factor_idx       = 0;
+    uint32_t last_factor_idx        = 0;
+
+    if (NULL != reciprocal_table) {
+        if (0 != node_view->quantized_axis_stride) {
+            first_factor_idx    = onnx_data_buf_offset / node_view->quantized_axis_stride;
+            last_factor_idx     = (onnx_data_buf_offset + (count - 1) * onnx_stride) / node_view->quantized_axis_stride;
+        }
+
+        if (last_factor_idx >= node_view->quantization_parameters_len) {
+            printf("error: index of quantization parameters out of range\n");
+            return KP_ERROR_INVALID_PARAM_12;
+        }
+
+        /* one factor for the whole line unless the line runs across the quantized axis */
+        reciprocal_factor = reciprocal_table[first_factor_idx];
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        uint32_t npu_offset = npu_data_buf_offset + i * npu_stride;
+
+        if (axis == node_view->channel_group_axis)
+            npu_offset += (((start + i) >> 4) - (start >> 4)) * node_view->channel_group_stride;
+
+        if (NULL != reciprocal_table) {
+            if (first_factor_idx != last_factor_idx)
+                reciprocal_factor = reciprocal_table[(onnx_data_buf_offset + i * onnx_stride) / node_view->quantized_axis_stride];
+
+            buffer[i] = (float)read_node_view_fixed_point_value(node_view, npu_offset) * reciprocal_factor;
+            continue;
+        }
+
+        if (0 != node_view->quantized_axis_stride) {
+            status = get_node_view_quantization_factor(node_view, onnx_data_buf_offset + i * onnx_stride, &quantization_factor);
+            if (KP_SUCCESS != status)
+                return status;
+        }
+
+        buffer[i] = (float)read_node_view_fixed_point_value(node_view, npu_offset) / quantization_factor;
+    }
+
+    return status;
+}
+
+static bool is_node_view_index_valid(kp_inf_node_view_t *node_view, int32_t *index)
+{
+    for (uint32_t axis = 0; axis < node_view->shape_len; axis++) {
+        if ((0 > index[axis]) || (index[axis] >= node_view->shape[axis]))
+            return false;
+    }
+
+    return true;
+}
+
+int kp_generic_inference_retrieve_node_view(uint32_t node_idx, uint8_t *raw_out_buffer, kp_inf_node_view_t *node_view)
+{
+    kp_inference_header_stamp_t *header_stamp               = (kp_inference_header_stamp_t *)raw_out_buffer;
+    kdp2_ipc_generic_raw_result_t_v1 *raw_result_v1         = NULL;
+    kdp2_ipc_generic_raw_result_t_v2 *raw_result_v2         = NULL;
+    _kl520_output_node_metadata_t *kl520_node_desc          = NULL;
+    _720_raw_cnn_res_t *pRawHead_720                        = NULL;
+    _630_raw_cnn_res_t *pRawHead_630                        = NULL;
+    npu_data_header_t *npu_data_heade                       = NULL;
+    npu_data_single_node_header_v2_t *output_node_header    = NULL;
+
+    int status                                              = KP_SUCCESS;
+    uint8_t *data_start                                     = NULL;
+    uint32_t raw_offset                                     = 0;
+    uint32_t out_node_num                                   = 0;
+    uint32_t npu_channel_group_stride_tmp                   = 0;
+    int32_t radix                                           = 0;
+    float scale                                             = 0;
+
+    int32_t batch                                           = 0;
+    int32_t channel                                         = 0;
+    int32_t height                                          = 0;
+    int32_t width                                           = 0;
+    int32_t width_aligned                                   = 0;
+
+    if ((NULL == raw_out_buffer) ||
+        (NULL == node_view)) {
+        printf("%s, NULL pointer input parameter.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    memset(node_view, 0, sizeof(kp_inf_node_view_t));
+    node_view->channel_group_axis = -1;
+
+    if (KDP2_MAGIC_TYPE_INFERENCE == header_stamp->magic_type) {
+        raw_result_v1 = (kdp2_ipc_generic_raw_result_t *)raw_out_buffer;
+
+        node_view->name             = "";
+        node_view->product_id       = raw_result_v1->product_id;
+        node_view->shape_version    = KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1;
+
+        switch (raw_result_v1->product_id)
+        {
+        case KP_DEVICE_KL520:
+        {
+            data_start      = raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t);
+            out_node_num    = *(uint32_t *)data_start;
+            if (node_idx >= out_node_num) {
+                printf("%s, invalid node index.\n", __func__);
+                return KP_ERROR_INVALID_PARAM_12;
+            }
+
+            kl520_node_desc = (_kl520_output_node_metadata_t *)(data_start + 4);
+
+            raw_offset = 4 + out_node_num * sizeof(_kl520_output_node_metadata_t);
+            for (uint32_t i = 0; i < node_idx; i++)
+                raw_offset += kl520_node_desc[i].height * kl520_node_desc[i].channel * round_up(kl520_node_desc[i].width, KDP_COL_MIN_16); // Note: Currently, kl520 output is only support 16W1C8B npu data layout.
+
+            node_view->index        = node_idx;
+            node_view->data         = data_start + raw_offset;
+            node_view->data_layout  = convert_data_format_to_kp_tensor_format(kl520_node_desc[node_idx].data_layout, KP_MODEL_TARGET_CHIP_KL520);
+
+            batch   = 1;
+            channel = kl520_node_desc[node_idx].channel;
+            height  = kl520_node_desc[node_idx].height;
+            width   = kl520_node_desc[node_idx].width;
+            radix   = kl520_node_desc[node_idx].radix;
+            scale   = kl520_node_desc[node_idx].scale;
+        }
+        break;
+
+        case KP_DEVICE_KL720:
+        {
+            pRawHead_720 = (_720_raw_cnn_res_t *)(raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t));
+            if ((0 >= pRawHead_720->total_nodes) || (node_idx >= (uint32_t)pRawHead_720->total_nodes)) {
+                printf("%s, invalid node index.\n", __func__);
+                return KP_ERROR_INVALID_PARAM_12;
+            }
+
+            node_view->index        = pRawHead_720->onode_a[node_idx].output_index;
+            node_view->data         = raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t) + sizeof(_720_raw_cnn_res_t) + pRawHead_720->onode_a[node_idx].start_offset;
+            node_view->data_layout  = convert_data_format_to_kp_tensor_format(pRawHead_720->onode_a[node_idx].data_format, KP_MODEL_TARGET_CHIP_KL720);
+
+            batch   = 1;
+            channel = pRawHead_720->onode_a[node_idx].ch_length;
+            height  = pRawHead_720->onode_a[node_idx].row_length;
+            width   = pRawHead_720->onode_a[node_idx].col_length;
+            radix   = (int32_t)pRawHead_720->onode_a[node_idx].output_radix;
+            memcpy(&scale, &pRawHead_720->onode_a[node_idx].output_scale, sizeof(float));
+        }
+        break;
+
+        case KP_DEVICE_KL630:
+        {
+            pRawHead_630 = (_630_raw_cnn_res_t *)(raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t));
+            if ((0 >= pRawHead_630->total_nodes) || (node_idx >= (uint32_t)pRawHead_630->total_nodes)) {
+                printf("%s, invalid node index.\n", __func__);
+                return KP_ERROR_INVALID_PARAM_12;
+            }
+
+            node_view->index        = pRawHead_630->onode_a[node_idx].idx;
+            node_view->data         = raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t) + sizeof(_630_raw_cnn_res_t) + pRawHead_630->onode_a[node_idx].start_offset;
+            node_view->data_layout  = convert_data_format_to_kp_tensor_format(pRawHead_630->onode_a[node_idx].fmt, KP_MODEL_TARGET_CHIP_KL630);
+
+            batch   = pRawHead_630->onode_a[node_idx].batch;
+            channel = pRawHead_630->onode_a[node_idx].ch_length;
+            height  = pRawHead_630->onode_a[node_idx].row_length;
+            width   = pRawHead_630->onode_a[node_idx].col_length;
+            radix   = (int32_t)pRawHead_630->onode_a[node_idx].radix;
+            memcpy(&scale, &pRawHead_630->onode_a[node_idx].scale, sizeof(float));
+        }
+        break;
+
+        default:
+            printf("%s, KP_DEVICE %d is not supported.\n", __func__, raw_result_v1->product_id);
+            return KP_ERROR_UNSUPPORTED_DEVICE_44;
+        }
+
+        /* BxCxHxW in the same NPU data access rules as kp_generic_inference_retrieve_float_node() */
+        node_view->shape_len            = 4;
+        node_view->shape[0]             = batch;
+        node_view->shape[1]             = channel;
+        node_view->shape[2]             = height;
+        node_view->shape[3]             = width;
+
+        node_view->stride_onnx[3]       = 1;
+        node_view->stride_onnx[2]       = width;
+        node_view->stride_onnx[1]       = height * width;
+        node_view->stride_onnx[0]       = channel * height * width;
+
+        if (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B == node_view->data_layout) {
+            if (KP_DEVICE_KL520 == node_view->product_id) {
+                /* KL520 not support 1W16C8B ouput NPU data layout format */
+                printf("%s, invalid NPU data layout KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B.\n", __func__);
+                return KP_ERROR_INVALID_MODEL_21;
+            }
+
+            node_view->fixed_point_dtype    = KP_FIXED_POINT_DTYPE_INT8;
+            node_view->stride_npu[3]        = KDP_CHANNEL_MIN_16;
+            node_view->stride_npu[2]        = width * KDP_CHANNEL_MIN_16;
+            node_view->stride_npu[1]        = 1;
+            node_view->stride_npu[0]        = round_up(channel, KDP_CHANNEL_MIN_16) * height * width;
+            node_view->channel_group_axis   = 1;
+            node_view->channel_group_stride = height * width * KDP_CHANNEL_MIN_16 - KDP_CHANNEL_MIN_16;
+        } else {
+            if (KP_MODEL_TENSOR_DATA_LAYOUT_8W1C16B == node_view->data_layout) {
+                /* standard 16-bit floating-point output */
+                node_view->fixed_point_dtype    = KP_FIXED_POINT_DTYPE_INT16;
+                width_aligned                   = round_up(width, KDP_COL_MIN_8);
+            } else {
+                /* standard 8-bit floating-point output */
+                node_view->fixed_point_dtype    = KP_FIXED_POINT_DTYPE_INT8;
+                width_aligned                   = round_up(width, KDP_COL_MIN_16);
+            }
+
+            node_view->stride_npu[3]    = 1;
+            node_view->stride_npu[0]    = channel * height * width_aligned;
+
+            if (KP_DEVICE_KL520 == node_view->product_id) {
+                /* height x channel x width */
+                node_view->stride_npu[2]    = channel * width_aligned;
+                node_view->stride_npu[1]    = width_aligned;
+            } else {
+                /* channel x height x width */
+                node_view->stride_npu[2]    = width_aligned;
+                node_view->stride_npu[1]    = height * width_aligned;
+            }
+        }
+
+        node_view->quantized_axis_stride        = 0;
+        node_view->quantization_parameters_len  = 1;
+        node_view->quantization_factor          = (float)(scale * pow2(radix));
+    } else if (KDP2_MAGIC_TYPE_INFERENCE_V2 == header_stamp->magic_type) {
+        raw_result_v2 = (kdp2_ipc_generic_raw_result_t_v2 *)raw_out_buffer;
+
+        node_view->product_id       = raw_result_v2->product_id;
+        node_view->shape_version    = KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2;
+
+        switch (raw_result_v2->product_id)
+        {
+        case KP_DEVICE_KL830:
+        case KP_DEVICE_KL730:
+        {
+            npu_data_heade = (npu_data_header_t *)(raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t_v2) + (raw_result_v2->num_of_pre_proc_info * sizeof(kp_hw_pre_proc_info_t)));
+
+            if ((0 == npu_data_heade->npu_data_node_num) || (node_idx >= npu_data_heade->npu_data_node_num)) {
+                printf("%s, invalid node index.\n", __func__);
+                return KP_ERROR_INVALID_PARAM_12;
+            }
+
+            output_node_header = &(((npu_data_single_node_header_v2_t *)npu_data_heade->data)[node_idx]);
+
+            if ((KP_DTYPE_INT32 != output_node_header->shape_data_type) ||
+                (KP_DTYPE_UINT32 != output_node_header->stride_npu_data_type) ||
+                (KP_DTYPE_UINT32 != output_node_header->stride_onnx_data_type)) {
+                printf("%s, unsupport IPC shape data type.\n", __func__);
+                return KP_ERROR_INVALID_MODEL_21;
+            }
+
+            if ((0 == output_node_header->shape_len) || (KP_MAX_NODE_VIEW_SHAPE_LEN < output_node_header->shape_len)) {
+                printf("%s, unsupport shape length %u.\n", __func__, output_node_header->shape_len);
+                return KP_ERROR_INVALID_MODEL_21;
+            }
+
+            node_view->index                        = output_node_header->index;
+            node_view->name                         = (char *)(npu_data_heade->data + output_node_header->name_start_offset);
+            node_view->data                         = npu_data_heade->data + output_node_header->npu_data_start_offset;
+            node_view->data_layout                  = convert_data_format_to_kp_tensor_format(output_node_header->data_layout, KP_MODEL_TARGET_CHIP_KL730);
+            node_view->fixed_point_dtype            = get_fixed_point_dtype(node_view->data_layout);
+            node_view->shape_len                    = output_node_header->shape_len;
+            node_view->quantization_parameters_len  = output_node_header->quantized_parameters_len;
+            node_view->radix_dtype                  = output_node_header->radix_data_type;
+            node_view->scale_dtype                  = output_node_header->scale_data_type;
+            node_view->radix                        = (void *)(npu_data_heade->data + output_node_header->radix_start_offset);
+            node_view->scale                        = (void *)(npu_data_heade->data + output_node_header->scale_start_offset);
+
+            if (KP_FIXED_POINT_DTYPE_UNKNOWN == node_view->fixed_point_dtype) {
+                printf("%s, invalid NPU data layout %u.\n", __func__, node_view->data_layout);
+                return KP_ERROR_INVALID_MODEL_21;
+            }
+
+            memcpy(node_view->shape, (void *)(npu_data_heade->data + output_node_header->shape_start_offset), node_view->shape_len * sizeof(int32_t));
+            memcpy(node_view->stride_npu, (void *)(npu_data_heade->data + output_node_header->stride_npu_start_offset), node_view->shape_len * sizeof(uint32_t));
+            memcpy(node_view->stride_onnx, (void *)(npu_data_heade->data + output_node_header->stride_onnx_start_offset), node_view->shape_len * sizeof(uint32_t));
+
+            if ((KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8B == node_view->data_layout) ||
+                (KP_MODEL_TENSOR_DATA_LAYOUT_1W16C8BHL == node_view->data_layout)) {
+                for (int axis = 0; axis < (int)node_view->shape_len; axis++) {
+                    if (1 == node_view->stride_npu[axis]) {
+                        node_view->channel_group_axis = axis;
+                        continue;
+                    }
+
+                    npu_channel_group_stride_tmp = node_view->stride_npu[axis] * node_view->shape[axis];
+                    if (npu_channel_group_stride_tmp > node_view->channel_group_stride)
+                        node_view->channel_group_stride = npu_channel_group_stride_tmp;
+                }
+
+                node_view->channel_group_stride -= 16;
+            }
+
+            /* get channel-wise quantization stride */
+            if (1 < node_view->quantization_parameters_len) {
+                node_view->quantized_axis_stride = 1;
+                for (uint32_t axis = 0; axis < node_view->shape_len; axis++) {
+                    if (axis != output_node_header->quantized_axis)
+                        node_view->quantized_axis_stride *= node_view->shape[axis];
+                }
+            }
+
+            status = get_node_view_quantization_parameter(node_view, 0, &radix, &scale);
+            if (KP_SUCCESS != status) {
+                printf("%s, get quantization parameters fail.\n", __func__);
+                return status;
+            }
+
+            node_view->quantization_factor = (float)(scale * pow2(radix));
+        }
+        break;
+
+        default:
+            printf("%s, KP_DEVICE %d is not supported.\n", __func__, raw_result_v2->product_id);
+            return KP_ERROR_UNSUPPORTED_DEVICE_44;
+        }
+    } else {
+        printf("%s, invalid header stamp.\n", __func__);
+        return KP_ERROR_RECEIVE_INCORRECT_HEADER_STAMP_30;
+    }
+
+    return KP_SUCCESS;
+}
+
+/* number of values and length of the RAW output shape of a model node */
+static int get_tensor_descriptor_data_size(kp_tensor_descriptor_t *tensor_descriptor, uint32_t *num_data, uint32_t *shape_len)
+{
+    kp_tensor_shape_info_v1_t *tensor_shape_info_v1 = &(tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v1);
+    kp_tensor_shape_info_v2_t *tensor_shape_info_v2 = &(tensor_descriptor->tensor_shape_info.tensor_shape_info_data.v2);
+
+    *num_data = 1;
+
+    if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1 == tensor_descriptor->tensor_shape_info.version) {
+        /* RAW output of KL520/KL720/KL630 is always described in 4 dimensions of NPU shape */
+        *shape_len = (4 > tensor_shape_info_v1->shape_npu_len) ? 4 : tensor_shape_info_v1->shape_npu_len;
+
+        for (uint32_t axis = 0; axis < tensor_shape_info_v1->shape_npu_len; axis++)
+            *num_data *= tensor_shape_info_v1->shape_npu[axis];
+    } else if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_2 == tensor_descriptor->tensor_shape_info.version) {
+        *shape_len = tensor_shape_info_v2->shape_len;
+
+        for (uint32_t axis = 0; axis < tensor_shape_info_v2->shape_len; axis++)
+            *num_data *= tensor_shape_info_v2->shape[axis];
+    } else {
+        printf("%s, invalid tensor shape version.\n", __func__);
+        return KP_ERROR_INVALID_MODEL_21;
+    }
+
+    return KP_SUCCESS;
+}
+
+int kp_inf_node_view_attach_model_output_node(kp_inf_node_view_t *node_view, kp_tensor_descriptor_t *output_node)
+{
+    kp_quantization_parameters_v1_t *quantization_parameters_v1 = NULL;
+
+    int status                                                  = KP_SUCCESS;
+    uint32_t num_data                                           = 0;
+    uint32_t view_num_data                                      = 1;
+    uint32_t shape_len                                          = 0;
+
+    if ((NULL == node_view) ||
+        (NULL == output_node)) {
+        printf("%s, NULL pointer input parameter.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    if (KP_MODEL_QUANTIZATION_PARAMS_VERSION_1 != output_node->quantization_parameters.version) {
+        printf("%s, invalid quantization parameters version.\n", __func__);
+        return KP_ERROR_INVALID_MODEL_21;
+    }
+
+    quantization_parameters_v1 = &(output_node->quantization_parameters.quantization_parameters_data.v1);
+
+    if (NULL == quantization_parameters_v1->quantization_reciprocal_factor) {
+        printf("%s, reciprocal quantization factor table is not built for the node.\n", __func__);
+        return KP_ERROR_INVALID_MODEL_21;
+    }
+
+    status = get_tensor_descriptor_data_size(output_node, &num_data, &shape_len);
+    if (KP_SUCCESS != status)
+        return status;
+
+    for (uint32_t axis = 0; axis < node_view->shape_len; axis++)
+        view_num_data *= node_view->shape[axis];
+
+    /* the table is indexed like the quantization parameters of the RAW output, so the node should be the same */
+    if ((output_node->index != node_view->index) ||
+        (num_data != view_num_data) ||
+        (quantization_parameters_v1->quantized_fixed_point_descriptor_num != node_view->quantization_parameters_len)) {
+        printf("%s, model output node %u does not match node view %u.\n", __func__, output_node->index, node_view->index);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    node_view->quantization_reciprocal_factor = quantization_parameters_v1->quantization_reciprocal_factor;
+
+    return KP_SUCCESS;
+}
+
+int kp_inf_node_view_get_float(kp_inf_node_view_t *node_view, int32_t *index, float *value)
+{
+    int status                  = KP_SUCCESS;
+    float quantization_factor   = 0;
+
+    if ((NULL == node_view) ||
+        (NULL == index) ||
+        (NULL == value)) {
+        printf("%s, NULL pointer input parameter.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    if (!is_node_view_index_valid(node_view, index)) {
+        printf("%s, index out of range.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    if (NULL != node_view->quantization_reciprocal_factor) {
+        uint32_t factor_idx = (0 != node_view->quantized_axis_stride) ? get_node_view_onnx_data_offset(node_view, index) / node_view->quantized_axis_stride : 0;
+
+        if (factor_idx >= node_view->quantization_parameters_len) {
+            printf("%s, index of quantization parameters out of range.\n", __func__);
+            return KP_ERROR_INVALID_PARAM_12;
+        }
+
+        *value = (float)read_node_view_fixed_point_value(node_view, get_node_view_npu_data_offset(node_view, index)) * node_view->quantization_reciprocal_factor[factor_idx];
+
+        return KP_SUCCESS;
+    }
+
+    status = get_node_view_quantization_factor(node_view, get_node_view_onnx_data_offset(node_view, index), &quantization_factor);
+    if (KP_SUCCESS != status)
+        return status;
+
+    *value = (float)read_node_view_fixed_point_value(node_view, get_node_view_npu_data_offset(node_view, index)) / quantization_factor;
+
+    return KP_SUCCESS;
+}
+
+int kp_inf_node_view_get_float_row(kp_inf_node_view_t *node_view, int32_t *index, float *row_buffer, uint32_t buf_len)
+{
+    int32_t row_index[KP_MAX_NODE_VIEW_SHAPE_LEN]   = {0};
+    int32_t last_axis                               = 0;
+
+    if ((NULL == node_view) ||
+        (NULL == index) ||
+        (NULL == row_buffer) ||
+        (0 == node_view->shape_len)) {
+        printf("%s, invalid input parameter.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    last_axis = node_view->shape_len - 1;
+
+    memcpy(row_index, index, node_view->shape_len * sizeof(int32_t));
+    row_index[last_axis] = 0;
+
+    if ((!is_node_view_index_valid(node_view, row_index)) ||
+        (buf_len < (uint32_t)node_view->shape[last_axis])) {
+        printf("%s, index out of range or buffer is insufficient.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    return read_node_view_float_line(node_view, row_index, last_axis, node_view->shape[last_axis], row_buffer);
+}
+
+int kp_inf_node_view_extract_float_region(kp_inf_node_view_t *node_view, int32_t *start, int32_t *size, float *region_buffer, uint32_t buf_len)
+{
+    int status                                      = KP_SUCCESS;
+    int32_t region_index[KP_MAX_NODE_VIEW_SHAPE_LEN] = {0};
+    int32_t last_axis                               = 0;
+    uint32_t num_data                               = 1;
+    uint32_t n                                      = 0;
+
+    if ((NULL == node_view) ||
+        (NULL == start) ||
+        (NULL == size) ||
+        (NULL == region_buffer) ||
+        (0 == node_view->shape_len)) {
+        printf("%s, invalid input parameter.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    last_axis = node_view->shape_len - 1;
+
+    for (uint32_t axis = 0; axis < node_view->shape_len; axis++) {
+        if ((0 > start[axis]) || (0 >= size[axis]) || (start[axis] + size[axis] > node_view->shape[axis])) {
+            printf("%s, region out of range.\n", __func__);
+            return KP_ERROR_INVALID_PARAM_12;
+        }
+
+        num_data *= size[axis];
+    }
+
+    if (buf_len < num_data) {
+        printf("%s, buffer is insufficient.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    memcpy(region_index, start, node_view->shape_len * sizeof(int32_t));
+
+    /* convert line by line (along the last axis), lines outside the region are never touched */
+    while (true) {
+        status = read_node_view_float_line(node_view, region_index, last_axis, size[last_axis], &region_buffer[n]);
+        if (KP_SUCCESS != status)
+            return status;
+
+        n += size[last_axis];
+
+        int32_t axis = last_axis - 1;
+        for (; axis >= 0; axis--) {
+            region_index[axis]++;
+            if (region_index[axis] < start[axis] + size[axis])
+                break;
+
+            region_index[axis] = start[axis];
+        }
+
+        if (0 > axis)
+            break;
+    }
+
+    return KP_SUCCESS;
+}
+
+#define FLOAT_NODE_ARENA_DATA_ALIGNMENT 16
+
+static int get_raw_output_node_num(uint8_t *raw_out_buffer, uint32_t *num_output_node)
+{
+    kp_inference_header_stamp_t *header_stamp           = (kp_inference_header_stamp_t *)raw_out_buffer;
+    kdp2_ipc_generic_raw_result_t_v1 *raw_result_v1     = NULL;
+    kdp2_ipc_generic_raw_result_t_v2 *raw_result_v2     = NULL;
+    npu_data_header_t *npu_data_heade                   = NULL;
+    int32_t total_nodes                                 = 0;
+
+    if (KDP2_MAGIC_TYPE_INFERENCE == header_stamp->magic_type) {
+        raw_result_v1 = (kdp2_ipc_generic_raw_result_t *)raw_out_buffer;
+
+        switch (raw_result_v1->product_id)
+        {
+        case KP_DEVICE_KL520:
+            *num_output_node = *(uint32_t *)(raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t));
+            return KP_SUCCESS;
+        case KP_DEVICE_KL720:
+            total_nodes = ((_720_raw_cnn_res_t *)(raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t)))->total_nodes;
+            break;
+        case KP_DEVICE_KL630:
+            total_nodes = ((_630_raw_cnn_res_t *)(raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t)))->total_nodes;
+            break;
+        default:
+            printf("%s, KP_DEVICE %d is not supported.\n", __func__, raw_result_v1->product_id);
+            return KP_ERROR_UNSUPPORTED_DEVICE_44;
+        }
+
+        *num_output_node = (0 < total_nodes) ? (uint32_t)total_nodes : 0;
+    } else if (KDP2_MAGIC_TYPE_INFERENCE_V2 == header_stamp->magic_type) {
+        raw_result_v2   = (kdp2_ipc_generic_raw_result_t_v2 *)raw_out_buffer;
+        npu_data_heade  = (npu_data_header_t *)(raw_out_buffer + sizeof(kdp2_ipc_generic_raw_result_t_v2) + (raw_result_v2->num_of_pre_proc_info * sizeof(kp_hw_pre_proc_info_t)));
+
+        *num_output_node = npu_data_heade->npu_data_node_num;
+    } else {
+        printf("%s, invalid header stamp.\n", __func__);
+        return KP_ERROR_RECEIVE_INCORRECT_HEADER_STAMP_30;
+    }
+
+    return KP_SUCCESS;
+}
+
+static uint32_t get_float_node_list_header_size(uint32_t num_output_node)
+{
+    return sizeof(kp_inf_float_node_output_list_t) + num_output_node * sizeof(kp_inf_float_node_output_t *);
+}
+
+/* place one node (header, 16 bytes aligned data, shape, name) at 'offset' of the arena and return the end offset */
+static uint32_t place_float_node_in_arena(uint32_t offset, uint32_t num_data, uint32_t shape_len, uint32_t name_len,
+                                          uint32_t *node_offset, uint32_t *shape_offset, uint32_t *name_offset)
+{
+    uint32_t data_offset = round_up(offset + offsetof(kp_inf_float_node_output_t, data), FLOAT_NODE_ARENA_DATA_ALIGNMENT);
+
+    *node_offset    = data_offset - offsetof(kp_inf_float_node_output_t, data);
+    *shape_offset   = round_up(data_offset + num_data * sizeof(float), sizeof(int32_t));
+    *name_offset    = *shape_offset + shape_len * sizeof(int32_t);
+
+    return *name_offset + name_len + 1;
+}
+
+static int convert_node_view_to_float(kp_inf_node_view_t *node_view, kp_channel_ordering_convert_t channel_ordering_convert_code, float *data)
+{
+    int status                                      = KP_SUCCESS;
+    int32_t index[KP_MAX_NODE_VIEW_SHAPE_LEN]       = {0};
+    int32_t axis_order[KP_MAX_NODE_VIEW_SHAPE_LEN]  = {0};
+    int32_t inner_axis                              = 0;
+    int32_t order_idx                               = 0;
+    uint32_t n                                      = 0;
+
+    for (uint32_t axis = 0; axis < node_view->shape_len; axis++)
+        axis_order[axis] = axis;
+
+    if (KP_MODEL_TENSOR_SHAPE_INFO_VERSION_1 == node_view->shape_version) {
+        /* BxCxHxW view, output the same channel ordering as kp_generic_inference_retrieve_float_node() */
+        switch (channel_ordering_convert_code)
+        {
+        case KP_CHANNEL_ORDERING_CVT_CHW2HCW:
+            axis_order[1] = 2;
+            axis_order[2] = 1;
+            break;
+        case KP_CHANNEL_ORDERING_CVT_HCW2HWC:
+        case KP_CHANNEL_ORDERING_CVT_CHW2HWC:
+            axis_order[1] = 2;
+            axis_order[2] = 3;
+            axis_order[3] = 1;
+            break;
+        case KP_CHANNEL_ORDERING_CVT_HCW2CHW:
+            break;
+        default:
+            if (KP_DEVICE_KL520 == node_view->product_id) {
+                axis_order[1] = 2;
+                axis_order[2] = 1;
+            }
+            break;
+        }
+    } else if (KP_CHANNEL_ORDERING_CVT_NONE != channel_ordering_convert_code) {
+        err_print("Device 0x%X only support ordering 'KP_CHANNEL_ORDERING_DEFAULT'\n", node_view->product_id);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    inner_axis = axis_order[node_view->shape_len - 1];
+
+    while (true) {
+        status = read_node_view_float_line(node_view, index, inner_axis, node_view->shape[inner_axis], &data[n]);
+        if (KP_SUCCESS != status)
+            return status;
+
+        n += node_view->shape[inner_axis];
+
+        for (order_idx = node_view->shape_len - 2; order_idx >= 0; order_idx--) {
+            int32_t axis = axis_order[order_idx];
+
+            index[axis]++;
+            if (index[axis] < node_view->shape[axis])
+                break;
+
+            index[axis] = 0;
+        }
+
+        if (0 > order_idx)
+            break;
+    }
+
+    return KP_SUCCESS;
+}
+
+int kp_generic_inference_get_float_node_list_size(kp_single_model_descriptor_t *single_model_desc, uint32_t *arena_size)
+{
+    kp_tensor_descriptor_t *tensor_descriptor       = NULL;
+
+    int status                                      = KP_SUCCESS;
+    uint32_t offset                                 = 0;
+    uint32_t num_data                               = 0;
+    uint32_t shape_len                              = 0;
+    uint32_t name_len                               = 0;
+    uint32_t node_offset                            = 0;
+    uint32_t shape_offset                           = 0;
+    uint32_t name_offset                            = 0;
+
+    if ((NULL == single_model_desc) ||
+        (NULL == arena_size)) {
+        printf("%s, NULL pointer input parameter.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    offset = get_float_node_list_header_size(single_model_desc->output_nodes_num);
+
+    for (uint32_t node_idx = 0; node_idx < single_model_desc->output_nodes_num; node_idx++) {
+        tensor_descriptor = &(single_model_desc->output_nodes[node_idx]);
+
+        status = get_tensor_descriptor_data_size(tensor_descriptor, &num_data, &shape_len);
+        if (KP_SUCCESS != status)
+            return status;
+
+        name_len    = (NULL != tensor_descriptor->name) ? strlen(tensor_descriptor->name) : 0;
+        offset      = place_float_node_in_arena(offset, num_data, shape_len, name_len, &node_offset, &shape_offset, &name_offset);
+    }
+
+    *arena_size = offset;
+
+    return KP_SUCCESS;
+}
+
+static int attach_model_output_node_by_index(kp_inf_node_view_t *node_view, kp_single_model_descriptor_t *single_model_desc)
+{
+    for (uint32_t node_idx = 0; node_idx < single_model_desc->output_nodes_num; node_idx++) {
+        if (node_view->index == single_model_desc->output_nodes[node_idx].index)
+            return kp_inf_node_view_attach_model_output_node(node_view, &(single_model_desc->output_nodes[node_idx]));
+    }
+
+    printf("%s, no model output node of index %u.\n", __func__, node_view->index);
+
+    return KP_ERROR_INVALID_PARAM_12;
+}
+
+int kp_generic_inference_retrieve_float_node_list(uint8_t *raw_out_buffer, kp_channel_ordering_t ordering, kp_single_model_descriptor_t *single_model_desc, void *arena, uint32_t arena_size, kp_inf_float_node_output_list_t **node_output_list)
+{
+    kp_inference_header_stamp_t *header_stamp                   = (kp_inference_header_stamp_t *)raw_out_buffer;
+    kp_channel_ordering_convert_t channel_ordering_convert_code = KP_CHANNEL_ORDERING_CVT_NONE;
+    kp_inf_float_node_output_list_t *list                       = NULL;
+    kp_inf_float_node_output_t *float_node_output               = NULL;
+    kp_inf_node_view_t node_view;
+
+    int status                                                  = KP_SUCCESS;
+    void *allocated_buffer                                      = NULL;
+    uint8_t *arena_base                                         = NULL;
+    uint32_t num_output_node                                    = 0;
+    uint32_t needed_size                                        = 0;
+    uint32_t num_data                                           = 0;
+    uint32_t node_offset                                        = 0;
+    uint32_t shape_offset                                       = 0;
+    uint32_t name_offset                                        = 0;
+
+    if ((NULL == raw_out_buffer) ||
+        (NULL == node_output_list)) {
+        printf("%s, NULL pointer input parameter.\n", __func__);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    *node_output_list = NULL;
+
+    if ((NULL != arena) && (0 != ((uintptr_t)arena & (FLOAT_NODE_ARENA_DATA_ALIGNMENT - 1)))) {
+        printf("%s, arena should be aligned to %d bytes.\n", __func__, FLOAT_NODE_ARENA_DATA_ALIGNMENT);
+        return KP_ERROR_INVALID_PARAM_12;
+    }
+
+    status = get_raw_output_node_num(raw_out_buffer, &num_output_node);
+    if (KP_SUCCESS != status)
+        return status;
+
+    if (KDP2_MAGIC_TYPE_INFERENCE == header_stamp->magic_type)
+        channel_ordering_convert_code = get_channel_ordering_convert_code(((kdp2_ipc_generic_raw_result_t *)raw_out_buffer)->product_id, ordering);
+    else
+        channel_ordering_convert_code = get_channel_ordering_convert_code(((kdp2_ipc_generic_raw_result_t_v2 *)raw_out_buffer)->product_id, ordering);
+
+    /* layout pass: get the needed arena size from the node metadata only */
+    needed_size = get_float_node_list_header_size(num_output_node);
+
+    for (uint32_t node_idx = 0; node_idx < num_output_node; node_idx++) {
+        status = kp_generic_inference_retrieve_node_view(node_idx, raw_out_buffer, &node_view);
+        if (KP_SUCCESS != status)
+            return status;
+
+        num_data = 1;
+        for (uint32_t axis = 0; axis < node_view.shape_len; axis++)
+            num_data *= node_view.shape[axis];
+
+        needed_size = place_float_node_in_arena(needed_size, num_data, node_view.shape_len, strlen(node_view.name), &node_offset, &shape_offset, &name_offset);
+    }
+
+    if (NULL == arena) {
+        allocated_buffer = malloc(needed_size + FLOAT_NODE_ARENA_DATA_ALIGNMENT - 1);
+        if (NULL == allocated_buffer) {
+            printf("%s, memory is insufficient to allocate arena.\n", __func__);
+            return KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+        }
+
+        arena_base = (uint8_t *)(((uintptr_t)allocated_buffer + FLOAT_NODE_ARENA_DATA_ALIGNMENT - 1) & ~(uintptr_t)(FLOAT_NODE_ARENA_DATA_ALIGNMENT - 1));
+    } else {
+        if (arena_size < needed_size) {
+            printf("%s, arena size %u is insufficient, %u bytes are needed.\n", __func__, arena_size, needed_size);
+            return KP_ERROR_INVALID_PARAM_12;
+        }
+
+        arena_base = (uint8_t *)arena;
+    }
+
+    list                    = (kp_inf_float_node_output_list_t *)arena_base;
+    list->num_output_node   = num_output_node;
+    list->arena_size        = needed_size;
+    list->allocated_buffer  = allocated_buffer;
+    list->node_output       = (kp_inf_float_node_output_t **)(arena_base + sizeof(kp_inf_float_node_output_list_t));
+
+    /* fill pass: convert every node into its slot of the arena */
+    needed_size = get_float_node_list_header_size(num_output_node);
+
+    for (uint32_t node_idx = 0; node_idx < num_output_node; node_idx++) {
+        status = kp_generic_inference_retrieve_node_view(node_idx, raw_out_buffer, &node_view);
+        if (KP_SUCCESS != status)
+            goto FUNC_OUT_ERROR;
+
+        if (NULL != single_model_desc) {
+            status = attach_model_output_node_by_index(&node_view, single_model_desc);
+            if (KP_SUCCESS != status)
+                goto FUNC_OUT_ERROR;
+        }
+
+        num_data = 1;
+        for (uint32_t axis = 0; axis < node_view.shape_len; axis++)
+            num_data *= node_view.shape[axis];
+
+        needed_size = place_float_node_in_arena(needed_size, num_data, node_view.shape_len, strlen(node_view.name), &node_offset, &shape_offset, &name_offset);
+
+        float_node_output               = (kp_inf_float_node_output_t *)(arena_base + node_offset);
+        float_node_output->num_data     = num_data;
+        float_node_output->shape_len    = node_view.shape_len;
+        float_node_output->shape        = (int32_t *)(arena_base + shape_offset);
+        float_node_output->name         = (char *)(arena_base + name_offset);
+
+        memcpy(float_node_output->shape, node_view.shape, node_view.shape_len * sizeof(int32_t));
+        strcpy(float_node_output->name, node_view.name);
+
+        status = convert_node_view_to_float(&node_view, channel_ordering_convert_code, float_node_output->data);
+        if (KP_SUCCESS != status)
+            goto FUNC_OUT_ERROR;
+
+        list->node_output[node_idx] = float_node_output;
+    }
+
+    *node_output_list = list;
+
+    return KP_SUCCESS;
+
+FUNC_OUT_ERROR:
+    if (NULL != allocated_buffer)
+        free(allocated_buffer);
+
+    return status;
+}
+
 int kp_customized_inference_send(kp_device_group_t devices, void *header, int header_size, uint8_t *image, int image_size)
 {
     int ret;
@@ -2650,6 +3655,9 @@ void kp_release_raw_fixed_node_output(kp_inf_raw_fixed_node_output_t *raw_fixed_
     if (KP_MODEL_QUANTIZATION_PARAMS_VERSION_1 == quantization_parameters->version) {
         if (NULL != quantization_parameters_v1->quantized_fixed_point_descriptor)
             free(quantization_parameters_v1->quantized_fixed_point_descriptor);
+
+        if (NULL != quantization_parameters_v1->quantization_reciprocal_factor)
+            free(quantization_parameters_v1->quantization_reciprocal_factor);
     } else {
         printf("%s, invalid quantization parameters version.\n", __func__);
         return;
@@ -2675,6 +3683,9 @@ void kp_release_fixed_node_output(kp_inf_fixed_node_output_t *fixed_node_output)
     if (KP_MODEL_QUANTIZATION_PARAMS_VERSION_1 == quantization_parameters->version) {
         if (NULL != quantization_parameters_v1->quantized_fixed_point_descriptor)
             free(quantization_parameters_v1->quantized_fixed_point_descriptor);
+
+        if (NULL != quantization_parameters_v1->quantization_reciprocal_factor)
+            free(quantization_parameters_v1->quantization_reciprocal_factor);
     } else {
         printf("%s, invalid quantization parameters version.\n", __func__);
         return;
@@ -2697,6 +3708,16 @@ void kp_release_float_node_output(kp_inf_float_node_output_t *float_node_output)
     free(float_node_output);
 }
 
+void kp_release_float_node_output_list(kp_inf_float_node_output_list_t *node_output_list)
+{
+    if (NULL == node_output_list)
+        return;
+
+    /* the list lives inside the arena, only an arena allocated by kp_generic_inference_retrieve_float_node_list() is freed */
+    if (NULL != node_output_list->allocated_buffer)
+        free(node_output_list->allocated_buffer);
+}
+
 int kp_release_dbg_checkpoint_data(void *checkpoint_buf)
 {
     kp_dbg_checkpoint_data_after_inference_t *after_inf = (kp_dbg_checkpoint_data_after_inference_t *)checkpoint_buf;
@@ -20,9 +20,11 @@
 // #define DEBUG_PRINT
 
 #include "internal_func.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include "kdp2_inf_generic_raw.h"
 
@@ -136,7 +138,9 @@ int deconstruct_quantization_parameters(kp_quantization_parameters_t* quantizati
     case KP_MODEL_QUANTIZATION_PARAMS_VERSION_1:
         quantization_parameters_v1                                      = &(quantization_parameters->quantization_parameters_data.v1);
         quantization_parameters_v1->quantized_fixed_point_descriptor    = realloc_zero(quantization_parameters_v1->quantized_fixed_point_descriptor, 0);
-        if (NULL != quantization_parameters_v1->quantized_fixed_point_descriptor) {
+        quantization_parameters_v1->quantization_reciprocal_factor      = realloc_zero(quantization_parameters_v1->quantization_reciprocal_factor, 0);
+        if (NULL != quantization_parameters_v1->quantized_fixed_point_descriptor ||
+            NULL != quantization_parameters_v1->quantization_reciprocal_factor) {
             err_print("deconstruct tensor quantization fixed point parameter in model_descriptor fail ...\n");
             ret = KP_ERROR_MEMORY_FREE_FAILURE_39;
         }
@@ -1189,6 +1193,46 @@ int _check_model_platform(kp_product_id_t target_pid, kp_model_target_chip_t mod
     return ret;
 }
 
+int construct_model_des_quantization_reciprocal_factor(kp_model_nef_descriptor_t* loaded_model_desc) {
+    int status                                                  = KP_SUCCESS;
+    kp_single_model_descriptor_t *single_model_descriptor       = NULL;
+    kp_tensor_descriptor_t *tensor_info                         = NULL;
+    kp_quantization_parameters_v1_t *quantization_parameters_v1 = NULL;
+
+    /* reciprocal dequantization factor of each channel, so fixed-point to floating-point conversion of output nodes needs no per-element pow2 */
+    for (int model_idx = 0; model_idx < loaded_model_desc->num_models; model_idx++) {
+        single_model_descriptor = &(loaded_model_desc->models[model_idx]);
+
+        for (int node_idx = 0; node_idx < single_model_descriptor->output_nodes_num; node_idx++) {
+            tensor_info = &(single_model_descriptor->output_nodes[node_idx]);
+
+            if (KP_MODEL_QUANTIZATION_PARAMS_VERSION_1 != tensor_info->quantization_parameters.version) {
+                err_print("construct quantization reciprocal factor in model_descriptor fail: invalid quantization parameters version ...\n");
+                return KP_ERROR_INVALID_MODEL_21;
+            }
+
+            quantization_parameters_v1                                  = &(tensor_info->quantization_parameters.quantization_parameters_data.v1);
+            quantization_parameters_v1->quantization_reciprocal_factor  = realloc_zero(quantization_parameters_v1->quantization_reciprocal_factor, quantization_parameters_v1->quantized_fixed_point_descriptor_num * sizeof(float));
+
+            if (0 == quantization_parameters_v1->quantized_fixed_point_descriptor_num)
+                continue;
+
+            if (NULL == quantization_parameters_v1->quantization_reciprocal_factor) {
+                err_print("construct quantization reciprocal factor in model_descriptor fail: alloc memory fail ...\n");
+                return KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+            }
+
+            status = build_quantization_factor_table(quantization_parameters_v1, true, quantization_parameters_v1->quantization_reciprocal_factor);
+            if (KP_SUCCESS != status) {
+                err_print("construct quantization reciprocal factor in model_descriptor fail: %d ...\n", status);
+                return status;
+            }
+        }
+    }
+
+    return KP_SUCCESS;
+}
+
 int build_model_nef_descriptor_from_nef(kp_nef_handler_t *nef_handler, kp_metadata_t *metadata, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t* loaded_model_desc) {
     if ((NULL == nef_handler) ||
         (NULL == metadata) ||
@@ -1242,6 +1286,13 @@ int build_model_nef_descriptor_from_nef(kp_nef_handler_t *nef_handler, kp_metada
         return ret;
     }
 
+    ret = construct_model_des_quantization_reciprocal_factor(loaded_model_desc);
+    if (KP_SUCCESS != ret)
+    {
+        err_print("construct quantization reciprocal factor failed: %d...\n", ret);
+        return ret;
+    }
+
     return ret;
 }
 
@@ -1303,28 +1354,130 @@ int build_model_nef_descriptor_from_device(kp_nef_handler_t *nef_handler, kp_nef
         return ret;
     }
 
+    ret = construct_model_des_quantization_reciprocal_factor(loaded_model_desc);
+    if (KP_SUCCESS != ret)
+    {
+        err_print("construct quantization reciprocal factor failed: %d...\n", ret);
+        return ret;
+    }
+
     return ret;
 }
 
-int load_model_info_from_nef(void *nef_buf, int nef_size, kp_product_id_t target_pid /* input */, kp_metadata_t *metadata, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t *loaded_model_desc /* output */)
+/******************************************************************
+ * kp_model_nef_descriptor_t cache
+ ******************************************************************/
+
+/**
+ * Descriptors built from NEFs are kept process-wide, keyed by the CRC32 of the NEF and the NEF size, so loading the same
+ * NEF again (another device group, a model restart) copies the descriptor instead of parsing its setup.bin again. The CRC
+ * is verified over the whole NEF on every load, except for an unchanged NEF file verified before (see
+ * load_model_info_from_nef_file()).
+ */
+#define MODEL_DESCRIPTOR_CACHE_SIZE     8
+
+typedef struct
+{
+    bool valid;
+    uint32_t nef_crc;
+    uint32_t nef_size;
+    uint32_t last_used;
+    kp_model_nef_descriptor_t model_desc;
+} _model_descriptor_cache_entry_t;
+
+static _model_descriptor_cache_entry_t model_descriptor_cache[MODEL_DESCRIPTOR_CACHE_SIZE];
+static uint32_t model_descriptor_cache_clock = 0;
+static pthread_mutex_t model_descriptor_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* the caller holds model_descriptor_cache_mutex */
+static _model_descriptor_cache_entry_t* _find_model_descriptor_cache_entry(uint32_t nef_crc, uint32_t nef_size) {
+    for (int i = 0; i < MODEL_DESCRIPTOR_CACHE_SIZE; i++) {
+        if ((true == model_descriptor_cache[i].valid) &&
+            (nef_crc == model_descriptor_cache[i].nef_crc) &&
+            (nef_size == model_descriptor_cache[i].nef_size))
+            return &model_descriptor_cache[i];
+    }
+
+    return NULL;
+}
+
+/* return KP_SUCCESS if copied, KP_ERROR_OTHER_99 if the descriptor is no longer cached */
+static int _copy_cached_model_descriptor(uint32_t nef_crc, uint32_t nef_size, kp_model_nef_descriptor_t *loaded_model_desc) {
+    int ret = KP_ERROR_OTHER_99;
+
+    pthread_mutex_lock(&model_descriptor_cache_mutex);
+
+    _model_descriptor_cache_entry_t *entry = _find_model_descriptor_cache_entry(nef_crc, nef_size);
+    if (NULL != entry) {
+        entry->last_used = ++model_descriptor_cache_clock;
+        ret = copy_model_nef_descriptor(loaded_model_desc, &(entry->model_desc));
+    }
+
+    pthread_mutex_unlock(&model_descriptor_cache_mutex);
+
+    return ret;
+}
+
+/* a full cache drops its least recently used descriptor */
+static void _cache_model_descriptor(uint32_t nef_crc, uint32_t nef_size, kp_model_nef_descriptor_t *loaded_model_desc) {
+    pthread_mutex_lock(&model_descriptor_cache_mutex);
+
+    _model_descriptor_cache_entry_t *entry = _find_model_descriptor_cache_entry(nef_crc, nef_size);
+
+    for (int i = 0; (NULL == entry) && (i < MODEL_DESCRIPTOR_CACHE_SIZE); i++) {
+        if (false == model_descriptor_cache[i].valid)
+            entry = &model_descriptor_cache[i];
+    }
+
+    if (NULL == entry) {
+        entry = &model_descriptor_cache[0];
+
+        for (int i = 1; i < MODEL_DESCRIPTOR_CACHE_SIZE; i++) {
+            if (model_descriptor_cache[i].last_used < entry->last_used)
+                entry = &model_descriptor_cache[i];
+        }
+    }
+
+    entry->nef_crc      = nef_crc;
+    entry->nef_size     = nef_size;
+    entry->last_used    = ++model_descriptor_cache_clock;
+    entry->valid        = (KP_SUCCESS == copy_model_nef_descriptor(&(entry->model_desc), loaded_model_desc));
+
+    if (false == entry->valid)
+        deconstruct_model_nef_descriptor(&(entry->model_desc));
+
+    pthread_mutex_unlock(&model_descriptor_cache_mutex);
+}
+
+static int _load_model_info_from_nef(void *nef_buf, int nef_size, bool check_crc, kp_product_id_t target_pid, kp_metadata_t *metadata, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t *loaded_model_desc)
 {
-    if ((NULL == metadata) || (NULL == nef_info))
+    if ((NULL == nef_buf) || (NULL == metadata) || (NULL == nef_info))
     {
         err_print("invalid parameters, null pointer ...\n");
         return KP_ERROR_INVALID_PARAM_12;
     }
 
+    if ((int)sizeof(uint32_t) >= nef_size)
+    {
+        err_print("invalid model size %d ...\n", nef_size);
+        return KP_ERROR_INVALID_MODEL_21;
+    }
+
     memset(metadata, 0, sizeof(kp_metadata_t));
     memset(nef_info, 0, sizeof(kp_nef_info_t));
 
     kp_nef_handler_t nef_handler = {0};
-    int ret = read_nef_content_table(nef_buf, nef_size, &nef_handler);
+    int ret = read_nef_content_table(nef_buf, nef_size, check_crc, &nef_handler);
     if (ret != 0)
     {
         err_print("getting NEF handler failed: %d...\n", ret);
         return KP_ERROR_INVALID_MODEL_21;
     }
 
+    // the CRC at the end of the NEF is verified by read_nef_content_table(), or was verified when the unchanged file was loaded before
+    uint32_t nef_crc = 0;
+    memcpy(&nef_crc, (char *)nef_buf + nef_size - sizeof(uint32_t), sizeof(uint32_t));
+
     ret = read_nef_header_information(&nef_handler, metadata);
     if (ret != 0)
     {
@@ -1344,8 +1497,163 @@ int load_model_info_from_nef(void *nef_buf, int nef_size, kp_product_id_t target
         return KP_ERROR_INVALID_MODEL_21;
     }
 
-    if (NULL != loaded_model_desc)
-        return build_model_nef_descriptor_from_nef(&nef_handler, metadata, nef_info, loaded_model_desc);
-    else
+    if (NULL == loaded_model_desc)
         return KP_SUCCESS;
+
+    if (KP_SUCCESS == _copy_cached_model_descriptor(nef_crc, nef_size, loaded_model_desc))
+        return KP_SUCCESS;
+
+    ret = build_model_nef_descriptor_from_nef(&nef_handler, metadata, nef_info, loaded_model_desc);
+
+    if (KP_SUCCESS == ret)
+        _cache_model_descriptor(nef_crc, nef_size, loaded_model_desc);
+
+    return ret;
+}
+
+int load_model_info_from_nef(void *nef_buf, int nef_size, kp_product_id_t target_pid /* input */, kp_metadata_t *metadata, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t *loaded_model_desc /* output */)
+{
+    return _load_model_info_from_nef(nef_buf, nef_size, true, target_pid, metadata, nef_info, loaded_model_desc);
+}
+
+/******************************************************************
+ * NEF files verified before
+ ******************************************************************/
+
+/**
+ * The CRC over the whole NEF costs about as much as building its descriptor. A NEF file whose size, inode, modification
+ * time and CRC field are those of a file verified before is trusted without calculating its CRC again; any change of the
+ * file (or a file changed while it was read) verifies the whole NEF again.
+ */
+#define VERIFIED_NEF_FILE_TABLE_SIZE    8
+
+typedef struct
+{
+    char *file_path;
+    kp_nef_file_stat_t file_stat;
+    uint32_t nef_crc;
+    uint32_t last_used;
+} _verified_nef_file_t;
+
+static _verified_nef_file_t verified_nef_files[VERIFIED_NEF_FILE_TABLE_SIZE];
+static uint32_t verified_nef_files_clock = 0;
+static pthread_mutex_t verified_nef_files_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool _is_same_nef_file_stat(const kp_nef_file_stat_t *file_stat_a, const kp_nef_file_stat_t *file_stat_b) {
+    return ((file_stat_a->size == file_stat_b->size) &&
+            (file_stat_a->ino == file_stat_b->ino) &&
+            (file_stat_a->mtime_sec == file_stat_b->mtime_sec) &&
+            (file_stat_a->mtime_nsec == file_stat_b->mtime_nsec));
+}
+
+/* the caller holds verified_nef_files_mutex */
+static _verified_nef_file_t* _find_verified_nef_file(const char *file_path) {
+    for (int i = 0; i < VERIFIED_NEF_FILE_TABLE_SIZE; i++) {
+        if ((NULL != verified_nef_files[i].file_path) &&
+            (0 == strcmp(file_path, verified_nef_files[i].file_path)))
+            return &verified_nef_files[i];
+    }
+
+    return NULL;
+}
+
+static bool _is_verified_nef_file(const char *file_path, const kp_nef_file_stat_t *file_stat, uint32_t nef_crc) {
+    bool verified = false;
+
+    pthread_mutex_lock(&verified_nef_files_mutex);
+
+    _verified_nef_file_t *entry = _find_verified_nef_file(file_path);
+    if ((NULL != entry) &&
+        (nef_crc == entry->nef_crc) &&
+        (true == _is_same_nef_file_stat(file_stat, &(entry->file_stat)))) {
+        entry->last_used = ++verified_nef_files_clock;
+        verified = true;
+    }
+
+    pthread_mutex_unlock(&verified_nef_files_mutex);
+
+    return verified;
+}
+
+/* a full table drops its least recently used file */
+static void _set_verified_nef_file(const char *file_path, const kp_nef_file_stat_t *file_stat, uint32_t nef_crc) {
+    pthread_mutex_lock(&verified_nef_files_mutex);
+
+    _verified_nef_file_t *entry = _find_verified_nef_file(file_path);
+
+    for (int i = 0; (NULL == entry) && (i < VERIFIED_NEF_FILE_TABLE_SIZE); i++) {
+        if (NULL == verified_nef_files[i].file_path)
+            entry = &verified_nef_files[i];
+    }
+
+    if (NULL == entry) {
+        entry = &verified_nef_files[0];
+
+        for (int i = 1; i < VERIFIED_NEF_FILE_TABLE_SIZE; i++) {
+            if (verified_nef_files[i].last_used < entry->last_used)
+                entry = &verified_nef_files[i];
+        }
+    }
+
+    if ((NULL == entry->file_path) || (0 != strcmp(file_path, entry->file_path))) {
+        free(entry->file_path);
+        entry->file_path = strdup(file_path);
+    }
+
+    entry->file_stat    = *file_stat;
+    entry->nef_crc      = nef_crc;
+    entry->last_used    = ++verified_nef_files_clock;
+
+    pthread_mutex_unlock(&verified_nef_files_mutex);
+}
+
+int get_nef_file_stat(const char *file_path, kp_nef_file_stat_t *file_stat)
+{
+    struct stat st;
+
+    if ((NULL == file_path) || (NULL == file_stat))
+        return KP_ERROR_INVALID_PARAM_12;
+
+    if (0 != stat(file_path, &st))
+        return KP_ERROR_FILE_OPEN_FAILED_20;
+
+    memset(file_stat, 0, sizeof(kp_nef_file_stat_t));
+    file_stat->size         = (long long)st.st_size;
+    file_stat->ino          = (long long)st.st_ino;
+    file_stat->mtime_sec    = (long long)st.st_mtime;
+#if defined(__APPLE__)
+    file_stat->mtime_nsec   = (long)st.st_mtimespec.tv_nsec;
+#elif !defined(_WIN32)
+    file_stat->mtime_nsec   = (long)st.st_mtim.tv_nsec;
+#endif
+
+    return KP_SUCCESS;
+}
+
+/**
+ * 'nef_buf' is the content of 'file_path' and 'file_stat' the state of the file before it was read, NULL if unknown.
+ */
+int load_model_info_from_nef_file(const char *file_path, const kp_nef_file_stat_t *file_stat, void *nef_buf, int nef_size, kp_product_id_t target_pid /* input */, kp_metadata_t *metadata, kp_nef_info_t *nef_info, kp_model_nef_descriptor_t *loaded_model_desc /* output */)
+{
+    kp_nef_file_stat_t file_stat_after_read;
+    uint32_t nef_crc = 0;
+
+    if ((NULL == file_path) || (NULL == file_stat) || (NULL == nef_buf) || ((int)sizeof(uint32_t) >= nef_size))
+        return load_model_info_from_nef(nef_buf, nef_size, target_pid, metadata, nef_info, loaded_model_desc);
+
+    // the buffer is the file as it was verified only if the file did not change while it was read
+    bool unchanged = ((KP_SUCCESS == get_nef_file_stat(file_path, &file_stat_after_read)) &&
+                      (true == _is_same_nef_file_stat(file_stat, &file_stat_after_read)) &&
+                      (nef_size == file_stat->size));
+
+    memcpy(&nef_crc, (char *)nef_buf + nef_size - sizeof(uint32_t), sizeof(uint32_t));
+
+    bool verified = ((true == unchanged) && (true == _is_verified_nef_file(file_path, file_stat, nef_crc)));
+
+    int ret = _load_model_info_from_nef(nef_buf, nef_size, !verified, target_pid, metadata, nef_info, loaded_model_desc);
+
+    if ((KP_SUCCESS == ret) && (true == unchanged) && (false == verified))
+        _set_verified_nef_file(file_path, file_stat, nef_crc);
+
+    return ret;
 }
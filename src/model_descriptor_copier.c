@@ -50,6 +50,18 @@ int copy_single_tensor_info_quantization_parameters(kp_quantization_parameters_t
         }
 
         memcpy((void *)quantization_parameters_dst_v1->quantized_fixed_point_descriptor, (void *)quantization_parameters_src_v1->quantized_fixed_point_descriptor, quantization_parameters_dst_v1->quantized_fixed_point_descriptor_num * sizeof(kp_quantized_fixed_point_descriptor_t));
+
+        if (NULL != quantization_parameters_src_v1->quantization_reciprocal_factor) {
+            quantization_parameters_dst_v1->quantization_reciprocal_factor = realloc_zero(quantization_parameters_dst_v1->quantization_reciprocal_factor, quantization_parameters_dst_v1->quantized_fixed_point_descriptor_num * sizeof(float));
+
+            if (0 < quantization_parameters_dst_v1->quantized_fixed_point_descriptor_num &&
+                NULL == quantization_parameters_dst_v1->quantization_reciprocal_factor) {
+                err_print("cpoy nef single model information quantization parameters in model_descriptor fail: alloc memory fail ...\n");
+                return KP_ERROR_MEMORY_ALLOCATION_FAILURE_9;
+            }
+
+            memcpy((void *)quantization_parameters_dst_v1->quantization_reciprocal_factor, (void *)quantization_parameters_src_v1->quantization_reciprocal_factor, quantization_parameters_dst_v1->quantized_fixed_point_descriptor_num * sizeof(float));
+        }
     } else {
         err_print("copy nef single model information quantization parameters in model_descriptor fail: invalide quantization parameters version ...\n");
         return KP_ERROR_INVALID_PARAM_12;
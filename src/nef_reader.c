@@ -182,6 +182,7 @@ FUNC_OUT:
 
 int read_nef_content_table(char* nef_data,
                            uint32_t nef_size,
+                           bool check_crc,
                            kp_nef_handler_t *nef_handler) {
     int status  = KP_SUCCESS;
     int nef_crc = 0;
@@ -195,14 +196,23 @@ int read_nef_content_table(char* nef_data,
         goto FUNC_OUT;
     }
 
-    nef_crc = crc_cal((uint8_t *)nef_data, nef_size-4);
-    crc     = *(uint32_t *)&(nef_data[nef_size-4]);
-    if (crc != nef_crc) {
+    if (sizeof(uint32_t) >= nef_size) {
         err_print("Bad model.\n");
         status = KP_ERROR_INVALID_MODEL_21;
         goto FUNC_OUT;
     }
 
+    /* the CRC of an unchanged NEF file verified before is not calculated again, see load_model_info_from_nef_file() */
+    if (true == check_crc) {
+        nef_crc = crc_cal((uint8_t *)nef_data, nef_size-4);
+        crc     = *(uint32_t *)&(nef_data[nef_size-4]);
+        if (crc != nef_crc) {
+            err_print("Bad model.\n");
+            status = KP_ERROR_INVALID_MODEL_21;
+            goto FUNC_OUT;
+        }
+    }
+
     table = KneronNEF_NEFContent_as_root(nef_data);
     if (table == NULL) {
         status = KP_ERROR_INVALID_MODEL_21;